@@ -0,0 +1,1957 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Batch.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Run many independent sites with SOILWAT2-standalone.
+ *
+ *           A manifest lists one site per line, either as a site
+ *           directory (which contains `files.in`) or as the path to
+ *           the main input file of a site.
+ *
+ *           Sites are simulated by a pool of worker threads. Each worker
+ *           owns a queue of sites and uses its own simulation run context
+ *           `SW_RUN`; a worker that runs out of sites steals sites from
+ *           the queues of other workers. Output files and the logfile
+ *           of each site are relative to the site's directory.
+ *
+ *           Sites are scheduled longest-first: the predicted run time of
+ *           each site (see `SW_BATCH_COST`) is estimated from its inputs
+ *           (simulated years, soil layers, soil temperature), the sites
+ *           are dealt in order of decreasing predicted run time to the
+ *           queue with the least predicted work, and a worker without
+ *           sites steals the shortest site of the queue with the most
+ *           predicted work left. Observed run times and soil temperature
+ *           sub-steps of finished sites update the cost model.
+ *
+ *           A site whose simulation fails with a fatal error is recorded
+ *           (see `SW_ERROR_HANDLER`) and does not affect the other sites;
+ *           its simulation run context is discarded. The log messages of
+ *           a site are held in memory (see `SW_LOGBUFFER`) and written at
+ *           once to its logfile when the site is finished.
+ *
+ *           If reader threads are requested (`SW_BATCH.n_readers`), then
+ *           they set up the simulation run contexts of upcoming sites
+ *           (i.e., read and prepare their inputs) while the workers
+ *           simulate, so that workers do not wait for storage. Sites are
+ *           then taken longest-first from one list: readers and workers
+ *           claim the next site without locks and hand over the
+ *           ready-to-run contexts in a bounded ring (see `SW_BATCH_READY`).
+ *
+ *           Sites with identical input files for CO2 concentrations and
+ *           weather generator parameters share one parsed, immutable copy
+ *           of them (see `SW_Shared.c`).
+ *
+ *           If threads are pinned (`SW_BATCH.pin_threads`), then they are
+ *           spread across the NUMA nodes (see `SW_Batch_numa.c`). A thread
+ *           allocates the simulation run contexts that it sets up on its
+ *           node, and the sites that it sets up share the copy of the input
+ *           tables of its node. A worker moves the context of a site that
+ *           a reader on another node set up to its own node.
+ *
+ *           If sites are simulated in lanes (`SW_BATCH.lanes`), then sites
+ *           with the same calendar and number of soil layers are grouped,
+ *           `SW_LANES` sites at a time in longest-first order, and workers
+ *           take the groups longest-first from one list. A worker simulates
+ *           the sites of a group day by day in lock-step and calculates
+ *           their percolation at once with the lane kernels of
+ *           `SW_Flow_lanes.c` (see `run_group()`); the outputs of each site
+ *           are identical to those of a site that is simulated alone.
+ *
+ *           If a metrics file is requested (`SW_BATCH.metrics_file`), then
+ *           each thread keeps counters of its sites (see
+ *           `SW_BATCH_COUNTERS`), and a publisher thread periodically
+ *           writes them with the state of the sites to the metrics file in
+ *           the Prometheus text format (see `write_metrics()`), e.g., for
+ *           the textfile collector of the Prometheus node exporter.
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING - ag
+ *     (2026-10-15) (ag) sites, their setup, and the worker threads are traced
+ *                       (option -t, see SW_Trace.h)
+ *     (2026-10-15) (ag) the manifest is read with SW_TEXTFILE
+ *     (2026-10-15) (ag) sites share the input tables of identical input files
+ *     (2026-10-15) (ag) sites write into one HDF5 output file (option -o h5)
+ *     (2026-10-15) (ag) longest-first scheduling by a cost model of the sites
+ *     (2026-10-15) (ag) log messages of a site are buffered in memory
+ *     (2026-10-15) (ag) reader threads set up upcoming sites ahead of the workers
+ *     (2026-10-15) (ag) live metrics of the threads are published to a file (option -m)
+ *     (2026-10-15) (ag) threads are pinned to the CPUs of the NUMA nodes (option -n)
+ *     (2026-10-15) (ag) the memory of the simulation run context of each site is recorded
+ *     (2026-10-15) (ag) sites can be simulated in lanes of the water flow kernels (option -l)
+ *     (2026-10-15) (ag) the summary reports the makespan predicted before the run and
+ *                       labels the makespan with the model fit to the run as a fit
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "Times.h"
+#include "SW_Defines.h"
+#include "SW_Control.h"
+#include "SW_Output.h"
+#include "SW_Output_outbin.h"
+#include "SW_Output_outhdf.h"
+#include "SW_Flow.h"
+#include "SW_Flow_lanes.h"
+#include "SW_Model.h"
+#include "SW_Site.h"
+#include "SW_Files.h"
+#include "SW_Weather.h"
+#include "SW_Trace.h"
+#include "SW_Profile.h"
+#include "SW_Run.h"
+#include "SW_Batch.h"
+
+
+/* Defaults of the cost model, measured with the example inputs
+   (`testing/`, 31 years, 8 soil layers); see `SW_BATCH_COST` */
+#define SW_BAT_COST_BASE 0.25e-3
+#define SW_BAT_COST_PER_LAYER 0.4e-3
+#define SW_BAT_COST_ST_PER_LAYER 0.07e-3
+#define SW_BAT_COST_SUBSTEPS 2.
+
+/* Seconds between two writes of the metrics file, see `SW_BATCH` */
+#define SW_BAT_METRICS_INTERVAL 5.
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** Sites waiting for a worker, longest first: the owning worker takes
+    sites from the front, other workers steal sites from the back */
+typedef struct {
+	pthread_mutex_t lock;
+	unsigned int head, tail; /**< sites `order[head]` to `order[tail - 1]` are waiting */
+	double fixed, per_substep; /**< predicted run time of the waiting sites, see `site_cost()` */
+} SW_BATCH_QUEUE;
+
+/** A site whose simulation run context was set up by a reader thread
+
+  Slot `k` of the ring holds positions `k`, `k + depth`, ... of the
+  longest-first list of sites; `seq` tells whose turn it is: the reader
+  that claimed position `i` fills the slot if `seq == i`, and the worker
+  that claimed position `i` takes it if `seq == i + 1` and passes it on
+  to position `i + depth`.
+*/
+typedef struct {
+	unsigned int seq;
+	SW_RUN *sw; /**< ready-to-run context of the site */
+	FILE *logfp; /**< logfile of the site (`stderr` if not opened) */
+	SW_LOGBUFFER logbuf; /**< messages of the setup of the site */
+	double seconds; /**< run time of the setup of the site */
+	int node; /**< NUMA node of the reader, see `SW_BATCH_WORKER` */
+} SW_BATCH_READY;
+
+/** Ring of sites that readers set up ahead of the workers
+
+  Readers and workers claim positions with atomic counters; the lock and
+  the condition only put a thread to sleep whose slot is not ready yet.
+*/
+typedef struct {
+	SW_BATCH_READY *slots;
+	unsigned int depth, /**< number of slots */
+		next_read, next_run; /**< next position to claim by a reader and by a worker */
+	pthread_mutex_t lock;
+	pthread_cond_t cond; /**< signaled if a slot changed hands */
+} SW_BATCH_PREFETCH;
+
+/** Counters of a worker or reader thread for the live metrics of a batch
+
+  Only the owning thread updates its counters, with atomic operations, so
+  that the publisher of the metrics reads them without locks.
+*/
+typedef struct {
+	uint64_t
+		claimed, /**< sites that the thread claimed to set up */
+		started, /**< sites whose simulation the thread started */
+		sites, /**< sites that the thread finished: simulated (worker) or set up (reader) */
+		failed, /**< simulated sites that failed */
+		years, days, /**< simulated years of the finished sites, and simulated days */
+		output_bytes, /**< size of the output files of the simulated sites */
+		setup_ns, max_setup_ns, /**< total and longest setup (input reads) of a site */
+		busy_ns, /**< time spent on sites */
+		since_ns; /**< start of the current site; 0 if idle */
+
+	#ifdef SW_PROFILE
+	uint64_t ticks[SW_PROFILE_NPHASES], calls[SW_PROFILE_NPHASES]; /**< profiled phases of the simulated sites */
+	#endif
+} SW_BATCH_COUNTERS;
+
+/** Sites of a batch that are simulated together in lanes, see `run_group()` */
+typedef struct {
+	unsigned int first, /**< sites `grouped[first]` to `grouped[first + n - 1]` of the schedule */
+		n, /**< number of sites, at most `SW_LANES` */
+		rank; /**< position of the longest site in the longest-first list */
+} SW_BATCH_GROUP;
+
+/** Queues of the workers and the cost model of a batch */
+typedef struct {
+	SW_BATCH *batch;
+	SW_BATCH_QUEUE *queues; /**< queues of all workers */
+	unsigned int *order, /**< sites of all queues */
+		*lpt, /**< all sites, longest first */
+		n_workers;
+	SW_BATCH_GROUP *groups; /**< groups of sites, longest first; NULL if sites are not simulated in lanes */
+	unsigned int *grouped, /**< sites of all groups */
+		n_groups, next_group; /**< number of groups, next group to claim by a worker */
+	SW_BATCH_PREFETCH *prefetch; /**< NULL if workers set up their own sites */
+	const SW_BATCH_NUMA *numa; /**< NULL if threads are not pinned */
+	pthread_mutex_t lock; /**< of `batch->cost` */
+} SW_BATCH_SCHEDULE;
+
+/** State of one worker thread */
+typedef struct {
+	SW_BATCH_SCHEDULE *sched;
+	unsigned int id,
+		first, last; /**< sites whose costs the worker estimates */
+	int node; /**< index of the NUMA node of the thread; -1 if not pinned */
+	SW_BATCH_COUNTERS count; /**< of the live metrics */
+} SW_BATCH_WORKER;
+
+/** Publisher of the live metrics of a batch, see `write_metrics()` */
+typedef struct {
+	SW_BATCH_SCHEDULE *sched;
+	SW_BATCH_WORKER *threads; /**< workers followed by the readers */
+	unsigned int n_readers;
+	uint64_t start_ns; /**< start of the simulation of the sites */
+	Bool stop; /**< TRUE at the end of the batch */
+	pthread_mutex_t lock;
+	pthread_cond_t cond; /**< signaled at the end of the batch */
+} SW_BATCH_METRICS;
+
+/** A per-thread counter of the live metrics */
+typedef struct {
+	const char *name, *type, *help;
+	size_t offset; /**< of the counter in `SW_BATCH_COUNTERS` */
+	double scale; /**< of the counter to the unit of the metric */
+} SW_BATCH_METRIC;
+
+/** A site and its predicted run time, for sorting */
+typedef struct {
+	double cost;
+	unsigned int isite;
+} SW_BATCH_RANK;
+
+/** A site, its calendar and number of soil layers, and its position in the
+    longest-first list, for grouping sites in lanes */
+typedef struct {
+	TimeInt startyr, n_years, startstart, endend;
+	unsigned int n_layers, rank;
+} SW_BATCH_KEY;
+
+/** A site of a group that is simulated in lock-step, see `run_group()` */
+typedef struct {
+	SW_BATCH_SITE *site;
+	SW_RUN *sw; /**< simulation run context of the site */
+	FILE *logfp; /**< logfile of the site (`stderr` if not opened) */
+	SW_LOGBUFFER logbuf; /**< messages of the site */
+	SW_ERROR_HANDLER handler; /**< of fatal errors of the site */
+	double setup_seconds; /**< run time of the setup of the site */
+	Bool active, /**< FALSE once the simulation of the site failed */
+		today; /**< TRUE if the site simulates the current day */
+} SW_BATCH_LANE;
+
+/** Steps of the simulation of a site of a group, see `lane_step()` */
+typedef enum {
+	eLaneStart, eLaneBeginYear, eLaneBeginDay, eLaneWaterFlow, eLaneEndDay,
+	eLaneEndYear, eLaneEnd
+} SW_BATCH_LANE_STEP;
+
+
+/* =================================================== */
+/*                  Local Variables                    */
+/* --------------------------------------------------- */
+
+/** Per-thread metrics of a batch, see `write_metrics()` */
+static const SW_BATCH_METRIC metric_defs[] = {
+	{"sw2_batch_thread_sites_total", "counter",
+		"Sites finished by the thread (simulated by a worker, set up by a reader)",
+		offsetof(SW_BATCH_COUNTERS, sites), 1.},
+	{"sw2_batch_thread_failed_total", "counter",
+		"Sites whose simulation failed",
+		offsetof(SW_BATCH_COUNTERS, failed), 1.},
+	{"sw2_batch_simulated_years_total", "counter",
+		"Simulated years of the finished sites",
+		offsetof(SW_BATCH_COUNTERS, years), 1.},
+	{"sw2_batch_simulated_days_total", "counter",
+		"Simulated days",
+		offsetof(SW_BATCH_COUNTERS, days), 1.},
+	{"sw2_batch_output_bytes_total", "counter",
+		"Size of the output files of the finished sites",
+		offsetof(SW_BATCH_COUNTERS, output_bytes), 1.},
+	{"sw2_batch_setup_seconds_total", "counter",
+		"Time spent on setting up sites (reading inputs)",
+		offsetof(SW_BATCH_COUNTERS, setup_ns), 1e-9},
+	{"sw2_batch_setup_seconds_max", "gauge",
+		"Longest setup of a site",
+		offsetof(SW_BATCH_COUNTERS, max_setup_ns), 1e-9},
+	{"sw2_batch_busy_seconds_total", "counter",
+		"Time spent on sites",
+		offsetof(SW_BATCH_COUNTERS, busy_ns), 1e-9}
+};
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Seconds elapsed since `start` */
+static double seconds_since(const struct timespec *start) {
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+
+	return (double) (now.tv_sec - start->tv_sec) +
+		1e-9 * (double) (now.tv_nsec - start->tv_nsec);
+}
+
+
+/** Nanoseconds since the epoch */
+static uint64_t now_ns(void) {
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+
+	return (uint64_t) now.tv_sec * 1000000000u + (uint64_t) now.tv_nsec;
+}
+
+
+/** Add to a counter of the calling thread, see `SW_BATCH_COUNTERS` */
+static void count_add(uint64_t *x, uint64_t v) {
+	__atomic_fetch_add(x, v, __ATOMIC_RELAXED);
+}
+
+
+/** Set a counter of the calling thread, see `SW_BATCH_COUNTERS` */
+static void count_set(uint64_t *x, uint64_t v) {
+	__atomic_store_n(x, v, __ATOMIC_RELAXED);
+}
+
+
+/** Read a counter of any thread, see `SW_BATCH_COUNTERS` */
+static uint64_t count_get(const uint64_t *x) {
+	return __atomic_load_n(x, __ATOMIC_RELAXED);
+}
+
+
+/** A thread starts with a site; returns the start */
+static uint64_t count_begin(SW_BATCH_COUNTERS *c) {
+	uint64_t start = now_ns();
+
+	count_set(&c->since_ns, start);
+
+	return start;
+}
+
+
+/** A thread is done with the site that it started at `start` */
+static void count_end(SW_BATCH_COUNTERS *c, uint64_t start) {
+	count_add(&c->busy_ns, now_ns() - start);
+	count_set(&c->since_ns, 0);
+}
+
+
+/** Add the size of a block of an arena to `data`, see `Mem_ArenaBlocks()` */
+static void add_block_size(const void *block, size_t size, void *data) {
+	(void) block;
+	*(size_t *) data += size;
+}
+
+
+/** A thread set up a site in `ns` nanoseconds */
+static void count_setup(SW_BATCH_COUNTERS *c, uint64_t ns) {
+	count_add(&c->setup_ns, ns);
+	if (ns > c->max_setup_ns) {
+		count_set(&c->max_setup_ns, ns);
+	}
+}
+
+
+/** Size of an open output file */
+static uint64_t file_size(FILE *fp) {
+	long n = ftell(fp);
+
+	return (n > 0) ? (uint64_t) n : 0;
+}
+
+
+/** Predicted run time of a site without `scale` of the cost model
+
+  @param c Cost model.
+  @param site Site of a batch.
+  @param fixed Run time that does not depend on soil temperature sub-steps.
+  @param per_substep Run time per soil temperature sub-step per day.
+*/
+static void site_cost(const SW_BATCH_COST *c, const SW_BATCH_SITE *site,
+	double *fixed, double *per_substep) {
+
+	*fixed = site->n_years * (c->base + c->per_layer * site->n_layers);
+	*per_substep = site->soil_temp ?
+		site->n_years * c->st_per_layer * site->n_layers : 0.;
+}
+
+
+/** Move a site out of a queue (locked by the caller) */
+static unsigned int dequeue(SW_BATCH_SCHEDULE *s, SW_BATCH_QUEUE *q,
+	Bool front) {
+
+	unsigned int isite = s->order[front ? q->head++ : --q->tail];
+	double fixed, per_substep;
+
+	site_cost(&s->batch->cost, &s->batch->sites[isite], &fixed, &per_substep);
+	q->fixed -= fixed;
+	q->per_substep -= per_substep;
+
+	return isite;
+}
+
+
+/** Take the next site from the own queue or steal one from another queue
+
+  A worker steals the shortest site of the queue with the longest predicted
+  run time of its waiting sites.
+
+  @param w Worker that is looking for work.
+  @param isite Index of the site that the worker should simulate next.
+
+  @return FALSE if all queues are empty.
+*/
+static Bool take_site(SW_BATCH_WORKER *w, unsigned int *isite) {
+	SW_BATCH_SCHEDULE *s = w->sched;
+	SW_BATCH_QUEUE *q = &s->queues[w->id];
+	unsigned int k, victim;
+	double substeps, load, max_load;
+	Bool found = swFALSE;
+
+	pthread_mutex_lock(&q->lock);
+	if (q->head < q->tail) {
+		*isite = dequeue(s, q, swTRUE);
+		found = swTRUE;
+	}
+	pthread_mutex_unlock(&q->lock);
+
+	pthread_mutex_lock(&s->lock);
+	substeps = s->batch->cost.substeps;
+	pthread_mutex_unlock(&s->lock);
+
+	while (!found) {
+		victim = s->n_workers;
+		max_load = -1.;
+
+		for (k = 0; k < s->n_workers; k++) {
+			q = &s->queues[k];
+
+			pthread_mutex_lock(&q->lock);
+			load = q->fixed + substeps * q->per_substep;
+			if (q->head < q->tail && load > max_load) {
+				victim = k;
+				max_load = load;
+			}
+			pthread_mutex_unlock(&q->lock);
+		}
+
+		if (victim == s->n_workers) {
+			break; // all queues are empty
+		}
+
+		// the victim may have run out of sites in the meantime
+		q = &s->queues[victim];
+		pthread_mutex_lock(&q->lock);
+		if (q->head < q->tail) {
+			*isite = dequeue(s, q, swFALSE);
+			found = swTRUE;
+		}
+		pthread_mutex_unlock(&q->lock);
+	}
+
+	return found;
+}
+
+
+/** Update the cost model with the observed run time of a site
+
+  @param s Schedule of the batch.
+  @param site A site that was simulated successfully.
+  @param st_days Days with soil temperature of the site.
+  @param st_steps Soil temperature sub-steps of the site.
+*/
+static void observe_site(SW_BATCH_SCHEDULE *s, const SW_BATCH_SITE *site,
+	double st_days, double st_steps) {
+
+	SW_BATCH_COST *c = &s->batch->cost;
+	double fixed, per_substep;
+
+	pthread_mutex_lock(&s->lock);
+
+	site_cost(c, site, &fixed, &per_substep);
+
+	if (st_days > 0.) {
+		c->st_days += st_days;
+		c->st_steps += st_steps;
+		c->substeps = c->st_steps / c->st_days;
+	}
+
+	// with the sub-steps that the site realized
+	c->sum_predicted += fixed +
+		per_substep * ((st_days > 0.) ? st_steps / st_days : c->substeps);
+	c->sum_observed += site->seconds;
+
+	if (c->sum_predicted > 0. && c->sum_observed > 0.) {
+		c->scale = c->sum_observed / c->sum_predicted;
+	}
+
+	pthread_mutex_unlock(&s->lock);
+}
+
+
+/** Read the inputs of the cost model of a site
+
+  Only the main input file, the model time, and the site and soil
+  inputs are read. A site whose inputs cannot be read has no predicted
+  run time; its simulation fails with the same error.
+
+  @param site Site of a batch; updated with the inputs of the cost model
+    and with its calendar.
+*/
+static void estimate_site(SW_BATCH_SITE *site) {
+	SW_RUN *sw;
+	SW_ERROR_HANDLER handler;
+	SW_LOGBUFFER logbuf = {NULL, 0, 0};
+	char firstfile[MAX_FILENAMESIZE];
+
+	logfp = stderr; // until SW_F_read() opens the logfile of the site
+	logged = swFALSE;
+
+	sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "estimate_site()");
+	sw->Files.relative_to_ProjDir = swTRUE;
+	sw->Arena.use = swTRUE;
+
+	// SW_F_construct() strips the path from its argument
+	strcpy(firstfile, site->firstfile);
+
+	site->n_years = site->n_layers = 0;
+	site->soil_temp = swFALSE;
+	site->startyr = site->startstart = site->endend = 0;
+
+	// messages are logged again by the simulation of the site
+	LogError_handler = &handler;
+	LogError_buffer = &logbuf;
+
+	if (0 == setjmp(handler.env)) {
+		SW_CTL_setup_model(sw, firstfile);
+		SW_F_read(NULL);
+		SW_MDL_read();
+		SW_SIT_read();
+
+		site->n_years = SW_Model.endyr - SW_Model.startyr + 1;
+		site->n_layers = SW_Site.n_layers;
+		site->soil_temp = SW_Site.use_soil_temp;
+		site->startyr = SW_Model.startyr;
+		site->startstart = SW_Model.startstart;
+		site->endend = SW_Model.endend;
+	}
+
+	LogError_handler = NULL;
+	LogError_buffer = NULL;
+	FlushLogBuffer(&logbuf, NULL);
+
+	if (logfp != stdout && logfp != stderr) {
+		CloseFile(&logfp);
+	}
+	logfp = stderr;
+
+	SW_CTL_clear_model(sw, swTRUE);
+	Mem_Free(sw);
+	SW_CTL_activate_run(NULL);
+}
+
+
+/** Thread function of the estimation of the costs of a range of sites */
+static void *estimate_worker(void *arg) {
+	SW_BATCH_WORKER *w = (SW_BATCH_WORKER *) arg;
+	unsigned int i;
+
+	for (i = w->first; i < w->last; i++) {
+		estimate_site(&w->sched->batch->sites[i]);
+	}
+
+	return NULL;
+}
+
+
+/** Sort sites by decreasing predicted run time, then by index */
+static int compare_ranks(const void *a, const void *b) {
+	const SW_BATCH_RANK *x = (const SW_BATCH_RANK *) a, *y = (const SW_BATCH_RANK *) b;
+
+	if (x->cost != y->cost) {
+		return (x->cost > y->cost) ? -1 : 1;
+	}
+
+	return (x->isite < y->isite) ? -1 : (x->isite > y->isite);
+}
+
+
+/** Deal sites, longest first, to the queue with the least predicted work
+
+  @param s Schedule of the batch; the queues and the longest-first list
+    are filled.
+
+  @return Predicted makespan of the schedule (seconds).
+*/
+static double deal_sites(SW_BATCH_SCHEDULE *s) {
+	SW_BATCH *batch = s->batch;
+	const SW_BATCH_COST *c = &batch->cost;
+	SW_BATCH_RANK *ranks;
+	SW_BATCH_QUEUE *q;
+	unsigned int i, k, n = 0, *owner;
+	double fixed, per_substep, *load, makespan = 0.;
+
+	ranks = (SW_BATCH_RANK *) Mem_Malloc(batch->n_sites * sizeof(SW_BATCH_RANK), "deal_sites()");
+	owner = (unsigned int *) Mem_Malloc(batch->n_sites * sizeof(unsigned int), "deal_sites()");
+	load = (double *) Mem_Calloc(s->n_workers, sizeof(double), "deal_sites()");
+
+	for (i = 0; i < batch->n_sites; i++) {
+		site_cost(c, &batch->sites[i], &fixed, &per_substep);
+		ranks[i].cost = fixed + c->substeps * per_substep;
+		ranks[i].isite = i;
+	}
+	qsort(ranks, batch->n_sites, sizeof(SW_BATCH_RANK), compare_ranks);
+
+	for (i = 0; i < batch->n_sites; i++) {
+		s->lpt[i] = ranks[i].isite;
+
+		owner[i] = 0;
+		for (k = 1; k < s->n_workers; k++) {
+			if (load[k] < load[owner[i]]) {
+				owner[i] = k;
+			}
+		}
+		load[owner[i]] += ranks[i].cost;
+	}
+
+	// queues are consecutive in `order`, each longest first
+	for (k = 0; k < s->n_workers; k++) {
+		q = &s->queues[k];
+		q->head = q->tail = n;
+		q->fixed = q->per_substep = 0.;
+
+		for (i = 0; i < batch->n_sites; i++) {
+			if (owner[i] == k) {
+				s->order[q->tail++] = ranks[i].isite;
+				site_cost(c, &batch->sites[ranks[i].isite], &fixed, &per_substep);
+				q->fixed += fixed;
+				q->per_substep += per_substep;
+			}
+		}
+
+		n = q->tail;
+		makespan = max(makespan, load[k]);
+	}
+
+	Mem_Free(load);
+	Mem_Free(owner);
+	Mem_Free(ranks);
+
+	return c->scale * makespan;
+}
+
+
+/** Sort sites by calendar and number of soil layers, then longest first */
+static int compare_keys(const void *a, const void *b) {
+	const SW_BATCH_KEY *x = (const SW_BATCH_KEY *) a, *y = (const SW_BATCH_KEY *) b;
+
+	if (x->n_years != y->n_years) {
+		return (x->n_years < y->n_years) ? -1 : 1;
+	}
+	if (x->n_layers != y->n_layers) {
+		return (x->n_layers < y->n_layers) ? -1 : 1;
+	}
+	if (x->startyr != y->startyr) {
+		return (x->startyr < y->startyr) ? -1 : 1;
+	}
+	if (x->startstart != y->startstart) {
+		return (x->startstart < y->startstart) ? -1 : 1;
+	}
+	if (x->endend != y->endend) {
+		return (x->endend < y->endend) ? -1 : 1;
+	}
+
+	return (x->rank < y->rank) ? -1 : (x->rank > y->rank);
+}
+
+
+/** TRUE if two sites have the same calendar and number of soil layers */
+static Bool same_key(const SW_BATCH_KEY *x, const SW_BATCH_KEY *y) {
+	return (Bool) (x->n_years == y->n_years && x->n_layers == y->n_layers &&
+		x->startyr == y->startyr && x->startstart == y->startstart &&
+		x->endend == y->endend);
+}
+
+
+/** Sort groups by the position of their longest site in the longest-first list */
+static int compare_groups(const void *a, const void *b) {
+	const SW_BATCH_GROUP *x = (const SW_BATCH_GROUP *) a, *y = (const SW_BATCH_GROUP *) b;
+
+	return (x->rank < y->rank) ? -1 : (x->rank > y->rank);
+}
+
+
+/** Group sites with the same calendar and number of soil layers,
+    `SW_LANES` sites at a time, see `run_group()`
+
+  Sites are grouped longest-first among the sites with the same calendar
+  and number of soil layers; a site whose inputs could not be read is a
+  group by itself.
+
+  @param s Schedule of the batch after `deal_sites()`; the groups are
+    allocated and sorted by their longest site.
+*/
+static void group_sites(SW_BATCH_SCHEDULE *s) {
+	SW_BATCH *batch = s->batch;
+	SW_BATCH_KEY *keys;
+	SW_BATCH_SITE *site;
+	SW_BATCH_GROUP *g = NULL;
+	unsigned int i;
+
+	keys = (SW_BATCH_KEY *) Mem_Malloc(batch->n_sites * sizeof(SW_BATCH_KEY), "group_sites()");
+	s->grouped = (unsigned int *) Mem_Malloc(batch->n_sites * sizeof(unsigned int), "group_sites()");
+	s->groups = (SW_BATCH_GROUP *) Mem_Malloc(batch->n_sites * sizeof(SW_BATCH_GROUP), "group_sites()");
+
+	for (i = 0; i < batch->n_sites; i++) {
+		site = &batch->sites[s->lpt[i]];
+		keys[i].n_years = site->n_years;
+		keys[i].n_layers = site->n_layers;
+		keys[i].startyr = site->startyr;
+		keys[i].startstart = site->startstart;
+		keys[i].endend = site->endend;
+		keys[i].rank = i;
+	}
+	qsort(keys, batch->n_sites, sizeof(SW_BATCH_KEY), compare_keys);
+
+	s->n_groups = s->next_group = 0;
+	for (i = 0; i < batch->n_sites; i++) {
+		s->grouped[i] = s->lpt[keys[i].rank];
+
+		if (isnull(g) || g->n == SW_LANES || 0 == keys[i].n_years ||
+			!same_key(&keys[i - 1], &keys[i])) {
+
+			g = &s->groups[s->n_groups++];
+			g->first = i;
+			g->n = 0;
+			g->rank = keys[i].rank;
+		}
+		g->n++;
+	}
+	qsort(s->groups, s->n_groups, sizeof(SW_BATCH_GROUP), compare_groups);
+
+	Mem_Free(keys);
+}
+
+
+/** Set up a new simulation run context of a site: read and prepare its inputs
+
+  The logfile of the site (if opened) is left in `logfp` of the calling thread.
+
+  @param site Site of a batch; updated if the setup fails.
+  @param batch Batch of the site.
+  @param logbuf Log buffer of the site; receives the messages of the setup.
+  @param read_weather Also read the weather of all years if it is preloaded
+    (see `SW_WTH_preload()`) and the weather generator is not used.
+  @param node NUMA node of the calling thread (-1 if not pinned); the site
+    shares the input tables of this node.
+
+  @return Simulation run context of the site.
+*/
+static SW_RUN *setup_site(SW_BATCH_SITE *site, const SW_BATCH *batch,
+	SW_LOGBUFFER *logbuf, Bool read_weather, int node) {
+
+	SW_RUN *sw;
+	SW_ERROR_HANDLER handler;
+	char firstfile[MAX_FILENAMESIZE];
+
+	logfp = stderr; // until SW_F_read() opens the logfile of the site
+	logged = swFALSE;
+
+	sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "setup_site()");
+	sw->Files.relative_to_ProjDir = swTRUE;
+	sw->Arena.use = swTRUE;
+	sw->Checkpoint = batch->checkpoint;
+	sw->Shared = (SW_SHARED_INPUTS *) &batch->shared[max(node, 0)];
+
+	// SW_F_construct() strips the path from its argument
+	strcpy(firstfile, site->firstfile);
+
+	LogError_handler = &handler;
+	LogError_buffer = logbuf;
+
+	SW_TRC_START(setup);
+
+	if (0 == setjmp(handler.env)) {
+		SW_CTL_setup_model(sw, firstfile);
+		SW_CTL_read_inputs_from_disk(sw);
+		SW_Weather.preload_all_years = batch->preload_weather;
+		SW_OUT_set_format(batch->out_format);
+		if (batch->out_format & SW_OUTFORMAT_HDF) {
+			SW_OUT_hdf_attach((unsigned int) (site - batch->sites));
+		}
+		SW_CTL_init_run(sw);
+
+		SW_OUT_set_ncol();
+		SW_OUT_set_colnames();
+
+		// the normal deviates of the weather generator depend on the thread
+		// (see `RandNorm()`); they are drawn by the simulating thread
+		if (read_weather && batch->preload_weather &&
+			!SW_Weather.use_weathergenerator) {
+			SW_WTH_preload();
+		}
+
+	} else {
+		site->failed = swTRUE;
+		strcpy(site->msg, handler.msg);
+	}
+
+	SW_TRC_STOP_STR(setup, "site setup", "setup", "site", site->firstfile);
+
+	LogError_handler = NULL;
+	LogError_buffer = NULL;
+	SW_CTL_activate_run(NULL);
+
+	return sw;
+}
+
+
+/** Finish a simulated site: write its log messages, close its files, and
+    discard its simulation run context
+
+  @param site Site of a batch; updated with run time and memory of the
+    simulation.
+  @param sw Simulation run context of the site, see `setup_site()`; freed.
+  @param s Schedule of the batch; its cost model is updated.
+  @param logbuf Log buffer of the site; written to `logfp` (the logfile of
+    the site) and emptied.
+  @param setup_seconds Run time of the setup of the site.
+  @param start Start of the simulation of the site.
+  @param n_share Number of sites that were simulated together since `start`
+    (see `run_group()`); each is charged an equal share of the run time.
+  @param c Counters of the calling thread.
+*/
+static void finish_site(SW_BATCH_SITE *site, SW_RUN *sw,
+	SW_BATCH_SCHEDULE *s, SW_LOGBUFFER *logbuf, double setup_seconds,
+	const struct timespec *start, unsigned int n_share,
+	SW_BATCH_COUNTERS *c) {
+
+	OutPeriod p;
+	double st_days, st_steps;
+	uint64_t output_bytes;
+	int b;
+
+	// to `stderr` if the site failed before its logfile was opened
+	FlushLogBuffer(logbuf, logfp);
+
+	// close output files (including those of a failed simulation)
+	SW_CTL_activate_run(sw);
+	output_bytes = SW_OutFiles.n_bytes; // of the files closed by the run
+	ForEachOutPeriod(p) {
+		if (!isnull(SW_OutFiles.fp_reg[p])) {
+			output_bytes += file_size(SW_OutFiles.fp_reg[p]);
+			CloseFile(&SW_OutFiles.fp_reg[p]);
+		}
+		if (!isnull(SW_OutFiles.fp_soil[p])) {
+			output_bytes += file_size(SW_OutFiles.fp_soil[p]);
+			CloseFile(&SW_OutFiles.fp_soil[p]);
+		}
+		if (!isnull(SW_OutBin.fp[p])) {
+			output_bytes += file_size(SW_OutBin.fp[p]);
+			CloseFile(&SW_OutBin.fp[p]);
+		}
+	}
+
+	if (logfp != stdout && logfp != stderr) {
+		CloseFile(&logfp);
+	}
+	logfp = stderr;
+
+	// days by sub-steps: bin `b` counts days with 2^b sub-steps
+	st_days = st_steps = 0.;
+	for (b = 0; b < SW_DIAG_NSTEPBINS; b++) {
+		st_days += (double) sw->Flow.diag.st_nsteps[b];
+		st_steps += (double) sw->Flow.diag.st_nsteps[b] * (double) (1u << b);
+	}
+
+	count_add(&c->days, sw->Flow.wbmon.days);
+	count_add(&c->output_bytes, output_bytes);
+	if (!site->failed) {
+		count_add(&c->years, sw->Model.endyr - sw->Model.startyr + 1);
+	}
+	#ifdef SW_PROFILE
+	for (b = 0; b < SW_PROFILE_NPHASES; b++) {
+		count_add(&c->ticks[b], sw->Profile.ticks[b]);
+		count_add(&c->calls[b], sw->Profile.calls[b]);
+	}
+	#endif
+
+	site->context_bytes = sizeof(SW_RUN);
+	Mem_ArenaBlocks(&sw->Arena, add_block_size, &site->context_bytes);
+
+	SW_CTL_clear_model(sw, swTRUE);
+	Mem_Free(sw);
+	SW_CTL_activate_run(NULL);
+
+	site->seconds = setup_seconds + seconds_since(start) / (double) n_share;
+	if (!site->failed) {
+		observe_site(s, site, st_days, st_steps);
+	} else {
+		count_add(&c->failed, 1);
+	}
+	count_add(&c->sites, 1);
+}
+
+
+/** Simulate a site with the simulation run context of its setup and discard the context
+
+  @param site Site of a batch; updated with status, run time, and memory
+    of the simulation.
+  @param sw Simulation run context of the site, see `setup_site()`; freed.
+  @param s Schedule of the batch; its cost model is updated.
+  @param logbuf Log buffer of the site; written to `logfp` (the logfile of
+    the site) and emptied.
+  @param setup_seconds Run time of the setup of the site.
+  @param c Counters of the calling thread.
+*/
+static void simulate_site(SW_BATCH_SITE *site, SW_RUN *sw,
+	SW_BATCH_SCHEDULE *s, SW_LOGBUFFER *logbuf, double setup_seconds,
+	SW_BATCH_COUNTERS *c) {
+
+	const SW_BATCH *batch = s->batch;
+	SW_ERROR_HANDLER handler;
+	struct timespec start;
+
+	timespec_get(&start, TIME_UTC);
+
+	SW_CTL_activate_run(sw);
+
+	// the calendar of `Times.c` is per thread; the setup may have been done
+	// by another thread (see `SW_MDL_construct()`)
+	Time_init_model();
+
+	// messages of the site are written at once to its logfile (see below)
+	LogError_handler = &handler;
+	LogError_buffer = logbuf;
+
+	SW_TRC_START(site);
+
+	if (site->failed) {
+		// setup failed
+
+	} else if (0 == setjmp(handler.env)) {
+		// output files, simulation, and checkpoints of the site
+		SW_CKP_run();
+
+		// per-phase breakdown of a profiling build, to the logfile of the site
+		SW_PROFILE_REPORT();
+
+		if (batch->log_diagnostics) {
+			SW_FLW_log_diagnostics();
+		}
+
+	} else {
+		site->failed = swTRUE;
+		strcpy(site->msg, handler.msg);
+	}
+
+	LogError_handler = NULL;
+	LogError_buffer = NULL;
+
+	SW_TRC_STOP_STR(site, site->failed ? "site (failed)" : "site", "site",
+		"site", site->firstfile);
+
+	finish_site(site, sw, s, logbuf, setup_seconds, &start, 1, c);
+}
+
+
+/** Set up and simulate one site with a new simulation run context
+
+  @param site Site of a batch; updated with status and run time of the simulation.
+  @param w Calling worker; the cost model of its schedule is updated.
+*/
+static void run_site(SW_BATCH_SITE *site, SW_BATCH_WORKER *w) {
+	SW_BATCH_SCHEDULE *s = w->sched;
+	SW_BATCH_COUNTERS *c = &w->count;
+	SW_LOGBUFFER logbuf = {NULL, 0, 0};
+	SW_RUN *sw;
+	uint64_t start, setup_ns;
+
+	count_add(&c->claimed, 1);
+	start = count_begin(c);
+
+	sw = setup_site(site, s->batch, &logbuf, swFALSE, w->node);
+	setup_ns = now_ns() - start;
+	count_setup(c, setup_ns);
+
+	count_add(&c->started, 1);
+	simulate_site(site, sw, s, &logbuf, 1e-9 * (double) setup_ns, c);
+	count_end(c, start);
+}
+
+
+/** TRUE if two set-up sites simulate the same days and soil layers */
+static Bool same_days(const SW_RUN *x, const SW_RUN *y) {
+	return (Bool) (x->Model.startyr == y->Model.startyr &&
+		x->Model.endyr == y->Model.endyr &&
+		x->Model.startstart == y->Model.startstart &&
+		x->Model.endend == y->Model.endend &&
+		x->Site.n_layers == y->Site.n_layers);
+}
+
+
+/** One step of the simulation of a site of a group, see `run_group()`
+
+  A fatal error of the site is recorded and ends its simulation; the
+  other sites of the group continue.
+
+  @param x Site of a group; skipped if its simulation failed.
+  @param batch Batch of the site.
+  @param step Step of the simulation.
+  @param arg Year (`eLaneBeginYear`) or part of the water flow
+    (`eLaneWaterFlow`, see `SW_CTL_water_flow_part()`).
+*/
+static void lane_step(SW_BATCH_LANE *x, const SW_BATCH *batch,
+	SW_BATCH_LANE_STEP step, unsigned int arg) {
+
+	if (!x->active) {
+		return;
+	}
+
+	SW_CTL_activate_run(x->sw);
+	logfp = x->logfp;
+	LogError_handler = &x->handler;
+	LogError_buffer = &x->logbuf;
+
+	if (0 == setjmp(x->handler.env)) {
+		switch (step) {
+			case eLaneStart:
+				SW_OUT_create_files();
+				break;
+
+			case eLaneBeginYear:
+				SW_CTL_begin_year(x->sw, (TimeInt) arg);
+				break;
+
+			case eLaneBeginDay:
+				x->today = SW_CTL_begin_day(x->sw, NULL);
+				break;
+
+			case eLaneWaterFlow:
+				SW_CTL_water_flow_part(x->sw, NULL, arg);
+				break;
+
+			case eLaneEndDay:
+				SW_CTL_end_day(x->sw);
+				break;
+
+			case eLaneEndYear:
+				SW_CTL_end_year(x->sw);
+				break;
+
+			case eLaneEnd:
+				SW_OUT_close_files();
+
+				// per-phase breakdown of a profiling build, to the logfile of the site
+				SW_PROFILE_REPORT();
+
+				if (batch->log_diagnostics) {
+					SW_FLW_log_diagnostics();
+				}
+				break;
+		}
+
+	} else {
+		x->site->failed = swTRUE;
+		strcpy(x->site->msg, x->handler.msg);
+		x->active = x->today = swFALSE;
+	}
+
+	LogError_handler = NULL;
+	LogError_buffer = NULL;
+	logfp = stderr;
+}
+
+
+/** Set up and simulate a group of sites together
+
+  The sites of the group are simulated day by day in lock-step; between
+  the parts of the water flow of a day (see `SW_CTL_water_flow_part()`),
+  the percolation of all sites is calculated at once in lanes (see
+  `SW_FLW_percolate_lanes()`). A site is simulated alone if its setup
+  failed, if it uses the weather generator (its normal deviates depend on
+  the order of the draws of the thread, see `RandNorm()`), or if it does
+  not simulate the same days and soil layers as the first site of the
+  group. Checkpoints are not written.
+
+  @param w Calling worker; the cost model of its schedule is updated.
+  @param g Group of sites.
+*/
+static void run_group(SW_BATCH_WORKER *w, const SW_BATCH_GROUP *g) {
+	SW_BATCH_SCHEDULE *s = w->sched;
+	SW_BATCH_COUNTERS *c = &w->count;
+	SW_BATCH_LANE lanes[SW_LANES], *x;
+	SW_RUN *runs[SW_LANES];
+	struct timespec start;
+	uint64_t begin, setup_start, setup_ns;
+	TimeInt year, endyr;
+	unsigned int i, k, m = 0, n, part;
+
+	begin = count_begin(c);
+
+	for (i = 0; i < g->n; i++) {
+		x = &lanes[m];
+		x->site = &s->batch->sites[s->grouped[g->first + i]];
+		x->logbuf.text = NULL;
+		x->logbuf.len = x->logbuf.size = 0;
+
+		count_add(&c->claimed, 1);
+		setup_start = now_ns();
+		x->sw = setup_site(x->site, s->batch, &x->logbuf, swFALSE, w->node);
+		setup_ns = now_ns() - setup_start;
+		count_setup(c, setup_ns);
+
+		x->setup_seconds = 1e-9 * (double) setup_ns;
+		x->logfp = logfp;
+		x->active = swTRUE;
+		x->today = swFALSE;
+
+		if (x->site->failed || x->sw->Weather.use_weathergenerator ||
+			(m > 0 && !same_days(lanes[0].sw, x->sw))) {
+
+			count_add(&c->started, 1);
+			simulate_site(x->site, x->sw, s, &x->logbuf, x->setup_seconds, c);
+		} else {
+			logfp = stderr;
+			m++;
+		}
+	}
+
+	if (1 == m) {
+		count_add(&c->started, 1);
+		logfp = lanes[0].logfp;
+		simulate_site(lanes[0].site, lanes[0].sw, s, &lanes[0].logbuf,
+			lanes[0].setup_seconds, c);
+
+	} else if (m > 1) {
+		timespec_get(&start, TIME_UTC);
+
+		// the calendar of `Times.c` is per thread, see `simulate_site()`
+		Time_init_model();
+
+		SW_TRC_START(group);
+
+		for (k = 0; k < m; k++) {
+			count_add(&c->started, 1);
+			lane_step(&lanes[k], s->batch, eLaneStart, 0);
+		}
+
+		endyr = lanes[0].sw->Model.endyr;
+		for (year = lanes[0].sw->Model.startyr; year <= endyr; year++) {
+			for (k = 0; k < m; k++) {
+				lane_step(&lanes[k], s->batch, eLaneBeginYear, year);
+			}
+
+			for (;;) {
+				n = 0;
+				for (k = 0; k < m; k++) {
+					lane_step(&lanes[k], s->batch, eLaneBeginDay, 0);
+					n += lanes[k].today ? 1 : 0;
+				}
+				if (0 == n) {
+					break;
+				}
+
+				for (part = 0; part < SW_FLW_NPARTS; part++) {
+					n = 0;
+					for (k = 0; k < m; k++) {
+						if (lanes[k].today) {
+							lane_step(&lanes[k], s->batch, eLaneWaterFlow, part);
+						}
+						if (lanes[k].today) {
+							runs[n++] = lanes[k].sw;
+						}
+					}
+
+					if (part < SW_FLW_NPARTS - 1) {
+						SW_FLW_percolate_lanes(runs, n, part);
+					}
+				}
+
+				for (k = 0; k < m; k++) {
+					if (lanes[k].today) {
+						lane_step(&lanes[k], s->batch, eLaneEndDay, 0);
+					}
+				}
+			}
+
+			for (k = 0; k < m; k++) {
+				lane_step(&lanes[k], s->batch, eLaneEndYear, 0);
+			}
+		}
+
+		for (k = 0; k < m; k++) {
+			lane_step(&lanes[k], s->batch, eLaneEnd, 0);
+		}
+
+		SW_TRC_STOP_INT(group, "site group", "site", "sites", m);
+
+		for (k = 0; k < m; k++) {
+			logfp = lanes[k].logfp;
+			finish_site(lanes[k].site, lanes[k].sw, s, &lanes[k].logbuf,
+				lanes[k].setup_seconds, &start, m, c);
+		}
+	}
+
+	count_end(c, begin);
+}
+
+
+/** Wait until it is the turn of position `seq` at a slot of the prefetch ring */
+static void wait_slot(SW_BATCH_PREFETCH *f, SW_BATCH_READY *r,
+	unsigned int seq) {
+
+	if (__atomic_load_n(&r->seq, __ATOMIC_ACQUIRE) == seq) {
+		return;
+	}
+
+	pthread_mutex_lock(&f->lock);
+	while (__atomic_load_n(&r->seq, __ATOMIC_ACQUIRE) != seq) {
+		pthread_cond_wait(&f->cond, &f->lock);
+	}
+	pthread_mutex_unlock(&f->lock);
+}
+
+
+/** Pass a slot of the prefetch ring on to position `seq` */
+static void post_slot(SW_BATCH_PREFETCH *f, SW_BATCH_READY *r,
+	unsigned int seq) {
+
+	__atomic_store_n(&r->seq, seq, __ATOMIC_RELEASE);
+
+	// a thread that found the slot not ready is asleep or about to be
+	pthread_mutex_lock(&f->lock);
+	pthread_cond_broadcast(&f->cond);
+	pthread_mutex_unlock(&f->lock);
+}
+
+
+/** Thread function of a reader: set up the next sites of the longest-first
+    list until all sites are claimed */
+static void *read_worker(void *arg) {
+	SW_BATCH_WORKER *w = (SW_BATCH_WORKER *) arg;
+	SW_BATCH_SCHEDULE *s = w->sched;
+	SW_BATCH_PREFETCH *f = s->prefetch;
+	SW_BATCH_READY *r;
+	uint64_t start, setup_ns;
+	unsigned int i;
+	char name[32];
+
+	snprintf(name, sizeof name, "reader %u", w->id);
+	SW_TRC_thread_name(name);
+
+	// readers are placed after the workers
+	w->node = isnull(s->numa) ? -1 : SW_BAT_numa_pin(s->numa, s->n_workers + w->id);
+
+	while ((i = __atomic_fetch_add(&f->next_read, 1u, __ATOMIC_RELAXED)) <
+		s->batch->n_sites) {
+
+		r = &f->slots[i % f->depth];
+		wait_slot(f, r, i);
+
+		count_add(&w->count.claimed, 1);
+		start = count_begin(&w->count);
+		r->logbuf.text = NULL;
+		r->logbuf.len = r->logbuf.size = 0;
+		r->sw = setup_site(&s->batch->sites[s->lpt[i]], s->batch, &r->logbuf,
+			swTRUE, w->node);
+		r->node = w->node;
+		setup_ns = now_ns() - start;
+		r->seconds = 1e-9 * (double) setup_ns;
+		count_setup(&w->count, setup_ns);
+
+		// the logfile of the site goes with its context to the worker
+		r->logfp = logfp;
+		logfp = stderr;
+
+		post_slot(f, r, i + 1);
+		count_add(&w->count.sites, 1);
+		count_end(&w->count, start);
+	}
+
+	return NULL;
+}
+
+
+/** Thread function of a worker: simulate sites until all queues are empty,
+    with readers, until all sites of the longest-first list are claimed, or,
+    in lanes, until all groups are claimed */
+static void *run_worker(void *arg) {
+	SW_BATCH_WORKER *w = (SW_BATCH_WORKER *) arg;
+	SW_BATCH_SCHEDULE *s = w->sched;
+	SW_BATCH_PREFETCH *f = s->prefetch;
+	SW_BATCH_READY *r, ready;
+	uint64_t start;
+	unsigned int i, isite;
+	char name[32];
+
+	snprintf(name, sizeof name, "worker %u", w->id);
+	SW_TRC_thread_name(name);
+
+	w->node = isnull(s->numa) ? -1 : SW_BAT_numa_pin(s->numa, w->id);
+
+	if (!isnull(s->groups)) {
+		while ((i = __atomic_fetch_add(&s->next_group, 1u, __ATOMIC_RELAXED)) <
+			s->n_groups) {
+
+			run_group(w, &s->groups[i]);
+		}
+
+		return NULL;
+	}
+
+	if (isnull(f)) {
+		while (take_site(w, &isite)) {
+			run_site(&s->batch->sites[isite], w);
+		}
+
+		return NULL;
+	}
+
+	while ((i = __atomic_fetch_add(&f->next_run, 1u, __ATOMIC_RELAXED)) <
+		s->batch->n_sites) {
+
+		r = &f->slots[i % f->depth];
+		wait_slot(f, r, i + 1);
+		ready = *r;
+		post_slot(f, r, i + f->depth);
+
+		count_add(&w->count.started, 1);
+		start = count_begin(&w->count);
+
+		// the context and its arena (e.g., the output arrays) were
+		// first touched by the reader
+		if (ready.node != w->node && w->node >= 0) {
+			SW_BAT_numa_move(s->numa, ready.sw, sizeof(SW_RUN), &ready.sw->Arena,
+				w->node);
+		}
+
+		logfp = ready.logfp;
+		simulate_site(&s->batch->sites[s->lpt[i]], ready.sw, s, &ready.logbuf,
+			ready.seconds, &w->count);
+		count_end(&w->count, start);
+	}
+
+	return NULL;
+}
+
+
+/** Print a metric of each thread of a batch in the Prometheus text format */
+static void print_thread_metric(FILE *fp, const SW_BATCH_METRICS *m,
+	const SW_BATCH_METRIC *d) {
+
+	const SW_BATCH_WORKER *w;
+	uint64_t x;
+	unsigned int i;
+
+	fprintf(fp, "# HELP %s %s\n# TYPE %s %s\n", d->name, d->help, d->name,
+		d->type);
+
+	for (i = 0; i < m->sched->n_workers + m->n_readers; i++) {
+		w = &m->threads[i];
+		x = count_get((const uint64_t *) ((const char *) &w->count + d->offset));
+
+		fprintf(fp, "%s{thread=\"%s %u\"} ", d->name,
+			(i < m->sched->n_workers) ? "worker" : "reader", w->id);
+		if (1. == d->scale) {
+			fprintf(fp, "%llu\n", (unsigned long long) x);
+		} else {
+			fprintf(fp, "%.6f\n", d->scale * (double) x);
+		}
+	}
+}
+
+
+/** Write the live metrics of a batch to its metrics file
+
+  The metrics are written to a temporary file that then replaces the
+  metrics file so that a reader never sees a partial file. The sites of
+  the batch are counted by their state: waiting to be set up, being set
+  up, set up and waiting for a worker (only with readers), being
+  simulated, succeeded, and failed. Counters are read without locks while
+  the threads update them; the states are only approximately consistent.
+
+  @param m Publisher of the metrics.
+
+  @return FALSE if the metrics file could not be written.
+*/
+static Bool write_metrics(const SW_BATCH_METRICS *m) {
+	const SW_BATCH_SCHEDULE *s = m->sched;
+	const char *metricsfile = s->batch->metrics_file;
+	const SW_BATCH_COUNTERS *c;
+	uint64_t now = now_ns(), since;
+	long long claimed = 0, started = 0, done = 0, failed = 0, in_setup = 0,
+		setup, n[6];
+	const char *states[6] = {"waiting", "setup", "ready", "running",
+		"succeeded", "failed"};
+	char tmpfile[MAX_FILENAMESIZE + 8];
+	unsigned int i, k;
+	FILE *fp;
+	Bool ok;
+
+	for (i = 0; i < s->n_workers + m->n_readers; i++) {
+		c = &m->threads[i].count;
+		claimed += (long long) count_get(&c->claimed);
+		started += (long long) count_get(&c->started);
+
+		if (i < s->n_workers) {
+			done += (long long) count_get(&c->sites);
+			failed += (long long) count_get(&c->failed);
+		} else if (0 != count_get(&c->since_ns)) {
+			in_setup++;
+		}
+	}
+
+	// with readers, a site is claimed at the start of its setup
+	setup = (m->n_readers > 0) ? in_setup : claimed - started;
+	n[0] = (long long) s->batch->n_sites - claimed;
+	n[1] = setup;
+	n[2] = claimed - started - setup;
+	n[3] = started - done;
+	n[4] = done - failed;
+	n[5] = failed;
+
+	snprintf(tmpfile, sizeof tmpfile, "%s.tmp", metricsfile);
+	fp = fopen(tmpfile, "w");
+	if (isnull(fp)) {
+		return swFALSE;
+	}
+
+	fprintf(fp,
+		"# HELP sw2_batch_sites Sites of the batch by state\n"
+		"# TYPE sw2_batch_sites gauge\n");
+	for (k = 0; k < 6; k++) {
+		fprintf(fp, "sw2_batch_sites{state=\"%s\"} %lld\n", states[k],
+			max(n[k], 0));
+	}
+
+	fprintf(fp,
+		"# HELP sw2_batch_threads Threads of the batch by role\n"
+		"# TYPE sw2_batch_threads gauge\n"
+		"sw2_batch_threads{role=\"worker\"} %u\n"
+		"sw2_batch_threads{role=\"reader\"} %u\n"
+		"# HELP sw2_batch_elapsed_seconds Time since the start of the simulations\n"
+		"# TYPE sw2_batch_elapsed_seconds gauge\n"
+		"sw2_batch_elapsed_seconds %.6f\n",
+		s->n_workers, m->n_readers, 1e-9 * (double) (now - m->start_ns));
+
+	for (k = 0; k < sizeof metric_defs / sizeof metric_defs[0]; k++) {
+		print_thread_metric(fp, m, &metric_defs[k]);
+	}
+
+	// a straggler is a thread that has been on its current site for long
+	fprintf(fp,
+		"# HELP sw2_batch_current_site_seconds Time that the thread has spent on its current site\n"
+		"# TYPE sw2_batch_current_site_seconds gauge\n");
+	for (i = 0; i < s->n_workers + m->n_readers; i++) {
+		since = count_get(&m->threads[i].count.since_ns);
+		fprintf(fp, "sw2_batch_current_site_seconds{thread=\"%s %u\"} %.6f\n",
+			(i < s->n_workers) ? "worker" : "reader", m->threads[i].id,
+			(0 != since && now > since) ? 1e-9 * (double) (now - since) : 0.);
+	}
+
+	#ifdef SW_PROFILE
+	fprintf(fp,
+		"# HELP sw2_batch_phase_ticks_total Cycle counter ticks of the profiled phases of the simulated sites\n"
+		"# TYPE sw2_batch_phase_ticks_total counter\n");
+	for (i = 0; i < s->n_workers; i++) {
+		for (k = 0; k < SW_PROFILE_NPHASES; k++) {
+			fprintf(fp,
+				"sw2_batch_phase_ticks_total{thread=\"worker %u\",phase=\"%s\"} %llu\n",
+				m->threads[i].id, SW_PROFILE_name((int) k),
+				(unsigned long long) count_get(&m->threads[i].count.ticks[k]));
+		}
+	}
+
+	fprintf(fp,
+		"# HELP sw2_batch_phase_calls_total Calls of the profiled phases of the simulated sites\n"
+		"# TYPE sw2_batch_phase_calls_total counter\n");
+	for (i = 0; i < s->n_workers; i++) {
+		for (k = 0; k < SW_PROFILE_NPHASES; k++) {
+			fprintf(fp,
+				"sw2_batch_phase_calls_total{thread=\"worker %u\",phase=\"%s\"} %llu\n",
+				m->threads[i].id, SW_PROFILE_name((int) k),
+				(unsigned long long) count_get(&m->threads[i].count.calls[k]));
+		}
+	}
+	#endif
+
+	ok = (Bool) !ferror(fp);
+	ok = (Bool) (0 == fclose(fp) && ok);
+
+	if (!ok || 0 != rename(tmpfile, metricsfile)) {
+		remove(tmpfile);
+		return swFALSE;
+	}
+
+	return swTRUE;
+}
+
+
+/** Thread function of the publisher: write the metrics file every
+    `metrics_interval` seconds until the end of the batch */
+static void *publish_worker(void *arg) {
+	SW_BATCH_METRICS *m = (SW_BATCH_METRICS *) arg;
+	double interval = m->sched->batch->metrics_interval;
+	struct timespec next;
+	int rc;
+
+	SW_TRC_thread_name("metrics");
+
+	pthread_mutex_lock(&m->lock);
+
+	while (!m->stop) {
+		timespec_get(&next, TIME_UTC);
+		next.tv_sec += (time_t) interval;
+		next.tv_nsec += (long) (1e9 * (interval - (double) (time_t) interval));
+		if (next.tv_nsec >= 1000000000L) {
+			next.tv_sec++;
+			next.tv_nsec -= 1000000000L;
+		}
+
+		rc = 0;
+		while (!m->stop && ETIMEDOUT != rc) {
+			rc = pthread_cond_timedwait(&m->cond, &m->lock, &next);
+		}
+
+		if (!m->stop) {
+			// a failed write is retried at the next interval
+			pthread_mutex_unlock(&m->lock);
+			write_metrics(m);
+			pthread_mutex_lock(&m->lock);
+		}
+	}
+
+	pthread_mutex_unlock(&m->lock);
+
+	return NULL;
+}
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Read the sites of a batch from a manifest
+
+Each (non-comment) line of the manifest is either a site directory,
+which is expected to contain `files.in`, or the path to the main input file
+of a site. Relative paths are relative to the working directory.
+
+@param batch Batch of sites; existing sites are discarded.
+@param manifest Name of the manifest file.
+*/
+void SW_BAT_read_manifest(SW_BATCH *batch, const char *manifest) {
+	SW_TEXTFILE f;
+	char buf[MAX_FILENAMESIZE];
+	size_t len, n_alloc = 0;
+
+	batch->sites = NULL;
+	batch->n_sites = batch->n_failed = 0;
+	batch->preload_weather = swFALSE;
+	batch->n_readers = 0;
+	batch->out_format = SW_OUTFORMAT_CSV;
+	memset(&batch->checkpoint, 0, sizeof batch->checkpoint);
+	batch->log_diagnostics = swFALSE;
+	batch->metrics_file = NULL;
+	batch->metrics_interval = SW_BAT_METRICS_INTERVAL;
+	batch->pin_threads = swFALSE;
+	batch->lanes = swFALSE;
+	batch->n_nodes = 0;
+	memset(batch->shared, 0, sizeof batch->shared);
+	memset(&batch->cost, 0, sizeof batch->cost);
+
+	OpenTextFile(&f, manifest);
+
+	while (GetATextLine(&f)) {
+		if (strlen(f.line) + strlen(DFLT_FIRSTFILE) + 1 >= sizeof buf) {
+			CloseTextFile(&f);
+			LogError(logfp, LOGFATAL, "Manifest %s: site name is too long", manifest);
+		}
+		strcpy(buf, f.line);
+
+		if (DirExists(buf)) {
+			len = strlen(buf);
+			if (len > 0 && buf[len - 1] != '/') {
+				strcat(buf, "/");
+			}
+			strcat(buf, DFLT_FIRSTFILE);
+		}
+
+		if (batch->n_sites == n_alloc) {
+			n_alloc = (0 == n_alloc) ? 16 : 2 * n_alloc;
+			batch->sites = (SW_BATCH_SITE *) (isnull(batch->sites) ?
+				Mem_Malloc(n_alloc * sizeof(SW_BATCH_SITE), "SW_BAT_read_manifest()") :
+				Mem_ReAlloc(batch->sites, n_alloc * sizeof(SW_BATCH_SITE)));
+		}
+
+		batch->sites[batch->n_sites].firstfile = Str_Dup(buf);
+		batch->sites[batch->n_sites].failed = swFALSE;
+		batch->sites[batch->n_sites].msg[0] = '\0';
+		batch->sites[batch->n_sites].n_years = 0;
+		batch->sites[batch->n_sites].n_layers = 0;
+		batch->sites[batch->n_sites].soil_temp = swFALSE;
+		batch->sites[batch->n_sites].startyr = 0;
+		batch->sites[batch->n_sites].startstart = 0;
+		batch->sites[batch->n_sites].endend = 0;
+		batch->sites[batch->n_sites].seconds = 0.;
+		batch->sites[batch->n_sites].context_bytes = 0;
+		batch->n_sites++;
+	}
+
+	CloseTextFile(&f);
+
+	if (0 == batch->n_sites) {
+		LogError(logfp, LOGFATAL, "Manifest %s does not list any sites", manifest);
+	}
+}
+
+
+/**
+@brief Simulate all sites of a batch with a pool of worker threads
+
+The worker threads first read the inputs of the cost model of each site;
+sites are then scheduled longest-first (see `SW_Batch.c`). The cost model
+is set up with its defaults unless a previous call calibrated it.
+If `batch->n_readers` is not 0, then that many reader threads set up the
+sites ahead of the workers. If `batch->pin_threads` is set, then the
+workers and readers are pinned to CPUs across the NUMA nodes, see
+`SW_BAT_numa_pin()`. If `batch->metrics_file` is set, then the live
+metrics of the threads are written to it at the start, every
+`batch->metrics_interval` seconds, and at the end of the simulations.
+If `batch->lanes` is set, then sites with the same calendar and number of
+soil layers are simulated together, `SW_LANES` sites at a time, with the
+percolation in lanes (see `SW_Batch.c`); checkpoints and reader threads
+are not used.
+
+@param batch Batch of sites; updated with the status and run time of each
+  simulation and with the calibrated cost model and the predicted, fitted,
+  and observed makespan (`batch->cost`).
+@param n_threads Number of worker threads; `0` uses
+  `SW_BAT_default_nthreads()`. At most one thread per site is used.
+*/
+void SW_BAT_run(SW_BATCH *batch, unsigned int n_threads) {
+	SW_BATCH_SCHEDULE sched;
+	SW_BATCH_PREFETCH prefetch;
+	SW_BATCH_METRICS metrics;
+	SW_BATCH_NUMA numa;
+	SW_BATCH_COST *c = &batch->cost;
+	SW_BATCH_WORKER *workers;
+	pthread_t *threads, publisher;
+	struct timespec start;
+	double *planned, makespan = 0.;
+	unsigned int i, n_failed = 0,
+		n_readers = batch->lanes ? 0 : batch->n_readers;
+
+	if (0 == n_threads) {
+		n_threads = SW_BAT_default_nthreads();
+	}
+	n_threads = min(n_threads, batch->n_sites);
+	n_threads = max(n_threads, 1);
+
+	if (0. == c->scale) {
+		memset(c, 0, sizeof *c);
+		c->base = SW_BAT_COST_BASE;
+		c->per_layer = SW_BAT_COST_PER_LAYER;
+		c->st_per_layer = SW_BAT_COST_ST_PER_LAYER;
+		c->scale = 1.;
+		c->substeps = SW_BAT_COST_SUBSTEPS;
+	}
+
+	sched.batch = batch;
+	sched.n_workers = n_threads;
+	sched.queues = (SW_BATCH_QUEUE *) Mem_Calloc(n_threads, sizeof(SW_BATCH_QUEUE), "SW_BAT_run()");
+	sched.order = (unsigned int *) Mem_Calloc(batch->n_sites, sizeof(unsigned int), "SW_BAT_run()");
+	sched.lpt = (unsigned int *) Mem_Calloc(batch->n_sites, sizeof(unsigned int), "SW_BAT_run()");
+	sched.groups = NULL;
+	sched.grouped = NULL;
+	sched.n_groups = sched.next_group = 0;
+	sched.prefetch = NULL;
+	sched.numa = NULL;
+	pthread_mutex_init(&sched.lock, NULL);
+
+	batch->n_nodes = 0;
+	if (batch->pin_threads) {
+		SW_BAT_numa_topology(&numa);
+		if (numa.n_nodes > 0) {
+			sched.numa = &numa;
+			batch->n_nodes = numa.n_nodes;
+		} else {
+			LogError(logfp, LOGWARN, "Threads of the batch cannot be pinned to CPUs");
+		}
+	}
+	workers = (SW_BATCH_WORKER *) Mem_Calloc(n_threads + n_readers, sizeof(SW_BATCH_WORKER), "SW_BAT_run()");
+	threads = (pthread_t *) Mem_Calloc(n_threads + n_readers, sizeof(pthread_t), "SW_BAT_run()");
+	planned = (double *) Mem_Calloc(2 * n_threads, sizeof(double), "SW_BAT_run()");
+
+	// each worker estimates the costs of a contiguous block of sites
+	for (i = 0; i < n_threads; i++) {
+		pthread_mutex_init(&sched.queues[i].lock, NULL);
+
+		workers[i].sched = &sched;
+		workers[i].id = i;
+		workers[i].first = (unsigned int) ((unsigned long) i * batch->n_sites / n_threads);
+		workers[i].last = (unsigned int) ((unsigned long) (i + 1) * batch->n_sites / n_threads);
+	}
+
+	for (i = 0; i < n_readers; i++) {
+		workers[n_threads + i].sched = &sched;
+		workers[n_threads + i].id = i;
+	}
+
+	for (i = 0; i < n_threads; i++) {
+		if (0 != pthread_create(&threads[i], NULL, estimate_worker, &workers[i])) {
+			LogError(logfp, LOGFATAL, "Cannot start worker thread %u of batch", i);
+		}
+	}
+
+	for (i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	c->n_workers = n_threads;
+	c->predicted_makespan = deal_sites(&sched);
+
+	// workers take groups instead of the sites of their queues
+	if (batch->lanes) {
+		group_sites(&sched);
+	}
+
+	for (i = 0; i < n_threads; i++) {
+		planned[2 * i] = sched.queues[i].fixed;
+		planned[2 * i + 1] = sched.queues[i].per_substep;
+	}
+
+	// each worker holds one site while the readers set up the next ones;
+	// with one slot, a site that is ready for the worker (`seq == i + 1`)
+	// could not be told apart from a free slot for the next reader
+	if (n_readers > 0) {
+		prefetch.depth = max(max(n_threads, n_readers), 2);
+		prefetch.slots = (SW_BATCH_READY *) Mem_Calloc(prefetch.depth,
+			sizeof(SW_BATCH_READY), "SW_BAT_run()");
+		for (i = 0; i < prefetch.depth; i++) {
+			prefetch.slots[i].seq = i;
+		}
+		prefetch.next_read = prefetch.next_run = 0;
+		pthread_mutex_init(&prefetch.lock, NULL);
+		pthread_cond_init(&prefetch.cond, NULL);
+		sched.prefetch = &prefetch;
+	}
+
+	timespec_get(&start, TIME_UTC);
+
+	if (!isnull(batch->metrics_file)) {
+		metrics.sched = &sched;
+		metrics.threads = workers;
+		metrics.n_readers = n_readers;
+		metrics.start_ns = now_ns();
+		metrics.stop = swFALSE;
+		pthread_mutex_init(&metrics.lock, NULL);
+		pthread_cond_init(&metrics.cond, NULL);
+
+		if (!write_metrics(&metrics)) {
+			LogError(logfp, LOGFATAL, "Cannot write metrics file %s",
+				batch->metrics_file);
+		}
+		if (0 != pthread_create(&publisher, NULL, publish_worker, &metrics)) {
+			LogError(logfp, LOGFATAL, "Cannot start metrics thread of batch");
+		}
+	}
+
+	for (i = 0; i < n_readers; i++) {
+		if (0 != pthread_create(&threads[n_threads + i], NULL, read_worker,
+			&workers[n_threads + i])) {
+			LogError(logfp, LOGFATAL, "Cannot start reader thread %u of batch", i);
+		}
+	}
+
+	for (i = 0; i < n_threads; i++) {
+		if (0 != pthread_create(&threads[i], NULL, run_worker, &workers[i])) {
+			LogError(logfp, LOGFATAL, "Cannot start worker thread %u of batch", i);
+		}
+	}
+
+	for (i = 0; i < n_threads + n_readers; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	c->makespan = seconds_since(&start);
+
+	if (!isnull(batch->metrics_file)) {
+		pthread_mutex_lock(&metrics.lock);
+		metrics.stop = swTRUE;
+		pthread_cond_signal(&metrics.cond);
+		pthread_mutex_unlock(&metrics.lock);
+		pthread_join(publisher, NULL);
+
+		if (!write_metrics(&metrics)) {
+			LogError(logfp, LOGWARN, "Cannot write metrics file %s",
+				batch->metrics_file);
+		}
+		pthread_cond_destroy(&metrics.cond);
+		pthread_mutex_destroy(&metrics.lock);
+	}
+
+	// the planned schedule with the cost model fit to its own sites, i.e.,
+	// this tells how well the form of the model fits, not how well it predicts
+	for (i = 0; i < n_threads; i++) {
+		makespan = max(makespan, planned[2 * i] + c->substeps * planned[2 * i + 1]);
+	}
+	c->fitted_makespan = c->scale * makespan;
+	c->n_runs++;
+
+	// other workers may steal from a queue until all workers are done
+	for (i = 0; i < n_threads; i++) {
+		pthread_mutex_destroy(&sched.queues[i].lock);
+	}
+	pthread_mutex_destroy(&sched.lock);
+
+	if (n_readers > 0) {
+		pthread_cond_destroy(&prefetch.cond);
+		pthread_mutex_destroy(&prefetch.lock);
+		Mem_Free(prefetch.slots);
+	}
+
+	for (i = 0; i < batch->n_sites; i++) {
+		if (batch->sites[i].failed) {
+			n_failed++;
+		}
+	}
+	batch->n_failed = n_failed;
+
+	if (batch->pin_threads) {
+		SW_BAT_numa_deconstruct(&numa);
+	}
+
+	if (!isnull(sched.groups)) {
+		Mem_Free(sched.groups);
+		Mem_Free(sched.grouped);
+	}
+
+	Mem_Free(planned);
+	Mem_Free(threads);
+	Mem_Free(workers);
+	Mem_Free(sched.lpt);
+	Mem_Free(sched.order);
+	Mem_Free(sched.queues);
+}
+
+
+/**
+@brief Print the number of simulated sites, the makespan of the schedule,
+  and the error message of each failed site
+
+@param batch Batch of sites after `SW_BAT_run()`.
+*/
+void SW_BAT_print_summary(SW_BATCH *batch) {
+	unsigned int i;
+	char model[64];
+
+	swprintf(
+		"Batch: %u sites simulated, %u succeeded, %u failed\n",
+		batch->n_sites, batch->n_sites - batch->n_failed, batch->n_failed
+	);
+
+	if (batch->cost.n_workers > 0) {
+		if (batch->cost.n_runs > 1) {
+			snprintf(model, sizeof model, "cost model of %u previous run%s",
+				batch->cost.n_runs - 1, (batch->cost.n_runs > 2) ? "s" : "");
+		} else {
+			snprintf(model, sizeof model, "default cost model");
+		}
+
+		swprintf(
+			"Batch: longest-first schedule of %u workers (%u readers), makespan "
+			"predicted before the run %.2f s (%s), actual %.2f s "
+			"(%.2f s with the cost model fit to this run)\n",
+			batch->cost.n_workers, batch->n_readers, batch->cost.predicted_makespan,
+			model, batch->cost.makespan, batch->cost.fitted_makespan
+		);
+	}
+
+	if (batch->n_nodes > 0) {
+		swprintf("Batch: threads pinned to CPUs across %u NUMA node%s\n",
+			batch->n_nodes, (batch->n_nodes > 1) ? "s" : "");
+	}
+
+	for (i = 0; i < batch->n_sites; i++) {
+		if (batch->sites[i].failed) {
+			swprintf("  FAILED %s: %s\n", batch->sites[i].firstfile, batch->sites[i].msg);
+		}
+	}
+}
+
+
+/**
+@brief Free the memory of a batch
+
+@param batch Batch of sites.
+*/
+void SW_BAT_deconstruct(SW_BATCH *batch) {
+	unsigned int i;
+
+	for (i = 0; i < batch->n_sites; i++) {
+		Mem_Free(batch->sites[i].firstfile);
+	}
+
+	if (!isnull(batch->sites)) {
+		Mem_Free(batch->sites);
+	}
+
+	batch->sites = NULL;
+	batch->n_sites = batch->n_failed = 0;
+
+	for (i = 0; i < SW_BATCH_MAXNODES; i++) {
+		SW_SHR_deconstruct(&batch->shared[i]);
+	}
+}
+
+
+/**
+@brief Number of worker threads if not requested otherwise
+
+@return Number of online processors (or 1 if unknown).
+*/
+unsigned int SW_BAT_default_nthreads(void) {
+	long n = 1;
+
+	#ifdef _SC_NPROCESSORS_ONLN
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	#endif
+
+	return (n > 0) ? (unsigned int) n : 1;
+}
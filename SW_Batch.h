@@ -0,0 +1,139 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Batch.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Run many independent sites with SOILWAT2-standalone:
+ *           a manifest lists the sites, a pool of worker threads
+ *           simulates them (one simulation run context per worker),
+ *           outputs are written per site, and failing sites are
+ *           collected for a summary.
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ *     2026-10-15 sites share the input tables of identical input files
+ *     2026-10-15 added SW_BAT_run_mpi() to distribute sites across MPI ranks
+ *     2026-10-15 sites are scheduled longest-first by a cost model (SW_BATCH_COST)
+ *     2026-10-15 added reader threads that set up sites ahead of the workers
+ *     2026-10-15 live metrics of the threads are published to a file
+ *     2026-10-15 threads can be pinned to the CPUs of the NUMA nodes
+ *                (SW_Batch_numa.c); shared input tables are replicated per node
+ *     2026-10-15 memory of the simulation run context of each site (for sw_bench_batch)
+ *     2026-10-15 sites with the same calendar and number of soil layers can be
+ *                simulated together in lanes (SW_BATCH.lanes)
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_BATCH_H
+#define SW_BATCH_H
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "SW_Checkpoint.h"
+#include "SW_Shared.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+#define SW_BATCH_MAXNODES 16 /**< NUMA nodes that threads are pinned to, see `SW_BATCH_NUMA` */
+
+/** One site of a batch */
+typedef struct {
+	char *firstfile; /**< name of the main input file (`files.in`) of the site */
+	Bool failed; /**< TRUE if the simulation of the site failed */
+	char msg[ERRSTRLEN]; /**< error message if the site failed */
+
+	unsigned int n_years, n_layers; /**< inputs of the cost model (0 if unknown), see `SW_BATCH_COST` */
+	Bool soil_temp; /**< TRUE if the site simulates soil temperature */
+	TimeInt startyr, startstart, endend; /**< calendar of the site (0 if unknown), see `SW_BATCH.lanes` */
+	double seconds; /**< observed run time of the site */
+	size_t context_bytes; /**< memory of the simulation run context of the site (`SW_RUN` and its arena) */
+} SW_BATCH_SITE;
+
+/** Cost model of the sites of a batch
+
+  The predicted run time (seconds) of a site is
+  `scale * n_years * (base + per_layer * n_layers + st_per_layer * n_layers * substeps)`
+  where the last term applies only to sites that simulate soil temperature.
+  `scale` and `substeps` are updated by each site that finishes; they
+  carry over to the next `SW_BAT_run()` of the batch.
+*/
+typedef struct {
+	double
+		base, per_layer, /**< seconds per simulated year and per soil layer and year */
+		st_per_layer, /**< seconds per soil layer, year, and soil temperature sub-step per day */
+		scale, /**< ratio of observed to predicted run time of finished sites; 0 if not set up */
+		substeps, /**< mean soil temperature sub-steps per day of finished sites */
+		sum_observed, sum_predicted, /**< run times of finished sites (to update `scale`) */
+		st_days, st_steps; /**< soil temperature days and sub-steps of finished sites (to update `substeps`) */
+
+	unsigned int
+		n_workers, /**< worker threads of the last `SW_BAT_run()`; 0 if none */
+		n_runs; /**< calls of `SW_BAT_run()` that updated the model, including the last one */
+	double
+		predicted_makespan, /**< of the last schedule, predicted at its start (seconds) with the model of the previous runs */
+		fitted_makespan, /**< of the last schedule, with `scale` fit to its own sites; not a prediction */
+		makespan; /**< observed run time of the last schedule */
+} SW_BATCH_COST;
+
+/** NUMA topology of the machine, see `SW_BAT_numa_topology()` */
+typedef struct {
+	unsigned int n_nodes, n_cpus,
+		*cpus, /**< CPUs that the process may run on, grouped by node */
+		first[SW_BATCH_MAXNODES + 1]; /**< CPUs of node `k` are `cpus[first[k]]` to `cpus[first[k + 1] - 1]` */
+	int node[SW_BATCH_MAXNODES]; /**< number of each node in the system */
+} SW_BATCH_NUMA;
+
+/** A batch of sites */
+typedef struct {
+	SW_BATCH_SITE *sites;
+	unsigned int n_sites, /**< number of sites of the batch */
+		n_failed; /**< number of failed sites, updated by `SW_BAT_run()` */
+	Bool preload_weather; /**< preload weather of all years, see `SW_WTH_preload()` */
+	unsigned int n_readers; /**< threads that set up upcoming sites ahead of the workers; 0 if workers set up their own sites */
+	int out_format; /**< output format(s), see `SW_OUT_set_format()` */
+	SW_CHECKPOINT checkpoint; /**< checkpoints of each site, see `SW_CKP_run()` */
+	Bool log_diagnostics; /**< log solver diagnostics of each site, see `SW_FLW_log_diagnostics()` */
+	const char *metrics_file; /**< file of live metrics in the Prometheus text format, see `SW_BAT_run()`; NULL if none */
+	double metrics_interval; /**< seconds between two writes of the metrics file */
+	Bool pin_threads; /**< pin threads to CPUs across the NUMA nodes, see `SW_BAT_numa_pin()` */
+	Bool lanes; /**< simulate sites with the same calendar and number of soil layers together, see `SW_BAT_run()`; not with checkpoints or readers */
+	unsigned int n_nodes; /**< NUMA nodes of the pinned threads of the last `SW_BAT_run()`; 0 if not pinned */
+	SW_SHARED_INPUTS shared[SW_BATCH_MAXNODES]; /**< input tables that are shared by the sites, one copy per NUMA node, see `SW_Shared.c` */
+	SW_BATCH_COST cost; /**< cost model of the sites, see `SW_BAT_run()` */
+} SW_BATCH;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_BAT_read_manifest(SW_BATCH *batch, const char *manifest);
+void SW_BAT_run(SW_BATCH *batch, unsigned int n_threads);
+void SW_BAT_print_summary(SW_BATCH *batch);
+void SW_BAT_deconstruct(SW_BATCH *batch);
+unsigned int SW_BAT_default_nthreads(void);
+
+void SW_BAT_numa_topology(SW_BATCH_NUMA *t); // SW_Batch_numa.c
+void SW_BAT_numa_deconstruct(SW_BATCH_NUMA *t);
+int SW_BAT_numa_pin(const SW_BATCH_NUMA *t, unsigned int slot);
+void SW_BAT_numa_move(const SW_BATCH_NUMA *t, const void *p, size_t size,
+	const MEM_ARENA *arena, int k);
+
+#ifdef SW_MPI
+int SW_BAT_run_mpi(SW_BATCH *batch, unsigned int n_threads); // SW_Batch_mpi.c
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,246 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Batch_mpi.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Run the sites of a batch on many nodes with MPI
+ *           (SOILWAT2-standalone compiled with `make bin_mpi`).
+ *
+ *           Every rank reads the manifest. Rank 0 hands out chunks of
+ *           consecutive sites on request (guided: chunks shrink as fewer
+ *           sites are left so that ranks finish at about the same time);
+ *           each other rank simulates its chunk with its pool of worker
+ *           threads (see `SW_BAT_run()`) and requests the next chunk
+ *           together with the failed sites of the previous one.
+ *
+ *           Outputs and logfiles of each site are written relative to
+ *           the site's directory, i.e., ranks never write to the same
+ *           file. Rank 0 collects the status of all sites for the summary.
+ *
+ *           MPI is called only by the main thread of a rank, between the
+ *           chunks, i.e., `MPI_THREAD_FUNNELED` is sufficient.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ *     2026-10-15 the cost model calibrated by a chunk carries over to the next one
+ *     2026-10-15 each rank writes its own metrics file
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <mpi.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "SW_Defines.h"
+#include "SW_Batch.h"
+
+#define SW_MPI_TAG_RESULTS 1 /**< compute rank -> rank 0: results and request */
+#define SW_MPI_TAG_CHUNK 2 /**< rank 0 -> compute rank: next chunk of sites */
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** Header of a message with the results of a chunk (and a request for
+    the next chunk); followed by `n_failed` records `SW_MPI_FAILED` */
+typedef struct {
+	unsigned int n_threads, /**< number of worker threads of the rank */
+		n_failed; /**< number of failed sites of the previous chunk */
+} SW_MPI_RESULTS;
+
+/** A failed site of a chunk */
+typedef struct {
+	unsigned int isite; /**< index of the site in the manifest */
+	char msg[ERRSTRLEN];
+} SW_MPI_FAILED;
+
+/** A chunk of sites: `n` sites starting with `first`; `n = 0` means stop */
+typedef struct {
+	unsigned int first, n;
+} SW_MPI_CHUNK;
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Hand out chunks of sites to the compute ranks and collect their
+    results until all sites are simulated */
+static void distribute_sites(SW_BATCH *batch, int n_ranks) {
+	MPI_Status status;
+	SW_MPI_RESULTS hdr;
+	SW_MPI_FAILED rec;
+	SW_MPI_CHUNK chunk;
+	char *buf = NULL;
+	int n_bytes, n_buf = 0, n_active = n_ranks - 1;
+	unsigned int i, next = 0, remaining;
+
+	while (n_active > 0) {
+		MPI_Probe(MPI_ANY_SOURCE, SW_MPI_TAG_RESULTS, MPI_COMM_WORLD, &status);
+		MPI_Get_count(&status, MPI_BYTE, &n_bytes);
+
+		if (n_bytes > n_buf) {
+			n_buf = n_bytes;
+			buf = (char *) (isnull(buf) ?
+				Mem_Malloc(n_buf, "distribute_sites()") : Mem_ReAlloc(buf, n_buf));
+		}
+
+		MPI_Recv(buf, n_bytes, MPI_BYTE, status.MPI_SOURCE, SW_MPI_TAG_RESULTS,
+			MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+		memcpy(&hdr, buf, sizeof hdr);
+		for (i = 0; i < hdr.n_failed; i++) {
+			memcpy(&rec, buf + sizeof hdr + i * sizeof rec, sizeof rec);
+			batch->sites[rec.isite].failed = swTRUE;
+			strcpy(batch->sites[rec.isite].msg, rec.msg);
+		}
+
+		// guided chunks: half of a fair share of the remaining sites,
+		// but at least one site per worker thread of the rank
+		remaining = batch->n_sites - next;
+		chunk.first = next;
+		chunk.n = remaining / (2 * (unsigned int) (n_ranks - 1));
+		chunk.n = max(chunk.n, max(hdr.n_threads, 1u));
+		chunk.n = min(chunk.n, remaining);
+		next += chunk.n;
+
+		MPI_Send(&chunk, sizeof chunk, MPI_BYTE, status.MPI_SOURCE,
+			SW_MPI_TAG_CHUNK, MPI_COMM_WORLD);
+
+		if (0 == chunk.n) {
+			n_active--;
+		}
+	}
+
+	if (!isnull(buf)) {
+		Mem_Free(buf);
+	}
+}
+
+
+/** Simulate chunks of sites until rank 0 has no more sites
+
+  The metrics file of a rank (if any) is the metrics file of the batch with
+  the rank as suffix; its counters start over with each chunk.
+*/
+static void simulate_chunks(SW_BATCH *batch, unsigned int n_threads) {
+	SW_BATCH sub;
+	SW_MPI_RESULTS hdr;
+	SW_MPI_FAILED rec;
+	SW_MPI_CHUNK chunk;
+	char *buf, metricsfile[MAX_FILENAMESIZE + 16];
+	size_t n_buf = sizeof hdr;
+	unsigned int i;
+	int rank;
+
+	if (0 == n_threads) {
+		n_threads = SW_BAT_default_nthreads();
+	}
+
+	if (!isnull(batch->metrics_file)) {
+		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+		snprintf(metricsfile, sizeof metricsfile, "%s.%d", batch->metrics_file,
+			rank);
+	}
+
+	hdr.n_threads = n_threads;
+	hdr.n_failed = 0;
+	buf = (char *) Mem_Malloc(n_buf, "simulate_chunks()");
+	memcpy(buf, &hdr, sizeof hdr);
+
+	for (;;) {
+		MPI_Send(buf, (int) (sizeof hdr + hdr.n_failed * sizeof rec), MPI_BYTE, 0,
+			SW_MPI_TAG_RESULTS, MPI_COMM_WORLD);
+		MPI_Recv(&chunk, sizeof chunk, MPI_BYTE, 0, SW_MPI_TAG_CHUNK,
+			MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+		if (0 == chunk.n) {
+			break;
+		}
+
+		// a view of the chunk; input tables are shared across chunks
+		sub = *batch;
+		sub.sites = batch->sites + chunk.first;
+		sub.n_sites = chunk.n;
+		if (!isnull(batch->metrics_file)) {
+			sub.metrics_file = metricsfile;
+		}
+		SW_BAT_run(&sub, n_threads);
+		memcpy(batch->shared, sub.shared, sizeof batch->shared);
+		batch->cost = sub.cost; // the calibrated cost model carries over to the next chunk
+
+		// results of the chunk go out with the request for the next chunk
+		if (sizeof hdr + sub.n_failed * sizeof rec > n_buf) {
+			n_buf = sizeof hdr + sub.n_failed * sizeof rec;
+			buf = (char *) Mem_ReAlloc(buf, n_buf);
+		}
+
+		for (i = 0, hdr.n_failed = 0; i < sub.n_sites; i++) {
+			if (sub.sites[i].failed) {
+				rec.isite = chunk.first + i;
+				strcpy(rec.msg, sub.sites[i].msg);
+				memcpy(buf + sizeof hdr + hdr.n_failed++ * sizeof rec, &rec, sizeof rec);
+			}
+		}
+		memcpy(buf, &hdr, sizeof hdr);
+	}
+
+	Mem_Free(buf);
+}
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Simulate all sites of a batch across the ranks of `MPI_COMM_WORLD`
+
+Rank 0 distributes the sites and does not simulate sites itself unless
+it is the only rank. Call this routine from every rank after `MPI_Init_thread()`
+and `SW_BAT_read_manifest()`.
+
+@param batch Batch of sites; on rank 0, updated with the status of each
+  simulation and `n_failed`.
+@param n_threads Number of worker threads of each rank; `0` uses
+  `SW_BAT_default_nthreads()`.
+
+@return Rank of the calling process.
+*/
+int SW_BAT_run_mpi(SW_BATCH *batch, unsigned int n_threads) {
+	int rank, n_ranks;
+	unsigned int i;
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &n_ranks);
+
+	if (1 == n_ranks) {
+		SW_BAT_run(batch, n_threads);
+		return rank;
+	}
+
+	if (0 == rank) {
+		distribute_sites(batch, n_ranks);
+
+		for (i = 0, batch->n_failed = 0; i < batch->n_sites; i++) {
+			if (batch->sites[i].failed) {
+				batch->n_failed++;
+			}
+		}
+
+	} else {
+		simulate_chunks(batch, n_threads);
+	}
+
+	return rank;
+}
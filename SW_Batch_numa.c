@@ -0,0 +1,292 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Batch_numa.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Place the threads of a batch (see `SW_Batch.c`) and their
+ *           memory on the NUMA nodes of the machine.
+ *
+ *           The topology is read from `/sys/devices/system/node` and
+ *           restricted to the CPUs that the process may run on (e.g.,
+ *           of `taskset` or a batch scheduler). Threads are pinned with
+ *           `pthread_setaffinity_np()`; pages are moved with the system
+ *           call `move_pages`, i.e., libnuma is not required. Elsewhere,
+ *           the machine has no NUMA nodes and threads are not pinned.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#ifdef __linux__
+#define _GNU_SOURCE /* for sched_getaffinity() and pthread_setaffinity_np() */
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "SW_Batch.h"
+
+#define SW_NUMA_SYSDIR "/sys/devices/system/node" /**< NUMA topology of Linux */
+#define SW_NUMA_MOVEPAGES 1024 /**< pages per call of `move_pages` */
+
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1) /**< move pages that are only used by the process, see <numaif.h> */
+#endif
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+#ifdef __linux__
+
+/** Read a list of numbers such as "0-63,128-191" from a file of
+    `SW_NUMA_SYSDIR` and mark its numbers in `set`
+
+  @return FALSE if the file cannot be read.
+*/
+static Bool read_list(const char *path, cpu_set_t *set) {
+	FILE *fp;
+	char line[4096], *s, *end;
+	long a, b;
+
+	CPU_ZERO(set);
+
+	if (isnull(fp = fopen(path, "r"))) {
+		return swFALSE;
+	}
+	s = fgets(line, sizeof line, fp);
+	fclose(fp);
+	if (isnull(s)) {
+		return swFALSE;
+	}
+
+	while (*s != '\0' && *s != '\n') {
+		a = b = strtol(s, &end, 10);
+		if (end == s || a < 0) {
+			break;
+		}
+		if ('-' == *end) {
+			s = end + 1;
+			b = strtol(s, &end, 10);
+		}
+
+		for (; a <= b && a < CPU_SETSIZE; a++) {
+			CPU_SET((int) a, set);
+		}
+
+		s = (',' == *end) ? end + 1 : end;
+	}
+
+	return swTRUE;
+}
+
+
+/** Add the CPUs of `set` as a node of the topology
+
+  @param t Topology of the machine.
+  @param node Number of the node in the system.
+  @param set CPUs of the node that the process may run on.
+*/
+static void add_node(SW_BATCH_NUMA *t, int node, const cpu_set_t *set) {
+	int cpu;
+	unsigned int n = t->n_cpus;
+
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (CPU_ISSET(cpu, set)) {
+			t->cpus[t->n_cpus++] = (unsigned int) cpu;
+		}
+	}
+
+	if (t->n_cpus > n) {
+		t->node[t->n_nodes] = node;
+		t->n_nodes++;
+		t->first[t->n_nodes] = t->n_cpus;
+	}
+}
+
+
+/** Move the pages of a block of memory, see `SW_BAT_numa_move()` */
+static void move_block(const void *block, size_t size, void *data) {
+	const int *node = (const int *) data;
+	uintptr_t
+		page = (uintptr_t) sysconf(_SC_PAGESIZE),
+		p = (uintptr_t) block & ~(page - 1),
+		end = (uintptr_t) block + size;
+	void *pages[SW_NUMA_MOVEPAGES];
+	int nodes[SW_NUMA_MOVEPAGES], status[SW_NUMA_MOVEPAGES];
+	unsigned long n = 0;
+
+	for (; p < end; p += page) {
+		pages[n] = (void *) p;
+		nodes[n] = *node;
+		n++;
+
+		// pages that cannot be moved stay where they are
+		if (SW_NUMA_MOVEPAGES == n || p + page >= end) {
+			(void) syscall(SYS_move_pages, 0, n, pages, nodes, status, MPOL_MF_MOVE);
+			n = 0;
+		}
+	}
+}
+
+#endif
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Read the NUMA topology of the machine
+
+At most `SW_BATCH_MAXNODES` nodes are used. A machine without
+information on its NUMA nodes has one node with all CPUs that the
+process may run on.
+
+@param t Topology; `n_nodes` is 0 if threads cannot be pinned.
+  Free with `SW_BAT_numa_deconstruct()`.
+*/
+void SW_BAT_numa_topology(SW_BATCH_NUMA *t) {
+	#ifdef __linux__
+	cpu_set_t allowed, set, nodes;
+	char path[64];
+	int node;
+	#endif
+
+	memset(t, 0, sizeof *t);
+
+	#ifdef __linux__
+	if (0 != sched_getaffinity(0, sizeof allowed, &allowed)) {
+		return;
+	}
+
+	t->cpus = (unsigned int *) Mem_Calloc(CPU_SETSIZE, sizeof(unsigned int),
+		"SW_BAT_numa_topology()");
+
+	if (read_list(SW_NUMA_SYSDIR "/online", &nodes)) {
+		for (node = 0; node < CPU_SETSIZE && t->n_nodes < SW_BATCH_MAXNODES; node++) {
+			snprintf(path, sizeof path, SW_NUMA_SYSDIR "/node%d/cpulist", node);
+
+			if (CPU_ISSET(node, &nodes) && read_list(path, &set)) {
+				CPU_AND(&set, &set, &allowed);
+				add_node(t, node, &set);
+			}
+		}
+	}
+
+	if (0 == t->n_nodes) {
+		add_node(t, 0, &allowed);
+	}
+	#endif
+}
+
+
+/**
+@brief Free the memory of a NUMA topology
+
+@param t Topology of `SW_BAT_numa_topology()`.
+*/
+void SW_BAT_numa_deconstruct(SW_BATCH_NUMA *t) {
+	if (!isnull(t->cpus)) {
+		Mem_Free(t->cpus);
+	}
+
+	memset(t, 0, sizeof *t);
+}
+
+
+/**
+@brief Pin the calling thread to one CPU
+
+Threads are spread across the nodes: thread `slot` runs on node
+`slot % n_nodes` and takes the CPUs of its node in turn, i.e., threads
+share a CPU only if there are more threads than CPUs.
+
+@param t Topology of `SW_BAT_numa_topology()`.
+@param slot Number of the thread.
+
+@return Index of the node of the thread (`0` to `n_nodes - 1`) or
+  `-1` if the thread is not pinned.
+*/
+int SW_BAT_numa_pin(const SW_BATCH_NUMA *t, unsigned int slot) {
+	#ifdef __linux__
+	cpu_set_t set;
+	unsigned int k, n;
+
+	if (0 == t->n_nodes) {
+		return -1;
+	}
+
+	k = slot % t->n_nodes;
+	n = t->first[k + 1] - t->first[k];
+
+	CPU_ZERO(&set);
+	CPU_SET((int) t->cpus[t->first[k] + (slot / t->n_nodes) % n], &set);
+
+	if (0 == pthread_setaffinity_np(pthread_self(), sizeof set, &set)) {
+		return (int) k;
+	}
+	#else
+	(void) t;
+	(void) slot;
+	#endif
+
+	return -1;
+}
+
+
+/**
+@brief Move memory to a node, e.g., the simulation run context of a site
+  to the node of the thread that simulates it
+
+Pages that cannot be moved (e.g., on a system without NUMA) stay where
+they are; the memory is not changed in either case.
+
+@param t Topology of `SW_BAT_numa_topology()`.
+@param p Start of the memory.
+@param size Size of the memory in bytes.
+@param arena Arena whose blocks are also moved; NULL if none.
+@param k Index of the node, see `SW_BAT_numa_pin()`.
+*/
+void SW_BAT_numa_move(const SW_BATCH_NUMA *t, const void *p, size_t size,
+	const MEM_ARENA *arena, int k) {
+
+	#ifdef __linux__
+	int node;
+
+	if (k < 0 || k >= (int) t->n_nodes) {
+		return;
+	}
+	node = t->node[k];
+
+	move_block(p, size, &node);
+	if (!isnull(arena)) {
+		Mem_ArenaBlocks(arena, move_block, &node);
+	}
+	#else
+	(void) t;
+	(void) p;
+	(void) size;
+	(void) arena;
+	(void) k;
+	#endif
+}
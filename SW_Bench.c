@@ -0,0 +1,55 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Bench.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Accumulate the timers of `SW_Bench.h`; only compiled
+ *           for the benchmark binary (with `SW_BENCH` defined).
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <time.h>
+
+#include "generic.h"
+#include "SW_Bench.h"
+#include "SW_Run.h"
+
+
+/* =================================================== */
+/*                  Global Variables                   */
+/* --------------------------------------------------- */
+
+/** Names of the timed code sections, as reported by the benchmark */
+const char *SW_BENCH_names[SW_BENCH_NTIMERS] = {
+	"SW_Water_Flow", "soil_temperature", "solar_radiation_petfunc",
+	"SW_OUT_sum_today", "SW_OUT_write_today"
+};
+
+
+/* =================================================== */
+/*             Global Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Add the time elapsed since `start` to timer `t` of the active run
+
+@param t Timed code section.
+@param start Time when the code section was entered.
+*/
+void SW_BENCH_add(SW_BenchTimer t, const struct timespec *start) {
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+
+	SW_CurrentRun->Bench.ns[t] +=
+		1e9 * (double) (now.tv_sec - start->tv_sec) +
+		(double) (now.tv_nsec - start->tv_nsec);
+	SW_CurrentRun->Bench.calls[t]++;
+}
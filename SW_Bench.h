@@ -0,0 +1,74 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Bench.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Timers of selected modules for the benchmark binary
+ *           (see `make bench`).
+ *
+ *           Timers are compiled in only if `SW_BENCH` is defined;
+ *           otherwise, `SW_BENCH_START()` and `SW_BENCH_STOP()` expand
+ *           to nothing. Elapsed time and number of calls are accumulated
+ *           per simulation run context (`SW_RUN.Bench`).
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_BENCH_H
+#define SW_BENCH_H
+
+#ifdef SW_BENCH
+#include <time.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#ifdef SW_BENCH
+
+/** Timed code sections */
+typedef enum {
+	eBenchWaterFlow, /**< `SW_Water_Flow()`, includes the other flow sections */
+	eBenchSoilTemp, /**< `soil_temperature()` */
+	eBenchRadPET, /**< `solar_radiation()` and `petfunc()` */
+	eBenchOutSum, /**< `SW_OUT_sum_today()` of all object types */
+	eBenchOutWrite, /**< `SW_OUT_write_today()` */
+	SW_BENCH_NTIMERS
+} SW_BenchTimer;
+
+/** Accumulated timers of a simulation run */
+typedef struct {
+	double ns[SW_BENCH_NTIMERS]; /**< elapsed time [nanoseconds] */
+	unsigned long calls[SW_BENCH_NTIMERS]; /**< number of timed calls */
+} SW_BENCH_TIMERS;
+
+extern const char *SW_BENCH_names[SW_BENCH_NTIMERS];
+
+void SW_BENCH_add(SW_BenchTimer t, const struct timespec *start);
+
+/** Start timer `t` of the active run (within a block of code) */
+#define SW_BENCH_START(t) \
+	struct timespec sw_bench_start_##t; \
+	timespec_get(&sw_bench_start_##t, TIME_UTC)
+
+/** Stop timer `t` (started in the same block) and add the elapsed time */
+#define SW_BENCH_STOP(t) SW_BENCH_add((t), &sw_bench_start_##t)
+
+#else
+
+#define SW_BENCH_START(t)
+#define SW_BENCH_STOP(t)
+
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
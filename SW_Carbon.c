@@ -25,6 +25,7 @@
 #include "SW_Site.h"
 #include "SW_VegProd.h"
 #include "SW_Model.h"
+#include "SW_Run.h"
 
 /* =================================================== */
 /*                  Global Variables                   */
@@ -35,10 +36,19 @@
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
 
-static char *MyFileName;
-SW_CARBON SW_Carbon;    // Declared here, externed elsewhere
-extern SW_VEGPROD SW_VegProd;
-extern SW_MODEL SW_Model;
+static SW_THREAD_LOCAL char *MyFileName;
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** CO2 concentrations of one scenario of `carbon.in` */
+typedef struct {
+  Bool is_empty;                 /**< TRUE if the file has no (non-comment) lines */
+  IntUS n_values[MAX_NYEAR];     /**< number of values of each calendar year */
+  double ppm[MAX_NYEAR];         /**< CO2 concentration of each calendar year */
+} SW_CBN_SCENARIO;
 
 
 /* =================================================== */
@@ -46,6 +56,103 @@ extern SW_MODEL SW_Model;
 /*             Private Function Definitions            */
 /* --------------------------------------------------- */
 
+/**
+ * @brief Reads the values of all years of a scenario from `carbon.in`
+ *
+ * Values of a scenario are not checked here so that the scenario can be
+ * shared by runs of a batch that simulate different years, see check_scenario().
+ *
+ * @param f The contents of `carbon.in`.
+ * @param scenario Name of the scenario.
+ * @param s The scenario.
+ */
+static void read_scenario(SW_TEXTFILE *f, const char *scenario, SW_CBN_SCENARIO *s)
+{
+  #ifdef SWDEBUG
+  short debug = 0;
+  #endif
+  char name[64] = "";
+  int year;
+  double ppm;
+
+  memset(s, 0, sizeof *s);
+  s->is_empty = swTRUE;
+
+  while (GetATextLine(f)) {
+    #ifdef SWDEBUG
+    if (debug) swprintf("\nline = %s", f->line);
+    #endif
+
+    s->is_empty = swFALSE;
+
+    // Read the year standalone because if it's 0 it marks a change in the scenario,
+    // in which case we'll need to read in a string instead of an int
+    Str_Scan(f->line, "%d", &year);
+
+    // Find scenario
+    if (year == 0)
+    {
+      Str_Scan(f->line, "%d %63s", &year, name);
+      continue;  // Skip to the ppm values
+    }
+    if (strcmp(name, scenario) != 0)
+    {
+      continue;  // Keep searching for the right scenario
+    }
+    if (year < 0 || year >= MAX_NYEAR)
+    {
+      continue;  // Negative years are never simulated
+    }
+
+    Str_Scan(f->line, "%d %lf", &year, &ppm);
+
+    s->ppm[year] = ppm;
+    s->n_values[year]++;
+    #ifdef SWDEBUG
+    if (debug) swprintf("  ==> ppm[%d] = %3.2f", year, s->ppm[year]);
+    #endif
+  }
+}
+
+
+/**
+ * @brief Checks that a scenario has exactly one value for each simulated year
+ *
+ * @param s The scenario, see read_scenario().
+ */
+static void check_scenario(const SW_CBN_SCENARIO *s)
+{
+  SW_CARBON *c = &SW_Carbon;
+  int year,
+    simstartyr = (int) SW_Model.startyr + SW_Model.addtl_yr,
+    simendyr = (int) SW_Model.endyr + SW_Model.addtl_yr;
+
+  // Must check if the file was empty before checking if the scenario was found,
+  // otherwise the empty file will be masked as not being able to find the scenario
+  if (s->is_empty)
+  {
+    sprintf(errstr, "(SW_Carbon) carbon.in was empty; for debugging purposes, SOILWAT2 read in file '%s'\n", MyFileName);
+    LogError(logfp, LOGFATAL, errstr);
+  }
+
+  // Ensure that the desired years were read exactly once
+  for (year = simstartyr; year <= simendyr; year++)
+  {
+    if (s->n_values[year] > 1)
+    {
+      sprintf(errstr, "(SW_Carbon) Year %d in scenario '%s' is entered more than once; only one entry is allowed.\n", year, c->scenario);
+      LogError(logfp, LOGFATAL, errstr);
+    }
+
+    if (s->n_values[year] == 0)
+    {
+      sprintf(errstr, "(SW_Carbon) missing CO2 data for year %d; ensure that ppm values for this year exist in scenario '%s'\n", year, c->scenario);
+      LogError(logfp, LOGFATAL, errstr);
+    }
+  }
+}
+
+
 /* =================================================== */
 /* =================================================== */
 /*             Public Function Definitions             */
@@ -55,14 +162,27 @@ extern SW_MODEL SW_Model;
  * @brief Initializes the multipliers of the SW_CARBON structure.
  * @note The spin-up year has been known to have the multipliers equal
  *       to 0 without this constructor.
+ * @note A run that shares input tables with other runs of a batch
+ *       does not need its own CO2 concentrations, see SW_CBN_read().
  */
 void SW_CBN_construct(void)
 {
   memset(&SW_Carbon, 0, sizeof(SW_Carbon));
+
+  if (isnull(SW_CurrentRun->Shared)) {
+    SW_Carbon.ppm = (double *) Mem_Calloc(MAX_NYEAR, sizeof(double),
+      "SW_CBN_construct()");
+  }
 }
 
 void SW_CBN_deconstruct(void)
 {
+  if (!isnull(SW_Carbon.ppm) && !SW_Carbon.shares_ppm) {
+    Mem_Free(SW_Carbon.ppm);
+  }
+
+  SW_Carbon.ppm = NULL;
+  SW_Carbon.shares_ppm = swFALSE;
 }
 
 
@@ -72,9 +192,12 @@ void SW_CBN_deconstruct(void)
  * Additionally, check for the following issues:
  *   1. Duplicate entries.
  *   2. Empty file.
- *   3. Missing scenario.
+ *   3. Missing scenario (reported as missing years).
  *   4. Missing year.
- *   5. Negative year.
+ *
+ * A run that shares input tables with other runs of a batch reads the
+ * scenario only if no other run has read it from an identical file; the
+ * run then points to the shared CO2 concentrations.
  */
 void SW_CBN_read(void)
 {
@@ -82,6 +205,10 @@ void SW_CBN_read(void)
   short debug = 0;
   #endif
   SW_CARBON  *c   = &SW_Carbon;
+  SW_SHARED_INPUTS *shared = SW_CurrentRun->Shared;
+  SW_SHARED_ID id;
+  SW_CBN_SCENARIO *s;
+  const SW_CBN_SCENARIO *sc;
 
   // For efficiency, don't read carbon.in if neither multiplier is being used
   // We can do this because SW_VPD_construct already populated the multipliers with default values
@@ -96,19 +223,10 @@ void SW_CBN_read(void)
   }
 
   /* Reading carbon.in */
-  FILE *f;
-  char scenario[64];
-  int year,
-    simstartyr = (int) SW_Model.startyr + SW_Model.addtl_yr,
-    simendyr = (int) SW_Model.endyr + SW_Model.addtl_yr;
-
-  // The following variables must be initialized to show if they've been changed or not
-  double ppm = 1.;
-  int existing_years[MAX_NYEAR] = {0};
-  short fileWasEmpty = 1;
+  SW_TEXTFILE f;
 
   MyFileName = SW_F_name(eCarbon);
-  f = OpenFile(MyFileName, "r");
+  OpenTextFile(&f, MyFileName);
 
   #ifdef SWDEBUG
   if (debug) {
@@ -116,86 +234,65 @@ void SW_CBN_read(void)
   }
   #endif
 
-  while (GetALine(f, inbuf)) {
-    #ifdef SWDEBUG
-    if (debug) swprintf("\ninbuf = %s", inbuf);
-    #endif
+  if (isnull(shared))
+  {
+    s = (SW_CBN_SCENARIO *) Mem_Malloc(sizeof *s, "SW_CBN_read()");
+    read_scenario(&f, c->scenario, s);
+    CloseTextFile(&f);
 
-    fileWasEmpty = 0;
+    check_scenario(s);
+    memcpy(c->ppm, s->ppm, sizeof s->ppm);
+    Mem_Free(s);
+    return;
+  }
 
-    // Read the year standalone because if it's 0 it marks a change in the scenario,
-    // in which case we'll need to read in a string instead of an int
-    sscanf(inbuf, "%d", &year);
+  // The table outlives the run and is not taken from its arena
+  SW_SHR_id(&id, eCarbon, c->scenario, f.data);
 
-    // Find scenario
-    if (year == 0)
-    {
-      sscanf(inbuf, "%d %63s", &year, scenario);
-      continue;  // Skip to the ppm values
-    }
-    if (strcmp(scenario, c->scenario) != 0)
-    {
-      continue;  // Keep searching for the right scenario
-    }
-    if ((year < simstartyr) || (year > simendyr))
+  if (isnull(sc = (const SW_CBN_SCENARIO *) SW_SHR_get(shared, &id)))
+  {
+    if (isnull(s = (SW_CBN_SCENARIO *) malloc(sizeof *s)))
     {
-      continue; // We aren't using this year
+      CloseTextFile(&f);
+      LogError(logfp, LOGFATAL, "SW_CBN_read(): out of memory");
     }
 
-    sscanf(inbuf, "%d %lf", &year, &ppm);
-
-    if (year < 0)
-    {
-      CloseFile(&f);
-      sprintf(errstr, "(SW_Carbon) Year %d in scenario '%s' is negative; only positive values are allowed.\n", year, c->scenario);
-      LogError(logfp, LOGFATAL, errstr);
-    }
+    read_scenario(&f, c->scenario, s);
+    sc = (const SW_CBN_SCENARIO *) SW_SHR_put(shared, &id, s);
+  }
 
-    c->ppm[year] = ppm;
-    #ifdef SWDEBUG
-    if (debug) swprintf("  ==> c->ppm[%d] = %3.2f", year, c->ppm[year]);
-    #endif
+  CloseTextFile(&f);
 
-    /* Has this year already been calculated?
-       If yes: Do NOT overwrite values, fail the run instead
+  check_scenario(sc);
 
-       Use a simple binary system with the year as the index, which avoids using a loop.
-       We cannot simply check if co2_multipliers[0 or 1][year].grass != 1.0, due to floating point precision
-       and the chance that a multiplier of 1.0 was actually calculated */
-    if (existing_years[year] != 0)
-    {
-      CloseFile(&f);
-      sprintf(errstr, "(SW_Carbon) Year %d in scenario '%s' is entered more than once; only one entry is allowed.\n", year, c->scenario);
-      LogError(logfp, LOGFATAL, errstr);
-    }
-    existing_years[year] = 1;
+  if (!isnull(c->ppm) && !c->shares_ppm) {
+    Mem_Free(c->ppm);
   }
+  c->ppm = (double *) sc->ppm;
+  c->shares_ppm = swTRUE;
+}
 
-  CloseFile(&f);
-
-
-  /* Error checking */
 
-  // Must check if the file was empty before checking if the scneario was found,
-  // otherwise the empty file will be masked as not being able to find the scenario
-  if (fileWasEmpty == 1)
-  {
-    sprintf(errstr, "(SW_Carbon) carbon.in was empty; for debugging purposes, SOILWAT2 read in file '%s'\n", MyFileName);
-    LogError(logfp, LOGFATAL, errstr);
-  }
+/**
+ * @brief Checks that CO2 concentrations are available for all years that
+ *        will be simulated.
+ */
+void SW_CBN_init_run(void) {
+  TimeInt year,
+    simendyr = SW_Model.endyr + SW_Model.addtl_yr;
+  SW_CARBON  *c  = &SW_Carbon;
 
-  if (EQ(ppm, -1.))  // A scenario must be found in order for ppm to have a positive value
+  if (!c->use_bio_mult && !c->use_wue_mult)
   {
-    sprintf(errstr, "(SW_Carbon) The scenario '%s' was not found in carbon.in\n", c->scenario);
-    LogError(logfp, LOGFATAL, errstr);
+    return;
   }
 
-  // Ensure that the desired years were calculated
-  for (year = simstartyr; year <= simendyr; year++)
+  // Only iterate through the years that we know will be used
+  for (year = SW_Model.startyr + SW_Model.addtl_yr; year <= simendyr; year++)
   {
-    if (existing_years[year] == 0)
+    if (LT(c->ppm[year], 0.))  // CO2 concentration must not be negative values
     {
-      sprintf(errstr, "(SW_Carbon) missing CO2 data for year %d; ensure that ppm values for this year exist in scenario '%s'\n", year, c->scenario);
+      sprintf(errstr, "(SW_Carbon) No CO2 ppm data was provided for year %d\n", year);
       LogError(logfp, LOGFATAL, errstr);
     }
   }
@@ -203,19 +300,19 @@ void SW_CBN_read(void)
 
 
 /**
- * @brief Calculates the multipliers of the CO2-effect for biomass and water-use efficiency.
+ * @brief Calculates the multipliers of the CO2-effect for biomass and water-use
+ *        efficiency of the current simulation year.
  *
- * Multipliers are calculated per year with the equation: Coeff1 * ppm^Coeff2
+ * Multipliers are calculated with the equation: Coeff1 * ppm^Coeff2
  * Where Coeff1 and Coeff2 are provided by the VegProd input. Coefficients assume that
  * monthly biomass reflect values for atmospheric conditions at 360 ppm CO2. Each PFT has
  * its own set of coefficients. If a multiplier is disabled, its value is kept at the
- * default value of 1.0. Multipliers are only calculated for the years that will
- * be simulated.
+ * default value of 1.0 (see SW_VPD_init_run()). Only the multipliers of the year
+ * `SW_Model.simyear` are held, so that the size of `SW_VEGPROD` does not depend on
+ * the range of supported calendar years.
  */
-void SW_CBN_init_run(void) {
+void SW_CBN_new_year(void) {
   int k;
-  TimeInt year,
-    simendyr = SW_Model.endyr + SW_Model.addtl_yr;
   double ppm;
   SW_CARBON  *c  = &SW_Carbon;
   SW_VEGPROD *v  = &SW_VegProd;
@@ -228,37 +325,27 @@ void SW_CBN_init_run(void) {
     return;
   }
 
-  // Only iterate through the years that we know will be used
-  for (year = SW_Model.startyr + SW_Model.addtl_yr; year <= simendyr; year++)
-  {
-    ppm = c->ppm[year];
-
-    if (LT(ppm, 0.))  // CO2 concentration must not be negative values
-    {
-      sprintf(errstr, "(SW_Carbon) No CO2 ppm data was provided for year %d\n", year);
-      LogError(logfp, LOGFATAL, errstr);
-    }
+  ppm = c->ppm[SW_Model.simyear];
 
-    // Calculate multipliers per PFT
-    if (c->use_bio_mult) {
-      ForEachVegType(k) {
-        v->veg[k].co2_multipliers[BIO_INDEX][year] = v->veg[k].co2_bio_coeff1 * pow(ppm, v->veg[k].co2_bio_coeff2);
-      }
+  // Calculate multipliers per PFT
+  if (c->use_bio_mult) {
+    ForEachVegType(k) {
+      v->veg[k].co2_multipliers[BIO_INDEX] = v->veg[k].co2_bio_coeff1 * pow(ppm, v->veg[k].co2_bio_coeff2);
     }
+  }
 
-    #ifdef SWDEBUG
-    if (debug) {
-      swprintf("Shrub: use%d: bio_mult[%d] = %1.3f / coeff1 = %1.3f / coeff2 = %1.3f / ppm = %3.2f\n",
-        c->use_bio_mult, year, v->veg[SW_SHRUB].co2_multipliers[BIO_INDEX][year],
-        v->veg[SW_SHRUB].co2_bio_coeff1, v->veg[SW_SHRUB].co2_bio_coeff2, ppm);
-    }
-    #endif
+  #ifdef SWDEBUG
+  if (debug) {
+    swprintf("Shrub: use%d: bio_mult[%d] = %1.3f / coeff1 = %1.3f / coeff2 = %1.3f / ppm = %3.2f\n",
+      c->use_bio_mult, SW_Model.simyear, v->veg[SW_SHRUB].co2_multipliers[BIO_INDEX],
+      v->veg[SW_SHRUB].co2_bio_coeff1, v->veg[SW_SHRUB].co2_bio_coeff2, ppm);
+  }
+  #endif
 
-    if (c->use_wue_mult) {
-      ForEachVegType(k) {
-        v->veg[k].co2_multipliers[WUE_INDEX][year] = v->veg[k].co2_wue_coeff1 *
-          pow(ppm, v->veg[k].co2_wue_coeff2);
-      }
+  if (c->use_wue_mult) {
+    ForEachVegType(k) {
+      v->veg[k].co2_multipliers[WUE_INDEX] = v->veg[k].co2_wue_coeff1 *
+        pow(ppm, v->veg[k].co2_wue_coeff2);
     }
   }
 }
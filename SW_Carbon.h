@@ -26,7 +26,10 @@ typedef struct {
     scenario[64];                      /**< A 64-char array holding the scenario name for which we are extracting CO2 data from the carbon.in file. */
 
   double
-    ppm[MAX_NYEAR];                 /**< A 1D array holding atmospheric CO2 concentration values (units ppm) that are indexed by calendar year. Is typically only populated for the years that are being simulated. `ppm[index]` is the CO2 value for the calendar year `index + 1` */
+    *ppm;                           /**< A 1D array of `MAX_NYEAR` atmospheric CO2 concentration values (units ppm) that are indexed by calendar year. Is typically only populated for the years that are being simulated. `ppm[index]` is the CO2 value for the calendar year `index + 1` */
+
+  Bool
+    shares_ppm;                     /**< TRUE if `ppm` points to a table that is shared with other runs of a batch (see SW_Shared.c) and must not be changed */
 
 } SW_CARBON;
 
@@ -35,6 +38,7 @@ void SW_CBN_construct(void);
 void SW_CBN_deconstruct(void);
 void SW_CBN_read(void);
 void SW_CBN_init_run(void);
+void SW_CBN_new_year(void);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,512 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Checkpoint.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Write checkpoints of a simulation run at the end of a year
+ *           and continue a run after its last checkpoint, e.g., after a
+ *           long batch run was killed or a machine went down.
+ *
+ *           A checkpoint is written every `every_years` simulated years
+ *           and/or at the end of the first year that ends `every_seconds`
+ *           after the previous checkpoint (see `SW_CHECKPOINT`). The output
+ *           files are committed to disk first; then the checkpoint is
+ *           written to a temporary file, committed to disk, and renamed
+ *           to replace the previous checkpoint. A crash at any time thus
+ *           leaves a complete checkpoint and output files that are at
+ *           least as long as recorded by it.
+ *
+ *           A run that resumes from a checkpoint is set up from the same
+ *           inputs as usual, loads the dynamic state of the checkpoint
+ *           (soil water, snowpack, soil temperature, random number
+ *           generator, establishment, accumulators of output, etc.), cuts
+ *           its output files to their sizes at the checkpoint, and
+ *           continues with the next year. The output files are identical
+ *           to those of an uninterrupted run (the chunks of binary output
+ *           files may be split differently).
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L /* for fsync() with -std=c11 */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "SW_Defines.h"
+#include "SW_Files.h"
+#include "SW_Control.h"
+#include "SW_Output.h"
+#include "SW_Output_outtext.h"
+#include "SW_Output_outbin.h"
+#include "SW_Checkpoint.h"
+#include "SW_Trace.h"
+#include "SW_Run.h"
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Write (`is_read` is FALSE) or read `n` bytes at `p`
+
+  Write errors are detected by `ferror()` once the checkpoint is complete;
+  a checkpoint that is too short cannot be resumed.
+*/
+static void xfer(FILE *f, Bool is_read, void *p, size_t n) {
+	if (!is_read) {
+		fwrite(p, 1, n, f);
+
+	} else if (n != fread(p, 1, n, f)) {
+		fclose(f);
+		LogError(logfp, LOGFATAL, "Checkpoint file is incomplete.");
+	}
+}
+
+/** Transfer `n` bytes at `p` unless `p` is NULL, e.g., the output
+    accumulators of an output period that is not used */
+static void xfer_opt(FILE *f, Bool is_read, void *p, size_t n) {
+	if (!isnull(p)) {
+		xfer(f, is_read, p, n);
+	}
+}
+
+/** Transfer the output accumulator and aggregator of one output period
+    (`n` bytes each); the daily aggregator points to the accumulator once
+    it is used (see `average_for()`) */
+static void xfer_outputs(FILE *f, Bool is_read, void *accu, void *oagg, size_t n) {
+	xfer_opt(f, is_read, accu, n);
+
+	if (oagg != accu) {
+		xfer_opt(f, is_read, oagg, n);
+	}
+}
+
+/* The `xfer_XXX` functions transfer the state of one module: pointers are
+   not part of the state and keep their values of the active run, which was
+   set up with the same inputs; the contents of the output accumulators and
+   aggregators are transferred after the module. */
+
+static void xfer_soilwat(FILE *f, Bool is_read) {
+	SW_SOILWAT *v = &SW_Soilwat;
+	SW_SOILWAT_OUTPUTS *p_accu[SW_OUTNPERIODS], *p_oagg[SW_OUTNPERIODS];
+	char *file_prefix = v->hist.file_prefix;
+	SW_SOILWAT_HIST_DAY *hist_days = v->hist.days;
+	TimeInt hist_alloc = v->hist.n_alloc;
+	#ifdef SWDEBUG
+	char *wbErrorNames[N_WBCHECKS];
+	#endif
+	Bool is_today = (Bool) (v->sTemp == v->sTemp_days[Today]);
+	OutPeriod pd;
+
+	memcpy(p_accu, v->p_accu, sizeof p_accu);
+	memcpy(p_oagg, v->p_oagg, sizeof p_oagg);
+	#ifdef SWDEBUG
+	memcpy(wbErrorNames, v->wbErrorNames, sizeof wbErrorNames);
+	#endif
+
+	xfer(f, is_read, &is_today, sizeof is_today);
+	xfer(f, is_read, v, sizeof *v);
+
+	memcpy(v->p_accu, p_accu, sizeof p_accu);
+	memcpy(v->p_oagg, p_oagg, sizeof p_oagg);
+	#ifdef SWDEBUG
+	memcpy(v->wbErrorNames, wbErrorNames, sizeof wbErrorNames);
+	#endif
+	v->hist.file_prefix = file_prefix;
+	v->hist.days = hist_days;
+	v->hist.n_alloc = hist_alloc;
+
+	// measured swc of the current year (only days with measurements)
+	if (v->hist.n_days > 0) {
+		SW_SWC_hist_reserve(v->hist.n_days);
+		xfer(f, is_read, v->hist.days, v->hist.n_days * sizeof(SW_SOILWAT_HIST_DAY));
+	}
+
+	// `sTemp` and `sTemp_yesterday` are swapped every day
+	v->sTemp = v->sTemp_days[is_today ? Today : Yesterday];
+	v->sTemp_yesterday = v->sTemp_days[is_today ? Yesterday : Today];
+
+	ForEachOutPeriod(pd) {
+		xfer_outputs(f, is_read, v->p_accu[pd], v->p_oagg[pd],
+			sizeof(SW_SOILWAT_OUTPUTS));
+	}
+}
+
+static void xfer_weather(FILE *f, Bool is_read) {
+	SW_WEATHER *w = &SW_Weather;
+	SW_WEATHER_OUTPUTS *p_accu[SW_OUTNPERIODS], *p_oagg[SW_OUTNPERIODS];
+	SW_WEATHER_HIST *allHist = w->allHist, *hist_year = w->hist_year;
+	const SW_WEATHER_HIST *memHist = w->memHist, *memHist_year = w->memHist_year;
+	TimeInt n_memHist = w->n_memHist;
+	Bool preload_all_years = w->preload_all_years;
+	OutPeriod pd;
+
+	memcpy(p_accu, w->p_accu, sizeof p_accu);
+	memcpy(p_oagg, w->p_oagg, sizeof p_oagg);
+
+	xfer(f, is_read, w, sizeof *w);
+
+	memcpy(w->p_accu, p_accu, sizeof p_accu);
+	memcpy(w->p_oagg, p_oagg, sizeof p_oagg);
+	w->allHist = allHist;
+	w->hist_year = hist_year;
+	w->memHist = memHist;
+	w->memHist_year = memHist_year;
+	w->n_memHist = n_memHist;
+	w->preload_all_years = preload_all_years;
+
+	ForEachOutPeriod(pd) {
+		xfer_outputs(f, is_read, w->p_accu[pd], w->p_oagg[pd],
+			sizeof(SW_WEATHER_OUTPUTS));
+	}
+}
+
+static void xfer_markov(FILE *f, Bool is_read) {
+	SW_MARKOV *m = &SW_Markov;
+	RealD *wetprob = m->wetprob, *dryprob = m->dryprob,
+		*avg_ppt = m->avg_ppt, *std_ppt = m->std_ppt,
+		*cfxw = m->cfxw, *cfxd = m->cfxd, *cfnw = m->cfnw, *cfnd = m->cfnd;
+	Bool shares_prob = m->shares_prob, shares_cov = m->shares_cov;
+
+	xfer(f, is_read, m, sizeof *m);
+
+	m->shares_prob = shares_prob;
+	m->shares_cov = shares_cov;
+
+	m->wetprob = wetprob;
+	m->dryprob = dryprob;
+	m->avg_ppt = avg_ppt;
+	m->std_ppt = std_ppt;
+	m->cfxw = cfxw;
+	m->cfxd = cfxd;
+	m->cfnw = cfnw;
+	m->cfnd = cfnd;
+}
+
+/** The CO2 concentrations are an input of the run and are not transferred */
+static void xfer_carbon(FILE *f, Bool is_read) {
+	SW_CARBON *c = &SW_Carbon;
+	double *ppm = c->ppm;
+	Bool shares_ppm = c->shares_ppm;
+
+	xfer(f, is_read, c, sizeof *c);
+
+	c->ppm = ppm;
+	c->shares_ppm = shares_ppm;
+}
+
+static void xfer_vegprod(FILE *f, Bool is_read) {
+	SW_VEGPROD *v = &SW_VegProd;
+	SW_VEGPROD_OUTPUTS *p_accu[SW_OUTNPERIODS], *p_oagg[SW_OUTNPERIODS];
+	OutPeriod pd;
+
+	memcpy(p_accu, v->p_accu, sizeof p_accu);
+	memcpy(p_oagg, v->p_oagg, sizeof p_oagg);
+
+	xfer(f, is_read, v, sizeof *v);
+
+	memcpy(v->p_accu, p_accu, sizeof p_accu);
+	memcpy(v->p_oagg, p_oagg, sizeof p_oagg);
+
+	ForEachOutPeriod(pd) {
+		xfer_outputs(f, is_read, v->p_accu[pd], v->p_oagg[pd],
+			sizeof(SW_VEGPROD_OUTPUTS));
+	}
+}
+
+static void xfer_vegestab(FILE *f, Bool is_read) {
+	SW_VEGESTAB *v = &SW_VegEstab;
+	IntU i;
+	OutPeriod pd;
+
+	// the number of species is part of the header of the checkpoint
+	for (i = 0; i < v->count; i++) {
+		xfer(f, is_read, v->parms[i], sizeof(SW_VEGESTAB_INFO));
+	}
+
+	if (v->count > 0) {
+		xfer(f, is_read, v->spp.germ_days, v->count * sizeof(TimeInt));
+		xfer(f, is_read, v->spp.drydays_postgerm, v->count * sizeof(TimeInt));
+		xfer(f, is_read, v->spp.wetdays_for_germ, v->count * sizeof(TimeInt));
+		xfer(f, is_read, v->spp.wetdays_for_estab, v->count * sizeof(TimeInt));
+		xfer(f, is_read, v->spp.germd, v->count * sizeof(Bool));
+		xfer(f, is_read, v->spp.active, v->count * sizeof(unsigned int));
+		xfer(f, is_read, &v->spp.n_active, sizeof v->spp.n_active);
+	}
+
+	ForEachOutPeriod(pd) {
+		if (!isnull(v->p_accu[pd])) {
+			xfer_opt(f, is_read, v->p_accu[pd]->days, v->count * sizeof(TimeInt));
+		}
+		if (!isnull(v->p_oagg[pd])) {
+			xfer_opt(f, is_read, v->p_oagg[pd]->days, v->count * sizeof(TimeInt));
+		}
+	}
+}
+
+/** Transfer the dynamic state of the active run; modules without pointers
+    are transferred as a whole */
+static void xfer_state(FILE *f, Bool is_read) {
+	SW_RUN *sw = SW_CurrentRun;
+
+	xfer(f, is_read, &markov_rng, sizeof markov_rng);
+	xfer(f, is_read, &weth_found, sizeof weth_found);
+	xfer(f, is_read, sw->TranspRgnBounds, sizeof sw->TranspRgnBounds);
+	xfer(f, is_read, &sw->SWCInitVal, sizeof sw->SWCInitVal);
+	xfer(f, is_read, &sw->SWCWetVal, sizeof sw->SWCWetVal);
+	xfer(f, is_read, &sw->SWCMinVal, sizeof sw->SWCMinVal);
+	xfer(f, is_read, &sw->temp_snow, sizeof sw->temp_snow);
+
+	xfer(f, is_read, &sw->Model, sizeof sw->Model);
+	xfer(f, is_read, &sw->Site, sizeof sw->Site);
+	xfer_soilwat(f, is_read);
+	xfer_weather(f, is_read);
+	xfer_markov(f, is_read);
+	xfer(f, is_read, &sw->Sky, sizeof sw->Sky);
+	xfer_vegprod(f, is_read);
+	xfer_vegestab(f, is_read);
+	xfer_carbon(f, is_read);
+	xfer(f, is_read, &sw->Flow, sizeof sw->Flow);
+	xfer(f, is_read, &sw->SoilTemp, sizeof sw->SoilTemp);
+	xfer(f, is_read, &sw->PET, sizeof sw->PET);
+}
+
+/** Describe a checkpoint of the active run at the end of `year` */
+static void set_header(SW_CKP_HEADER *h, TimeInt year) {
+	OutPeriod pd;
+
+	memset(h, 0, sizeof *h);
+	memcpy(h->magic, SW_CKP_MAGIC, sizeof h->magic);
+	h->version = SW_CKP_VERSION;
+	h->byteorder = SW_CKP_BYTEORDER;
+	h->size_run = (uint32_t) sizeof(SW_RUN);
+	h->year = year;
+	h->startyr = SW_Model.startyr;
+	h->endyr = SW_Model.endyr;
+	h->n_layers = SW_Site.n_layers;
+	h->n_estab = SW_VegEstab.count;
+
+	ForEachOutPeriod(pd) {
+		if (use_OutPeriod[pd]) {
+			h->out_periods |= 1u << pd;
+		}
+	}
+
+	if (!SW_OutBin.skip_csv) {
+		h->out_format |= SW_OUTFORMAT_CSV;
+	}
+	if (SW_OutBin.use) {
+		h->out_format |= SW_OUTFORMAT_BIN;
+	}
+}
+
+/** Commit the directory entry of a renamed file to disk (best effort) */
+static void sync_dir(const char *fname) {
+	#ifndef _WIN32
+	const char *dname = DirName(fname);
+	int fd = open(('\0' == *dname) ? "." : dname, O_RDONLY);
+
+	if (fd >= 0) {
+		(void) fsync(fd);
+		close(fd);
+	}
+	#else
+	(void) fname;
+	#endif
+}
+
+/** Is a checkpoint due at the end of `year`? */
+static Bool is_due(TimeInt year) {
+	const SW_CHECKPOINT *c = &SW_Checkpoint;
+
+	if (c->every_years > 0 && 0 == (year - SW_Model.startyr + 1) % c->every_years) {
+		return swTRUE;
+	}
+
+	return (Bool) (c->every_seconds > 0 &&
+		difftime(time(NULL), c->last) >= (double) c->every_seconds);
+}
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Name of the checkpoint file of the active run: `SW_CKP_FILENAME`
+  next to the output files
+
+@param fname Resulting file name; of size `FILENAME_MAX`.
+*/
+void SW_CKP_name(char *fname) {
+	SW_OutputPrefix(fname);
+	strcat(fname, SW_CKP_FILENAME);
+}
+
+
+/**
+@brief Write a checkpoint of the active run at the end of a year
+
+The output so far is committed to disk first, then the checkpoint
+replaces the previous one atomically (see `SW_Checkpoint.c`).
+
+@param year The last simulated year.
+
+@note Output files must be open, see `SW_OUT_sync_files()`.
+*/
+void SW_CKP_write(TimeInt year) {
+	char fname[FILENAME_MAX], tmp[FILENAME_MAX + 4];
+	SW_CKP_HEADER h;
+	SW_OUT_FILEPOS pos;
+	FILE *f;
+	Bool ok;
+
+	SW_TRC_START(write);
+
+	SW_OUT_sync_files(&pos);
+
+	SW_CKP_name(fname);
+	snprintf(tmp, sizeof tmp, "%s.tmp", fname);
+
+	set_header(&h, year);
+
+	f = OpenFile(tmp, "wb");
+	xfer(f, swFALSE, &h, sizeof h);
+	xfer(f, swFALSE, &pos, sizeof pos);
+	xfer_state(f, swFALSE);
+
+	ok = (Bool) (!ferror(f) && SyncFile(f));
+	ok = (Bool) (0 == fclose(f) && ok);
+
+	#ifdef _WIN32
+	remove(fname); // rename() does not replace an existing file
+	#endif
+
+	if (!ok || 0 != rename(tmp, fname)) {
+		remove(tmp);
+		LogError(logfp, LOGFATAL, "Cannot write checkpoint file %s", fname);
+	}
+
+	sync_dir(fname);
+
+	SW_Checkpoint.last = time(NULL);
+
+	SW_TRC_STOP_INT(write, "write checkpoint", "output", "year", year);
+}
+
+
+/**
+@brief Load the checkpoint of a previous run into the active run and
+  continue its output files
+
+@param year Resulting last simulated year of the checkpoint.
+
+@return FALSE if there is no checkpoint (nothing is changed).
+
+@note Call this routine instead of `SW_OUT_create_files()` after the run
+  is set up from the same inputs as the run that wrote the checkpoint.
+*/
+Bool SW_CKP_read(TimeInt *year) {
+	char fname[FILENAME_MAX];
+	SW_CKP_HEADER h, expected;
+	SW_OUT_FILEPOS pos;
+	FILE *f;
+
+	SW_CKP_name(fname);
+
+	if (!FileExists(fname)) {
+		return swFALSE;
+	}
+
+	f = OpenFile(fname, "rb");
+	xfer(f, swTRUE, &h, sizeof h);
+
+	set_header(&expected, h.year);
+
+	if (0 != memcmp(&h, &expected, sizeof h) ||
+		h.year < h.startyr || h.year > h.endyr) {
+		fclose(f);
+		LogError(logfp, LOGFATAL,
+			"Checkpoint file %s was written by a different program or from different inputs",
+			fname);
+	}
+
+	xfer(f, swTRUE, &pos, sizeof pos);
+	xfer_state(f, swTRUE);
+
+	if (EOF != fgetc(f)) {
+		fclose(f);
+		LogError(logfp, LOGFATAL, "Checkpoint file %s is too long", fname);
+	}
+
+	fclose(f);
+
+	SW_OUT_resume_files(&pos);
+
+	*year = h.year;
+
+	return swTRUE;
+}
+
+
+/**
+@brief Simulate the active run from its first year or, if requested, from
+  the year after its last checkpoint; write checkpoints as requested
+
+Creates (or continues) the output files, simulates the remaining years,
+writes checkpoints as requested by `SW_Checkpoint` (including one at the
+end of a complete run, so that resuming it does nothing), and closes the
+output files. Without checkpoints, this is equivalent to
+`SW_OUT_create_files()`, `SW_CTL_main()`, and `SW_OUT_close_files()`.
+
+@note Call this routine after `SW_OUT_set_ncol()` and `SW_OUT_set_colnames()`.
+*/
+void SW_CKP_run(void) {
+	SW_CHECKPOINT *c = &SW_Checkpoint;
+	TimeInt year, endyr = SW_Model.endyr;
+	Bool use = (Bool) (c->every_years > 0 || c->every_seconds > 0);
+
+	if (c->resume && SW_CKP_read(&year)) {
+		if (year < endyr) {
+			LogError(logfp, LOGNOTE, "Continue after year %u from the checkpoint.", year);
+		}
+
+	} else {
+		SW_OUT_create_files();
+		year = SW_Model.startyr - 1;
+	}
+
+	c->last = time(NULL);
+
+	while (year < endyr) {
+		year++;
+		SW_CTL_run_years(SW_CurrentRun, year, year);
+
+		if (use && (year == endyr || is_due(year))) {
+			SW_CKP_write(year);
+		}
+	}
+
+	SW_OUT_close_files();
+}
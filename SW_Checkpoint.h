@@ -0,0 +1,87 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Checkpoint.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for the checkpoints of
+ *           `SW_Checkpoint.c` that let an interrupted run of
+ *           SOILWAT2-standalone continue after the last checkpoint.
+ *
+ *           A checkpoint file `[output prefix]sw2_checkpoint.bin` holds
+ *             - a header `SW_CKP_HEADER`,
+ *             - the sizes of the output files `SW_OUT_FILEPOS`, and
+ *             - the dynamic state of the run at the end of the year of
+ *               the header, module by module (see `SW_Checkpoint.c`).
+ *
+ *           A checkpoint can only be resumed by the same program with the
+ *           same inputs; values are stored in the byte order and layout
+ *           of the machine that wrote the checkpoint.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ *     2026-10-15 version 2: without the previous periods of SW_Model.c
+ *     2026-10-15 version 3: with the arrays of the establishment check (SW_VEGESTAB_SPP)
+ *     2026-10-15 version 4: with the days of measured swc of the current year
+ *     2026-10-15 version 5: without the CO2 concentrations (an input of the run)
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_CHECKPOINT_H
+#define SW_CHECKPOINT_H
+
+#include <stdint.h>
+#include <time.h>
+#include "generic.h"
+#include "Times.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+#define SW_CKP_MAGIC "SW2CKPNT" /**< first 8 bytes of a checkpoint file */
+#define SW_CKP_VERSION 5 /**< version of the checkpoint format */
+#define SW_CKP_BYTEORDER 0x01020304 /**< detects a foreign byte order */
+#define SW_CKP_FILENAME "sw2_checkpoint.bin" /**< name of the checkpoint file in the output directory */
+
+/** Header of a checkpoint file */
+typedef struct {
+	char magic[8];
+	uint32_t version, byteorder,
+		size_run, /**< `sizeof(SW_RUN)` of the program that wrote the checkpoint */
+		year, /**< last simulated year; `endyr` if the run is complete */
+		startyr, endyr, /**< simulation period */
+		n_layers, /**< number of soil layers */
+		n_estab, /**< number of species of the establishment module */
+		out_periods, /**< bit `pd` is set if output period `pd` is in use */
+		out_format; /**< `SW_OUTFORMAT_CSV` and/or `SW_OUTFORMAT_BIN` */
+} SW_CKP_HEADER;
+
+/** Checkpoints of a simulation run; zero-initialized means no checkpoints */
+typedef struct {
+	TimeInt every_years; /**< write a checkpoint after every `every_years` simulated years (0: never) */
+	unsigned int every_seconds; /**< write a checkpoint at the end of the first year that ends `every_seconds` after the previous one (0: never) */
+	Bool resume; /**< TRUE: continue after the checkpoint of a previous run if one exists; set before `SW_CTL_setup_model()` */
+	time_t last; /**< time of the previous checkpoint */
+} SW_CHECKPOINT;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_CKP_name(char *fname);
+void SW_CKP_write(TimeInt year);
+Bool SW_CKP_read(TimeInt *year);
+void SW_CKP_run(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -13,6 +13,9 @@
  *     (10-May-02) -- INITIAL CODING - cwb
  02/04/2012	(drs)	in function '_read_inputs()' moved order of 'SW_VPD_read' from after 'SW_VES_read' to before 'SW_SIT_read': SWPcrit is read in in 'SW_VPD_read' and then calculated SWC_atSWPcrit is assigned to each layer in 'SW_SIT_read'
  06/24/2013	(rjm)	added call to SW_FLW_construct() in function SW_CTL_init_model()
+ 2026-10-15	added SW_CTL_begin_year(), SW_CTL_begin_day(), SW_CTL_water_flow(),
+ 						SW_CTL_end_day(), and SW_CTL_end_year() to advance a run by one day
+ 2026-10-15	added SW_CTL_water_flow_part() to simulate the water flow of several runs together
  */
 /********************************************************/
 /********************************************************/
@@ -33,6 +36,7 @@
 #include "SW_Control.h"
 #include "SW_Model.h"
 #include "SW_Output.h"
+#include "SW_Output_reduce.h"
 #include "SW_Site.h"
 #include "SW_Flow_lib.h"
 #include "SW_Flow_lib_PET.h"
@@ -44,15 +48,17 @@
 #include "SW_Markov.h"
 #include "SW_Sky.h"
 #include "SW_Carbon.h"
+#include "SW_Trace.h"
 
 /* =================================================== */
 /*                  Global Declarations                */
 /* --------------------------------------------------- */
-extern SW_MODEL SW_Model;
-extern SW_VEGESTAB SW_VegEstab;
-extern SW_SITE SW_Site;
-extern SW_VEGPROD SW_VegProd;
-extern SW_WEATHER SW_Weather;
+
+/** Simulation run that is active on a thread before any run is activated,
+    e.g., for code that does not (yet) manage its own `SW_RUN` */
+static SW_RUN SW_DefaultRun;
+
+SW_THREAD_LOCAL SW_RUN *SW_CurrentRun = &SW_DefaultRun;
 
 /* =================================================== */
 /*                Module-Level Declarations            */
@@ -64,30 +70,99 @@ static void _end_day(void);
 
 /*******************************************************/
 /***************** Begin Main Code *********************/
+
+/**
+@brief Make a simulation run the active run of the calling thread
+
+All model code (e.g., `SW_Site`, `SW_Model`) operates on the active run
+of the calling thread until another run is activated; allocations come
+from the arena of the active run if it is in use.
+
+@param sw Simulation run context; `NULL` re-activates the default run.
+*/
+void SW_CTL_activate_run(SW_RUN *sw) {
+	SW_CurrentRun = isnull(sw) ? &SW_DefaultRun : sw;
+	Mem_ArenaActivate(isnull(sw) ? NULL : &sw->Arena);
+}
+
 /**
 @brief Calls 'SW_CTL_run_current_year' for each year
           which calls 'SW_SWC_water_flow' for each day.
+
+@param sw Simulation run context.
 */
 
-void SW_CTL_main(void) {
+void SW_CTL_main(SW_RUN *sw) {
+  #ifdef SWDEBUG
+  int debug = 0;
+  #endif
+
+  SW_CTL_activate_run(sw);
+
+  #ifdef SWDEBUG
+  if (debug) swprintf("\n'SW_CTL_main': simulate years %d-%d\n",
+    SW_Model.startyr, SW_Model.endyr);
+  #endif
+
+  SW_CTL_run_years(sw, SW_Model.startyr, SW_Model.endyr);
+} /******* End Main Loop *********/
+
+/**
+@brief Calls 'SW_CTL_run_current_year' for each year of a part of the
+  simulation period.
+
+A run can be checkpointed at the end of a year and several scenarios can
+continue from the checkpoint, e.g., after a shared historical spin-up:
+  1. `SW_CTL_run_years(sw, SW_Model.startyr, Y)` and
+     `SW_OUT_close_files()`,
+  2. `SW_CTL_save_run()` (the checkpoint holds all dynamic state, e.g.,
+     soil water, snowpack, soil temperature, random number generators,
+     and accumulators of establishment and output),
+  3. for each scenario: `SW_CTL_restore_run()`, scenario inputs (e.g.,
+     `SW_Weather.name_prefix`), `SW_F_tag_output_names()`,
+     `SW_OUT_create_files()`, `SW_CTL_run_years(sw, Y + 1, SW_Model.endyr)`,
+     and `SW_OUT_close_files()`.
+
+Alternatively, a process can fork() after step 1 and let each child
+continue with one scenario; the children share the state of the spin-up
+copy-on-write.
+
+@param sw Simulation run context.
+@param firstyr First year to simulate; either `SW_Model.startyr` or the
+  year after the last simulated year.
+@param lastyr Last year to simulate; at most `SW_Model.endyr`.
+*/
+void SW_CTL_run_years(SW_RUN *sw, TimeInt firstyr, TimeInt lastyr) {
   #ifdef SWDEBUG
   int debug = 0;
   #endif
 
-  TimeInt *cur_yr = &SW_Model.year;
+  TimeInt *cur_yr;
 
-  for (*cur_yr = SW_Model.startyr; *cur_yr <= SW_Model.endyr; (*cur_yr)++) {
+  SW_CTL_activate_run(sw);
+  cur_yr = &SW_Model.year;
+
+  for (*cur_yr = firstyr; *cur_yr <= lastyr; (*cur_yr)++) {
     #ifdef SWDEBUG
-    if (debug) swprintf("\n'SW_CTL_main': simulate year = %d\n", *cur_yr);
+    if (debug) swprintf("\n'SW_CTL_run_years': simulate year = %d\n", *cur_yr);
     #endif
 
-    SW_CTL_run_current_year();
+    SW_TRC_START(year);
+    SW_CTL_run_current_year(sw);
+    SW_TRC_STOP_INT(year, "year", "simulation", "year", *cur_yr);
   }
-} /******* End Main Loop *********/
+}
 
 /** @brief Setup and construct model (independent of inputs)
+
+@param sw Simulation run context; must be zero-initialized
+  (or previously cleared by `SW_CTL_clear_model`).
+@param firstfile Name of the main input file; NULL if inputs are passed
+  in memory, see SW_CTL_read_inputs_from_memory().
  */
-void SW_CTL_setup_model(const char *firstfile) {
+void SW_CTL_setup_model(SW_RUN *sw, const char *firstfile) {
+
+	SW_CTL_activate_run(sw);
 
 	SW_F_construct(firstfile);
 	SW_MDL_construct();
@@ -110,9 +185,13 @@ void SW_CTL_setup_model(const char *firstfile) {
 					* do not reset output arrays `p_OUT` and `p_OUTsd` which are used under
 						`SW_OUTARRAY` to pass output in-memory to `rSOILWAT2` and to
 						`STEPWAT2`
-			* if `TRUE`, de-allocate all memory including output arrays.
+			* if `TRUE`, de-allocate all memory including output arrays and
+					release the arena of the run.
+		@param sw Simulation run context.
 */
-void SW_CTL_clear_model(Bool full_reset) {
+void SW_CTL_clear_model(SW_RUN *sw, Bool full_reset) {
+	SW_CTL_activate_run(sw);
+
 	SW_F_deconstruct();
 	SW_MDL_deconstruct();
 	SW_WTH_deconstruct(); // calls SW_MKV_deconstruct() if needed
@@ -124,13 +203,21 @@ void SW_CTL_clear_model(Bool full_reset) {
 	SW_OUT_deconstruct(full_reset);
 	SW_SWC_deconstruct();
 	SW_CBN_deconstruct();
+
+	if (full_reset) {
+		Mem_ArenaRelease(&sw->Arena);
+	}
 }
 
 /** @brief Initialize simulation run (based on user inputs)
   Note: Time will only be set up correctly while carrying out a
   simulation year, i.e., after calling _begin_year()
+
+  @param sw Simulation run context.
 */
-void SW_CTL_init_run(void) {
+void SW_CTL_init_run(SW_RUN *sw) {
+
+	SW_CTL_activate_run(sw);
 
 	// SW_F_init_run() not needed
 	// SW_MDL_init_run() not needed
@@ -139,7 +226,7 @@ void SW_CTL_init_run(void) {
 	SW_PET_init_run();
 	SW_SKY_init_run();
 	SW_SIT_init_run();
-	// SW_VES_init_run() not needed
+	SW_VES_init_run();
 	SW_VPD_init_run();
 	SW_FLW_init_run();
 	SW_ST_init_run();
@@ -150,61 +237,303 @@ void SW_CTL_init_run(void) {
 }
 
 
+/**
+@brief Take an image of a prepared simulation run
+
+The image holds the complete state of the run, e.g., after
+`SW_CTL_read_inputs_from_disk()` and `SW_CTL_init_run()`, so that
+`SW_CTL_restore_run()` can re-start the run from this state without
+re-reading and re-deriving its inputs (e.g., for a parameter sweep), or
+at the end of a simulated year, so that scenarios can continue from a
+shared spin-up (see `SW_CTL_run_years()`).
+
+@param sw Simulation run context; must allocate from its arena
+  (`Arena.use`) so that all of its memory is part of the image.
+@param snap Image of the run; release with `SW_CTL_free_snapshot()`.
+
+@note Take the image while no output files are open, i.e., before
+  `SW_OUT_create_files()` or after `SW_OUT_close_files()`; open files are
+  not part of the image.
+*/
+void SW_CTL_save_run(SW_RUN *sw, SW_RUN_SNAPSHOT *snap) {
+	if (!sw->Arena.use) {
+		LogError(logfp, LOGFATAL,
+			"SW_CTL_save_run(): run does not allocate from its arena.");
+	}
+
+	// the image itself must not be part of the arena
+	Mem_ArenaActivate(NULL);
+	snap->run = (SW_RUN *) Mem_Malloc(sizeof(SW_RUN), "SW_CTL_save_run()");
+	SW_CTL_activate_run(sw);
+
+	snap->sw = sw;
+	Mem_ArenaSave(&sw->Arena, &snap->arena);
+	memcpy(snap->run, sw, sizeof(SW_RUN));
+}
+
+
+/**
+@brief Return a simulation run to the state of an image
+
+Memory that the run allocated after the image was taken is released.
+
+@param sw Simulation run context that `snap` was taken from; must not have
+  been cleared by `SW_CTL_clear_model()` since.
+@param snap Image of the run, see `SW_CTL_save_run()`.
+
+@note Close output files (`SW_OUT_close_files()`) before the run is
+  restored.
+*/
+void SW_CTL_restore_run(SW_RUN *sw, const SW_RUN_SNAPSHOT *snap) {
+	if (snap->sw != sw) {
+		LogError(logfp, LOGFATAL,
+			"SW_CTL_restore_run(): image was taken from another run.");
+	}
+
+	Mem_ArenaRestore(&sw->Arena, &snap->arena);
+	memcpy(sw, snap->run, sizeof(SW_RUN));
+	SW_CTL_activate_run(sw);
+}
+
+
+/**
+@brief Release an image of a simulation run
+
+@param snap Image of the run, see `SW_CTL_save_run()`.
+*/
+void SW_CTL_free_snapshot(SW_RUN_SNAPSHOT *snap) {
+	SW_RUN *sw = SW_CurrentRun;
+
+	Mem_ArenaActivate(NULL);
+	if (!isnull(snap->run)) {
+		Mem_Free(snap->run);
+	}
+	SW_CTL_activate_run(sw);
+
+	Mem_ArenaFreeImage(&snap->arena);
+	snap->run = NULL;
+	snap->sw = NULL;
+}
+
+
 /**
 @brief Calls 'SW_SWC_water_flow' for each day.
+
+@param sw Simulation run context.
 */
-void SW_CTL_run_current_year(void) {
+void SW_CTL_run_current_year(SW_RUN *sw) {
   /*=======================================================*/
-  TimeInt *doy = &SW_Model.doy; // base1
   #ifdef SWDEBUG
   int debug = 0;
   #endif
 
+  SW_CTL_activate_run(sw);
+
   #ifdef SWDEBUG
   if (debug) swprintf("\n'SW_CTL_run_current_year': begin new year\n");
   #endif
-  _begin_year();
+  SW_CTL_begin_year(sw, SW_Model.year);
 
-  for (*doy = SW_Model.firstdoy; *doy <= SW_Model.lastdoy; (*doy)++) {
+  while (SW_CTL_begin_day(sw, NULL)) {
     #ifdef SWDEBUG
-    if (debug) swprintf("\t: begin doy = %d ... ", *doy);
+    if (debug) swprintf("\t: doy = %d: simulate water ... ", SW_Model.doy);
     #endif
-    _begin_day();
-
-    #ifdef SWDEBUG
-    if (debug) swprintf("simulate water ... ");
-    #endif
-    SW_SWC_water_flow();
-
-    // Only run this function if SWA output is asked for
-    if (SW_VegProd.use_SWA) {
-      calculate_repartitioned_soilwater();
-    }
-
-    if (SW_VegEstab.use) {
-      SW_VES_checkestab();
-    }
+    SW_CTL_water_flow(sw, NULL);
 
     #ifdef SWDEBUG
     if (debug) swprintf("ending day ... ");
     #endif
-    _end_day();
+    SW_CTL_end_day(sw);
 
     #ifdef SWDEBUG
-    if (debug) swprintf("doy = %d completed.\n", *doy);
+    if (debug) swprintf("completed.\n");
     #endif
   }
 
   #ifdef SWDEBUG
   if (debug) swprintf("'SW_CTL_run_current_year': flush output\n");
   #endif
-  SW_OUT_flush();
+  SW_CTL_end_year(sw);
 
   #ifdef SWDEBUG
   if (debug) swprintf("'SW_CTL_run_current_year': completed.\n");
   #endif
 }
 
+
+/**
+@brief Start the simulation of a year one day at a time
+
+Programs that couple SOILWAT2 with another model (e.g., a vegetation model)
+advance a run by one day with
+  1. `SW_CTL_begin_year()`,
+  2. for each day: `SW_CTL_begin_day()`, exchange of state through the
+     `SW_DAY_STATE` of the day (e.g., today's vegetation from the
+     coupled model), `SW_CTL_water_flow()`, exchange of state (e.g.,
+     today's transpiration and soil water for the coupled model), and
+     `SW_CTL_end_day()` until `SW_CTL_begin_day()` returns `FALSE`,
+  3. `SW_CTL_end_year()`.
+
+This is what `SW_CTL_run_current_year()` does for a year.
+
+@param sw Simulation run context.
+@param year Calendar year; either `SW_Model.startyr` or the year after
+  the last simulated year.
+*/
+void SW_CTL_begin_year(SW_RUN *sw, TimeInt year) {
+  SW_CTL_activate_run(sw);
+
+  SW_Model.year = year;
+  _begin_year();
+  SW_Model.doy = SW_Model.firstdoy; // base1
+}
+
+
+/**
+@brief Start the next day of the current year
+
+@param sw Simulation run context.
+@param[out] day If not `NULL`, then views of the state of the day (without
+  copies), see `SW_DAY_STATE`.
+
+@return `FALSE` if all days of the year are simulated, i.e., continue with
+  `SW_CTL_end_year()`.
+*/
+Bool SW_CTL_begin_day(SW_RUN *sw, SW_DAY_STATE *day) {
+  TimeInt doy;
+  int k;
+
+  SW_CTL_activate_run(sw);
+
+  if (SW_Model.doy > SW_Model.lastdoy) {
+    return swFALSE;
+  }
+
+  SW_PROFILE_START(eProfBeginDay);
+  _begin_day();
+  SW_PROFILE_STOP(eProfBeginDay);
+
+  if (!isnull(day)) {
+    doy = SW_Model.doy;
+
+    day->year = SW_Model.year;
+    day->doy = doy;
+    day->n_layers = SW_Site.n_layers;
+    day->swcBulk = SW_Soilwat.swcBulk[Today];
+    day->evaporation = SW_Soilwat.evaporation;
+    day->sTemp = SW_Soilwat.sTemp;
+
+    ForEachVegType(k) {
+      day->transpiration[k] = SW_Soilwat.transpiration[k];
+      day->biomass[k] = &SW_VegProd.veg[k].biomass_daily[doy];
+      day->pct_live[k] = &SW_VegProd.veg[k].pct_live_daily[doy];
+      day->litter[k] = &SW_VegProd.veg[k].litter_daily[doy];
+      day->lai_conv[k] = &SW_VegProd.veg[k].lai_conv_daily[doy];
+    }
+
+    day->veg_changed = swFALSE;
+  }
+
+  return swTRUE;
+}
+
+
+/**
+@brief Simulate the water flow of the current day
+
+@param sw Simulation run context.
+@param day The views of the day from `SW_CTL_begin_day()` or `NULL`;
+  if `day->veg_changed`, then values of vegetation that are derived from
+  today's vegetation are updated first, see `SW_VPD_update_day()`.
+*/
+void SW_CTL_water_flow(SW_RUN *sw, const SW_DAY_STATE *day) {
+  SW_CTL_activate_run(sw);
+
+  if (!isnull(day) && day->veg_changed) {
+    SW_VPD_update_day(SW_Model.doy);
+  }
+
+  SW_SWC_water_flow();
+
+  // Only run these functions if their output is asked for
+  if (use_Derived[eSW_DerivedSWA]) {
+    calculate_repartitioned_soilwater();
+  }
+
+  if (SW_VegEstab.use && use_Derived[eSW_DerivedEstab]) {
+    SW_VES_checkestab();
+  }
+}
+
+
+/**
+@brief Simulate one part of the water flow of the current day
+
+The water flow of the day of several runs can be simulated together:
+for each part `0` to `SW_FLW_NPARTS - 1`, call this function for every
+run, and between two parts, calculate the percolation of all runs with
+`SW_FLW_percolate_lanes()` (step `0` after part `0`, step `1` after
+part `1`). The results are identical to those of `SW_CTL_water_flow()`.
+
+@param sw Simulation run context.
+@param day The views of the day from `SW_CTL_begin_day()` or `NULL`,
+  see `SW_CTL_water_flow()`.
+@param part Part of the water flow, see `SW_FLW_water_flow_part()`.
+*/
+void SW_CTL_water_flow_part(SW_RUN *sw, const SW_DAY_STATE *day,
+  unsigned int part) {
+
+  SW_CTL_activate_run(sw);
+
+  if (0 == part && !isnull(day) && day->veg_changed) {
+    SW_VPD_update_day(SW_Model.doy);
+  }
+
+  SW_SWC_water_flow_part(part);
+
+  if (SW_FLW_NPARTS - 1 == part) {
+    // Only run these functions if their output is asked for
+    if (use_Derived[eSW_DerivedSWA]) {
+      calculate_repartitioned_soilwater();
+    }
+
+    if (SW_VegEstab.use && use_Derived[eSW_DerivedEstab]) {
+      SW_VES_checkestab();
+    }
+  }
+}
+
+
+/**
+@brief End the current day: pass today's state to reducers
+  (see `SW_Output_reduce.c`), collect output, and carry today's state over
+  to tomorrow
+
+Views of the day (`SW_DAY_STATE`) are invalid afterwards.
+
+@param sw Simulation run context.
+*/
+void SW_CTL_end_day(SW_RUN *sw) {
+  SW_CTL_activate_run(sw);
+
+  _end_day();
+  SW_Model.doy++;
+}
+
+
+/**
+@brief End the current year: write output of the year and complete
+  the year of reducers (see `SW_Output_reduce.c`)
+
+@param sw Simulation run context.
+*/
+void SW_CTL_end_year(SW_RUN *sw) {
+  SW_CTL_activate_run(sw);
+
+  SW_OUT_flush();
+  SW_OUT_reduce_year();
+}
+
 /**
 @brief Initiate/update variables for a new simulation year.
       In addition to the timekeeper (Model), usually only modules
@@ -219,10 +548,10 @@ static void _begin_year(void) {
 	SW_SKY_new_year(); // Update daily climate variables from monthly values
 	//SW_SIT_new_year() not needed
 	SW_VES_new_year();
+	SW_CBN_new_year(); // CO2 multipliers of the year
 	SW_VPD_new_year(); // Dynamic CO2 effects on vegetation
-	// SW_FLW_new_year() not needed
+	SW_FLW_new_year(); // Radiation and PET of the year (if weather is known)
 	SW_SWC_new_year();
-	// SW_CBN_new_year() not needed
 	SW_OUT_new_year();
 }
 
@@ -232,6 +561,7 @@ static void _begin_day(void) {
 }
 
 static void _end_day(void) {
+	SW_OUT_reduce_day();
 	_collect_values();
 	SW_WTH_end_day();
 	SW_SWC_end_day();
@@ -240,16 +570,21 @@ static void _end_day(void) {
 /**
 @brief Reads inputs from disk and makes a print statement if there is an error
         in doing so.
+
+@param sw Simulation run context.
 */
-void SW_CTL_read_inputs_from_disk(void) {
+void SW_CTL_read_inputs_from_disk(SW_RUN *sw) {
   #ifdef SWDEBUG
   int debug = 0;
   #endif
 
+  SW_CTL_activate_run(sw);
+
   #ifdef SWDEBUG
   if (debug) swprintf("'SW_CTL_read_inputs_from_disk': Read input from disk:");
   #endif
 
+  SW_TRC_START(read);
   SW_F_read(NULL);
   #ifdef SWDEBUG
   if (debug) swprintf(" 'files'");
@@ -307,12 +642,88 @@ void SW_CTL_read_inputs_from_disk(void) {
   if (debug) swprintf(" > 'swc'");
   if (debug) swprintf(" completed.\n");
   #endif
+
+  SW_TRC_STOP(read, "read inputs", "input");
 }
 
 
 
+/**
+@brief Prepare the inputs that a calling program has passed in memory
+  instead of reading input files (equivalent to SW_CTL_read_inputs_from_disk())
+
+A program that links against `libSOILWAT2` simulates a run with
+inputs from memory, e.g., from a database, by
+  1. SW_CTL_setup_model() with `firstfile` set to NULL,
+  2. passing the inputs to the active run (i.e., `sw`):
+     - simulation period: SW_MDL_set_time()
+     - site parameters: elements of `SW_Site` and `SW_Carbon`
+       (as in `siteparam.in`)
+     - vegetation: elements of `SW_VegProd` (as in `veg.in`)
+     - climate: monthly values of `SW_Sky` (as in `climate.in`)
+     - weather: elements of `SW_Weather` (as in `weathsetup.in`) and
+       daily values with SW_WTH_set_memory(); if the weather generator is
+       used, then SW_MKV_construct() and elements of `SW_Markov`
+     - CO2 concentration: `SW_Carbon.ppm` of each simulated year if CO2-effects
+       are turned on
+     - soil layers: set_soillayers() (after the site and vegetation parameters)
+     - output: SW_OUT_set_request() for each output key and
+       SW_OUT_set_format() (e.g., `SW_OUTFORMAT_MEM`, see
+       SW_OUT_get_outarray() and SW_OUT_set_outarray_allocator()) and/or
+       SW_OUT_set_outarray_consumer() to receive output arrays one year
+       at a time
+  3. this function,
+  4. and then, as for inputs from disk, SW_CTL_init_run(), SW_OUT_set_ncol(),
+     SW_OUT_set_colnames(), SW_OUT_create_files(), SW_CTL_main(),
+     SW_OUT_close_files(), and SW_CTL_clear_model().
+
+Inputs that require further input files, i.e., establishment of species
+and historical soil water content, are not available for such runs.
+
+@param sw Simulation run context.
+*/
+void SW_CTL_read_inputs_from_memory(SW_RUN *sw) {
+  LyrIndex i;
+
+  SW_CTL_activate_run(sw);
+
+  if (0 == SW_Model.startyr) {
+    LogError(logfp, LOGFATAL, "Inputs from memory: "
+      "simulation period is not set, see SW_MDL_set_time().");
+  }
+
+  if (0 == SW_Site.n_layers) {
+    LogError(logfp, LOGFATAL, "Inputs from memory: "
+      "soil layers are not set, see set_soillayers().");
+  }
+
+  SW_WTH_init_years();
+
+  if (SW_Weather.use_weathergenerator && isnull(SW_Markov.wetprob)) {
+    LogError(logfp, LOGFATAL, "Inputs from memory: "
+      "weather generator is turned on but its parameters are not set.");
+  }
+
+  SW_VPD_fix_cover();
+
+  if (SW_VegEstab.use || SW_Soilwat.hist_use) {
+    LogError(logfp, LOGFATAL, "Inputs from memory: establishment and "
+      "historical soil water content require input files.");
+  }
+
+  SW_OUT_setup_requests();
+
+  // initial soil temperature, see SW_SWC_read()
+  SW_Soilwat.surfaceTemp = 0;
+  ForEachSoilLayer(i) {
+    SW_Soilwat.sTemp[i] = SW_Soilwat.sTemp_yesterday[i] = SW_Site.sTemp[i];
+  }
+}
+
+
 #ifdef DEBUG_MEM
 #include "SW_Markov.h"  /* for setmemrefs function */
+#include "SW_Run.h"
 
 /**
 @brief This routine sets the known memory refs so they can be
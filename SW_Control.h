@@ -11,6 +11,18 @@
  *
  *  History:
  *     (10-May-02) -- INITIAL CODING - cwb
+ *     (2026-10-14) -- functions operate on a simulation run context `SW_RUN`
+ *                     which replaces the global module state
+ *     (2026-10-14) -- added SW_CTL_read_inputs_from_memory() for programs
+ *                     that pass inputs without input files
+ *     (2026-10-15) -- added SW_CTL_save_run() and SW_CTL_restore_run() to
+ *                     re-start a prepared run without re-reading its inputs
+ *     (2026-10-15) -- added SW_CTL_run_years() to continue scenarios from a
+ *                     checkpoint at the end of a year
+ *     (2026-10-15) -- added SW_CTL_begin_day() and friends to advance a run
+ *                     by one day, e.g., for coupled models
+ *     (2026-10-15) -- added SW_CTL_water_flow_part() to simulate the water
+ *                     flow of several runs together (see SW_Flow.c)
  */
 /********************************************************/
 /********************************************************/
@@ -18,16 +30,56 @@
 #ifndef SW_CONTROL_H
 #define SW_CONTROL_H
 
+#include "SW_Run.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-void SW_CTL_setup_model(const char *firstfile);
-void SW_CTL_clear_model(Bool full_reset);
-void SW_CTL_init_run(void);
-void SW_CTL_read_inputs_from_disk(void);
-void SW_CTL_main(void); /* main controlling loop for SOILWAT  */
-void SW_CTL_run_current_year(void);
+/** Views of the state of the current day of a run, without copies,
+  see `SW_CTL_begin_day()`; views are valid until `SW_CTL_end_day()`.
+
+  Soil values of the day are calculated by `SW_CTL_water_flow()`.
+  Vegetation of the day may be changed after `SW_CTL_begin_day()` and
+  before `SW_CTL_water_flow()`; then set `veg_changed`. */
+typedef struct {
+	TimeInt year, doy; /**< calendar year and day of year (base1) */
+	LyrIndex n_layers; /**< number of soil layers of the arrays */
+
+	const RealD
+		*swcBulk, /**< soil water content of each layer [cm] */
+		*transpiration[NVEGTYPES], /**< transpiration of each layer by vegetation type [cm] */
+		*evaporation, /**< bare-soil evaporation of each layer [cm] */
+		*sTemp; /**< soil temperature of each layer [C] */
+
+	RealD
+		*biomass[NVEGTYPES], /**< aboveground biomass by vegetation type [g / m2] */
+		*pct_live[NVEGTYPES], /**< live biomass in percent of aboveground biomass */
+		*litter[NVEGTYPES], /**< litter [g / m2] */
+		*lai_conv[NVEGTYPES]; /**< biomass that corresponds to LAI = 1 [g / m2] */
+
+	Bool veg_changed; /**< set to TRUE if vegetation of the day was changed */
+} SW_DAY_STATE;
+
+void SW_CTL_activate_run(SW_RUN *sw);
+void SW_CTL_setup_model(SW_RUN *sw, const char *firstfile);
+void SW_CTL_clear_model(SW_RUN *sw, Bool full_reset);
+void SW_CTL_init_run(SW_RUN *sw);
+void SW_CTL_read_inputs_from_disk(SW_RUN *sw);
+void SW_CTL_read_inputs_from_memory(SW_RUN *sw);
+void SW_CTL_main(SW_RUN *sw); /* main controlling loop for SOILWAT  */
+void SW_CTL_run_current_year(SW_RUN *sw);
+void SW_CTL_begin_year(SW_RUN *sw, TimeInt year);
+Bool SW_CTL_begin_day(SW_RUN *sw, SW_DAY_STATE *day);
+void SW_CTL_water_flow(SW_RUN *sw, const SW_DAY_STATE *day);
+void SW_CTL_water_flow_part(SW_RUN *sw, const SW_DAY_STATE *day,
+  unsigned int part);
+void SW_CTL_end_day(SW_RUN *sw);
+void SW_CTL_end_year(SW_RUN *sw);
+void SW_CTL_run_years(SW_RUN *sw, TimeInt firstyr, TimeInt lastyr);
+void SW_CTL_save_run(SW_RUN *sw, SW_RUN_SNAPSHOT *snap);
+void SW_CTL_restore_run(SW_RUN *sw, const SW_RUN_SNAPSHOT *snap);
+void SW_CTL_free_snapshot(SW_RUN_SNAPSHOT *snap);
 
 #ifdef DEBUG_MEM
 void SW_CTL_SetMemoryRefs(void);
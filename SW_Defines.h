@@ -12,6 +12,7 @@
 	05/31/2012  (DLM) added MAX_ST_RGR definition for the maximum amount of soil temperature regressions allowed...
 	07/09/2013	(clk) added the ForEachForbTranspLayer(i) function
  	01/02/2015	(drs) changed MAX_ST_RGR from 30 to 100 (to allow a depth of 10 m and 10 cm intervals)
+	2026-10-15	tanfunc() uses sw_atan(), see SW_FAST_MATH in generic.h
 */
 /********************************************************/
 /********************************************************/
@@ -55,6 +56,10 @@ extern "C" {
 #define MAX_TRANSP_REGIONS 4
 #define MAX_ST_RGR 100
 
+/* methods to solve the soil temperature profile, see `soil_temperature()` */
+#define SW_STMETHOD_EXPLICIT 1 /**< explicit scheme with sub-daily time steps as needed for stability (Parton 1978) */
+#define SW_STMETHOD_CRANKNICOLSON 2 /**< implicit Crank-Nicolson scheme with one time step per day */
+
 #define MAX_NYEAR 2500  /**< An integer representing the max calendar year that is supported. The number just needs to be reasonable, it is an artifical limit. */
 
 #define SW_MISSING     999.     /* value to use as MISSING */
@@ -165,7 +170,7 @@ typedef IntUS OutPeriod;
  *   c - step size (diff of max point to min point)
  *   d - slope of line at inflection point
  */
-#define tanfunc(z,a,b,c,d)  ((b)+((c)/swPI)*atan(swPI*(d)*((z)-(a))) )
+#define tanfunc(z,a,b,c,d)  ((b)+((c)/swPI)*sw_atan(swPI*(d)*((z)-(a))) )
 
 /* To facilitate providing parameters to tanfunc() from the model,
  * this typedef can be used.  The parameters are analagous to a-d
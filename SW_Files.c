@@ -13,6 +13,9 @@
  new module-level variable static char weather_prefix[FILENAME_MAX]; read in in function SW_F_read() from file files.in line 6
  09/30/2011	(drs)	added function SW_OutputPrefix(): so that SW_Output can access local variable output_prefix that is read in now in SW_F_read()
  new module-level variable static char output_prefix[FILENAME_MAX]; read in in function SW_F_read() from file files.in line 12: / for same directory, or e.g., Output/
+ 2026-10-15 added function SW_F_tag_output_names(): so that scenarios forked from a checkpoint write their own output files
+ 2026-10-15 SW_CSV_F_INIT() keeps old output of a run that resumes from a checkpoint (option -r)
+ 2026-10-15 SW_F_read() reads its input file with SW_TEXTFILE instead of the global buffer inbuf
  */
 /********************************************************/
 /********************************************************/
@@ -29,15 +32,12 @@
 #include "myMemory.h"
 #include "SW_Defines.h"
 #include "SW_Files.h"
+#include "SW_Run.h"
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-static char *MyFileName;
-char *InFiles[SW_NFILES];
-char _ProjDir[FILENAME_MAX];
-char weather_prefix[FILENAME_MAX];
-char output_prefix[FILENAME_MAX];
+static SW_THREAD_LOCAL char *MyFileName;
 
 /* =================================================== */
 /* =================================================== */
@@ -65,6 +65,25 @@ static void init(const char *s) {
 
 }
 
+/** Copy a path name that is relative to `_ProjDir` if `relative_to_ProjDir`
+    is set, otherwise relative to the working directory */
+static void copy_path_name(char *dest, const char *s) {
+	if (SW_CurrentRun->Files.relative_to_ProjDir) {
+		strcpy(dest, _ProjDir);
+		strcat(dest, s);
+	} else {
+		strcpy(dest, s);
+	}
+}
+
+/** Copy the name of an output file, see `copy_path_name()` */
+static char *output_file_name(const char *s) {
+	char buf[FILENAME_MAX];
+
+	copy_path_name(buf, s);
+	return Str_Dup(buf);
+}
+
 /* =================================================== */
 /* =================================================== */
 /*             Public Function Definitions             */
@@ -83,12 +102,16 @@ void SW_CSV_F_INIT(const char *s)
 {
 	/* AKT 08/28/2016
 	 *  remove old output and/or create the output directories if needed */
-	/* borrow inbuf for filenames */
 
 	if (DirExists(DirName(s)))
 	{
-		strcpy(inbuf, s);
-		if (!RemoveFiles(inbuf))
+		#ifdef SOILWAT
+		// keep old output that the run continues after its checkpoint
+		if (SW_CurrentRun->Checkpoint.resume)
+			return;
+		#endif
+
+		if (!RemoveFiles(s))
 		{
 			LogError(logfp, LOGWARN, "Can't remove old csv output file: %s\n", s);
 			printf("Can't remove old csv output file: %s\n", s);
@@ -118,7 +141,7 @@ void SW_CSV_F_INIT(const char *s)
       - `logfp` for SOILWAT2-standalone
   */
 void SW_F_read(const char *s) {
-	FILE *f;
+	SW_TEXTFILE f;
 	int lineno = 0, fileno = 0;
 	char buf[FILENAME_MAX];
   #ifdef SWDEBUG
@@ -130,63 +153,63 @@ void SW_F_read(const char *s) {
 		init(s); /* init should be run by SW_F_Construct() */
 
 	MyFileName = SW_F_name(eFirst);
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
 
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 
     #ifdef SWDEBUG
-    if (debug) swprintf("'SW_F_read': line = %d/%d: %s\n", lineno, eEndFile, inbuf);
+    if (debug) swprintf("'SW_F_read': line = %d/%d: %s\n", lineno, eEndFile, f.line);
     #endif
 
 		switch (lineno) {
 		case 5:
-			strcpy(weather_prefix, inbuf);
+			copy_path_name(weather_prefix, f.line);
 			break;
 		case 13:
-			strcpy(output_prefix, inbuf);
+			copy_path_name(output_prefix, f.line);
 			break;
 		case 15:
-			InFiles[eOutputDaily] = Str_Dup(inbuf);
+			InFiles[eOutputDaily] = output_file_name(f.line);
 			++fileno;
 			SW_CSV_F_INIT(InFiles[eOutputDaily]);
 			break;
 		case 16:
-			InFiles[eOutputWeekly] = Str_Dup(inbuf);
+			InFiles[eOutputWeekly] = output_file_name(f.line);
 			++fileno;
 			SW_CSV_F_INIT(InFiles[eOutputWeekly]);
 			//printf("filename: %s \n",InFiles[eOutputWeekly]);
 			break;
 		case 17:
-			InFiles[eOutputMonthly] = Str_Dup(inbuf);
+			InFiles[eOutputMonthly] = output_file_name(f.line);
 			++fileno;
 			SW_CSV_F_INIT(InFiles[eOutputMonthly]);
 			//printf("filename: %s \n",InFiles[eOutputMonthly]);
 			break;
 		case 18:
-			InFiles[eOutputYearly] = Str_Dup(inbuf);
+			InFiles[eOutputYearly] = output_file_name(f.line);
 			++fileno;
 			SW_CSV_F_INIT(InFiles[eOutputYearly]);
 			break;
 		case 19:
-			InFiles[eOutputDaily_soil] = Str_Dup(inbuf);
+			InFiles[eOutputDaily_soil] = output_file_name(f.line);
 			++fileno;
 			SW_CSV_F_INIT(InFiles[eOutputDaily_soil]);
 			//printf("filename: %s \n",InFiles[eOutputDaily]);
 			break;
 		case 20:
-			InFiles[eOutputWeekly_soil] = Str_Dup(inbuf);
+			InFiles[eOutputWeekly_soil] = output_file_name(f.line);
 			++fileno;
 			SW_CSV_F_INIT(InFiles[eOutputWeekly_soil]);
 			//printf("filename: %s \n",InFiles[eOutputWeekly]);
 			break;
 		case 21:
-			InFiles[eOutputMonthly_soil] = Str_Dup(inbuf);
+			InFiles[eOutputMonthly_soil] = output_file_name(f.line);
 			++fileno;
 			SW_CSV_F_INIT(InFiles[eOutputMonthly_soil]);
 			//printf("filename: %s \n",InFiles[eOutputMonthly]);
 			break;
 		case 22:
-			InFiles[eOutputYearly_soil] = Str_Dup(inbuf);
+			InFiles[eOutputYearly_soil] = output_file_name(f.line);
 			++fileno;
 			SW_CSV_F_INIT(InFiles[eOutputYearly_soil]);
 			break;
@@ -199,7 +222,7 @@ void SW_F_read(const char *s) {
 				Mem_Free(InFiles[fileno]);
 
 			strcpy(buf, _ProjDir);
-			strcat(buf, inbuf);
+			strcat(buf, f.line);
 			InFiles[fileno] = Str_Dup(buf);
 		}
 
@@ -207,11 +230,11 @@ void SW_F_read(const char *s) {
 	}
 
 	if (fileno < eEndFile - 1) {
-		CloseFile(&f);
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "Too few files (%d) in %s", fileno, MyFileName);
 	}
 
-	CloseFile(&f);
+	CloseTextFile(&f);
 
 #ifdef SOILWAT
 	if (0 == strcmp(InFiles[eLog], "stdout")) {
@@ -234,13 +257,49 @@ void SW_F_read(const char *s) {
 */
 char *SW_F_name(SW_FileIndex i) {
 	/* =================================================== */
-	return InFiles[i];
+	// a run with inputs in memory has no file names
+	return isnull(InFiles[i]) ? (char *) "" : InFiles[i];
 
 }
+
+/**
+@brief Insert `_tag` into the names of the output files (before the
+  extension), e.g., `sw2_daily.csv` becomes `sw2_daily_tag.csv`
+
+Used to write the output of each scenario that continues from a
+checkpoint into its own files, see `SW_CTL_run_years()`.
+
+@param tag Text that identifies the output files.
+
+@note Call this routine before `SW_OUT_create_files()`.
+*/
+void SW_F_tag_output_names(const char *tag) {
+	int i;
+	char buf[FILENAME_MAX], *name;
+	const char *ext;
+
+	for (i = eOutputDaily; i <= eOutputYearly_soil; i++) {
+		if (isnull(InFiles[i])) {
+			continue;
+		}
+
+		name = InFiles[i];
+		ext = strchr(BaseName(name), '.');
+		if (isnull(ext)) {
+			ext = name + strlen(name);
+		}
+
+		snprintf(buf, sizeof buf, "%.*s_%s%s", (int) (ext - name), name, tag, ext);
+
+		Mem_Free(InFiles[i]);
+		InFiles[i] = Str_Dup(buf);
+	}
+}
 /**
 @brief Determines string length of file being read in combined with _ProjDir.
 
-@param *firstfile File to be read in.
+@param *firstfile File to be read in; NULL if the inputs of the run are
+  passed in memory (no input files).
 
 @sideeffect
 	- *firstfile File to be read in.
@@ -256,6 +315,13 @@ void SW_F_construct(const char *firstfile) {
 	 */
 	char *c, *p;
 
+	if (isnull(firstfile)) {
+		// no input files: inputs are passed in memory,
+		// see `SW_CTL_read_inputs_from_memory()`
+		_ProjDir[0] = '\0';
+		return;
+	}
+
 	init(firstfile);
 
 	if ((c = DirName(firstfile))) {
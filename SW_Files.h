@@ -10,6 +10,7 @@
  *     (1/24/02) -- added logfile entry and rearranged order.
  09/30/2011	(drs)	added function SW_WeatherPrefix()
  09/30/2011	(drs)	added function SW_OutputPrefix()
+ 2026-10-15 added function SW_F_tag_output_names()
  */
 /********************************************************/
 /********************************************************/
@@ -42,6 +43,7 @@ void SW_F_deconstruct(void);
 void SW_WeatherPrefix(char prefix[]);
 void SW_OutputPrefix(char prefix[]);
 void SW_CSV_F_INIT(const char *s);
+void SW_F_tag_output_names(const char *tag);
 
 #ifdef DEBUG_MEM
 void SW_F_SetMemoryRefs(void);
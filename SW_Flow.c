@@ -97,6 +97,18 @@
  06/23/2015 (akt)	Added surfaceTemp[Today] value at structure SW_Weather so that we can add surfaceTemp[Today] in output from Sw_Outout.c get_tmp() function
  02/08/2016 (CMA & CTD) Added snowpack as an input argument to function call of soil_temperature()
  02/08/2016 (CMA & CTD) Modified biomass to use the live biomass as opposed to standing crop
+ 2026-10-14 removed records2arrays() and arrays2records(): the water flow subroutines operate
+ in place on the soil layer arrays of SW_Site and on the daily arrays of SW_Soilwat
+ 2026-10-15 added cycle counters of the sub-steps (SW_PROFILE, see SW_Profile.h)
+ 2026-10-15 added SW_FLW_log_diagnostics() to report the solver and clamp counters of a run
+ 2026-10-15 added SW_FLW_new_year(): radiation and PET of a year are calculated at once
+ if the air temperature of all days is known at the start of the year
+ 2026-10-15 potential rates of soil evaporation and transpiration of all vegetation
+ types are calculated at once by the lane kernels of SW_Flow_lanes.c (one type per lane)
+ 2026-10-15 SW_Water_Flow() checks the daily water balance of every run (SW_WB_MONITOR)
+ 2026-10-15 split SW_Water_Flow() into parts around the saturated and unsaturated percolation:
+ SW_FLW_water_flow_part() and SW_FLW_percolate_lanes() simulate the water flow of several
+ runs with the same number of soil layers, the percolation in lanes (SW_Flow_lanes.c)
  */
 /********************************************************/
 /********************************************************/
@@ -108,6 +120,7 @@
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "generic.h"
 #include "filefuncs.h"
@@ -116,6 +129,7 @@
 #include "SW_Site.h"
 #include "SW_SoilWater.h"
 #include "SW_Flow_lib.h"
+#include "SW_Flow_lanes.h"
 /*#include "SW_VegEstab.h" */
 #include "SW_VegProd.h"
 #include "SW_Weather.h"
@@ -123,65 +137,221 @@
 
 #include "SW_Flow_lib_PET.h"
 #include "SW_Flow.h"
+#include "SW_Run.h"
 
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_MODEL SW_Model;
-extern SW_SITE SW_Site;
-extern SW_SOILWAT SW_Soilwat;
-extern SW_WEATHER SW_Weather;
-extern SW_VEGPROD SW_VegProd;
-extern SW_SKY SW_Sky;
-
-extern unsigned int soil_temp_init;
+
 extern char const *key2veg[];
 
+// names of the invariants of `SW_WB_MONITOR`
+static char const *wb_names[SW_WB_NCHECKS] = {
+	"AET <= PET",
+	"inf == rain + snowmelt + runon - (runoff + intercepted + delta_surfaceWater + Eponded)",
+	"delta_swc == inf - (deepDrainage + Esoil + Ttotal)"
+};
+
+#if SW_LANES < NVEGTYPES
+#error "The lane kernels require one lane per vegetation type (SW_LANES >= NVEGTYPES)."
+#endif
+
 /* *************************************************** */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
 
-/* temporary arrays for SoWat_flow_subs.c subroutines.
- * array indexing in those routines will be from
- * zero rather than 1.  see records2arrays().
+/* The water flow subroutines operate in place on the soil layer arrays
+ * of `SW_Site` (parameters) and on the daily arrays of `SW_Soilwat`
+ * (state and fluxes); array indexing in those routines is from zero.
+ * Only the arrays below have no counterpart in those records.
+ * These are part of the simulation run context, see `SW_FLOW` in SW_Run.h
  */
-IntU lyrTrRegions[NVEGTYPES][MAX_LAYERS];
+#define lyrEvap (SW_CurrentRun->Flow.lyrEvap)
+#define lyrEvap_BareGround (SW_CurrentRun->Flow.lyrEvap_BareGround)
+#define lyrSWCBulk_HalfWiltpts (SW_CurrentRun->Flow.lyrSWCBulk_HalfWiltpts)
 
-RealD lyrSWCBulk[MAX_LAYERS], lyrDrain[MAX_LAYERS],
+#define drainout (SW_CurrentRun->Flow.drainout) /* h2o drained out of deepest layer */
 
-	lyrTransp[NVEGTYPES][MAX_LAYERS], lyrTranspCo[NVEGTYPES][MAX_LAYERS],
-	lyrEvap[NVEGTYPES][MAX_LAYERS], lyrEvap_BareGround[MAX_LAYERS],
-	lyrSWCBulk_atSWPcrit[NVEGTYPES][MAX_LAYERS], lyrHydRed[NVEGTYPES][MAX_LAYERS],
+// variables to help calculate runon from a (hypothetical) upslope neighboring (UpNeigh) site
+#define UpNeigh_lyrSWCBulk (SW_CurrentRun->Flow.UpNeigh_lyrSWCBulk)
+#define UpNeigh_lyrDrain (SW_CurrentRun->Flow.UpNeigh_lyrDrain)
+#define UpNeigh_drainout (SW_CurrentRun->Flow.UpNeigh_drainout)
+#define UpNeigh_standingWater (SW_CurrentRun->Flow.UpNeigh_standingWater)
 
-	lyrbDensity[MAX_LAYERS], lyrWidths[MAX_LAYERS],
-	lyrEvapCo[MAX_LAYERS], lyrSumTrCo[MAX_TRANSP_REGIONS + 1],
-	lyrImpermeability[MAX_LAYERS],
-	lyrSWCBulk_FieldCaps[MAX_LAYERS], lyrSWCBulk_Saturated[MAX_LAYERS],
-	lyrSWCBulk_Wiltpts[MAX_LAYERS], lyrSWCBulk_HalfWiltpts[MAX_LAYERS],
-	lyrSWCBulk_Mins[MAX_LAYERS],
+// note: `SW_CurrentRun->Flow.surfaceTemp` is spelled out because
+// `surfaceTemp` is also a member of `SW_SOILWAT` and of `SW_WEATHER`
+#define veg_int_storage (SW_CurrentRun->Flow.veg_int_storage) // storage of intercepted rain by the vegetation
+#define litter_int_storage (SW_CurrentRun->Flow.litter_int_storage) // storage of intercepted rain by the litter layer
+#define standingWater (SW_CurrentRun->Flow.standingWater) /* water on soil surface if layer below is saturated */
 
-	lyroldsTemp[MAX_LAYERS], lyrsTemp[MAX_LAYERS];
 
-RealD drainout; /* h2o drained out of deepest layer */
+/* *************************************************** */
+/*                Local Functions                      */
+/* --------------------------------------------------- */
 
-// variables to help calculate runon from a (hypothetical) upslope neighboring (UpNeigh) site
-RealD UpNeigh_lyrSWCBulk[MAX_LAYERS], UpNeigh_lyrDrain[MAX_LAYERS], UpNeigh_drainout,
-	UpNeigh_standingWater;
+/** Add the residual of one invariant of today to the water balance monitor;
+    the first violation of the invariant is logged */
+static void wb_monitor_add(unsigned int i, double residual) {
+	SW_WB_MONITOR *m = &SW_CurrentRun->Flow.wbmon;
 
+	// plain comparisons: `fmax()` of generic.h ignores differences below `F_DELTA`
+	residual = fabs(residual);
+	if (residual > m->max_residual[i]) {
+		m->max_residual[i] = residual;
+	}
 
-static RealD surfaceTemp[TWO_DAYS],
-	veg_int_storage[NVEGTYPES], // storage of intercepted rain by the vegetation
-	litter_int_storage, // storage of intercepted rain by the litter layer
-	standingWater[TWO_DAYS]; /* water on soil surface if layer below is saturated */
+	if (residual > SW_WB_TOL) {
+		if (0 == m->failures[i]) {
+			LogError(logfp, LOGWARN, "Water balance (%d-%d): '%s' is violated "
+				"by %g cm; further violations are counted only.",
+				SW_Model.year, SW_Model.doy, wb_names[i], residual);
+		}
+		m->failures[i]++;
+	}
+}
 
+/** Check the water balance of today's `SW_Water_Flow()`, see `SW_WB_MONITOR`
 
-/* *************************************************** */
-/* *************************************************** */
-/*            Private functions                        */
-/* --------------------------------------------------- */
-static void records2arrays(void);
-static void arrays2records(void);
+    @param swc_start Soil water of the profile before today's fluxes.
+    @param aet_surface AET before soil evaporation and transpiration.
+*/
+static void wb_monitor_day(double swc_start, double aet_surface) {
+	const SW_SOILWAT *sw = &SW_Soilwat;
+	const SW_WEATHER *w = &SW_Weather;
+	double swc_end = 0., intercepted = sw->litter_int, arriving, removed;
+	LyrIndex i;
+	int k;
+
+	ForEachSoilLayer(i) {
+		swc_end += sw->swcBulk[Today][i];
+	}
+
+	ForEachVegType(k) {
+		intercepted += sw->int_veg[k];
+	}
+
+	arriving = w->now.rain[Today] + w->snowmelt + w->surfaceRunon;
+	removed = w->snowRunoff + w->surfaceRunoff + intercepted +
+		(standingWater[Today] - standingWater[Yesterday]) + sw->surfaceWater_evap;
+
+	wb_monitor_add(0, (sw->aet > sw->pet) ? sw->aet - sw->pet : 0.);
+	wb_monitor_add(1, w->soil_inf - (arriving - removed));
+	wb_monitor_add(2, (swc_end - swc_start) -
+		(w->soil_inf - (drainout + (sw->aet - aet_surface))));
+
+	SW_CurrentRun->Flow.wbmon.days++;
+}
+
+/** Surface albedo: albedo of bare ground and of vegetation types
+    weighted by their cover */
+static double surface_albedo(void) {
+	SW_VEGPROD *v = &SW_VegProd;
+	double x;
+	int k;
+
+	x = v->bare_cov.albedo * v->bare_cov.fCover;
+	ForEachVegType(k)
+	{
+		x += v->veg[k].cov.albedo * v->veg[k].cov.fCover;
+	}
+
+	return x;
+}
+
+
+/** Copy the parameters of the vegetation types into lanes (one type per
+    lane) for the potential rates of `veglanes_pot_rates()` */
+static void veglanes_new_year(void) {
+	SW_VEGTYPE_LANES *vl = &SW_CurrentRun->Flow.veglanes;
+	SW_VEGPROD *v = &SW_VegProd;
+	unsigned int i, l;
+	int k;
+
+	/* evaporation layers up to the first layer without evaporation */
+	for (i = 0; i < SW_Site.n_evap_lyrs && !ZRO(SW_Site.evap_coeff[i]); i++) {}
+	vl->n_evap_lyrs = i;
+	vl->nlyrs = i;
+
+	ForEachLane(l) {
+		k = vl->vegtype[l] = (l < NVEGTYPES) ? (int) l : 0;
+
+		vl->nlyrs = max(vl->nlyrs, SW_Site.n_transp_lyrs[k]);
+
+		ForEachSoilLayer(i) {
+			vl->evap_coeff[i][l] = SW_Site.evap_coeff[i];
+			vl->width[i][l] = SW_Site.width[i];
+			vl->transp_coeff[i][l] = SW_Site.transp_coeff[k][i];
+			vl->tr_regions[i][l] = (i < SW_Site.n_transp_lyrs[k]) ?
+				SW_Site.my_transp_rgn[k][i] : 0;
+		}
+
+		vl->lai_param[l] = v->veg[k].EsTpartitioning_param;
+		vl->Es_param_limit[l] = v->veg[k].Es_param_limit;
+		vl->shade_scale[l] = v->veg[k].shade_scale;
+		vl->shade_deadmax[l] = v->veg[k].shade_deadmax;
+		vl->co2_wue[l] = v->veg[k].co2_multipliers[WUE_INDEX];
+
+		SW_LANES_set_tanfunc(&vl->evap, l, &SW_Site.evap);
+		SW_LANES_set_tanfunc(&vl->transp, l, &SW_Site.transp);
+		SW_LANES_set_tanfunc(&vl->shade, l, &v->veg[k].tr_shade_effects);
+	}
+}
+
+
+/** Potential rates of soil evaporation and of transpiration of all
+    vegetation types at once; a rate is zero if its type is absent or
+    covered by snow (`scale_veg`), or, for soil evaporation, if there is snow.
+    Types are masked instead of skipped; the rates of each type are
+    identical to those of `pot_soil_evap()` and `pot_transp()`. */
+static void veglanes_pot_rates(int doy, double pet, Bool snowfree,
+	const double scale_veg[], double soil_evap_rate[], double transp_rate[]) {
+
+	SW_VEGTYPE_LANES *vl = &SW_CurrentRun->Flow.veglanes;
+	SW_VEGPROD *v = &SW_VegProd;
+	const double *swp_lyr;
+	unsigned int i, l;
+	int k;
+	double
+		swp[MAX_LAYERS][SW_LANES], petday[SW_LANES],
+		lai[SW_LANES], totagb[SW_LANES], biolive[SW_LANES], biodead[SW_LANES],
+		fbse[SW_LANES], fbst[SW_LANES], swpavg[SW_LANES],
+		evap_rate[SW_LANES], tr_rate[SW_LANES];
+
+	swp_lyr = SW_SWCbulk2SWPmatric_cached(SW_Soilwat.swcBulk[Today], vl->nlyrs);
+
+	for (i = 0; i < vl->nlyrs; i++) {
+		ForEachLane(l) {
+			swp[i][l] = swp_lyr[i];
+		}
+	}
+
+	ForEachLane(l) {
+		k = vl->vegtype[l];
+		petday[l] = pet;
+		lai[l] = v->veg[k].lai_live_daily[doy];
+		totagb[l] = v->veg[k].total_agb_daily[doy];
+		biolive[l] = v->veg[k].biolive_daily[doy];
+		biodead[l] = v->veg[k].biodead_daily[doy];
+	}
+
+	EsT_partitioning_lanes(fbse, fbst, lai, vl->lai_param);
+
+	pot_soil_evap_lanes(evap_rate, vl->n_evap_lyrs, vl->evap_coeff, totagb,
+		fbse, petday, &vl->evap, vl->width, swp, vl->Es_param_limit);
+
+	transp_weighted_avg_lanes(swpavg, SW_Site.n_transp_rgn, vl->nlyrs,
+		vl->tr_regions, vl->transp_coeff, swp);
+
+	pot_transp_lanes(tr_rate, swpavg, biolive, biodead, fbst, petday,
+		&vl->transp, vl->shade_scale, vl->shade_deadmax, &vl->shade, vl->co2_wue);
+
+	ForEachVegType(k) {
+		soil_evap_rate[k] = (GT(scale_veg[k], 0.) && snowfree) ?
+			evap_rate[k] * v->veg[k].cov.fCover : 0.;
+		transp_rate[k] = GT(scale_veg[k], 0.) ? tr_rate[k] * scale_veg[k] : 0.;
+	}
+}
 
 
 
@@ -207,35 +377,116 @@ void SW_FLW_init_run(void) {
 	//These only have to be cleared if a loop is wrong in the code.
 	for (i = 0; i < MAX_LAYERS; i++) {
 		ForEachVegType(k) {
-			lyrTrRegions[k][i] = 0;
-			lyrTransp[k][i] = 0.;
-			lyrTranspCo[k][i] = 0.;
 			lyrEvap[k][i] = 0.;
-			lyrSWCBulk_atSWPcrit[k][i] = 0.;
-			lyrHydRed[k][i] = 0;
 		}
 
-		lyrSWCBulk[i] = lyrDrain[i] = 0.;
 		lyrEvap_BareGround[i] = 0;
-		lyrEvapCo[i] = lyrSWCBulk_FieldCaps[i] = 0;
-		lyrWidths[i] = lyrSWCBulk_Wiltpts[i] = lyrSWCBulk_HalfWiltpts[i] = 0;
-		lyrSWCBulk_Mins[i] = 0;
-		lyrImpermeability[i] = lyrSWCBulk_Saturated[i] = 0;
-		lyroldsTemp[i] = lyrsTemp[i] = lyrbDensity[i] = 0;
+		lyrSWCBulk_HalfWiltpts[i] = 0;
 	}
 
-	for(i=0; i<= MAX_TRANSP_REGIONS; i++)
-		lyrSumTrCo[i] = 0;
-
 	//When running as a library make sure these are set to zero.
 	drainout = 0;
-	surfaceTemp[0] = surfaceTemp[1] = 0.;
+	SW_CurrentRun->Flow.surfaceTemp[0] = SW_CurrentRun->Flow.surfaceTemp[1] = 0.;
 	standingWater[0] = standingWater[1] = 0.;
 	litter_int_storage = 0.;
 
 	ForEachVegType(k) {
 		veg_int_storage[k] = 0.;
 	}
+
+	memset(&SW_CurrentRun->Flow.diag, 0, sizeof SW_CurrentRun->Flow.diag);
+	memset(&SW_CurrentRun->Flow.wbmon, 0, sizeof SW_CurrentRun->Flow.wbmon);
+	memset(&SW_CurrentRun->Flow.day, 0, sizeof SW_CurrentRun->Flow.day);
+}
+
+
+/**
+@brief Calculate radiation and PET of all days of the year at once
+
+If the daily air temperature of the year is known before the year is
+simulated (see `SW_WTH_temp_avg_year()`), e.g., if weather is preloaded,
+then `SW_Water_Flow()` uses the values of `SW_PET_YEAR` instead of
+calculating radiation and PET day by day.
+
+@note Call this routine after the weather, sky, and vegetation of the
+  year are set up.
+*/
+void SW_FLW_new_year(void) {
+	SW_PET_YEAR *py = &SW_CurrentRun->PET.year;
+	double temp_avg[MAX_DAYS + 1];
+
+	veglanes_new_year();
+
+	py->use = SW_WTH_temp_avg_year(temp_avg);
+
+	if (!py->use) {
+		return;
+	}
+
+	py->albedo = surface_albedo();
+
+	SW_BENCH_START(eBenchRadPET);
+	SW_PROFILE_START(eProfRadPET);
+	pet_days(
+		SW_Model.firstdoy,
+		SW_Model.lastdoy,
+		SW_Site.latitude,
+		SW_Site.altitude,
+		SW_Site.slope,
+		SW_Site.aspect,
+		py->albedo,
+		temp_avg,
+		SW_Sky.r_humidity_daily,
+		SW_Sky.windspeed_daily,
+		SW_Sky.cloudcov_daily,
+		py->H_oh,
+		py->H_ot,
+		py->H_gh,
+		py->H_gt,
+		py->pet
+	);
+	SW_PROFILE_STOP(eProfRadPET);
+	SW_BENCH_STOP(eBenchRadPET);
+}
+
+
+/**
+@brief Write the solver and clamp counters of the active run to the logfile
+
+Reports how often the explicit soil temperature scheme halved its time
+step, the histogram of its realized sub-steps per day, failures of the
+soil temperature solver, freezing/thawing adjustments, and how often
+removals by evaporation and transpiration and unsaturated percolation
+were limited by the available soil water (see `SW_FLOW_DIAG`), and the
+largest residual and number of violations of each water balance invariant
+(see `SW_WB_MONITOR`).
+*/
+void SW_FLW_log_diagnostics(void) {
+	const SW_FLOW_DIAG *d = &SW_CurrentRun->Flow.diag;
+	const SW_WB_MONITOR *m = &SW_CurrentRun->Flow.wbmon;
+	unsigned int i;
+
+	LogError(logfp, LOGNOTE, "Diagnostics of the water flow and soil temperature solvers:");
+	LogError(logfp, LOGNOTE,
+		"  soil temperature: %lu days (explicit scheme), %lu time step halvings, "
+		"%lu solver failures",
+		d->st_days, d->st_halvings, d->st_failures);
+	LogError(logfp, LOGNOTE,
+		"  days by sub-steps: 1: %lu, 2: %lu, 4: %lu, 8: %lu, 16: %lu, >16: %lu",
+		d->st_nsteps[0], d->st_nsteps[1], d->st_nsteps[2],
+		d->st_nsteps[3], d->st_nsteps[4], d->st_nsteps[5]);
+	LogError(logfp, LOGNOTE,
+		"  freezing/thawing: %lu calls, %lu adjusted soil temperature",
+		d->ft_calls, d->ft_adjusted);
+	LogError(logfp, LOGNOTE,
+		"  limited by available water: %lu layer removals (evaporation, "
+		"transpiration), %lu layer percolations; %lu layers above saturation",
+		d->clamp_remove, d->clamp_perc, d->push_sat);
+	LogError(logfp, LOGNOTE, "  water balance: %lu days checked", m->days);
+	for (i = 0; i < SW_WB_NCHECKS; i++) {
+		LogError(logfp, LOGNOTE, "    '%s': max. residual %g cm, %lu violations",
+			wb_names[i], m->max_residual[i], m->failures[i]);
+	}
 }
 
 
@@ -243,24 +494,28 @@ void SW_FLW_init_run(void) {
 /* *************************************************** */
 /*            The Water Flow                           */
 /* --------------------------------------------------- */
-void SW_Water_Flow(void) {
-	#ifdef SWDEBUG
-	IntUS debug = 0, debug_year = 1980, debug_doy = 350;
-	double Eveg, Tveg, HRveg;
-	#endif
+/* `SW_Water_Flow()` consists of parts that are separated by the saturated
+ * and the unsaturated percolation so that the percolation of several runs
+ * can be calculated at once by the lane kernels, see
+ * `SW_FLW_water_flow_part()` and `SW_FLW_percolate_lanes()`.
+ * Today's values that are carried from one part to the next are kept in
+ * `SW_FLOW_DAY` of the run.
+ */
 
-  SW_VEGPROD *v = &SW_VegProd;
-  SW_SOILWAT *sw = &SW_Soilwat;
-  SW_WEATHER *w = &SW_Weather;
+#ifdef SWDEBUG
+static IntUS debug = 0, debug_year = 1980, debug_doy = 350;
+#endif
 
-	RealD swpot_avg[NVEGTYPES],
-		transp_veg[NVEGTYPES], transp_rate[NVEGTYPES],
-		soil_evap[NVEGTYPES], soil_evap_rate[NVEGTYPES], soil_evap_rate_bs = 1.,
-		surface_evap_veg_rate[NVEGTYPES],
-		surface_evap_litter_rate = 1., surface_evap_standingWater_rate = 1.,
-		h2o_for_soil = 0., snowmelt,
-		scale_veg[NVEGTYPES],
-		pet2, peti, rate_help, x;
+/** Water flow of today up to the infiltration: soil temperature set-up,
+    radiation and PET, snow depth, and rainfall interception */
+static void flow_surface(void) {
+	SW_VEGPROD *v = &SW_VegProd;
+	SW_SOILWAT *sw = &SW_Soilwat;
+	SW_WEATHER *w = &SW_Weather;
+	SW_FLOW_DAY *day = &SW_CurrentRun->Flow.day;
+	const SW_PET_YEAR *py = &SW_CurrentRun->PET.year;
+
+	RealD h2o_for_soil, *scale_veg = day->scale_veg, x;
 
 	int doy, month, k;
 	LyrIndex i;
@@ -268,13 +523,26 @@ void SW_Water_Flow(void) {
 	doy = SW_Model.doy; /* base1 */
 	month = SW_Model.month; /* base0 */
 
-	records2arrays();
+	day->flowing = swTRUE;
+	day->swc_start = 0.;
+
+	if (SW_Model.doy == SW_Model.firstdoy) {
+		/* soil evaporation extracts water down to half of wilting point */
+		ForEachEvapLayer(i) {
+			lyrSWCBulk_HalfWiltpts[i] = SW_Site.swcBulk_wiltpt[i] / 2.;
+		}
+	}
+
+	/* soil water before today's fluxes (water balance monitor) */
+	ForEachSoilLayer(i) {
+		day->swc_start += sw->swcBulk[Today][i];
+	}
 
 	#ifdef SWDEBUG
 	if (debug && SW_Model.year == debug_year && SW_Model.doy == debug_doy) {
 		swprintf("Flow (%d-%d): start:", SW_Model.year, SW_Model.doy);
 		ForEachSoilLayer(i) {
-			swprintf(" swc[%i]=%1.3f", i, lyrSWCBulk[i]);
+			swprintf(" swc[%i]=%1.3f", i, sw->swcBulk[Today][i]);
 		}
 		swprintf("\n");
 	}
@@ -288,15 +556,15 @@ void SW_Water_Flow(void) {
 		*/
 		SW_ST_setup_run(
 			w->now.temp_avg[Today],
-			lyrSWCBulk,
-			lyrSWCBulk_Saturated,
-			lyrbDensity,
-			lyrWidths,
-			lyroldsTemp,
-			surfaceTemp,
+			sw->swcBulk[Today],
+			SW_Site.swcBulk_saturated,
+			SW_Site.soilBulk_density,
+			SW_Site.width,
+			sw->sTemp_yesterday,
+			SW_CurrentRun->Flow.surfaceTemp,
 			SW_Site.n_layers,
-			lyrSWCBulk_FieldCaps,
-			lyrSWCBulk_Wiltpts,
+			SW_Site.swcBulk_fieldcap,
+			SW_Site.swcBulk_wiltpt,
 			SW_Site.Tsoil_constant,
 			SW_Site.stDeltaX,
 			SW_Site.stMaxDepth,
@@ -307,36 +575,46 @@ void SW_Water_Flow(void) {
 
 
 	/* Solar radiation and PET */
-	x = v->bare_cov.albedo * v->bare_cov.fCover;
-	ForEachVegType(k)
-	{
-		x += v->veg[k].cov.albedo * v->veg[k].cov.fCover;
-	}
+	x = surface_albedo();
+
+	SW_BENCH_START(eBenchRadPET);
+	SW_PROFILE_START(eProfRadPET);
+	if (py->use && x == py->albedo) {
+		// calculated for the year by `SW_FLW_new_year()`
+		sw->H_oh = py->H_oh[doy];
+		sw->H_ot = py->H_ot[doy];
+		sw->H_gh = py->H_gh[doy];
+		sw->H_gt = py->H_gt[doy];
+		sw->pet = SW_Site.pet_scale * py->pet[doy];
 
-	sw->H_gt = solar_radiation(
-		doy,
-		SW_Site.latitude,
-		SW_Site.altitude,
-		SW_Site.slope,
-		SW_Site.aspect,
-		x,
-		SW_Sky.cloudcov_daily[doy],
-		SW_Sky.r_humidity_daily[doy],
-		w->now.temp_avg[Today],
-		&sw->H_oh,
-		&sw->H_ot,
-		&sw->H_gh
-	);
+	} else {
+		sw->H_gt = solar_radiation(
+			doy,
+			SW_Site.latitude,
+			SW_Site.altitude,
+			SW_Site.slope,
+			SW_Site.aspect,
+			x,
+			SW_Sky.cloudcov_daily[doy],
+			SW_Sky.r_humidity_daily[doy],
+			w->now.temp_avg[Today],
+			&sw->H_oh,
+			&sw->H_ot,
+			&sw->H_gh
+		);
 
-	sw->pet = SW_Site.pet_scale * petfunc(
-		sw->H_gt,
-		w->now.temp_avg[Today],
-		SW_Site.altitude,
-		x,
-		SW_Sky.r_humidity_daily[doy],
-		SW_Sky.windspeed_daily[doy],
-		SW_Sky.cloudcov_daily[doy]
-	);
+		sw->pet = SW_Site.pet_scale * petfunc(
+			sw->H_gt,
+			w->now.temp_avg[Today],
+			SW_Site.altitude,
+			x,
+			SW_Sky.r_humidity_daily[doy],
+			SW_Sky.windspeed_daily[doy],
+			SW_Sky.cloudcov_daily[doy]
+		);
+	}
+	SW_PROFILE_STOP(eProfRadPET);
+	SW_BENCH_STOP(eBenchRadPET);
 
 
 	/* snowdepth scaling */
@@ -350,14 +628,13 @@ void SW_Water_Flow(void) {
 
 	ForEachVegType(k)
 	{
-		scale_veg[k] = v->veg[k].cov.fCover;
-
-		if (GT(v->veg[k].veg_height_daily[doy], 0.)) {
-			scale_veg[k] *= 1. - sw->snowdepth / v->veg[k].veg_height_daily[doy];
-		}
+		x = v->veg[k].veg_height_daily[doy];
+		scale_veg[k] = GT(x, 0.) ?
+			v->veg[k].cov.fCover * (1. - sw->snowdepth / x) : v->veg[k].cov.fCover;
 	}
 
 	/* Rainfall interception */
+	SW_PROFILE_START(eProfInterception);
 	h2o_for_soil = w->now.rain[Today]; /* ppt is partioned into ppt = snow + rain */
 
   ForEachVegType(k)
@@ -391,16 +668,28 @@ void SW_Water_Flow(void) {
     }
   }
 
+	SW_PROFILE_STOP(eProfInterception);
 	/* End Interception */
 
+	day->h2o_for_soil = h2o_for_soil;
+}
+
+
+/** Surface water before the saturated percolation: snowmelt and runon */
+static void infiltration_begin(void) {
+	SW_SOILWAT *sw = &SW_Soilwat;
+	SW_WEATHER *w = &SW_Weather;
+	SW_FLOW_DAY *day = &SW_CurrentRun->Flow.day;
+
+	RealD snowmelt;
+	LyrIndex i;
 
-	/* Surface water */
 	standingWater[Today] = standingWater[Yesterday];
 
 	/* Snow melt infiltrates un-intercepted */
 	snowmelt = fmax( 0., w->snowmelt * (1. - w->pct_snowRunoff/100.) ); /* amount of snowmelt is changed by runon/off as percentage */
 	w->snowRunoff = w->snowmelt - snowmelt;
-	h2o_for_soil += snowmelt;
+	day->h2o_for_soil += snowmelt;
 
 	/* @brief Surface water runon:
 			Proportion of water that arrives at surface added as daily runon from a hypothetical
@@ -412,16 +701,16 @@ void SW_Water_Flow(void) {
 		// Calculate 'rain + snowmelt - interception - infiltration' for upslope neighbor
 		// Copy values to simulate identical upslope neighbor site
 		ForEachSoilLayer(i) {
-			UpNeigh_lyrSWCBulk[i] = lyrSWCBulk[i];
-			UpNeigh_lyrDrain[i] = lyrDrain[i];
+			UpNeigh_lyrSWCBulk[i] = sw->swcBulk[Today][i];
+			UpNeigh_lyrDrain[i] = sw->drain[i];
 		}
 		UpNeigh_drainout = drainout;
 		UpNeigh_standingWater = standingWater[Today];
 
 		// Infiltrate for upslope neighbor under saturated soil conditions
 		infiltrate_water_high(UpNeigh_lyrSWCBulk, UpNeigh_lyrDrain, &UpNeigh_drainout,
-			h2o_for_soil, SW_Site.n_layers, lyrSWCBulk_FieldCaps, lyrSWCBulk_Saturated,
-			lyrImpermeability, &UpNeigh_standingWater);
+			day->h2o_for_soil, SW_Site.n_layers, SW_Site.swcBulk_fieldcap, SW_Site.swcBulk_saturated,
+			SW_Site.impermeability, &UpNeigh_standingWater);
 
 		// Runon as percentage from today's surface water addition on upslope neighbor
 		w->surfaceRunon = fmax(0., (UpNeigh_standingWater - standingWater[Yesterday]) * SW_Site.percentRunon);
@@ -432,23 +721,32 @@ void SW_Water_Flow(void) {
 	}
 
 	/* Soil infiltration */
-	w->soil_inf = h2o_for_soil;
+	w->soil_inf = day->h2o_for_soil;
 
 	/* Percolation under saturated soil conditions */
 	w->soil_inf += standingWater[Today];
-	infiltrate_water_high(lyrSWCBulk, lyrDrain, &drainout, h2o_for_soil, SW_Site.n_layers,
-		lyrSWCBulk_FieldCaps, lyrSWCBulk_Saturated, lyrImpermeability, &standingWater[Today]);
+}
+
+
+/** Surface water after the saturated percolation: runoff */
+static void infiltration_end(void) {
+	SW_WEATHER *w = &SW_Weather;
+	#ifdef SWDEBUG
+	SW_SOILWAT *sw = &SW_Soilwat;
+	LyrIndex i;
+	#endif
+
 	w->soil_inf -= standingWater[Today]; // adjust soil_infiltration for not infiltrated surface water
 
 	#ifdef SWDEBUG
 	if (debug && SW_Model.year == debug_year && SW_Model.doy == debug_doy) {
 		swprintf("Flow (%d-%d): satperc:", SW_Model.year, SW_Model.doy);
 		ForEachSoilLayer(i) {
-			swprintf(" swc[%i]=%1.3f", i, lyrSWCBulk[i]);
+			swprintf(" swc[%i]=%1.3f", i, sw->swcBulk[Today][i]);
 		}
 		swprintf("\n              : satperc:");
 		ForEachSoilLayer(i) {
-			swprintf(" perc[%d]=%1.3f", i, lyrDrain[i]);
+			swprintf(" perc[%d]=%1.3f", i, sw->drain[i]);
 		}
 		swprintf("\n");
 	}
@@ -466,16 +764,40 @@ void SW_Water_Flow(void) {
 	} else {
 		w->surfaceRunoff = 0.;
 	}
+}
 
-	// end surface water and infiltration
 
+/** Water flow of today between the saturated and the unsaturated
+    percolation: evaporation, transpiration, and hydraulic redistribution */
+static void flow_soil(void) {
+	#ifdef SWDEBUG
+	double Eveg, Tveg, HRveg;
+	#endif
+
+	SW_VEGPROD *v = &SW_VegProd;
+	SW_SOILWAT *sw = &SW_Soilwat;
+	SW_WEATHER *w = &SW_Weather;
+	SW_FLOW_DAY *day = &SW_CurrentRun->Flow.day;
+
+	RealD transp_rate[NVEGTYPES],
+		soil_evap_rate[NVEGTYPES], soil_evap_rate_bs = 1.,
+		surface_evap_veg_rate[NVEGTYPES],
+		surface_evap_litter_rate = 1., surface_evap_standingWater_rate = 1.,
+		*scale_veg = day->scale_veg,
+		pet2, peti, rate_help;
+
+	int doy, k;
+	LyrIndex i;
+
+	doy = SW_Model.doy; /* base1 */
 
 	/* Potential bare-soil evaporation rates */
+	SW_PROFILE_START(eProfETRates);
 	if (GT(v->bare_cov.fCover, 0.) && EQ(sw->snowpack[Today], 0.)) /* bare ground present AND no snow on ground */
 	{
-		pot_soil_evap_bs(&soil_evap_rate_bs, SW_Site.n_evap_lyrs, lyrEvapCo, sw->pet,
+		pot_soil_evap_bs(&soil_evap_rate_bs, SW_Site.n_evap_lyrs, SW_Site.evap_coeff, sw->pet,
 			SW_Site.evap.xinflec, SW_Site.evap.slope, SW_Site.evap.yinflec,
-			SW_Site.evap.range, lyrWidths, lyrSWCBulk);
+			SW_Site.evap.range, SW_Site.width, sw->swcBulk[Today]);
 		soil_evap_rate_bs *= v->bare_cov.fCover;
 
 	} else {
@@ -483,45 +805,11 @@ void SW_Water_Flow(void) {
 	}
 
 
-	/* Potential transpiration & bare-soil evaporation rates */
-	ForEachVegType(k)
-	{
-		if (GT(scale_veg[k], 0.)) {
-			/* vegetation type k present AND not fully covered in snow */
-			EsT_partitioning(&soil_evap[k], &transp_veg[k], v->veg[k].lai_live_daily[doy],
-				v->veg[k].EsTpartitioning_param);
-
-			if (EQ(sw->snowpack[Today], 0.)) { /* bare-soil evaporation only when no snow */
-				pot_soil_evap(&soil_evap_rate[k], SW_Site.n_evap_lyrs, lyrEvapCo,
-					v->veg[k].total_agb_daily[doy], soil_evap[k], sw->pet,
-					SW_Site.evap.xinflec, SW_Site.evap.slope, SW_Site.evap.yinflec, SW_Site.evap.range,
-					lyrWidths, lyrSWCBulk, v->veg[k].Es_param_limit);
-
-				soil_evap_rate[k] *= v->veg[k].cov.fCover;
-
-			} else {
-				soil_evap_rate[k] = 0.;
-			}
-
-			transp_weighted_avg(&swpot_avg[k], SW_Site.n_transp_rgn, SW_Site.n_transp_lyrs[k],
-				lyrTrRegions[k], lyrTranspCo[k], lyrSWCBulk);
-
-			pot_transp(&transp_rate[k], swpot_avg[k],
-				v->veg[k].biolive_daily[doy], v->veg[k].biodead_daily[doy],
-				transp_veg[k], sw->pet,
-				SW_Site.transp.xinflec, SW_Site.transp.slope, SW_Site.transp.yinflec, SW_Site.transp.range,
-				v->veg[k].shade_scale, v->veg[k].shade_deadmax,
-				v->veg[k].tr_shade_effects.xinflec, v->veg[k].tr_shade_effects.slope,
-				v->veg[k].tr_shade_effects.yinflec, v->veg[k].tr_shade_effects.range,
-				v->veg[k].co2_multipliers[WUE_INDEX][SW_Model.simyear]);
-
-			transp_rate[k] *= scale_veg[k];
-
-		} else {
-			soil_evap_rate[k] = 0.;
-			transp_rate[k] = 0.;
-		}
-	}
+	/* Potential transpiration & bare-soil evaporation rates of vegetation
+		types that are present AND not fully covered in snow;
+		bare-soil evaporation only when no snow */
+	veglanes_pot_rates(doy, sw->pet, itob(EQ(sw->snowpack[Today], 0.)),
+		scale_veg, soil_evap_rate, transp_rate);
 
 
 	/* Snow sublimation takes precedence over other ET fluxes:
@@ -564,10 +852,13 @@ void SW_Water_Flow(void) {
 		soil_evap_rate_bs *= rate_help;
 	}
 
+	SW_PROFILE_STOP(eProfETRates);
+
 	/* Start adding components to AET */
 	sw->aet = w->snowloss; /* init aet for the day */
 
 	/* Evaporation of intercepted and surface water */
+	SW_PROFILE_START(eProfEvaporation);
 	ForEachVegType(k)
 	{
 		evap_fromSurface(&veg_int_storage[k], &surface_evap_veg_rate[k], &sw->aet);
@@ -579,12 +870,13 @@ void SW_Water_Flow(void) {
 
 	sw->litter_evap = surface_evap_litter_rate;
 	sw->surfaceWater_evap = surface_evap_standingWater_rate;
+	day->aet_surface = sw->aet;
 
 	/* bare-soil evaporation */
 	if (GT(v->bare_cov.fCover, 0.) && EQ(sw->snowpack[Today], 0.)) {
 		/* remove bare-soil evap from swv */
-		remove_from_soil(lyrSWCBulk, lyrEvap_BareGround, &sw->aet, SW_Site.n_evap_lyrs,
-			lyrEvapCo, soil_evap_rate_bs, lyrSWCBulk_HalfWiltpts);
+		remove_from_soil(sw->swcBulk[Today], lyrEvap_BareGround, &sw->aet, SW_Site.n_evap_lyrs,
+			SW_Site.evap_coeff, soil_evap_rate_bs, lyrSWCBulk_HalfWiltpts);
 
 	} else {
 		/* Set daily array to zero, no evaporation */
@@ -592,12 +884,13 @@ void SW_Water_Flow(void) {
 			lyrEvap_BareGround[i] = 0.;
 		}
 	}
+	SW_PROFILE_STOP(eProfEvaporation);
 
 	#ifdef SWDEBUG
 	if (debug && SW_Model.year == debug_year && SW_Model.doy == debug_doy) {
 		swprintf("Flow (%d-%d): Esoil:", SW_Model.year, SW_Model.doy);
 		ForEachSoilLayer(i) {
-			swprintf(" swc[%i]=%1.3f", i, lyrSWCBulk[i]);
+			swprintf(" swc[%i]=%1.3f", i, sw->swcBulk[Today][i]);
 		}
 		swprintf("\n              : Esoil:");
 		ForEachSoilLayer(i) {
@@ -608,37 +901,39 @@ void SW_Water_Flow(void) {
 	#endif
 
 	/* Vegetation transpiration and bare-soil evaporation */
+	SW_PROFILE_START(eProfTranspiration);
 	ForEachVegType(k)
 	{
 		if (GT(scale_veg[k], 0.)) {
 			/* remove bare-soil evap from swc */
-			remove_from_soil(lyrSWCBulk, lyrEvap[k], &sw->aet, SW_Site.n_evap_lyrs,
-				lyrEvapCo, soil_evap_rate[k], lyrSWCBulk_HalfWiltpts);
+			remove_from_soil(sw->swcBulk[Today], lyrEvap[k], &sw->aet, SW_Site.n_evap_lyrs,
+				SW_Site.evap_coeff, soil_evap_rate[k], lyrSWCBulk_HalfWiltpts);
 
 			/* remove transp from swc */
-			remove_from_soil(lyrSWCBulk, lyrTransp[k], &sw->aet, SW_Site.n_transp_lyrs[k],
-				lyrTranspCo[k], transp_rate[k], lyrSWCBulk_atSWPcrit[k]);
+			remove_from_soil(sw->swcBulk[Today], sw->transpiration[k], &sw->aet, SW_Site.n_transp_lyrs[k],
+				SW_Site.transp_coeff[k], transp_rate[k], SW_Site.swcBulk_atSWPcrit[k]);
 
 		} else {
 			/* Set daily array to zero, no evaporation or transpiration */
 			ForEachSoilLayer(i) {
-				lyrTransp[k][i] = lyrEvap[k][i] = 0.;
+				sw->transpiration[k][i] = lyrEvap[k][i] = 0.;
 			}
 		}
 	}
+	SW_PROFILE_STOP(eProfTranspiration);
 
 	#ifdef SWDEBUG
 	if (debug && SW_Model.year == debug_year && SW_Model.doy == debug_doy) {
 		swprintf("Flow (%d-%d): ETveg:", SW_Model.year, SW_Model.doy);
 		ForEachSoilLayer(i) {
-			swprintf(" swc[%i]=%1.3f", i, lyrSWCBulk[i]);
+			swprintf(" swc[%i]=%1.3f", i, sw->swcBulk[Today][i]);
 		}
 		swprintf("\n              : ETveg:");
 		ForEachSoilLayer(i) {
 			Eveg = Tveg = 0.;
 			ForEachVegType(k) {
 				Eveg += lyrEvap[k][i];
-				Tveg += lyrTransp[k][i];
+				Tveg += sw->transpiration[k][i];
 			}
 			swprintf(" Tveg[%d]=%1.3f/Eveg=%1.3f", i, Tveg, Eveg);
 		}
@@ -648,52 +943,57 @@ void SW_Water_Flow(void) {
 
 
 	/* Hydraulic redistribution */
+	SW_PROFILE_START(eProfHydRed);
 	ForEachVegTypeBottomUp(k) {
 		if (v->veg[k].flagHydraulicRedistribution && GT(v->veg[k].cov.fCover, 0.) &&
 			GT(v->veg[k].biolive_daily[doy], 0.)) {
 
-			hydraulic_redistribution(lyrSWCBulk, lyrSWCBulk_Wiltpts, lyrTranspCo[k],
-				lyrHydRed[k], SW_Site.n_layers, v->veg[k].maxCondroot, v->veg[k].swpMatric50,
+			hydraulic_redistribution(sw->swcBulk[Today], SW_Site.swcBulk_wiltpt, SW_Site.transp_coeff[k],
+				sw->hydred[k], SW_Site.n_layers, v->veg[k].maxCondroot, v->veg[k].swpMatric50,
 				v->veg[k].shapeCond, v->veg[k].cov.fCover);
 
 		} else {
 			/* Set daily array to zero */
 			ForEachSoilLayer(i) {
-				lyrHydRed[k][i] = 0.;
+				sw->hydred[k][i] = 0.;
 			}
 		}
 	}
+	SW_PROFILE_STOP(eProfHydRed);
 
 	#ifdef SWDEBUG
 	if (debug && SW_Model.year == debug_year && SW_Model.doy == debug_doy) {
 		swprintf("Flow (%d-%d): HR:", SW_Model.year, SW_Model.doy);
 		ForEachSoilLayer(i) {
-			swprintf(" swc[%i]=%1.3f", i, lyrSWCBulk[i]);
+			swprintf(" swc[%i]=%1.3f", i, sw->swcBulk[Today][i]);
 		}
 		swprintf("\n              : HR:");
 		ForEachSoilLayer(i) {
 			HRveg = 0.;
 			ForEachVegType(k) {
-				HRveg += lyrHydRed[k][i];
+				HRveg += sw->hydred[k][i];
 			}
 			swprintf(" HRveg[%d]=%1.3f", i, HRveg);
 		}
 		swprintf("\n");
 	}
 	#endif
+}
 
 
-	/* Calculate percolation for unsaturated soil water conditions. */
-	/* 01/06/2011	(drs) call to infiltrate_water_low() has to be the last swc
-		 affecting calculation */
+/** Surface water before the unsaturated percolation */
+static void percolation_begin(void) {
+	SW_Weather.soil_inf += standingWater[Today];
+}
 
-	w->soil_inf += standingWater[Today];
 
-	infiltrate_water_low(
-		lyrSWCBulk, lyrDrain, &drainout, SW_Site.n_layers,
-		SW_Site.slow_drain_coeff, SLOW_DRAIN_DEPTH, lyrSWCBulk_FieldCaps, lyrWidths,
-		lyrSWCBulk_Mins, lyrSWCBulk_Saturated, lyrImpermeability, &standingWater[Today]
-	);
+/** Surface water after the unsaturated percolation */
+static void percolation_end(void) {
+	SW_SOILWAT *sw = &SW_Soilwat;
+	SW_WEATHER *w = &SW_Weather;
+	#ifdef SWDEBUG
+	LyrIndex i;
+	#endif
 
 	// adjust soil_infiltration for water pushed back to surface
 	w->soil_inf -= standingWater[Today];
@@ -704,16 +1004,31 @@ void SW_Water_Flow(void) {
 	if (debug && SW_Model.year == debug_year && SW_Model.doy == debug_doy) {
 		swprintf("Flow (%d-%d): unsatperc:", SW_Model.year, SW_Model.doy);
 		ForEachSoilLayer(i) {
-			swprintf(" swc[%i]=%1.3f", i, lyrSWCBulk[i]);
+			swprintf(" swc[%i]=%1.3f", i, sw->swcBulk[Today][i]);
 		}
 		swprintf("\n              : satperc:");
 		ForEachSoilLayer(i) {
-			swprintf(" perc[%d]=%1.3f", i, lyrDrain[i]);
+			swprintf(" perc[%d]=%1.3f", i, sw->drain[i]);
 		}
 		swprintf("\n");
 	}
 	#endif
+}
+
 
+/** Water flow of today after the unsaturated percolation: soil temperature,
+    derived values, and the water balance monitor */
+static void flow_end(void) {
+	SW_VEGPROD *v = &SW_VegProd;
+	SW_SOILWAT *sw = &SW_Soilwat;
+	SW_WEATHER *w = &SW_Weather;
+	SW_FLOW_DAY *day = &SW_CurrentRun->Flow.day;
+
+	RealD x;
+	int doy, k;
+	LyrIndex i;
+
+	doy = SW_Model.doy; /* base1 */
 
 	/* Soil Temperature starts here */
 
@@ -729,111 +1044,230 @@ void SW_Water_Flow(void) {
 		}
 	}
 
-	// soil_temperature function computes the soil temp for each layer and stores it in lyrsTemp
+	// soil_temperature function computes the soil temp for each layer and stores it in sw->sTemp
 	// doesn't affect SWC at all (yet), but needs it for the calculation, so therefore the temperature is the last calculation done
 	if (SW_Site.use_soil_temp) {
-		soil_temperature(w->now.temp_avg[Today], sw->pet, sw->aet, x, lyrSWCBulk,
-			lyrSWCBulk_Saturated, lyrbDensity, lyrWidths, lyroldsTemp, lyrsTemp, surfaceTemp,
+		SW_BENCH_START(eBenchSoilTemp);
+		SW_PROFILE_START(eProfSoilTemp);
+		soil_temperature(w->now.temp_avg[Today], sw->pet, sw->aet, x, sw->swcBulk[Today],
+			SW_Site.swcBulk_saturated, SW_Site.soilBulk_density, SW_Site.width, sw->sTemp_yesterday, sw->sTemp, SW_CurrentRun->Flow.surfaceTemp,
 			SW_Site.n_layers, SW_Site.bmLimiter,
 			SW_Site.t1Param1, SW_Site.t1Param2, SW_Site.t1Param3, SW_Site.csParam1,
 			SW_Site.csParam2, SW_Site.shParam, sw->snowdepth, SW_Site.Tsoil_constant,
 			SW_Site.stDeltaX, SW_Site.stMaxDepth, SW_Site.stNRGR, sw->snowpack[Today],
-			&SW_Soilwat.soiltempError);
+			SW_Site.stMethod, &SW_Soilwat.soiltempError);
+		SW_PROFILE_STOP(eProfSoilTemp);
+		SW_BENCH_STOP(eBenchSoilTemp);
 	}
 
 	/* Soil Temperature ends here */
 
-	/* Move local values into main arrays */
-	arrays2records();
+	/* Move local values into main records */
+	SW_Soilwat.surfaceTemp = SW_CurrentRun->Flow.surfaceTemp[Today];
+	SW_Weather.surfaceTemp = SW_CurrentRun->Flow.surfaceTemp[Today];
+
+	if (SW_Site.deepdrain) {
+		SW_Soilwat.swcBulk[Today][SW_Site.deep_lyr] = drainout;
+	}
+
+	if (use_Derived[eSW_DerivedEvapSoil]) {
+		ForEachEvapLayer(i)
+		{
+			SW_Soilwat.evaporation[i] = lyrEvap_BareGround[i];
+			ForEachVegType(k)
+			{
+				SW_Soilwat.evaporation[i] += lyrEvap[k][i];
+			}
+		}
+	}
+
+	wb_monitor_day(day->swc_start, day->aet_surface);
 
 	standingWater[Yesterday] = standingWater[Today];
 
+	day->flowing = swFALSE;
+}
+
+
+void SW_Water_Flow(void) {
+	SW_SOILWAT *sw = &SW_Soilwat;
+
+	flow_surface();
+
+	/* Surface water and infiltration */
+	SW_PROFILE_START(eProfInfiltration);
+	infiltration_begin();
+	infiltrate_water_high(sw->swcBulk[Today], sw->drain, &drainout,
+		SW_CurrentRun->Flow.day.h2o_for_soil, SW_Site.n_layers,
+		SW_Site.swcBulk_fieldcap, SW_Site.swcBulk_saturated, SW_Site.impermeability, &standingWater[Today]);
+	infiltration_end();
+	SW_PROFILE_STOP(eProfInfiltration);
+	// end surface water and infiltration
+
+	flow_soil();
+
+	/* Calculate percolation for unsaturated soil water conditions. */
+	/* 01/06/2011	(drs) call to infiltrate_water_low() has to be the last swc
+		 affecting calculation */
+
+	SW_PROFILE_START(eProfPercolation);
+	percolation_begin();
+	infiltrate_water_low(
+		sw->swcBulk[Today], sw->drain, &drainout, SW_Site.n_layers,
+		SW_Site.slow_drain_coeff, SLOW_DRAIN_DEPTH, SW_Site.swcBulk_fieldcap, SW_Site.width,
+		SW_Site.swcBulk_min, SW_Site.swcBulk_saturated, SW_Site.impermeability, &standingWater[Today]
+	);
+	percolation_end();
+	SW_PROFILE_STOP(eProfPercolation);
+
+	flow_end();
+
 } /* END OF WATERFLOW */
 
-static void records2arrays(void) {
-	/* some values are unchanged by the water subs but
-	 * are still required in an array format.
-	 * Also, some arrays start out empty and are
-	 * filled during the water flow.
-	 * See arrays2records() for the modified arrays.
-	 *
-	 * 3/24/2003 - cwb - when running with steppe, the
-	 *       static variable firsttime would only be set once
-	 *       so the firsttime tasks were done only the first
-	 *       year, but what we really want with stepwat is
-	 *       to firsttime tasks on the first day of each year.
-	 * 1-Oct-03 (cwb) - Removed references to sum_transp_coeff.
-	 *       see also Site.c.
-	 */
-	LyrIndex i;
-	int k;
 
-	ForEachSoilLayer(i)
-	{
-		lyrSWCBulk[i] = SW_Soilwat.swcBulk[Today][i];
-		lyroldsTemp[i] = SW_Soilwat.sTemp[i];
+/**
+@brief Simulate one part of today's water flow of the active run
+
+The water flow of a day consists of the parts `0` (up to the
+infiltration), `1` (evaporation, transpiration, and hydraulic
+redistribution), and `2` (soil temperature and water balance). The
+saturated percolation of a day is calculated between parts `0` and `1`
+and the unsaturated percolation between parts `1` and `2` by
+`SW_FLW_percolate_lanes()`. Together, they produce the same values as
+`SW_Water_Flow()`.
+
+@param part Part of today's water flow, `0` to `SW_FLW_NPARTS - 1`.
+*/
+void SW_FLW_water_flow_part(unsigned int part) {
+
+	switch (part) {
+		case 0: {
+			flow_surface();
+			SW_PROFILE_START(eProfInfiltration);
+			infiltration_begin();
+			SW_PROFILE_STOP(eProfInfiltration);
+			break;
+		}
+
+		case 1: {
+			SW_PROFILE_START(eProfInfiltration);
+			infiltration_end();
+			SW_PROFILE_STOP(eProfInfiltration);
+			flow_soil();
+			SW_PROFILE_START(eProfPercolation);
+			percolation_begin();
+			SW_PROFILE_STOP(eProfPercolation);
+			break;
+		}
+
+		default: {
+			SW_PROFILE_START(eProfPercolation);
+			percolation_end();
+			SW_PROFILE_STOP(eProfPercolation);
+			flow_end();
+			break;
+		}
 	}
+}
 
-	if (SW_Model.doy == SW_Model.firstdoy) {
-		ForEachSoilLayer(i)
-		{
-			lyrSWCBulk_FieldCaps[i] = SW_Site.lyr[i]->swcBulk_fieldcap;
-			lyrWidths[i] = SW_Site.lyr[i]->width;
-			lyrSWCBulk_Wiltpts[i] = SW_Site.lyr[i]->swcBulk_wiltpt;
-			lyrSWCBulk_HalfWiltpts[i] = SW_Site.lyr[i]->swcBulk_wiltpt / 2.;
-			lyrSWCBulk_Mins[i] = SW_Site.lyr[i]->swcBulk_min;
-			lyrImpermeability[i] = SW_Site.lyr[i]->impermeability;
-			lyrSWCBulk_Saturated[i] = SW_Site.lyr[i]->swcBulk_saturated;
-			lyrbDensity[i] = SW_Site.lyr[i]->soilBulk_density;
 
-			ForEachVegType(k)
-			{
-				lyrTrRegions[k][i] = SW_Site.lyr[i]->my_transp_rgn[k];
-				lyrSWCBulk_atSWPcrit[k][i] = SW_Site.lyr[i]->swcBulk_atSWPcrit[k];
-				lyrTranspCo[k][i] = SW_Site.lyr[i]->transp_coeff[k];
+
+/**
+@brief Saturated or unsaturated percolation of today of several runs at
+  once with the lane kernels of `SW_Flow_lanes.c`
+
+The runs are gathered into lanes, `SW_LANES` runs at a time; surplus
+lanes repeat the first run of a block and their results are discarded.
+Runs that do not simulate water flow today (see `SW_FLOW_DAY`), e.g.,
+because their soil moisture is set to observations, are skipped.
+The results of each run are identical to those of the scalar
+percolation of `SW_Water_Flow()`.
+
+@param runs Simulation runs with the same number of soil layers,
+  each after part `step` of today's water flow (see
+  `SW_FLW_water_flow_part()`).
+@param n Number of runs.
+@param step `0`, saturated percolation (`infiltrate_water_high()`), or
+  `1`, unsaturated percolation (`infiltrate_water_low()`).
+*/
+void SW_FLW_percolate_lanes(SW_RUN *runs[], unsigned int n, unsigned int step) {
+	SW_RUN *active = SW_CurrentRun, *r[SW_LANES];
+	unsigned int i, k = 0, l, m, nlyrs;
+	unsigned long clamp_perc[SW_LANES], push_sat[SW_LANES];
+	double
+		swc[MAX_LAYERS][SW_LANES], drain[MAX_LAYERS][SW_LANES],
+		swcfc[MAX_LAYERS][SW_LANES], swcsat[MAX_LAYERS][SW_LANES],
+		swcmin[MAX_LAYERS][SW_LANES], width[MAX_LAYERS][SW_LANES],
+		impermeability[MAX_LAYERS][SW_LANES],
+		lane_drainout[SW_LANES], pptleft[SW_LANES], sdrainpar[SW_LANES],
+		lane_standingWater[SW_LANES];
+	Bool lyrFrozen[MAX_LAYERS][SW_LANES];
+
+	while (k < n) {
+		// next block of runs that simulate water flow today
+		for (m = 0; m < SW_LANES && k < n; k++) {
+			if (runs[k]->Flow.day.flowing) {
+				r[m++] = runs[k];
 			}
 		}
 
-		ForEachEvapLayer(i) {
-			lyrEvapCo[i] = SW_Site.lyr[i]->evap_coeff;
+		if (0 == m) {
+			break;
 		}
 
-	} /* end firsttime stuff */
+		nlyrs = r[0]->Site.n_layers;
 
-}
+		// the module variables of each run are accessed by activating it
+		ForEachLane(l) {
+			SW_CurrentRun = r[(l < m) ? l : 0];
 
-static void arrays2records(void) {
-	/* move output quantities from arrays to
-	 * the appropriate records.
-	 */
-	LyrIndex i;
-	int k;
+			if (SW_Site.n_layers != nlyrs) {
+				SW_CurrentRun = active;
+				LogError(logfp, LOGFATAL, "Water flow in lanes: runs have %u "
+					"and %u soil layers", nlyrs, r[l]->Site.n_layers);
+			}
 
-	ForEachSoilLayer(i)
-	{
-		SW_Soilwat.swcBulk[Today][i] = lyrSWCBulk[i];
-		SW_Soilwat.drain[i] = lyrDrain[i];
-		SW_Soilwat.sTemp[i] = lyrsTemp[i];
-		ForEachVegType(k)
-		{
-			SW_Soilwat.hydred[k][i] = lyrHydRed[k][i];
-			SW_Soilwat.transpiration[k][i] = lyrTransp[k][i];
+			for (i = 0; i < nlyrs; i++) {
+				swc[i][l] = SW_Soilwat.swcBulk[Today][i];
+				drain[i][l] = SW_Soilwat.drain[i];
+				swcfc[i][l] = SW_Site.swcBulk_fieldcap[i];
+				swcsat[i][l] = SW_Site.swcBulk_saturated[i];
+				swcmin[i][l] = SW_Site.swcBulk_min[i];
+				width[i][l] = SW_Site.width[i];
+				impermeability[i][l] = SW_Site.impermeability[i];
+				lyrFrozen[i][l] = stValues.lyrFrozen[i];
+			}
+
+			lane_drainout[l] = drainout;
+			pptleft[l] = SW_CurrentRun->Flow.day.h2o_for_soil;
+			sdrainpar[l] = SW_Site.slow_drain_coeff;
+			lane_standingWater[l] = standingWater[Today];
+			clamp_perc[l] = push_sat[l] = 0;
 		}
-	}
-	SW_Soilwat.surfaceTemp = surfaceTemp[Today];
-	SW_Weather.surfaceTemp = surfaceTemp[Today];
 
-	if (SW_Site.deepdrain)
-		SW_Soilwat.swcBulk[Today][SW_Site.deep_lyr] = drainout;
+		if (0 == step) {
+			infiltrate_water_high_lanes(swc, drain, lane_drainout, pptleft, nlyrs,
+				swcfc, swcsat, impermeability, lyrFrozen, lane_standingWater);
+		} else {
+			infiltrate_water_low_lanes(swc, drain, lane_drainout, nlyrs, sdrainpar,
+				SLOW_DRAIN_DEPTH, swcfc, width, swcmin, swcsat, impermeability,
+				lyrFrozen, lane_standingWater, clamp_perc, push_sat);
+		}
 
+		for (l = 0; l < m; l++) {
+			SW_CurrentRun = r[l];
 
-	ForEachEvapLayer(i)
-	{
-		SW_Soilwat.evaporation[i] = lyrEvap_BareGround[i];
-		ForEachVegType(k)
-		{
-			SW_Soilwat.evaporation[i] += lyrEvap[k][i];
+			for (i = 0; i < nlyrs; i++) {
+				SW_Soilwat.swcBulk[Today][i] = swc[i][l];
+				SW_Soilwat.drain[i] = drain[i][l];
+			}
+
+			drainout = lane_drainout[l];
+			standingWater[Today] = lane_standingWater[l];
+			SW_CurrentRun->Flow.diag.clamp_perc += clamp_perc[l];
+			SW_CurrentRun->Flow.diag.push_sat += push_sat[l];
 		}
 	}
 
+	SW_CurrentRun = active;
 }
@@ -2,12 +2,21 @@
 #define SW_FLOW_H
 
 
+#include "SW_Run.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/** Number of parts of the water flow of a day, see `SW_FLW_water_flow_part()` */
+#define SW_FLW_NPARTS 3
+
 void SW_FLW_init_run(void);
+void SW_FLW_new_year(void);
 void SW_Water_Flow(void);
+void SW_FLW_water_flow_part(unsigned int part);
+void SW_FLW_percolate_lanes(SW_RUN *runs[], unsigned int n, unsigned int step);
+void SW_FLW_log_diagnostics(void);
 
 
 #ifdef __cplusplus
@@ -0,0 +1,538 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Flow_lanes.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Multi-site lane versions of the daily water flow subroutines
+ *           of `SW_Flow_lib.c`.
+ *
+ *           A lane kernel performs the calculations of its scalar
+ *           counterpart for `SW_LANES` sites at once (see `SW_Flow_lanes.h`).
+ *           Each innermost loop runs over the lanes and is free of
+ *           branches and of calls to other functions (except for the
+ *           math library) so that compilers can map it onto SIMD registers:
+ *           a branch of the scalar kernel is replaced by calculating both
+ *           alternatives and a masked blend (`mask ? a : b`) of the results.
+ *           Branches that depend on the number of soil layers are shared
+ *           by all lanes and remain branches.
+ *
+ *           The results of each lane are identical to those of the
+ *           scalar kernel with the inputs of that lane. Unlike the scalar
+ *           kernels, lane kernels do not access a simulation run context:
+ *           soil water potential and frozen soil layers are inputs.
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ *     2026-10-15 added transp_weighted_avg_lanes() and EsT_partitioning_lanes()
+ *     2026-10-15 infiltrate_water_low_lanes() counts the clamped percolations
+ *       and the layers above saturation of each lane (see SW_FLOW_DIAG)
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <math.h>
+
+#include "generic.h"
+#include "SW_Defines.h"
+#include "SW_Flow_lanes.h"
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Copy the parameters of a `tanfunc()` into one lane
+
+@param tf Lane-shaped parameters.
+@param lane The lane to be set.
+@param x Parameters of the site of `lane`.
+*/
+void SW_LANES_set_tanfunc(SW_TANFUNC_LANES *tf, unsigned int lane,
+	tanfunc_t *x) {
+
+	tf->xinflec[lane] = x->xinflec;
+	tf->yinflec[lane] = x->yinflec;
+	tf->range[lane] = x->range;
+	tf->slope[lane] = x->slope;
+}
+
+
+/**
+@brief Calculate rain interception by vegetation canopies of `SW_LANES` sites,
+  see `veg_intercepted_water()`
+
+@param ppt_incident Amount of rain (cm) arriving at canopy per lane.
+@param int_veg Amount of rain intercepted by vegetation canopy (cm) per lane.
+@param s_veg Current canopy storage of intercepted water (cm) per lane.
+@param m Number of rain events per day per lane.
+@param kSmax Parameter (mm) to determine storage capacity based on LAI per lane.
+@param LAI Leaf-area index (m2 / m2) per lane.
+@param scale The compound fraction of vegetation type coverage and canopy
+  extent above snow pack per lane.
+*/
+void veg_intercepted_water_lanes(double ppt_incident[], double int_veg[],
+	double s_veg[], double m[], double kSmax[], double LAI[], double scale[]) {
+
+	unsigned int l;
+	int on;
+	double Dthreshold_cm, x;
+
+	ForEachLane(l) {
+		on = GT(LAI[l], 0.) & GT(ppt_incident[l], 0.);
+
+		Dthreshold_cm = m[l] * kSmax[l] * log10(1 + LAI[l]) / 10.;
+		x = scale[l] * fmin(ppt_incident[l],
+			fmax(0., Dthreshold_cm - s_veg[l] / scale[l]));
+		x = on ? x : 0.;
+
+		int_veg[l] = x;
+		s_veg[l] += x;
+		ppt_incident[l] -= x;
+	}
+}
+
+
+/**
+@brief Calculate rain interception by litter layer of `SW_LANES` sites,
+  see `litter_intercepted_water()`
+
+@param ppt_through Amount of rain (cm) arriving at litter layer per lane.
+@param int_lit Amount of rain intercepted by litter; added to previous
+  value (cm) per lane.
+@param s_lit Current litter storage of intercepted water (cm) per lane.
+@param m Number of rain events per day per lane.
+@param kSmax Parameter (mm) to determine storage capacity based on litter
+  biomass per lane.
+@param blitter Litter biomass density (g / m2) per lane.
+@param scale The compound fraction of vegetation type coverage and litter
+  above snow pack per lane.
+*/
+void litter_intercepted_water_lanes(double ppt_through[], double int_lit[],
+	double s_lit[], double m[], double kSmax[], double blitter[],
+	double scale[]) {
+
+	unsigned int l;
+	int on;
+	double Dthreshold_cm, x;
+
+	ForEachLane(l) {
+		on = GT(blitter[l], 0.) & GT(ppt_through[l], 0.);
+
+		Dthreshold_cm = m[l] * kSmax[l] * log10(1 + blitter[l]) / 10.;
+		x = scale[l] * fmin(ppt_through[l],
+			fmax(0., Dthreshold_cm - s_lit[l] / scale[l]));
+		x = on ? x : 0.;
+
+		int_lit[l] += x;
+		s_lit[l] += x;
+		ppt_through[l] -= x;
+	}
+}
+
+
+/**
+@brief Infiltrate water into soil layers under high water conditions
+  of `SW_LANES` sites, see `infiltrate_water_high()`
+
+@param swc Soilwater content in each layer and lane (cm H<SUB>2</SUB>O).
+@param drain Drainage amount in each layer and lane (cm/day).
+@param drainout Drainage from the lowest layer per lane (cm H<SUB>2</SUB>O).
+@param pptleft Daily precipitation available to the soil per lane (cm/day).
+@param nlyrs Number of layers available to drain from (of each lane).
+@param swcfc Soilwater content at field capacity in each layer and lane.
+@param swcsat Soilwater content at saturation in each layer and lane.
+@param impermeability Impermeability measures for each layer and lane.
+@param lyrFrozen Frozen state of each layer and lane.
+@param standingWater Remaining water on the surface per lane.
+*/
+void infiltrate_water_high_lanes(double swc[][SW_LANES],
+	double drain[][SW_LANES], double drainout[], double pptleft[],
+	unsigned int nlyrs, double swcfc[][SW_LANES], double swcsat[][SW_LANES],
+	double impermeability[][SW_LANES], Bool lyrFrozen[][SW_LANES],
+	double standingWater[]) {
+
+	unsigned int i, l;
+	int j;
+	double d, push, ksat_rel;
+
+	// Infiltration
+	ForEachLane(l) {
+		swc[0][l] += pptleft[l] + standingWater[l];
+		standingWater[l] = 0.;
+	}
+
+	// Saturated percolation
+	for (i = 0; i < nlyrs; i++) {
+		ForEachLane(l) {
+			ksat_rel = lyrFrozen[i][l] ? 0.01 : 1.;
+
+			d = fmax(0., ksat_rel * (1. - impermeability[i][l]) *
+				(swc[i][l] - swcfc[i][l]));
+			drain[i][l] = d;
+			swc[i][l] -= d;
+
+			if (i < nlyrs - 1) {
+				swc[i + 1][l] += d;
+			} else {
+				drainout[l] = d;
+			}
+		}
+	}
+
+	// push water upwards if water content of a layer is now above saturation
+	for (j = (int) nlyrs - 1; j >= 0; j--) {
+		ForEachLane(l) {
+			push = GT(swc[j][l], swcsat[j][l]) ? swc[j][l] - swcsat[j][l] : 0.;
+			swc[j][l] -= push;
+
+			if (j > 0) {
+				drain[j - 1][l] -= push;
+				swc[j - 1][l] += push;
+			} else {
+				standingWater[l] = push;
+			}
+		}
+	}
+}
+
+
+/**
+@brief Calculate the evaporation or transpiration rate of `SW_LANES` sites,
+  see `watrate()`
+
+@param rate Resulting rate relative to potential evapotranspiration per lane.
+@param swp Soil water potential (-bar) per lane.
+@param petday Potential evapotranspiration rate (cm/day) per lane.
+@param tf Parameters (shift, shape, inflec, range) of `watrate()` per lane.
+*/
+void watrate_lanes(double rate[], double swp[], double petday[],
+	SW_TANFUNC_LANES *tf) {
+
+	unsigned int l;
+	double par1, result;
+
+	ForEachLane(l) {
+		par1 = LT(petday[l], .2) ? 3.0 :
+			LT(petday[l], .4) ? (.4 - petday[l]) * -10. + 5. :
+			LT(petday[l], .6) ? (.6 - petday[l]) * -15. + 8. : 8.;
+
+		result = tanfunc(tf->xinflec[l] - swp[l], par1, tf->yinflec[l],
+			tf->range[l], tf->slope[l]);
+
+		rate[l] = fmin(fmax(result, 0.0), 1.0);
+	}
+}
+
+
+/**
+@brief Calculate the weighted average of soil water potential of
+  transpiration regions of `SW_LANES` sites, see `transp_weighted_avg()`
+
+@param swp_avg Smallest weighted average of soil water potential of the
+  transpiration regions (-bar) per lane.
+@param n_tr_rgns Number of transpiration regions.
+@param nlyrs Number of soil layers to consider.
+@param tr_regions Transpiration region of each layer and lane;
+  0 for layers without transpiration, e.g., below the transpiration layers
+  of a lane.
+@param tr_coeff Transpiration coefficients of each layer and lane.
+@param swp Soil water potential of each layer and lane (-bar), e.g.,
+  see `SW_SWCbulk2SWPmatric_profile()`.
+*/
+void transp_weighted_avg_lanes(double swp_avg[], unsigned int n_tr_rgns,
+	unsigned int nlyrs, unsigned int tr_regions[][SW_LANES],
+	double tr_coeff[][SW_LANES], double swp[][SW_LANES]) {
+
+	unsigned int r, i, l;
+	int on;
+	double x[SW_LANES], sumco[SW_LANES];
+
+	for (r = 1; r <= n_tr_rgns; r++) {
+		ForEachLane(l) {
+			x[l] = sumco[l] = 0.;
+		}
+
+		for (i = 0; i < nlyrs; i++) {
+			ForEachLane(l) {
+				on = tr_regions[i][l] == r;
+
+				x[l] += on ? tr_coeff[i][l] * swp[i][l] : 0.;
+				sumco[l] += on ? tr_coeff[i][l] : 0.;
+			}
+		}
+
+		ForEachLane(l) {
+			x[l] /= GT(sumco[l], 0.) ? sumco[l] : 1.;
+
+			/* use smallest weighted average of regions */
+			swp_avg[l] = (r == 1) ? x[l] : fmin(x[l], swp_avg[l]);
+		}
+	}
+}
+
+
+/**
+@brief Calculate the fractions of water loss from bare soil evaporation
+  and from transpiration of `SW_LANES` sites, see `EsT_partitioning()`
+
+@param fbse Fraction of water loss from bare soil evaporation per lane.
+@param fbst Fraction of water loss from transpiration per lane.
+@param blivelai Live biomass leaf area index per lane.
+@param lai_param Leaf area index parameter per lane.
+*/
+void EsT_partitioning_lanes(double fbse[], double fbst[], double blivelai[],
+	double lai_param[]) {
+
+	unsigned int l;
+
+	ForEachLane(l) {
+		fbse[l] = fmin(exp(-lai_param[l] * blivelai[l]), 0.995);
+		fbst[l] = 1. - fbse[l];
+	}
+}
+
+
+/**
+@brief Calculate potential bare soil evaporation rate of `SW_LANES` sites,
+  see `pot_soil_evap()`
+
+@param bserate Bare soil evaporation loss rate (cm/day) per lane.
+@param nelyrs Number of layers to consider in evaporation.
+@param ecoeff Evaporation coefficients of each layer and lane.
+@param totagb Sum of above ground biomass and litter per lane.
+@param fbse Fraction of water loss from bare soil evaporation per lane.
+@param petday Potential evapotranspiration rate (cm/day) per lane.
+@param evap Parameters of `watrate()` per lane.
+@param width Width of each layer and lane (cm).
+@param swp Soil water potential of each layer and lane (-bar), e.g.,
+  see `SW_SWCbulk2SWPmatric_profile()`.
+@param Es_param_limit Parameter to determine when soil surface is completely
+  covered with litter per lane.
+*/
+void pot_soil_evap_lanes(double bserate[], unsigned int nelyrs,
+	double ecoeff[][SW_LANES], double totagb[], double fbse[], double petday[],
+	SW_TANFUNC_LANES *evap, double width[][SW_LANES], double swp[][SW_LANES],
+	double Es_param_limit[]) {
+
+	unsigned int i, l;
+	int on[SW_LANES], off;
+	double x, avswp[SW_LANES], sumwidth[SW_LANES], rate[SW_LANES];
+
+	ForEachLane(l) {
+		on[l] = 1;
+		avswp[l] = sumwidth[l] = 0.;
+	}
+
+	/* weighted average of swp in the evap layers up to the first layer
+	   without evaporation */
+	for (i = 0; i < nelyrs; i++) {
+		ForEachLane(l) {
+			on[l] &= !ZRO(ecoeff[i][l]);
+
+			x = width[i][l] * ecoeff[i][l];
+			sumwidth[l] += on[l] ? x : 0.;
+			avswp[l] += on[l] ? x * swp[i][l] : 0.;
+		}
+	}
+
+	ForEachLane(l) {
+		avswp[l] /= ZRO(sumwidth[l]) ? 1 : sumwidth[l];
+	}
+
+	watrate_lanes(rate, avswp, petday, evap);
+
+	ForEachLane(l) {
+		off = GE(totagb[l], Es_param_limit[l]) | ZRO(avswp[l]);
+
+		x = petday[l] * rate[l] * (1. - (totagb[l] / Es_param_limit[l])) * fbse[l];
+		bserate[l] = off ? 0. : x;
+	}
+}
+
+
+/**
+@brief Calculate the potential transpiration rate of `SW_LANES` sites,
+  see `pot_transp()`
+
+@param bstrate Potential transpiration rate (cm/day) per lane.
+@param swpavg Weighted average of soil water potential (-bar) per lane.
+@param biolive Living biomass per lane.
+@param biodead Dead biomass per lane.
+@param fbst Fraction of water loss from transpiration per lane.
+@param petday Potential evapotranspiration rate (cm/day) per lane.
+@param transp Parameters of `watrate()` per lane.
+@param shade_scale Scale for shade effect per lane.
+@param shade_deadmax Maximum biomass of dead, before shade has any effect,
+  per lane.
+@param shade Parameters of the shade effect per lane.
+@param co2_wue_multiplier Water-usage efficiency multiplier per lane.
+*/
+void pot_transp_lanes(double bstrate[], double swpavg[], double biolive[],
+	double biodead[], double fbst[], double petday[], SW_TANFUNC_LANES *transp,
+	double shade_scale[], double shade_deadmax[], SW_TANFUNC_LANES *shade,
+	double co2_wue_multiplier[]) {
+
+	unsigned int l;
+	double par1, par2, shadeaf, x, rate[SW_LANES];
+
+	watrate_lanes(rate, swpavg, petday, transp);
+
+	ForEachLane(l) {
+		par1 = tanfunc(biolive[l], shade->xinflec[l], shade->yinflec[l],
+			shade->range[l], shade->slope[l]);
+		par2 = tanfunc(biodead[l], shade->xinflec[l], shade->yinflec[l],
+			shade->range[l], shade->slope[l]);
+		shadeaf = fmin((par1 / par2) * (1.0 - shade_scale[l]) + shade_scale[l], 1.0);
+		shadeaf = GE(biodead[l], shade_deadmax[l]) ? shadeaf : 1.0;
+
+		x = rate[l] * shadeaf * petday[l] * fbst[l] * co2_wue_multiplier[l];
+		bstrate[l] = LE(biolive[l], 0.) ? 0. : x;
+	}
+}
+
+
+/**
+@brief Remove water from the soil of `SW_LANES` sites,
+  see `remove_from_soil()`
+
+@param swc Soilwater content of each layer and lane (cm H<SUB>2</SUB>O).
+@param qty Removal quantity from each layer and lane (cm/day);
+  unchanged in lanes without removal coefficients.
+@param aet Actual evapotranspiration (cm/day) per lane.
+@param nlyrs Number of layers considered in water removal.
+@param coeff Coefficients of removal of each layer and lane.
+@param rate Removal rate per lane.
+@param swcmin Lower limit on soilwater content of each layer and lane.
+@param swp Soil water potential of each layer and lane (-bar), e.g.,
+  see `SW_SWCbulk2SWPmatric_profile()`.
+@param lyrFrozen Frozen state of each layer and lane.
+*/
+void remove_from_soil_lanes(double swc[][SW_LANES], double qty[][SW_LANES],
+	double aet[], unsigned int nlyrs, double coeff[][SW_LANES], double rate[],
+	double swcmin[][SW_LANES], double swp[][SW_LANES],
+	Bool lyrFrozen[][SW_LANES]) {
+
+	unsigned int i, l;
+	int on;
+	double swpfrac[MAX_LAYERS][SW_LANES], sumswp[SW_LANES], q, swc_avail;
+
+	ForEachLane(l) {
+		sumswp[l] = 0.;
+	}
+
+	for (i = 0; i < nlyrs; i++) {
+		ForEachLane(l) {
+			swpfrac[i][l] = coeff[i][l] / swp[i][l];
+			sumswp[l] += swpfrac[i][l];
+		}
+	}
+
+	for (i = 0; i < nlyrs; i++) {
+		ForEachLane(l) {
+			// no water extraction from a frozen soil layer
+			q = (swpfrac[i][l] / sumswp[l]) * rate[l];
+			swc_avail = fmax(0., swc[i][l] - swcmin[i][l]);
+			q = lyrFrozen[i][l] ? 0. : fmin(q, swc_avail);
+
+			on = !ZRO(sumswp[l]);
+			qty[i][l] = on ? q : qty[i][l];
+			q = on ? q : 0.;
+
+			swc[i][l] -= q;
+			aet[l] += q;
+		}
+	}
+}
+
+
+/**
+@brief Calculate soilwater drainage for low soil water conditions
+  of `SW_LANES` sites, see `infiltrate_water_low()`
+
+@param swc Soilwater content of each layer and lane (cm H<SUB>2</SUB>O).
+@param drain Drainage from each layer and lane (cm/day).
+@param drainout Drainage from the lowest layer per lane (cm H<SUB>2</SUB>O).
+@param nlyrs Number of layers in the soil profile (of each lane).
+@param sdrainpar Slow drainage parameter per lane.
+@param sdraindpth Slow drainage depth (cm).
+@param swcfc Soilwater content at field capacity of each layer and lane.
+@param width The width of each layer and lane (cm).
+@param swcmin Lower limit on soilwater content of each layer and lane.
+@param swcsat Soilwater content at saturation of each layer and lane.
+@param impermeability Impermeability measures of each layer and lane.
+@param lyrFrozen Frozen state of each layer and lane.
+@param standingWater Remaining water on the surface per lane.
+@param clamp_perc Incremented per lane by the number of layers whose
+  percolation was limited by the available water (`NULL`: not counted).
+@param push_sat Incremented per lane by the number of layers that were
+  above saturation (`NULL`: not counted).
+*/
+void infiltrate_water_low_lanes(double swc[][SW_LANES],
+	double drain[][SW_LANES], double drainout[], unsigned int nlyrs,
+	double sdrainpar[], double sdraindpth, double swcfc[][SW_LANES],
+	double width[][SW_LANES], double swcmin[][SW_LANES],
+	double swcsat[][SW_LANES], double impermeability[][SW_LANES],
+	Bool lyrFrozen[][SW_LANES], double standingWater[],
+	unsigned long clamp_perc[], unsigned long push_sat[]) {
+
+	unsigned int i, l, n_clamp[SW_LANES] = {0}, n_push[SW_LANES] = {0};
+	int j;
+	double d, swc_avail, drainpot, kunsat_rel, push;
+
+	// Unsaturated percolation
+	for (i = 0; i < nlyrs; i++) {
+		ForEachLane(l) {
+			kunsat_rel = lyrFrozen[i][l] ? 0.01 : 1.;
+			swc_avail = fmax(0., swc[i][l] - swcmin[i][l]);
+			drainpot = GT(swc[i][l], swcfc[i][l]) ? sdrainpar[l] :
+				sdrainpar[l] * exp((swc[i][l] - swcfc[i][l]) * sdraindpth / width[i][l]);
+
+			d = kunsat_rel * (1. - impermeability[i][l]) * fmin(swc_avail, drainpot);
+			n_clamp[l] += (drainpot > swc_avail && !LE(swc[i][l], swcmin[i][l])) ? 1 : 0;
+			d = LE(swc[i][l], swcmin[i][l]) ? 0. : d;
+			drain[i][l] += d;
+
+			if (i < nlyrs - 1) {
+				swc[i + 1][l] += d;
+				swc[i][l] -= d;
+			} else {
+				d = fmax(d, 0.0);
+				drainout[l] += d;
+				swc[i][l] -= d;
+			}
+		}
+	}
+
+	// push water upwards if water content of a layer is now above saturation
+	for (j = (int) nlyrs - 1; j >= 0; j--) {
+		ForEachLane(l) {
+			n_push[l] += GT(swc[j][l], swcsat[j][l]) ? 1 : 0;
+			push = GT(swc[j][l], swcsat[j][l]) ? swc[j][l] - swcsat[j][l] : 0.;
+			swc[j][l] -= push;
+
+			if (j > 0) {
+				drain[j - 1][l] -= push;
+				swc[j - 1][l] += push;
+			} else {
+				standingWater[l] += push;
+			}
+		}
+	}
+
+	if (!isnull(clamp_perc)) {
+		ForEachLane(l) {
+			clamp_perc[l] += n_clamp[l];
+		}
+	}
+
+	if (!isnull(push_sat)) {
+		ForEachLane(l) {
+			push_sat[l] += n_push[l];
+		}
+	}
+}
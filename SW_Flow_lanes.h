@@ -0,0 +1,123 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Flow_lanes.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for the multi-site lane
+ *           versions of the daily water flow subroutines of
+ *           `SW_Flow_lanes.c`.
+ *
+ *           Each lane kernel simulates `SW_LANES` sites at once that share
+ *           the number of soil layers (and the calendar). Lane-shaped values
+ *           are arrays `x[SW_LANES]` that hold one value per site; lane-shaped
+ *           layer values are arrays `x[MAX_LAYERS][SW_LANES]` so that the
+ *           values of all sites of a layer are contiguous.
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ *     2026-10-15 added transp_weighted_avg_lanes() and EsT_partitioning_lanes();
+ *       lanes may also hold the vegetation types of one site (see SW_Flow.c)
+ *     2026-10-15 lane kernels are also compiled for OpenMP offload devices
+ *       (see SW_Flow_offload.c)
+ *     2026-10-15 infiltrate_water_low_lanes() counts clamped percolations
+ *       and layers above saturation per lane
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_FLOW_LANES_H
+#define SW_FLOW_LANES_H
+
+#include "generic.h"
+#include "SW_Defines.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+/** Number of sites that are simulated together by a lane kernel;
+    4 (or 8) doubles fill one AVX2 (or AVX-512) register */
+#ifndef SW_LANES
+#define SW_LANES 4
+#endif
+
+#define ForEachLane(l) for ((l) = 0; (l) < SW_LANES; (l)++)
+
+/** Lane-shaped parameters of a `tanfunc()`, see `tanfunc_t` */
+typedef struct {
+	double xinflec[SW_LANES], yinflec[SW_LANES], range[SW_LANES],
+		slope[SW_LANES];
+} SW_TANFUNC_LANES;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+#ifdef _OPENMP
+#pragma omp declare target
+#endif
+
+void SW_LANES_set_tanfunc(SW_TANFUNC_LANES *tf, unsigned int lane,
+	tanfunc_t *x);
+
+void veg_intercepted_water_lanes(double ppt_incident[], double int_veg[],
+	double s_veg[], double m[], double kSmax[], double LAI[], double scale[]);
+
+void litter_intercepted_water_lanes(double ppt_through[], double int_lit[],
+	double s_lit[], double m[], double kSmax[], double blitter[],
+	double scale[]);
+
+void infiltrate_water_high_lanes(double swc[][SW_LANES],
+	double drain[][SW_LANES], double drainout[], double pptleft[],
+	unsigned int nlyrs, double swcfc[][SW_LANES], double swcsat[][SW_LANES],
+	double impermeability[][SW_LANES], Bool lyrFrozen[][SW_LANES],
+	double standingWater[]);
+
+void watrate_lanes(double rate[], double swp[], double petday[],
+	SW_TANFUNC_LANES *tf);
+
+void transp_weighted_avg_lanes(double swp_avg[], unsigned int n_tr_rgns,
+	unsigned int nlyrs, unsigned int tr_regions[][SW_LANES],
+	double tr_coeff[][SW_LANES], double swp[][SW_LANES]);
+
+void EsT_partitioning_lanes(double fbse[], double fbst[], double blivelai[],
+	double lai_param[]);
+
+void pot_soil_evap_lanes(double bserate[], unsigned int nelyrs,
+	double ecoeff[][SW_LANES], double totagb[], double fbse[], double petday[],
+	SW_TANFUNC_LANES *evap, double width[][SW_LANES], double swp[][SW_LANES],
+	double Es_param_limit[]);
+
+void pot_transp_lanes(double bstrate[], double swpavg[], double biolive[],
+	double biodead[], double fbst[], double petday[], SW_TANFUNC_LANES *transp,
+	double shade_scale[], double shade_deadmax[], SW_TANFUNC_LANES *shade,
+	double co2_wue_multiplier[]);
+
+void remove_from_soil_lanes(double swc[][SW_LANES], double qty[][SW_LANES],
+	double aet[], unsigned int nlyrs, double coeff[][SW_LANES], double rate[],
+	double swcmin[][SW_LANES], double swp[][SW_LANES],
+	Bool lyrFrozen[][SW_LANES]);
+
+void infiltrate_water_low_lanes(double swc[][SW_LANES],
+	double drain[][SW_LANES], double drainout[], unsigned int nlyrs,
+	double sdrainpar[], double sdraindpth, double swcfc[][SW_LANES],
+	double width[][SW_LANES], double swcmin[][SW_LANES],
+	double swcsat[][SW_LANES], double impermeability[][SW_LANES],
+	Bool lyrFrozen[][SW_LANES], double standingWater[],
+	unsigned long clamp_perc[], unsigned long push_sat[]);
+
+#ifdef _OPENMP
+#pragma omp end declare target
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
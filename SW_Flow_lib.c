@@ -79,6 +79,19 @@
 02/08/2016 (CMA & CTD) In the function surface_temperature_under_snow(), used Parton's Eq. 5 & 6 from 1998 paper instead of koren paper
 								 Adjusted function calls to surface_temperature_under_snow to account for the new parameters
 03/01/2016 (CTD) Added error check for Rsoilwat called tempError()
+2026-10-14	added soil_temperature_today_CN(), an unconditionally stable Crank-Nicolson
+						solver of the soil temperature profile; soil_temperature() selects the solver
+2026-10-14	soil_temperature_setup() calculates the interpolation weights between soil layers
+						and soil temperature layers once per run as sparse matrices (ST_SPARSE_MATRIX);
+						soil_temperature() applies them instead of re-deriving the interpolations daily
+2026-10-15	count time step halvings and sub-steps of soil_temperature_today(), solver
+						failures, freezing/thawing adjustments, and water-limited removals and
+						percolation (SW_FLOW_DIAG)
+2026-10-15	hydraulic_redistribution() considers only pairs of layers with roots
+						that are not frozen (other pairs have no flux)
+2026-10-15	soil_temperature_setup() holds the correspondance between soil layers and
+						soil temperature layers only while it derives the interpolation weights,
+						sized by the number of soil temperature layers
 */
 /********************************************************/
 /********************************************************/
@@ -93,6 +106,7 @@
 #include <string.h>
 #include "generic.h"
 #include "filefuncs.h"
+#include "myMemory.h"
 #include "SW_Defines.h"
 #include "SW_Flow_lib.h"
 #include "SW_SoilWater.h"
@@ -101,27 +115,23 @@
 
 
 #include "SW_Model.h"
-extern SW_MODEL SW_Model;
+#include "SW_Run.h"
+
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
 
-ST_RGR_VALUES stValues; //keeps track of soil_temperature values
-
-extern SW_SITE SW_Site;
-extern SW_SOILWAT SW_Soilwat;
-extern SW_CARBON SW_Carbon;
-unsigned int soil_temp_init;   // simply keeps track of whether or not the values for the soil_temperature function have been initialized.  0 for no, 1 for yes.
-unsigned int fusion_pool_init;   // simply keeps track of whether or not the values for the soil fusion (thawing/freezing) section of the soil_temperature function have been initialized.  0 for no, 1 for yes.
+// `stValues`, `soil_temp_init`, and `fusion_pool_init` are part of the
+// simulation run context, see `SW_ST_STATE` in SW_Run.h
 
 /* *************************************************** */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
 
-Bool do_once_at_soiltempError;
-// last successful time step in seconds; start out with 1 day
-double delta_time;
+// `do_once_at_soiltempError` and `delta_time` (last successful time step in
+// seconds; start out with 1 day) are part of the simulation run context,
+// see `SW_ST_STATE` in SW_Run.h
 
 
 /* *************************************************** */
@@ -129,6 +139,50 @@ double delta_time;
 /*              Local Function Definitions             */
 /* --------------------------------------------------- */
 
+/** Start an empty sparse matrix with `n_cols` columns */
+static void st_sparse_start(ST_SPARSE_MATRIX *w, unsigned int n_cols) {
+	w->n_rows = 0;
+	w->n_cols = n_cols;
+	w->n_nz = 0;
+	w->row_start[0] = 0;
+}
+
+/** Add weight `val` of column `col` to the current row of a sparse matrix;
+    weights of the same column as the previous weight of the row are summed */
+static void st_sparse_add(ST_SPARSE_MATRIX *w, unsigned int col, double val) {
+	if (EQ(val, 0.)) {
+		return;
+	}
+
+	if (w->n_nz > w->row_start[w->n_rows] && w->col[w->n_nz - 1] == col) {
+		w->val[w->n_nz - 1] += val;
+		return;
+	}
+
+	if (w->n_nz >= MAX_ST_NNZ) {
+		LogError(logfp, LOGFATAL, "SOIL_TEMP FUNCTION ERROR: "
+			"too many (n > %d) interpolation weights between soil layers and "
+			"soil temperature layers\n", MAX_ST_NNZ);
+	}
+
+	w->col[w->n_nz] = col;
+	w->val[w->n_nz] = val;
+	w->n_nz++;
+}
+
+/** Finish the current row of a sparse matrix and multiply its weights by `scale` */
+static void st_sparse_end_row(ST_SPARSE_MATRIX *w, double scale) {
+	unsigned int k;
+
+	for (k = w->row_start[w->n_rows]; k < w->n_nz; k++) {
+		w->val[k] *= scale;
+	}
+
+	w->n_rows++;
+	w->row_start[w->n_rows] = w->n_nz;
+}
+
+
 
 
 /**********************************************************************
@@ -367,6 +421,7 @@ void transp_weighted_avg(double *swp_avg, unsigned int n_tr_rgns, unsigned int n
 	 **********************************************************************/
 	unsigned int r, i;
 	double swp, sumco;
+	const double *swp_lyr = SW_SWCbulk2SWPmatric_cached(swc, n_layers);
 
 	*swp_avg = 0;
 	for (r = 1; r <= n_tr_rgns; r++) {
@@ -374,7 +429,7 @@ void transp_weighted_avg(double *swp_avg, unsigned int n_tr_rgns, unsigned int n
 
 		for (i = 0; i < n_layers; i++) {
 			if (tr_regions[i] == r) {
-				swp += tr_coeff[i] * SW_SWCbulk2SWPmatric(SW_Site.lyr[i]->fractionVolBulk_gravel, swc[i], i);
+				swp += tr_coeff[i] * swp_lyr[i];
 				sumco += tr_coeff[i];
 			}
 		}
@@ -478,15 +533,18 @@ void pot_soil_evap(double *bserate, unsigned int nelyrs, double ecoeff[], double
 
 	double x, avswp = 0.0, sumwidth = 0.0;
 	unsigned int i;
+	const double *swp;
+
+	/* number of evap layers up to the first layer without evaporation */
+	for (i = 0; i < nelyrs && !ZRO(ecoeff[i]); i++) {}
+	nelyrs = i;
+	swp = SW_SWCbulk2SWPmatric_cached(swc, nelyrs);
 
 	/* get the weighted average of swp in the evap layers */
 	for (i = 0; i < nelyrs; i++) {
-	  if (ZRO(ecoeff[i])) {
-	    break;
-	  }
 		x = width[i] * ecoeff[i];
 		sumwidth += x;
-		avswp += x * SW_SWCbulk2SWPmatric(SW_Site.lyr[i]->fractionVolBulk_gravel, swc[i], i);
+		avswp += x * swp[i];
 	}
 
   // Note: avswp = 0 if swc = 0 because that is the return value of SW_SWCbulk2SWPmatric
@@ -541,12 +599,13 @@ void pot_soil_evap_bs(double *bserate, unsigned int nelyrs, double ecoeff[], dou
 
 	double x, avswp = 0.0, sumwidth = 0.0;
 	unsigned int i;
+	const double *swp = SW_SWCbulk2SWPmatric_cached(swc, nelyrs);
 
 	/* get the weighted average of swp in the evap layers */
 	for (i = 0; i < nelyrs; i++) {
 		x = width[i] * ecoeff[i];
 		sumwidth += x;
-		avswp += x * SW_SWCbulk2SWPmatric(SW_Site.lyr[i]->fractionVolBulk_gravel, swc[i], i);
+		avswp += x * swp[i];
 	}
 
 	avswp /= sumwidth;
@@ -747,11 +806,12 @@ void remove_from_soil(double swc[], double qty[], double *aet, unsigned int nlyr
 
 	unsigned int i;
 	double swpfrac[MAX_LAYERS], sumswp = 0.0, swc_avail, q;
+	const double *swp = SW_SWCbulk2SWPmatric_cached(swc, nlyrs);
 
 	ST_RGR_VALUES *st = &stValues;
 
 	for (i = 0; i < nlyrs; i++) {
-		swpfrac[i] = coeff[i] / SW_SWCbulk2SWPmatric(SW_Site.lyr[i]->fractionVolBulk_gravel, swc[i], i);
+		swpfrac[i] = coeff[i] / swp[i];
 		sumswp += swpfrac[i];
 	}
 
@@ -766,6 +826,9 @@ void remove_from_soil(double swc[], double qty[], double *aet, unsigned int nlyr
 		} else {
 			q = (swpfrac[i] / sumswp) * rate;
 			swc_avail = fmax(0., swc[i] - swcmin[i]);
+			if (q > swc_avail) {
+				SW_CurrentRun->Flow.diag.clamp_remove++;
+			}
 			qty[i] = fmin( q, swc_avail);
 			swc[i] -= qty[i];
 			*aet += qty[i];
@@ -839,6 +902,9 @@ void infiltrate_water_low(double swc[], double drain[], double *drainout, unsign
 			}
 			swc_avail = fmax(0., swc[i] - swcmin[i]);
 			drainpot = GT(swc[i], swcfc[i]) ? sdrainpar : sdrainpar * exp((swc[i] - swcfc[i]) * sdraindpth / width[i]);
+			if (drainpot > swc_avail) {
+				SW_CurrentRun->Flow.diag.clamp_perc++;
+			}
 			d[i] = kunsat_rel * (1. - impermeability[i]) * fmin(swc_avail, drainpot);
     }
 		drain[i] += d[i];
@@ -856,6 +922,7 @@ void infiltrate_water_low(double swc[], double drain[], double *drainout, unsign
 	/* adjust (i.e., push water upwards) if water content of a layer is now above saturated water content */
 	for (j = nlyrs - 1; j >= 0; j--) {
 		if (GT(swc[j], swcsat[j])) {
+			SW_CurrentRun->Flow.diag.push_sat++;
 			push = swc[j] - swcsat[j];
 			swc[j] -= push;
 			if (j > 0) {
@@ -899,31 +966,45 @@ void hydraulic_redistribution(double swc[], double swcwp[], double lyrRootCo[],
 	 10/19/2010 (drs)
 	 11/13/2010 (drs) limited water extraction for hydred to swp above wilting point
 	 03/23/2012 (drs) excluded hydraulic redistribution from top soil layer (assuming that this layer is <= 5 cm deep)
+	 2026-10-15 pairs of layers are restricted to layers with roots that are not frozen
 	 **********************************************************************/
 
-	unsigned int i, j;
-	double swp[MAX_LAYERS] = {0}, swpwp[MAX_LAYERS] = {0}, relCondroot[MAX_LAYERS] = {0}, hydredmat[MAX_LAYERS][MAX_LAYERS] = {{0}};
-  double Rx, swa, hydred_sum, x;
+	unsigned int i, j, a, b, n = 0, lyr[MAX_LAYERS];
+	double swp[MAX_LAYERS], swpwp[MAX_LAYERS], relCondroot[MAX_LAYERS],
+		hydredmat[MAX_LAYERS][MAX_LAYERS];
+	double Rx, swa, hydred_sum, x;
+	Bool above_wp[MAX_LAYERS];
 
 	ST_RGR_VALUES *st = &stValues;
 
-	for (i = 0; i < nlyrs; i++) {
-		swp[i] = SW_SWCbulk2SWPmatric(SW_Site.lyr[i]->fractionVolBulk_gravel, swc[i], i);
-		relCondroot[i] = fmin( 1., fmax(0., 1./(1. + powe(swp[i]/swp50, shapeCond) ) ) );
-		swpwp[i] = SW_SWCbulk2SWPmatric(SW_Site.lyr[i]->fractionVolBulk_gravel, swcwp[i], i);
+	memcpy(swp, SW_SWCbulk2SWPmatric_cached(swc, nlyrs), nlyrs * sizeof(double));
+	SW_SWCbulk2SWPmatric_profile(swcwp, swpwp, nlyrs);
 
-		hydredmat[0][i] = hydredmat[i][0] = 0.; /* no hydred in top layer */
+	/* Only layers with roots that are not frozen exchange water (the flux
+	   between two layers is proportional to the product of their roots);
+	   no hydred in top layer. The fluxes between the `n` participating
+	   layers `lyr[]` are stored in the first `n` rows and columns of
+	   `hydredmat` in the order of the layers, i.e., sums run over
+	   the same non-zero terms in the same order as over all layers. */
+	for (i = 1; i < nlyrs; i++) {
+		if (lyrRootCo[i] > 0. && st->lyrFrozen[i] == swFALSE) {
+			lyr[n] = i;
+			relCondroot[n] = fmin( 1., fmax(0., 1./(1. + powe(swp[i]/swp50, shapeCond) ) ) );
+			// swp is a positive suction: less than at wilting point is wetter
+			above_wp[n] = itob(LT(swp[i], swpwp[i]));
+			n++;
+		}
 	}
 
-	for (i = 1; i < nlyrs; i++) {
-		hydredmat[i][i] = 0.; /* init */
+	for (a = 0; a < n; a++) {
+		i = lyr[a];
+		hydredmat[a][a] = 0.;
 
-		for (j = i + 1; j < nlyrs; j++) {
+		for (b = a + 1; b < n; b++) {
+			j = lyr[b];
 
-			if ((LT(swp[i], swpwp[i]) || LT(swp[j], swpwp[j])) &&
-				(st->lyrFrozen[i] == swFALSE) && (st->lyrFrozen[j] == swFALSE)) {
-				/* hydred occurs only if at least one soil layer's swp is above wilting point
-				and both soil layers are not frozen */
+			if (above_wp[a] || above_wp[b]) {
+				/* hydred occurs only if at least one soil layer's swp is above wilting point */
 
 				if (GT(swp[i], swp[j])) {
 					Rx = lyrRootCo[j]; // layer j has more water than i
@@ -931,37 +1012,40 @@ void hydraulic_redistribution(double swc[], double swcwp[], double lyrRootCo[],
 					Rx = lyrRootCo[i];
 				}
 
-				hydredmat[i][j] = maxCondroot * 10. / 24. * (swp[j] - swp[i]) *
-					fmax(relCondroot[i], relCondroot[j]) * (lyrRootCo[i] * lyrRootCo[j] / (1. - Rx)); /* assuming a 10-hour night */
-				hydredmat[j][i] = -hydredmat[i][j];
+				hydredmat[a][b] = maxCondroot * 10. / 24. * (swp[j] - swp[i]) *
+					fmax(relCondroot[a], relCondroot[b]) * (lyrRootCo[i] * lyrRootCo[j] / (1. - Rx)); /* assuming a 10-hour night */
+				hydredmat[b][a] = -hydredmat[a][b];
 			} else {
-				hydredmat[i][j] = hydredmat[j][i] = 0.;
+				hydredmat[a][b] = hydredmat[b][a] = 0.;
 			}
 		}
 	}
 
-	for (i = 0; i < nlyrs; i++) { /* total hydred from layer i cannot extract more than its swa */
+	for (a = 0; a < n; a++) { /* total hydred from layer i cannot extract more than its swa */
+		i = lyr[a];
 		hydred_sum = 0.;
-		for (j = 0; j < nlyrs; j++) {
-			hydred_sum += hydredmat[i][j];
+		for (b = 0; b < n; b++) {
+			hydred_sum += hydredmat[a][b];
 		}
 
 		swa = fmax( 0., swc[i] - swcwp[i] );
 		if (LT(hydred_sum, 0.) && GT( -hydred_sum, swa)) {
 			x = swa / -hydred_sum;
-			for (j = 0; j < nlyrs; j++) {
-				hydredmat[i][j] *= x;
-				hydredmat[j][i] *= x;
+			for (b = 0; b < n; b++) {
+				hydredmat[a][b] *= x;
+				hydredmat[b][a] *= x;
 			}
 		}
 	}
 
-	hydred[0] = 0.; /* no hydred in top layer */
-
-	for (i = 1; i < nlyrs; i++) {
+	for (i = 0; i < nlyrs; i++) {
 		hydred[i] = 0.; //init
-		for (j = 1; j < nlyrs; j++) {
-			hydred[i] += hydredmat[i][j];
+	}
+
+	for (a = 0; a < n; a++) {
+		i = lyr[a];
+		for (b = 0; b < n; b++) {
+			hydred[i] += hydredmat[a][b];
 		}
 
 		hydred[i] *= scale;
@@ -970,33 +1054,53 @@ void hydraulic_redistribution(double swc[], double swcwp[], double lyrRootCo[],
 }
 
 /**
-@brief Interpolate soil temperature layer temperature values to
-     input soil profile depths/layers.
+@brief Calculate `y = W x` for a sparse matrix of interpolation weights.
+
+@param w Interpolation weights with `w->n_rows` rows and `w->n_cols` columns.
+@param x Input values of size `w->n_cols`.
+@param y Resulting values of size `w->n_rows`.
+
+@sideeffect y Updated interpolated values.
+*/
+void st_sparse_matvec(const ST_SPARSE_MATRIX *w, const double x[], double y[]) {
+	unsigned int r, k;
+	double acc;
+
+	for (r = 0; r < w->n_rows; r++) {
+		acc = 0.;
+		for (k = w->row_start[r]; k < w->row_start[r + 1]; k++) {
+			acc += w->val[k] * x[w->col[k]];
+		}
+		y[r] = acc;
+	}
+}
+
+/**
+@brief Calculate the weights that interpolate soil temperature layer
+  temperature values to input soil profile depths/layers.
+
+The soil layer temperatures are `sTemp = W sTempR`, i.e., the matrix has
+one row per soil layer and one column per value of `sTempR`
+(`nlyrTemp + 2` columns including surface and lower boundary).
 
 @param cor Two dimensional array containing soil temperature data.
 @param nlyrTemp The number of soil temperature layers.
 @param depth_Temp Depths of soil temperature layers (cm).
-@param sTempR Temperature values of soil temperature layers (&deg;C).
 @param nlyrSoil Number of soil layers.
 @param depth_Soil Depths of soil layers (cm).
 @param width_Soil Witdths of soil layers (cm).
-@param sTemp Temperature values of soil layers (&deg;C).
-
-@sideeffect sTemp Updated temperatature values soil layers (&deg;C).
+@param w Resulting interpolation weights.
 */
-
-void lyrTemp_to_lyrSoil_temperature(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
-  unsigned int nlyrTemp, double depth_Temp[], double sTempR[], unsigned int nlyrSoil,
-  double depth_Soil[], double width_Soil[], double sTemp[]){
+void lyrTemp_to_lyrSoil_temperature_weights(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
+	unsigned int nlyrTemp, double depth_Temp[], unsigned int nlyrSoil,
+	double depth_Soil[], double width_Soil[], ST_SPARSE_MATRIX *w) {
 	unsigned int i = 0, j, n;
-  #ifdef SWDEBUG
-  int debug = 0;
-  #endif
-	double acc;
+	double acc, x1, w2;
+
+	st_sparse_start(w, nlyrTemp + 2);
 
 	// interpolate soil temperature values for depth of soil profile layers
 	for (j = 0; j < nlyrSoil; j++) {
-		sTemp[j] = 0.0;
 		acc = 0.0;
 		n = 0;
 		while (LT(acc, width_Soil[j]) && i <= nlyrTemp + 1) {
@@ -1008,8 +1112,11 @@ void lyrTemp_to_lyrSoil_temperature(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
 			{ // there are soil layers to add; index i = 0 is soil surface temperature
 				if (!(i == 0 && LT(acc + cor[i][j], width_Soil[j])))
 				{ //don't use soil surface temperature if there is other sufficient soil temperature to interpolate
-					sTemp[j] += interpolation(((i > 0) ? depth_Temp[i - 1] : 0.0),
-						depth_Temp[i], sTempR[i], sTempR[i + 1], depth_Soil[j]);
+					// linear interpolation between sTempR[i] and sTempR[i + 1], see interpolation()
+					x1 = (i > 0) ? depth_Temp[i - 1] : 0.0;
+					w2 = (depth_Soil[j] - x1) / (depth_Temp[i] - x1);
+					st_sparse_add(w, i, 1. - w2);
+					st_sparse_add(w, i + 1, w2);
 					n++; // add weighting by layer width
 				}
 				acc += cor[i][j];
@@ -1021,51 +1128,70 @@ void lyrTemp_to_lyrSoil_temperature(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
 			}
 		}
 
-		if(n > 0) {
-			sTemp[j] = sTemp[j] / n;
-		}
-
-    #ifdef SWDEBUG
-    if (debug)
-      swprintf("\nConf T : i=%i, j=%i, n=%i, sTemp[%i]=%2.2f, acc=%2.2f", i, j, n, j, sTemp[j], acc);
-    #endif
+		st_sparse_end_row(w, (n > 0) ? 1. / n : 1.);
 	}
 }
 
 /**
-@brief Interpolate soil layer temperature values to soil temperature profile
-   depths/layers.
+@brief Interpolate soil temperature layer temperature values to
+     input soil profile depths/layers.
 
+@param cor Two dimensional array containing soil temperature data.
+@param nlyrTemp The number of soil temperature layers.
+@param depth_Temp Depths of soil temperature layers (cm).
+@param sTempR Temperature values of soil temperature layers (&deg;C).
 @param nlyrSoil Number of soil layers.
 @param depth_Soil Depths of soil layers (cm).
-@param sTemp Temperatature values of soil layers (&deg;C).
-@param endTemp Final input for sTemp variables
-@param nlyrTemp Number of soil temperature layers.
-@param depth_Temp Depths of soil temperature layers (cm).
-@param maxTempDepth Maximum depth temperature (&deg;C).
-@param sTempR Array of today's (regression)-layer soil temperature values.
+@param width_Soil Witdths of soil layers (cm).
+@param sTemp Temperature values of soil layers (&deg;C).
 
-@sideeffect sTempR Updated array of today's (regression)-layer soil temperature values.
+@sideeffect sTemp Updated temperatature values soil layers (&deg;C).
 
+@note `soil_temperature()` uses the weights that `soil_temperature_setup()`
+  calculated once per run instead.
 */
 
-void lyrSoil_to_lyrTemp_temperature(unsigned int nlyrSoil, double depth_Soil[],
-   double sTemp[], double endTemp, unsigned int nlyrTemp, double depth_Temp[],
-   double maxTempDepth, double sTempR[]){
+void lyrTemp_to_lyrSoil_temperature(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
+  unsigned int nlyrTemp, double depth_Temp[], double sTempR[], unsigned int nlyrSoil,
+  double depth_Soil[], double width_Soil[], double sTemp[]){
+	ST_SPARSE_MATRIX w;
 
-  unsigned int i, j1=0, j2;
-  #ifdef SWDEBUG
-  int debug = 0;
-  #endif
-	double depth_Soil2[MAX_LAYERS + 1] = {0}, sTemp2[MAX_LAYERS + 1] = {0};
+	lyrTemp_to_lyrSoil_temperature_weights(cor, nlyrTemp, depth_Temp, nlyrSoil,
+		depth_Soil, width_Soil, &w);
+	st_sparse_matvec(&w, sTempR, sTemp);
+}
+
+/**
+@brief Calculate the weights that interpolate soil layer temperature values
+  to soil temperature profile depths/layers.
+
+The temperatures of the soil temperature layers are
+`sTempR[1:nlyrTemp] = W (sTemp, endTemp)`, i.e., the matrix has one row per
+soil temperature layer and `nlyrSoil + 1` columns where the last column
+corresponds to the temperature at `maxTempDepth`.
+Each row has (at most) two nonzero weights.
+
+@param nlyrSoil Number of soil layers.
+@param depth_Soil Depths of soil layers (cm).
+@param nlyrTemp Number of soil temperature layers.
+@param depth_Temp Depths of soil temperature layers (cm).
+@param maxTempDepth Maximum depth of the soil temperature profile (cm).
+@param w Resulting interpolation weights.
+*/
+void lyrSoil_to_lyrTemp_temperature_weights(unsigned int nlyrSoil,
+	double depth_Soil[], unsigned int nlyrTemp, double depth_Temp[],
+	double maxTempDepth, ST_SPARSE_MATRIX *w) {
+
+	unsigned int i, j1 = 0, j2;
+	double depth_Soil2[MAX_LAYERS + 1] = {0}, w2;
+
+	st_sparse_start(w, nlyrSoil + 1);
 
 	//transfer data to include bottom conditions; do not include surface temperature in interpolations
 	for (i = 0; i < nlyrSoil; i++) {
 		depth_Soil2[i] = depth_Soil[i];
-		sTemp2[i] = sTemp[i];
 	}
 	depth_Soil2[nlyrSoil] = maxTempDepth;
-	sTemp2[nlyrSoil] = endTemp;
 
 	//interpolate soil temperature at soil temperature profile depths
 	for (i = 0; i < nlyrTemp; i++) {
@@ -1077,77 +1203,128 @@ void lyrSoil_to_lyrTemp_temperature(unsigned int nlyrSoil, double depth_Soil[],
 			j2++;
 		}
 
-		sTempR[i + 1] = interpolation(depth_Soil2[j1], depth_Soil2[j2], sTemp2[j1], sTemp2[j2], depth_Temp[i]);
+		// linear interpolation between layers j1 and j2, see interpolation()
+		w2 = (depth_Temp[i] - depth_Soil2[j1]) / (depth_Soil2[j2] - depth_Soil2[j1]);
+		st_sparse_add(w, j1, 1. - w2);
+		st_sparse_add(w, j2, w2);
+		st_sparse_end_row(w, 1.);
+	}
+}
 
-		#ifdef SWDEBUG
-		if (debug)
+/**
+@brief Interpolate soil layer temperature values to soil temperature profile
+   depths/layers.
+
+@param nlyrSoil Number of soil layers.
+@param depth_Soil Depths of soil layers (cm).
+@param sTemp Temperatature values of soil layers (&deg;C).
+@param endTemp Final input for sTemp variables
+@param nlyrTemp Number of soil temperature layers.
+@param depth_Temp Depths of soil temperature layers (cm).
+@param maxTempDepth Maximum depth temperature (&deg;C).
+@param sTempR Array of today's (regression)-layer soil temperature values.
 
-			swprintf("\nConf T: i=%i, j1=%i, j2=%i, sTempR[%i]=%2.2f, sTemp2[%i]=%2.2f, sTemp2[%i]=%2.2f, depthT[%i]=%2.2f, depthS2[%i]=%2.2f, depthS2[%i]=%2.2f", i, j1, j2, i, sTempR[i], j1, sTemp2[j1], j2, sTemp2[j2], i, depth_Temp[i], j1, depth_Soil2[j1], j2, depth_Soil2[j2]);
+@sideeffect sTempR Updated array of today's (regression)-layer soil temperature values.
 
-		#endif
+@note `soil_temperature()` uses the weights that `soil_temperature_setup()`
+  calculated once per run instead.
+*/
+
+void lyrSoil_to_lyrTemp_temperature(unsigned int nlyrSoil, double depth_Soil[],
+   double sTemp[], double endTemp, unsigned int nlyrTemp, double depth_Temp[],
+   double maxTempDepth, double sTempR[]){
+
+	unsigned int i;
+	double sTemp2[MAX_LAYERS + 1] = {0};
+	ST_SPARSE_MATRIX w;
+
+	lyrSoil_to_lyrTemp_temperature_weights(nlyrSoil, depth_Soil, nlyrTemp,
+		depth_Temp, maxTempDepth, &w);
+
+	for (i = 0; i < nlyrSoil; i++) {
+		sTemp2[i] = sTemp[i];
 	}
-	sTempR[nlyrTemp + 1] = endTemp;
+	sTemp2[nlyrSoil] = endTemp;
 
-	#ifdef SWDEBUG
-	if (debug)
-		swprintf("\nConf T: sTempR[%i]=%2.2f, sTempR[%i]=%2.2f", i, sTempR[i], i+1, sTempR[i+1]);
-	#endif
+	st_sparse_matvec(&w, sTemp2, sTempR + 1);
+	sTempR[nlyrTemp + 1] = endTemp;
 }
 
 /**
-@brief Initialize soil temperature layer values by transfering soil layer values
-    to soil temperature layer values.
+@brief Calculate the weights that transfer soil layer values to soil
+  temperature layer values.
+
+The values of the soil temperature layers are `res = W var`, i.e., the matrix
+has one row per soil temperature layer (`nlyrTemp + 1` rows) and one column per
+soil layer; rows are width-weighted averages of the overlapping soil layers.
 
 @param cor Two dimensional array containing soil temperature data.
 @param nlyrSoil Number of soil layers.
 @param width_Soil Width of the soil layers.
-@param var Soil layer values to be interpolated.
 @param nlyrTemp Number of soil temperature layers.
 @param width_Temp Width of the soil temperature layers.
-@param res Values interpolated to soil temperature depths.
-
-@return res is updated and reflects new values.
+@param w Resulting interpolation weights.
 */
-
-void lyrSoil_to_lyrTemp(double cor[MAX_ST_RGR][MAX_LAYERS + 1], unsigned int nlyrSoil,
-	double width_Soil[], double var[], unsigned int nlyrTemp, double width_Temp,
-	double res[]) {
+void lyrSoil_to_lyrTemp_weights(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
+	unsigned int nlyrSoil, double width_Soil[], unsigned int nlyrTemp,
+	double width_Temp, ST_SPARSE_MATRIX *w) {
 
 	unsigned int i, j = 0;
-  #ifdef SWDEBUG
-  int debug = 0;
-  #endif
 	double acc, ratio, sum;
 
+	st_sparse_start(w, nlyrSoil);
+
 	for (i = 0; i < nlyrTemp + 1; i++) {
-		res[i] = 0.0;
 		acc = 0.0;
 		sum = 0.0;
 		while (LT(acc, width_Temp) && j < nlyrSoil + 1) {
 			if (GE(cor[i][j], 0.0)) { // there are soil layers to add
 				ratio = cor[i][j] / width_Soil[j];
-				res[i] += var[j] * ratio;
+				st_sparse_add(w, j, ratio);
 				sum += ratio;
 				acc += cor[i][j];
 				if (LT(acc, width_Temp)) j++;
 			} else if (LT(cor[i][j], 0.0)) { // negative cor values indicate end of soil layer profile
 				// copying values from deepest soil layer
 				ratio = -cor[i][j] / width_Soil[j - 1];
-				res[i] += var[j - 1] * ratio;
+				st_sparse_add(w, j - 1, ratio);
 				sum += ratio;
 				acc += (-cor[i][j]);
 			}
 		}
-		res[i] = res[i] / sum;
-
-		#ifdef SWDEBUG
-		if (debug)
-       swprintf("\n i = %u, j = %u, tempLyrVal=%2.2f,  soilLyrVal = %2.2f, cor[i][j] = %2.2f, ratio = %2.2f, acc=%2.2f,sum=%2.2f", i, j, res[i], var[j], cor[i][j], ratio, acc, sum);
-		#endif
 
+		st_sparse_end_row(w, 1. / sum);
 	}
 }
 
+/**
+@brief Initialize soil temperature layer values by transfering soil layer values
+    to soil temperature layer values.
+
+@param cor Two dimensional array containing soil temperature data.
+@param nlyrSoil Number of soil layers.
+@param width_Soil Width of the soil layers.
+@param var Soil layer values to be interpolated.
+@param nlyrTemp Number of soil temperature layers.
+@param width_Temp Width of the soil temperature layers.
+@param res Values interpolated to soil temperature depths.
+
+@return res is updated and reflects new values.
+
+@note `soil_temperature()` uses the weights that `soil_temperature_setup()`
+  calculated once per run instead.
+*/
+
+void lyrSoil_to_lyrTemp(double cor[MAX_ST_RGR][MAX_LAYERS + 1], unsigned int nlyrSoil,
+	double width_Soil[], double var[], unsigned int nlyrTemp, double width_Temp,
+	double res[]) {
+
+	ST_SPARSE_MATRIX w;
+
+	lyrSoil_to_lyrTemp_weights(cor, nlyrSoil, width_Soil, nlyrTemp, width_Temp, &w);
+	st_sparse_matvec(&w, var, res);
+}
+
 /**
 @brief Determine the average temperature of the soil surface under snow.
 
@@ -1180,8 +1357,8 @@ double surface_temperature_under_snow(double airTempAvg, double snow){
 void SW_ST_init_run(void) {
 	soil_temp_init = 0;
 	fusion_pool_init = 0;
-	do_once_at_soiltempError = swTRUE;
-	delta_time = SEC_PER_DAY;
+	SW_CurrentRun->SoilTemp.do_once_at_soiltempError = swTRUE;
+	SW_CurrentRun->SoilTemp.delta_time = SEC_PER_DAY;
 }
 
 
@@ -1273,7 +1450,9 @@ void SW_ST_setup_run(
   - *ptr_stError Updated booleans status of soil temperature error in *ptr_stError.
   - ST_RGR_VALUES.depths Depths of soil layer profile (cm).
   - ST_RGR_VALUES.depthsR Evenly spaced depths of soil temperature profile (cm).
-  - ST_RGR_VALUES.tlyrs_by_slyrs Values of correspondance between soil profile layers and soil temperature layers.
+  - ST_RGR_VALUES.wSoil_to_Temp, ST_RGR_VALUES.wSoil_to_Temp_temperature, and
+    ST_RGR_VALUES.wTemp_to_Soil_temperature Interpolation weights between
+    soil profile layers and soil temperature layers.
 */
 
 void soil_temperature_setup(double bDensity[], double width[], double oldsTemp[],
@@ -1288,6 +1467,11 @@ void soil_temperature_setup(double bDensity[], double width[], double oldsTemp[]
 	double d1 = 0.0, d2 = 0.0, acc = 0.0;
 	// double fc_vwc[nlyrs], wp_vwc[nlyrs];
   double fc_vwc[MAX_LAYERS] = {0}, wp_vwc[MAX_LAYERS] = {0};
+	// correspondance between soil profile layers and soil temperature layers
+	// (one row per soil temperature layer, zero-padded); last column has negative
+	// values and indicates use of deepest soil layer values copied for deeper
+	// soil temperature layers
+	double (*tlyrs_by_slyrs)[MAX_LAYERS + 1];
 
 	// pointers
 	ST_RGR_VALUES *st = &stValues; // just for convenience, so I don't have to type as much
@@ -1324,8 +1508,6 @@ void soil_temperature_setup(double bDensity[], double width[], double oldsTemp[]
 		st->wpR[i] = 0.0;
 		st->bDensityR[i] = 0.0;
 		st->oldsTempR[i] = 0.0;
-		for (j = 0; j < nlyrs + 1; j++) // last column is used for soil temperature layers that are deeper than the deepest soil profile layer
-			st->tlyrs_by_slyrs[i][j] = 0.0;
 	}
 	st->oldsTempR[nRgr + 1] = 0.0;
 
@@ -1364,6 +1546,10 @@ void soil_temperature_setup(double bDensity[], double width[], double oldsTemp[]
 	}
 
 	// calculate values of correspondance 'tlyrs_by_slyrs' between soil profile layers and soil temperature layers
+	// (the weights read up to two rows past the deepest soil temperature layer)
+	tlyrs_by_slyrs = (double (*)[MAX_LAYERS + 1]) Mem_Calloc(nRgr + 3,
+		sizeof *tlyrs_by_slyrs, "soil_temperature_setup()");
+
 	for (i = 0; i < nRgr + 1; i++) {
 		acc = 0.0; // cumulative sum towards deltaX
 		while (x2 < nlyrs && acc < deltaX) { // there are soil layers to add
@@ -1391,12 +1577,12 @@ void soil_temperature_setup(double bDensity[], double width[], double oldsTemp[]
 				}
 			}
 			acc += d2;
-			st->tlyrs_by_slyrs[i][j] = d2;
+			tlyrs_by_slyrs[i][j] = d2;
 		}
 		x1 = x2;
 
 		if (x2 >= nlyrs) { // soil temperature profile is deeper than deepest soil layer; copy data from deepest soil layer
-			st->tlyrs_by_slyrs[i][x2] = -(deltaX - acc);
+			tlyrs_by_slyrs[i][x2] = -(deltaX - acc);
 		}
 	}
 	#ifdef SWDEBUG
@@ -1404,16 +1590,26 @@ void soil_temperature_setup(double bDensity[], double width[], double oldsTemp[]
 		for (i = 0; i < nRgr + 1; i++) {
 			swprintf("\ntl_by_sl");
 				for (j = 0; j < nlyrs + 1; j++)
-					swprintf("[%i,%i]=%3.2f ", i, j, st->tlyrs_by_slyrs[i][j]);
+					swprintf("[%i,%i]=%3.2f ", i, j, tlyrs_by_slyrs[i][j]);
 		}
 	}
 	#endif
 
+	// calculate the interpolation weights between soil profile layers and
+	// soil temperature layers once: geometry does not change during a run
+	lyrSoil_to_lyrTemp_weights(tlyrs_by_slyrs, nlyrs, width, nRgr, deltaX,
+		&st->wSoil_to_Temp);
+	lyrSoil_to_lyrTemp_temperature_weights(nlyrs, st->depths, nRgr, st->depthsR,
+		theMaxDepth, &st->wSoil_to_Temp_temperature);
+	lyrTemp_to_lyrSoil_temperature_weights(tlyrs_by_slyrs, nRgr, st->depthsR,
+		nlyrs, st->depths, width, &st->wTemp_to_Soil_temperature);
+
+	Mem_Free(tlyrs_by_slyrs);
+
 	// calculate volumetric field capacity, volumetric wilting point,
 	// bulk density of the whole soil, and
 	// initial soil temperature for layers of the soil temperature profile
-	lyrSoil_to_lyrTemp(st->tlyrs_by_slyrs, nlyrs, width, bDensity, nRgr, deltaX,
-		st->bDensityR);
+	st_sparse_matvec(&st->wSoil_to_Temp, bDensity, st->bDensityR);
 	lyrSoil_to_lyrTemp_temperature(nlyrs, st->depths, oldsTemp, sTconst, nRgr,
 		st->depthsR, theMaxDepth, st->oldsTempR);
 
@@ -1423,8 +1619,8 @@ void soil_temperature_setup(double bDensity[], double width[], double oldsTemp[]
 		wp_vwc[i] = wp[i] / width[i];
 	}
 
-	lyrSoil_to_lyrTemp(st->tlyrs_by_slyrs, nlyrs, width, fc_vwc, nRgr, deltaX, st->fcR);
-	lyrSoil_to_lyrTemp(st->tlyrs_by_slyrs, nlyrs, width, wp_vwc, nRgr, deltaX, st->wpR);
+	st_sparse_matvec(&st->wSoil_to_Temp, fc_vwc, st->fcR);
+	st_sparse_matvec(&st->wSoil_to_Temp, wp_vwc, st->wpR);
 
 	// st->oldsTempR: index 0 is surface temperature
 	#ifdef SWDEBUG
@@ -1619,10 +1815,11 @@ void soil_temperature_today(double *ptr_dTime, double deltaX, double sT1, double
 	int nRgr, double sTempR[], double oldsTempR[], double vwcR[], double wpR[], double fcR[],
 	double bDensityR[], double csParam1, double csParam2, double shParam, Bool *ptr_stError) {
 
-	int i, k, m, Nsteps_per_day = 1;
+	int i, k, m, b, Nsteps_per_day = 1;
 	double pe, cs, sh, part1, parts, part2;
 	double oldsTempR2[MAX_ST_RGR];
 	Bool Tsoil_not_exploded = swTRUE;
+	SW_FLOW_DIAG *diag = &SW_CurrentRun->Flow.diag;
   #ifdef SWDEBUG
   int debug = 0;
   if (SW_Model.year == 1980 && SW_Model.doy < 10) {
@@ -1694,6 +1891,7 @@ void soil_temperature_today(double *ptr_dTime, double deltaX, double sT1, double
 				(*ptr_stError) = GE(parts, 0.5)? swTRUE: swFALSE; /* Flag whether an error has occurred */
 				if (*ptr_stError) {
 					*ptr_dTime = *ptr_dTime / 2;
+					diag->st_halvings++;
 					/* step out of for-loop through regression soil layers and re-start with adjusted dTime */
 					break;
 				}
@@ -1734,6 +1932,109 @@ void soil_temperature_today(double *ptr_dTime, double deltaX, double sT1, double
 
 	} while ((*ptr_stError) && Tsoil_not_exploded && Nsteps_per_day <= 16);
 
+	// histogram of realized sub-steps per day: bin `b` counts 2^b sub-steps
+	for (b = 0; b < SW_DIAG_NSTEPBINS - 1 && (1 << b) < Nsteps_per_day; b++);
+	diag->st_nsteps[b]++;
+	diag->st_days++;
+
+}
+
+
+/**
+@brief Calculate today's soil temperature for each layer with an implicit
+  Crank-Nicolson scheme.
+
+The heat equation of @cite Parton1978 (eq. 2.21) is discretized with the
+average of the explicit and the implicit finite differences in space,
+i.e., for the interior nodes `i = 1, ..., nRgr`,
+  sTempR[i] - oldsTempR[i] = parts / 2 *
+    ((sTempR[i-1] - 2 * sTempR[i] + sTempR[i+1]) +
+     (oldsTempR[i-1] - 2 * oldsTempR[i] + oldsTempR[i+1]))
+with `parts = dt / deltaX^2 * cs / (sh * bDensityR)` as in
+`soil_temperature_today()`. The scheme is unconditionally stable and
+takes a single time step of one day; the tridiagonal system is
+diagonally dominant and solved without pivoting by the Thomas algorithm,
+i.e., the cost is linear in `nRgr`.
+
+@param deltaX The depth increment for the soil temperature (regression) calculations (cm).
+@param sT1 The soil surface temperature as upper boundary condition (&deg;C).
+@param sTconst The soil temperature at a soil depth where it stays constant as
+		lower boundary condition (&deg;C).
+@param nRgr The number of regressions (1 extra value is needed for the sTempR and oldsTempR for the last layer).
+@param sTempR An array of today's (regression)-layer soil temperature values (&deg;C).
+@param oldsTempR An array of yesterday's (regression)-layer soil temperature value (&deg;C);
+  index 0 is yesterday's surface temperature.
+@param vwcR An array of temperature-layer VWC values (cm/layer).
+@param wpR An array of temperature-layer wilting point values (cm/layer).
+@param fcR An array of temperature-layer field capacity values (cm/layer).
+@param bDensityR temperature-layer bulk density of the whole soil
+  (g/cm<SUP>3</SUP>).
+@param csParam1 A constant for the soil thermal conductivity equation.
+@param csParam2 A constant for the soil thermal conductivity equation.
+@param shParam A constant for specific heat capacity equation.
+@param *ptr_stError A boolean indicating whether there was an error.
+
+@sideeffect
+  - Updated soil temperature values in array of sTempR.
+  - Updated status of soil temperature error in *ptr_stError, i.e.,
+    TRUE if soil temperature goes beyond &plusmn; 100 C.
+*/
+void soil_temperature_today_CN(double deltaX, double sT1, double sTconst,
+	int nRgr, double sTempR[], double oldsTempR[], double vwcR[], double wpR[], double fcR[],
+	double bDensityR[], double csParam1, double csParam2, double shParam, Bool *ptr_stError) {
+
+	int i, k;
+	double pe, cs, sh, part1, halfparts, rhs, m;
+	double cprime[MAX_ST_RGR]; // modified super-diagonal of the Thomas algorithm
+
+	sTempR[0] = sT1; //upper boundary condition; index 0 indicates surface and not first layer
+	sTempR[nRgr + 1] = sTconst; // lower boundary condition; assuming that lowest layer is the depth of constant soil temperature
+
+	part1 = SEC_PER_DAY / squared(deltaX);
+	*ptr_stError = swFALSE;
+
+	// forward sweep: row i has sub- and super-diagonal `-parts / 2` and
+	// diagonal `1 + parts`; sTempR[i] holds the modified right-hand side
+	for (i = 1; i < nRgr + 1; i++) {
+		k = i - 1;
+		pe = (vwcR[k] - wpR[k]) / (fcR[k] - wpR[k]); // the units are volumetric!
+		cs = csParam1 + (pe * csParam2); // Parton (1978) eq. 2.22: soil thermal conductivity
+		sh = vwcR[k] + shParam * (1. - vwcR[k]); // Parton (1978) eq. 2.22: specific heat capacity
+		halfparts = part1 * cs / (sh * bDensityR[k]) / 2.;
+
+		rhs = oldsTempR[i] +
+			halfparts * (oldsTempR[i - 1] - 2. * oldsTempR[i] + oldsTempR[i + 1]);
+
+		if (i == 1) {
+			// known upper boundary of today
+			m = 1. + 2. * halfparts;
+			rhs += halfparts * sT1;
+		} else {
+			m = 1. + 2. * halfparts + halfparts * cprime[i - 1];
+			rhs += halfparts * sTempR[i - 1];
+		}
+
+		if (i == nRgr) {
+			// known lower boundary of today
+			rhs += halfparts * sTconst;
+		}
+
+		cprime[i] = -halfparts / m;
+		sTempR[i] = rhs / m;
+	}
+
+	// back substitution
+	for (i = nRgr - 1; i >= 1; i--) {
+		sTempR[i] -= cprime[i] * sTempR[i + 1];
+	}
+
+	// Sensibility check to cut-short exploding soil temperature values
+	for (i = 1; i < nRgr + 1; i++) {
+		if (GT(sTempR[i], 100.) || LT(sTempR[i], -100.) || !isfinite(sTempR[i])) {
+			*ptr_stError = swTRUE;
+			break;
+		}
+	}
 }
 
 /**********************************************************************
@@ -1832,6 +2133,9 @@ Equations based on Eitzinger, Parton, and Hartman 2000. @cite Eitzinger2000, Par
 @param theMaxDepth Lower bound of the equation (default is 180 cm from Parton's equation @cite Parton1984).
 @param nRgr Number of regressions (1 extra value is needed for the sTempR and oldsTempR for the last layer.
 @param snow Snow-water-equivalent of the area (cm).
+@param method Solver of the soil temperature profile:
+  \ref SW_STMETHOD_CRANKNICOLSON uses `soil_temperature_today_CN()`;
+  any other value uses the explicit scheme of `soil_temperature_today()`.
 @param *ptr_stError Boolean indicating whether there was an error.
 
 @sideeffect *ptr_stError Updated boolean indicating whether there was an error.
@@ -1844,17 +2148,23 @@ void soil_temperature(double airTemp, double pet, double aet, double biomass,
 	double sTemp[], double surfaceTemp[2], unsigned int nlyrs,
 	double bmLimiter, double t1Param1, double t1Param2, double t1Param3, double csParam1,
 	double csParam2, double shParam, double snowdepth, double sTconst, double deltaX,
-	double theMaxDepth, unsigned int nRgr, double snow, Bool *ptr_stError) {
+	double theMaxDepth, unsigned int nRgr, double snow, unsigned int method,
+	Bool *ptr_stError) {
 
 	unsigned int i, sFadjusted_sTemp;
   #ifdef SWDEBUG
   int debug = 0;
   #endif
-	double T1, vwc[MAX_LAYERS], vwcR[MAX_ST_RGR], sTempR[MAX_ST_RGR];
+	double T1, vwc[MAX_LAYERS], vwcR[MAX_ST_RGR], sTempR[MAX_ST_RGR],
+		sTemp2[MAX_LAYERS + 1];
 
 
 	ST_RGR_VALUES *st = &stValues; // just for convenience, so I don't have to type as much
 
+	// the depth of the soil temperature profile is part of the interpolation
+	// weights calculated by `soil_temperature_setup()`
+	(void) theMaxDepth;
+
 	/* local variables explained:
 	 debug - 1 to print out debug messages & then exit the program after completing the function, 0 to not.  default is 0.
 	 T1 - the average daily temperature at the top of the soil in celsius
@@ -1918,7 +2228,7 @@ void soil_temperature(double airTemp, double pet, double aet, double biomass,
 	if (*ptr_stError) {
 		/* we return early (but after calculating surface temperature) and
 				without attempt to calculate soil temperature again */
-		if (do_once_at_soiltempError) {
+		if (SW_CurrentRun->SoilTemp.do_once_at_soiltempError) {
 			for (i = 0; i < nlyrs; i++) {
 				// reset soil temperature values
 				sTemp[i] = SW_MISSING;
@@ -1926,7 +2236,7 @@ void soil_temperature(double airTemp, double pet, double aet, double biomass,
 				st->lyrFrozen[i] = swFALSE;
 			}
 
-			do_once_at_soiltempError = swFALSE;
+			SW_CurrentRun->SoilTemp.do_once_at_soiltempError = swFALSE;
 		}
 
 		#ifdef SWDEBUG
@@ -1944,7 +2254,7 @@ void soil_temperature(double airTemp, double pet, double aet, double biomass,
 		vwc[i] = swc[i] / width[i];
 	}
 
-	lyrSoil_to_lyrTemp(st->tlyrs_by_slyrs, nlyrs, width, vwc, nRgr, deltaX, vwcR);
+	st_sparse_matvec(&st->wSoil_to_Temp, vwc, vwcR);
 
   #ifdef SWDEBUG
 	if (debug) {
@@ -1964,15 +2274,29 @@ void soil_temperature(double airTemp, double pet, double aet, double biomass,
 	#endif
 
 	// calculate the new soil temperature for each layer
-	soil_temperature_today(&delta_time, deltaX, T1, sTconst, nRgr, sTempR, st->oldsTempR,
-		vwcR, st->wpR, st->fcR, st->bDensityR, csParam1, csParam2, shParam, ptr_stError);
+	if (method == SW_STMETHOD_CRANKNICOLSON) {
+		soil_temperature_today_CN(deltaX, T1, sTconst, nRgr, sTempR, st->oldsTempR,
+			vwcR, st->wpR, st->fcR, st->bDensityR, csParam1, csParam2, shParam, ptr_stError);
+
+		if (*ptr_stError) {
+			SW_CurrentRun->Flow.diag.st_failures++;
+			LogError(logfp, LOGWARN, "SOILWAT2 ERROR in soil temperature module: "
+				"implicit solution exceeded +/- 100 C; "
+				"soil temperature is being turned off\n");
+		}
 
-	// question: should we ever reset delta_time to SEC_PER_DAY?
+	} else {
+		soil_temperature_today(&SW_CurrentRun->SoilTemp.delta_time, deltaX, T1, sTconst, nRgr, sTempR, st->oldsTempR,
+			vwcR, st->wpR, st->fcR, st->bDensityR, csParam1, csParam2, shParam, ptr_stError);
 
-	if (*ptr_stError) {
-		LogError(logfp, LOGWARN, "SOILWAT2 ERROR in soil temperature module: "
-			"stability criterion failed despite reduced time step = %f seconds; "
-			"soil temperature is being turned off\n", delta_time);
+		// question: should we ever reset delta_time to SEC_PER_DAY?
+
+		if (*ptr_stError) {
+			SW_CurrentRun->Flow.diag.st_failures++;
+			LogError(logfp, LOGWARN, "SOILWAT2 ERROR in soil temperature module: "
+				"stability criterion failed despite reduced time step = %f seconds; "
+				"soil temperature is being turned off\n", SW_CurrentRun->SoilTemp.delta_time);
+		}
 	}
 
 	#ifdef SWDEBUG
@@ -1987,17 +2311,27 @@ void soil_temperature(double airTemp, double pet, double aet, double biomass,
 	#endif
 
 	// convert soil temperature of soil temperature profile 'sTempR' to soil profile layers 'sTemp'
-	lyrTemp_to_lyrSoil_temperature(st->tlyrs_by_slyrs, nRgr, st->depthsR, sTempR, nlyrs,
-		st->depths, width, sTemp);
+	st_sparse_matvec(&st->wTemp_to_Soil_temperature, sTempR, sTemp);
 
 	// Calculate fusion pools based on soil profile layers, soil freezing/thawing, and if freezing/thawing not completed during one day, then adjust soil temperature
 	sFadjusted_sTemp = adjust_Tsoil_by_freezing_and_thawing(oldsTemp, sTemp, shParam,
 		nlyrs, vwc, bDensity);
 
+	SW_CurrentRun->Flow.diag.ft_calls++;
+	if (sFadjusted_sTemp) {
+		SW_CurrentRun->Flow.diag.ft_adjusted++;
+	}
+
 	// update sTempR if sTemp were changed due to soil freezing/thawing
 	if (sFadjusted_sTemp) {
-		lyrSoil_to_lyrTemp_temperature(nlyrs, st->depths, sTemp, sTconst, nRgr, st->depthsR,
-			theMaxDepth, sTempR);
+		// soil layer temperature and lower boundary: the last column of the weights
+		for (i = 0; i < nlyrs; i++) {
+			sTemp2[i] = sTemp[i];
+		}
+		sTemp2[nlyrs] = sTconst;
+
+		st_sparse_matvec(&st->wSoil_to_Temp_temperature, sTemp2, sTempR + 1);
+		sTempR[nRgr + 1] = sTconst;
 	}
 
 	// determine frozen/unfrozen status of soil layers
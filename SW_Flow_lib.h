@@ -30,6 +30,12 @@
  01/31/2013	(clk) added new function, pot_soil_evap_bs()
  03/07/2013	(clk) add new array, lyrFrozen to keep track of whether a certain soil layer is frozen. 1 = frozen, 0 = not frozen.
  07/09/2013	(clk) added two new functions: forb_intercepted_water and forb_EsT_partitioning
+ 2026-10-14	added ST_SPARSE_MATRIX to hold the interpolation weights between soil
+ 						layers and soil temperature layers of a simulation run
+ 2026-10-15	added SW_FLOW_DIAG, counters of solver and clamp events of a simulation run
+ 2026-10-15	added SW_WB_MONITOR, residuals of the daily water balance of a simulation run
+ 2026-10-15	removed tlyrs_by_slyrs[MAX_ST_RGR][MAX_LAYERS + 1] from ST_RGR_VALUES; it is
+ 						only needed by soil_temperature_setup() to derive the interpolation weights
  */
 /********************************************************/
 /********************************************************/
@@ -50,6 +56,59 @@ extern "C" {
 // based on Parton, W. J., M. Hartman, D. Ojima, and D. Schimel. 1998. DAYCENT and its land surface submodel: description and testing. Global and Planetary Change 19:35-48.
 #define MIN_VWC_TO_FREEZE	0.13
 
+// upper bound of the nonzero interpolation weights between soil layers and soil temperature layers
+#define MAX_ST_NNZ (2 * (MAX_ST_RGR + MAX_LAYERS + 1))
+
+/** Sparse matrix (compressed rows) of the weights that interpolate values
+    between soil profile layers and soil temperature layers; `y = W x` is
+    calculated by `st_sparse_matvec()` */
+typedef struct {
+	unsigned int n_rows, n_cols, n_nz,
+		row_start[MAX_ST_RGR + 1], /**< weights of row `r` are `row_start[r]` to `row_start[r + 1] - 1` */
+		col[MAX_ST_NNZ]; /**< column index of each weight */
+	double val[MAX_ST_NNZ]; /**< value of each weight */
+} ST_SPARSE_MATRIX;
+
+// number of bins of the histogram of sub-steps per day of soil_temperature_today(): 1, 2, 4, 8, 16, more
+#define SW_DIAG_NSTEPBINS 6
+
+/** Counters of solver and clamp events of the water flow and soil
+    temperature subroutines of a simulation run, see `SW_FLW_log_diagnostics()` */
+typedef struct {
+	unsigned long
+		st_days, /**< days solved by the explicit scheme of `soil_temperature_today()` */
+		st_halvings, /**< halvings of the time step of the explicit scheme */
+		st_nsteps[SW_DIAG_NSTEPBINS], /**< days by realized number of sub-steps: 1, 2, 4, 8, 16, more */
+		st_failures, /**< failures of the soil temperature solver (soil temperature is turned off) */
+		ft_calls, /**< calls of `adjust_Tsoil_by_freezing_and_thawing()` */
+		ft_adjusted, /**< calls that adjusted the soil temperature */
+		clamp_remove, /**< layer removals of `remove_from_soil()` limited by available water */
+		clamp_perc, /**< layer drainage of `infiltrate_water_low()` limited by available water */
+		push_sat; /**< layers of `infiltrate_water_low()` above saturation whose excess is pushed up */
+} SW_FLOW_DIAG;
+
+// number of water balance invariants of `SW_WB_MONITOR`
+#define SW_WB_NCHECKS 3
+// absolute tolerance (cm) of the water balance invariants
+#define SW_WB_TOL 1e-9
+
+/** Water balance monitor of a simulation run: `SW_Water_Flow()` checks
+    three invariants each day from the fluxes it has calculated (cm):
+      - 0: AET <= PET
+      - 1: infiltration == rain + snowmelt + runon - (runoff + intercepted
+           + change of surface water + evaporation of surface water)
+      - 2: change of soil water of the profile == infiltration
+           - (deep drainage + soil evaporation + transpiration)
+
+    The first violation of each invariant is logged as a warning;
+    `SW_FLW_log_diagnostics()` reports the monitor of the run. */
+typedef struct {
+	unsigned long
+		days, /**< days that were checked */
+		failures[SW_WB_NCHECKS]; /**< days on which an invariant was violated by more than `SW_WB_TOL` */
+	double max_residual[SW_WB_NCHECKS]; /**< largest absolute residual of each invariant */
+} SW_WB_MONITOR;
+
 // this structure is for keeping track of the variables used in the soil_temperature function (mainly the regressions)
 typedef struct {
 
@@ -62,7 +121,12 @@ typedef struct {
 		   	 oldsTempR[MAX_ST_RGR];//yesterdays soil temperature of soil layers for soil temperature calculations; index 0 is surface temperature
 
 	Bool lyrFrozen[MAX_LAYERS];
-	double tlyrs_by_slyrs[MAX_ST_RGR][MAX_LAYERS + 1]; // array of soil depth correspondance between soil profile layers and soil temperature layers; last column has negative values and indicates use of deepest soil layer values copied for deeper soil temperature layers
+
+	// interpolation weights of the soil profile geometry, see soil_temperature_setup()
+	ST_SPARSE_MATRIX
+		wSoil_to_Temp, // soil layer values to soil temperature layers, see lyrSoil_to_lyrTemp()
+		wSoil_to_Temp_temperature, // soil layer temperature to soil temperature layers, see lyrSoil_to_lyrTemp_temperature()
+		wTemp_to_Soil_temperature; // soil temperature layers to soil layer temperature, see lyrTemp_to_lyrSoil_temperature()
 
 	/*unsigned int x1BoundsR[MAX_ST_RGR],
 	             x2BoundsR[MAX_ST_RGR],
@@ -136,6 +200,7 @@ void soil_temperature(double airTemp,
 					  double theMaxDepth,
 					  unsigned int nRgr,
 						double snow,
+						unsigned int method,
 						Bool *ptr_stError);
 
 void lyrTemp_to_lyrSoil_temperature(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
@@ -151,6 +216,20 @@ void lyrSoil_to_lyrTemp(double cor[MAX_ST_RGR][MAX_LAYERS + 1], unsigned int nly
 		double width_Soil[], double var[], unsigned int nlyrTemp, double width_Temp,
 		double res[]);
 
+void lyrTemp_to_lyrSoil_temperature_weights(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
+	unsigned int nlyrTemp, double depth_Temp[], unsigned int nlyrSoil,
+	double depth_Soil[], double width_Soil[], ST_SPARSE_MATRIX *w);
+
+void lyrSoil_to_lyrTemp_temperature_weights(unsigned int nlyrSoil,
+	double depth_Soil[], unsigned int nlyrTemp, double depth_Temp[],
+	double maxTempDepth, ST_SPARSE_MATRIX *w);
+
+void lyrSoil_to_lyrTemp_weights(double cor[MAX_ST_RGR][MAX_LAYERS + 1],
+	unsigned int nlyrSoil, double width_Soil[], unsigned int nlyrTemp,
+	double width_Temp, ST_SPARSE_MATRIX *w);
+
+void st_sparse_matvec(const ST_SPARSE_MATRIX *w, const double x[], double y[]);
+
 double surface_temperature_under_snow(double airTempAvg, double snow);
 
 void SW_ST_init_run(void);
@@ -187,6 +266,10 @@ void soil_temperature_today(double *ptr_dTime, double deltaX, double sT1, double
 	int nRgr, double sTempR[], double oldsTempR[], double vwcR[], double wpR[], double fcR[],
 	double bDensityR[], double csParam1, double csParam2, double shParam, Bool *ptr_stError);
 
+void soil_temperature_today_CN(double deltaX, double sT1, double sTconst,
+	int nRgr, double sTempR[], double oldsTempR[], double vwcR[], double wpR[], double fcR[],
+	double bDensityR[], double csParam1, double csParam2, double shParam, Bool *ptr_stError);
+
 
 #ifdef __cplusplus
 }
@@ -18,6 +18,7 @@
 #include "SW_Defines.h"
 
 #include "SW_Flow_lib_PET.h"
+#include "SW_Run.h"
 
 
 /* =================================================== */
@@ -30,11 +31,12 @@
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
 
-static double
-  memoized_G_o[366][2],
-  msun_angles[366][7],
-  memoized_int_cos_theta[366][2],
-  memoized_int_sin_beta[366][2];
+/* memoized values are held by the run context, see `SW_PET_STATE` */
+#define memoized_G_o (SW_CurrentRun->PET.memoized_G_o)
+#define msun_angles (SW_CurrentRun->PET.msun_angles)
+#define memoized_int_cos_theta (SW_CurrentRun->PET.memoized_int_cos_theta)
+#define memoized_int_sin_beta (SW_CurrentRun->PET.memoized_int_sin_beta)
+#define memoized_site (SW_CurrentRun->PET.site)
 
 
 /** @brief Solar constant
@@ -53,12 +55,67 @@ static const double G_sc = 118.1088;
 
 
 
+/* *************************************************** */
+/*                Local Functions                      */
+/* --------------------------------------------------- */
+
+/** @brief Memoized atmospheric pressure and psychrometric constant
+
+  These depend only on the elevation of the site; they are recalculated
+  if `elev` differs from the memoized elevation.
+
+  @param elev Site elevation [m above mean sea level].
+  @return Memoized site constants.
+*/
+static const SW_PET_SITE *pet_site_elev(double elev)
+{
+  SW_PET_SITE *s = &memoized_site;
+
+  if (!s->has_elev || elev != s->elev) {
+    s->elev = elev;
+    s->P = atmospheric_pressure(elev);
+    s->gamma = psychrometric_constant(s->P);
+    s->has_elev = swTRUE;
+  }
+
+  return s;
+}
+
+/** @brief Memoized slope terms of the transposition to a tilted surface
+
+  These depend only on the slope of the site; they are recalculated
+  if `slope` differs from the memoized slope.
+
+  @param slope Slope of the site
+    between 0 (horizontal) and pi / 2 (vertical) [radians].
+  @return Memoized site constants.
+*/
+static const SW_PET_SITE *pet_site_slope(double slope)
+{
+  SW_PET_SITE *s = &memoized_site;
+
+  if (!s->has_slope || slope != s->slope) {
+    s->slope = slope;
+    s->f_i = 0.75 + 0.25 * cos(slope) - slope / swPI2; // Allen et al. 2006: eq. 32
+    s->sin3_halfslope = pow(sin(slope / 2.), 3.);
+    s->has_slope = swTRUE;
+  }
+
+  return s;
+}
+
+
+
 /* *************************************************** */
 /*                Functions                            */
 /* --------------------------------------------------- */
 
 
 /** @brief Initialize global and memoized variables
+
+  The site constants of `solar_radiation()` and `petfunc()`, i.e.,
+  atmospheric pressure, psychrometric constant, and slope terms, are
+  prepared for the elevation and slope of `SW_Site`.
 */
 void SW_PET_init_run(void) {
   int k1, k2;
@@ -74,6 +131,12 @@ void SW_PET_init_run(void) {
       msun_angles[k1][k2] = SW_MISSING;
     }
   }
+
+  memoized_site.has_elev = memoized_site.has_slope = swFALSE;
+  pet_site_elev(SW_Site.altitude);
+  pet_site_slope(SW_Site.slope);
+
+  SW_CurrentRun->PET.year.use = swFALSE;
 }
 
 
@@ -727,8 +790,8 @@ double clearsky_directbeam(double P, double e_a, double int_sin_beta)
 
   // Allen et al. 2006: eq. 17
   if (GT(int_sin_beta, 0.)) {
-    K_b = 0.98 * exp(-0.00146 * P / (Kt * int_sin_beta) \
-           - 0.075 * pow(W / int_sin_beta, 0.4));
+    K_b = 0.98 * sw_exp(-0.00146 * P / (Kt * int_sin_beta) \
+           - 0.075 * sw_pow(W / int_sin_beta, 0.4));
 
   } else {
     K_b = 0.;
@@ -830,14 +893,14 @@ double solar_radiation(unsigned int doy,
 
 
   //--- Atmospheric attenuation
-  // Calculate atmospheric pressure
-  P = atmospheric_pressure(elev);
+  // Calculate atmospheric pressure (memoized for the site)
+  P = pet_site_elev(elev)->P;
 
   // Actual vapor pressure [kPa] estimated from daily mean air temperature and
   // mean monthly relative humidity
   // Allen et al. 2005: eqs 7 and 14
   e_a = rel_humidity / 100. *
-    0.6108 * exp((17.27 * air_temp_mean) / (air_temp_mean + 237.3));
+    0.6108 * sw_exp((17.27 * air_temp_mean) / (air_temp_mean + 237.3));
 
 
   // Atmospheric attenuation: additional cloud effects
@@ -866,20 +929,21 @@ double solar_radiation(unsigned int doy,
 
   //--- Transposition: transpose direct and diffuse radiation to tilted surface
   if (has_tilted_surface(slope, aspect)) {
+    const SW_PET_SITE *s = pet_site_slope(slope);
 
     // Direct beam irradiation
     K_bt = clearsky_directbeam(P, e_a, int_sin_beta[1]);
     H_bt = K_bt * k_c * (*H_ot); // Allen et al. 2006: eq. 30 + k_c
 
-    // Diffuse irradiation (isotropic)
-    f_i = 0.75 + 0.25 * cos(slope) - slope / swPI2; // Allen et al. 2006: eq. 32
+    // Diffuse irradiation (isotropic): Allen et al. 2006: eq. 32
+    f_i = s->f_i;
 
 
     // Diffuse irradiation (anisotropic): HDKR model (Reindl et al. 1990)
     f_B = K_bt / K_bh * (*H_ot) / (*H_oh); // Allen et al. 2006: eq. 34
 
     f_ia = f_i * (1. - K_bh) \
-      * (1. + sqrt(K_bh / (K_bh + K_dh)) * pow(sin(slope / 2.), 3.)) \
+      * (1. + sqrt(K_bh / (K_bh + K_dh)) * s->sin3_halfslope) \
       + f_B * K_bh; // Allen et al. 2006: eq. 33
 
     H_dt = f_ia * H_dh; // Allen et al. 2006: eq. 31
@@ -971,11 +1035,11 @@ double svp(double T, double *slope_svp_to_t) {
   if (T > 0) {
     // Derivation for Huang 2018: eq. 17
     tmp0 = T + 105.;
-    tmp1 = pow(tmp0, 1.57);
+    tmp1 = sw_pow(tmp0, 1.57);
     tmp = T + 237.1;
     tmp2 = 4924.99 / squared(tmp);
-    tmp3 = exp(34.494 - 4924.99 / tmp);
-    dp = 1.57 * pow(tmp0, 0.57);
+    tmp3 = sw_exp(34.494 - 4924.99 / tmp);
+    dp = 1.57 * sw_pow(tmp0, 0.57);
 
   } else {
     // Derivation for Huang 2018: eq. 18
@@ -983,7 +1047,7 @@ double svp(double T, double *slope_svp_to_t) {
     tmp1 = squared(tmp0);
     tmp = T + 278.;
     tmp2 = 6545.8 / squared(tmp);
-    tmp3 = exp(43.494 - 6545.8 / tmp);
+    tmp3 = sw_exp(43.494 - 6545.8 / tmp);
     dp = 2. * tmp0;
   }
 
@@ -1019,7 +1083,7 @@ double petfunc(double H_g, double avgtemp, double elev,
   double reflec, double humid, double windsp, double cloudcov)
 {
 
-  double Ea, Rn, Rc, Rbb, delta, clrsky, ea, P_kPa, gamma, pet;
+  double Ea, Rn, Rc, Rbb, delta, clrsky, ea, gamma, pet;
 
   /* Unit conversion factors:
    1 langley = 1 ly = 41840 J/m2 = 0.0168 evaporative-mm
@@ -1075,11 +1139,9 @@ double petfunc(double H_g, double avgtemp, double elev,
 
   //------ Calculate inputs to Penman's equation
 
-  // Calculate atmospheric pressure [kPa]
-  P_kPa = atmospheric_pressure(elev);
-
-  // Calculate psychrometric constant [kPa / K]
-  gamma = psychrometric_constant(P_kPa);
+  // Psychrometric constant [kPa / K] based on atmospheric pressure [kPa]
+  // (memoized for the site)
+  gamma = pet_site_elev(elev)->gamma;
 
 
   // Saturation vapor pressure [mmHg]
@@ -1112,3 +1174,52 @@ double petfunc(double H_g, double avgtemp, double elev,
 
   return fmax(0.1 * pet, 0.01); // PET [cm / day]
 }
+
+
+
+/**
+@brief Global irradiation and potential evapotranspiration of a sequence
+  of days, see `solar_radiation()` and `petfunc()`
+
+  The site constants are looked up once for all days. Daily inputs and
+  outputs are arrays indexed by day of year, e.g., of a year of preloaded
+  weather.
+
+  @param firstdoy First day of year [1-366].
+  @param lastdoy Last day of year [1-366].
+  @param lat Latitude of the site [radians].
+  @param elev Elevation of site [m asl].
+  @param slope Slope of the site [radians].
+  @param aspect Aspect of the site [radians].
+  @param albedo Surface albedo [-].
+  @param temp_avg Average daily air temperature [C].
+  @param rel_humidity Average daily relative humidity [%].
+  @param windspeed Average daily wind speed at 2-m above ground [m / s].
+  @param cloudcov Average daily cloud cover [%].
+  @param[out] H_oh Daily extraterrestrial horizontal irradiation [MJ / m2].
+  @param[out] H_ot Daily extraterrestrial tilted irradiation [MJ / m2].
+  @param[out] H_gh Daily global horizontal irradiation [MJ / m2].
+  @param[out] H_gt Daily global tilted irradiation [MJ / m2].
+  @param[out] pet Daily potential evapotranspiration [cm / day].
+*/
+void pet_days(unsigned int firstdoy, unsigned int lastdoy,
+  double lat, double elev, double slope, double aspect, double albedo,
+  const double temp_avg[], const double rel_humidity[],
+  const double windspeed[], const double cloudcov[],
+  double H_oh[], double H_ot[], double H_gh[], double H_gt[], double pet[])
+{
+  unsigned int doy;
+
+  for (doy = firstdoy; doy <= lastdoy; doy++) {
+    H_gt[doy] = solar_radiation(
+      doy, lat, elev, slope, aspect, albedo,
+      cloudcov[doy], rel_humidity[doy], temp_avg[doy],
+      &H_oh[doy], &H_ot[doy], &H_gh[doy]
+    );
+
+    pet[doy] = petfunc(
+      H_gt[doy], temp_avg[doy], elev, albedo,
+      rel_humidity[doy], windspeed[doy], cloudcov[doy]
+    );
+  }
+}
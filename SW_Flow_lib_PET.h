@@ -50,6 +50,12 @@ double blackbody_radiation(double T);
 double petfunc(double H_g, double avgtemp, double elev,
   double reflec, double humid, double windsp, double cloudcov);
 
+void pet_days(unsigned int firstdoy, unsigned int lastdoy,
+  double lat, double elev, double slope, double aspect, double albedo,
+  const double temp_avg[], const double rel_humidity[],
+  const double windspeed[], const double cloudcov[],
+  double H_oh[], double H_ot[], double H_gh[], double H_gt[], double pet[]);
+
 double svp(double T, double *slope_svp_to_t);
 double atmospheric_pressure(double elev);
 double psychrometric_constant(double pressure);
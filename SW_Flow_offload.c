@@ -0,0 +1,586 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Flow_offload.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Multi-site daily water balance engine that advances blocks
+ *           of `SW_LANES` sites with the lane kernels of `SW_Flow_lanes.c`,
+ *           see `SW_Flow_offload.h`.
+ *
+ *           Compiled with OpenMP (`-fopenmp`), the daily step of all
+ *           blocks runs on the host threads; without OpenMP, it is a plain
+ *           loop. Compiled with OpenMP and `SW_OFFLOAD_DEVICE`, the daily
+ *           step is an OpenMP target region instead: the blocks, the
+ *           forcing of the current year, and the sums of the current output
+ *           period are mapped to the default device when the engine is
+ *           constructed and remain there. This device path has only run as
+ *           the host fallback of a gcc without offloading support; it has
+ *           not been verified on an offload device and is off by default.
+ *
+ *           A lane of the engine is identical to calling the scalar
+ *           kernels of `SW_Flow_lib.c` in the order of `SW_Water_Flow()`
+ *           for a site with one vegetation type, without snow, and with
+ *           unfrozen soil layers.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ *     (2026-10-15) (ag) the unverified device path requires SW_OFFLOAD_DEVICE
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// OpenMP target regions, see file header (unverified on a device)
+#if defined(_OPENMP) && defined(SW_OFFLOAD_DEVICE)
+#define SW_OFL_TARGET
+#endif
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "SW_Defines.h"
+#include "SW_Site.h"
+#include "SW_SoilWater.h"
+#include "SW_VegProd.h"
+#include "SW_Flow_lanes.h"
+#include "SW_Flow_offload.h"
+#include "SW_Run.h"
+
+
+/* =================================================== */
+/*             Local Function Definitions              */
+/* --------------------------------------------------- */
+
+/** Copy the parameters and state of a site into lane `l` of a block */
+static void set_lane(SW_OFL_BLOCK *b, unsigned int l, const SW_OFL_SITE *s) {
+	unsigned int i;
+	tanfunc_t tf;
+
+	for (i = 0; i < s->n_layers; i++) {
+		b->transp_rgn[i][l] = s->transp_rgn[i];
+		b->swc[i][l] = s->swc[i];
+		b->swcfc[i][l] = s->swcfc[i];
+		b->swcsat[i][l] = s->swcsat[i];
+		b->swcmin[i][l] = s->swcmin[i];
+		b->width[i][l] = s->width[i];
+		b->impermeability[i][l] = s->impermeability[i];
+		b->evap_coeff[i][l] = s->evap_coeff[i];
+		b->transp_coeff[i][l] = s->transp_coeff[i];
+		b->swc_halfwiltpt[i][l] = s->swc_halfwiltpt[i];
+		b->swc_crit[i][l] = s->swc_crit[i];
+		b->swrc_psis[i][l] = s->swrc_psis[i];
+		b->swrc_scale[i][l] = s->swrc_scale[i];
+		b->swrc_b[i][l] = s->swrc_b[i];
+		b->frozen[i][l] = swFALSE;
+	}
+
+	b->fCover[l] = s->fCover;
+	b->veg_kSmax[l] = s->veg_kSmax;
+	b->lit_kSmax[l] = s->lit_kSmax;
+	b->lai_param[l] = s->lai_param;
+	b->Es_param_limit[l] = s->Es_param_limit;
+	b->shade_scale[l] = s->shade_scale;
+	b->shade_deadmax[l] = s->shade_deadmax;
+	b->co2_wue[l] = s->co2_wue;
+	b->slow_drain_coeff[l] = s->slow_drain_coeff;
+	b->standingWater[l] = s->standingWater;
+	b->s_veg[l] = s->s_veg;
+	b->s_lit[l] = s->s_lit;
+
+	tf = s->evap;
+	SW_LANES_set_tanfunc(&b->evap, l, &tf);
+	tf = s->transp;
+	SW_LANES_set_tanfunc(&b->transp, l, &tf);
+	tf = s->shade;
+	SW_LANES_set_tanfunc(&b->shade, l, &tf);
+}
+
+
+#ifdef SW_OFL_TARGET
+#pragma omp declare target
+#endif
+
+/** Soil water potential of each layer and lane of a block,
+    see `SW_SWCbulk2SWPmatric_profile()` */
+static void swp_block(const SW_OFL_BLOCK *b, double swp[][SW_LANES]) {
+	unsigned int i, l;
+
+	for (i = 0; i < b->n_layers; i++) {
+		ForEachLane(l) {
+			swp[i][l] = ZRO(b->swc[i][l]) ?
+				0. :
+				b->swrc_psis[i][l] / powe(b->swc[i][l] * b->swrc_scale[i][l],
+					b->swrc_b[i][l]);
+		}
+	}
+}
+
+
+/** Evaporate from a surface water pool of each lane, see `evap_fromSurface()` */
+static void evap_fromSurface_lanes(double water_pool[], double evap_rate[],
+	double aet[]) {
+
+	unsigned int l;
+	int full;
+
+	ForEachLane(l) {
+		full = GT(water_pool[l], evap_rate[l]);
+
+		evap_rate[l] = full ? evap_rate[l] : water_pool[l];
+		aet[l] += evap_rate[l];
+		water_pool[l] = full ? water_pool[l] - evap_rate[l] : 0.;
+	}
+}
+
+
+/** Advance the sites of a block by one day and add their fluxes to the
+    sums of the output period, see `SW_Water_Flow()` */
+static void step_block(SW_OFL_BLOCK *b, SW_OFL_FORCING *f, SW_OFL_SUMS *sums) {
+	unsigned int i, l, n = b->n_layers;
+	double
+		h2o[SW_LANES], int_veg[SW_LANES], int_lit[SW_LANES],
+		drainout[SW_LANES], aet[SW_LANES], fbse[SW_LANES], fbst[SW_LANES],
+		swpavg[SW_LANES], evap_rate[SW_LANES], transp_rate[SW_LANES],
+		evap_veg[SW_LANES], evap_lit[SW_LANES], evap_sw[SW_LANES],
+		peti, x,
+		swp[MAX_LAYERS][SW_LANES], drain[MAX_LAYERS][SW_LANES],
+		qty[MAX_LAYERS][SW_LANES];
+
+	/* Rainfall interception */
+	ForEachLane(l) {
+		h2o[l] = f->rain[l];
+		int_lit[l] = aet[l] = drainout[l] = 0.;
+	}
+
+	veg_intercepted_water_lanes(h2o, int_veg, b->s_veg, f->rain_events,
+		b->veg_kSmax, f->bLAI_total, b->fCover);
+
+	litter_intercepted_water_lanes(h2o, int_lit, b->s_lit, f->rain_events,
+		b->lit_kSmax, f->litter, b->fCover);
+
+	/* Infiltration */
+	infiltrate_water_high_lanes(b->swc, drain, drainout, h2o, n, b->swcfc,
+		b->swcsat, b->impermeability, b->frozen, b->standingWater);
+
+	/* Potential rates of soil evaporation and transpiration */
+	swp_block(b, swp);
+
+	EsT_partitioning_lanes(fbse, fbst, f->lai_live, b->lai_param);
+
+	pot_soil_evap_lanes(evap_rate, n, b->evap_coeff, f->total_agb, fbse,
+		f->pet, &b->evap, b->width, swp, b->Es_param_limit);
+
+	transp_weighted_avg_lanes(swpavg, b->n_transp_rgn, n, b->transp_rgn,
+		b->transp_coeff, swp);
+
+	pot_transp_lanes(transp_rate, swpavg, f->biolive, f->biodead, fbst, f->pet,
+		&b->transp, b->shade_scale, b->shade_deadmax, &b->shade, b->co2_wue);
+
+	ForEachLane(l) {
+		evap_rate[l] *= b->fCover[l];
+		transp_rate[l] *= b->fCover[l];
+
+		/* Potential evaporation rates of intercepted and surface water */
+		evap_veg[l] = fmax(0., fmin(f->pet[l] * b->fCover[l], b->s_veg[l]));
+		peti = f->pet[l] - evap_veg[l] / b->fCover[l];
+		evap_lit[l] = fmax(0., fmin(peti, b->s_lit[l]));
+		peti -= evap_lit[l];
+		evap_sw[l] = fmax(0., fmin(peti, b->standingWater[l]));
+
+		/* Scale all rates to PET */
+		x = evap_lit[l] + evap_sw[l];
+		x += evap_veg[l] + evap_rate[l] + transp_rate[l];
+		x = GT(x, f->pet[l]) ? f->pet[l] / x : 1.;
+
+		evap_veg[l] *= x;
+		evap_rate[l] *= x;
+		transp_rate[l] *= x;
+		evap_lit[l] *= x;
+		evap_sw[l] *= x;
+	}
+
+	/* Evaporation of intercepted and surface water */
+	evap_fromSurface_lanes(b->s_veg, evap_veg, aet);
+	evap_fromSurface_lanes(b->s_lit, evap_lit, aet);
+	evap_fromSurface_lanes(b->standingWater, evap_sw, aet);
+
+	ForEachLane(l) {
+		sums->interception[l] += int_veg[l] + int_lit[l];
+		sums->evap_surface[l] += evap_veg[l] + evap_lit[l] + evap_sw[l];
+	}
+
+	/* Soil evaporation and transpiration */
+	remove_from_soil_lanes(b->swc, qty, aet, n, b->evap_coeff, evap_rate,
+		b->swc_halfwiltpt, swp, b->frozen);
+
+	for (i = 0; i < n; i++) {
+		ForEachLane(l) {
+			sums->evap_soil[l] += qty[i][l];
+		}
+	}
+
+	swp_block(b, swp);
+
+	remove_from_soil_lanes(b->swc, qty, aet, n, b->transp_coeff, transp_rate,
+		b->swc_crit, swp, b->frozen);
+
+	for (i = 0; i < n; i++) {
+		ForEachLane(l) {
+			sums->transp[l] += qty[i][l];
+		}
+	}
+
+	/* Drainage */
+	infiltrate_water_low_lanes(b->swc, drain, drainout, n, b->slow_drain_coeff,
+		SLOW_DRAIN_DEPTH, b->swcfc, b->width, b->swcmin, b->swcsat,
+		b->impermeability, b->frozen, b->standingWater, NULL, NULL);
+
+	ForEachLane(l) {
+		sums->aet[l] += aet[l];
+		sums->drainout[l] += drainout[l];
+	}
+
+	for (i = 0; i < n; i++) {
+		ForEachLane(l) {
+			sums->swc[i][l] += b->swc[i][l];
+		}
+	}
+}
+
+#ifdef SW_OFL_TARGET
+#pragma omp end declare target
+#endif
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Set up a site of the engine from the active simulation run
+
+@param s Parameters and initial state of the site.
+@param k The vegetation type of the site.
+*/
+void SW_OFL_site_from_run(SW_OFL_SITE *s, int k) {
+	VegType *v = &SW_VegProd.veg[k];
+	LyrIndex i;
+
+	memset(s, 0, sizeof *s);
+
+	s->n_layers = SW_Site.n_layers;
+	s->n_transp_rgn = SW_Site.n_transp_rgn;
+
+	ForEachSoilLayer(i) {
+		s->transp_rgn[i] = (i < SW_Site.n_transp_lyrs[k]) ?
+			SW_Site.my_transp_rgn[k][i] : 0;
+		s->swc[i] = SW_Soilwat.swcBulk[Today][i];
+		s->swcfc[i] = SW_Site.swcBulk_fieldcap[i];
+		s->swcsat[i] = SW_Site.swcBulk_saturated[i];
+		s->swcmin[i] = SW_Site.swcBulk_min[i];
+		s->width[i] = SW_Site.width[i];
+		s->impermeability[i] = SW_Site.impermeability[i];
+		s->evap_coeff[i] = (i < SW_Site.n_evap_lyrs) ? SW_Site.evap_coeff[i] : 0.;
+		s->transp_coeff[i] = (i < SW_Site.n_transp_lyrs[k]) ?
+			SW_Site.transp_coeff[k][i] : 0.;
+		s->swc_halfwiltpt[i] = SW_Site.swcBulk_wiltpt[i] / 2.;
+		s->swc_crit[i] = SW_Site.swcBulk_atSWPcrit[k][i];
+		s->swrc_psis[i] = SW_Site.swrc_psis_bar[i];
+		s->swrc_scale[i] = SW_Site.swrc_theta_scale[i];
+		s->swrc_b[i] = SW_Site.bMatric[i];
+	}
+
+	s->fCover = v->cov.fCover;
+	s->veg_kSmax = v->veg_kSmax;
+	s->lit_kSmax = v->lit_kSmax;
+	s->lai_param = v->EsTpartitioning_param;
+	s->Es_param_limit = v->Es_param_limit;
+	s->shade_scale = v->shade_scale;
+	s->shade_deadmax = v->shade_deadmax;
+	s->co2_wue = v->co2_multipliers[WUE_INDEX];
+	s->slow_drain_coeff = SW_Site.slow_drain_coeff;
+
+	s->standingWater = SW_CurrentRun->Flow.standingWater[Today];
+	s->s_veg = SW_CurrentRun->Flow.veg_int_storage[k];
+	s->s_lit = SW_CurrentRun->Flow.litter_int_storage;
+
+	s->evap = SW_Site.evap;
+	s->transp = SW_Site.transp;
+	s->shade = v->tr_shade_effects;
+}
+
+
+/**
+@brief Group sites into blocks and map them to the default device
+
+Consecutive sites with the same number of soil layers and of transpiration
+regions share a block; unused lanes of a block simulate a copy of its
+first site without forcing. Sites are simulated in order of `sites` to
+keep blocks full.
+
+@param e The engine.
+@param sites Parameters and initial state of each site; vegetation cover
+  must be positive.
+@param n_sites Number of sites.
+*/
+void SW_OFL_construct(SW_OFL_ENGINE *e, const SW_OFL_SITE sites[],
+	unsigned int n_sites) {
+
+	SW_OFL_BLOCK *blocks;
+	unsigned int i, l, nb = 0, lane = 0;
+
+	e->n_sites = n_sites;
+	e->n_days = 0;
+	e->block = (unsigned int *) Mem_Calloc(max(n_sites, 1u),
+		sizeof(unsigned int), "SW_OFL_construct");
+	e->lane = (unsigned int *) Mem_Calloc(max(n_sites, 1u),
+		sizeof(unsigned int), "SW_OFL_construct");
+
+	for (i = 0; i < n_sites; i++) {
+		if (sites[i].n_layers < 1 || sites[i].n_layers > MAX_LAYERS ||
+			!GT(sites[i].fCover, 0.)) {
+
+			LogError(logfp, LOGFATAL, "SW_OFL_construct(): site %u has %u soil "
+				"layers and vegetation cover %f.\n", i, sites[i].n_layers,
+				sites[i].fCover);
+		}
+
+		if (i == 0 || lane == SW_LANES - 1 ||
+			sites[i].n_layers != sites[i - 1].n_layers ||
+			sites[i].n_transp_rgn != sites[i - 1].n_transp_rgn) {
+
+			nb++;
+			lane = 0;
+		} else {
+			lane++;
+		}
+
+		e->block[i] = nb - 1;
+		e->lane[i] = lane;
+	}
+
+	e->n_blocks = nb;
+	blocks = e->blocks = (SW_OFL_BLOCK *) Mem_Calloc(max(nb, 1u),
+		sizeof(SW_OFL_BLOCK), "SW_OFL_construct");
+	e->forcing = (SW_OFL_FORCING *) Mem_Calloc((size_t) MAX_DAYS * max(nb, 1u),
+		sizeof(SW_OFL_FORCING), "SW_OFL_construct");
+	e->sums = (SW_OFL_SUMS *) Mem_Calloc(max(nb, 1u),
+		sizeof(SW_OFL_SUMS), "SW_OFL_construct");
+
+	for (i = 0; i < n_sites; i++) {
+		if (0 == e->lane[i]) {
+			blocks[e->block[i]].n_layers = sites[i].n_layers;
+			blocks[e->block[i]].n_transp_rgn = sites[i].n_transp_rgn;
+
+			ForEachLane(l) {
+				set_lane(&blocks[e->block[i]], l, &sites[i]);
+			}
+
+		} else {
+			set_lane(&blocks[e->block[i]], e->lane[i], &sites[i]);
+		}
+	}
+
+	#ifdef SW_OFL_TARGET
+	#pragma omp target enter data map(to: e->blocks[0:nb], e->sums[0:nb]) \
+		map(alloc: e->forcing[0:(size_t) MAX_DAYS * nb])
+	#endif
+}
+
+
+/**
+@brief Remove the engine from the device and free its memory
+
+@param e The engine.
+*/
+void SW_OFL_deconstruct(SW_OFL_ENGINE *e) {
+	SW_OFL_BLOCK *blocks = e->blocks;
+	SW_OFL_FORCING *forcing = e->forcing;
+	SW_OFL_SUMS *sums = e->sums;
+
+	if (isnull(blocks)) {
+		return;
+	}
+
+	#ifdef SW_OFL_TARGET
+	#pragma omp target exit data map(delete: e->blocks[0:e->n_blocks], \
+		e->sums[0:e->n_blocks], e->forcing[0:(size_t) MAX_DAYS * e->n_blocks])
+	#endif
+
+	Mem_Free(e->block);
+	Mem_Free(e->lane);
+	Mem_Free(blocks);
+	Mem_Free(forcing);
+	Mem_Free(sums);
+
+	e->block = e->lane = NULL;
+	e->blocks = NULL;
+	e->forcing = NULL;
+	e->sums = NULL;
+	e->n_sites = e->n_blocks = 0;
+}
+
+
+/**
+@brief Set the forcing of a site for a day of the current year
+
+The forcing of all sites and days of a year is copied to the device
+at once by `SW_OFL_new_year()`.
+
+@param e The engine.
+@param isite The site (base0).
+@param doy The day of the year (base0).
+@param d The forcing of the site.
+*/
+void SW_OFL_set_forcing(SW_OFL_ENGINE *e, unsigned int isite, TimeInt doy,
+	const SW_OFL_DAY *d) {
+
+	SW_OFL_FORCING *f = &e->forcing[(size_t) doy * e->n_blocks + e->block[isite]];
+	unsigned int l = e->lane[isite];
+
+	f->rain[l] = d->rain;
+	f->pet[l] = d->pet;
+	f->rain_events[l] = d->rain_events;
+	f->lai_live[l] = d->lai_live;
+	f->bLAI_total[l] = d->bLAI_total;
+	f->total_agb[l] = d->total_agb;
+	f->biolive[l] = d->biolive;
+	f->biodead[l] = d->biodead;
+	f->litter[l] = d->litter;
+}
+
+
+/**
+@brief Copy the forcing of a year to the device
+
+@param e The engine.
+*/
+void SW_OFL_new_year(SW_OFL_ENGINE *e) {
+	#ifdef SW_OFL_TARGET
+	#pragma omp target update to(e->forcing[0:(size_t) MAX_DAYS * e->n_blocks])
+	#else
+	(void) e; /* the forcing is used in place */
+	#endif
+}
+
+
+/**
+@brief Advance all sites by one day
+
+@param e The engine.
+@param doy The day of the year (base0).
+*/
+void SW_OFL_step_day(SW_OFL_ENGINE *e, TimeInt doy) {
+	SW_OFL_BLOCK *blocks = e->blocks;
+	SW_OFL_FORCING *forcing = e->forcing;
+	SW_OFL_SUMS *sums = e->sums;
+	unsigned int j, nb = e->n_blocks;
+	size_t f0 = (size_t) doy * nb;
+
+	#if defined(SW_OFL_TARGET)
+	size_t nf = (size_t) MAX_DAYS * nb;
+
+	#pragma omp target teams distribute parallel for \
+		map(alloc: blocks[0:nb], forcing[0:nf], sums[0:nb])
+	#elif defined(_OPENMP)
+	#pragma omp parallel for
+	#endif
+	for (j = 0; j < nb; j++) {
+		step_block(&blocks[j], &forcing[f0 + j], &sums[j]);
+	}
+
+	e->n_days++;
+}
+
+
+/**
+@brief Copy the sums of the output period from the device and start
+  the next output period
+
+@param e The engine.
+@param out The output of each site for the period.
+*/
+void SW_OFL_end_period(SW_OFL_ENGINE *e, SW_OFL_OUT out[]) {
+	SW_OFL_SUMS *sums = e->sums, *s;
+	unsigned int isite, i, l, nb = e->n_blocks;
+	double nd = (e->n_days > 0) ? e->n_days : 1.;
+
+	#ifdef SW_OFL_TARGET
+	#pragma omp target update from(sums[0:nb])
+	#endif
+
+	for (isite = 0; isite < e->n_sites; isite++) {
+		s = &sums[e->block[isite]];
+		l = e->lane[isite];
+
+		out[isite].n_days = e->n_days;
+		out[isite].interception = s->interception[l];
+		out[isite].evap_surface = s->evap_surface[l];
+		out[isite].evap_soil = s->evap_soil[l];
+		out[isite].transp = s->transp[l];
+		out[isite].aet = s->aet[l];
+		out[isite].drainout = s->drainout[l];
+
+		for (i = 0; i < e->blocks[e->block[isite]].n_layers; i++) {
+			out[isite].swc[i] = s->swc[i][l] / nd;
+		}
+	}
+
+	memset(sums, 0, nb * sizeof(SW_OFL_SUMS));
+	e->n_days = 0;
+
+	#ifdef SW_OFL_TARGET
+	#pragma omp target update to(sums[0:nb])
+	#endif
+}
+
+
+/**
+@brief Copy the current soil water content of a site from the device
+
+Each call copies the state of all sites; it is meant for the end of a
+simulation (or debugging), not for every day.
+
+@param e The engine.
+@param isite The site (base0).
+@param swc The soil water content of each layer (cm).
+*/
+void SW_OFL_get_swc(SW_OFL_ENGINE *e, unsigned int isite, double swc[]) {
+	SW_OFL_BLOCK *blocks = e->blocks, *b;
+	unsigned int i;
+
+	#ifdef SW_OFL_TARGET
+	#pragma omp target update from(e->blocks[0:e->n_blocks])
+	#endif
+
+	b = &blocks[e->block[isite]];
+	for (i = 0; i < b->n_layers; i++) {
+		swc[i] = b->swc[i][e->lane[isite]];
+	}
+}
+
+
+/**
+@brief Is the engine running on an offload device?
+
+@return swTRUE if compiled with OpenMP and `SW_OFFLOAD_DEVICE` and a device
+  is available.
+*/
+Bool SW_OFL_on_device(void) {
+	#ifdef SW_OFL_TARGET
+	return itob(omp_get_num_devices() > 0);
+	#else
+	return swFALSE;
+	#endif
+}
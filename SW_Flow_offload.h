@@ -0,0 +1,159 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Flow_offload.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for the multi-site daily
+ *           water balance engine of `SW_Flow_offload.c` that may run on
+ *           an offload device (e.g., a GPU via OpenMP target regions;
+ *           unverified and off by default, see `SW_Flow_offload.c`).
+ *
+ *           The engine advances many sites one day at a time. Sites are
+ *           grouped into blocks of `SW_LANES` sites (see `SW_Flow_lanes.h`)
+ *           that share the number of soil layers and of transpiration
+ *           regions; each device thread advances one block with the lane
+ *           kernels. The state of the sites stays on the device; the host
+ *           uploads the daily forcing once per year and copies back only
+ *           the sums of each output period.
+ *
+ *           The engine simulates the core of `SW_Water_Flow()` for one
+ *           vegetation type per site: canopy and litter interception,
+ *           infiltration, potential evaporation and transpiration rates
+ *           from a given PET (e.g., of the per-year PET tables),
+ *           evaporation of intercepted and standing water, soil evaporation,
+ *           transpiration, and drainage. Snow, frozen soils, bare-ground
+ *           evaporation, runon/runoff, and hydraulic redistribution are not
+ *           simulated. `SW_Water_Flow()` remains the reference implementation.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_FLOW_OFFLOAD_H
+#define SW_FLOW_OFFLOAD_H
+
+#include "generic.h"
+#include "SW_Defines.h"
+#include "Times.h"
+#include "SW_Flow_lanes.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+/** Parameters and initial state of a site, see `SW_OFL_site_from_run()`;
+    layer values beyond `n_layers` are ignored */
+typedef struct {
+	unsigned int n_layers, n_transp_rgn,
+		transp_rgn[MAX_LAYERS]; /**< transpiration region of each layer (base1); 0 if none */
+
+	double
+		swc[MAX_LAYERS], swcfc[MAX_LAYERS], swcsat[MAX_LAYERS],
+		swcmin[MAX_LAYERS], width[MAX_LAYERS], impermeability[MAX_LAYERS],
+		evap_coeff[MAX_LAYERS], transp_coeff[MAX_LAYERS],
+		swc_halfwiltpt[MAX_LAYERS], /**< lower limit of soil evaporation */
+		swc_crit[MAX_LAYERS], /**< lower limit of transpiration */
+		swrc_psis[MAX_LAYERS], swrc_scale[MAX_LAYERS], swrc_b[MAX_LAYERS]; /**< see `SW_SWCbulk2SWPmatric_profile()` */
+
+	double fCover, veg_kSmax, lit_kSmax, lai_param, Es_param_limit,
+		shade_scale, shade_deadmax, co2_wue, slow_drain_coeff,
+		standingWater, s_veg, s_lit; /**< surface water and storage of intercepted water */
+
+	tanfunc_t evap, transp, shade;
+} SW_OFL_SITE;
+
+/** Daily forcing of a site */
+typedef struct {
+	double rain, pet, rain_events, lai_live, bLAI_total, total_agb,
+		biolive, biodead, litter;
+} SW_OFL_DAY;
+
+/** Lane-shaped parameters and state of a block of sites (on the device) */
+typedef struct {
+	unsigned int n_layers, n_transp_rgn,
+		transp_rgn[MAX_LAYERS][SW_LANES];
+
+	double
+		swc[MAX_LAYERS][SW_LANES], swcfc[MAX_LAYERS][SW_LANES],
+		swcsat[MAX_LAYERS][SW_LANES], swcmin[MAX_LAYERS][SW_LANES],
+		width[MAX_LAYERS][SW_LANES], impermeability[MAX_LAYERS][SW_LANES],
+		evap_coeff[MAX_LAYERS][SW_LANES], transp_coeff[MAX_LAYERS][SW_LANES],
+		swc_halfwiltpt[MAX_LAYERS][SW_LANES], swc_crit[MAX_LAYERS][SW_LANES],
+		swrc_psis[MAX_LAYERS][SW_LANES], swrc_scale[MAX_LAYERS][SW_LANES],
+		swrc_b[MAX_LAYERS][SW_LANES];
+
+	Bool frozen[MAX_LAYERS][SW_LANES]; /**< always swFALSE */
+
+	double fCover[SW_LANES], veg_kSmax[SW_LANES], lit_kSmax[SW_LANES],
+		lai_param[SW_LANES], Es_param_limit[SW_LANES], shade_scale[SW_LANES],
+		shade_deadmax[SW_LANES], co2_wue[SW_LANES], slow_drain_coeff[SW_LANES],
+		standingWater[SW_LANES], s_veg[SW_LANES], s_lit[SW_LANES];
+
+	SW_TANFUNC_LANES evap, transp, shade;
+} SW_OFL_BLOCK;
+
+/** Lane-shaped daily forcing of a block, see `SW_OFL_DAY` */
+typedef struct {
+	double rain[SW_LANES], pet[SW_LANES], rain_events[SW_LANES],
+		lai_live[SW_LANES], bLAI_total[SW_LANES], total_agb[SW_LANES],
+		biolive[SW_LANES], biodead[SW_LANES], litter[SW_LANES];
+} SW_OFL_FORCING;
+
+/** Lane-shaped sums of a block over the days of an output period */
+typedef struct {
+	double interception[SW_LANES], evap_surface[SW_LANES],
+		evap_soil[SW_LANES], transp[SW_LANES], aet[SW_LANES],
+		drainout[SW_LANES], swc[MAX_LAYERS][SW_LANES];
+} SW_OFL_SUMS;
+
+/** Output of a site for an output period: sums of the fluxes (cm) and
+    the mean soil water content of each layer (cm) */
+typedef struct {
+	unsigned int n_days;
+	double interception, evap_surface, evap_soil, transp, aet, drainout,
+		swc[MAX_LAYERS];
+} SW_OFL_OUT;
+
+/** Multi-site water balance engine, see `SW_OFL_construct()` */
+typedef struct {
+	unsigned int n_sites, n_blocks,
+		n_days, /**< days since the end of the last output period */
+		*block, *lane; /**< block and lane of each site */
+
+	SW_OFL_BLOCK *blocks; /**< [n_blocks] */
+	SW_OFL_FORCING *forcing; /**< [MAX_DAYS][n_blocks] of the current year */
+	SW_OFL_SUMS *sums; /**< [n_blocks] */
+} SW_OFL_ENGINE;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_OFL_site_from_run(SW_OFL_SITE *s, int k);
+
+void SW_OFL_construct(SW_OFL_ENGINE *e, const SW_OFL_SITE sites[],
+	unsigned int n_sites);
+void SW_OFL_deconstruct(SW_OFL_ENGINE *e);
+
+void SW_OFL_set_forcing(SW_OFL_ENGINE *e, unsigned int isite, TimeInt doy,
+	const SW_OFL_DAY *d);
+void SW_OFL_new_year(SW_OFL_ENGINE *e);
+void SW_OFL_step_day(SW_OFL_ENGINE *e, TimeInt doy);
+void SW_OFL_end_period(SW_OFL_ENGINE *e, SW_OFL_OUT out[]);
+void SW_OFL_get_swc(SW_OFL_ENGINE *e, unsigned int isite, double swc[]);
+
+Bool SW_OFL_on_device(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
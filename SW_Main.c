@@ -7,6 +7,24 @@
  *
  06/24/2013	(rjm)	included "SW_Site.h" and "SW_Weather.h";
  added calls at end of main() to SW_SIT_clear_layers() and SW_WTH_clear_runavg_list() to free memory
+ 2026-10-14 simulation state is held by the run context `sw_run`
+ 2026-10-14 added batch mode (option -b) which simulates many sites with a pool of threads
+ 2026-10-14 added conversion of weather input files to a binary weather store (option -w)
+ 2026-10-14 added whole-run weather preload (option -p)
+ 2026-10-15 added checkpoints (option -c) and resuming from them (option -r)
+ 2026-10-15 profiling builds (SW_PROFILE) report the cycle counters of the run
+ 2026-10-15 added solver diagnostics (option -g)
+ 2026-10-15 added a trace of timed spans for Perfetto (option -t)
+ 2026-10-15 option -w also converts files of measured soil moisture to a binary store
+ 2026-10-15 added output of summary statistics only (option -o summary)
+ 2026-10-15 batch mode distributes sites across MPI ranks (`make bin_mpi`)
+ 2026-10-15 files and tiles of gridded weather are released at the end
+ 2026-10-15 added output of all sites into one HDF5 file (option -o h5)
+ 2026-10-15 added reader threads that set up sites ahead of the batch threads (option -i)
+ 2026-10-15 added live metrics of batch mode (option -m)
+ 2026-10-15 added pinning of the threads of batch mode across NUMA nodes (option -n)
+ 2026-10-15 added sweeps over variants of parameters of a site (option -s)
+ 2026-10-15 added simulation of the sites of batch mode in lanes (option -l)
  */
 /********************************************************/
 /********************************************************/
@@ -23,19 +41,40 @@
 #else
 #include <unistd.h>
 #endif
+#ifdef SW_MPI
+#include <mpi.h>
+#endif
 #include "generic.h"
 #include "filefuncs.h"
 #include "SW_Defines.h"
 #include "SW_Control.h"
 #include "SW_Site.h"
 #include "SW_Weather.h"
+#include "SW_Weather_grid.h"
+#include "SW_SoilWater.h"
 #include "SW_Output.h"
 #include "SW_Output_outtext.h"
+#include "SW_Output_outhdf.h"
+#include "SW_Output_reduce.h"
+#include "SW_Flow.h"
+#include "SW_Trace.h"
+#include "SW_Run.h"
+#include "SW_Batch.h"
+#include "SW_Sweep.h"
 #include "SW_Main_lib.c"
 
 
 static void check_log(void);
 
+/** Simulation run context of SOILWAT2-standalone */
+static SW_RUN sw_run;
+
+static int run_batch(void);
+static int run_sweep(void);
+static int convert_weather(void);
+static void create_output_store(const char *const *sites, unsigned int n_sites);
+
+
 
 static void check_log(void) {
 	/* =================================================== */
@@ -43,6 +82,8 @@ static void check_log(void) {
 	 * to execute before termination.  This is the place to
 	 * do any cleanup or progress reporting.
 	 */
+	SW_TRC_close(); // complete the trace, also after a fatal error
+
 	if (logfp != stdout && logfp != stderr) {
 		if (logged && !QuietMode)
 			sw_error(0, "\nCheck logfile for error or status messages.\n");
@@ -51,6 +92,164 @@ static void check_log(void) {
 
 }
 
+/** Create the HDF5 output file of all sites (option -o h5)
+
+@param sites Name of each site.
+@param n_sites Number of sites.
+*/
+static void create_output_store(const char *const *sites, unsigned int n_sites) {
+	const char *msg;
+
+	// a checkpoint cannot restore the outputs that a run holds in memory
+	if (Checkpoint.every_years > 0 || Checkpoint.every_seconds > 0 ||
+		Checkpoint.resume) {
+		LogError(logfp, LOGFATAL,
+			"Checkpoints (-c, -r) are not available with HDF5 output (-o h5).");
+	}
+
+	msg = SW_OUT_hdf_create(SW_OUT_HDF_FILENAME, sites, n_sites);
+	if (!isnull(msg)) {
+		LogError(logfp, LOGFATAL, "%s : %s", SW_OUT_HDF_FILENAME, msg);
+	}
+}
+
+/** Simulate all sites of the manifest `_batchfile` (option -b)
+
+With MPI (`make bin_mpi`), sites are distributed across the ranks, see
+`SW_BAT_run_mpi()`, and rank 0 prints the summary.
+
+@return Exit status: 0 if all sites were successfully simulated.
+*/
+static int run_batch(void) {
+	SW_BATCH batch;
+	unsigned int i, n_failed;
+	const char **sites;
+	#ifdef SW_MPI
+	int rank;
+	#endif
+
+	if (OutputSummary) {
+		LogError(logfp, LOGFATAL,
+			"Summary statistics (-o summary) are not available in batch mode.");
+	}
+
+	// sites in lanes are simulated in lock-step by the thread that sets them up
+	if (BatchLanes && (Checkpoint.every_years > 0 ||
+		Checkpoint.every_seconds > 0 || Checkpoint.resume)) {
+		LogError(logfp, LOGFATAL,
+			"Checkpoints (-c, -r) are not available with lanes (-l).");
+	}
+	if (BatchLanes && BatchReaders > 0) {
+		LogError(logfp, LOGFATAL,
+			"Reader threads (-i) are not available with lanes (-l).");
+	}
+
+	SW_BAT_read_manifest(&batch, _batchfile);
+	batch.preload_weather = PreloadWeather;
+	batch.n_readers = BatchReaders;
+	batch.out_format = OutputFormat;
+	batch.checkpoint = Checkpoint;
+	batch.log_diagnostics = LogDiagnostics;
+	batch.pin_threads = PinThreads;
+	batch.lanes = BatchLanes;
+	if (*_metricsfile) {
+		batch.metrics_file = _metricsfile;
+	}
+
+	// sites are rows of the HDF5 output file in the order of the manifest
+	if (OutputFormat & SW_OUTFORMAT_HDF) {
+		#ifdef SW_MPI
+		LogError(logfp, LOGFATAL,
+			"HDF5 output (-o h5) is not available with MPI.");
+		#endif
+		sites = (const char **) Mem_Malloc(
+			max(batch.n_sites, 1u) * sizeof(char *), "run_batch()");
+		for (i = 0; i < batch.n_sites; i++) {
+			sites[i] = batch.sites[i].firstfile;
+		}
+		create_output_store(sites, batch.n_sites);
+		Mem_Free(sites);
+	}
+
+	#ifdef SW_MPI
+	rank = SW_BAT_run_mpi(&batch, BatchThreads);
+	if (0 == rank) {
+		SW_BAT_print_summary(&batch);
+	}
+	#else
+	SW_BAT_run(&batch, BatchThreads);
+	SW_BAT_print_summary(&batch);
+	#endif
+
+	n_failed = batch.n_failed;
+	SW_BAT_deconstruct(&batch);
+	SW_WTH_grid_close();
+	SW_OUT_hdf_close();
+
+	return (n_failed > 0) ? EXIT_FAILURE : 0;
+}
+
+/** Simulate all variants of the design `_sweepfile` of the site `_firstfile` (option -s)
+
+@return Exit status: 0 if all variants were successfully simulated.
+*/
+static int run_sweep(void) {
+	SW_SWEEP sweep;
+	unsigned int n_failed;
+
+	if (Checkpoint.every_years > 0 || Checkpoint.every_seconds > 0 ||
+		Checkpoint.resume) {
+		LogError(logfp, LOGFATAL,
+			"Checkpoints (-c, -r) are not available with sweeps (-s).");
+	}
+
+	SW_SWP_read_design(&sweep, _sweepfile);
+	SW_SWP_run(&sweep, _firstfile, BatchThreads);
+	SW_SWP_write_results(&sweep, SW_SWEEP_FILENAME);
+
+	SW_SWP_print_summary(&sweep);
+
+	n_failed = sweep.n_failed;
+	SW_SWP_deconstruct(&sweep);
+	SW_WTH_grid_close();
+
+	return (n_failed > 0) ? EXIT_FAILURE : 0;
+}
+
+/** Convert the weather input files of `_firstfile` into a binary weather store
+    and, if used, the files of measured soil moisture into a binary soil
+    moisture store (option -w)
+
+@return Exit status.
+*/
+static int convert_weather(void) {
+	char fname[MAX_FILENAMESIZE];
+	int n;
+
+	SW_CTL_setup_model(&sw_run, _firstfile);
+	SW_CTL_read_inputs_from_disk(&sw_run);
+
+	SW_WTH_store_name(fname, SW_Weather.name_prefix);
+	n = SW_WTH_write_store(fname, SW_Weather.yr.first, SW_Model.endyr);
+
+	if (!QuietMode) {
+		swprintf("Weather of %d years written to %s\n", n, fname);
+	}
+
+	if (SW_Soilwat.hist_use) {
+		SW_SWC_store_name(fname, SW_Soilwat.hist.file_prefix);
+		n = SW_SWC_write_store(fname, SW_Soilwat.hist.yr.first, SW_Model.endyr);
+
+		if (!QuietMode) {
+			swprintf("Soil moisture of %d years written to %s\n", n, fname);
+		}
+	}
+
+	SW_CTL_clear_model(&sw_run, swTRUE);
+
+	return 0;
+}
+
 /************  Main() ************************/
 
 /**
@@ -59,40 +258,126 @@ static void check_log(void) {
 */
 int main(int argc, char **argv) {
 	/* =================================================== */
+	SW_OUT_SUMMARY summary;
+	const char *sites[1];
+	#ifdef SW_MPI
+	int rank, provided, status;
+	#endif
 
 	logged = swFALSE;
 	atexit(check_log);
 	logfp = stdout;
 
+	#ifdef SW_MPI
+	MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	#endif
+
 	init_args(argc, argv);
 
+	#ifdef SW_MPI
+	// only batch mode is distributed; rank 0 speaks for all ranks
+	if (!*_batchfile) {
+		LogError(logfp, LOGFATAL, "SOILWAT2 with MPI requires batch mode (option -b)");
+	}
+	if (rank > 0) {
+		QuietMode = swTRUE;
+	}
+	#endif
+
 	// Print version if not in quiet mode
 	if (!QuietMode) {
 		print_version();
 	}
 
+	if (*_tracefile) {
+		SW_TRC_open(_tracefile);
+	}
+
+	// batch mode: each site is simulated with its own run context
+	#ifdef SW_MPI
+	status = run_batch();
+	MPI_Finalize();
+	return status;
+	#else
+	if (*_batchfile) {
+		return run_batch();
+	}
+	#endif
+
+	if (*_metricsfile) {
+		LogError(logfp, LOGFATAL, "Metrics (option -m) require batch mode (option -b)");
+	}
+	if (PinThreads) {
+		LogError(logfp, LOGFATAL, "Pinning threads (option -n) requires batch mode (option -b)");
+	}
+	if (BatchLanes) {
+		LogError(logfp, LOGFATAL, "Lanes (option -l) require batch mode (option -b)");
+	}
+
+	// sweep: each worker thread simulates variants of the site with its own run context
+	if (*_sweepfile) {
+		return run_sweep();
+	}
+
+	// all memory of the run is freed at once by SW_CTL_clear_model()
+	sw_run.Arena.use = swTRUE;
+	sw_run.Checkpoint = Checkpoint;
+
+	if (ConvertWeather) {
+		return convert_weather();
+	}
+
+	SW_TRC_START(setup);
+
   // setup and construct model (independent of inputs)
-	SW_CTL_setup_model(_firstfile);
+	SW_CTL_setup_model(&sw_run, _firstfile);
 
 	// read user inputs
-	SW_CTL_read_inputs_from_disk();
+	SW_CTL_read_inputs_from_disk(&sw_run);
+	SW_Weather.preload_all_years = PreloadWeather;
+	SW_OUT_set_format(OutputFormat);
+
+	// the outputs of the run are a single site of a HDF5 output file (-o h5)
+	if (OutputFormat & SW_OUTFORMAT_HDF) {
+		sites[0] = _firstfile;
+		create_output_store(sites, 1);
+		SW_OUT_hdf_attach(0);
+	}
+
+	// summary statistics are reduced while the run progresses (-o summary)
+	if (OutputSummary) {
+		SW_OUT_init_summary(&summary, 1.);
+		SW_OUT_add_summary(&summary);
+	}
 
 	// initialize simulation run (based on user inputs)
-	SW_CTL_init_run();
+	SW_CTL_init_run(&sw_run);
 
   // initialize output
 	SW_OUT_set_ncol();
 	SW_OUT_set_colnames();
-	SW_OUT_create_files(); // only used with SOILWAT2
+	SW_TRC_STOP_STR(setup, "site setup", "setup", "site", _firstfile);
+
+  // create (or continue) output files, run simulation: loop through each
+  // year and write checkpoints (options -c and -r), and finish-up output
+	SW_CKP_run(); // only used with SOILWAT2 (text and binary output)
 
-  // run simulation: loop through each year
-	SW_CTL_main();
+	if (OutputSummary) {
+		SW_OUT_write_summary(stdout, &summary);
+	}
 
-  // finish-up output
-	SW_OUT_close_files(); // not used with rSOILWAT2
+	// per-phase breakdown of a profiling build (`make bin_profile`)
+	SW_PROFILE_REPORT();
+
+	if (LogDiagnostics) {
+		SW_FLW_log_diagnostics();
+	}
 
 	// de-allocate all memory
-	SW_CTL_clear_model(swTRUE);
+	SW_CTL_clear_model(&sw_run, swTRUE);
+	SW_WTH_grid_close();
+	SW_OUT_hdf_close();
 
 	return 0;
 }
@@ -29,6 +29,10 @@
 #include "SW_Control.h"
 #include "SW_Site.h"
 #include "SW_Weather.h"
+#include "SW_Output.h"
+#include "SW_Output_outbin.h"
+#include "SW_Checkpoint.h"
+#include "SW_Flow_lanes.h"
 
 /* =================================================== */
 /*                  Global Declarations                */
@@ -36,10 +40,9 @@
 /* --------------------------------------------------- */
 
 /* see generic.h and filefuncs.h for more info on these vars */
-char inbuf[MAX_FILENAMESIZE]; /* buffer used by input statements */
-char errstr[MAX_ERROR]; /* used to compose an error msg    */
-FILE *logfp; /* file handle for logging messages */
-int logged; /* boolean: true = we logged a msg */
+SW_THREAD_LOCAL char errstr[MAX_ERROR]; /* used to compose an error msg    */
+SW_THREAD_LOCAL FILE *logfp; /* file handle for logging messages */
+SW_THREAD_LOCAL int logged; /* boolean: true = we logged a msg */
 /* if true, write indicator to stderr */
 
 Bool QuietMode, EchoInits; /* if true, echo inits to logfile */
@@ -61,14 +64,66 @@ static void print_usage(void) {
 	swprintf(
 		"Ecosystem water simulation model SOILWAT2\n"
 		"More details at https://github.com/Burke-Lauenroth-Lab/SOILWAT2\n"
-		"Usage: ./SOILWAT2 [-d startdir] [-f files.in] [-e] [-q] [-v] [-h]\n"
+		"Usage: ./SOILWAT2 [-d startdir] [-f files.in] [-b manifest [-j n] [-i n] [-m metrics] [-n] [-l]] [-s design [-j n]] [-p] [-w] [-o format] [-a] [-c n[s]] [-r] [-g] [-t trace] [-e] [-q] [-v] [-h]\n"
 		"  -d : operate (chdir) in startdir (default=.)\n"
 		"  -f : name of main input file (default=files.in)\n"
 		"       a preceeding path applies to all input files\n"
+		"  -b : batch mode: simulate each site listed in the manifest file\n"
+		"       (one site directory or path to files.in per line);\n"
+		"       outputs are written relative to each site's directory\n"
+		"  -j : number of threads for batch mode and sweeps (default=number of\n"
+		"       processors)\n"
+		"  -i : number of threads for batch mode that read and set up upcoming\n"
+		"       sites while the other threads simulate (default=0: each thread\n"
+		"       sets up the sites that it simulates)\n"
+		"  -m : batch mode: write live metrics of the threads (sites by state,\n"
+		"       simulated years and days, output bytes, setup and busy times)\n"
+		"       in the Prometheus text format to the file metrics every 5 s\n"
+		"  -n : batch mode: pin threads to CPUs, spread across the NUMA nodes;\n"
+		"       each node holds the inputs of the sites that its threads simulate\n"
+		"  -l : batch mode: simulate sites with the same simulated days and number\n"
+		"       of soil layers together, up to %d at a time, with their percolation\n"
+		"       in lanes (not with -c, -r, or -i)\n"
+		"  -s : sweep: simulate each variant of the site of -f that the design\n"
+		"       file lists (a header line of parameter names, e.g., swc_min,\n"
+		"       RmeltMax, trco_grass[1], SWPcrit_shrub, then one line of values\n"
+		"       per variant) and write summary statistics of all variants (as\n"
+		"       -o summary) to sw2_sweep.csv in the working directory\n"
+		"  -p : preload the weather of all years into memory before the simulation\n"
+		"  -w : convert the weather input files into a binary weather store\n"
+		"       ([weather-file prefix].bin) and, if used, the files of measured\n"
+		"       soil moisture into a binary store ([swc prefix].bin) that are\n"
+		"       used by later runs, and exit\n"
+		"  -o : output format: 'csv' (text, default), 'bin' (binary columnar\n"
+		"       files with extension .bin instead of .csv), 'both', 'none'\n"
+		"       (no output, e.g., to benchmark the simulation), 'summary'\n"
+		"       (no output files; print summary statistics of the run, e.g.,\n"
+		"       mean annual AET, deep drainage, and the distribution of\n"
+		"       available soil water, for calibrations; not with -b), or 'h5'\n"
+		"       (outputs of all sites in one HDF5 file sw2_output.h5 in the\n"
+		"       working directory; requires HDF5, not with -c or -r), or 'map'\n"
+		"       (output arrays of the full run that are memory-mapped binary\n"
+		"       files, one per output key and time step, e.g., sw2_daily_SWC.bin,\n"
+		"       for runs whose outputs exceed memory; not with -c or -r), or\n"
+		"       'digest' (no output files; count, sum, min, max, and a hash of\n"
+		"       the values of each output key and time step in sw2_digest.csv\n"
+		"       next to the outputs, e.g., to compare versions; not with -c or -r)\n"
+		"  -a : write csv files with a separate writer thread\n"
+		"  -c : write a checkpoint (sw2_checkpoint.bin next to the outputs)\n"
+		"       every n simulated years, or with suffix 's' at the end of the\n"
+		"       first year that ends n seconds after the previous checkpoint\n"
+		"  -r : resume: continue each run after its checkpoint (if any) and\n"
+		"       append to its output files, e.g., after the run was killed\n"
+		"  -g : write solver diagnostics of each run to its logfile, e.g.,\n"
+		"       time step halvings of soil temperature and water-limited fluxes\n"
+		"  -t : write a trace of sites, setup, simulated years, input reads,\n"
+		"       and output flushes of all threads (Chrome trace event format,\n"
+		"       e.g., for https://ui.perfetto.dev) to the file trace\n"
 		"  -e : echo initial values from site and estab to logfile\n"
 		"  -q : quiet mode, don't print message to check logfile\n"
 		"  -v : print version information\n"
-		"  -h : print this help information\n"
+		"  -h : print this help information\n",
+		SW_LANES
 	);
 }
 
@@ -88,6 +143,20 @@ void print_version(void) {
 
 
 char _firstfile[MAX_FILENAMESIZE];
+char _batchfile[MAX_FILENAMESIZE]; /* manifest of sites for batch mode; empty if not in batch mode */
+char _tracefile[MAX_FILENAMESIZE]; /* trace file, see SW_TRC_open(); empty if not traced */
+char _metricsfile[MAX_FILENAMESIZE]; /* live metrics of batch mode, see SW_BAT_run(); empty if none */
+char _sweepfile[MAX_FILENAMESIZE]; /* design of a sweep, see SW_SWP_read_design(); empty if not a sweep */
+unsigned int BatchThreads; /* number of threads for batch mode; 0 = number of processors */
+unsigned int BatchReaders; /* number of threads that set up sites ahead of the batch threads; 0 = none */
+Bool ConvertWeather; /* if true, convert weather input files to a binary weather store */
+Bool PreloadWeather; /* if true, preload weather of all years, see SW_WTH_preload() */
+int OutputFormat; /* output format(s), see SW_OUT_set_format() */
+Bool OutputSummary; /* if true, print summary statistics of the run, see SW_OUT_add_summary() */
+SW_CHECKPOINT Checkpoint; /* checkpoints of each run, see SW_CKP_run() */
+Bool LogDiagnostics; /* if true, log solver diagnostics of each run, see SW_FLW_log_diagnostics() */
+Bool PinThreads; /* if true, pin the threads of batch mode to CPUs across the NUMA nodes */
+Bool BatchLanes; /* if true, simulate sites of batch mode together in lanes, see SW_BAT_run() */
 
 /**
 @brief Initializes arguments and sets indicators/variables based on results.
@@ -110,19 +179,52 @@ void init_args(int argc, char **argv) {
 	 *                -f=chg deflt first file <opt=file.in>
 	 *                -q=quiet, don't print "Check logfile"
 	 *                   at end of program.
+	 * 2026-10-14 - added -b=batch mode <opt=manifest>
+	 *                and -j=number of batch threads <opt=n>
+	 *              - added -w=convert weather to binary store
+	 * 2026-10-15 - -w also converts measured soil moisture to a binary store
+	 *              - added -p=preload weather of all years
+	 *              - added -o=output format <opt=csv|bin|both>
+	 * 2026-10-15 - added -a=asynchronous writing of csv files
+	 *            - added -c=checkpoints <opt=n years|ns seconds>
+	 *              and -r=resume from checkpoints
+	 *            - added -g=log solver diagnostics
+	 *            - added -t=trace <opt=file>
+	 *            - added -o none and -o summary
+	 *            - added -o h5
+	 *            - added -i=number of batch reader threads <opt=n>
+	 *            - added -m=batch metrics <opt=file>
+	 *            - added -n=pin batch threads across NUMA nodes
+	 *            - added -s=sweep <opt=design>
+	 *            - added -o map
+	 *            - added -o digest
+	 *            - added -l=batch sites in lanes
 	 */
 	char str[1024];
-	char const *opts[] = { "-d", "-f", "-e", "-q", "-v", "-h" }; /* valid options */
-	int valopts[] = { 1, 1, 0, 0, 0, 0 }; /* indicates options with values */
+	char const *opts[] = { "-d", "-f", "-e", "-q", "-v", "-h", "-b", "-j", "-w", "-p", "-o", "-a", "-c", "-r", "-g", "-t", "-i", "-m", "-n", "-s", "-l" }; /* valid options */
+	int valopts[] = { 1, 1, 0, 0, 0, 0, 1, 1, 0, 0, 1, 0, 1, 0, 0, 1, 1, 1, 0, 1, 0 }; /* indicates options with values */
 	/* 0=none, 1=required, -1=optional */
 	int i, /* looper through all cmdline arguments */
 	a, /* current valid argument-value position */
 	op, /* position number of found option */
 	nopts = sizeof(opts) / sizeof(char *);
+	Bool async_output = swFALSE; /* independent of the order of -o and -a */
+	long n; /* value of -c */
+	char *end; /* unit of -c */
 
 	/* Defaults */
 	strcpy(_firstfile, DFLT_FIRSTFILE);
-	QuietMode = EchoInits = swFALSE;
+	*_batchfile = '\0';
+	*_tracefile = '\0';
+	*_metricsfile = '\0';
+	*_sweepfile = '\0';
+	BatchThreads = 0;
+	BatchReaders = 0;
+	OutputFormat = SW_OUTFORMAT_CSV;
+	OutputSummary = swFALSE;
+	QuietMode = EchoInits = ConvertWeather = PreloadWeather = LogDiagnostics = swFALSE;
+	PinThreads = BatchLanes = swFALSE;
+	memset(&Checkpoint, 0, sizeof Checkpoint);
 
 	a = 1;
 	for (i = 1; i <= nopts; i++) {
@@ -137,6 +239,7 @@ void init_args(int argc, char **argv) {
 		if (op == nopts) {
       print_usage();
       sw_error(-1, "\nInvalid option %s\n", argv[a]);
+      return; // not reached: sw_error() exits
 		}
 
 		*str = '\0';
@@ -185,6 +288,99 @@ void init_args(int argc, char **argv) {
 				sw_error(-1, "");
 				break;
 
+			case 6: /* -b */
+				strcpy(_batchfile, str);
+				break;
+
+			case 7: /* -j */
+				if (atoi(str) < 1) {
+					LogError(logfp, LOGFATAL, "Invalid number of threads (%s)", str);
+				}
+				BatchThreads = (unsigned int) atoi(str);
+				break;
+
+			case 8: /* -w */
+				ConvertWeather = swTRUE;
+				break;
+
+			case 9: /* -p */
+				PreloadWeather = swTRUE;
+				break;
+
+			case 10: /* -o */
+				if (0 == strcmp(str, "csv")) {
+					OutputFormat = SW_OUTFORMAT_CSV;
+				} else if (0 == strcmp(str, "bin")) {
+					OutputFormat = SW_OUTFORMAT_BIN;
+				} else if (0 == strcmp(str, "both")) {
+					OutputFormat = SW_OUTFORMAT_CSV | SW_OUTFORMAT_BIN;
+				} else if (0 == strcmp(str, "none")) {
+					OutputFormat = SW_OUTFORMAT_NONE;
+				} else if (0 == strcmp(str, "summary")) {
+					OutputFormat = SW_OUTFORMAT_NONE;
+					OutputSummary = swTRUE;
+				} else if (0 == strcmp(str, "h5")) {
+					OutputFormat = SW_OUTFORMAT_HDF;
+				} else if (0 == strcmp(str, "map")) {
+					OutputFormat = SW_OUTFORMAT_MAP;
+				} else if (0 == strcmp(str, "digest")) {
+					OutputFormat = SW_OUTFORMAT_DIGEST;
+				} else {
+					LogError(logfp, LOGFATAL, "Invalid output format (%s)", str);
+				}
+				break;
+
+			case 11: /* -a */
+				async_output = swTRUE;
+				break;
+
+			case 12: /* -c */
+				n = strtol(str, &end, 10);
+				if (n < 1 || (0 != strcmp(end, "") && 0 != strcmp(end, "s"))) {
+					LogError(logfp, LOGFATAL, "Invalid checkpoint interval (%s)", str);
+				}
+				if ('s' == *end) {
+					Checkpoint.every_seconds = (unsigned int) n;
+				} else {
+					Checkpoint.every_years = (TimeInt) n;
+				}
+				break;
+
+			case 13: /* -r */
+				Checkpoint.resume = swTRUE;
+				break;
+
+			case 14: /* -g */
+				LogDiagnostics = swTRUE;
+				break;
+
+			case 15: /* -t */
+				strcpy(_tracefile, str);
+				break;
+
+			case 16: /* -i */
+				if (atoi(str) < 0) {
+					LogError(logfp, LOGFATAL, "Invalid number of reader threads (%s)", str);
+				}
+				BatchReaders = (unsigned int) atoi(str);
+				break;
+
+			case 17: /* -m */
+				strcpy(_metricsfile, str);
+				break;
+
+			case 18: /* -n */
+				PinThreads = swTRUE;
+				break;
+
+			case 19: /* -s */
+				strcpy(_sweepfile, str);
+				break;
+
+			case 20: /* -l */
+				BatchLanes = swTRUE;
+				break;
+
 			default:
 				LogError(
 					logfp,
@@ -197,4 +393,16 @@ void init_args(int argc, char **argv) {
 
 	} /* end for(i) */
 
+	if (async_output) {
+		OutputFormat |= SW_OUTFORMAT_ASYNC;
+	}
+
+	// a checkpoint cannot restore the output arrays or the digest of a run
+	if ((OutputFormat & (SW_OUTFORMAT_MAP | SW_OUTFORMAT_DIGEST)) &&
+		(Checkpoint.every_years > 0 || Checkpoint.every_seconds > 0 ||
+		Checkpoint.resume)) {
+		LogError(logfp, LOGFATAL,
+			"Checkpoints (-c, -r) are not available with -o map or -o digest.");
+	}
+
 }
@@ -11,6 +11,11 @@
  *    12/02 - IMPORTANT CHANGE - cwb
  *          refer to comments in Times.h regarding base0
  06/27/2013	(drs)	closed open files if LogError() with LOGFATAL is called in SW_MKV_read_prob(), SW_MKV_read_cov()
+ 2026-10-14	added SW_MKV_generate_year() and SW_MKV_generate_years() which generate
+ 						whole years of weather from per-site and per-replicate random
+ 						number streams (see SW_MKV_seed_stream())
+ 2026-10-15	SW_MKV_read_prob() and SW_MKV_read_cov() read with SW_TEXTFILE and Str_Scan()
+ 2026-10-15	runs of a batch share the parameters of identical input files (see SW_Shared.c)
  */
 /********************************************************/
 /********************************************************/
@@ -33,26 +38,125 @@
 #include "SW_Weather.h"
 #include "SW_Model.h"
 #include "SW_Markov.h"
+#include "SW_Run.h"
 #include "pcg/pcg_basic.h"
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_MODEL SW_Model;
-pcg32_random_t markov_rng;
-SW_MARKOV SW_Markov; /* declared here, externed elsewhere */
+// `markov_rng` is part of the simulation run context, see SW_Run.h
 
 /* =================================================== */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
 
-static char *MyFileName;
+static SW_THREAD_LOCAL char *MyFileName;
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** Parameters of `mkv_prob.in` that are shared by runs of a batch */
+typedef struct {
+	RealD wetprob[MAX_DAYS], dryprob[MAX_DAYS], avg_ppt[MAX_DAYS], std_ppt[MAX_DAYS];
+} SW_MKV_PROB;
+
+/** Parameters of `mkv_covar.in` that are shared by runs of a batch */
+typedef struct {
+	RealD u_cov[MAX_WEEKS][2], v_cov[MAX_WEEKS][2][2],
+		cfxw[MAX_DAYS], cfxd[MAX_DAYS], cfnw[MAX_DAYS], cfnd[MAX_DAYS];
+} SW_MKV_COV;
 
 /* =================================================== */
 /* =================================================== */
 /*             Private Function Definitions            */
 /* --------------------------------------------------- */
 
+/** Allocate the probability parameters of the run */
+static void alloc_prob(SW_MARKOV *m) {
+	size_t s = sizeof(RealD);
+
+	m->wetprob = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+	m->dryprob = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+	m->avg_ppt = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+	m->std_ppt = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+}
+
+/** Allocate the temperature correction factors of the run */
+static void alloc_cov(SW_MARKOV *m) {
+	size_t s = sizeof(RealD);
+
+	m->cfxw = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+	m->cfxd = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+	m->cfnw = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+	m->cfnd = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+}
+
+/** Point the probability parameters of the run to a shared table */
+static void share_prob(SW_MARKOV *m, const SW_MKV_PROB *t) {
+	m->wetprob = (RealD *) t->wetprob;
+	m->dryprob = (RealD *) t->dryprob;
+	m->avg_ppt = (RealD *) t->avg_ppt;
+	m->std_ppt = (RealD *) t->std_ppt;
+	m->shares_prob = swTRUE;
+}
+
+/** Point the temperature correction factors of the run to a shared table
+    and copy its means and covariances */
+static void share_cov(SW_MARKOV *m, const SW_MKV_COV *t) {
+	memcpy(m->u_cov, t->u_cov, sizeof m->u_cov);
+	memcpy(m->v_cov, t->v_cov, sizeof m->v_cov);
+	m->cfxw = (RealD *) t->cfxw;
+	m->cfxd = (RealD *) t->cfxd;
+	m->cfnw = (RealD *) t->cfnw;
+	m->cfnd = (RealD *) t->cfnd;
+	m->shares_cov = swTRUE;
+}
+
+/** Move the probability parameters that the run has read into a shared table */
+static void publish_prob(SW_MARKOV *m, const SW_SHARED_ID *id) {
+	SW_MKV_PROB *t;
+
+	if (isnull(t = (SW_MKV_PROB *) malloc(sizeof *t))) {
+		LogError(logfp, LOGFATAL, "SW_MKV_read_prob(): out of memory");
+	}
+
+	memcpy(t->wetprob, m->wetprob, sizeof t->wetprob);
+	memcpy(t->dryprob, m->dryprob, sizeof t->dryprob);
+	memcpy(t->avg_ppt, m->avg_ppt, sizeof t->avg_ppt);
+	memcpy(t->std_ppt, m->std_ppt, sizeof t->std_ppt);
+
+	Mem_Free(m->wetprob);
+	Mem_Free(m->dryprob);
+	Mem_Free(m->avg_ppt);
+	Mem_Free(m->std_ppt);
+
+	share_prob(m, (const SW_MKV_PROB *) SW_SHR_put(SW_CurrentRun->Shared, id, t));
+}
+
+/** Move the covariance parameters that the run has read into a shared table */
+static void publish_cov(SW_MARKOV *m, const SW_SHARED_ID *id) {
+	SW_MKV_COV *t;
+
+	if (isnull(t = (SW_MKV_COV *) malloc(sizeof *t))) {
+		LogError(logfp, LOGFATAL, "SW_MKV_read_cov(): out of memory");
+	}
+
+	memcpy(t->u_cov, m->u_cov, sizeof t->u_cov);
+	memcpy(t->v_cov, m->v_cov, sizeof t->v_cov);
+	memcpy(t->cfxw, m->cfxw, sizeof t->cfxw);
+	memcpy(t->cfxd, m->cfxd, sizeof t->cfxd);
+	memcpy(t->cfnw, m->cfnw, sizeof t->cfnw);
+	memcpy(t->cfnd, m->cfnd, sizeof t->cfnd);
+
+	Mem_Free(m->cfxw);
+	Mem_Free(m->cfxd);
+	Mem_Free(m->cfnw);
+	Mem_Free(m->cfnd);
+
+	share_cov(m, (const SW_MKV_COV *) SW_SHR_put(SW_CurrentRun->Shared, id, t));
+}
+
 /**
   @brief Adjust average maximum/minimum daily temperature for whether day is
          wet or dry
@@ -189,6 +293,34 @@ static void mvnorm(RealD *tmax, RealD *tmin, RealD wTmax, RealD wTmin,
 #endif
 
 
+/** Cholesky factors of the weekly covariance matrices of maximum and
+    minimum daily temperature, see `mvnorm()`
+
+    @param m Weather generator parameters.
+    @param sd Standard deviation of maximum temperature of each week.
+    @param vc10 Factor of the first normal variate for minimum temperature.
+    @param vc11 Factor of the second normal variate for minimum temperature.
+*/
+static void weekly_cholesky(SW_MARKOV *m, RealD sd[], RealD vc10[],
+	RealD vc11[]) {
+
+	TimeInt week;
+	RealD s;
+
+	for (week = 0; week < MAX_WEEKS; week++) {
+		sd[week] = sqrt(m->v_cov[week][0][0]);
+		vc10[week] = (GT(sd[week], 0.)) ? m->v_cov[week][1][0] / sd[week] : 0;
+		s = vc10[week] * vc10[week];
+
+		if (GT(s, m->v_cov[week][1][1])) {
+			LogError(logfp, LOGFATAL, "\nBad covariance matrix in week %d", week + 1);
+		}
+
+		vc11[week] = (EQ(m->v_cov[week][1][1], s)) ? 0. : sqrt(m->v_cov[week][1][1] - s);
+	}
+}
+
+
 
 /* =================================================== */
 /* =================================================== */
@@ -196,26 +328,26 @@ static void mvnorm(RealD *tmax, RealD *tmin, RealD wTmax, RealD wTmin,
 /* --------------------------------------------------- */
 /**
 @brief Markov constructor for global variables.
+
+A run that shares input tables with other runs of a batch allocates its
+parameters only if it is the first to read them, see SW_MKV_read_prob()
+and SW_MKV_read_cov().
 */
 void SW_MKV_construct(void) {
 	/* =================================================== */
 	SW_MARKOV *m = &SW_Markov;
-	size_t s = sizeof(RealD);
 
 	/* STEPWAT2: The markov_rng seed will be reset with `Globals.randseed` by
 		 its `main` at the beginning of each iteration */
 	RandSeed(0, &markov_rng);
 
 	m->ppt_events = 0;
+	m->shares_prob = m->shares_cov = swFALSE;
 
-	m->wetprob = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
-	m->dryprob = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
-	m->avg_ppt = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
-	m->std_ppt = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
-	m->cfxw = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
-	m->cfxd = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
-	m->cfnw = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
-	m->cfnd = (RealD *) Mem_Calloc(MAX_DAYS, s, "SW_MKV_construct");
+	if (isnull(SW_CurrentRun->Shared)) {
+		alloc_prob(m);
+		alloc_cov(m);
+	}
 }
 
 /**
@@ -223,6 +355,17 @@ void SW_MKV_construct(void) {
 */
 void SW_MKV_deconstruct(void)
 {
+	if (SW_Markov.shares_prob) {
+		SW_Markov.wetprob = SW_Markov.dryprob = NULL;
+		SW_Markov.avg_ppt = SW_Markov.std_ppt = NULL;
+		SW_Markov.shares_prob = swFALSE;
+	}
+
+	if (SW_Markov.shares_cov) {
+		SW_Markov.cfxw = SW_Markov.cfxd = SW_Markov.cfnw = SW_Markov.cfnd = NULL;
+		SW_Markov.shares_cov = swFALSE;
+	}
+
 	if (!isnull(SW_Markov.wetprob)) {
 		Mem_Free(SW_Markov.wetprob);
 		SW_Markov.wetprob = NULL;
@@ -332,16 +475,138 @@ void SW_MKV_today(TimeInt doy0, RealD *tmax, RealD *tmin, RealD *rain) {
 	#endif
 
 }
+/**
+@brief Seed a random number generator for the weather of one site and
+  replicate of an ensemble
+
+The generated weather depends only on `seed`, `site`, and `replicate`
+(see `RandSeedStream()`) which makes ensembles reproducible if sites and
+replicates are simulated in parallel.
+
+@param rng The random number generator to set.
+@param seed The initial state of the generator, e.g., shared by an ensemble.
+@param site Index of the site (< 2^31).
+@param replicate Index of the replicate of the site.
+*/
+void SW_MKV_seed_stream(pcg32_random_t *rng, uint64_t seed, uint32_t site,
+	uint32_t replicate) {
+
+	RandSeedStream(seed, ((uint64_t) site << 32) | replicate, rng);
+}
+
+
+/**
+@brief Generate daily weather of one year
+
+All random variates of the year are drawn at once (one uniform and three
+normal variates per day whether a day is wet or not) and are transformed
+into daily weather in loops over days; only the occurrence of precipitation
+depends on the previous day. The same parameters as `SW_MKV_today()` are
+used, but the sequence of weather differs from that of calling
+`SW_MKV_today()` for each day.
+
+@param m Weather generator parameters, e.g., `&SW_Markov`; not modified
+  (and may be shared among threads).
+@param rng The random number generator, e.g., see `SW_MKV_seed_stream()`.
+@param year The calendar year.
+@param[in,out] rain Precipitation of the day before the year (cm); upon
+  return, precipitation of the last day of the year.
+@param[out] tmax Maximum temperature (&deg;C) of each day (at least
+  `MAX_DAYS` elements).
+@param[out] tmin Minimum temperature (&deg;C) of each day.
+@param[out] ppt Precipitation (cm) of each day.
+
+@return The number of days of `year`.
+*/
+TimeInt SW_MKV_generate_year(SW_MARKOV *m, pcg32_random_t *rng,
+	TimeInt year, RealD *rain, RealD tmax[], RealD tmin[], RealD ppt[]) {
+
+	TimeInt doy0, week, n = Time_get_lastdoy_y(year);
+	RealD
+		u[MAX_DAYS], z[3 * MAX_DAYS], *zp = z, *z1 = z + n, *z2 = z + 2 * n,
+		sd[MAX_WEEKS], vc10[MAX_WEEKS], vc11[MAX_WEEKS],
+		prob, x, cfmax, cfmin;
+
+	weekly_cholesky(m, sd, vc10, vc11);
+
+	// Random variates of the year
+	for (doy0 = 0; doy0 < n; doy0++) {
+		u[doy0] = RandUni(rng);
+	}
+	RandNormList(3 * (long) n, 0., 1., z, rng);
+
+	// Precipitation: occurrence depends on yesterday
+	for (doy0 = 0; doy0 < n; doy0++) {
+		prob = (GT(*rain, 0.0)) ? m->wetprob[doy0] : m->dryprob[doy0];
+		x = fmax(0., m->avg_ppt[doy0] + m->std_ppt[doy0] * zp[doy0]);
+		*rain = (LE(u[doy0], prob)) ? x : 0.;
+		ppt[doy0] = *rain;
+	}
+
+	// Temperature: see `mvnorm()` and `temp_correct_wetdry()`
+	for (doy0 = 0; doy0 < n; doy0++) {
+		week = doy2week(doy0 + 1);
+
+		tmax[doy0] = sd[week] * z1[doy0] + m->u_cov[week][0];
+		tmin[doy0] = fmin(tmax[doy0],
+			vc10[week] * z1[doy0] + vc11[week] * z2[doy0] + m->u_cov[week][1]);
+
+		cfmax = (GT(ppt[doy0], 0.)) ? m->cfxw[week] : m->cfxd[week];
+		cfmin = (GT(ppt[doy0], 0.)) ? m->cfnw[week] : m->cfnd[week];
+		tmax[doy0] += cfmax;
+		tmin[doy0] = fmin(tmax[doy0], tmin[doy0] + cfmin);
+	}
+
+	return n;
+}
+
+
+/**
+@brief Generate daily weather of consecutive years, see `SW_MKV_generate_year()`
+
+@param m Weather generator parameters, e.g., `&SW_Markov`.
+@param rng The random number generator, e.g., see `SW_MKV_seed_stream()`.
+@param startyr The first calendar year.
+@param n_years The number of years.
+@param[out] tmax Maximum temperature (&deg;C) of each day of all years
+  (at least `n_years * MAX_DAYS` elements); the days of a year follow
+  immediately after the last day of the previous year.
+@param[out] tmin Minimum temperature (&deg;C) of each day.
+@param[out] ppt Precipitation (cm) of each day.
+
+@return The number of generated days.
+*/
+size_t SW_MKV_generate_years(SW_MARKOV *m, pcg32_random_t *rng,
+	TimeInt startyr, TimeInt n_years, RealD tmax[], RealD tmin[], RealD ppt[]) {
+
+	TimeInt yr;
+	RealD rain = 0.;
+	size_t n = 0;
+
+	for (yr = startyr; yr < startyr + n_years; yr++) {
+		n += SW_MKV_generate_year(m, rng, yr, &rain, tmax + n, tmin + n, ppt + n);
+	}
+
+	return n;
+}
+
+
 /**
 @brief Reads prob file in and checks input variables for errors, then stores files in SW_Markov.
 
+A run that shares input tables with other runs of a batch points to the
+parameters of an identical file that another run has read.
+
 @return swTRUE Returns true if prob file is correctly opened and closed.
 */
 Bool SW_MKV_read_prob(void) {
 	/* =================================================== */
 	SW_MARKOV *v = &SW_Markov;
+	SW_SHARED_INPUTS *shared = SW_CurrentRun->Shared;
+	SW_SHARED_ID id;
+	const SW_MKV_PROB *t;
 	const int nitems = 5;
-	FILE *f;
+	SW_TEXTFILE f;
 	int lineno = 0, day, x, msg_type = 0;
 	char msg[200]; // error message
 	RealF wet, dry, avg, std;
@@ -349,14 +614,29 @@ Bool SW_MKV_read_prob(void) {
 	/* note that Files.read() must be called prior to this. */
 	MyFileName = SW_F_name(eMarkovProb);
 
-	if (NULL == (f = fopen(MyFileName, "r")))
+	if (!ReadTextFile(&f, MyFileName))
 		return swFALSE;
 
-	while (GetALine(f, inbuf)) {
+	if (!isnull(shared)) {
+		SW_SHR_id(&id, eMarkovProb, "", f.data);
+
+		if (!isnull(t = (const SW_MKV_PROB *) SW_SHR_get(shared, &id))) {
+			CloseTextFile(&f);
+			share_prob(v, t);
+			return swTRUE;
+		}
+
+		if (v->shares_prob || isnull(v->wetprob)) {
+			alloc_prob(v);
+			v->shares_prob = swFALSE;
+		}
+	}
+
+	while (GetATextLine(&f)) {
 		if (lineno++ == MAX_DAYS)
 			break; /* skip extra lines */
 
-		x = sscanf(inbuf, "%d %f %f %f %f",
+		x = Str_Scan(f.line, "%d %f %f %f %f",
 			&day, &wet, &dry, &avg, &std);
 
 		// Check that text file is ok:
@@ -398,7 +678,7 @@ Bool SW_MKV_read_prob(void) {
 		// If any input is bad, then close file and fail with message:
 		if (msg_type != 0)
 		{
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s", msg);
 		}
 
@@ -411,7 +691,11 @@ Bool SW_MKV_read_prob(void) {
 		v->std_ppt[day] = std; // std dev. for precip of wet days
 	}
 
-	CloseFile(&f);
+	CloseTextFile(&f);
+
+	if (!isnull(shared)) {
+		publish_prob(v, &id);
+	}
 
 	return swTRUE;
 }
@@ -419,27 +703,48 @@ Bool SW_MKV_read_prob(void) {
 /**
 @brief Reads cov file in and checks input variables for errors, then stores files in SW_Markov.
 
+A run that shares input tables with other runs of a batch points to the
+parameters of an identical file that another run has read.
+
 @return Returns true if cov file is correctly opened and closed.
 */
 Bool SW_MKV_read_cov(void) {
 	/* =================================================== */
 	SW_MARKOV *v = &SW_Markov;
+	SW_SHARED_INPUTS *shared = SW_CurrentRun->Shared;
+	SW_SHARED_ID id;
+	const SW_MKV_COV *t;
 	const int nitems = 11;
-	FILE *f;
+	SW_TEXTFILE f;
 	int lineno = 0, week, x, msg_type = 0;
 	char msg[200]; // error message
 	RealF t1, t2, t3, t4, t5, t6, cfxw, cfxd, cfnw, cfnd;
 
 	MyFileName = SW_F_name(eMarkovCov);
 
-	if (NULL == (f = fopen(MyFileName, "r")))
+	if (!ReadTextFile(&f, MyFileName))
 		return swFALSE;
 
-	while (GetALine(f, inbuf)) {
+	if (!isnull(shared)) {
+		SW_SHR_id(&id, eMarkovCov, "", f.data);
+
+		if (!isnull(t = (const SW_MKV_COV *) SW_SHR_get(shared, &id))) {
+			CloseTextFile(&f);
+			share_cov(v, t);
+			return swTRUE;
+		}
+
+		if (v->shares_cov || isnull(v->cfxw)) {
+			alloc_cov(v);
+			v->shares_cov = swFALSE;
+		}
+	}
+
+	while (GetATextLine(&f)) {
 		if (lineno++ == MAX_WEEKS)
 			break; /* skip extra lines */
 
-		x = sscanf(inbuf, "%d %f %f %f %f %f %f %f %f %f %f",
+		x = Str_Scan(f.line, "%d %f %f %f %f %f %f %f %f %f %f",
 			&week, &t1, &t2, &t3, &t4, &t5, &t6, &cfxw, &cfxd, &cfnw, &cfnd);
 
 		// Check that text file is ok:
@@ -488,7 +793,7 @@ Bool SW_MKV_read_cov(void) {
 		// If any input is bad, then close file and fail with message:
 		if (msg_type != 0)
 		{
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s", msg);
 		}
 
@@ -507,7 +812,11 @@ Bool SW_MKV_read_cov(void) {
 		v->cfnd[week] = cfnd;      // correction factor for tmin for dry days
 	}
 
-	CloseFile(&f);
+	CloseTextFile(&f);
+
+	if (!isnull(shared)) {
+		publish_cov(v, &id);
+	}
 
 	return swTRUE;
 }
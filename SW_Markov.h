@@ -7,12 +7,17 @@
  functions.
  History:
  (9/11/01) -- INITIAL CODING - cwb
+ (2026-10-14) added generation of whole years of weather with
+   per-site and per-replicate random number streams
+ (2026-10-15) parameters can be shared by the runs of a batch
  */
 /********************************************************/
 /********************************************************/
 #ifndef SW_MARKOV_H
 #define SW_MARKOV_H
 
+#include "rands.h" // for pcg32_random_t
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -35,6 +40,11 @@ typedef struct {
     v_cov[MAX_WEEKS][2][2]; /* covariance matrix */
   int ppt_events; /* number of ppt events generated this year */
 
+  /* TRUE if `wetprob` to `std_ppt` (`shares_prob`) or `cfxw` to `cfnd`
+     (`shares_cov`) point to tables that are shared with other runs of a
+     batch (see SW_Shared.c) and must not be changed */
+  Bool shares_prob, shares_cov;
+
 } SW_MARKOV;
 
 void SW_MKV_construct(void);
@@ -43,6 +53,12 @@ Bool SW_MKV_read_prob(void);
 Bool SW_MKV_read_cov(void);
 void SW_MKV_setup(void);
 void SW_MKV_today(TimeInt doy0, RealD *tmax, RealD *tmin, RealD *rain);
+void SW_MKV_seed_stream(pcg32_random_t *rng, uint64_t seed, uint32_t site,
+	uint32_t replicate);
+TimeInt SW_MKV_generate_year(SW_MARKOV *m, pcg32_random_t *rng,
+	TimeInt year, RealD *rain, RealD tmax[], RealD tmin[], RealD ppt[]);
+size_t SW_MKV_generate_years(SW_MARKOV *m, pcg32_random_t *rng,
+	TimeInt startyr, TimeInt n_years, RealD tmax[], RealD tmin[], RealD ppt[]);
 
 #ifdef DEBUG_MEM
 void SW_MKV_SetMemoryRefs( void);
@@ -23,6 +23,9 @@
  d = atoi(enddyval);
  m->endend = (d < 365) ? d : Time_get_lastdoy_y(m->endyr);
  06/27/2013	(drs)	closed open files if LogError() with LOGFATAL is called in SW_MDL_read()
+ 2026-10-15	SW_MDL_new_day() derives new months and weeks from the first days of
+ months and weeks of the calendar (Times.c) instead of tracking previous periods
+ 2026-10-15	SW_MDL_read() reads years.in with SW_TEXTFILE
  */
 /********************************************************/
 /********************************************************/
@@ -48,24 +51,17 @@
 #include "SW_SoilWater.h"  /* for setup_new_year() */
 #include "SW_Times.h"
 #include "SW_Model.h"
+#include "SW_Run.h"
 
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_SITE SW_Site; /* for reset attribute */
-SW_MODEL SW_Model; /* declared here, externed elsewhere */
 
 /* =================================================== */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
-static char *MyFileName;
-
-/* these are set in _new_day() */
-static TimeInt _prevweek, /* check for new week */
-_prevmonth, /* check for new month */
-_prevyear, /* check for new year */
-_notime = 0xffff; /* init value for _prev* */
+static SW_THREAD_LOCAL char *MyFileName;
 
 /* =================================================== */
 /* =================================================== */
@@ -117,42 +113,42 @@ void SW_MDL_read(void) {
 	 *    starting year
 	 */
 	SW_MODEL *m = &SW_Model;
-	FILE *f;
+	SW_TEXTFILE f;
 	int y, cnt;
 	TimeInt d;
 	char *p, enddyval[6];
 	Bool fstartdy = swFALSE, fenddy = swFALSE, fhemi = swFALSE;
 
 	MyFileName = SW_F_name(eModel);
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
 
 	/* ----- beginning year */
-	if (!GetALine(f, inbuf)) {
-		CloseFile(&f);
+	if (!GetATextLine(&f)) {
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "%s: No input.", MyFileName);
 	}
-	y = atoi(inbuf);
+	y = atoi(f.line);
 	if (y < 0) {
-		CloseFile(&f);
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "%s: Negative start year (%d)", MyFileName, y);
 	}
 	m->startyr = yearto4digit((TimeInt) y);
 	m->addtl_yr = 0; // Could be done anywhere; SOILWAT2 runs don't need a delta year
 
 	/* ----- ending year */
-	if (!GetALine(f, inbuf)) {
-		CloseFile(&f);
+	if (!GetATextLine(&f)) {
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "%s: Ending year not found.", MyFileName);
 	}
-	y = atoi(inbuf);
+	y = atoi(f.line);
 	//assert(y > 0);
 	if (y < 0) {
-		CloseFile(&f);
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "%s: Negative ending year (%d)", MyFileName, y);
 	}
 	m->endyr = yearto4digit((TimeInt) y);
 	if (m->endyr < m->startyr) {
-		CloseFile(&f);
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "%s: Start Year > End Year", MyFileName);
 	}
 
@@ -162,20 +158,20 @@ void SW_MDL_read(void) {
 	 and assume they're not there.
 	 */
 	cnt = 0;
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 		cnt++;
-		if (isalpha(*inbuf) && strcmp(inbuf, "end")) { /* get hemisphere */
-			m->isnorth = (Bool) (toupper((int) *inbuf) == 'N');
+		if (isalpha(*f.line) && strcmp(f.line, "end")) { /* get hemisphere */
+			m->isnorth = (Bool) (toupper((int) *f.line) == 'N');
 			fhemi = swTRUE;
 			break;
 		}//TODO: SHOULDN'T WE SKIP THIS BELOW IF ABOVE IS swTRUE
 		switch (cnt) {
 		case 1:
-			m->startstart = atoi(inbuf);
+			m->startstart = atoi(f.line);
 			fstartdy = swTRUE;
 			break;
 		case 2:
-			p = inbuf;
+			p = f.line;
 			cnt = 0;
 			while (*p && cnt < 6) {
 				enddyval[cnt++] = tolower((int) *(p++));
@@ -184,7 +180,7 @@ void SW_MDL_read(void) {
 			fenddy = swTRUE;
 			break;
 		case 3:
-			m->isnorth = (Bool) (toupper((int) *inbuf) == 'N');
+			m->isnorth = (Bool) (toupper((int) *f.line) == 'N');
 			fhemi = swTRUE;
 			break;
 		default:
@@ -219,8 +215,41 @@ void SW_MDL_read(void) {
 	}
 
 	m->daymid = (m->isnorth) ? DAYMID_NORTH : DAYMID_SOUTH;
-	CloseFile(&f);
+	CloseTextFile(&f);
+
+}
+
+/**
+@brief Set the simulation period without an input file (see `SW_MDL_read()`
+  for the equivalent inputs from `years.in`)
+
+@param startyr First simulation year.
+@param endyr Last simulation year.
+@param startdoy First simulated day (base1) of `startyr`.
+@param enddoy Last simulated day (base1) of `endyr`;
+  0 is the last day of `endyr`.
+@param isnorth swTRUE if the site is located in the northern hemisphere.
+*/
+void SW_MDL_set_time(TimeInt startyr, TimeInt endyr, TimeInt startdoy,
+	TimeInt enddoy, Bool isnorth) {
+
+	SW_MODEL *m = &SW_Model;
 
+	if (endyr < startyr) {
+		LogError(logfp, LOGFATAL, "SW_MDL_set_time(): Start Year > End Year");
+	}
+
+	m->startyr = startyr;
+	m->endyr = endyr;
+	m->addtl_yr = 0;
+	m->isnorth = isnorth;
+
+	m->startstart = max(startdoy, 1);
+	m->endend = (0 == enddoy) ?
+		Time_get_lastdoy_y(endyr) :
+		min(enddoy, Time_get_lastdoy_y(endyr));
+
+	m->daymid = (m->isnorth) ? DAYMID_NORTH : DAYMID_SOUTH;
 }
 
 /**
@@ -234,8 +263,6 @@ void SW_MDL_new_year(void) {
 	SW_MODEL *m = &SW_Model;
 	TimeInt year = SW_Model.year;
 
-	_prevweek = _prevmonth = _prevyear = _notime;
-
 	Time_new_year(year);
 	SW_Model.simyear = SW_Model.year + SW_Model.addtl_yr;
 
@@ -249,6 +276,7 @@ void SW_MDL_new_year(void) {
 void SW_MDL_new_day(void) {
 
 	OutPeriod pd;
+	Bool notfirst;
 
 	SW_Model.month = doy2month(SW_Model.doy); /* base0 */
 	SW_Model.week = doy2week(SW_Model.doy); /* base0; more often an index */
@@ -264,17 +292,14 @@ void SW_MDL_new_day(void) {
 		return;
 	}
 
-	if (SW_Model.month != _prevmonth) {
-		SW_Model.newperiod[eSW_Month] = (_prevmonth != _notime) ? swTRUE : swFALSE;
-		_prevmonth = SW_Model.month;
-	} else
-		SW_Model.newperiod[eSW_Month] = swFALSE;
-
-	/*  if (SW_Model.week != _prevweek || SW_Model.month == NoMonth) { */
-	if (SW_Model.week != _prevweek) {
-		SW_Model.newperiod[eSW_Week] = (_prevweek != _notime) ? swTRUE : swFALSE;
-		_prevweek = SW_Model.week;
-	} else
-		SW_Model.newperiod[eSW_Week] = swFALSE;
+	/* a month (week) is new on its first day unless the simulation of the
+	 * year starts that day (there is no previous month or week to output) */
+	notfirst = (Bool) (SW_Model.doy != SW_Model.firstdoy);
+
+	SW_Model.newperiod[eSW_Month] = (Bool) (notfirst &&
+		SW_Model.doy == Time_first_doy_month(SW_Model.month));
+
+	SW_Model.newperiod[eSW_Week] = (Bool) (notfirst &&
+		SW_Model.doy == Time_first_doy_week(SW_Model.week));
 
 }
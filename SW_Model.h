@@ -53,6 +53,8 @@ typedef struct {
 } SW_MODEL;
 
 void SW_MDL_read(void);
+void SW_MDL_set_time(TimeInt startyr, TimeInt endyr, TimeInt startdoy,
+	TimeInt enddoy, Bool isnorth);
 void SW_MDL_construct(void);
 void SW_MDL_deconstruct(void);
 void SW_MDL_new_year(void);
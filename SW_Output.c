@@ -20,6 +20,8 @@
       a bit of work to keep track of the number of
       missing days, etc.
     - 2018 June 04 (drs) -- complete overhaul of output code
+    - 2026-10-15 output may be restricted to a window of calendar years
+      (`OUTYEARS`, see `SW_OUT_set_years()`), e.g., to skip spin-up years
 */
 /********************************************************/
 /********************************************************/
@@ -61,6 +63,14 @@
 #include "SW_Output_outtext.h"
 #endif
 
+// Binary output and asynchronous writer declarations:
+#ifdef SOILWAT
+#include "SW_Output_outbin.h"
+#include "SW_Output_outwriter.h"
+#endif
+
+#include "SW_Run.h"
+
 /* Note: `get_XXX` functions are declared in `SW_Output.h`
     and defined/implemented in 'SW_Output_get_functions.c"
 */
@@ -69,45 +79,20 @@
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_SITE SW_Site;
-extern SW_SOILWAT SW_Soilwat;
-extern SW_MODEL SW_Model;
-extern SW_WEATHER SW_Weather;
-extern SW_VEGPROD SW_VegProd;
-extern SW_VEGESTAB SW_VegEstab;
 extern Bool EchoInits;
-extern SW_CARBON SW_Carbon;
-
-
-SW_OUTPUT SW_Output[SW_OUTNKEYS];
-
-char _Sep; /* output delimiter */
-TimeInt tOffset; /* 1 or 0 means we're writing previous or current period */
 
 
-// Global variables describing output periods:
-/** `timeSteps` is the array that keeps track of the output time periods that
-    are required for `text` and/or `array`-based output for each output key. */
-OutPeriod timeSteps[SW_OUTNKEYS][SW_OUTNPERIODS];
-/** The number of different time steps/periods that are used/requested
-		Note: Under STEPWAT2, this may be larger than the sum of `use_OutPeriod`
-			because it also incorporates information from `timeSteps_SXW`. */
-IntUS used_OUTNPERIODS;
-/** TRUE if time step/period is active for any output key. */
-Bool use_OutPeriod[SW_OUTNPERIODS];
-
-
-// Global variables describing size and names of output
-/** names of output columns for each output key; number is an expensive guess */
-char *colnames_OUT[SW_OUTNKEYS][5 * NVEGTYPES + MAX_LAYERS];
-/** number of output columns for each output key */
-IntUS ncol_OUT[SW_OUTNKEYS];
+/* `SW_Output`, `_Sep`, `tOffset`, and the global variables describing
+   output periods (`timeSteps`, `used_OUTNPERIODS`, `use_OutPeriod`) and
+   size and names of output (`colnames_OUT`, `ncol_OUT`) are part of the
+   simulation run context, see `SW_OUT_STATE` in SW_Run.h
+   Note: Under STEPWAT2, `used_OUTNPERIODS` may be larger than the sum of
+   `use_OutPeriod` because it also incorporates information from
+   `timeSteps_SXW`. */
 
 
 // Text-based output: defined in `SW_Output_outtext.c`:
 #ifdef SW_OUTTEXT
-extern SW_FILE_STATUS SW_OutFiles;
-extern char sw_outstr[];
 extern Bool print_IterationSummary;
 extern Bool print_SW_Output;
 #endif
@@ -116,8 +101,6 @@ extern Bool print_SW_Output;
 // Array-based output: defined in `SW_Output_outarray.c`
 #ifdef SW_OUTARRAY
 extern IntUS ncol_TimeOUT[];
-extern size_t nrow_OUT[];
-extern size_t irow_OUT[];
 #endif
 
 
@@ -126,7 +109,7 @@ extern size_t irow_OUT[];
     that are required for `SXW` in-memory output for each output key.
     Compare with `timeSteps` */
 OutPeriod timeSteps_SXW[SW_OUTNKEYS][SW_OUTNPERIODS];
-extern char sw_outstr_agg[];
+extern SW_THREAD_LOCAL char sw_outstr_agg[];
 
 /** `storeAllIterations` is set to TRUE if STEPWAT2 is called with `-i` flag
      if TRUE, then write to disk the SOILWAT2 output
@@ -172,6 +155,23 @@ ObjType key2obj[] =
 	eVPD, eVPD
 };
 
+/* derived quantities (`OutDerived`) that each output key requires;
+   bit `d` is set if the key requires derived quantity `d`.
+   MUST be SW_OUTNKEYS of these */
+static const unsigned int key2derived[] =
+{ // weather/atmospheric quantities:
+	0, 0, 0, 0, 0,
+	// soil related water quantities:
+	0, 0, 0, 0, 0, 0,
+		1u << eSW_DerivedSWA, 0, 0, 0, 1u << eSW_DerivedEvapSoil, 0,
+		0, 0, 0, 0, 0, 0, 1u << eSW_DerivedWetDays,
+		0, 0, 0,
+	// vegetation quantities:
+	0, 1u << eSW_DerivedEstab,
+	// vegetation other:
+	0, 0
+};
+
 char const *pd2str[] =
 	{ SW_DAY, SW_WEEK, SW_MONTH, SW_YEAR };
 
@@ -185,10 +185,11 @@ char const *styp2str[] =
 /* =================================================== */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
-static char *MyFileName;
+static SW_THREAD_LOCAL char *MyFileName;
 
-static int useTimeStep; /* flag to determine whether or not the line TIMESTEP exists */
-static Bool bFlush_output; /* process partial period ? */
+#define useTimeStep (SW_CurrentRun->Out.useTimeStep) /* flag to determine whether or not the line TIMESTEP exists */
+#define bFlush_output (SW_CurrentRun->Out.bFlush_output) /* process partial period ? */
+#define skip_outyear (SW_CurrentRun->Out.skip_year) /* current year is outside of the output years ? */
 
 
 /* =================================================== */
@@ -201,11 +202,23 @@ static OutKey str2key(char *s);
 static OutSum str2stype(char *s);
 
 static void collect_sums(ObjType otyp, OutPeriod op);
-static void sumof_wth(SW_WEATHER *v, SW_WEATHER_OUTPUTS *s, OutKey k);
-static void sumof_swc(SW_SOILWAT *v, SW_SOILWAT_OUTPUTS *s, OutKey k);
-static void sumof_ves(SW_VEGESTAB *v, SW_VEGESTAB_OUTPUTS *s, OutKey k);
-static void sumof_vpd(SW_VEGPROD *v, SW_VEGPROD_OUTPUTS *s, OutKey k);
+static void sumof_wth(OutKey k, OutPeriod op);
+static void sumof_swc(OutKey k, OutPeriod op);
+static void sumof_ves(OutKey k, OutPeriod op);
+static void sumof_vpd(OutKey k, OutPeriod op);
+static void average_wth(OutKey k, OutPeriod pd, RealD div);
+static void average_swc(OutKey k, OutPeriod pd, RealD div);
+static void average_vpd(OutKey k, OutPeriod pd, RealD div);
 static void average_for(ObjType otyp, OutPeriod pd);
+static void add_sums(RealD *to, const RealD *from, IntUS n);
+static void rollup_wth(OutKey k, OutPeriod pd, OutPeriod pd_to);
+static void rollup_swc(OutKey k, OutPeriod pd, OutPeriod pd_to);
+static void rollup_vpd(OutKey k, OutPeriod pd, OutPeriod pd_to);
+static void rollup_sums(ObjType otyp, OutPeriod pd);
+static void set_activeKeys(void);
+static Bool has_key_finalstate(OutKey k);
+static void set_rollups(void);
+static void set_derived_inUse(void);
 
 #ifdef STEPWAT
 static void _set_SXWrequests_helper(OutKey k, OutPeriod pd, OutSum aggfun,
@@ -316,8 +329,10 @@ Bool has_keyname_soillayers(const char *var) {
 
 
 
-static void sumof_vpd(SW_VEGPROD *v, SW_VEGPROD_OUTPUTS *s, OutKey k)
+static void sumof_vpd(OutKey k, OutPeriod op)
 {
+	SW_VEGPROD *v = &SW_VegProd;
+	SW_VEGPROD_OUTPUTS *s = v->p_accu[op];
 	int ik;
 
 	switch (k)
@@ -338,8 +353,11 @@ static void sumof_vpd(SW_VEGPROD *v, SW_VEGPROD_OUTPUTS *s, OutKey k)
 	}
 }
 
-static void sumof_ves(SW_VEGESTAB *v, SW_VEGESTAB_OUTPUTS *s, OutKey k)
+static void sumof_ves(OutKey k, OutPeriod op)
 {
+	SW_VEGESTAB *v = &SW_VegEstab;
+	SW_VEGESTAB_OUTPUTS *s = v->p_accu[eSW_Year]; /* yearly, y'see */
+
 	/* --------------------------------------------------- */
 	/* k is always eSW_Estab, and this only gets called yearly */
 	/* in fact, there's nothing to do here as the get_estab()
@@ -349,14 +367,21 @@ static void sumof_ves(SW_VEGESTAB *v, SW_VEGESTAB_OUTPUTS *s, OutKey k)
 	 * establishment variables.
 	 */
 
+  if (op != eSW_Year) {
+    return;
+  }
+
 // just a few lines of nonsense to supress the compile warnings
   if ((int)k == 1) {}
   if (0 == v->count) {}
   if (0 == s->days) {}
 }
 
-static void sumof_wth(SW_WEATHER *v, SW_WEATHER_OUTPUTS *s, OutKey k)
+static void sumof_wth(OutKey k, OutPeriod op)
 {
+	SW_WEATHER *v = &SW_Weather;
+	SW_WEATHER_OUTPUTS *s = v->p_accu[op];
+
 	switch (k)
 	{
 
@@ -388,8 +413,10 @@ static void sumof_wth(SW_WEATHER *v, SW_WEATHER_OUTPUTS *s, OutKey k)
 
 }
 
-static void sumof_swc(SW_SOILWAT *v, SW_SOILWAT_OUTPUTS *s, OutKey k)
+static void sumof_swc(OutKey k, OutPeriod op)
 {
+	SW_SOILWAT *v = &SW_Soilwat;
+	SW_SOILWAT_OUTPUTS *s = v->p_accu[op];
 	LyrIndex i;
 	int j; // for use with ForEachVegType
 
@@ -419,13 +446,13 @@ static void sumof_swc(SW_SOILWAT *v, SW_SOILWAT_OUTPUTS *s, OutKey k)
 	case eSW_SWABulk:
 		ForEachSoilLayer(i)
 			s->swaBulk[i] += fmax(
-					v->swcBulk[Today][i] - SW_Site.lyr[i]->swcBulk_wiltpt, 0.);
+					v->swcBulk[Today][i] - SW_Site.swcBulk_wiltpt[i], 0.);
 		break;
 
 	case eSW_SWAMatric: /* get swaBulk and convert later */
 		ForEachSoilLayer(i)
 			s->swaMatric[i] += fmax(
-					v->swcBulk[Today][i] - SW_Site.lyr[i]->swcBulk_wiltpt, 0.);
+					v->swcBulk[Today][i] - SW_Site.swcBulk_wiltpt[i], 0.);
 		break;
 
 	case eSW_SWA: /* get swaBulk and convert later */
@@ -525,6 +552,443 @@ static void sumof_swc(SW_SOILWAT *v, SW_SOILWAT_OUTPUTS *s, OutKey k)
 }
 
 
+static void average_wth(OutKey k, OutPeriod pd, RealD div)
+{
+	SW_WEATHER *w = &SW_Weather;
+
+	switch (k)
+	{
+		case eSW_Temp:
+			w->p_oagg[pd]->temp_max = w->p_accu[pd]->temp_max / div;
+			w->p_oagg[pd]->temp_min = w->p_accu[pd]->temp_min / div;
+			w->p_oagg[pd]->temp_avg = w->p_accu[pd]->temp_avg / div;
+			w->p_oagg[pd]->surfaceTemp = w->p_accu[pd]->surfaceTemp / div;
+			break;
+
+		case eSW_Precip:
+			w->p_oagg[pd]->ppt = w->p_accu[pd]->ppt / div;
+			w->p_oagg[pd]->rain = w->p_accu[pd]->rain / div;
+			w->p_oagg[pd]->snow = w->p_accu[pd]->snow / div;
+			w->p_oagg[pd]->snowmelt = w->p_accu[pd]->snowmelt / div;
+			w->p_oagg[pd]->snowloss = w->p_accu[pd]->snowloss / div;
+			break;
+
+		case eSW_SoilInf:
+			w->p_oagg[pd]->soil_inf = w->p_accu[pd]->soil_inf / div;
+			break;
+
+		case eSW_Runoff:
+			w->p_oagg[pd]->snowRunoff = w->p_accu[pd]->snowRunoff / div;
+			w->p_oagg[pd]->surfaceRunoff = w->p_accu[pd]->surfaceRunoff / div;
+			w->p_oagg[pd]->surfaceRunon = w->p_accu[pd]->surfaceRunon / div;
+			break;
+
+		default:
+			LogError(logfp, LOGFATAL, "PGMR: Invalid key in average_wth(%s)", key2str[k]);
+	}
+}
+
+
+static void average_swc(OutKey k, OutPeriod pd, RealD div)
+{
+	SW_SOILWAT *s = &SW_Soilwat;
+	LyrIndex i;
+	int j;
+
+	switch (k)
+	{
+		case eSW_SoilTemp:
+			ForEachSoilLayer(i) {
+				s->p_oagg[pd]->sTemp[i] =
+						(SW_Output[k].sumtype == eSW_Fnl) ?
+								s->sTemp[i] :
+								s->p_accu[pd]->sTemp[i] / div;
+			}
+			break;
+
+		case eSW_VWCBulk:
+			ForEachSoilLayer(i) {
+				/* vwcBulk at this point is identical to swcBulk */
+				s->p_oagg[pd]->vwcBulk[i] =
+						(SW_Output[k].sumtype == eSW_Fnl) ?
+								s->swcBulk[Yesterday][i] :
+								s->p_accu[pd]->vwcBulk[i] / div;
+			}
+			break;
+
+		case eSW_VWCMatric:
+			ForEachSoilLayer(i) {
+				/* vwcMatric at this point is identical to swcBulk */
+				s->p_oagg[pd]->vwcMatric[i] =
+						(SW_Output[k].sumtype == eSW_Fnl) ?
+								s->swcBulk[Yesterday][i] :
+								s->p_accu[pd]->vwcMatric[i] / div;
+			}
+			break;
+
+		case eSW_SWCBulk:
+			ForEachSoilLayer(i) {
+				s->p_oagg[pd]->swcBulk[i] =
+						(SW_Output[k].sumtype == eSW_Fnl) ?
+								s->swcBulk[Yesterday][i] :
+								s->p_accu[pd]->swcBulk[i] / div;
+			}
+			break;
+
+		case eSW_SWPMatric:
+			ForEachSoilLayer(i) {
+				/* swpMatric at this point is identical to swcBulk */
+				s->p_oagg[pd]->swpMatric[i] =
+						(SW_Output[k].sumtype == eSW_Fnl) ?
+								s->swcBulk[Yesterday][i] :
+								s->p_accu[pd]->swpMatric[i] / div;
+			}
+			break;
+
+		case eSW_SWABulk:
+			ForEachSoilLayer(i) {
+				s->p_oagg[pd]->swaBulk[i] =
+						(SW_Output[k].sumtype == eSW_Fnl) ?
+								fmax(
+										s->swcBulk[Yesterday][i]
+												- SW_Site.swcBulk_wiltpt[i],
+										0.) :
+								s->p_accu[pd]->swaBulk[i] / div;
+			}
+			break;
+
+		case eSW_SWAMatric: /* swaMatric at this point is identical to swaBulk */
+			ForEachSoilLayer(i) {
+				s->p_oagg[pd]->swaMatric[i] =
+						(SW_Output[k].sumtype == eSW_Fnl) ?
+								fmax(
+										s->swcBulk[Yesterday][i]
+												- SW_Site.swcBulk_wiltpt[i],
+										0.) :
+								s->p_accu[pd]->swaMatric[i] / div;
+			}
+			break;
+
+		case eSW_SWA:
+			ForEachSoilLayer(i) {
+				ForEachVegType(j) {
+					s->p_oagg[pd]->SWA_VegType[j][i] =
+							(SW_Output[k].sumtype == eSW_Fnl) ?
+									s->dSWA_repartitioned_sum[j][i] :
+									s->p_accu[pd]->SWA_VegType[j][i] / div;
+				}
+			}
+			break;
+
+		case eSW_DeepSWC:
+			s->p_oagg[pd]->deep =
+					(SW_Output[k].sumtype == eSW_Fnl) ?
+							s->swcBulk[Yesterday][SW_Site.deep_lyr] :
+							s->p_accu[pd]->deep / div;
+			break;
+
+		case eSW_SurfaceWater:
+			s->p_oagg[pd]->surfaceWater = s->p_accu[pd]->surfaceWater / div;
+			break;
+
+		case eSW_Transp:
+			ForEachSoilLayer(i)
+			{
+				s->p_oagg[pd]->transp_total[i] = s->p_accu[pd]->transp_total[i] / div;
+				ForEachVegType(j) {
+					s->p_oagg[pd]->transp[j][i] = s->p_accu[pd]->transp[j][i] / div;
+				}
+			}
+			break;
+
+		case eSW_EvapSoil:
+			ForEachEvapLayer(i)
+				s->p_oagg[pd]->evap[i] = s->p_accu[pd]->evap[i] / div;
+			break;
+
+		case eSW_EvapSurface:
+			s->p_oagg[pd]->total_evap = s->p_accu[pd]->total_evap / div;
+			ForEachVegType(j) {
+				s->p_oagg[pd]->evap_veg[j] = s->p_accu[pd]->evap_veg[j] / div;
+			}
+			s->p_oagg[pd]->litter_evap = s->p_accu[pd]->litter_evap / div;
+			s->p_oagg[pd]->surfaceWater_evap = s->p_accu[pd]->surfaceWater_evap / div;
+			break;
+
+		case eSW_Interception:
+			s->p_oagg[pd]->total_int = s->p_accu[pd]->total_int / div;
+			ForEachVegType(j) {
+				s->p_oagg[pd]->int_veg[j] = s->p_accu[pd]->int_veg[j] / div;
+			}
+			s->p_oagg[pd]->litter_int = s->p_accu[pd]->litter_int / div;
+			break;
+
+		case eSW_AET:
+			s->p_oagg[pd]->aet = s->p_accu[pd]->aet / div;
+			break;
+
+		case eSW_LyrDrain:
+			for (i = 0; i < SW_Site.n_layers - 1; i++)
+				s->p_oagg[pd]->lyrdrain[i] = s->p_accu[pd]->lyrdrain[i] / div;
+			break;
+
+		case eSW_HydRed:
+			ForEachSoilLayer(i)
+			{
+				s->p_oagg[pd]->hydred_total[i] = s->p_accu[pd]->hydred_total[i] / div;
+				ForEachVegType(j) {
+					s->p_oagg[pd]->hydred[j][i] = s->p_accu[pd]->hydred[j][i] / div;
+				}
+			}
+			break;
+
+		case eSW_PET:
+			s->p_oagg[pd]->pet = s->p_accu[pd]->pet / div;
+			s->p_oagg[pd]->H_oh = s->p_accu[pd]->H_oh / div;
+			s->p_oagg[pd]->H_ot = s->p_accu[pd]->H_ot / div;
+			s->p_oagg[pd]->H_gh = s->p_accu[pd]->H_gh / div;
+			s->p_oagg[pd]->H_gt = s->p_accu[pd]->H_gt / div;
+			break;
+
+		case eSW_WetDays:
+			ForEachSoilLayer(i)
+				s->p_oagg[pd]->wetdays[i] = s->p_accu[pd]->wetdays[i] / div;
+			break;
+
+		case eSW_SnowPack:
+			s->p_oagg[pd]->snowpack = s->p_accu[pd]->snowpack / div;
+			s->p_oagg[pd]->snowdepth = s->p_accu[pd]->snowdepth / div;
+			break;
+
+		default:
+			LogError(logfp, LOGFATAL, "PGMR: Invalid key in average_swc(%s)", key2str[k]);
+	}
+}
+
+
+static void average_vpd(OutKey k, OutPeriod pd, RealD div)
+{
+	SW_VEGPROD *vp = &SW_VegProd;
+	int i;
+
+	switch (k)
+	{
+		case eSW_CO2Effects:
+			break;
+
+		case eSW_Biomass:
+			ForEachVegType(i) {
+				vp->p_oagg[pd]->veg[i].biomass = vp->p_accu[pd]->veg[i].biomass / div;
+				vp->p_oagg[pd]->veg[i].litter = vp->p_accu[pd]->veg[i].litter / div;
+				vp->p_oagg[pd]->veg[i].biolive = vp->p_accu[pd]->veg[i].biolive / div;
+			}
+			break;
+
+		default:
+			LogError(logfp, LOGFATAL, "PGMR: Invalid key in average_vpd(%s)", key2str[k]);
+	}
+}
+
+
+/** Add `n` accumulated values of a finer output period to the ones of a
+    coarser output period */
+static void add_sums(RealD *to, const RealD *from, IntUS n)
+{
+	IntUS i;
+
+	for (i = 0; i < n; i++)
+		to[i] += from[i];
+}
+
+
+/** Roll up the accumulated weather values of output key `k` from the
+    closing output period `pd` into the coarser output period `pd_to`;
+    see `set_rollups()` */
+static void rollup_wth(OutKey k, OutPeriod pd, OutPeriod pd_to)
+{
+	SW_WEATHER_OUTPUTS
+		*f = SW_Weather.p_accu[pd],
+		*t = SW_Weather.p_accu[pd_to];
+
+	switch (k)
+	{
+		case eSW_Temp:
+			t->temp_max += f->temp_max;
+			t->temp_min += f->temp_min;
+			t->temp_avg += f->temp_avg;
+			t->surfaceTemp += f->surfaceTemp;
+			break;
+
+		case eSW_Precip:
+			t->ppt += f->ppt;
+			t->rain += f->rain;
+			t->snow += f->snow;
+			t->snowmelt += f->snowmelt;
+			t->snowloss += f->snowloss;
+			break;
+
+		case eSW_SoilInf:
+			t->soil_inf += f->soil_inf;
+			break;
+
+		case eSW_Runoff:
+			t->snowRunoff += f->snowRunoff;
+			t->surfaceRunoff += f->surfaceRunoff;
+			t->surfaceRunon += f->surfaceRunon;
+			break;
+
+		default:
+			LogError(logfp, LOGFATAL, "PGMR: Invalid key in rollup_wth(%s)", key2str[k]);
+	}
+}
+
+
+/** Roll up the accumulated soil water values of output key `k` from the
+    closing output period `pd` into the coarser output period `pd_to`;
+    see `set_rollups()` */
+static void rollup_swc(OutKey k, OutPeriod pd, OutPeriod pd_to)
+{
+	SW_SOILWAT_OUTPUTS
+		*f = SW_Soilwat.p_accu[pd],
+		*t = SW_Soilwat.p_accu[pd_to];
+	IntUS n = SW_Site.n_layers;
+	int j;
+
+	switch (k)
+	{
+		case eSW_VWCBulk:
+			add_sums(t->vwcBulk, f->vwcBulk, n);
+			break;
+
+		case eSW_VWCMatric:
+			add_sums(t->vwcMatric, f->vwcMatric, n);
+			break;
+
+		case eSW_SWCBulk:
+			add_sums(t->swcBulk, f->swcBulk, n);
+			break;
+
+		case eSW_SWPMatric:
+			add_sums(t->swpMatric, f->swpMatric, n);
+			break;
+
+		case eSW_SWABulk:
+			add_sums(t->swaBulk, f->swaBulk, n);
+			break;
+
+		case eSW_SWAMatric:
+			add_sums(t->swaMatric, f->swaMatric, n);
+			break;
+
+		case eSW_SWA:
+			ForEachVegType(j) {
+				add_sums(t->SWA_VegType[j], f->SWA_VegType[j], n);
+			}
+			break;
+
+		case eSW_SurfaceWater:
+			t->surfaceWater += f->surfaceWater;
+			break;
+
+		case eSW_Transp:
+			add_sums(t->transp_total, f->transp_total, n);
+			ForEachVegType(j) {
+				add_sums(t->transp[j], f->transp[j], n);
+			}
+			break;
+
+		case eSW_EvapSoil:
+			add_sums(t->evap, f->evap, SW_Site.n_evap_lyrs);
+			break;
+
+		case eSW_EvapSurface:
+			t->total_evap += f->total_evap;
+			add_sums(t->evap_veg, f->evap_veg, NVEGTYPES);
+			t->litter_evap += f->litter_evap;
+			t->surfaceWater_evap += f->surfaceWater_evap;
+			break;
+
+		case eSW_Interception:
+			t->total_int += f->total_int;
+			add_sums(t->int_veg, f->int_veg, NVEGTYPES);
+			t->litter_int += f->litter_int;
+			break;
+
+		case eSW_LyrDrain:
+			add_sums(t->lyrdrain, f->lyrdrain, n - 1);
+			break;
+
+		case eSW_HydRed:
+			add_sums(t->hydred_total, f->hydred_total, n);
+			ForEachVegType(j) {
+				add_sums(t->hydred[j], f->hydred[j], n);
+			}
+			break;
+
+		case eSW_AET:
+			t->aet += f->aet;
+			break;
+
+		case eSW_PET:
+			t->pet += f->pet;
+			t->H_oh += f->H_oh;
+			t->H_ot += f->H_ot;
+			t->H_gh += f->H_gh;
+			t->H_gt += f->H_gt;
+			break;
+
+		case eSW_WetDays:
+			add_sums(t->wetdays, f->wetdays, n);
+			break;
+
+		case eSW_SnowPack:
+			t->snowpack += f->snowpack;
+			t->snowdepth += f->snowdepth;
+			break;
+
+		case eSW_DeepSWC:
+			t->deep += f->deep;
+			break;
+
+		case eSW_SoilTemp:
+			add_sums(t->sTemp, f->sTemp, n);
+			break;
+
+		default:
+			LogError(logfp, LOGFATAL, "PGMR: Invalid key in rollup_swc(%s)", key2str[k]);
+	}
+}
+
+
+/** Roll up the accumulated vegetation values of output key `k` from the
+    closing output period `pd` into the coarser output period `pd_to`;
+    see `set_rollups()` */
+static void rollup_vpd(OutKey k, OutPeriod pd, OutPeriod pd_to)
+{
+	SW_VEGPROD_OUTPUTS
+		*f = SW_VegProd.p_accu[pd],
+		*t = SW_VegProd.p_accu[pd_to];
+	int ik;
+
+	switch (k)
+	{
+		case eSW_CO2Effects:
+			break;
+
+		case eSW_Biomass:
+			ForEachVegType(ik) {
+				t->veg[ik].biomass += f->veg[ik].biomass;
+				t->veg[ik].litter += f->veg[ik].litter;
+				t->veg[ik].biolive += f->veg[ik].biolive;
+			}
+			break;
+
+		default:
+			LogError(logfp, LOGFATAL, "PGMR: Invalid key in rollup_vpd(%s)", key2str[k]);
+	}
+}
+
+
 /** separates the task of obtaining a periodic average.
    no need to average days, so this should never be
    called with eSW_Day.
@@ -536,11 +1000,11 @@ static void average_for(ObjType otyp, OutPeriod pd) {
 	SW_SOILWAT *s = &SW_Soilwat;
 	SW_WEATHER *w = &SW_Weather;
 	SW_VEGPROD *vp = &SW_VegProd;
+	SW_OUT_ACTIVEKEY *a;
 	TimeInt curr_pd = 0;
 	RealD div = 0.; /* if sumtype=AVG, days in period; if sumtype=SUM, 1 */
 	OutKey k;
-	LyrIndex i;
-	int j;
+	IntUS i;
 
 	if (otyp == eVES)
 		return;
@@ -570,13 +1034,18 @@ static void average_for(ObjType otyp, OutPeriod pd) {
 
 	}
 	else {
-		// carefully aggregate for specific time period and aggregation type (mean, sum, final value)
-		ForEachOutKey(k)
+		// carefully aggregate for specific time period and aggregation type
+		// (mean, sum, final value) of each output key that is active for `pd`
+		for (i = 0; i < n_activeKeys[pd]; i++)
 		{
-			if (!SW_Output[k].use) {
+			a = &activeKeys[pd][i];
+
+			if (a->obj != otyp || NULL == a->pfunc_avg) {
 				continue;
 			}
 
+			k = a->key;
+
 			switch (pd)
 			{
 				case eSW_Week:
@@ -598,240 +1067,23 @@ static void average_for(ObjType otyp, OutPeriod pd) {
 					LogError(logfp, LOGFATAL, "Programmer: Invalid period in average_for().");
 			} /* end switch(pd) */
 
-			if (SW_Output[k].myobj != otyp
-					|| curr_pd < SW_Output[k].first
-					|| curr_pd > SW_Output[k].last)
+			if (curr_pd < SW_Output[k].first || curr_pd > SW_Output[k].last)
 				continue;
 
 			if (SW_Output[k].sumtype == eSW_Sum)
 				div = 1.;
 
-			/* notice that all valid keys are in this switch */
-			switch (k)
-			{
-
-			case eSW_Temp:
-				w->p_oagg[pd]->temp_max = w->p_accu[pd]->temp_max / div;
-				w->p_oagg[pd]->temp_min = w->p_accu[pd]->temp_min / div;
-				w->p_oagg[pd]->temp_avg = w->p_accu[pd]->temp_avg / div;
-				w->p_oagg[pd]->surfaceTemp = w->p_accu[pd]->surfaceTemp / div;
-				break;
-
-			case eSW_Precip:
-				w->p_oagg[pd]->ppt = w->p_accu[pd]->ppt / div;
-				w->p_oagg[pd]->rain = w->p_accu[pd]->rain / div;
-				w->p_oagg[pd]->snow = w->p_accu[pd]->snow / div;
-				w->p_oagg[pd]->snowmelt = w->p_accu[pd]->snowmelt / div;
-				w->p_oagg[pd]->snowloss = w->p_accu[pd]->snowloss / div;
-				break;
-
-			case eSW_SoilInf:
-				w->p_oagg[pd]->soil_inf = w->p_accu[pd]->soil_inf / div;
-				break;
-
-			case eSW_Runoff:
-				w->p_oagg[pd]->snowRunoff = w->p_accu[pd]->snowRunoff / div;
-				w->p_oagg[pd]->surfaceRunoff = w->p_accu[pd]->surfaceRunoff / div;
-				w->p_oagg[pd]->surfaceRunon = w->p_accu[pd]->surfaceRunon / div;
-				break;
-
-			case eSW_SoilTemp:
-				ForEachSoilLayer(i) {
-					s->p_oagg[pd]->sTemp[i] =
-							(SW_Output[k].sumtype == eSW_Fnl) ?
-									s->sTemp[i] :
-									s->p_accu[pd]->sTemp[i] / div;
-				}
-				break;
-
-			case eSW_VWCBulk:
-				ForEachSoilLayer(i) {
-					/* vwcBulk at this point is identical to swcBulk */
-					s->p_oagg[pd]->vwcBulk[i] =
-							(SW_Output[k].sumtype == eSW_Fnl) ?
-									s->swcBulk[Yesterday][i] :
-									s->p_accu[pd]->vwcBulk[i] / div;
-				}
-				break;
-
-			case eSW_VWCMatric:
-				ForEachSoilLayer(i) {
-					/* vwcMatric at this point is identical to swcBulk */
-					s->p_oagg[pd]->vwcMatric[i] =
-							(SW_Output[k].sumtype == eSW_Fnl) ?
-									s->swcBulk[Yesterday][i] :
-									s->p_accu[pd]->vwcMatric[i] / div;
-				}
-				break;
-
-			case eSW_SWCBulk:
-				ForEachSoilLayer(i) {
-					s->p_oagg[pd]->swcBulk[i] =
-							(SW_Output[k].sumtype == eSW_Fnl) ?
-									s->swcBulk[Yesterday][i] :
-									s->p_accu[pd]->swcBulk[i] / div;
-				}
-				break;
-
-			case eSW_SWPMatric:
-				ForEachSoilLayer(i) {
-					/* swpMatric at this point is identical to swcBulk */
-					s->p_oagg[pd]->swpMatric[i] =
-							(SW_Output[k].sumtype == eSW_Fnl) ?
-									s->swcBulk[Yesterday][i] :
-									s->p_accu[pd]->swpMatric[i] / div;
-				}
-				break;
-
-			case eSW_SWABulk:
-				ForEachSoilLayer(i) {
-					s->p_oagg[pd]->swaBulk[i] =
-							(SW_Output[k].sumtype == eSW_Fnl) ?
-									fmax(
-											s->swcBulk[Yesterday][i]
-													- SW_Site.lyr[i]->swcBulk_wiltpt,
-											0.) :
-									s->p_accu[pd]->swaBulk[i] / div;
-				}
-				break;
-
-			case eSW_SWAMatric: /* swaMatric at this point is identical to swaBulk */
-				ForEachSoilLayer(i) {
-					s->p_oagg[pd]->swaMatric[i] =
-							(SW_Output[k].sumtype == eSW_Fnl) ?
-									fmax(
-											s->swcBulk[Yesterday][i]
-													- SW_Site.lyr[i]->swcBulk_wiltpt,
-											0.) :
-									s->p_accu[pd]->swaMatric[i] / div;
-				}
-				break;
-
-			case eSW_SWA:
-				ForEachSoilLayer(i) {
-					ForEachVegType(j) {
-						s->p_oagg[pd]->SWA_VegType[j][i] =
-								(SW_Output[k].sumtype == eSW_Fnl) ?
-										s->dSWA_repartitioned_sum[j][i] :
-										s->p_accu[pd]->SWA_VegType[j][i] / div;
-					}
-				}
-				break;
-
-			case eSW_DeepSWC:
-				s->p_oagg[pd]->deep =
-						(SW_Output[k].sumtype == eSW_Fnl) ?
-								s->swcBulk[Yesterday][SW_Site.deep_lyr] :
-								s->p_accu[pd]->deep / div;
-				break;
-
-			case eSW_SurfaceWater:
-				s->p_oagg[pd]->surfaceWater = s->p_accu[pd]->surfaceWater / div;
-				break;
-
-			case eSW_Transp:
-				ForEachSoilLayer(i)
-				{
-					s->p_oagg[pd]->transp_total[i] = s->p_accu[pd]->transp_total[i] / div;
-					ForEachVegType(j) {
-						s->p_oagg[pd]->transp[j][i] = s->p_accu[pd]->transp[j][i] / div;
-					}
-				}
-				break;
-
-			case eSW_EvapSoil:
-				ForEachEvapLayer(i)
-					s->p_oagg[pd]->evap[i] = s->p_accu[pd]->evap[i] / div;
-				break;
-
-			case eSW_EvapSurface:
-				s->p_oagg[pd]->total_evap = s->p_accu[pd]->total_evap / div;
-				ForEachVegType(j) {
-					s->p_oagg[pd]->evap_veg[j] = s->p_accu[pd]->evap_veg[j] / div;
-				}
-				s->p_oagg[pd]->litter_evap = s->p_accu[pd]->litter_evap / div;
-				s->p_oagg[pd]->surfaceWater_evap = s->p_accu[pd]->surfaceWater_evap / div;
-				break;
-
-			case eSW_Interception:
-				s->p_oagg[pd]->total_int = s->p_accu[pd]->total_int / div;
-				ForEachVegType(j) {
-					s->p_oagg[pd]->int_veg[j] = s->p_accu[pd]->int_veg[j] / div;
-				}
-				s->p_oagg[pd]->litter_int = s->p_accu[pd]->litter_int / div;
-				break;
-
-			case eSW_AET:
-				s->p_oagg[pd]->aet = s->p_accu[pd]->aet / div;
-				break;
-
-			case eSW_LyrDrain:
-				for (i = 0; i < SW_Site.n_layers - 1; i++)
-					s->p_oagg[pd]->lyrdrain[i] = s->p_accu[pd]->lyrdrain[i] / div;
-				break;
-
-			case eSW_HydRed:
-				ForEachSoilLayer(i)
-				{
-					s->p_oagg[pd]->hydred_total[i] = s->p_accu[pd]->hydred_total[i] / div;
-					ForEachVegType(j) {
-						s->p_oagg[pd]->hydred[j][i] = s->p_accu[pd]->hydred[j][i] / div;
-					}
-				}
-				break;
-
-			case eSW_PET:
-				s->p_oagg[pd]->pet = s->p_accu[pd]->pet / div;
-				s->p_oagg[pd]->H_oh = s->p_accu[pd]->H_oh / div;
-				s->p_oagg[pd]->H_ot = s->p_accu[pd]->H_ot / div;
-				s->p_oagg[pd]->H_gh = s->p_accu[pd]->H_gh / div;
-				s->p_oagg[pd]->H_gt = s->p_accu[pd]->H_gt / div;
-				break;
-
-			case eSW_WetDays:
-				ForEachSoilLayer(i)
-					s->p_oagg[pd]->wetdays[i] = s->p_accu[pd]->wetdays[i] / div;
-				break;
-
-			case eSW_SnowPack:
-				s->p_oagg[pd]->snowpack = s->p_accu[pd]->snowpack / div;
-				s->p_oagg[pd]->snowdepth = s->p_accu[pd]->snowdepth / div;
-				break;
-
-			case eSW_Estab: /* do nothing, no averaging required */
-				break;
-
-			case eSW_CO2Effects:
-				break;
-
-			case eSW_Biomass:
-				ForEachVegType(i) {
-					vp->p_oagg[pd]->veg[i].biomass = vp->p_accu[pd]->veg[i].biomass / div;
-					vp->p_oagg[pd]->veg[i].litter = vp->p_accu[pd]->veg[i].litter / div;
-					vp->p_oagg[pd]->veg[i].biolive = vp->p_accu[pd]->veg[i].biolive / div;
-				}
-				break;
-
-			default:
-				LogError(logfp, LOGFATAL, "PGMR: Invalid key in average_for(%s)", key2str[k]);
-			}
-
-		} /* end ForEachKey */
+			a->pfunc_avg(k, pd, div);
+		}
 	}
 }
 
 
 static void collect_sums(ObjType otyp, OutPeriod op)
-{
-	SW_SOILWAT *s = &SW_Soilwat;
-	SW_WEATHER *w = &SW_Weather;
-	SW_VEGESTAB *v = &SW_VegEstab;
-	SW_VEGPROD *vp = &SW_VegProd;
-
+{
+	SW_OUT_ACTIVEKEY *a;
 	TimeInt pd = 0;
-	OutKey k;
 	IntUS i;
-	Bool use_help, use_KeyPeriodCombo;
 
 	switch (op)
 	{
@@ -852,58 +1104,243 @@ static void collect_sums(ObjType otyp, OutPeriod op)
 	}
 
 
-	// call `sumof_XXX` for each output key x output period combination
-	// for those output keys that belong to the output type `otyp` (eSWC, eWTH, eVES, eVPD)
-	ForEachOutKey(k)
+	// call `sumof_XXX` for each output key that is active for output period
+	// `op` and that belongs to the output type `otyp` (eSWC, eWTH, eVES, eVPD)
+	// unless its accumulator is rolled up from a finer period or not needed
+	for (i = 0; i < n_activeKeys[op]; i++)
 	{
-		if (otyp != SW_Output[k].myobj || !SW_Output[k].use)
-			continue;
+		a = &activeKeys[op][i];
 
-		/* determine whether output period op is active for current output key k */
-		use_KeyPeriodCombo = swFALSE;
-		for (i = 0; i < used_OUTNPERIODS; i++)
+		if (a->obj == otyp && !isnull(a->pfunc_sum) && !a->is_rolledup &&
+			pd >= SW_Output[a->key].first && pd <= SW_Output[a->key].last)
 		{
-			use_help = (Bool) op == timeSteps[k][i];
+			a->pfunc_sum(a->key, op);
+		}
+	}
+}
 
-			#ifdef STEPWAT
-			use_help = (Bool) (use_help || op == timeSteps_SXW[k][i]);
-			#endif
 
-			if (use_help)
-			{
-				use_KeyPeriodCombo = swTRUE;
-				break;
-			}
+/** Add the accumulators of the closing output period `pd` to the coarser
+    output periods that are rolled up from it; see `set_rollups()` */
+static void rollup_sums(ObjType otyp, OutPeriod pd)
+{
+	SW_OUT_ACTIVEKEY *a;
+	IntUS i;
+
+	for (i = 0; i < n_activeKeys[pd]; i++)
+	{
+		a = &activeKeys[pd][i];
+
+		if (a->obj == otyp && a->rollup_to != eSW_NoTime)
+		{
+			a->pfunc_rollup(a->key, pd, a->rollup_to);
 		}
+	}
+}
+
+
+/** @brief List for each output period the output keys that are active
+
+		`collect_sums()` and `average_for()` walk these lists instead of all
+		output keys so that the daily cost of summarizing output scales with
+		the number of requested outputs.
+
+		@sideeffect Uses `SW_Output`, `timeSteps` (and `timeSteps_SXW`) to set
+			`activeKeys` and `n_activeKeys`
+*/
+static void set_activeKeys(void)
+{
+	OutKey k;
+	OutPeriod p;
+	IntUS i;
+	Bool use_KeyPeriodCombo;
+	SW_OUT_ACTIVEKEY *a;
+
+	ForEachOutPeriod(p)
+	{
+		n_activeKeys[p] = 0;
 
-		if (use_KeyPeriodCombo && pd >= SW_Output[k].first && pd <= SW_Output[k].last)
+		ForEachOutKey(k)
 		{
-			switch (otyp)
+			if (!SW_Output[k].use)
+				continue;
+
+			/* determine whether output period p is active for output key k */
+			use_KeyPeriodCombo = swFALSE;
+			for (i = 0; i < used_OUTNPERIODS && !use_KeyPeriodCombo; i++)
 			{
-			case eSWC:
-				sumof_swc(s, s->p_accu[op], k);
-				break;
+				use_KeyPeriodCombo = (Bool) (p == timeSteps[k][i]);
 
-			case eWTH:
-				sumof_wth(w, w->p_accu[op], k);
-				break;
+				#ifdef STEPWAT
+				use_KeyPeriodCombo = (Bool) (use_KeyPeriodCombo ||
+					p == timeSteps_SXW[k][i]);
+				#endif
+			}
 
-			case eVES:
-				if (op == eSW_Year) {
-					sumof_ves(v, v->p_accu[eSW_Year], k); /* yearly, y'see */
-				}
-				break;
+			if (!use_KeyPeriodCombo)
+				continue;
 
-			case eVPD:
-				sumof_vpd(vp, vp->p_accu[op], k);
-				break;
+			a = &activeKeys[p][n_activeKeys[p]++];
+			a->key = k;
+			a->obj = SW_Output[k].myobj;
+			a->rollup_to = eSW_NoTime;
+			a->is_rolledup = swFALSE;
 
-			default:
-				break;
+			switch (a->obj)
+			{
+				case eSWC:
+					a->pfunc_sum = sumof_swc;
+					a->pfunc_avg = average_swc;
+					a->pfunc_rollup = rollup_swc;
+					break;
+
+				case eWTH:
+					a->pfunc_sum = sumof_wth;
+					a->pfunc_avg = average_wth;
+					a->pfunc_rollup = rollup_wth;
+					break;
+
+				case eVES:
+					a->pfunc_sum = sumof_ves;
+					a->pfunc_avg = NULL; /* no averaging required */
+					a->pfunc_rollup = NULL;
+					break;
+
+				case eVPD:
+					a->pfunc_sum = sumof_vpd;
+					a->pfunc_avg = average_vpd;
+					a->pfunc_rollup = rollup_vpd;
+					break;
+
+				default:
+					LogError(logfp, LOGFATAL,
+						"PGMR: Invalid object type in set_activeKeys(%s)", key2str[k]);
+			}
+
+			/* final values of state variables are taken from the state itself;
+			   only the day period needs its accumulator (see `average_for()`) */
+			if (p != eSW_Day && SW_Output[k].sumtype == eSW_Fnl &&
+				has_key_finalstate(k))
+			{
+				a->pfunc_sum = NULL;
+			}
+		}
+	}
+}
+
+
+/** Checks whether the aggregation of output key `k` with summary type
+    `eSW_Fnl` uses the state on the last day of a period instead of
+    accumulated daily values (see `average_swc()`) */
+static Bool has_key_finalstate(OutKey k)
+{
+	return (Bool) (
+			k == eSW_VWCBulk ||
+			k == eSW_VWCMatric ||
+			k == eSW_SWCBulk ||
+			k == eSW_SWABulk ||
+			k == eSW_SWAMatric ||
+			k == eSW_SWA ||
+			k == eSW_SWPMatric ||
+			k == eSW_DeepSWC ||
+			k == eSW_SoilTemp
+		);
+}
+
+
+/** @brief Determine which derived quantities the daily loop calculates
+
+		Follows `key2derived` from each requested output key back to the
+		derived quantities that it requires; quantities that are consumed by
+		the model itself (e.g., by the water balance checks) are always used.
+
+		@sideeffect Uses `SW_Output` to set `use_Derived`
+*/
+static void set_derived_inUse(void)
+{
+	OutKey k;
+	IntUS d;
+
+	ForEachOutDerived(d) {
+		use_Derived[d] = swFALSE;
+	}
+
+	ForEachOutKey(k) {
+		if (!SW_Output[k].use)
+			continue;
+
+		ForEachOutDerived(d) {
+			if (key2derived[k] & (1u << d)) {
+				use_Derived[d] = swTRUE;
+			}
+		}
+	}
+
+	#ifdef SWDEBUG
+	// `SW_WaterBalance_Checks()` requires layer-wise bare-soil evaporation
+	use_Derived[eSW_DerivedEvapSoil] = swTRUE;
+	#endif
+}
+
+
+/** @brief Decide for the current year which yearly accumulators are rolled up
+		from monthly (or weekly) accumulators instead of summed daily
+
+		A yearly accumulator is rolled up from the monthly accumulator of the
+		same output key if monthly output is active, else from the weekly one,
+		if all days of the year are summarized for this output key, i.e., the
+		first/last day filters of `collect_sums()` pass for every day, week,
+		and month of the year. The accumulators are sums of daily values for
+		every `OutSum` so that `average_for()` aggregates them unchanged.
+
+		@sideeffect Sets `rollup_to` and `is_rolledup` of `activeKeys`
+*/
+static void set_rollups(void)
+{
+	SW_OUT_ACTIVEKEY *a, *from, *cand;
+	OutKey k;
+	OutPeriod pd;
+	IntUS i, j;
+	Bool use_rollup;
+
+	ForEachOutPeriod(pd)
+	{
+		for (i = 0; i < n_activeKeys[pd]; i++) {
+			activeKeys[pd][i].rollup_to = eSW_NoTime;
+			activeKeys[pd][i].is_rolledup = swFALSE;
+		}
+	}
+
+	for (i = 0; i < n_activeKeys[eSW_Year]; i++)
+	{
+		a = &activeKeys[eSW_Year][i];
+		k = a->key;
+
+		use_rollup = (Bool) (NULL != a->pfunc_sum && NULL != a->pfunc_rollup &&
+			SW_Output[k].first == 1 && SW_Output[k].last == SW_Model.lastdoy);
+
+		if (!use_rollup)
+			continue;
+
+		/* find the finer accumulator: monthly if active, else weekly */
+		from = NULL;
+		for (pd = eSW_Month; pd >= eSW_Week && isnull(from); pd--)
+		{
+			for (j = 0; j < n_activeKeys[pd]; j++) {
+				cand = &activeKeys[pd][j];
+
+				if (cand->key == k && NULL != cand->pfunc_sum) {
+					from = cand;
+					break;
+				}
 			}
 		}
 
-	} /* end ForEachOutKey */
+		if (!isnull(from)) {
+			from->rollup_to = eSW_Year;
+			a->is_rolledup = swTRUE;
+		}
+	}
 }
 
 
@@ -944,7 +1381,7 @@ static void _set_SXWrequests_helper(OutKey k, OutPeriod pd, OutSum aggfun,
 		active
 
 		@sideeffect Uses global variables SW_Output.use and timeSteps to set
-			elements of use_OutPeriod
+			elements of use_OutPeriod, activeKeys, n_activeKeys, and use_Derived
 */
 void find_OutPeriods_inUse(void)
 {
@@ -967,6 +1404,9 @@ void find_OutPeriods_inUse(void)
 			}
 		}
 	}
+
+	set_activeKeys();
+	set_derived_inUse();
 }
 
 /** Determine whether output period `pd` is active for output key `k`
@@ -1023,7 +1463,8 @@ Bool has_OutPeriod_inUse2(OutPeriod pd, OutKey k)
 			* annual sum of AET
 		@sideeffect Sets elements of `timeSteps_SXW`, updates `used_OUTNPERIODS`,
 			and adjusts variables `use`, `sumtype` (with a warning), `first_orig`,
-			and `last_orig` of `SW_Output`.
+			and `last_orig` of `SW_Output`, and updates `activeKeys` and
+			`use_Derived`.
 */
 void SW_OUT_set_SXWrequests(void)
 {
@@ -1052,6 +1493,10 @@ void SW_OUT_set_SXWrequests(void)
 	// STEPWAT2 requires annual sum of AET
 	_set_SXWrequests_helper(eSW_AET, eSW_Year, eSW_Sum,
 		"annual AET");
+
+	// Update output keys that are active for each output period
+	set_activeKeys();
+	set_derived_inUse();
 }
 #endif
 
@@ -1066,8 +1511,8 @@ void SW_OUT_construct(void)
 	int j;
 
 	#if defined(SOILWAT)
-	print_SW_Output = swTRUE;
-	print_IterationSummary = swFALSE;
+	// `print_SW_Output` and `print_IterationSummary` are initialized in
+	// `SW_Output_outtext.c` and constant so that concurrent runs don't write them
 	#elif defined(STEPWAT)
 	print_SW_Output = (Bool) storeAllIterations;
 	// `print_IterationSummary` is set by STEPWAT2's `main` function
@@ -1079,10 +1524,21 @@ void SW_OUT_construct(void)
 		SW_OutFiles.make_soil[p] = swFALSE;
 		SW_OutFiles.make_regular[p] = swFALSE;
 	}
+	#ifdef SOILWAT
+	SW_OutFiles.n_bytes = 0;
+	#endif
 	#endif
 
 	bFlush_output = swFALSE;
 	tOffset = 1;
+	SW_CurrentRun->Out.first_year = 0;
+	SW_CurrentRun->Out.last_year = 0;
+	skip_outyear = swFALSE;
+
+	ForEachOutPeriod(p)
+	{
+		n_activeKeys[p] = 0;
+	}
 
 	ForEachSoilLayer(i) {
 		ForEachVegType(j) {
@@ -1138,7 +1594,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_temp_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_temp_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_temp_agg;
@@ -1150,7 +1606,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_precip_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_precip_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_precip_agg;
@@ -1162,7 +1618,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_vwcBulk_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_vwcBulk_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_vwcBulk_agg;
@@ -1174,7 +1630,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_vwcMatric_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_vwcMatric_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_vwcMatric_agg;
@@ -1186,7 +1642,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_swcBulk_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_swcBulk_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_swcBulk_agg;
@@ -1198,7 +1654,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_swpMatric_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_swpMatric_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_swpMatric_agg;
@@ -1210,7 +1666,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_swaBulk_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_swaBulk_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_swaBulk_agg;
@@ -1222,7 +1678,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_swaMatric_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_swaMatric_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_swaMatric_agg;
@@ -1234,7 +1690,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_swa_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_swa_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_swa_agg;
@@ -1246,7 +1702,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_surfaceWater_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_surfaceWater_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_surfaceWater_agg;
@@ -1258,7 +1714,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_runoffrunon_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_runoffrunon_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_runoffrunon_agg;
@@ -1270,7 +1726,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_transp_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_transp_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_transp_agg;
@@ -1282,7 +1738,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_evapSoil_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_evapSoil_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_evapSoil_agg;
@@ -1294,7 +1750,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_evapSurface_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_evapSurface_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_evapSurface_agg;
@@ -1306,7 +1762,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_interception_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_interception_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_interception_agg;
@@ -1318,7 +1774,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_soilinf_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_soilinf_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_soilinf_agg;
@@ -1330,7 +1786,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_lyrdrain_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_lyrdrain_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_lyrdrain_agg;
@@ -1342,7 +1798,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_hydred_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_hydred_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_hydred_agg;
@@ -1354,7 +1810,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_aet_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_aet_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_aet_agg;
@@ -1366,7 +1822,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_pet_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_pet_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_pet_agg;
@@ -1378,7 +1834,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_wetdays_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_wetdays_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_wetdays_agg;
@@ -1390,7 +1846,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_snowpack_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_snowpack_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_snowpack_agg;
@@ -1402,7 +1858,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_deepswc_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_deepswc_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_deepswc_agg;
@@ -1414,7 +1870,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_soiltemp_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_soiltemp_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_soiltemp_agg;
@@ -1426,7 +1882,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_estab_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_estab_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_estab_agg;
@@ -1438,7 +1894,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_co2effects_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_co2effects_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_co2effects_agg;
@@ -1450,7 +1906,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_biomass_text;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_biomass_mem;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_biomass_agg;
@@ -1462,7 +1918,7 @@ void SW_OUT_construct(void)
 			#ifdef SW_OUTTEXT
 			SW_Output[k].pfunc_text = (void (*)(OutPeriod)) get_none;
 			#endif
-			#if defined(RSOILWAT)
+			#if defined(SW_OUTMEM)
 			SW_Output[k].pfunc_mem = (void (*)(OutPeriod)) get_none;
 			#elif defined(STEPWAT)
 			SW_Output[k].pfunc_agg = (void (*)(OutPeriod)) get_none;
@@ -1477,7 +1933,6 @@ void SW_OUT_construct(void)
 
 void SW_OUT_deconstruct(Bool full_reset)
 {
-	#if defined(SW_OUTARRAY) || defined(RSOILWAT)
 	OutKey k;
 	IntU i;
 
@@ -1502,12 +1957,10 @@ void SW_OUT_deconstruct(Bool full_reset)
 		#endif
 	}
 
+	#ifdef SW_OUTARRAY
 	if (full_reset) {
 		SW_OUT_deconstruct_outarray();
 	}
-
-	#else
-	if (full_reset) {} // avoid ``-Wunused-parameter` warning
 	#endif
 }
 
@@ -1822,6 +2275,11 @@ void SW_OUT_new_year(void)
 	/* reset the terminal output days each year  */
 
 	OutKey k;
+	TimeInt first_year, last_year;
+
+	// output is neither summed nor written in years outside of the output years
+	SW_OUT_get_years(&first_year, &last_year);
+	skip_outyear = (Bool) (SW_Model.year < first_year || SW_Model.year > last_year);
 
 	ForEachOutKey(k)
 	{
@@ -1842,6 +2300,8 @@ void SW_OUT_new_year(void)
 		}
 	}
 
+	// Decide which accumulators are rolled up this year
+	set_rollups();
 }
 
 
@@ -1875,13 +2335,6 @@ int SW_OUT_read_onekey(OutKey k, OutSum sumtype, char period[], int first,
 		res = LOGWARN;
 	}
 
-	// set use_SWA to TRUE if defined.
-	// Used in SW_Control to run the functions to get the recalculated values only if SWA is used
-	// This function is run prior to the control functions so thats why it is here.
-	if (k == eSW_SWA) {
-		SW_VegProd.use_SWA = swTRUE;
-	}
-
 	/* Check validity of output key */
 	if (k == eSW_Estab) {
 		SW_Output[k].sumtype = eSW_Sum;
@@ -1934,6 +2387,8 @@ int SW_OUT_read_onekey(OutKey k, OutSum sumtype, char period[], int first,
     monthly (MO), and yearly (YR).
 
     We have two options to specify time steps:
+        - The calendar years of output: Add a line with the tag `OUTYEARS`,
+          e.g., `OUTYEARS 1980 end`; see `SW_OUT_set_years()`.
         - The same time step(s) for every output: Add a line with the tag `TIMESTEP`,
           e.g., `TIMESTEP dy mo yr` will generate daily, monthly, and yearly output for
           every output variable. If there is a line with this tag, then this will
@@ -1955,7 +2410,7 @@ void SW_OUT_read(void)
 	 *             In fact, the only keys to process are
 	 *             TRANSP, PRECIP, and TEMP.
 	 */
-	FILE *f;
+	SW_TEXTFILE f;
 	OutKey k;
 	int x, itemno, msg_type;
 	IntUS i;
@@ -1974,19 +2429,40 @@ void SW_OUT_read(void)
 	int first; /* first doy for output */
 
 	MyFileName = SW_F_name(eOutput);
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
 	itemno = 0;
 
 	_Sep = ','; /* default in case it doesn't show up in the file */
+	SW_OUT_set_years(0, 0); /* default: output all simulated years */
 	used_OUTNPERIODS = 1; // if 'TIMESTEP' is not specified in input file, then only one time step = period can be specified
 	useTimeStep = 0;
 
 
-	while (GetALine(f, inbuf))
+	while (GetATextLine(&f))
 	{
 		itemno++; /* note extra lines will cause an error */
 
-		x = sscanf(inbuf, "%s %s %s %d %s %s", keyname, sumtype, period, &first,
+		// `OUTYEARS` has its own format (years don't fit into `sumtype`)
+		Str_Scan(f.line, "%49s", keyname);
+		if (Str_CompareI(keyname, (char *)"OUTYEARS") == 0)
+		{
+			// condition to read in the OUTYEARS line in outsetup.in
+			x = Str_Scan(f.line, "%49s %d %9s", keyname, &first, period);
+
+			if (x < 3 || first < 0)
+			{
+				CloseTextFile(&f);
+				LogError(logfp, LOGFATAL, "%s : Insufficient or invalid input "
+					"for key %s.", MyFileName, keyname);
+			}
+
+			SW_OUT_set_years((TimeInt) first,
+				!Str_CompareI("END", period) ? 0 : (TimeInt) atoi(period));
+
+			continue; // read next line of `outsetup.in`
+		}
+
+		x = Str_Scan(f.line, "%s %s %s %d %s %s", keyname, sumtype, period, &first,
 				last, outfile);
 
 		// Check whether we have read in `TIMESTEP`, `OUTSEP`, or one of the 'key' lines
@@ -1994,7 +2470,7 @@ void SW_OUT_read(void)
 		{
 			// condition to read in the TIMESTEP line in outsetup.in
 			// need to rescan the line because you are looking for all strings, unlike the original scan
-			used_OUTNPERIODS = sscanf(inbuf, "%s %s %s %s %s", keyname, timeStep[0],
+			used_OUTNPERIODS = Str_Scan(f.line, "%s %s %s %s %s", keyname, timeStep[0],
 					timeStep[1], timeStep[2], timeStep[3]);	// maximum number of possible timeStep is SW_OUTNPERIODS
 			used_OUTNPERIODS--; // decrement the count to make sure to not count keyname in the number of periods
 
@@ -2005,7 +2481,7 @@ void SW_OUT_read(void)
 
 				if (used_OUTNPERIODS > SW_OUTNPERIODS)
 				{
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, "SW_OUT_read: used_OUTNPERIODS = %d > " \
 						"SW_OUTNPERIODS = %d which is illegal.\n",
 						used_OUTNPERIODS, SW_OUTNPERIODS);
@@ -2040,7 +2516,7 @@ void SW_OUT_read(void)
 		// make sure that we got enough input
 		if (x < 6)
 		{
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s : Insufficient input for key %s item %d.",
 				MyFileName, keyname, itemno);
 
@@ -2067,7 +2543,7 @@ void SW_OUT_read(void)
 		if (msg_type != 0) {
 			if (msg_type > 0) {
 				if (msg_type == LOGFATAL) {
-					CloseFile(&f);
+					CloseTextFile(&f);
 				}
 				LogError(logfp, msg_type, "%s", msg);
 			}
@@ -2090,6 +2566,121 @@ void SW_OUT_read(void)
 		}
 	} //end of while-loop
 
+	SW_OUT_setup_requests();
+
+	CloseTextFile(&f);
+
+	if (EchoInits)
+		_echo_outputs();
+}
+
+
+/**
+@brief Request output for one output key without an input file (see
+  `SW_OUT_read()` for the equivalent inputs from `outsetup.in`)
+
+@param k The output key.
+@param sumtype The summary type; `eSW_Off` turns output off.
+@param periods Array of `n_periods` output time steps.
+@param n_periods Number of output time steps (at most `SW_OUTNPERIODS`).
+
+@note Call `SW_OUT_setup_requests()` after all output keys are requested.
+*/
+void SW_OUT_set_request(OutKey k, OutSum sumtype, const OutPeriod periods[],
+	IntUS n_periods)
+{
+	int msg_type;
+	IntUS i;
+	char period[10] = { '\0' }, // set by `SW_OUT_read_onekey()` for `eSW_Estab`
+		msg[200];
+
+	msg_type = SW_OUT_read_onekey(k, sumtype, period, 1, 366, msg);
+
+	if (msg_type > 0) {
+		LogError(logfp, msg_type, "%s", msg);
+	}
+
+	ForEachOutPeriod(i) {
+		timeSteps[k][i] = eSW_NoTime;
+	}
+
+	if (SW_Output[k].use) {
+		if (k == eSW_Estab) {
+			// establishment is only summarized per year, see `SW_OUT_read_onekey()`
+			timeSteps[k][0] = eSW_Year;
+			n_periods = 1;
+
+		} else {
+			n_periods = min(n_periods, (IntUS) SW_OUTNPERIODS);
+			for (i = 0; i < n_periods; i++) {
+				timeSteps[k][i] = periods[i];
+			}
+		}
+
+		used_OUTNPERIODS = max(used_OUTNPERIODS, n_periods);
+	}
+}
+
+
+/**
+@brief Restrict output to a window of calendar years
+
+Output is neither summed nor written (nor allocated by `SW_OUT_set_nrow()`)
+for simulated years before `first_year` or after `last_year`, e.g., for the
+spin-up years of a run; the simulation itself is not affected.
+
+@param first_year First calendar year of output; 0 for the first simulated year.
+@param last_year Last calendar year of output; 0 for the last simulated year.
+
+@note `SW_OUT_read()` calls this routine for the tag `OUTYEARS`
+  and otherwise resets output to all simulated years.
+*/
+void SW_OUT_set_years(TimeInt first_year, TimeInt last_year)
+{
+	if (first_year > 0 && last_year > 0 && last_year < first_year) {
+		LogError(logfp, LOGFATAL, "SW_OUT_set_years: last output year (%u) "
+			"is before the first output year (%u).", last_year, first_year);
+	}
+
+	SW_CurrentRun->Out.first_year = first_year;
+	SW_CurrentRun->Out.last_year = last_year;
+}
+
+
+/**
+@brief Calendar years of output within the simulated years
+
+@param[out] first_year First simulated year with output.
+@param[out] last_year Last simulated year with output.
+
+@note Call this routine after the simulated years are set up,
+  e.g., by `SW_MDL_read()`.
+*/
+void SW_OUT_get_years(TimeInt *first_year, TimeInt *last_year)
+{
+	const SW_OUT_STATE *o = &SW_CurrentRun->Out;
+
+	*first_year = (o->first_year > 0) ?
+		max(o->first_year, SW_Model.startyr) : SW_Model.startyr;
+	*last_year = (o->last_year > 0) ?
+		min(o->last_year, SW_Model.endyr) : SW_Model.endyr;
+
+	if (*last_year < *first_year) {
+		LogError(logfp, LOGFATAL, "SW_OUT_get_years: none of the output years "
+			"is a simulated year (%u-%u).", SW_Model.startyr, SW_Model.endyr);
+	}
+}
+
+
+/**
+@brief Determine the output time periods that are in use after output keys
+  were requested by `SW_OUT_read()` or `SW_OUT_set_request()`
+*/
+void SW_OUT_setup_requests(void)
+{
+	if (_Sep == '\0') {
+		_Sep = ',';
+	}
 
 	// Determine which output periods are turned on for at least one output key
 	find_OutPeriods_inUse();
@@ -2104,22 +2695,31 @@ void SW_OUT_read(void)
 	// Determine number of used years/months/weeks/days in simulation period
 	SW_OUT_set_nrow();
 	#endif
-
-	CloseFile(&f);
-
-	if (EchoInits)
-		_echo_outputs();
 }
 
 
 
 void _collect_values(void) {
+	// output is not used, see `SW_OUTFORMAT_NONE`, or not in this year,
+	// see `SW_OUT_set_years()`
+	if (SW_OutReduce.skip_output || skip_outyear) {
+		return;
+	}
+
+	SW_BENCH_START(eBenchOutSum);
+	SW_PROFILE_START(eProfOutSum);
 	SW_OUT_sum_today(eSWC);
 	SW_OUT_sum_today(eWTH);
 	SW_OUT_sum_today(eVES);
 	SW_OUT_sum_today(eVPD);
+	SW_PROFILE_STOP(eProfOutSum);
+	SW_BENCH_STOP(eBenchOutSum);
 
+	SW_BENCH_START(eBenchOutWrite);
+	SW_PROFILE_START(eProfOutWrite);
 	SW_OUT_write_today();
+	SW_PROFILE_STOP(eProfOutWrite);
+	SW_BENCH_STOP(eBenchOutWrite);
 }
 
 
@@ -2127,6 +2727,10 @@ void _collect_values(void) {
     period.  This sets two module-level flags: bFlush_output and
     tOffset to be used in the appropriate subs.*/
 void SW_OUT_flush(void) {
+	#ifdef SOILWAT
+	OutPeriod pd;
+	#endif
+
 	bFlush_output = swTRUE;
 	tOffset = 0;
 
@@ -2134,6 +2738,20 @@ void SW_OUT_flush(void) {
 
 	bFlush_output = swFALSE;
 	tOffset = 1;
+
+	#ifdef SOILWAT
+	// hand the rows of the year to the writer thread
+	SW_OUT_submit_rows();
+
+	// pass on the rows of the year if output arrays are streamed
+	if (!collect_OUT && !isnull(consumer_OUT)) {
+		ForEachOutPeriod(pd) {
+			if (use_OutPeriod[pd]) {
+				SW_OUT_end_outarray_chunk(pd);
+			}
+		}
+	}
+	#endif
 }
 
 /** adds today's output values to week, month and year
@@ -2159,6 +2777,10 @@ void SW_OUT_sum_today(ObjType otyp)
 		{
 			average_for(otyp, pd);
 
+			// Periods are processed from fine to coarse: roll up the closing
+			// period before the coarser period is aggregated and reset
+			rollup_sums(otyp, pd);
+
 			switch (otyp)
 			{
 				case eSWC:
@@ -2204,9 +2826,9 @@ void SW_OUT_write_today(void)
 	 * sending the string to output.
 	 * Each output quantity must have a print function
 	 * defined and linked to SW_Output.pfunc (currently all
-	 * starting with 'get_').  Those funcs return a properly
-	 * formatted string to be output via the module variable
-	 * 'sw_outstr'. Furthermore, those funcs must know their
+	 * starting with 'get_').  Those funcs append a properly
+	 * formatted string to the output row of their file, see
+	 * 'SW_OUT_text_row()'. Furthermore, those funcs must know their
 	 * own time period.  This version of the program only
 	 * prints one period for each quantity.
 	 *
@@ -2236,11 +2858,20 @@ void SW_OUT_write_today(void)
 	#ifdef SW_OUTTEXT
 	char str_time[10]; // year and day/week/month header for each output row
 
+	// SOILWAT2-standalone may produce binary instead of text output
+	#ifdef SOILWAT
+	Bool print_text = (Bool) !SW_OutBin.skip_csv;
+	#else
+	Bool print_text = print_SW_Output;
+	#endif
+
 	// We don't really need all of these buffers to init every day
 	ForEachOutPeriod(p)
 	{
 		SW_OutFiles.buf_reg[p][0] = '\0';
 		SW_OutFiles.buf_soil[p][0] = '\0';
+		SW_OutFiles.len_reg[p] = 0;
+		SW_OutFiles.len_soil[p] = 0;
 
 		#ifdef STEPWAT
 		SW_OutFiles.buf_reg_agg[p][0] = '\0';
@@ -2293,11 +2924,23 @@ void SW_OUT_write_today(void)
 			}
 
 			#ifdef SOILWAT
-			#ifdef SWDEBUG
-			if (debug) swprintf(" call pfunc_text(%d=%s))",
-				timeSteps[k][i], pd2str[timeSteps[k][i]]);
-			#endif
-			((void (*)(OutPeriod)) SW_Output[k].pfunc_text)(timeSteps[k][i]);
+			if (print_text)
+			{
+				#ifdef SWDEBUG
+				if (debug) swprintf(" call pfunc_text(%d=%s))",
+					timeSteps[k][i], pd2str[timeSteps[k][i]]);
+				#endif
+				((void (*)(OutPeriod)) SW_Output[k].pfunc_text)(timeSteps[k][i]);
+			}
+
+			if (SW_OutBin.use || collect_OUT || !isnull(consumer_OUT))
+			{
+				#ifdef SWDEBUG
+				if (debug) swprintf(" call pfunc_mem(%d=%s))",
+					timeSteps[k][i], pd2str[timeSteps[k][i]]);
+				#endif
+				((void (*)(OutPeriod)) SW_Output[k].pfunc_mem)(timeSteps[k][i]);
+			}
 
 			#elif RSOILWAT
 			#ifdef SWDEBUG
@@ -2345,18 +2988,11 @@ void SW_OUT_write_today(void)
 			if (debug) swprintf(" ... ok");
 			#endif
 
-			#ifdef SW_OUTTEXT
-			/* concatenate formatted output for one row of `csv`- files */
-			if (print_SW_Output)
-			{
-				if (SW_Output[k].has_sl) {
-					strcat(SW_OutFiles.buf_soil[timeSteps[k][i]], sw_outstr);
-				} else {
-					strcat(SW_OutFiles.buf_reg[timeSteps[k][i]], sw_outstr);
-				}
-			}
+			/* `get_XXX_text` functions have already appended their formatted
+			   output to one row of `csv`- files, see `SW_OUT_text_row()` */
 
 			#ifdef STEPWAT
+			/* concatenate aggregated output for one row of `csv`- files */
 			if (print_IterationSummary)
 			{
 				if (SW_Output[k].has_sl) {
@@ -2366,7 +3002,6 @@ void SW_OUT_write_today(void)
 				}
 			}
 			#endif
-			#endif
 		} // end of loop across `used_OUTNPERIODS`
 	} // end of loop across output keys
 
@@ -2381,12 +3016,17 @@ void SW_OUT_write_today(void)
 
 			if (SW_OutFiles.make_regular[p])
 			{
-				if (print_SW_Output) {
+				if (print_text) {
+					#ifdef SOILWAT
+					SW_OUT_write_row(SW_OutFiles.fp_reg[p], str_time,
+						SW_OutFiles.buf_reg[p], SW_OutFiles.len_reg[p]);
+					#else
 					fprintf(SW_OutFiles.fp_reg[p], "%s%s\n",
 						str_time, SW_OutFiles.buf_reg[p]);
 					// STEPWAT2 needs a fflush for yearly output;
 					// other time steps, the soil-layer files, and SOILWAT2 work fine without it...
 					fflush(SW_OutFiles.fp_reg[p]);
+					#endif
 				}
 
 				#ifdef STEPWAT
@@ -2399,9 +3039,14 @@ void SW_OUT_write_today(void)
 
 			if (SW_OutFiles.make_soil[p])
 			{
-				if (print_SW_Output) {
+				if (print_text) {
+					#ifdef SOILWAT
+					SW_OUT_write_row(SW_OutFiles.fp_soil[p], str_time,
+						SW_OutFiles.buf_soil[p], SW_OutFiles.len_soil[p]);
+					#else
 					fprintf(SW_OutFiles.fp_soil[p], "%s%s\n",
 						str_time, SW_OutFiles.buf_soil[p]);
+					#endif
 				}
 
 				#ifdef STEPWAT
@@ -2423,6 +3068,14 @@ void SW_OUT_write_today(void)
 		if (use_OutPeriod[p] && writeit[p])
 		{
 			irow_OUT[p]++;
+
+			#ifdef SOILWAT
+			// pass on a complete chunk of rows to binary output and/or consumer
+			// (output arrays of the full run are passed on when files are closed)
+			if (!collect_OUT && irow_OUT[p] == nrow_OUT[p]) {
+				SW_OUT_end_outarray_chunk(p);
+			}
+			#endif
 		}
 	}
 	#endif
@@ -2478,8 +3131,10 @@ void SW_OUT_SetMemoryRefs( void)
 
 	ForEachOutKey(k)
 	{
+		#ifdef RSOILWAT
 		if (SW_Output[k].use)
-		//NoteMemoryRef(SW_Output[k].outfile);
+			NoteMemoryRef(SW_Output[k].outfile);
+		#endif
 	}
 
 }
@@ -2531,9 +3186,10 @@ void SW_OUT_SetMemoryRefs( void)
   There are four types of outputs and thus four types of output formatter
   functions `get_XXX` in file \ref SW_Output_get_functions.c
     - output to text files of current simulation:
-      - output formatter function such as `get_XXX_text` which prepare a
-        formatted text string in the global variable \ref sw_outstr which is
-        concatenated and written to the text files by SW_OUT_write_today()
+      - output formatter function such as `get_XXX_text` which append a
+        formatted text string to the output row of their text file (see
+        SW_OUT_text_row()) which is written to the text files by
+        SW_OUT_write_today()
       - these output formatter functions are assigned to pointers
         `SW_Output[k].pfunc_text` and called by SW_OUT_write_today()
       - currently used by `SOILWAT2-standalone` and by `STEPWAT2` if executed
@@ -2570,7 +3226,10 @@ void SW_OUT_SetMemoryRefs( void)
         values directly in the appropriate elements of \ref p_OUT
       - these output formatter functions are assigned to pointers
         `SW_Output[k].pfunc_mem` and called by SW_OUT_write_today()
-      - currently used by `rSOILWAT2`
+      - currently used by `rSOILWAT2` and by `SOILWAT2-standalone` for
+        binary output (\ref p_OUT holds a chunk of rows) and for
+        output arrays of the full simulation run that are passed to a calling
+        program, see SW_OUT_get_outarray()
 
 
   __Below text is outdated as of June 2018 (retained until updated):__
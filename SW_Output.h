@@ -42,11 +42,27 @@ extern "C" {
 #endif
 
 
-// Array-based output:
-#if defined(RSOILWAT) || defined(STEPWAT)
+// Array-based output: rSOILWAT2, STEPWAT2, and binary output of
+// SOILWAT2-standalone (see `SW_Output_outbin.c`)
+#if defined(RSOILWAT) || defined(STEPWAT) || defined(SOILWAT)
 #define SW_OUTARRAY
 #endif
 
+/** Type of the values of the output arrays `p_OUT` (and `p_OUTsd`):
+    `double` or, if compiled with `-DSW_OUTFLOAT`, `float` which halves
+    their memory; all calculations remain in double precision */
+#ifdef SW_OUTFLOAT
+typedef float RealOut;
+#else
+typedef RealD RealOut;
+#endif
+
+// Array-based output of values for each simulation run with the
+// `get_XXX_mem` functions: rSOILWAT2 and SOILWAT2-standalone
+#if defined(RSOILWAT) || defined(SOILWAT)
+#define SW_OUTMEM
+#endif
+
 // Text-based output:
 #if defined(SOILWAT) || defined(STEPWAT)
 #define SW_OUTTEXT
@@ -140,6 +156,18 @@ typedef enum {
 } OutKey;
 
 
+/* derived quantities that the daily loop calculates only if
+   at least one requested output key requires them */
+#define SW_NDERIVED 4
+
+typedef enum {
+	eSW_DerivedSWA, /* vegetation-type specific available soil water, see calculate_repartitioned_soilwater() */
+	eSW_DerivedWetDays, /* wet state of soil layers */
+	eSW_DerivedEvapSoil, /* bare-soil evaporation summed across vegetation types for each layer */
+	eSW_DerivedEstab /* establishment checks, see SW_VES_checkestab() */
+} OutDerived;
+
+
 /* summary methods */
 #define SW_SUM_OFF "OFF"  /* don't output */
 #define SW_SUM_SUM "SUM"  /* sum for period */
@@ -166,8 +194,11 @@ typedef struct {
 	void (*pfunc_text)(OutPeriod); /* pointer to output routine for text output */
 	#endif
 
-	#if defined(RSOILWAT)
+	#if defined(SW_OUTMEM)
 	void (*pfunc_mem)(OutPeriod); /* pointer to output routine for array output */
+	#endif
+
+	#if defined(RSOILWAT)
 	char *outfile; /* name of output */ //could probably be removed
 
 	#elif defined(STEPWAT)
@@ -177,6 +208,19 @@ typedef struct {
 } SW_OUTPUT;
 
 
+/** An output key that is active for an output period: `collect_sums()` and
+  `average_for()` call the summary functions of these entries only */
+typedef struct {
+	OutKey key;
+	ObjType obj;
+	OutPeriod rollup_to; /* coarser period into which the accumulators are added when this period closes; eSW_NoTime if none */
+	Bool is_rolledup; /* TRUE if the accumulators are rolled up from a finer period instead of summed daily */
+	void (*pfunc_sum)(OutKey, OutPeriod); /* adds today's values to the accumulators; NULL if not needed */
+	void (*pfunc_avg)(OutKey, OutPeriod, RealD); /* aggregates the accumulators; NULL if not needed */
+	void (*pfunc_rollup)(OutKey, OutPeriod, OutPeriod); /* adds the accumulators to those of a coarser period */
+} SW_OUT_ACTIVEKEY;
+
+
 /* convenience loops for consistency.
  * k must be a defined variable, either of OutKey type
  * or int (IntU is better).
@@ -185,6 +229,7 @@ typedef struct {
 #define ForEachSWC_OutKey(k) for((k)=eSW_AllH2O;  (k)<=eSW_SnowPack; (k)++)
 #define ForEachWTH_OutKey(k) for((k)=eSW_AllWthr; (k)<=eSW_Precip;   (k)++)
 #define ForEachVES_OutKey(k) for((k)=eSW_AllVeg;  (k)<=eSW_Estab;    (k)++)
+#define ForEachOutDerived(d) for((d)=eSW_DerivedSWA; (d)<SW_NDERIVED; (d)++)
 
 
 
@@ -197,6 +242,11 @@ void SW_OUT_new_year(void);
 int SW_OUT_read_onekey(OutKey k, OutSum sumtype, char period[], int first,
 	int last, char msg[]);
 void SW_OUT_read(void);
+void SW_OUT_set_request(OutKey k, OutSum sumtype, const OutPeriod periods[],
+	IntUS n_periods);
+void SW_OUT_setup_requests(void);
+void SW_OUT_set_years(TimeInt first_year, TimeInt last_year);
+void SW_OUT_get_years(TimeInt *first_year, TimeInt *last_year);
 void SW_OUT_sum_today(ObjType otyp);
 void SW_OUT_write_today(void);
 void SW_OUT_write_year(void);
@@ -216,14 +266,15 @@ void SW_OUT_set_SXWrequests(void);
 #endif
 
 
-// Functions that format the output in `sw_outstr` for printing
+// Functions that format the output for printing
 /* --------------------------------------------------- */
 /* each of these get_<envparm> -type funcs return a
  * formatted string of the appropriate type and are
  * pointed to by SW_Output[k].pfunc so they can be called
  * anonymously by looping over the Output[k] list
  * (see _output_today() for usage.)
- * they all use the global-level string sw_outstr[].
+ * the text versions append to the output row of their text file
+ * (see SW_OUT_text_row()).
  */
 /* 10-May-02 (cwb) Added conditionals for interfacing with STEPPE
  * 05-Mar-03 (cwb) Added code for max,min,avg. Previously, only avg was output.
@@ -261,7 +312,7 @@ void get_co2effects_text(OutPeriod pd);
 void get_biomass_text(OutPeriod pd);
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 void get_temp_mem(OutPeriod pd);
 void get_precip_mem(OutPeriod pd);
 void get_vwcBulk_mem(OutPeriod pd);
@@ -0,0 +1,238 @@
+/********************************************************/
+/********************************************************/
+/**
+  @file
+  @brief Output functionality for output digests: streaming summaries of
+  the values of each output key and output period
+
+  Values are obtained by the array-based `get_XXX_mem` functions (see
+  `SW_Output_get_functions.c`) into the output arrays `p_OUT` while
+  `SW_OUT_write_today()` runs; the digest consumes them in chunks of one
+  year (see `SW_OUT_set_outarray_consumer()`) so that memory is independent
+  of the length of the run. Only the digest file is written, see
+  `SW_Output_digest.h` for its format.
+
+  See the \ref out_algo "output algorithm documentation" for details.
+
+  History:
+  (2026-10-15) -- INITIAL CODING
+*/
+/********************************************************/
+/********************************************************/
+
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "generic.h"
+#include "filefuncs.h"
+
+#include "SW_Defines.h"
+#include "SW_Files.h"
+
+#include "SW_Output.h"
+#include "SW_Output_outarray.h"
+#include "SW_Output_digest.h"
+#include "SW_Run.h"
+
+
+#define FNV_OFFSET 14695981039346656037ULL /**< FNV-1a 64-bit offset basis */
+#define FNV_PRIME 1099511628211ULL /**< FNV-1a 64-bit prime */
+
+
+/* =================================================== */
+/*                  Global Variables                   */
+/* --------------------------------------------------- */
+
+// `SW_Output`, `use_OutPeriod`, and `SW_OutDigest` are part of the
+// simulation run context, see SW_Run.h
+
+// defined in `SW_Output.c`
+extern char const *key2str[];
+extern char const *pd2longstr[];
+
+// defined in `SW_Output_outarray.c`
+extern const IntUS ncol_TimeOUT[];
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Declarations            */
+/* --------------------------------------------------- */
+
+static uint64_t hash_word(uint64_t h, uint64_t w);
+static uint64_t hash_value(uint64_t h, double x);
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Add the 8 bytes of `w` (least significant first, independent of the
+    byte order of the machine) to the FNV-1a hash `h` */
+static uint64_t hash_word(uint64_t h, uint64_t w) {
+	unsigned int i;
+
+	for (i = 0; i < 8; i++) {
+		h ^= (w >> (8 * i)) & 0xFF;
+		h *= FNV_PRIME;
+	}
+
+	return h;
+}
+
+
+/** Add the quantized value `x` to the hash `h`: its binary exponent and
+    its mantissa rounded to `SW_OUT_DIGEST_TOL`; values that are smaller
+    than `SW_OUT_DIGEST_TOL` are zero, non-finite values are tagged */
+static uint64_t hash_value(uint64_t h, double x) {
+	int e = 0;
+	double m = 0.;
+
+	if (isnan(x)) {
+		e = 0x7FFF;
+
+	} else if (isinf(x)) {
+		e = 0x7FFF;
+		m = (x > 0.) ? 1. : -1.;
+
+	} else if (fabs(x) >= SW_OUT_DIGEST_TOL) {
+		m = floor(frexp(x, &e) / SW_OUT_DIGEST_TOL + 0.5);
+	}
+
+	h = hash_word(h, (uint64_t) (int64_t) e);
+	return hash_word(h, (uint64_t) (int64_t) m);
+}
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Function Definitions                    */
+/*             (declared in SW_Output_digest.h)        */
+/* --------------------------------------------------- */
+
+/**
+@brief Start the digest of each output key and output period
+
+@note `SW_OUT_create_files()` calls this routine if `SW_OUTFORMAT_DIGEST`
+  is requested.
+*/
+void SW_OUT_init_digest(void) {
+	OutKey k;
+	OutPeriod pd;
+
+	memset(SW_OutDigest.s, 0, sizeof SW_OutDigest.s);
+
+	ForEachOutKey(k) {
+		ForEachOutPeriod(pd) {
+			SW_OutDigest.s[k][pd].hash = FNV_OFFSET;
+		}
+	}
+}
+
+
+/**
+@brief Add a chunk of rows of an output array to the digest of its
+  output key and output period
+
+This is the consumer of output arrays (see `SW_OUTARRAY_CONSUMER`) that
+`SW_OUT_set_format()` registers for `SW_OUTFORMAT_DIGEST`; the time columns
+are not part of the digest.
+
+@param k The output key.
+@param pd The output time step.
+@param p The chunk: `ncol` columns of `nrow` values; column `i` starts
+  at `p + i * stride`.
+@param nrow Number of rows of the chunk.
+@param stride Distance between consecutive columns.
+@param ncol Number of columns including the time columns.
+@param data Not used.
+*/
+void SW_OUT_digest_chunk(OutKey k, OutPeriod pd, const RealOut *p,
+	size_t nrow, size_t stride, IntUS ncol, void *data) {
+
+	SW_OUT_DIGEST_STATS *s = &SW_OutDigest.s[k][pd];
+	size_t r;
+	IntUS i;
+	double x;
+
+	(void) data;
+
+	for (r = 0; r < nrow; r++) {
+		for (i = ncol_TimeOUT[pd]; i < ncol; i++) {
+			x = (double) p[r + i * stride];
+
+			if (isnan(x)) {
+				s->n_nan++;
+
+			} else if (s->count == s->n_nan) {
+				s->sum = s->min = s->max = x;
+
+			} else {
+				s->sum += x;
+				s->min = fmin(s->min, x);
+				s->max = fmax(s->max, x);
+			}
+
+			s->count++;
+			s->hash = hash_value(s->hash, x);
+		}
+	}
+}
+
+
+/**
+@brief Write the digest of the active run to `SW_OUT_DIGEST_FILENAME` in
+  its output directory
+
+@note `SW_OUT_close_files()` calls this routine after the last rows are
+  passed to `SW_OUT_digest_chunk()`.
+*/
+void SW_OUT_write_digest(void) {
+	char fname[MAX_FILENAMESIZE];
+	FILE *f;
+	OutKey k;
+	OutPeriod pd;
+	const SW_OUT_DIGEST_STATS *s;
+
+	SW_OutputPrefix(fname);
+	strcat(fname, SW_OUT_DIGEST_FILENAME);
+
+	f = OpenFile(fname, "w");
+	fprintf(f, "key,period,count,nan,sum,min,max,hash\n");
+
+	ForEachOutKey(k) {
+		ForEachOutPeriod(pd) {
+			if (!SW_Output[k].use || !has_OutPeriod_inUse(pd, k)) {
+				continue;
+			}
+
+			s = &SW_OutDigest.s[k][pd];
+			fprintf(f, "%s,%s,%llu,%llu,", key2str[k], pd2longstr[pd],
+				(unsigned long long) s->count, (unsigned long long) s->n_nan);
+
+			if (s->count > s->n_nan) {
+				fprintf(f, "%.17g,%.17g,%.17g,", s->sum, s->min, s->max);
+			} else {
+				fprintf(f, "NA,NA,NA,");
+			}
+
+			fprintf(f, "%016llx\n", (unsigned long long) s->hash);
+		}
+	}
+
+	if (ferror(f)) {
+		CloseFile(&f);
+		LogError(logfp, LOGFATAL, "%s : Cannot write output digest.", fname);
+	}
+
+	CloseFile(&f);
+}
@@ -0,0 +1,70 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Output_digest.h
+  Type: header
+  Purpose: Support for SW_Output_digest.c
+  Application: SOILWAT - soilwater dynamics simulator
+  Purpose: define functions to deal with output digests;
+    currently, used by SOILWAT2-standalone
+
+    An output digest (`SW_OUT_DIGEST_FILENAME` in the output directory)
+    is a `csv` file with one line per used output key and output period:
+      - `count`: number of values (rows times columns without the time
+        columns),
+      - `nan`: number of values that are not a number,
+      - `sum`, `min`, `max` of the other values, and
+      - `hash`: a 64-bit FNV-1a hash (16 hex digits) of all values in the
+        order of the rows and, within a row, of the columns; each value is
+        quantized to `SW_OUT_DIGEST_TOL` relative to its magnitude (values
+        that are smaller than `SW_OUT_DIGEST_TOL` count as zero) so that
+        runs whose outputs differ only by rounding usually hash identical.
+
+    Digests of two runs are compared instead of their output files; only
+    runs with different digests need a comparison of their full outputs.
+
+  History:
+  (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_OUTPUT_DIGEST_H
+#define SW_OUTPUT_DIGEST_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define SW_OUT_DIGEST_FILENAME "sw2_digest.csv" /**< name of the digest in the output directory */
+#define SW_OUT_DIGEST_TOL 1e-6 /**< relative tolerance of the quantized values of the hash */
+
+/** Streaming digest of the values of one output key and output period */
+typedef struct {
+	uint64_t count, /**< number of values */
+		n_nan, /**< number of values that are not a number */
+		hash; /**< FNV-1a hash of the quantized values */
+	double sum, min, max; /**< of the values that are a number */
+} SW_OUT_DIGEST_STATS;
+
+/** Output digest of a simulation run; zero-initialized means no digest */
+typedef struct {
+	Bool use; /**< TRUE if a digest is requested, see `SW_OUTFORMAT_DIGEST` */
+	SW_OUT_DIGEST_STATS s[SW_OUTNKEYS][SW_OUTNPERIODS];
+} SW_OUT_DIGEST;
+
+
+// Function declarations
+void SW_OUT_init_digest(void);
+void SW_OUT_digest_chunk(OutKey k, OutPeriod pd, const RealOut *p,
+	size_t nrow, size_t stride, IntUS ncol, void *data);
+void SW_OUT_write_digest(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -64,49 +64,35 @@
 #include "SW_Output_outtext.h"
 #endif
 
+#include "SW_Run.h"
+
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_SITE SW_Site;
-extern SW_SOILWAT SW_Soilwat;
-extern SW_MODEL SW_Model;
-extern SW_WEATHER SW_Weather;
-extern SW_VEGPROD SW_VegProd;
-extern SW_VEGESTAB SW_VegEstab;
-extern SW_CARBON SW_Carbon;
 
-extern IntUS ncol_OUT[];
+// `ncol_OUT`, `tOffset`, `_Sep`, `SW_OutFiles`, `p_OUT`, `nrow_OUT`, and
+// `irow_OUT` are part of the simulation run context, see SW_Run.h
 
 #ifdef STEPWAT
 extern Bool prepare_IterationSummary;
 extern ModelType *Globals; // defined in `ST_Main.c`
 extern GlobalType SuperGlobals;
 extern SXW_t* SXW; // structure to store values in and pass back to STEPPE
-extern TimeInt tOffset; // defined in `SW_Output.c`
 #endif
 
 // Text-based output: defined in `SW_Output_outtext.c`:
 #ifdef SW_OUTTEXT
-extern SW_FILE_STATUS SW_OutFiles;
-extern char _Sep;
-extern char sw_outstr[];
 extern Bool print_IterationSummary;
 #endif
 #ifdef STEPWAT
-extern char sw_outstr_agg[];
+extern SW_THREAD_LOCAL char sw_outstr_agg[];
 #endif
 
 
 // Array-based output: defined in `SW_Output_outarray.c`
 #ifdef SW_OUTARRAY
-extern RealD *p_OUT[SW_OUTNKEYS][SW_OUTNPERIODS];
 extern IntUS ncol_TimeOUT[];
-extern size_t nrow_OUT[];
-extern size_t irow_OUT[];
-#endif
-#ifdef STEPWAT
-extern RealD *p_OUTsd[SW_OUTNKEYS][SW_OUTNPERIODS];
 #endif
 
 
@@ -116,9 +102,9 @@ extern RealD *p_OUTsd[SW_OUTNKEYS][SW_OUTNPERIODS];
 /* --------------------------------------------------- */
 
 #ifdef STEPWAT
-static void format_IterationSummary(RealD *p, RealD *psd, OutPeriod pd,
+static void format_IterationSummary(RealOut *p, RealOut *psd, OutPeriod pd,
 	IntUS N);
-static void format_IterationSummary2(RealD *p, RealD *psd, OutPeriod pd,
+static void format_IterationSummary2(RealOut *p, RealOut *psd, OutPeriod pd,
 	IntUS N1, IntUS N2, IntUS offset);
 #endif
 
@@ -128,7 +114,7 @@ static void format_IterationSummary2(RealD *p, RealD *psd, OutPeriod pd,
 /* --------------------------------------------------- */
 
 #ifdef STEPWAT
-static void format_IterationSummary(RealD *p, RealD *psd, OutPeriod pd, IntUS N)
+static void format_IterationSummary(RealOut *p, RealOut *psd, OutPeriod pd, IntUS N)
 {
 	IntUS i;
 	size_t n;
@@ -146,7 +132,7 @@ static void format_IterationSummary(RealD *p, RealD *psd, OutPeriod pd, IntUS N)
 	}
 }
 
-static void format_IterationSummary2(RealD *p, RealD *psd, OutPeriod pd,
+static void format_IterationSummary2(RealOut *p, RealOut *psd, OutPeriod pd,
 	IntUS N1, IntUS N2, IntUS offset)
 {
 	IntUS k, i;
@@ -202,37 +188,34 @@ void get_co2effects_text(OutPeriod pd) {
 	int k;
 	SW_VEGPROD *v = &SW_VegProd;
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
-
-	if (pd) {} // hack to silence "-Wunused-parameter"
+	char *s = SW_OUT_text_row(eSW_CO2Effects, pd);
 
 	ForEachVegType(k) {
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS,
-			v->veg[k].co2_multipliers[BIO_INDEX][SW_Model.simyear]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s,
+			v->veg[k].co2_multipliers[BIO_INDEX]);
 	}
 	ForEachVegType(k) {
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS,
-			v->veg[k].co2_multipliers[WUE_INDEX][SW_Model.simyear]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s,
+			v->veg[k].co2_multipliers[WUE_INDEX]);
 	}
+
+	SW_OUT_text_row_end(eSW_CO2Effects, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 void get_co2effects_mem(OutPeriod pd) {
 	int k;
 	SW_VEGPROD *v = &SW_VegProd;
 
-	RealD *p = p_OUT[eSW_CO2Effects][pd];
+	RealOut *p = p_OUT[eSW_CO2Effects][pd];
 	get_outvalleader(p, pd);
 
 	// No averaging or summing required:
 	ForEachVegType(k)
 	{
-		p[iOUT(k, pd)] = v->veg[k].co2_multipliers[BIO_INDEX][SW_Model.simyear];
-		p[iOUT(k + NVEGTYPES, pd)] = v->veg[k].co2_multipliers[WUE_INDEX][SW_Model.simyear];
+		p[iOUT(k, pd)] = v->veg[k].co2_multipliers[BIO_INDEX];
+		p[iOUT(k + NVEGTYPES, pd)] = v->veg[k].co2_multipliers[WUE_INDEX];
 	}
 }
 
@@ -241,16 +224,16 @@ void get_co2effects_agg(OutPeriod pd) {
 	int k;
 	SW_VEGPROD *v = &SW_VegProd;
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_CO2Effects][pd],
 		*psd = p_OUTsd[eSW_CO2Effects][pd];
 
 	ForEachVegType(k)
 	{
 		do_running_agg(p, psd, iOUT(k, pd), Globals->currIter,
-			v->veg[k].co2_multipliers[BIO_INDEX][SW_Model.simyear]);
+			v->veg[k].co2_multipliers[BIO_INDEX]);
 		do_running_agg(p, psd, iOUT(k + NVEGTYPES, pd), Globals->currIter,
-			v->veg[k].co2_multipliers[WUE_INDEX][SW_Model.simyear]);
+			v->veg[k].co2_multipliers[WUE_INDEX]);
 	}
 
 	if (print_IterationSummary) {
@@ -277,47 +260,39 @@ void get_biomass_text(OutPeriod pd) {
 		biolive_total += vo->veg[k].biolive * v->veg[k].cov.fCover;
 	}
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_Biomass, pd);
 
 	// fCover for NVEGTYPES plus bare-ground
-	sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, v->bare_cov.fCover);
-	strcat(sw_outstr, str);
+	s = SW_OUT_put_dbl(s, v->bare_cov.fCover);
 	ForEachVegType(k) {
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, v->veg[k].cov.fCover);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, v->veg[k].cov.fCover);
 	}
 
 	// biomass (g/m2 as component of total) for NVEGTYPES plus totals and litter
-	sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, biomass_total);
-	strcat(sw_outstr, str);
+	s = SW_OUT_put_dbl(s, biomass_total);
 	ForEachVegType(k) {
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS,
-			vo->veg[k].biomass * v->veg[k].cov.fCover);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->veg[k].biomass * v->veg[k].cov.fCover);
 	}
-	sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, litter_total);
-	strcat(sw_outstr, str);
+	s = SW_OUT_put_dbl(s, litter_total);
 
 	// biolive (g/m2 as component of total) for NVEGTYPES plus totals
-	sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, biolive_total);
-	strcat(sw_outstr, str);
+	s = SW_OUT_put_dbl(s, biolive_total);
 	ForEachVegType(k) {
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS,
-			vo->veg[k].biolive * v->veg[k].cov.fCover);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->veg[k].biolive * v->veg[k].cov.fCover);
 	}
+
+	SW_OUT_text_row_end(eSW_Biomass, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 void get_biomass_mem(OutPeriod pd) {
 	int k, i;
 	RealD biomass_total = 0., litter_total = 0., biolive_total = 0.;
 	SW_VEGPROD *v = &SW_VegProd;
 	SW_VEGPROD_OUTPUTS *vo = SW_VegProd.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_Biomass][pd];
+	RealOut *p = p_OUT[eSW_Biomass][pd];
 	get_outvalleader(p, pd);
 
 	// scale total biomass by fCover to obtain 100% total cover biomass
@@ -359,7 +334,7 @@ void get_biomass_agg(OutPeriod pd) {
 	SW_VEGPROD *v = &SW_VegProd;
 	SW_VEGPROD_OUTPUTS *vo = SW_VegProd.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_Biomass][pd],
 		*psd = p_OUTsd[eSW_Biomass][pd];
 
@@ -429,27 +404,25 @@ void get_estab_text(OutPeriod pd)
 	SW_VEGESTAB *v = &SW_VegEstab;
 	IntU i;
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
-
-	i = (IntU) pd; // silence `-Wunused-parameter`
+	char *s = SW_OUT_text_row(eSW_Estab, pd);
 
 	for (i = 0; i < v->count; i++)
 	{
-		sprintf(str, "%c%d", _Sep, v->parms[i]->estab_doy);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_int(s, v->parms[i]->estab_doy);
 	}
+
+	SW_OUT_text_row_end(eSW_Estab, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 /**
 @brief The establishment check produces, for each species in the given set,
 			a day of year >= 0 that the species established itself in the current year.
 			The output will be a single row of numbers for each year. Each column
 			represents a species in order it was entered in the stabs.in file. The
 			value will be the day that the species established, or - if it didn't
-			establish this year.  This check is for RSOILWAT.
+			establish this year.  This check is for array-based output.
 
 @param pd Period.
 */
@@ -458,7 +431,7 @@ void get_estab_mem(OutPeriod pd)
 	SW_VEGESTAB *v = &SW_VegEstab;
 	IntU i;
 
-	RealD *p = p_OUT[eSW_Estab][pd];
+	RealOut *p = p_OUT[eSW_Estab][pd];
 	get_outvalleader(p, pd);
 
 	for (i = 0; i < v->count; i++)
@@ -483,7 +456,7 @@ void get_estab_agg(OutPeriod pd)
 	SW_VEGESTAB *v = &SW_VegEstab;
 	IntU i;
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_Estab][pd],
 		*psd = p_OUTsd[eSW_Estab][pd];
 
@@ -513,16 +486,17 @@ void get_temp_text(OutPeriod pd)
 {
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	sw_outstr[0] = '\0';
-	sprintf(sw_outstr, "%c%.*f%c%.*f%c%.*f%c%.*f",
-		_Sep, OUT_DIGITS, vo->temp_max,
-		_Sep, OUT_DIGITS, vo->temp_min,
-		_Sep, OUT_DIGITS, vo->temp_avg,
-		_Sep, OUT_DIGITS, vo->surfaceTemp);
+	char *s = SW_OUT_text_row(eSW_Temp, pd);
+	s = SW_OUT_put_dbl(s, vo->temp_max);
+	s = SW_OUT_put_dbl(s, vo->temp_min);
+	s = SW_OUT_put_dbl(s, vo->temp_avg);
+	s = SW_OUT_put_dbl(s, vo->surfaceTemp);
+
+	SW_OUT_text_row_end(eSW_Temp, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets temp text from SW_WEATHER_OUTPUTS when dealing with RSOILWAT.
@@ -533,7 +507,7 @@ void get_temp_mem(OutPeriod pd)
 {
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_Temp][pd];
+	RealOut *p = p_OUT[eSW_Temp][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->temp_max;
@@ -553,7 +527,7 @@ void get_temp_agg(OutPeriod pd)
 {
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_Temp][pd],
 		*psd = p_OUTsd[eSW_Temp][pd];
 
@@ -601,17 +575,18 @@ void get_precip_text(OutPeriod pd)
 {
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	sw_outstr[0] = '\0';
-	sprintf(sw_outstr, "%c%.*f%c%.*f%c%.*f%c%.*f%c%.*f",
-		_Sep, OUT_DIGITS, vo->ppt,
-		_Sep, OUT_DIGITS, vo->rain,
-		_Sep, OUT_DIGITS, vo->snow,
-		_Sep, OUT_DIGITS, vo->snowmelt,
-		_Sep, OUT_DIGITS, vo->snowloss);
+	char *s = SW_OUT_text_row(eSW_Precip, pd);
+	s = SW_OUT_put_dbl(s, vo->ppt);
+	s = SW_OUT_put_dbl(s, vo->rain);
+	s = SW_OUT_put_dbl(s, vo->snow);
+	s = SW_OUT_put_dbl(s, vo->snowmelt);
+	s = SW_OUT_put_dbl(s, vo->snowloss);
+
+	SW_OUT_text_row_end(eSW_Precip, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets precipitation text from SW_WEATHER_OUTPUTS when dealing with RSOILWAT.
@@ -622,7 +597,7 @@ void get_precip_mem(OutPeriod pd)
 {
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_Precip][pd];
+	RealOut *p = p_OUT[eSW_Precip][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->ppt;
@@ -643,7 +618,7 @@ void get_precip_agg(OutPeriod pd)
 {
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_Precip][pd],
 		*psd = p_OUTsd[eSW_Precip][pd];
 
@@ -692,19 +667,18 @@ void get_vwcBulk_text(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_VWCBulk, pd);
 
 	ForEachSoilLayer(i) {
 		/* vwcBulk at this point is identical to swcBulk */
-		sprintf(str, "%c%.*f",
-			_Sep, OUT_DIGITS, vo->vwcBulk[i] / SW_Site.lyr[i]->width);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->vwcBulk[i] / SW_Site.width[i]);
 	}
+
+	SW_OUT_text_row_end(eSW_VWCBulk, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets vwcBulk text from SW_SOILWAT_OUTPUTS when dealing with RSOILWAT.
@@ -716,12 +690,12 @@ void get_vwcBulk_mem(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_VWCBulk][pd];
+	RealOut *p = p_OUT[eSW_VWCBulk][pd];
 	get_outvalleader(p, pd);
 
 	ForEachSoilLayer(i) {
 		/* vwcBulk at this point is identical to swcBulk */
-		p[iOUT(i, pd)] = vo->vwcBulk[i] / SW_Site.lyr[i]->width;
+		p[iOUT(i, pd)] = vo->vwcBulk[i] / SW_Site.width[i];
 	}
 }
 
@@ -737,14 +711,14 @@ void get_vwcBulk_agg(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_VWCBulk][pd],
 		*psd = p_OUTsd[eSW_VWCBulk][pd];
 
 	ForEachSoilLayer(i) {
 		/* vwcBulk at this point is identical to swcBulk */
 		do_running_agg(p, psd, iOUT(i, pd), Globals->currIter,
-			vo->vwcBulk[i] / SW_Site.lyr[i]->width);
+			vo->vwcBulk[i] / SW_Site.width[i]);
 	}
 
 	if (print_IterationSummary) {
@@ -769,21 +743,20 @@ void get_vwcMatric_text(OutPeriod pd)
 	RealD convert;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_VWCMatric, pd);
 
 	ForEachSoilLayer(i) {
 		/* vwcMatric at this point is identical to swcBulk */
-		convert = 1. / (1. - SW_Site.lyr[i]->fractionVolBulk_gravel) / SW_Site.lyr[i]->width;
+		convert = 1. / (1. - SW_Site.fractionVolBulk_gravel[i]) / SW_Site.width[i];
 
-		sprintf(str, "%c%.*f",
-			_Sep, OUT_DIGITS, vo->vwcMatric[i] * convert);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->vwcMatric[i] * convert);
 	}
+
+	SW_OUT_text_row_end(eSW_VWCMatric, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets vwcMatric text from SW_SOILWAT_OUTPUTS when dealing with RSOILWAT.
@@ -796,12 +769,12 @@ void get_vwcMatric_mem(OutPeriod pd)
 	RealD convert;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_VWCMatric][pd];
+	RealOut *p = p_OUT[eSW_VWCMatric][pd];
 	get_outvalleader(p, pd);
 
 	ForEachSoilLayer(i) {
 		/* vwcMatric at this point is identical to swcBulk */
-		convert = 1. / (1. - SW_Site.lyr[i]->fractionVolBulk_gravel) / SW_Site.lyr[i]->width;
+		convert = 1. / (1. - SW_Site.fractionVolBulk_gravel[i]) / SW_Site.width[i];
 		p[iOUT(i, pd)] = vo->vwcMatric[i] * convert;
 	}
 }
@@ -819,13 +792,13 @@ void get_vwcMatric_agg(OutPeriod pd)
 	RealD convert;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_VWCMatric][pd],
 		*psd = p_OUTsd[eSW_VWCMatric][pd];
 
 	ForEachSoilLayer(i) {
 		/* vwcMatric at this point is identical to swcBulk */
-		convert = 1. / (1. - SW_Site.lyr[i]->fractionVolBulk_gravel) / SW_Site.lyr[i]->width;
+		convert = 1. / (1. - SW_Site.fractionVolBulk_gravel[i]) / SW_Site.width[i];
 
 		do_running_agg(p, psd, iOUT(i, pd), Globals->currIter,
 			vo->vwcMatric[i] * convert);
@@ -854,21 +827,21 @@ void get_swa_text(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_SWA, pd);
 
 	ForEachVegType(k)
 	{
 		ForEachSoilLayer(i)
 		{
-			sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->SWA_VegType[k][i]);
-			strcat(sw_outstr, str);
+			s = SW_OUT_put_dbl(s, vo->SWA_VegType[k][i]);
 		}
 	}
+
+	SW_OUT_text_row_end(eSW_SWA, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets SWA text from SW_SOILWAT_OUTPUTS when dealing with RSOILWAT.
@@ -881,7 +854,7 @@ void get_swa_mem(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SWA][pd];
+	RealOut *p = p_OUT[eSW_SWA][pd];
 	get_outvalleader(p, pd);
 
 	ForEachVegType(k)
@@ -906,7 +879,7 @@ void get_swa_agg(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SWA][pd],
 		*psd = p_OUTsd[eSW_SWA][pd];
 
@@ -940,18 +913,18 @@ void get_swcBulk_text(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_SWCBulk, pd);
 
 	ForEachSoilLayer(i)
 	{
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->swcBulk[i]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->swcBulk[i]);
 	}
+
+	SW_OUT_text_row_end(eSW_SWCBulk, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets swcBulk text from SW_SOILWAT_OUTPUTS when dealing with RSOILWAT.
@@ -963,7 +936,7 @@ void get_swcBulk_mem(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SWCBulk][pd];
+	RealOut *p = p_OUT[eSW_SWCBulk][pd];
 	get_outvalleader(p, pd);
 
 	ForEachSoilLayer(i)
@@ -984,7 +957,7 @@ void get_swcBulk_agg(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SWCBulk][pd],
 		*psd = p_OUTsd[eSW_SWCBulk][pd];
 
@@ -1032,26 +1005,25 @@ void get_swcBulk_SXW(OutPeriod pd)
 */
 void get_swpMatric_text(OutPeriod pd)
 {
-	RealD val;
+	RealD swp[MAX_LAYERS];
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_SWPMatric, pd);
+
+	/* swpMatric at this point is identical to swcBulk */
+	SW_SWCbulk2SWPmatric_profile(vo->swpMatric, swp, SW_Site.n_layers);
 
 	ForEachSoilLayer(i)
 	{
-		/* swpMatric at this point is identical to swcBulk */
-		val = SW_SWCbulk2SWPmatric(SW_Site.lyr[i]->fractionVolBulk_gravel,
-			vo->swpMatric[i], i);
-
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, val);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, swp[i]);
 	}
+
+	SW_OUT_text_row_end(eSW_SWPMatric, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets swpMatric when dealing with RSOILWAT
@@ -1060,17 +1032,19 @@ void get_swpMatric_text(OutPeriod pd)
 */
 void get_swpMatric_mem(OutPeriod pd)
 {
+	RealD swp[MAX_LAYERS];
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SWPMatric][pd];
+	RealOut *p = p_OUT[eSW_SWPMatric][pd];
 	get_outvalleader(p, pd);
 
+	/* swpMatric at this point is identical to swcBulk */
+	SW_SWCbulk2SWPmatric_profile(vo->swpMatric, swp, SW_Site.n_layers);
+
 	ForEachSoilLayer(i)
 	{
-		/* swpMatric at this point is identical to swcBulk */
-		p[iOUT(i, pd)] = SW_SWCbulk2SWPmatric(
-			SW_Site.lyr[i]->fractionVolBulk_gravel, vo->swpMatric[i], i);
+		p[iOUT(i, pd)] = swp[i];
 	}
 }
 
@@ -1083,20 +1057,20 @@ void get_swpMatric_mem(OutPeriod pd)
 */
 void get_swpMatric_agg(OutPeriod pd)
 {
-	RealD val;
+	RealD swp[MAX_LAYERS];
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SWPMatric][pd],
 		*psd = p_OUTsd[eSW_SWPMatric][pd];
 
+	/* swpMatric at this point is identical to swcBulk */
+	SW_SWCbulk2SWPmatric_profile(vo->swpMatric, swp, SW_Site.n_layers);
+
 	ForEachSoilLayer(i)
 	{
-		/* swpMatric at this point is identical to swcBulk */
-		val = SW_SWCbulk2SWPmatric(
-			SW_Site.lyr[i]->fractionVolBulk_gravel, vo->swpMatric[i], i);
-		do_running_agg(p, psd, iOUT(i, pd), Globals->currIter, val);
+		do_running_agg(p, psd, iOUT(i, pd), Globals->currIter, swp[i]);
 	}
 
 	if (print_IterationSummary) {
@@ -1120,18 +1094,18 @@ void get_swaBulk_text(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_SWABulk, pd);
 
 	ForEachSoilLayer(i)
 	{
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->swaBulk[i]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->swaBulk[i]);
 	}
+
+	SW_OUT_text_row_end(eSW_SWABulk, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets swaBulk when dealing with RSOILWAT.
@@ -1143,7 +1117,7 @@ void get_swaBulk_mem(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SWABulk][pd];
+	RealOut *p = p_OUT[eSW_SWABulk][pd];
 	get_outvalleader(p, pd);
 
 	ForEachSoilLayer(i)
@@ -1164,7 +1138,7 @@ void get_swaBulk_agg(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SWABulk][pd],
 		*psd = p_OUTsd[eSW_SWABulk][pd];
 
@@ -1194,21 +1168,21 @@ void get_swaMatric_text(OutPeriod pd)
 	RealD convert;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_SWAMatric, pd);
 
 	ForEachSoilLayer(i)
 	{
 		/* swaMatric at this point is identical to swaBulk */
-		convert = 1. / (1. - SW_Site.lyr[i]->fractionVolBulk_gravel);
+		convert = 1. / (1. - SW_Site.fractionVolBulk_gravel[i]);
 
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->swaMatric[i] * convert);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->swaMatric[i] * convert);
 	}
+
+	SW_OUT_text_row_end(eSW_SWAMatric, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets swaMatric when dealing with RSOILWAT.
@@ -1221,13 +1195,13 @@ void get_swaMatric_mem(OutPeriod pd)
 	RealD convert;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SWAMatric][pd];
+	RealOut *p = p_OUT[eSW_SWAMatric][pd];
 	get_outvalleader(p, pd);
 
 	ForEachSoilLayer(i)
 	{
 		/* swaMatric at this point is identical to swaBulk */
-		convert = 1. / (1. - SW_Site.lyr[i]->fractionVolBulk_gravel);
+		convert = 1. / (1. - SW_Site.fractionVolBulk_gravel[i]);
 		p[iOUT(i, pd)] = vo->swaMatric[i] * convert;
 	}
 }
@@ -1245,14 +1219,14 @@ void get_swaMatric_agg(OutPeriod pd)
 	RealD convert;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SWAMatric][pd],
 		*psd = p_OUTsd[eSW_SWAMatric][pd];
 
 	ForEachSoilLayer(i)
 	{
 		/* swaMatric at this point is identical to swaBulk */
-		convert = 1. / (1. - SW_Site.lyr[i]->fractionVolBulk_gravel);
+		convert = 1. / (1. - SW_Site.fractionVolBulk_gravel[i]);
 		do_running_agg(p, psd, iOUT(i, pd), Globals->currIter,
 			vo->swaMatric[i] * convert);
 	}
@@ -1277,12 +1251,14 @@ void get_surfaceWater_text(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	sw_outstr[0] = '\0';
-	sprintf(sw_outstr, "%c%.*f", _Sep, OUT_DIGITS, vo->surfaceWater);
+	char *s = SW_OUT_text_row(eSW_SurfaceWater, pd);
+	s = SW_OUT_put_dbl(s, vo->surfaceWater);
+
+	SW_OUT_text_row_end(eSW_SurfaceWater, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets surfaceWater when dealing with RSOILWAT.
@@ -1293,7 +1269,7 @@ void get_surfaceWater_mem(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SurfaceWater][pd];
+	RealOut *p = p_OUT[eSW_SurfaceWater][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->surfaceWater;
@@ -1310,7 +1286,7 @@ void get_surfaceWater_agg(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SurfaceWater][pd],
 		*psd = p_OUTsd[eSW_SurfaceWater][pd];
 
@@ -1339,16 +1315,17 @@ void get_runoffrunon_text(OutPeriod pd)
 
 	net = vo->surfaceRunoff + vo->snowRunoff - vo->surfaceRunon;
 
-	sw_outstr[0] = '\0';
-	sprintf(sw_outstr, "%c%.*f%c%.*f%c%.*f%c%.*f",
-		_Sep, OUT_DIGITS, net,
-		_Sep, OUT_DIGITS, vo->surfaceRunoff,
-		_Sep, OUT_DIGITS, vo->snowRunoff,
-		_Sep, OUT_DIGITS, vo->surfaceRunon);
+	char *s = SW_OUT_text_row(eSW_Runoff, pd);
+	s = SW_OUT_put_dbl(s, net);
+	s = SW_OUT_put_dbl(s, vo->surfaceRunoff);
+	s = SW_OUT_put_dbl(s, vo->snowRunoff);
+	s = SW_OUT_put_dbl(s, vo->surfaceRunon);
+
+	SW_OUT_text_row_end(eSW_Runoff, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets surfaceRunon, surfaceRunoff, and snowRunoff when dealing with RSOILWAT.
@@ -1360,7 +1337,7 @@ void get_runoffrunon_mem(OutPeriod pd)
 	RealD net;
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_Runoff][pd];
+	RealOut *p = p_OUT[eSW_Runoff][pd];
 	get_outvalleader(p, pd);
 
 	net = vo->surfaceRunoff + vo->snowRunoff - vo->surfaceRunon;
@@ -1383,7 +1360,7 @@ void get_runoffrunon_agg(OutPeriod pd)
 	RealD net;
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_Runoff][pd],
 		*psd = p_OUTsd[eSW_Runoff][pd];
 
@@ -1415,14 +1392,12 @@ void get_transp_text(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_Transp, pd);
 
 	/* total transpiration */
 	ForEachSoilLayer(i)
 	{
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->transp_total[i]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->transp_total[i]);
 	}
 
 	/* transpiration for each vegetation type */
@@ -1430,14 +1405,15 @@ void get_transp_text(OutPeriod pd)
 	{
 		ForEachSoilLayer(i)
 		{
-			sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->transp[k][i]);
-			strcat(sw_outstr, str);
+			s = SW_OUT_put_dbl(s, vo->transp[k][i]);
 		}
 	}
+
+	SW_OUT_text_row_end(eSW_Transp, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets transp_total when dealing with RSOILWAT.
@@ -1450,7 +1426,7 @@ void get_transp_mem(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_Transp][pd];
+	RealOut *p = p_OUT[eSW_Transp][pd];
 	get_outvalleader(p, pd);
 
 	/* total transpiration */
@@ -1482,7 +1458,7 @@ void get_transp_agg(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_Transp][pd],
 		*psd = p_OUTsd[eSW_Transp][pd];
 
@@ -1558,18 +1534,18 @@ void get_evapSoil_text(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_EvapSoil, pd);
 
 	ForEachEvapLayer(i)
 	{
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->evap[i]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->evap[i]);
 	}
+
+	SW_OUT_text_row_end(eSW_EvapSoil, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets evap when dealing with RSOILWAT.
@@ -1581,7 +1557,7 @@ void get_evapSoil_mem(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_EvapSoil][pd];
+	RealOut *p = p_OUT[eSW_EvapSoil][pd];
 	get_outvalleader(p, pd);
 
 	ForEachEvapLayer(i)
@@ -1602,7 +1578,7 @@ void get_evapSoil_agg(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_EvapSoil][pd],
 		*psd = p_OUTsd[eSW_EvapSoil][pd];
 
@@ -1632,24 +1608,22 @@ void get_evapSurface_text(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_EvapSurface, pd);
 
-	sprintf(sw_outstr, "%c%.*f", _Sep, OUT_DIGITS, vo->total_evap);
+	s = SW_OUT_put_dbl(s, vo->total_evap);
 
 	ForEachVegType(k) {
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->evap_veg[k]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->evap_veg[k]);
 	}
 
-	sprintf(str, "%c%.*f%c%.*f",
-		_Sep, OUT_DIGITS, vo->litter_evap,
-		_Sep, OUT_DIGITS, vo->surfaceWater_evap);
-	strcat(sw_outstr, str);
+	s = SW_OUT_put_dbl(s, vo->litter_evap);
+	s = SW_OUT_put_dbl(s, vo->surfaceWater_evap);
+
+	SW_OUT_text_row_end(eSW_EvapSurface, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets evapSurface when dealing with RSOILWAT.
@@ -1661,7 +1635,7 @@ void get_evapSurface_mem(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_EvapSurface][pd];
+	RealOut *p = p_OUT[eSW_EvapSurface][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->total_evap;
@@ -1686,7 +1660,7 @@ void get_evapSurface_agg(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_EvapSurface][pd],
 		*psd = p_OUTsd[eSW_EvapSurface][pd];
 
@@ -1722,22 +1696,21 @@ void get_interception_text(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_Interception, pd);
 
-	sprintf(sw_outstr, "%c%.*f", _Sep, OUT_DIGITS, vo->total_int);
+	s = SW_OUT_put_dbl(s, vo->total_int);
 
 	ForEachVegType(k) {
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->int_veg[k]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->int_veg[k]);
 	}
 
-	sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->litter_int);
-	strcat(sw_outstr, str);
+	s = SW_OUT_put_dbl(s, vo->litter_int);
+
+	SW_OUT_text_row_end(eSW_Interception, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets total_int, int_veg, and litter_int when dealing with RSOILWAT.
@@ -1749,7 +1722,7 @@ void get_interception_mem(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_Interception][pd];
+	RealOut *p = p_OUT[eSW_Interception][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->total_int;
@@ -1773,7 +1746,7 @@ void get_interception_agg(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_Interception][pd],
 		*psd = p_OUTsd[eSW_Interception][pd];
 
@@ -1808,12 +1781,14 @@ void get_soilinf_text(OutPeriod pd)
 	/* 12/13/2012	(clk)	moved runoff, now named snowRunoff, to get_runoffrunon(); */
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	sw_outstr[0] = '\0';
-	sprintf(sw_outstr, "%c%.*f", _Sep, OUT_DIGITS, vo->soil_inf);
+	char *s = SW_OUT_text_row(eSW_SoilInf, pd);
+	s = SW_OUT_put_dbl(s, vo->soil_inf);
+
+	SW_OUT_text_row_end(eSW_SoilInf, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets soil_inf when dealing with RSOILWAT.
@@ -1824,7 +1799,7 @@ void get_soilinf_mem(OutPeriod pd)
 {
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SoilInf][pd];
+	RealOut *p = p_OUT[eSW_SoilInf][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->soil_inf;
@@ -1841,7 +1816,7 @@ void get_soilinf_agg(OutPeriod pd)
 {
 	SW_WEATHER_OUTPUTS *vo = SW_Weather.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SoilInf][pd],
 		*psd = p_OUTsd[eSW_SoilInf][pd];
 
@@ -1869,18 +1844,18 @@ void get_lyrdrain_text(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_LyrDrain, pd);
 
 	for (i = 0; i < SW_Site.n_layers - 1; i++)
 	{
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->lyrdrain[i]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->lyrdrain[i]);
 	}
+
+	SW_OUT_text_row_end(eSW_LyrDrain, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets lyrdrain when dealing with RSOILWAT.
@@ -1892,7 +1867,7 @@ void get_lyrdrain_mem(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_LyrDrain][pd];
+	RealOut *p = p_OUT[eSW_LyrDrain][pd];
 	get_outvalleader(p, pd);
 
 	for (i = 0; i < SW_Site.n_layers - 1; i++)
@@ -1913,7 +1888,7 @@ void get_lyrdrain_agg(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_LyrDrain][pd],
 		*psd = p_OUTsd[eSW_LyrDrain][pd];
 
@@ -1945,14 +1920,12 @@ void get_hydred_text(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_HydRed, pd);
 
 	/* total hydraulic redistribution */
 	ForEachSoilLayer(i)
 	{
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->hydred_total[i]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->hydred_total[i]);
 	}
 
 	/* hydraulic redistribution for each vegetation type */
@@ -1960,14 +1933,15 @@ void get_hydred_text(OutPeriod pd)
 	{
 		ForEachSoilLayer(i)
 		{
-			sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->hydred[k][i]);
-			strcat(sw_outstr, str);
+			s = SW_OUT_put_dbl(s, vo->hydred[k][i]);
 		}
 	}
+
+	SW_OUT_text_row_end(eSW_HydRed, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets hydred and hydred_total when dealing with RSOILWAT.
@@ -1980,7 +1954,7 @@ void get_hydred_mem(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_HydRed][pd];
+	RealOut *p = p_OUT[eSW_HydRed][pd];
 	get_outvalleader(p, pd);
 
 	/* total hydraulic redistribution */
@@ -2012,7 +1986,7 @@ void get_hydred_agg(OutPeriod pd)
 	int k;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_HydRed][pd],
 		*psd = p_OUTsd[eSW_HydRed][pd];
 
@@ -2057,12 +2031,14 @@ void get_aet_text(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	sw_outstr[0] = '\0';
-	sprintf(sw_outstr, "%c%.*f", _Sep, OUT_DIGITS, vo->aet);
+	char *s = SW_OUT_text_row(eSW_AET, pd);
+	s = SW_OUT_put_dbl(s, vo->aet);
+
+	SW_OUT_text_row_end(eSW_AET, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets actual evapotranspiration when dealing with OUTTEXT.
@@ -2073,7 +2049,7 @@ void get_aet_mem(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_AET][pd];
+	RealOut *p = p_OUT[eSW_AET][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->aet;
@@ -2090,7 +2066,7 @@ void get_aet_agg(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_AET][pd],
 		*psd = p_OUTsd[eSW_AET][pd];
 
@@ -2131,20 +2107,18 @@ void get_pet_text(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	sw_outstr[0] = '\0';
-	sprintf(
-		sw_outstr,
-		"%c%.*f%c%.*f%c%.*f%c%.*f%c%.*f",
-		_Sep, OUT_DIGITS, vo->pet,
-		_Sep, OUT_DIGITS, vo->H_oh,
-		_Sep, OUT_DIGITS, vo->H_ot,
-		_Sep, OUT_DIGITS, vo->H_gh,
-		_Sep, OUT_DIGITS, vo->H_gt
-	);
+	char *s = SW_OUT_text_row(eSW_PET, pd);
+	s = SW_OUT_put_dbl(s, vo->pet);
+	s = SW_OUT_put_dbl(s, vo->H_oh);
+	s = SW_OUT_put_dbl(s, vo->H_ot);
+	s = SW_OUT_put_dbl(s, vo->H_gh);
+	s = SW_OUT_put_dbl(s, vo->H_gt);
+
+	SW_OUT_text_row_end(eSW_PET, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets potential evapotranspiration and radiation
@@ -2156,7 +2130,7 @@ void get_pet_mem(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_PET][pd];
+	RealOut *p = p_OUT[eSW_PET][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->pet;
@@ -2176,7 +2150,7 @@ void get_pet_agg(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_PET][pd],
 		*psd = p_OUTsd[eSW_PET][pd];
 
@@ -2206,14 +2180,12 @@ void get_wetdays_text(OutPeriod pd)
 {
 	LyrIndex i;
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_WetDays, pd);
 
 	if (pd == eSW_Day)
 	{
 		ForEachSoilLayer(i) {
-			sprintf(str, "%c%i", _Sep, (SW_Soilwat.is_wet[i]) ? 1 : 0);
-			strcat(sw_outstr, str);
+			s = SW_OUT_put_int(s, (SW_Soilwat.is_wet[i]) ? 1 : 0);
 		}
 
 	} else
@@ -2221,14 +2193,15 @@ void get_wetdays_text(OutPeriod pd)
 		SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
 		ForEachSoilLayer(i) {
-			sprintf(str, "%c%i", _Sep, (int) vo->wetdays[i]);
-			strcat(sw_outstr, str);
+			s = SW_OUT_put_int(s, (int) vo->wetdays[i]);
 		}
 	}
+
+	SW_OUT_text_row_end(eSW_WetDays, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets is_wet and wetdays when dealing with RSOILWAT.
@@ -2239,7 +2212,7 @@ void get_wetdays_mem(OutPeriod pd)
 {
 	LyrIndex i;
 
-	RealD *p = p_OUT[eSW_WetDays][pd];
+	RealOut *p = p_OUT[eSW_WetDays][pd];
 	get_outvalleader(p, pd);
 
 	if (pd == eSW_Day)
@@ -2269,7 +2242,7 @@ void get_wetdays_agg(OutPeriod pd)
 {
 	LyrIndex i;
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_WetDays][pd],
 		*psd = p_OUTsd[eSW_WetDays][pd];
 
@@ -2309,14 +2282,15 @@ void get_snowpack_text(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	sw_outstr[0] = '\0';
-	sprintf(sw_outstr, "%c%.*f%c%.*f",
-		_Sep, OUT_DIGITS, vo->snowpack,
-		_Sep, OUT_DIGITS, vo->snowdepth);
+	char *s = SW_OUT_text_row(eSW_SnowPack, pd);
+	s = SW_OUT_put_dbl(s, vo->snowpack);
+	s = SW_OUT_put_dbl(s, vo->snowdepth);
+
+	SW_OUT_text_row_end(eSW_SnowPack, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets snowpack and snowdepth when dealing with OUTTEXT.
@@ -2327,7 +2301,7 @@ void get_snowpack_mem(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SnowPack][pd];
+	RealOut *p = p_OUT[eSW_SnowPack][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->snowpack;
@@ -2345,7 +2319,7 @@ void get_snowpack_agg(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SnowPack][pd],
 		*psd = p_OUTsd[eSW_SnowPack][pd];
 
@@ -2372,12 +2346,14 @@ void get_deepswc_text(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	sw_outstr[0] = '\0';
-	sprintf(sw_outstr, "%c%.*f", _Sep, OUT_DIGITS, vo->deep);
+	char *s = SW_OUT_text_row(eSW_DeepSWC, pd);
+	s = SW_OUT_put_dbl(s, vo->deep);
+
+	SW_OUT_text_row_end(eSW_DeepSWC, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets deep for when dealing with RSOILWAT.
@@ -2388,7 +2364,7 @@ void get_deepswc_mem(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_DeepSWC][pd];
+	RealOut *p = p_OUT[eSW_DeepSWC][pd];
 	get_outvalleader(p, pd);
 
 	p[iOUT(0, pd)] = vo->deep;
@@ -2405,7 +2381,7 @@ void get_deepswc_agg(OutPeriod pd)
 {
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_DeepSWC][pd],
 		*psd = p_OUTsd[eSW_DeepSWC][pd];
 
@@ -2432,18 +2408,18 @@ void get_soiltemp_text(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	char str[OUTSTRLEN];
-	sw_outstr[0] = '\0';
+	char *s = SW_OUT_text_row(eSW_SoilTemp, pd);
 
 	ForEachSoilLayer(i)
 	{
-		sprintf(str, "%c%.*f", _Sep, OUT_DIGITS, vo->sTemp[i]);
-		strcat(sw_outstr, str);
+		s = SW_OUT_put_dbl(s, vo->sTemp[i]);
 	}
+
+	SW_OUT_text_row_end(eSW_SoilTemp, pd, s);
 }
 #endif
 
-#if defined(RSOILWAT)
+#if defined(SW_OUTMEM)
 
 /**
 @brief Gets soil temperature for when dealing with RSOILWAT.
@@ -2455,7 +2431,7 @@ void get_soiltemp_mem(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD *p = p_OUT[eSW_SoilTemp][pd];
+	RealOut *p = p_OUT[eSW_SoilTemp][pd];
 	get_outvalleader(p, pd);
 
 	ForEachSoilLayer(i)
@@ -2476,7 +2452,7 @@ void get_soiltemp_agg(OutPeriod pd)
 	LyrIndex i;
 	SW_SOILWAT_OUTPUTS *vo = SW_Soilwat.p_oagg[pd];
 
-	RealD
+	RealOut
 		*p = p_OUT[eSW_SoilTemp][pd],
 		*psd = p_OUTsd[eSW_SoilTemp][pd];
 
@@ -33,41 +33,14 @@
 #include "SW_Weather.h"
 #include "SW_VegEstab.h"
 #include "SW_VegProd.h"
+#include "SW_Run.h"
 
 // Global Variables
-extern SW_SITE SW_Site;
-extern SW_SOILWAT SW_Soilwat;
-extern SW_MODEL SW_Model;
-extern SW_WEATHER SW_Weather;
-extern SW_VEGPROD SW_VegProd;
-extern SW_VEGESTAB SW_VegEstab;
 extern Bool EchoInits;
-extern SW_CARBON SW_Carbon;
 
-// Copy-paste from SW_Output.c (lines 81-103)
-SW_OUTPUT SW_Output[SW_OUTNKEYS];
-
-char _Sep; /* output delimiter */
-TimeInt tOffset; /* 1 or 0 means we're writing previous or current period */
-
-
-// Global variables describing output periods:
-/** `timeSteps` is the array that keeps track of the output time periods that
-    are required for `text` and/or `array`-based output for each output key. */
-OutPeriod timeSteps[SW_OUTNKEYS][SW_OUTNPERIODS];
-/** The number of different time steps/periods that are used/requested
-		Note: Under STEPWAT2, this may be larger than the sum of `use_OutPeriod`
-			because it also incorporates information from `timeSteps_SXW`. */
-IntUS used_OUTNPERIODS;
-/** TRUE if time step/period is active for any output key. */
-Bool use_OutPeriod[SW_OUTNPERIODS];
-
-
-// Global variables describing size and names of output
-/** names of output columns for each output key; number is an expensive guess */
-char *colnames_OUT[SW_OUTNKEYS][5 * NVEGTYPES + MAX_LAYERS];
-/** number of output columns for each output key */
-IntUS ncol_OUT[SW_OUTNKEYS];
+// `SW_Output`, `_Sep`, `tOffset`, `timeSteps`, `used_OUTNPERIODS`,
+// `use_OutPeriod`, `colnames_OUT`, and `ncol_OUT` are part of the
+// simulation run context, see SW_Run.h
 
 
 
@@ -88,7 +61,14 @@ void SW_OUT_set_ncol(void)
 {}
 
 void SW_OUT_construct(void)
-{}
+{
+	IntUS d;
+
+	// without output requests, calculate all derived quantities
+	ForEachOutDerived(d) {
+		use_Derived[d] = swTRUE;
+	}
+}
 
 void SW_OUT_deconstruct(Bool full_reset)
 {
@@ -101,6 +81,26 @@ void SW_OUT_new_year(void)
 void SW_OUT_read(void)
 {}
 
+void SW_OUT_set_request(OutKey k, OutSum sumtype, const OutPeriod periods[],
+	IntUS n_periods)
+{
+	if (k || sumtype || periods || n_periods) {}
+}
+
+void SW_OUT_setup_requests(void)
+{}
+
+void SW_OUT_set_years(TimeInt first_year, TimeInt last_year)
+{
+	if (first_year || last_year) {}
+}
+
+void SW_OUT_get_years(TimeInt *first_year, TimeInt *last_year)
+{
+	*first_year = SW_Model.startyr;
+	*last_year = SW_Model.endyr;
+}
+
 /**
 @brief This is a blank function.
 */
@@ -371,3 +371,9 @@ Bool has_OutPeriod_inUse(OutPeriod pd, OutKey k)
 
 	return res;
 }
+
+#ifdef DEBUG_MEM
+void SW_OUT_SetMemoryRefs(void)
+{
+}
+#endif
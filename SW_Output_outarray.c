@@ -8,6 +8,14 @@
 
   History:
   2018 June 15 (drs) moved functions from `SW_Output.c` and `rSW_Output.c`
+  2026-10-14 added output arrays of the full simulation run for
+    SOILWAT2-standalone and `libSOILWAT2`
+  2026-10-15 added streaming of output arrays in chunks of one year
+  2026-10-15 rows are sized for the output years, see `SW_OUT_set_years()`
+  2026-10-15 added output arrays that are owned by the calling program,
+    see `SW_OUT_set_outarray_allocator()`
+  2026-10-15 output arrays of the full run can be memory-mapped binary
+    output files, see `SW_OUT_map_bin_file()`
 */
 /********************************************************/
 /********************************************************/
@@ -31,6 +39,10 @@
 
 #include "SW_Output.h"
 #include "SW_Output_outarray.h"
+#ifdef SOILWAT
+#include "SW_Output_outbin.h"
+#endif
+#include "SW_Run.h"
 
 #ifdef STEPWAT
 #include "../ST_defines.h"
@@ -40,39 +52,30 @@
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_MODEL SW_Model;
 
-// defined in `SW_Output.c`:
-extern SW_OUTPUT SW_Output[];
-extern TimeInt tOffset;
-extern Bool use_OutPeriod[];
-extern IntUS used_OUTNPERIODS;
-extern IntUS ncol_OUT[];
-extern OutPeriod timeSteps[SW_OUTNKEYS][SW_OUTNPERIODS];
+// `SW_Output`, `tOffset`, `use_OutPeriod`, `used_OUTNPERIODS`, `ncol_OUT`,
+// and `timeSteps` (defined in `SW_Output.c`) as well as `p_OUT`, `nrow_OUT`,
+// and `irow_OUT` are part of the simulation run context, see SW_Run.h
 
 
-// defined here:
+// defined in `SW_Output.c`
+extern char const *pd2longstr[];
 
-/** \brief A 2-dim array of pointers to output arrays.
 
-  \note This should be initialized to NULL because they are defined globally
-    and thus have `static storage duration`.
+// defined here:
 
-  The variable p_OUT used by rSOILWAT2 for output and by STEPWAT2 for
-  mean aggregation.
+/* `p_OUT` is a 2-dim array of pointers to output arrays; it is used by
+  rSOILWAT2 for output, by STEPWAT2 for mean aggregation, and by
+  SOILWAT2-standalone to buffer chunks of binary output; it is initialized
+  to NULL because a simulation run context starts out zero-initialized.
 */
-RealD *p_OUT[SW_OUTNKEYS][SW_OUTNPERIODS];
-
-/** \brief A 2-dim array of pointers to output arrays of standard deviations.
-
-  \note This should be initialized to NULL because they are defined globally
-    and thus have `static storage duration`.
 
-  The variable p_OUTsd is used by STEPWAT2 for standard-deviation during
-  aggregation. See also \ref p_OUT
+/* `p_OUTsd` is a 2-dim array of pointers to output arrays of running sums
+  of squares; it is used by STEPWAT2 for the standard deviation across
+  iterations and is part of the simulation run context (see `p_OUT`) so
+  that iterations can be aggregated in separate run contexts and merged
+  with `SW_OUT_merge_running_agg()`.
 */
-#define p_OUTsd
-#undef p_OUTsd
 
 /** `prepare_IterationSummary` is TRUE if STEPWAT2 is called with `-o` flag
       and if STEPWAT2 is currently not in its last iteration/repetition.
@@ -83,14 +86,16 @@ RealD *p_OUT[SW_OUTNKEYS][SW_OUTNPERIODS];
 
 #ifdef STEPWAT
 extern GlobalType SuperGlobals;
-RealD *p_OUTsd[SW_OUTNKEYS][SW_OUTNPERIODS];
 Bool prepare_IterationSummary;
 #endif
 
-size_t nrow_OUT[SW_OUTNPERIODS]; // number of years/months/weeks/days
-size_t irow_OUT[SW_OUTNPERIODS]; // row index of current year/month/week/day output; incremented at end of each day
 const IntUS ncol_TimeOUT[SW_OUTNPERIODS] = { 2, 2, 2, 1 }; // number of time header columns for each output period
 
+#ifdef SOILWAT
+// max number of rows per calendar year for each output period (chunk size of streaming)
+static const size_t nrow_YearOUT[SW_OUTNPERIODS] = { MAX_DAYS, MAX_WEEKS, MAX_MONTHS, 1 };
+#endif
+
 
 
 /* =================================================== */
@@ -104,6 +109,25 @@ const IntUS ncol_TimeOUT[SW_OUTNPERIODS] = { 2, 2, 2, 1 }; // number of time hea
 /*             Private Function Definitions            */
 /* --------------------------------------------------- */
 
+/** Release the output array of one output key and output period unless it
+    is owned by the calling program (see `SW_OUT_set_outarray_allocator()`);
+    a memory-mapped output array is unmapped (see `SW_OUT_map_bin_file()`)
+*/
+static void free_outarray(OutKey k, OutPeriod pd) {
+	#ifdef SOILWAT
+	if (!isnull(SW_OutBin.map_base[k][pd])) {
+		SW_OUT_unmap_bin_file(k, pd);
+	} else if (!host_OUT[k][pd]) {
+		Mem_Free(p_OUT[k][pd]);
+	}
+	host_OUT[k][pd] = swFALSE;
+	#else
+	Mem_Free(p_OUT[k][pd]);
+	#endif
+
+	p_OUT[k][pd] = NULL;
+}
+
 
 /* =================================================== */
 /* =================================================== */
@@ -113,27 +137,35 @@ const IntUS ncol_TimeOUT[SW_OUTNPERIODS] = { 2, 2, 2, 1 }; // number of time hea
 
 /** @brief Determine number of years/months/weeks/days used in simulation period
 
+  Only years of output count (see `SW_OUT_set_years()`), i.e., spin-up years
+  without output don't allocate rows.
+
   @sideeffect Set nrow_OUT using global variables SW_Model,
     SuperGlobals if compiled for STEPWAT2, and use_OutPeriod
 */
 void SW_OUT_set_nrow(void)
 {
-	TimeInt i;
+	TimeInt i, startyear, endyear, startday, endday;
 	size_t n_yrs;
-	IntU startyear, endyear;
 	#ifdef SWDEBUG
 	int debug = 0;
 	#endif
 
-	startyear = SW_Model.startyr;
-
 	#ifdef STEPWAT
+	startyear = SW_Model.startyr;
 	n_yrs = SuperGlobals.runModelYears;
 	endyear = startyear + n_yrs + 1;
+	startday = SW_Model.startstart;
+	endday = SW_Model.endend;
 
 	#else
-	n_yrs = SW_Model.endyr - SW_Model.startyr + 1;
-	endyear = SW_Model.endyr;
+	SW_OUT_get_years(&startyear, &endyear);
+	n_yrs = endyear - startyear + 1;
+
+	// a year of output that is not the first (last) simulated year is complete
+	startday = (startyear == SW_Model.startyr) ? SW_Model.startstart : 1;
+	endday = (endyear == SW_Model.endyr) ?
+		SW_Model.endend : Time_get_lastdoy_y(endyear);
 	#endif
 
 	nrow_OUT[eSW_Year] = n_yrs * use_OutPeriod[eSW_Year];
@@ -146,15 +178,14 @@ void SW_OUT_set_nrow(void)
 	{
 		if (n_yrs == 1)
 		{
-			nrow_OUT[eSW_Day] = SW_Model.endend - SW_Model.startstart + 1;
+			nrow_OUT[eSW_Day] = endday - startday + 1;
 
 		} else
 		{
 			// Calculate the start day of first year
-			nrow_OUT[eSW_Day] = Time_get_lastdoy_y(startyear) -
-				SW_Model.startstart + 1;
+			nrow_OUT[eSW_Day] = Time_get_lastdoy_y(startyear) - startday + 1;
 			// and last day of last year.
-			nrow_OUT[eSW_Day] += SW_Model.endend;
+			nrow_OUT[eSW_Day] += endday;
 
 			// Cumulate days of years between first and last year
 			for (i = startyear + 1; i < endyear; i++)
@@ -175,6 +206,8 @@ void SW_OUT_set_nrow(void)
 
 /**
 @brief For each out key, the p_OUT array is set to NULL.
+
+Arrays that are owned by the calling program are not freed.
 */
 void SW_OUT_deconstruct_outarray(void)
 {
@@ -183,8 +216,7 @@ void SW_OUT_deconstruct_outarray(void)
 
 	ForEachOutKey(k) {
 		for (i = 0; i < SW_OUTNPERIODS; i++) {
-			Mem_Free(p_OUT[k][i]);
-			p_OUT[k][i] = NULL;
+			free_outarray(k, (OutPeriod) i);
 
 			#ifdef STEPWAT
 			Mem_Free(p_OUTsd[k][i]);
@@ -196,10 +228,10 @@ void SW_OUT_deconstruct_outarray(void)
 }
 
 
-#ifdef RSOILWAT
+#ifdef SW_OUTMEM
 /** @brief Corresponds to function `get_outstrleader` of `SOILWAT2-standalone`
 */
-void get_outvalleader(RealD *p, OutPeriod pd) {
+void get_outvalleader(RealOut *p, OutPeriod pd) {
 	p[irow_OUT[pd] + nrow_OUT[pd] * 0] = SW_Model.simyear;
 
 	switch (pd) {
@@ -222,6 +254,224 @@ void get_outvalleader(RealD *p, OutPeriod pd) {
 #endif
 
 
+#ifdef SOILWAT
+/**
+@brief Register a consumer that receives the output arrays in chunks
+
+Instead of holding all rows of the simulation run, the output arrays hold
+one calendar year (a window of a fixed size); at the end of each year
+(and at the end of the run), the consumer is called once for each used
+output key and output period with the rows of that year. Memory is thus
+independent of the length of the simulation run.
+
+If `SW_OUTFORMAT_MEM` is requested as well, then the output arrays hold
+all rows of the run and the consumer is called once when the output files
+are closed.
+
+@param consumer The function that receives the chunks; NULL to unregister.
+@param data A pointer that is passed on to `consumer`.
+
+@note Call this routine before `SW_OUT_create_files()`.
+*/
+void SW_OUT_set_outarray_consumer(SW_OUTARRAY_CONSUMER consumer, void *data)
+{
+	consumer_OUT = consumer;
+	consumer_data_OUT = data;
+}
+
+
+/**
+@brief Register an allocator that provides the output arrays of the full
+  simulation run in memory of the calling program
+
+With `SW_OUTFORMAT_MEM`, `SW_OUT_construct_outarray()` asks the allocator
+for the output array of each used output key and output period (with the
+layout of `SW_OUT_get_outarray()`) and the `get_XXX_mem` functions write
+directly into it; a calling program thus receives the output without
+copying it and without a second array of the same size.
+The calling program owns the buffers: they are not freed by
+`SW_OUT_deconstruct()` and remain valid after `SW_CTL_clear_model()`.
+
+@param allocator The function that provides the buffers; NULL to unregister.
+@param data A pointer that is passed on to `allocator`.
+
+@note Call this routine before `SW_OUT_create_files()`. Output arrays that
+  only hold a chunk of rows (binary output and consumers without
+  `SW_OUTFORMAT_MEM`) are always allocated by SOILWAT2.
+*/
+void SW_OUT_set_outarray_allocator(SW_OUTARRAY_ALLOCATOR allocator, void *data)
+{
+	allocator_OUT = allocator;
+	allocator_data_OUT = data;
+}
+
+
+/**
+@brief Allocate output arrays that hold all rows of the simulation run or,
+  if only a consumer is registered, one year of rows
+
+A calling program (e.g., a harness that links against `libSOILWAT2`)
+requests all rows with `SW_OUT_set_format()` and `SW_OUTFORMAT_MEM`; they are
+filled by the `get_XXX_mem` functions and remain available via
+`SW_OUT_get_outarray()` until `SW_OUT_deconstruct()` (e.g., called by
+`SW_CTL_clear_model()`) or, if an allocator is registered, are written
+into buffers of the calling program, see `SW_OUT_set_outarray_allocator()`.
+Otherwise, with `SW_OUTFORMAT_MAP`, the output arrays are memory-mapped
+binary output files, see `SW_OUT_map_bin_file()`.
+Chunks of rows are requested with `SW_OUT_set_outarray_consumer()`.
+
+@note Call this routine after `SW_OUT_set_ncol()`;
+  `SW_OUT_create_files()` calls it if `SW_OUTFORMAT_MEM` is requested or
+  a consumer is registered.
+
+@sideeffect Set `nrow_OUT` to the number of rows of the simulation run
+  (or, at most, of one year) and allocate `p_OUT` of each used output key
+  and output period.
+*/
+void SW_OUT_construct_outarray(void)
+{
+	IntUS i, ncol;
+	OutKey k;
+	OutPeriod pd;
+	RealOut *p;
+
+	SW_OUT_set_nrow();
+
+	ForEachOutPeriod(pd) {
+		if (!collect_OUT) {
+			nrow_OUT[pd] = min(nrow_OUT[pd], nrow_YearOUT[pd]);
+		}
+
+		irow_OUT[pd] = 0;
+	}
+
+	ForEachOutKey(k) {
+		for (i = 0; i < used_OUTNPERIODS; i++) {
+			pd = timeSteps[k][i];
+
+			if (SW_Output[k].use && pd != eSW_NoTime) {
+				free_outarray(k, pd);
+
+				ncol = ncol_OUT[k] + ncol_TimeOUT[pd];
+				p = (collect_OUT && !isnull(allocator_OUT)) ?
+					allocator_OUT(k, pd, nrow_OUT[pd], ncol, allocator_data_OUT) :
+					NULL;
+
+				if (!isnull(p)) {
+					memset(p, 0, nrow_OUT[pd] * ncol * sizeof(RealOut));
+					host_OUT[k][pd] = swTRUE;
+
+				} else if (collect_OUT && SW_OutBin.map) {
+					p = SW_OUT_map_bin_file(k, pd, nrow_OUT[pd]);
+
+				} else {
+					p = (RealOut *) Mem_Calloc(nrow_OUT[pd] * ncol,
+						sizeof(RealOut), "SW_OUT_construct_outarray()");
+				}
+
+				p_OUT[k][pd] = p;
+			}
+		}
+	}
+}
+
+
+/**
+@brief Complete the current chunk of output arrays of one output period
+
+Passes the rows of the chunk to the consumer (if registered) and to the
+binary output file (if used) and starts a new chunk. Called when a chunk
+is full, at the end of each year if a consumer streams output arrays, and
+when the output files are closed.
+
+@param pd The output time step.
+*/
+void SW_OUT_end_outarray_chunk(OutPeriod pd)
+{
+	OutKey k;
+
+	if (0 == irow_OUT[pd]) {
+		return;
+	}
+
+	if (!isnull(consumer_OUT)) {
+		ForEachOutKey(k) {
+			if (SW_Output[k].use && !isnull(p_OUT[k][pd])) {
+				consumer_OUT(k, pd, p_OUT[k][pd], irow_OUT[pd], nrow_OUT[pd],
+					ncol_OUT[k] + ncol_TimeOUT[pd], consumer_data_OUT);
+			}
+		}
+	}
+
+	if (SW_OutBin.use) {
+		SW_OUT_write_bin_chunk(pd);
+	}
+
+	irow_OUT[pd] = 0;
+}
+
+
+/**
+@brief Access the output array of the full simulation run of one output key
+  and output period
+
+The array is organized column by column (see `iOUT`): the time columns
+(year and, except for yearly output, day/week/month) are followed by the
+columns of the output key, see `SW_OUT_get_outarray_colname()`.
+
+@param k The output key.
+@param pd The output time step.
+@param nrow Number of rows of the simulation run (may be NULL).
+@param ncol Number of columns including the time columns (may be NULL).
+
+@return Pointer to `nrow * ncol` values or NULL if output key `k` is not
+  requested for period `pd` or output arrays are not used,
+  see `SW_OUT_construct_outarray()`.
+*/
+const RealOut *SW_OUT_get_outarray(OutKey k, OutPeriod pd, size_t *nrow, IntUS *ncol)
+{
+	Bool has = (Bool) (collect_OUT && !isnull(p_OUT[k][pd]));
+
+	if (!isnull(nrow)) {
+		*nrow = has ? nrow_OUT[pd] : 0;
+	}
+
+	if (!isnull(ncol)) {
+		*ncol = has ? ncol_OUT[k] + ncol_TimeOUT[pd] : 0;
+	}
+
+	return has ? p_OUT[k][pd] : NULL;
+}
+
+
+/**
+@brief Name of a column of an output array of the full simulation run
+
+@param k The output key.
+@param pd The output time step.
+@param i The column (base0) of the output array, see `SW_OUT_get_outarray()`.
+
+@return Column name or NULL if `i` is out of range.
+*/
+const char *SW_OUT_get_outarray_colname(OutKey k, OutPeriod pd, IntUS i)
+{
+	if (i >= ncol_TimeOUT[pd] + ncol_OUT[k]) {
+		return NULL;
+	}
+
+	if (i == 0) {
+		return "Year";
+	}
+
+	if (i < ncol_TimeOUT[pd]) {
+		return pd2longstr[pd];
+	}
+
+	return colnames_OUT[k][i - ncol_TimeOUT[pd]];
+}
+#endif
+
+
 #ifdef STEPWAT
 /** @brief Handle the cumulative running mean and standard deviation
 		@param k. The index (base0) for subsetting `p` and `psd`, e.g., as calculated by
@@ -229,7 +479,7 @@ void get_outvalleader(RealD *p, OutPeriod pd) {
 		@param n. The current iteration/repetition number (base1).
 		@param x. The new value.
 */
-void do_running_agg(RealD *p, RealD *psd, size_t k, IntU n, RealD x)
+void do_running_agg(RealOut *p, RealOut *psd, size_t k, IntU n, RealD x)
 {
 	RealD prev_val = p[k];
 
@@ -238,6 +488,71 @@ void do_running_agg(RealD *p, RealD *psd, size_t k, IntU n, RealD x)
 }
 
 
+/** @brief Merge partial running aggregations of iterations/repetitions
+
+		Iterations can be aggregated in separate simulation run contexts (e.g.,
+		one per worker thread or node) and merged afterwards; the result
+		corresponds to aggregating all iterations with `do_running_agg()`
+		(up to rounding).
+
+		@param p_to Running means of `n_to` iterations; updated to all iterations.
+		@param psd_to Running sums of squares corresponding to `p_to`; updated.
+		@param n_to Number of iterations aggregated in `p_to`.
+		@param p_from Running means of `n_from` other iterations.
+		@param psd_from Running sums of squares corresponding to `p_from`.
+		@param n_from Number of iterations aggregated in `p_from`.
+		@param size Number of values of each array.
+*/
+void merge_running_agg(RealOut *p_to, RealOut *psd_to, IntU n_to,
+	const RealOut *p_from, const RealOut *psd_from, IntU n_from, size_t size)
+{
+	size_t i;
+	RealD m, ss;
+
+	for (i = 0; i < size; i++)
+	{
+		m = p_to[i];
+		ss = psd_to[i];
+		merge_running_stats(n_to, &m, &ss, n_from, p_from[i], psd_from[i]);
+		p_to[i] = m;
+		psd_to[i] = ss;
+	}
+}
+
+
+/** @brief Merge the aggregated output of another simulation run context
+		into the active one
+
+		@param p_from Output arrays `p_OUT` of the other simulation run context.
+		@param psd_from Output arrays `p_OUTsd` of the other simulation run context.
+		@param n_to Number of iterations aggregated by the active run context.
+		@param n_from Number of iterations aggregated by the other run context.
+
+		@note Both run contexts must use the same output requests, see
+			`setGlobalSTEPWAT2_OutputVariables()`.
+*/
+void SW_OUT_merge_running_agg(RealOut *p_from[][SW_OUTNPERIODS],
+	RealOut *psd_from[][SW_OUTNPERIODS], IntU n_to, IntU n_from)
+{
+	IntUS i;
+	OutKey k;
+	OutPeriod pd;
+
+	ForEachOutKey(k) {
+		for (i = 0; i < used_OUTNPERIODS; i++) {
+			pd = timeSteps[k][i];
+
+			if (SW_Output[k].use && pd != eSW_NoTime && !isnull(p_from[k][pd]))
+			{
+				merge_running_agg(p_OUT[k][pd], p_OUTsd[k][pd], n_to,
+					p_from[k][pd], psd_from[k][pd], n_from,
+					nrow_OUT[pd] * (ncol_OUT[k] + ncol_TimeOUT[pd]));
+			}
+		}
+	}
+}
+
+
 /** Set global STEPWAT2 output variables that aggregate across iterations/repetitions
 
 		Note: Compare with function `setGlobalrSOILWAT2_OutputVariables` in `rSW_Output.c`
@@ -250,7 +565,7 @@ void setGlobalSTEPWAT2_OutputVariables(void)
 	IntUS i;
 	size_t
 		size,
-		s = sizeof(RealD);
+		s = sizeof(RealOut);
 	OutKey k;
 
 	ForEachOutKey(k) {
@@ -260,10 +575,10 @@ void setGlobalSTEPWAT2_OutputVariables(void)
 				size = nrow_OUT[timeSteps[k][i]] *
 					(ncol_OUT[k] + ncol_TimeOUT[timeSteps[k][i]]);
 
-				p_OUT[k][timeSteps[k][i]] = (RealD *) Mem_Calloc(size, s,
+				p_OUT[k][timeSteps[k][i]] = (RealOut *) Mem_Calloc(size, s,
 					"setGlobalSTEPWAT2_OutputVariables()");
 
-				p_OUTsd[k][timeSteps[k][i]] = (RealD *) Mem_Calloc(size, s,
+				p_OUTsd[k][timeSteps[k][i]] = (RealOut *) Mem_Calloc(size, s,
 					"setGlobalSTEPWAT2_OutputVariables()");
 			}
 		}
@@ -5,10 +5,19 @@
   Purpose: Support for SW_Output_outarray.c
   Application: SOILWAT - soilwater dynamics simulator
   Purpose: define functions to deal with array outputs; currently, used
-    by rSOILWAT2 and STEPWAT2
+    by rSOILWAT2, STEPWAT2, and SOILWAT2-standalone (binary output and
+    output arrays of the full simulation run for a calling program)
 
   History:
   2018 June 15 (drs) moved functions from `SW_Output.c`
+  2026-10-14 added output arrays of the full simulation run for
+    SOILWAT2-standalone and `libSOILWAT2`, see `SW_OUT_get_outarray()`
+  2026-10-15 added streaming of output arrays in chunks of one year to a
+    consumer, see `SW_OUT_set_outarray_consumer()`
+  2026-10-15 output arrays store values of type `RealOut`
+  2026-10-15 added merging of running aggregations across run contexts
+  2026-10-15 a calling program may own the output arrays of the full
+    simulation run, see `SW_OUT_set_outarray_allocator()`
  */
 /********************************************************/
 /********************************************************/
@@ -38,17 +47,64 @@ extern "C" {
 	(ncol_TimeOUT[(pd)] + (i) + SW_Site.n_layers * (k)))
 
 
+#ifdef SOILWAT
+/** Consumer of completed chunks of output arrays,
+  see `SW_OUT_set_outarray_consumer()`
+
+  @param k The output key.
+  @param pd The output time step.
+  @param p The chunk: `ncol` columns (including the time columns) of `nrow`
+    values; column `i` starts at `p + i * stride`. Valid only during the call.
+  @param nrow Number of rows of the chunk.
+  @param stride Distance between consecutive columns (`stride >= nrow`).
+  @param ncol Number of columns including the time columns.
+  @param data The pointer that was registered with the consumer.
+*/
+typedef void (*SW_OUTARRAY_CONSUMER)(OutKey k, OutPeriod pd, const RealOut *p,
+	size_t nrow, size_t stride, IntUS ncol, void *data);
+
+/** Allocator of the output arrays of the full simulation run in memory of
+  the calling program, see `SW_OUT_set_outarray_allocator()`
+
+  @param k The output key.
+  @param pd The output time step.
+  @param nrow Number of rows (`nrow_OUT[pd]`).
+  @param ncol Number of columns including the time columns.
+  @param data The pointer that was registered with the allocator.
+
+  @return A buffer of `nrow * ncol` values that remains owned by the
+    calling program; SOILWAT2 sets it to zero and writes the output by
+    columns (see `iOUT`). NULL lets SOILWAT2 allocate the output array.
+*/
+typedef RealOut *(*SW_OUTARRAY_ALLOCATOR)(OutKey k, OutPeriod pd,
+	size_t nrow, IntUS ncol, void *data);
+#endif
+
+
 
 // Function declarations
 void SW_OUT_set_nrow(void);
 void SW_OUT_deconstruct_outarray(void);
 
-#ifdef RSOILWAT
-void get_outvalleader(RealD *p, OutPeriod pd);
+#ifdef SW_OUTMEM
+void get_outvalleader(RealOut *p, OutPeriod pd);
+#endif
+
+#ifdef SOILWAT
+void SW_OUT_set_outarray_consumer(SW_OUTARRAY_CONSUMER consumer, void *data);
+void SW_OUT_set_outarray_allocator(SW_OUTARRAY_ALLOCATOR allocator, void *data);
+void SW_OUT_construct_outarray(void);
+void SW_OUT_end_outarray_chunk(OutPeriod pd);
+const RealOut *SW_OUT_get_outarray(OutKey k, OutPeriod pd, size_t *nrow, IntUS *ncol);
+const char *SW_OUT_get_outarray_colname(OutKey k, OutPeriod pd, IntUS i);
 #endif
 
 #ifdef STEPWAT
-void do_running_agg(RealD *p, RealD *psd, size_t k, IntU n, RealD x);
+void do_running_agg(RealOut *p, RealOut *psd, size_t k, IntU n, RealD x);
+void merge_running_agg(RealOut *p_to, RealOut *psd_to, IntU n_to,
+	const RealOut *p_from, const RealOut *psd_from, IntU n_from, size_t size);
+void SW_OUT_merge_running_agg(RealOut *p_from[][SW_OUTNPERIODS],
+	RealOut *psd_from[][SW_OUTNPERIODS], IntU n_to, IntU n_from);
 void setGlobalSTEPWAT2_OutputVariables(void);
 #endif
 
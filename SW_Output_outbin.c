@@ -0,0 +1,576 @@
+/********************************************************/
+/********************************************************/
+/**
+  @file
+  @brief Output functionality for binary columnar outputs that are written
+  to disk files
+
+  Values are obtained by the array-based `get_XXX_mem` functions (see
+  `SW_Output_get_functions.c`) into the output arrays `p_OUT` which are
+  sized to hold a chunk of rows; a full chunk is written to disk column
+  by column in large blocks (see `SW_Output_outbin.h` for the file format).
+  Compared to text output, values are not formatted and are written
+  with full precision (of `RealOut`).
+
+  See the \ref out_algo "output algorithm documentation" for details.
+
+  History:
+  (2026-10-14) -- INITIAL CODING
+  2026-10-15 binary output files can be synced and resumed at checkpoints
+  2026-10-15 writes of chunks are traced (option -t, see SW_Trace.h)
+  2026-10-15 added SW_OUTFORMAT_NONE, output only to reducers
+  2026-10-15 added SW_OUTFORMAT_HDF, output arrays for the HDF5 output file
+  2026-10-15 added SW_OUTFORMAT_MAP: output arrays of the full run are
+    memory-mapped binary output files, one per output key and period
+  2026-10-15 added SW_OUTFORMAT_DIGEST, see SW_Output_digest.c
+*/
+/********************************************************/
+/********************************************************/
+
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L /* for ftruncate() and mmap() with -std=c11 */
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+
+#include "SW_Defines.h"
+#include "SW_Files.h"
+
+#include "SW_Output.h"
+#include "SW_Output_outarray.h"
+#include "SW_Output_outbin.h"
+#include "SW_Output_digest.h"
+#include "SW_Trace.h"
+#include "SW_Run.h"
+
+
+
+/* =================================================== */
+/*                  Global Variables                   */
+/* --------------------------------------------------- */
+
+// `SW_Output`, `use_OutPeriod`, `timeSteps`, `colnames_OUT`, `ncol_OUT`,
+// `p_OUT`, `nrow_OUT`, `irow_OUT`, and `SW_OutBin` are part of the
+// simulation run context, see SW_Run.h
+
+// defined in `SW_Output.c`
+extern char const *key2str[];
+extern char const *pd2longstr[];
+
+// defined in `SW_Output_outarray.c`
+extern const IntUS ncol_TimeOUT[];
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Declarations            */
+/* --------------------------------------------------- */
+
+static Bool has_bin_output(OutPeriod pd, OutKey k);
+static void bin_file_name(OutPeriod pd, char *fname);
+static void map_file_name(OutKey k, OutPeriod pd, char *fname);
+static char *bin_header(OutPeriod pd, OutKey k0, SW_OUTBIN_HEADER *header,
+	size_t align);
+static void write_bin_header(OutPeriod pd);
+static void alloc_bin_chunks(OutPeriod pd);
+static void open_bin_files(const long pos[]);
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Is output key `k` part of the binary output file of period `pd`? */
+static Bool has_bin_output(OutPeriod pd, OutKey k) {
+	return (Bool) (SW_Output[k].use && has_OutPeriod_inUse(pd, k));
+}
+
+
+/** Name of the binary output file of period `pd`: the name of the
+    "regular" `csv` output file with its extension replaced by `.bin`
+
+    @param pd The output time step.
+    @param fname Resulting file name; of size `MAX_FILENAMESIZE`.
+*/
+static void bin_file_name(OutPeriod pd, char *fname) {
+	char *ext;
+
+	// PROGRAMMER Note: `eOutputDaily + pd` assumes a specific order of
+	// `SW_FileIndex`, see `_create_csv_files()`
+	strcpy(fname, SW_F_name(eOutputDaily + pd));
+
+	ext = strrchr(fname, '.');
+	if (!isnull(ext) && isnull(strchr(ext, '/'))) {
+		*ext = '\0';
+	}
+
+	strcat(fname, SW_OUTBIN_EXT);
+}
+
+
+/** Name of the memory-mapped binary output file of output key `k` and
+    period `pd`: "[name of the binary output file of `pd`]_[key].bin"
+
+    @param k The output key.
+    @param pd The output time step.
+    @param fname Resulting file name; of size `MAX_FILENAMESIZE`.
+*/
+static void map_file_name(OutKey k, OutPeriod pd, char *fname) {
+	bin_file_name(pd, fname);
+
+	fname[strlen(fname) - strlen(SW_OUTBIN_EXT)] = '\0';
+	strcat(fname, "_");
+	strcat(fname, key2str[k]);
+	strcat(fname, SW_OUTBIN_EXT);
+}
+
+
+/** Header and column names of a binary output file of period `pd`
+
+    @param pd The output time step.
+    @param k0 The output key of a memory-mapped file; `eSW_NoKey` for all
+      output keys of period `pd`.
+    @param header Resulting header.
+    @param align The block of column names is padded with nul bytes so
+      that the values of the first chunk start at a multiple of `align` bytes.
+
+    @return The block of `header->len_colnames` bytes; free with `Mem_Free()`.
+*/
+static char *bin_header(OutPeriod pd, OutKey k0, SW_OUTBIN_HEADER *header,
+	size_t align) {
+
+	OutKey k;
+	IntUS i;
+	char *names, *s;
+	size_t len = 0;
+
+	memset(header, 0, sizeof *header);
+	memcpy(header->magic, SW_OUTBIN_MAGIC, sizeof header->magic);
+	header->version = SW_OUTBIN_VERSION;
+	header->byteorder = SW_OUTBIN_BYTEORDER;
+	header->period = (uint32_t) pd;
+	header->n_cols = ncol_TimeOUT[pd];
+	header->value_size = (uint32_t) sizeof(RealOut);
+
+	// size of the block of column names
+	len += strlen("Year") + 1;
+	if (pd != eSW_Year) {
+		len += strlen(pd2longstr[pd]) + 1;
+	}
+
+	ForEachOutKey(k) {
+		if (has_bin_output(pd, k) && (k0 == eSW_NoKey || k == k0)) {
+			header->n_cols += ncol_OUT[k];
+
+			for (i = 0; i < ncol_OUT[k]; i++) {
+				len += strlen(key2str[k]) + strlen(colnames_OUT[k][i]) + 2;
+			}
+		}
+	}
+
+	len += (align - (sizeof *header + len + sizeof(SW_OUTBIN_CHUNK)) % align) % align;
+	header->len_colnames = (uint32_t) len;
+
+	// column names as consecutive nul-terminated strings
+	names = s = (char *) Mem_Calloc(len, 1, "bin_header()");
+
+	strcpy(s, "Year");
+	s += strlen(s) + 1;
+	if (pd != eSW_Year) {
+		strcpy(s, pd2longstr[pd]);
+		s += strlen(s) + 1;
+	}
+
+	ForEachOutKey(k) {
+		if (has_bin_output(pd, k) && (k0 == eSW_NoKey || k == k0)) {
+			for (i = 0; i < ncol_OUT[k]; i++) {
+				sprintf(s, "%s_%s", key2str[k], colnames_OUT[k][i]);
+				s += strlen(s) + 1;
+			}
+		}
+	}
+
+	return names;
+}
+
+
+/** Write header and column names to the binary output file of period `pd` */
+static void write_bin_header(OutPeriod pd) {
+	SW_OUTBIN_HEADER header;
+	char *names = bin_header(pd, eSW_NoKey, &header, 1);
+	FILE *f = SW_OutBin.fp[pd];
+
+	if (1 != fwrite(&header, sizeof header, 1, f) ||
+		header.len_colnames != fwrite(names, 1, header.len_colnames, f)) {
+		Mem_Free(names);
+		LogError(logfp, LOGFATAL, "Cannot write header of binary output file.");
+	}
+
+	Mem_Free(names);
+}
+
+
+/** Allocate the output arrays of period `pd` to hold one chunk of rows
+
+  @sideeffect Set `nrow_OUT` to the number of rows per chunk (at most
+    `SW_OUTBIN_CHUNKROWS`) and allocate `p_OUT` of each output key.
+    If `SW_OUTFORMAT_MEM` is requested, then the output arrays already hold
+    all rows of the run (see `SW_OUT_construct_outarray()`) which are written
+    as one chunk at the end; if a consumer streams output arrays, then the
+    chunks are the years of the run.
+*/
+static void alloc_bin_chunks(OutPeriod pd) {
+	OutKey k;
+
+	if (collect_OUT || !isnull(consumer_OUT)) {
+		return;
+	}
+
+	nrow_OUT[pd] = max(min(nrow_OUT[pd], (size_t) SW_OUTBIN_CHUNKROWS), (size_t) 1);
+	irow_OUT[pd] = 0;
+
+	ForEachOutKey(k) {
+		if (has_bin_output(pd, k) && isnull(p_OUT[k][pd])) {
+			p_OUT[k][pd] = (RealOut *) Mem_Calloc(
+				nrow_OUT[pd] * (ncol_OUT[k] + ncol_TimeOUT[pd]),
+				sizeof(RealOut),
+				"alloc_bin_chunks()"
+			);
+		}
+	}
+}
+
+
+/** Open the binary output files of all used output periods and create the
+    output arrays that buffer a chunk of rows
+
+    @param pos NULL to create new files; otherwise, the sizes of the files
+      at a checkpoint (see `SW_OUT_sync_bin_files()`): the files are cut to
+      these sizes and continued.
+*/
+static void open_bin_files(const long pos[]) {
+	OutPeriod pd;
+	char fname[MAX_FILENAMESIZE];
+
+	// number of rows of the simulation period (upper bound per chunk);
+	// output arrays of `SW_OUT_construct_outarray()` are already sized
+	if (!collect_OUT && isnull(consumer_OUT)) {
+		SW_OUT_set_nrow();
+	}
+
+	ForEachOutPeriod(pd) {
+		if (use_OutPeriod[pd]) {
+			bin_file_name(pd, fname);
+
+			if (isnull(pos)) {
+				SW_OutBin.fp[pd] = OpenFile(fname, "wb");
+				write_bin_header(pd);
+			} else {
+				SW_OutBin.fp[pd] = ResumeFile(fname, "r+b", pos[pd]);
+			}
+
+			alloc_bin_chunks(pd);
+		}
+	}
+}
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Function Definitions                    */
+/*             (declared in SW_Output_outbin.h)        */
+/* --------------------------------------------------- */
+
+/**
+@brief Select the output format(s) of the active simulation run
+
+@param format Bitwise combination of `SW_OUTFORMAT_CSV`, `SW_OUTFORMAT_BIN`,
+  `SW_OUTFORMAT_MEM`, `SW_OUTFORMAT_HDF`, `SW_OUTFORMAT_MAP`,
+  `SW_OUTFORMAT_DIGEST`, and `SW_OUTFORMAT_ASYNC`; zero (or only
+  `SW_OUTFORMAT_ASYNC`) is treated as `SW_OUTFORMAT_CSV`.
+  `SW_OUTFORMAT_HDF` implies `SW_OUTFORMAT_MEM`, see `SW_OUT_hdf_attach()`.
+  `SW_OUTFORMAT_MAP` implies `SW_OUTFORMAT_MEM`: the output arrays are
+  memory-mapped binary output files, see `SW_OUT_map_bin_file()`.
+  `SW_OUTFORMAT_DIGEST` registers the digest as the consumer of output
+  arrays (see `SW_OUT_digest_chunk()`); it cannot be combined with another
+  consumer.
+  `SW_OUTFORMAT_NONE` overrides the others: output is neither summed nor
+  written and derived quantities are not calculated; only reducers
+  (see `SW_Output_reduce.c`) see the daily state, e.g., for calibrations
+  and benchmarks of the simulation itself.
+
+@note Call this routine after `SW_OUT_read()`.
+*/
+void SW_OUT_set_format(int format) {
+	IntUS d;
+
+	SW_OutReduce.skip_output = (Bool) (0 != (format & SW_OUTFORMAT_NONE));
+
+	if (SW_OutReduce.skip_output) {
+		format = 0;
+
+		ForEachOutDerived(d) {
+			use_Derived[d] = swFALSE;
+		}
+
+	} else if (0 == (format & ~SW_OUTFORMAT_ASYNC)) {
+		format |= SW_OUTFORMAT_CSV;
+	}
+
+	if (0 != (format & (SW_OUTFORMAT_HDF | SW_OUTFORMAT_MAP))) {
+		format |= SW_OUTFORMAT_MEM;
+	}
+
+	SW_OutBin.map = (Bool) (0 != (format & SW_OUTFORMAT_MAP));
+	SW_OutDigest.use = (Bool) (0 != (format & SW_OUTFORMAT_DIGEST));
+	SW_OutBin.use = (Bool) (0 != (format & SW_OUTFORMAT_BIN));
+	SW_OutBin.skip_csv = (Bool) (0 == (format & SW_OUTFORMAT_CSV));
+	collect_OUT = (Bool) (0 != (format & SW_OUTFORMAT_MEM));
+	SW_OutWriter.request = (Bool) (0 != (format & SW_OUTFORMAT_ASYNC));
+
+	// the digest consumes the output arrays in chunks of one year
+	if (SW_OutDigest.use) {
+		if (!isnull(consumer_OUT) && consumer_OUT != SW_OUT_digest_chunk) {
+			LogError(logfp, LOGFATAL,
+				"An output digest cannot be combined with a consumer of output arrays.");
+		}
+		SW_OUT_set_outarray_consumer(SW_OUT_digest_chunk, NULL);
+
+	} else if (consumer_OUT == SW_OUT_digest_chunk) {
+		SW_OUT_set_outarray_consumer(NULL, NULL);
+	}
+}
+
+
+/**
+@brief Create the binary output files and the output arrays that buffer
+  a chunk of rows for each used output period
+
+@note Call this routine after `SW_OUT_set_ncol()` and
+  `SW_OUT_set_colnames()`.
+*/
+void SW_OUT_create_bin_files(void) {
+	open_bin_files(NULL);
+}
+
+
+/**
+@brief Continue the binary output files of a run that resumes from a
+  checkpoint
+
+@param pos Sizes of the files at the checkpoint, see `SW_OUT_sync_bin_files()`;
+  anything that was written after the checkpoint is discarded.
+
+@note Call this routine instead of `SW_OUT_create_bin_files()`.
+*/
+void SW_OUT_resume_bin_files(const long pos[]) {
+	open_bin_files(pos);
+}
+
+
+/**
+@brief Write the buffered rows as a chunk and commit the binary output
+  files to disk, e.g., at a checkpoint
+
+@param pos Resulting sizes of the files for each output period
+  (-1 if not used).
+*/
+void SW_OUT_sync_bin_files(long pos[]) {
+	OutPeriod pd;
+
+	ForEachOutPeriod(pd) {
+		pos[pd] = -1;
+
+		if (isnull(SW_OutBin.fp[pd])) {
+			continue;
+		}
+
+		SW_OUT_end_outarray_chunk(pd);
+
+		if (!SyncFile(SW_OutBin.fp[pd])) {
+			LogError(logfp, LOGFATAL, "Cannot write to binary output file.");
+		}
+
+		pos[pd] = ftell(SW_OutBin.fp[pd]);
+	}
+}
+
+
+/**
+@brief Write the buffered rows of period `pd` as one chunk to the binary
+  output file
+
+@param pd The output time step.
+
+@note Call `SW_OUT_end_outarray_chunk()` which starts a new chunk.
+*/
+void SW_OUT_write_bin_chunk(OutPeriod pd) {
+	SW_OUTBIN_CHUNK chunk;
+	OutKey k;
+	IntUS i;
+	Bool has_time = swFALSE;
+	size_t n = irow_OUT[pd];
+	FILE *f = SW_OutBin.fp[pd];
+
+	if (0 == n || isnull(f)) {
+		return;
+	}
+
+	SW_TRC_START(write);
+
+	chunk.n_rows = (uint32_t) n;
+	chunk.reserved = 0;
+
+	if (1 != fwrite(&chunk, sizeof chunk, 1, f)) {
+		LogError(logfp, LOGFATAL, "Cannot write to binary output file.");
+	}
+
+	ForEachOutKey(k) {
+		if (!has_bin_output(pd, k)) {
+			continue;
+		}
+
+		// time columns are identical across output keys: write them once
+		if (!has_time) {
+			for (i = 0; i < ncol_TimeOUT[pd]; i++) {
+				if (n != fwrite(p_OUT[k][pd] + nrow_OUT[pd] * i, sizeof(RealOut), n, f)) {
+					LogError(logfp, LOGFATAL, "Cannot write to binary output file.");
+				}
+			}
+			has_time = swTRUE;
+		}
+
+		for (i = 0; i < ncol_OUT[k]; i++) {
+			if (n != fwrite(p_OUT[k][pd] + nrow_OUT[pd] * (ncol_TimeOUT[pd] + i),
+				sizeof(RealOut), n, f)) {
+				LogError(logfp, LOGFATAL, "Cannot write to binary output file.");
+			}
+		}
+	}
+
+	SW_TRC_STOP_INT(write, "write binary chunk", "output", "rows", n);
+}
+
+
+/**
+@brief Close the binary output files
+
+@note Call this routine after the remaining buffered rows are written by
+  `SW_OUT_end_outarray_chunk()`; the output arrays are freed by
+  `SW_OUT_deconstruct()`.
+*/
+void SW_OUT_close_bin_files(void) {
+	OutPeriod pd;
+
+	ForEachOutPeriod(pd) {
+		if (!isnull(SW_OutBin.fp[pd])) {
+			CloseFile(&SW_OutBin.fp[pd]);
+		}
+	}
+}
+
+
+/**
+@brief Create the memory-mapped binary output file of output key `k` and
+  period `pd` that holds the output array of the full simulation run
+
+The file ("[name of the binary output file of `pd`]_[key].bin") has the
+format of a binary output file with one output key and exactly one chunk
+of `nrow` rows (see `SW_Output_outbin.h`); the values of the chunk are
+the output array in the layout of `iOUT` and `iOUT2` (column by column).
+The `get_XXX_mem` functions write directly into the file: the operating
+system pages the rows out as needed (memory is thus independent of the
+length of the run) and the file is the final output without a separate
+write pass when the output files are closed.
+
+@param k The output key.
+@param pd The output time step.
+@param nrow Number of rows (`nrow_OUT[pd]`).
+
+@return The output array of `nrow` rows (zero-initialized); it is unmapped
+  by `SW_OUT_unmap_bin_file()`.
+*/
+RealOut *SW_OUT_map_bin_file(OutKey k, OutPeriod pd, size_t nrow) {
+	SW_OUTBIN_HEADER header;
+	SW_OUTBIN_CHUNK chunk;
+	char fname[MAX_FILENAMESIZE], *names, *map;
+	size_t offset, size;
+	int fd;
+
+	map_file_name(k, pd, fname);
+
+	names = bin_header(pd, k, &header, sizeof(RealOut));
+	offset = sizeof header + header.len_colnames + sizeof chunk;
+	size = offset + nrow * header.n_cols * sizeof(RealOut);
+
+	// a new file is zero-filled up to its size without writing the values
+	fd = open(fname, O_RDWR | O_CREAT | O_TRUNC, 0666);
+	if (-1 == fd || 0 != ftruncate(fd, (off_t) size)) {
+		Mem_Free(names);
+		if (-1 != fd) {
+			close(fd);
+		}
+		LogError(logfp, LOGFATAL, "%s : Cannot create binary output file: %s",
+			fname, strerror(errno));
+	}
+
+	map = (char *) mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	if ((void *) MAP_FAILED == (void *) map) {
+		Mem_Free(names);
+		LogError(logfp, LOGFATAL, "%s : Cannot map binary output file: %s",
+			fname, strerror(errno));
+	}
+
+	chunk.n_rows = (uint32_t) nrow;
+	chunk.reserved = 0;
+
+	memcpy(map, &header, sizeof header);
+	memcpy(map + sizeof header, names, header.len_colnames);
+	memcpy(map + offset - sizeof chunk, &chunk, sizeof chunk);
+	Mem_Free(names);
+
+	SW_OutBin.map_base[k][pd] = map;
+	SW_OutBin.map_size[k][pd] = size;
+
+	return (RealOut *) (map + offset);
+}
+
+
+/**
+@brief Unmap the memory-mapped binary output file of output key `k` and
+  period `pd` (if mapped)
+
+The file keeps the values that were written into the output array; the
+operating system writes back any remaining modified pages.
+
+@param k The output key.
+@param pd The output time step.
+*/
+void SW_OUT_unmap_bin_file(OutKey k, OutPeriod pd) {
+	if (!isnull(SW_OutBin.map_base[k][pd])) {
+		munmap(SW_OutBin.map_base[k][pd], SW_OutBin.map_size[k][pd]);
+	}
+
+	SW_OutBin.map_base[k][pd] = NULL;
+	SW_OutBin.map_size[k][pd] = 0;
+}
@@ -0,0 +1,109 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Output_outbin.h
+  Type: header
+  Purpose: Support for SW_Output_outbin.c
+  Application: SOILWAT - soilwater dynamics simulator
+  Purpose: define functions to deal with binary columnar outputs;
+    currently, used by SOILWAT2-standalone
+
+    A binary output file holds all output keys of one output period:
+      - a header `SW_OUTBIN_HEADER`,
+      - a block of `len_colnames` bytes with the `n_cols` column names
+        as consecutive nul-terminated strings: the time columns
+        (e.g., "Year", "Day") followed by "[key]_[colname]" of each
+        output key (as for the header of `csv` files), and
+      - a sequence of chunks until the end of the file: each chunk is a
+        `SW_OUTBIN_CHUNK` followed by `n_cols` columns of `n_rows`
+        values each (column by column); values are doubles or, if
+        `value_size` of the header is 4, floats (see `SW_OUTFLOAT`).
+
+    A memory-mapped binary output file (see `SW_OUTFORMAT_MAP`) holds one
+    output key of one output period in the same format with exactly one
+    chunk of all rows of the run; its block of column names is padded
+    with nul bytes so that the values are aligned.
+
+    Values are stored in the byte order of the machine that
+    created the file.
+
+  History:
+  (2026-10-14) -- INITIAL CODING
+  (2026-10-15) version 2: header records the size of the values
+  2026-10-15 a checkpoint ends the current chunk early, see `SW_OUT_sync_bin_files()`
+  2026-10-15 added SW_OUTFORMAT_NONE
+  2026-10-15 added SW_OUTFORMAT_HDF
+  2026-10-15 added SW_OUTFORMAT_MAP, memory-mapped output arrays
+  2026-10-15 added SW_OUTFORMAT_DIGEST
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_OUTPUT_BIN_H
+#define SW_OUTPUT_BIN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define SW_OUTBIN_MAGIC "SW2OUTPT" /**< first 8 bytes of a binary output file */
+#define SW_OUTBIN_VERSION 2 /**< version of the binary output format */
+#define SW_OUTBIN_BYTEORDER 0x01020304 /**< detects a foreign byte order */
+#define SW_OUTBIN_EXT ".bin" /**< replaces the extension of the `csv` file name */
+#define SW_OUTBIN_CHUNKROWS 4096 /**< max number of rows buffered per chunk */
+
+/* Output formats of SOILWAT2-standalone, see `SW_OUT_set_format()` */
+#define SW_OUTFORMAT_CSV 1 /**< text output to `csv` files */
+#define SW_OUTFORMAT_BIN 2 /**< binary columnar output */
+#define SW_OUTFORMAT_MEM 4 /**< output arrays of the full run, see `SW_OUT_get_outarray()` */
+#define SW_OUTFORMAT_ASYNC 8 /**< `csv` files are written by a writer thread, see `SW_Output_outwriter.c` */
+#define SW_OUTFORMAT_NONE 16 /**< no output files or arrays; only reducers, see `SW_Output_reduce.c` */
+#define SW_OUTFORMAT_HDF 32 /**< output arrays of the full run are written into one HDF5 file of many sites, see `SW_Output_outhdf.c` */
+#define SW_OUTFORMAT_MAP 64 /**< output arrays of the full run are memory-mapped binary output files, see `SW_OUT_map_bin_file()` */
+#define SW_OUTFORMAT_DIGEST 128 /**< a digest of the output of each output key and period, see `SW_Output_digest.h` */
+
+/** Header of a binary output file */
+typedef struct {
+	char magic[8];
+	uint32_t version, byteorder,
+		period, /**< output period (`OutPeriod`) */
+		n_cols, /**< number of columns including the time columns */
+		len_colnames, /**< size of the block of column names in bytes */
+		value_size; /**< size of a value in bytes: 8 (double) or 4 (float) */
+} SW_OUTBIN_HEADER;
+
+/** Header of a chunk of rows of a binary output file */
+typedef struct {
+	uint32_t n_rows, /**< number of rows of the chunk */
+		reserved;
+} SW_OUTBIN_CHUNK;
+
+/** Binary output of a simulation run; zero-initialized means text output only */
+typedef struct {
+	Bool use; /**< TRUE if binary output is requested */
+	Bool skip_csv; /**< TRUE if text output to `csv` files is not requested */
+	FILE *fp[SW_OUTNPERIODS]; /**< one binary output file per output period */
+	Bool map; /**< TRUE if the output arrays of the full run are memory-mapped files */
+	void *map_base[SW_OUTNKEYS][SW_OUTNPERIODS]; /**< mapped binary output file of each output key and period; NULL if not mapped */
+	size_t map_size[SW_OUTNKEYS][SW_OUTNPERIODS]; /**< size of each mapped file in bytes */
+} SW_OUTBIN_FILES;
+
+
+// Function declarations
+void SW_OUT_set_format(int format);
+void SW_OUT_create_bin_files(void);
+void SW_OUT_resume_bin_files(const long pos[]);
+void SW_OUT_sync_bin_files(long pos[]);
+void SW_OUT_write_bin_chunk(OutPeriod pd);
+void SW_OUT_close_bin_files(void);
+RealOut *SW_OUT_map_bin_file(OutKey k, OutPeriod pd, size_t nrow);
+void SW_OUT_unmap_bin_file(OutKey k, OutPeriod pd);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
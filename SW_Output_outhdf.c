@@ -0,0 +1,640 @@
+/********************************************************/
+/********************************************************/
+/**
+  @file
+  @brief Output functionality that writes the outputs of many sites into
+  one HDF5 file
+
+  Each run collects all rows of its outputs in the output arrays `p_OUT`
+  (see `SW_OUTFORMAT_MEM`); when its output files are closed, the output
+  arrays are passed to the consumer of `SW_OUT_hdf_attach()` which writes
+  one hyperslab `[site, all time steps, layers, variables]` per output key
+  and output period (see `SW_Output_outhdf.h` for the file layout).
+
+  Runs of different sites (e.g., the worker threads of a batch) write
+  disjoint hyperslabs. Each worker arranges the values of its site as
+  `time x layer x variable` on its own; only the calls to the HDF5 library
+  are serialized by one lock (a build of HDF5 without thread-safety is
+  sufficient). Errors are reported only after the lock is released because
+  `LogError()` may not return.
+
+  The file, its datasets, and their bookkeeping are shared by all runs of
+  the process and are not taken from the arena of a run.
+
+  Without `SW_HDF5`, creating the file is an error.
+
+  History:
+  (2026-10-15) -- INITIAL CODING
+*/
+/********************************************************/
+/********************************************************/
+
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#ifdef SW_HDF5
+#include <pthread.h>
+#include <hdf5.h>
+#endif
+
+#include "generic.h"
+#include "filefuncs.h"
+
+#include "SW_Defines.h"
+
+#include "SW_Output.h"
+#include "SW_Output_outarray.h"
+#include "SW_Output_outhdf.h"
+#include "SW_Run.h"
+
+
+
+/* =================================================== */
+/*                  Global Variables                   */
+/* --------------------------------------------------- */
+
+// `colnames_OUT` is part of the simulation run context, see SW_Run.h
+
+// defined in `SW_Output.c`
+extern char const *key2str[];
+extern char const *pd2longstr[];
+
+// defined in `SW_Output_outarray.c`
+extern const IntUS ncol_TimeOUT[];
+
+
+
+#ifdef SW_HDF5
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** Memory and file type of output values */
+#define HDF_REALOUT ((sizeof(RealOut) == sizeof(float)) ? \
+	H5T_NATIVE_FLOAT : H5T_NATIVE_DOUBLE)
+#define HDF_REALOUT_FILE ((sizeof(RealOut) == sizeof(float)) ? \
+	H5T_IEEE_F32LE : H5T_IEEE_F64LE)
+
+/** The dataset of an output key and output period */
+typedef struct {
+	hid_t dset; /**< -1 until a site writes the output */
+	hsize_t n_layers; /**< current extent of the layer dimension */
+	unsigned int n_vars;
+	char (*vars)[SW_OUT_HDF_NAMELEN]; /**< names of the variables */
+} HDF_DSET;
+
+/** The HDF5 output file of the process */
+static struct {
+	pthread_mutex_t lock;
+	hid_t file; /**< -1 if not open */
+	unsigned int n_sites,
+		*isite; /**< `isite[i] = i`, passed to the consumer of site `i` */
+	hid_t group[SW_OUTNPERIODS]; /**< -1 until a site writes the output period */
+	hsize_t n_time[SW_OUTNPERIODS]; /**< number of time steps of each output period */
+	RealOut year0[SW_OUTNPERIODS]; /**< first year of each output period */
+	HDF_DSET d[SW_OUTNKEYS][SW_OUTNPERIODS];
+} Store = { PTHREAD_MUTEX_INITIALIZER, -1, 0, NULL, {0}, {0}, {0}, {{{0, 0, 0, NULL}}} };
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Allocate memory that is not part of a run
+
+  @return The memory or NULL if out of memory (with an error message).
+*/
+static void *hdf_alloc(size_t size, char *msg) {
+	void *p = malloc(max(size, (size_t) 1));
+
+	if (isnull(p)) {
+		snprintf(msg, MAX_ERROR, "Out of memory for HDF5 output.");
+	}
+
+	return p;
+}
+
+
+/** Split a column name into a variable and a soil layer
+
+  A column name `[variable]_Lyr_[j]` is layer `j - 1` (base0) of the
+  variable; a name `Lyr_[j]` is layer `j - 1` of the variable `dflt`;
+  other names are variables with one layer.
+
+  @param name Column name, see `SW_OUT_set_colnames()`.
+  @param dflt Name of the variable if `name` consists only of the layer.
+  @param var Resulting name of the variable (`SW_OUT_HDF_NAMELEN` bytes).
+  @param layer Resulting soil layer (base0).
+*/
+static void split_colname(const char *name, const char *dflt, char *var,
+	hsize_t *layer) {
+
+	const char *s = strstr(name, "Lyr_"), *d;
+	size_t n = strlen(name);
+
+	*layer = 0;
+
+	if (!isnull(s)) {
+		for (d = s + 4; isdigit((unsigned char) *d); d++);
+
+		if ('\0' == *d && d > s + 4 && '0' != s[4]) {
+			*layer = strtoul(s + 4, NULL, 10) - 1;
+			n = (size_t) (s - name);
+			if (n > 0 && '_' == name[n - 1]) {
+				n--;
+			}
+		}
+	}
+
+	if (0 == n) {
+		name = dflt;
+		n = strlen(dflt);
+	}
+
+	n = min(n, (size_t) SW_OUT_HDF_NAMELEN - 1);
+	memcpy(var, name, n);
+	var[n] = '\0';
+}
+
+
+/** Write an attribute or a dataset of fixed-length strings
+
+  @param loc Object of the attribute or group of the dataset.
+  @param name Name of the attribute or dataset.
+  @param s `n` strings of `len` bytes each (nul-terminated).
+  @param is_attr swTRUE for an attribute, swFALSE for a dataset.
+
+  @return swFALSE if the strings cannot be written.
+*/
+static Bool write_strings(hid_t loc, const char *name, const void *s,
+	size_t len, hsize_t n, Bool is_attr) {
+
+	hid_t type, space, obj;
+	herr_t status = -1;
+
+	type = H5Tcopy(H5T_C_S1);
+	H5Tset_size(type, len);
+	H5Tset_strpad(type, H5T_STR_NULLTERM);
+	space = H5Screate_simple(1, &n, NULL);
+
+	if (is_attr) {
+		obj = H5Acreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+		if (obj >= 0) {
+			status = H5Awrite(obj, type, s);
+			H5Aclose(obj);
+		}
+
+	} else {
+		obj = H5Dcreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT,
+			H5P_DEFAULT);
+		if (obj >= 0) {
+			status = H5Dwrite(obj, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, s);
+			H5Dclose(obj);
+		}
+	}
+
+	H5Sclose(space);
+	H5Tclose(type);
+
+	return (Bool) (status >= 0);
+}
+
+
+/** Create the group of an output period with a dataset per time column,
+  i.e., `Year` and, e.g., `Day`, with the time steps of the first site
+  that writes the output period
+
+  @param p Output array of the site (columns of `nrow` values, `stride` apart).
+*/
+static Bool create_period(OutPeriod pd, const RealOut *p, size_t nrow,
+	size_t stride, char *msg) {
+
+	hid_t space, dset;
+	hsize_t n = nrow;
+	herr_t status = -1;
+	IntUS j;
+	int *t;
+	size_t r;
+
+	Store.group[pd] = H5Gcreate2(Store.file, pd2longstr[pd], H5P_DEFAULT,
+		H5P_DEFAULT, H5P_DEFAULT);
+	if (Store.group[pd] < 0 || isnull(t = (int *) hdf_alloc(nrow * sizeof(int), msg))) {
+		if ('\0' == *msg) {
+			snprintf(msg, MAX_ERROR, "Cannot create group '%s' of HDF5 output.",
+				pd2longstr[pd]);
+		}
+		return swFALSE;
+	}
+
+	space = H5Screate_simple(1, &n, NULL);
+
+	for (j = 0; j < ncol_TimeOUT[pd]; j++) {
+		for (r = 0; r < nrow; r++) {
+			t[r] = (int) p[j * stride + r];
+		}
+
+		dset = H5Dcreate2(Store.group[pd], (0 == j) ? "Year" : pd2longstr[pd],
+			H5T_STD_I32LE, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+		status = (dset < 0) ? -1 :
+			H5Dwrite(dset, H5T_NATIVE_INT, H5S_ALL, H5S_ALL, H5P_DEFAULT, t);
+		if (dset >= 0) {
+			H5Dclose(dset);
+		}
+		if (status < 0) {
+			break;
+		}
+	}
+
+	H5Sclose(space);
+	free(t);
+
+	if (status < 0) {
+		snprintf(msg, MAX_ERROR, "Cannot write time steps of '%s' of HDF5 output.",
+			pd2longstr[pd]);
+		return swFALSE;
+	}
+
+	Store.n_time[pd] = nrow;
+	Store.year0[pd] = p[0];
+
+	return swTRUE;
+}
+
+
+/** Create the dataset `site x time x layer x variable` of an output key and
+  output period; chunks are one site, up to `SW_OUT_HDF_CHUNKSIZE` bytes of
+  time steps, one layer, and all variables
+*/
+static Bool create_dset(OutKey k, OutPeriod pd, hsize_t n_layers,
+	unsigned int n_vars, char (*vars)[SW_OUT_HDF_NAMELEN], char *msg) {
+
+	HDF_DSET *d = &Store.d[k][pd];
+	hsize_t dims[4], maxdims[4], chunk[4];
+	hid_t space, dcpl;
+	RealOut fill = (RealOut) NAN;
+
+	dims[0] = maxdims[0] = Store.n_sites;
+	dims[1] = maxdims[1] = Store.n_time[pd];
+	dims[2] = n_layers;
+	maxdims[2] = H5S_UNLIMITED;
+	dims[3] = maxdims[3] = n_vars;
+
+	chunk[0] = 1;
+	chunk[1] = SW_OUT_HDF_CHUNKSIZE / (n_vars * sizeof(RealOut));
+	chunk[1] = max(min(chunk[1], dims[1]), (hsize_t) 1);
+	chunk[2] = 1;
+	chunk[3] = n_vars;
+
+	space = H5Screate_simple(4, dims, maxdims);
+	dcpl = H5Pcreate(H5P_DATASET_CREATE);
+	H5Pset_chunk(dcpl, 4, chunk);
+	H5Pset_fill_value(dcpl, HDF_REALOUT, &fill);
+
+	d->dset = H5Dcreate2(Store.group[pd], key2str[k], HDF_REALOUT_FILE, space,
+		H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+	H5Pclose(dcpl);
+	H5Sclose(space);
+
+	if (d->dset < 0 ||
+		!write_strings(d->dset, "variables", vars, SW_OUT_HDF_NAMELEN, n_vars, swTRUE) ||
+		isnull(d->vars = hdf_alloc(n_vars * sizeof *vars, msg))) {
+
+		if ('\0' == *msg) {
+			snprintf(msg, MAX_ERROR, "Cannot create dataset '%s/%s' of HDF5 output.",
+				pd2longstr[pd], key2str[k]);
+		}
+		return swFALSE;
+	}
+
+	memcpy(d->vars, vars, n_vars * sizeof *vars);
+	d->n_vars = n_vars;
+	d->n_layers = n_layers;
+
+	return swTRUE;
+}
+
+
+/** Write the values of a site into the dataset of an output key and
+  output period (call with the lock held)
+
+  @param x Values of the site as `time x layer x variable` (row-major).
+*/
+static void write_dset(OutKey k, OutPeriod pd, unsigned int isite,
+	const RealOut *p, size_t nrow, size_t stride, const RealOut *x,
+	hsize_t n_layers, unsigned int n_vars, char (*vars)[SW_OUT_HDF_NAMELEN],
+	char *msg) {
+
+	HDF_DSET *d = &Store.d[k][pd];
+	hsize_t dims[4], start[4] = {0, 0, 0, 0}, count[4];
+	hid_t fspace, mspace;
+	herr_t status;
+	unsigned int v;
+
+	H5Eset_auto2(H5E_DEFAULT, NULL, NULL); // errors are reported by `msg`
+
+	if (Store.group[pd] < 0) {
+		if (!create_period(pd, p, nrow, stride, msg)) {
+			return;
+		}
+
+	} else if (nrow != Store.n_time[pd] || p[0] != Store.year0[pd]) {
+		snprintf(msg, MAX_ERROR, "'%s' output of the site covers other time "
+			"steps than that of other sites of the HDF5 output.", pd2longstr[pd]);
+		return;
+	}
+
+	if (d->dset < 0) {
+		if (!create_dset(k, pd, n_layers, n_vars, vars, msg)) {
+			return;
+		}
+
+	} else {
+		for (v = 0; v < n_vars && n_vars == d->n_vars; v++) {
+			if (0 != strcmp(vars[v], d->vars[v])) {
+				break;
+			}
+		}
+
+		if (n_vars != d->n_vars || v < n_vars) {
+			snprintf(msg, MAX_ERROR, "'%s' output of the site has other variables "
+				"than that of other sites of the HDF5 output.", key2str[k]);
+			return;
+		}
+	}
+
+	// a site with more soil layers extends the dataset (with NaN)
+	if (n_layers > d->n_layers) {
+		dims[0] = Store.n_sites;
+		dims[1] = Store.n_time[pd];
+		dims[2] = n_layers;
+		dims[3] = d->n_vars;
+
+		if (H5Dset_extent(d->dset, dims) < 0) {
+			snprintf(msg, MAX_ERROR, "Cannot extend dataset '%s/%s' of HDF5 output.",
+				pd2longstr[pd], key2str[k]);
+			return;
+		}
+		d->n_layers = n_layers;
+	}
+
+	start[0] = isite;
+	count[0] = 1;
+	count[1] = nrow;
+	count[2] = n_layers;
+	count[3] = n_vars;
+
+	fspace = H5Dget_space(d->dset);
+	mspace = H5Screate_simple(4, count, NULL);
+	status = H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, count, NULL);
+	if (status >= 0) {
+		status = H5Dwrite(d->dset, HDF_REALOUT, mspace, fspace, H5P_DEFAULT, x);
+	}
+	H5Sclose(mspace);
+	H5Sclose(fspace);
+
+	if (status < 0) {
+		snprintf(msg, MAX_ERROR, "Cannot write dataset '%s/%s' of HDF5 output.",
+			pd2longstr[pd], key2str[k]);
+	}
+}
+
+
+/** Consumer of the output arrays of a site, see `SW_OUTARRAY_CONSUMER`
+
+  @param data Index of the site, see `SW_OUT_hdf_attach()`.
+*/
+static void write_site(OutKey k, OutPeriod pd, const RealOut *p,
+	size_t nrow, size_t stride, IntUS ncol, void *data) {
+
+	unsigned int isite = *(const unsigned int *) data, n_vars = 0, *ivar = NULL;
+	IntUS nt = ncol_TimeOUT[pd], nc = ncol - nt, i;
+	char (*vars)[SW_OUT_HDF_NAMELEN] = NULL, msg[MAX_ERROR] = "";
+	hsize_t *layer = NULL, n_layers = 1;
+	RealOut *x = NULL;
+	size_t r, n;
+
+	if (0 == nc || 0 == nrow) {
+		return;
+	}
+
+	if (!isnull(vars = hdf_alloc(nc * sizeof *vars, msg)) &&
+		!isnull(layer = (hsize_t *) hdf_alloc(nc * sizeof *layer, msg)) &&
+		!isnull(ivar = (unsigned int *) hdf_alloc(nc * sizeof *ivar, msg))) {
+
+		// variables in order of their first column
+		for (i = 0; i < nc; i++) {
+			split_colname(colnames_OUT[k][i], key2str[k], vars[n_vars], &layer[i]);
+
+			for (ivar[i] = 0; ivar[i] < n_vars; ivar[i]++) {
+				if (0 == strcmp(vars[ivar[i]], vars[n_vars])) {
+					break;
+				}
+			}
+			if (ivar[i] == n_vars) {
+				n_vars++;
+			}
+
+			n_layers = max(n_layers, layer[i] + 1);
+		}
+
+		n = nrow * n_layers * n_vars;
+
+		if (!isnull(x = (RealOut *) hdf_alloc(n * sizeof *x, msg))) {
+			for (r = 0; r < n; r++) {
+				x[r] = (RealOut) NAN;
+			}
+
+			for (i = 0; i < nc; i++) {
+				for (r = 0; r < nrow; r++) {
+					x[(r * n_layers + layer[i]) * n_vars + ivar[i]] =
+						p[(nt + i) * stride + r];
+				}
+			}
+
+			pthread_mutex_lock(&Store.lock);
+			if (Store.file >= 0) {
+				write_dset(k, pd, isite, p, nrow, stride, x, n_layers, n_vars,
+					vars, msg);
+			}
+			pthread_mutex_unlock(&Store.lock);
+		}
+	}
+
+	free(x);
+	free(ivar);
+	free(layer);
+	free(vars);
+
+	if ('\0' != *msg) {
+		LogError(logfp, LOGFATAL, "%s", msg);
+	}
+}
+
+#endif
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Create the HDF5 output file of many sites
+
+An existing file is replaced. The datasets of the outputs are created when
+the first site writes them, see `SW_OUT_hdf_attach()`.
+
+@param fname Name of the file, e.g., `SW_OUT_HDF_FILENAME`.
+@param sites Name of each site, e.g., the entries of a manifest.
+@param n_sites Number of sites.
+
+@return An error message or `NULL` if the file was created.
+
+@note Call this routine before any run writes its outputs and
+  `SW_OUT_hdf_close()` after all runs have completed.
+*/
+const char *SW_OUT_hdf_create(const char *fname, const char *const *sites,
+	unsigned int n_sites) {
+
+	#ifdef SW_HDF5
+	char msg[MAX_ERROR] = "", *names;
+	size_t len = 1;
+	unsigned int i;
+	Bool ok;
+	OutKey k;
+	OutPeriod pd;
+
+	SW_OUT_hdf_close();
+
+	if (isnull(Store.isite = (unsigned int *) hdf_alloc(n_sites * sizeof(unsigned int), msg))) {
+		return "Out of memory for HDF5 output.";
+	}
+
+	for (i = 0; i < n_sites; i++) {
+		Store.isite[i] = i;
+		len = max(len, strlen(sites[i]) + 1);
+	}
+
+	Store.n_sites = n_sites;
+	ForEachOutPeriod(pd) {
+		Store.group[pd] = -1;
+		Store.n_time[pd] = 0;
+		ForEachOutKey(k) {
+			Store.d[k][pd].dset = -1;
+			Store.d[k][pd].vars = NULL;
+		}
+	}
+
+	H5Eset_auto2(H5E_DEFAULT, NULL, NULL);
+
+	Store.file = H5Fcreate(fname, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+	if (Store.file < 0) {
+		SW_OUT_hdf_close();
+		return "Cannot create the HDF5 output file.";
+	}
+
+	if (isnull(names = (char *) hdf_alloc(n_sites * len, msg))) {
+		SW_OUT_hdf_close();
+		return "Out of memory for HDF5 output.";
+	}
+
+	for (i = 0; i < n_sites; i++) {
+		strncpy(names + i * len, sites[i], len);
+	}
+
+	ok = write_strings(Store.file, "site", names, len, n_sites, swFALSE);
+	free(names);
+
+	if (!ok) {
+		SW_OUT_hdf_close();
+		return "Cannot write the sites of the HDF5 output file.";
+	}
+
+	return NULL;
+
+	#else
+	(void) fname;
+	(void) sites;
+	(void) n_sites;
+	return "Output to HDF5 requires SOILWAT2 compiled with HDF5 "
+		"(add -DSW_HDF5 to CPPFLAGS and -lhdf5 to LDLIBS)";
+	#endif
+}
+
+
+/**
+@brief Write the outputs of the active run as site `isite` of the HDF5
+  output file
+
+Registers a consumer of the output arrays (see
+`SW_OUT_set_outarray_consumer()`) which writes each output key and output
+period of the run when its output files are closed. Outputs that do not
+fit the datasets of other sites (e.g., other simulation years or other
+variables) are a fatal error of the run.
+
+@param isite Index of the site, see `SW_OUT_hdf_create()`.
+
+@note Call this routine after `SW_OUT_set_format()` with `SW_OUTFORMAT_HDF`
+  and before `SW_OUT_create_files()`.
+*/
+void SW_OUT_hdf_attach(unsigned int isite) {
+	#ifdef SW_HDF5
+	SW_OUT_set_outarray_consumer(write_site, &Store.isite[isite]);
+	#else
+	(void) isite;
+	#endif
+}
+
+
+/**
+@brief Close the HDF5 output file
+
+Sites that did not write an output (e.g., failed sites) have NaN values.
+*/
+void SW_OUT_hdf_close(void) {
+	#ifdef SW_HDF5
+	OutKey k;
+	OutPeriod pd;
+
+	pthread_mutex_lock(&Store.lock);
+
+	if (Store.file >= 0) {
+		ForEachOutPeriod(pd) {
+			ForEachOutKey(k) {
+				if (Store.d[k][pd].dset >= 0) {
+					H5Dclose(Store.d[k][pd].dset);
+				}
+				free(Store.d[k][pd].vars);
+				Store.d[k][pd].vars = NULL;
+				Store.d[k][pd].dset = -1;
+			}
+
+			if (Store.group[pd] >= 0) {
+				H5Gclose(Store.group[pd]);
+				Store.group[pd] = -1;
+			}
+		}
+
+		H5Fclose(Store.file);
+		Store.file = -1;
+	}
+
+	free(Store.isite);
+	Store.isite = NULL;
+	Store.n_sites = 0;
+
+	pthread_mutex_unlock(&Store.lock);
+	#endif
+}
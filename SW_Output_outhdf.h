@@ -0,0 +1,59 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Output_outhdf.h
+  Type: header
+  Purpose: Support for SW_Output_outhdf.c
+  Application: SOILWAT - soilwater dynamics simulator
+  Purpose: define functions to write the outputs of many sites into one
+    HDF5 file (option `-o h5`); currently, used by SOILWAT2-standalone
+
+    The file `SW_OUT_HDF_FILENAME` holds
+      - a dataset `/site` with the name of each site (e.g., as listed in
+        the manifest of a batch),
+      - a group per used output period (e.g., `/Day`) with one dataset
+        per time column (e.g., `/Day/Year` and `/Day/Day`), and
+      - a dataset per used output key and output period (e.g.,
+        `/Day/VWCBULK`) with dimensions `site x time x layer x variable`;
+        the attribute `variables` lists the variables. A column name
+        `[variable]_Lyr_[j]` (see `SW_OUT_set_colnames()`) is value `j`
+        of the layer dimension; other columns have one layer.
+        Values of sites or layers without output are NaN.
+
+    Datasets are chunked as one site, up to `SW_OUT_HDF_CHUNKSIZE` bytes
+    of time steps, one layer, and all variables so that the time series of
+    a site is read from a few contiguous chunks.
+
+    All sites must simulate the same years. Checkpoints (and resuming from
+    them) are not available.
+
+  History:
+  (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_OUTPUT_HDF_H
+#define SW_OUTPUT_HDF_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define SW_OUT_HDF_FILENAME "sw2_output.h5" /**< name of the HDF5 output file */
+#define SW_OUT_HDF_CHUNKSIZE (1024 * 1024) /**< target size of a chunk [bytes] */
+#define SW_OUT_HDF_NAMELEN 64 /**< maximum length of a variable name */
+
+
+// Function declarations
+const char *SW_OUT_hdf_create(const char *fname, const char *const *sites,
+	unsigned int n_sites);
+void SW_OUT_hdf_attach(unsigned int isite);
+void SW_OUT_hdf_close(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -9,6 +9,16 @@
 
   History:
   2018 June 15 (drs) moved functions from `SW_Output.c`
+  2026-10-15 SOILWAT2 `csv` files with extension `.gz` or `.zst` are
+    written as compressed streams, see `open_csv_file()`
+  2026-10-15 SOILWAT2 output files can be synced and resumed at
+    checkpoints, see `SW_OUT_sync_files()`
+  2026-10-15 closing of the output files is traced (option -t)
+  2026-10-15 SW_OUT_close_files() adds up the size of the closed files
+  2026-10-15 SW_OUT_close_files() writes the output digest, see SW_Output_digest.c
+  2026-10-15 compressed `csv` files are written with zlib or libzstd
+    (compiled with `SW_ZLIB` or `SW_ZSTD`) instead of piping them through
+    external programs
 */
 /********************************************************/
 /********************************************************/
@@ -18,6 +28,10 @@
 /*                INCLUDES / DEFINES                   */
 /* --------------------------------------------------- */
 
+#if (defined(SW_ZLIB) || defined(SW_ZSTD)) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for fopencookie() of glibc with -std=c11 */
+#endif
+
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -34,48 +48,51 @@
 
 #include "SW_Output.h"
 #include "SW_Output_outtext.h"
+#ifdef SOILWAT
+#include "SW_Output_outarray.h"
+#include "SW_Output_outbin.h"
+#include "SW_Output_outwriter.h"
+#include "SW_Trace.h"
+#endif
+#include "SW_Run.h"
+
+#ifdef SOILWAT
+#ifdef SW_ZLIB
+#include <zlib.h>
+#endif
+#ifdef SW_ZSTD
+#include <zstd.h>
+#endif
+#if (defined(SW_ZLIB) || defined(SW_ZSTD)) && !defined(__GLIBC__) && \
+	!defined(__APPLE__) && !defined(__FreeBSD__)
+#error "Compressed output files (SW_ZLIB, SW_ZSTD) require fopencookie() or funopen()."
+#endif
+#endif
 
 
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_MODEL SW_Model;
-extern SW_SITE SW_Site;
 
-// defined in `SW_Output.c`
-extern SW_OUTPUT SW_Output[];
-extern char _Sep;
-extern TimeInt tOffset;
-
-extern Bool use_OutPeriod[];
-extern IntUS used_OUTNPERIODS;
-extern OutPeriod timeSteps[SW_OUTNKEYS][SW_OUTNPERIODS];
-
-extern char *colnames_OUT[SW_OUTNKEYS][5 * NVEGTYPES + MAX_LAYERS];
-extern IntUS ncol_OUT[];
+// `SW_Output`, `_Sep`, `tOffset`, `use_OutPeriod`, `used_OUTNPERIODS`,
+// `timeSteps`, `colnames_OUT`, and `ncol_OUT` (defined in `SW_Output.c`) as
+// well as `SW_OutFiles` are part of the simulation run context, see SW_Run.h
 
+// defined in `SW_Output.c`
 extern char const *key2str[];
 extern char const *pd2longstr[];
 
 
 // defined here:
-SW_FILE_STATUS SW_OutFiles;
 
 Bool
   /** `print_IterationSummary` is TRUE if STEPWAT2 is called with `-o` flag
       and if STEPWAT2 is currently in its last iteration/repetition */
-  print_IterationSummary,
+  print_IterationSummary = swFALSE,
   /** `print_SW_Output` is TRUE for SOILWAT2 and
       if STEPWAT2 is called with `-i` flag */
-  print_SW_Output;
-
-/** \brief Formatted output string for single run output
-
-  Used for output as returned from any function `get_XXX_text` which are used
-  for SOILWAT2-standalone and for a single iteration/repeat for STEPWAT2
-*/
-char sw_outstr[MAX_LAYERS * OUTSTRLEN];
+  print_SW_Output = swTRUE;
 
 /** \brief Formatted output string for aggregated output
 
@@ -90,11 +107,48 @@ char sw_outstr[MAX_LAYERS * OUTSTRLEN];
 #undef sw_outstr_agg
 
 #ifdef STEPWAT
-char sw_outstr_agg[MAX_LAYERS * OUTSTRLEN];
+SW_THREAD_LOCAL char sw_outstr_agg[MAX_LAYERS * OUTSTRLEN];
 extern Bool prepare_IterationSummary; // defined in `SW_Output.c`
 extern Bool storeAllIterations; // defined in `SW_Output.c`
 #endif
 
+#ifdef SOILWAT
+/** Compressed `csv` files: file extension, the build flag that enables
+    it, and whether SOILWAT2 was compiled with it */
+static const char *const csv_zext[] = { ".gz", ".zst" };
+static const char *const csv_zflag[] = { "SW_ZLIB", "SW_ZSTD" };
+static const Bool csv_zbuilt[] = {
+	#ifdef SW_ZLIB
+	swTRUE,
+	#else
+	swFALSE,
+	#endif
+	#ifdef SW_ZSTD
+	swTRUE
+	#else
+	swFALSE
+	#endif
+};
+#define SW_OUTTEXT_NZ 2
+#define SW_OUTTEXT_ZBUFSIZE 1048576 /**< buffer size of a compressed stream */
+
+#if defined(SW_ZLIB) || defined(SW_ZSTD)
+/** State of a compressed `csv` file, see `open_csv_file()` */
+typedef struct {
+	int kind; /**< index of the extension in `csv_zext` */
+	#ifdef SW_ZLIB
+	gzFile gz; /**< `.gz` file */
+	#endif
+	#ifdef SW_ZSTD
+	FILE *fp; /**< `.zst` file */
+	ZSTD_CCtx *cctx; /**< compression context of the `.zst` file */
+	char *out; /**< compressed data that is written to `fp` */
+	size_t n_out; /**< size of `out` */
+	#endif
+} SW_ZSTREAM;
+#endif
+#endif
+
 
 /* =================================================== */
 /* =================================================== */
@@ -103,6 +157,12 @@ extern Bool storeAllIterations; // defined in `SW_Output.c`
 
 static void _create_csv_headers(OutPeriod pd, char *str_reg, char *str_soil, Bool does_agg);
 static void get_outstrheader(OutPeriod pd, char *str);
+#ifdef SOILWAT
+static FILE *open_csv_file(const char *fname, Bool *is_zipped);
+static void close_csv_file(FILE **fp, Bool is_zipped);
+static long sync_csv_file(FILE *fp, Bool is_zipped);
+static unsigned long file_size(FILE *fp);
+#endif
 
 
 /* =================================================== */
@@ -178,6 +238,309 @@ static void get_outstrheader(OutPeriod pd, char *str) {
 
 
 
+#ifdef SOILWAT
+#if defined(SW_ZLIB) || defined(SW_ZSTD)
+/**
+  \brief Compress data into a compressed `csv` file (write function of the
+  stream, see `open_csv_file()`)
+
+  \return The number of bytes that were consumed; 0 on failure.
+*/
+static size_t zstream_write(SW_ZSTREAM *z, const char *buf, size_t size) {
+	#ifdef SW_ZSTD
+	ZSTD_inBuffer in = { buf, size, 0 };
+	ZSTD_outBuffer out;
+	#endif
+
+	switch (z->kind) {
+		#ifdef SW_ZLIB
+		case 0:
+			// the stream hands over at most `SW_OUTTEXT_ZBUFSIZE` bytes at a time
+			return (size > 0 && gzwrite(z->gz, buf, (unsigned int) size) <= 0) ?
+				0 : size;
+		#endif
+
+		#ifdef SW_ZSTD
+		case 1:
+			while (in.pos < in.size) {
+				out.dst = z->out;
+				out.size = z->n_out;
+				out.pos = 0;
+
+				if (ZSTD_isError(ZSTD_compressStream2(z->cctx, &out, &in, ZSTD_e_continue)) ||
+					fwrite(z->out, 1, out.pos, z->fp) != out.pos) {
+					return 0;
+				}
+			}
+			return size;
+		#endif
+
+		default:
+			return 0;
+	}
+}
+
+
+/**
+  \brief Complete and close a compressed `csv` file (close function of the
+  stream, see `open_csv_file()`)
+
+  \return 0 on success, -1 on failure.
+*/
+static int zstream_close(SW_ZSTREAM *z) {
+	int res = -1;
+	#ifdef SW_ZSTD
+	ZSTD_inBuffer in = { NULL, 0, 0 };
+	ZSTD_outBuffer out;
+	size_t left;
+	#endif
+
+	switch (z->kind) {
+		#ifdef SW_ZLIB
+		case 0:
+			res = (Z_OK == gzclose(z->gz)) ? 0 : -1;
+			break;
+		#endif
+
+		#ifdef SW_ZSTD
+		case 1:
+			do {
+				out.dst = z->out;
+				out.size = z->n_out;
+				out.pos = 0;
+				left = ZSTD_compressStream2(z->cctx, &out, &in, ZSTD_e_end);
+			} while (!ZSTD_isError(left) &&
+				fwrite(z->out, 1, out.pos, z->fp) == out.pos && left > 0);
+
+			res = (!ZSTD_isError(left) && 0 == left) ? 0 : -1;
+			res = (0 == fclose(z->fp)) ? res : -1;
+			ZSTD_freeCCtx(z->cctx);
+			free(z->out);
+			break;
+		#endif
+
+		default:
+			break;
+	}
+
+	free(z);
+
+	return res;
+}
+
+
+/**
+  \brief Start a compressed `csv` file
+
+  \param fname The name of the file.
+  \param kind Index of the extension of the file in `csv_zext`.
+  \param fp The file, opened for writing; taken over (closed on failure).
+
+  \return The state of the compressed file; NULL on failure.
+*/
+static SW_ZSTREAM *zstream_open(const char *fname, int kind, FILE *fp) {
+	// freed by `zstream_close()` (not from the arena of the run)
+	SW_ZSTREAM *z = (SW_ZSTREAM *) calloc(1, sizeof(SW_ZSTREAM));
+	Bool ok = swFALSE;
+
+	(void) fname; // only used by zlib
+
+	if (!isnull(z)) {
+		z->kind = kind;
+
+		switch (kind) {
+			#ifdef SW_ZLIB
+			case 0:
+				CloseFile(&fp);
+				z->gz = gzopen(fname, "wb");
+				ok = (Bool) !isnull(z->gz);
+				break;
+			#endif
+
+			#ifdef SW_ZSTD
+			case 1:
+				z->fp = fp;
+				fp = NULL;
+				z->n_out = ZSTD_CStreamOutSize();
+				z->out = (char *) malloc(z->n_out);
+				z->cctx = ZSTD_createCCtx();
+				ok = (Bool) (!isnull(z->out) && !isnull(z->cctx) &&
+					!ZSTD_isError(ZSTD_CCtx_setParameter(z->cctx,
+						ZSTD_c_compressionLevel, ZSTD_CLEVEL_DEFAULT)));
+				if (!ok) {
+					ZSTD_freeCCtx(z->cctx);
+					free(z->out);
+					CloseFile(&z->fp);
+				}
+				break;
+			#endif
+
+			default:
+				break;
+		}
+	}
+
+	if (!isnull(fp)) {
+		CloseFile(&fp);
+	}
+
+	if (!ok) {
+		free(z);
+		z = NULL;
+	}
+
+	return z;
+}
+
+
+#if defined(__GLIBC__)
+static ssize_t zstream_cookie_write(void *cookie, const char *buf, size_t size) {
+	return (ssize_t) zstream_write((SW_ZSTREAM *) cookie, buf, size);
+}
+
+static int zstream_cookie_close(void *cookie) {
+	return zstream_close((SW_ZSTREAM *) cookie);
+}
+#else
+static int zstream_cookie_write(void *cookie, const char *buf, int size) {
+	return (int) zstream_write((SW_ZSTREAM *) cookie, buf, (size_t) size);
+}
+
+static int zstream_cookie_close(void *cookie) {
+	return zstream_close((SW_ZSTREAM *) cookie);
+}
+#endif
+#endif
+
+
+/**
+  \brief Open a `csv` output file for writing
+
+  A file name that ends with `.gz` or `.zst` is written as a compressed
+  stream with zlib or libzstd (at their default compression levels, as by
+  `gzip` and `zstd`); this requires that SOILWAT2 is compiled with
+  `SW_ZLIB` or `SW_ZSTD` (see makefile). The stream is a `FILE` whose
+  buffer hands over the rows in large blocks to the compressor.
+
+  \param fname The name of the file.
+  \param is_zipped Set to TRUE if the file is a compressed stream.
+
+  \return The opened stream; close it with `close_csv_file()`.
+*/
+static FILE *open_csv_file(const char *fname, Bool *is_zipped) {
+	size_t len = strlen(fname), len_ext;
+	int i;
+	FILE *fp;
+	#if defined(SW_ZLIB) || defined(SW_ZSTD)
+	SW_ZSTREAM *z;
+	#if defined(__GLIBC__)
+	cookie_io_functions_t io = {
+		NULL, zstream_cookie_write, NULL, zstream_cookie_close
+	};
+	#endif
+	#endif
+
+	for (i = 0; i < SW_OUTTEXT_NZ; i++) {
+		len_ext = strlen(csv_zext[i]);
+		if (len > len_ext && 0 == strcmp(fname + len - len_ext, csv_zext[i])) {
+			break;
+		}
+	}
+
+	*is_zipped = (Bool) (i < SW_OUTTEXT_NZ);
+
+	if (*is_zipped && !csv_zbuilt[i]) {
+		LogError(logfp, LOGFATAL, "Cannot compress output file %s: "
+			"SOILWAT2 was compiled without %s", fname, csv_zflag[i]);
+	}
+
+	// create (or truncate) the file: reports an invalid path as usual
+	fp = OpenFile(fname, *is_zipped ? "wb" : "w");
+
+	if (!*is_zipped) {
+		return fp;
+	}
+
+	#if defined(SW_ZLIB) || defined(SW_ZSTD)
+	z = zstream_open(fname, i, fp);
+
+	#if defined(__GLIBC__)
+	fp = isnull(z) ? NULL : fopencookie(z, "w", io);
+	#else
+	fp = isnull(z) ? NULL :
+		funopen(z, NULL, zstream_cookie_write, NULL, zstream_cookie_close);
+	#endif
+
+	if (isnull(fp)) {
+		if (!isnull(z)) {
+			zstream_close(z);
+		}
+		LogError(logfp, LOGFATAL, "Cannot open compressed output file %s", fname);
+	}
+
+	setvbuf(fp, NULL, _IOFBF, SW_OUTTEXT_ZBUFSIZE);
+	#endif
+
+	return fp;
+}
+
+
+/**
+  \brief Close a `csv` output file that was opened by `open_csv_file()`
+
+  \param fp The stream; set to NULL.
+  \param is_zipped TRUE if the file is a compressed stream.
+*/
+static void close_csv_file(FILE **fp, Bool is_zipped) {
+	if (!is_zipped) {
+		CloseFile(fp);
+		return;
+	}
+
+	// completes the compressed stream, see `zstream_close()`
+	if (0 != fclose(*fp)) {
+		*fp = NULL;
+		LogError(logfp, LOGFATAL, "Cannot complete compressed output file.");
+	}
+
+	*fp = NULL;
+}
+
+
+/**
+  \brief Size of an open output file (0 if unknown, e.g., of a compressed stream)
+*/
+static unsigned long file_size(FILE *fp) {
+	long n = isnull(fp) ? -1 : ftell(fp);
+
+	return (n > 0) ? (unsigned long) n : 0;
+}
+
+
+/**
+  \brief Commit a `csv` output file to disk
+
+  \param fp The stream.
+  \param is_zipped TRUE if the file is a compressed stream.
+
+  \return The size of the file.
+*/
+static long sync_csv_file(FILE *fp, Bool is_zipped) {
+	if (is_zipped) {
+		LogError(logfp, LOGFATAL,
+			"Compressed output files cannot be continued from a checkpoint.");
+	}
+
+	if (!SyncFile(fp)) {
+		LogError(logfp, LOGFATAL, "Cannot write to text output file.");
+	}
+
+	return ftell(fp);
+}
+#endif
+
+
+
 /* =================================================== */
 /* =================================================== */
 /*             Function Definitions                    */
@@ -200,29 +563,125 @@ void _create_csv_files(OutPeriod pd)
 	// a basename, etc.
 
 	if (SW_OutFiles.make_regular[pd]) {
-		SW_OutFiles.fp_reg[pd] = OpenFile(SW_F_name(eOutputDaily + pd), "w");
+		SW_OutFiles.fp_reg[pd] = open_csv_file(SW_F_name(eOutputDaily + pd),
+			&SW_OutFiles.zip_reg[pd]);
 	}
 
 	if (SW_OutFiles.make_soil[pd]) {
-		SW_OutFiles.fp_soil[pd] = OpenFile(SW_F_name(eOutputDaily_soil + pd), "w");
+		SW_OutFiles.fp_soil[pd] = open_csv_file(SW_F_name(eOutputDaily_soil + pd),
+			&SW_OutFiles.zip_soil[pd]);
 	}
 }
 
 /** @brief create all of the user-specified output files.
     @note Call this routine at the beginning of the main program run, but
     after SW_OUT_read() which sets the global variable use_OutPeriod.
+    @note Text (`csv`) and/or binary output files and output arrays of the
+    full simulation run are created as selected by `SW_OUT_set_format()`.
 */
 void SW_OUT_create_files(void) {
 	OutPeriod pd;
 
 	ForEachOutPeriod(pd) {
-		if (use_OutPeriod[pd]) {
+		if (SW_OutBin.skip_csv) {
+			SW_OutFiles.make_regular[pd] = swFALSE;
+			SW_OutFiles.make_soil[pd] = swFALSE;
+
+		} else if (use_OutPeriod[pd]) {
 			_create_csv_files(pd);
 
 			write_headers_to_csv(pd, SW_OutFiles.fp_reg[pd], SW_OutFiles.fp_soil[pd],
 				swFALSE);
 		}
 	}
+
+	if (SW_OutWriter.request && !SW_OutBin.skip_csv) {
+		SW_OUT_start_writer();
+	}
+
+	if (SW_OutDigest.use) {
+		SW_OUT_init_digest();
+	}
+
+	if (collect_OUT || !isnull(consumer_OUT)) {
+		SW_OUT_construct_outarray();
+	}
+
+	if (SW_OutBin.use) {
+		SW_OUT_create_bin_files();
+	}
+}
+
+/** @brief Write all output so far and commit the output files to disk,
+      e.g., at a checkpoint at the end of a year.
+    @param pos Resulting sizes of the output files; pass them to
+      `SW_OUT_resume_files()` to continue the files.
+    @note Output arrays (`SW_OUTFORMAT_MEM`, output consumers) and
+      compressed `csv` files cannot be continued from a checkpoint.
+*/
+void SW_OUT_sync_files(SW_OUT_FILEPOS *pos) {
+	OutPeriod pd;
+
+	if (collect_OUT || !isnull(consumer_OUT)) {
+		LogError(logfp, LOGFATAL,
+			"Output arrays cannot be continued from a checkpoint.");
+	}
+
+	SW_OUT_sync_writer();
+
+	ForEachOutPeriod(pd) {
+		pos->reg[pd] = pos->soil[pd] = -1;
+
+		if (use_OutPeriod[pd]) {
+			if (SW_OutFiles.make_regular[pd]) {
+				pos->reg[pd] = sync_csv_file(SW_OutFiles.fp_reg[pd],
+					SW_OutFiles.zip_reg[pd]);
+			}
+
+			if (SW_OutFiles.make_soil[pd]) {
+				pos->soil[pd] = sync_csv_file(SW_OutFiles.fp_soil[pd],
+					SW_OutFiles.zip_soil[pd]);
+			}
+		}
+	}
+
+	SW_OUT_sync_bin_files(pos->bin);
+}
+
+/** @brief Continue the output files of a run that resumes from a checkpoint.
+    @param pos Sizes of the output files at the checkpoint, see
+      `SW_OUT_sync_files()`; anything that was written after the checkpoint
+      is discarded.
+    @note Call this routine instead of `SW_OUT_create_files()`.
+*/
+void SW_OUT_resume_files(const SW_OUT_FILEPOS *pos) {
+	OutPeriod pd;
+
+	ForEachOutPeriod(pd) {
+		if (SW_OutBin.skip_csv) {
+			SW_OutFiles.make_regular[pd] = swFALSE;
+			SW_OutFiles.make_soil[pd] = swFALSE;
+
+		} else if (use_OutPeriod[pd]) {
+			if (SW_OutFiles.make_regular[pd]) {
+				SW_OutFiles.fp_reg[pd] = ResumeFile(SW_F_name(eOutputDaily + pd),
+					"r+", pos->reg[pd]);
+			}
+
+			if (SW_OutFiles.make_soil[pd]) {
+				SW_OutFiles.fp_soil[pd] = ResumeFile(SW_F_name(eOutputDaily_soil + pd),
+					"r+", pos->soil[pd]);
+			}
+		}
+	}
+
+	if (SW_OutWriter.request && !SW_OutBin.skip_csv) {
+		SW_OUT_start_writer();
+	}
+
+	if (SW_OutBin.use) {
+		SW_OUT_resume_bin_files(pos->bin);
+	}
 }
 
 
@@ -371,6 +830,73 @@ void get_outstrleader(OutPeriod pd, char *str) {
 
 
 
+/**
+  \brief Position at which an output formatter appends to the output row
+
+  Functions `get_XXX_text` (which are used for SOILWAT2-standalone and
+  for a single iteration/repeat for STEPWAT2) append their formatted values
+  directly to the row buffer `buf_soil` or `buf_reg` of their text output file
+  (without rescanning the row) and call SW_OUT_text_row_end() when done.
+
+  \param k The output key.
+  \param pd The output time step.
+
+  \return Pointer to the end of the current output row.
+*/
+char *SW_OUT_text_row(OutKey k, OutPeriod pd) {
+	return SW_Output[k].has_sl ?
+		SW_OutFiles.buf_soil[pd] + SW_OutFiles.len_soil[pd] :
+		SW_OutFiles.buf_reg[pd] + SW_OutFiles.len_reg[pd];
+}
+
+/**
+  \brief Record the new end of the output row after an output formatter
+    appended values, see SW_OUT_text_row()
+
+  \param k The output key.
+  \param pd The output time step.
+  \param end Pointer to the terminating nul character of the output row.
+*/
+void SW_OUT_text_row_end(OutKey k, OutPeriod pd, const char *end) {
+	if (SW_Output[k].has_sl) {
+		SW_OutFiles.len_soil[pd] = (size_t) (end - SW_OutFiles.buf_soil[pd]);
+	} else {
+		SW_OutFiles.len_reg[pd] = (size_t) (end - SW_OutFiles.buf_reg[pd]);
+	}
+}
+
+/**
+  \brief Append the separator and a value with `OUT_DIGITS` decimal digits
+
+  Output is identical to `sprintf(s, "%c%.*f", _Sep, OUT_DIGITS, x)`.
+
+  \param s Position in an output row, see SW_OUT_text_row().
+  \param x The value.
+
+  \return Pointer to the new end of the output row.
+*/
+char *SW_OUT_put_dbl(char *s, RealD x) {
+	*s++ = _Sep;
+	return Str_FormatFixed(s, x, OUT_DIGITS);
+}
+
+/**
+  \brief Append the separator and an integer value
+
+  Output is identical to `sprintf(s, "%c%d", _Sep, x)`.
+
+  \param s Position in an output row, see SW_OUT_text_row().
+  \param x The value.
+
+  \return Pointer to the new end of the output row.
+*/
+char *SW_OUT_put_int(char *s, int x) {
+	*s++ = _Sep;
+	return Str_FormatFixed(s, (double) x, 0);
+}
+
+
+
 /**
   \brief Creates column headers for output files
 
@@ -451,7 +977,16 @@ void find_TXToutputSoilReg_inUse(void)
 void SW_OUT_close_files(void) {
 	Bool close_regular, close_layers, close_aggs;
 	OutPeriod p;
+	#ifdef SOILWAT
+	OutKey k;
+	#endif
 
+	#ifdef SOILWAT
+	SW_TRC_START(close);
+
+	// write all queued rows before their files are closed
+	SW_OUT_stop_writer();
+	#endif
 
 	ForEachOutPeriod(p) {
 		#if defined(SOILWAT)
@@ -467,6 +1002,22 @@ void SW_OUT_close_files(void) {
 		#endif
 
 		if (use_OutPeriod[p]) {
+			#if defined(SOILWAT)
+			if (close_regular) {
+				if (!SW_OutFiles.zip_reg[p]) {
+					SW_OutFiles.n_bytes += file_size(SW_OutFiles.fp_reg[p]);
+				}
+				close_csv_file(&SW_OutFiles.fp_reg[p], SW_OutFiles.zip_reg[p]);
+			}
+
+			if (close_layers) {
+				if (!SW_OutFiles.zip_soil[p]) {
+					SW_OutFiles.n_bytes += file_size(SW_OutFiles.fp_soil[p]);
+				}
+				close_csv_file(&SW_OutFiles.fp_soil[p], SW_OutFiles.zip_soil[p]);
+			}
+
+			#elif defined(STEPWAT)
 			if (close_regular) {
 				CloseFile(&SW_OutFiles.fp_reg[p]);
 			}
@@ -474,6 +1025,7 @@ void SW_OUT_close_files(void) {
 			if (close_layers) {
 				CloseFile(&SW_OutFiles.fp_soil[p]);
 			}
+			#endif
 
 			if (close_aggs) {
 				#ifdef STEPWAT
@@ -486,4 +1038,27 @@ void SW_OUT_close_files(void) {
 			}
 		}
 	}
+
+	#ifdef SOILWAT
+	// pass the remaining rows to the consumer and/or binary output files;
+	// memory-mapped output arrays are already their files
+	ForEachOutPeriod(p) {
+		if (use_OutPeriod[p]) {
+			SW_OUT_end_outarray_chunk(p);
+		}
+		SW_OutFiles.n_bytes += file_size(SW_OutBin.fp[p]);
+
+		ForEachOutKey(k) {
+			SW_OutFiles.n_bytes += SW_OutBin.map_size[k][p];
+		}
+	}
+
+	SW_OUT_close_bin_files();
+
+	if (SW_OutDigest.use) {
+		SW_OUT_write_digest();
+	}
+
+	SW_TRC_STOP(close, "close output", "output");
+	#endif
 }
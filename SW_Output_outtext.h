@@ -9,6 +9,11 @@
 
   History:
   2018 June 15 (drs) moved functions from `SW_Output.c`
+  2026-10-14 `get_XXX_text` functions append to the output rows with a
+    cursor and format values with `Str_FormatFixed()`
+  2026-10-15 added SW_OUT_sync_files() and SW_OUT_resume_files() for
+    checkpoints of SOILWAT2-standalone
+  2026-10-15 SW_OUT_close_files() adds up the size of the closed files
  */
 /********************************************************/
 /********************************************************/
@@ -42,14 +47,39 @@ typedef struct {
 	FILE *fp_soil[SW_OUTNPERIODS];
 	char buf_soil[SW_OUTNPERIODS][MAX_LAYERS * OUTSTRLEN];
 
+	// length of the current output rows in `buf_reg` and `buf_soil`;
+	// `get_XXX_text` functions append at this position (see `SW_OUT_text_row()`)
+	size_t len_reg[SW_OUTNPERIODS], len_soil[SW_OUTNPERIODS];
+
+	#ifdef SOILWAT
+	// TRUE if `fp_reg` or `fp_soil` is a compressed stream (`.gz` or `.zst`)
+	Bool zip_reg[SW_OUTNPERIODS], zip_soil[SW_OUTNPERIODS];
+
+	// size of the output files (other than compressed streams) that were
+	// closed by `SW_OUT_close_files()`, e.g., for the metrics of batch mode
+	unsigned long n_bytes;
+	#endif
+
 } SW_FILE_STATUS;
 
+#ifdef SOILWAT
+/** Sizes of the output files of a run at a checkpoint (-1 if not used),
+    see `SW_OUT_sync_files()` */
+typedef struct {
+	long reg[SW_OUTNPERIODS], /**< "regular" `csv` files */
+		soil[SW_OUTNPERIODS], /**< `csv` files of soil layers */
+		bin[SW_OUTNPERIODS]; /**< binary output files */
+} SW_OUT_FILEPOS;
+#endif
+
 
 
 // Function declarations
 #if defined(SOILWAT)
 void _create_csv_files(OutPeriod pd);
 void SW_OUT_create_files(void);
+void SW_OUT_sync_files(SW_OUT_FILEPOS *pos);
+void SW_OUT_resume_files(const SW_OUT_FILEPOS *pos);
 
 #elif defined(STEPWAT)
 void _create_filename_ST(char *str, char *flag, int iteration, char *filename);
@@ -59,6 +89,10 @@ void SW_OUT_create_iteration_files(int iteration);
 #endif
 
 void get_outstrleader(OutPeriod pd, char *str);
+char *SW_OUT_text_row(OutKey k, OutPeriod pd);
+void SW_OUT_text_row_end(OutKey k, OutPeriod pd, const char *end);
+char *SW_OUT_put_dbl(char *s, RealD x);
+char *SW_OUT_put_int(char *s, int x);
 void write_headers_to_csv(OutPeriod pd, FILE *fp_reg, FILE *fp_soil, Bool does_agg);
 void find_TXToutputSoilReg_inUse(void);
 void SW_OUT_close_files(void);
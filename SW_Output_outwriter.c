@@ -0,0 +1,330 @@
+/********************************************************/
+/********************************************************/
+/**
+  @file
+  @brief Asynchronous writer of text output to `csv` files
+
+  `SW_OUT_write_today()` formats rows of `csv` output on the simulation
+  thread (the `get_XXX_text` functions read the model state); if the
+  writer is in use, then `SW_OUT_write_row()` appends a formatted row
+  to a block of a small ring of blocks instead of writing it to its file.
+  A writer thread writes the rows of full blocks to their files while the
+  simulation thread continues; the simulation thread waits only if all
+  blocks are queued (see `SW_Output_outwriter.h`).
+
+  The writer is requested with `SW_OUTFORMAT_ASYNC`, started by
+  `SW_OUT_create_files()`, and drained and stopped by
+  `SW_OUT_close_files()` before the files are closed.
+
+  History:
+  (2026-10-15) -- INITIAL CODING
+  2026-10-15 writes of blocks and waits for the writer are traced (option -t)
+*/
+/********************************************************/
+/********************************************************/
+
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+
+#include "SW_Defines.h"
+#include "SW_Files.h"
+
+#include "SW_Output.h"
+#include "SW_Output_outwriter.h"
+#include "SW_Trace.h"
+#include "SW_Run.h"
+
+
+
+/* =================================================== */
+/*                  Global Variables                   */
+/* --------------------------------------------------- */
+
+// `SW_OutWriter` is part of the simulation run context, see SW_Run.h
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Write all records of a block to their files
+    @return FALSE if a record could not be written completely */
+static Bool write_block(const SW_OUTWRITER_BLOCK *b) {
+	SW_OUTWRITER_RECORD rec;
+	size_t pos = 0;
+	Bool ok = swTRUE;
+
+	while (pos < b->len) {
+		memcpy(&rec, b->data + pos, sizeof rec);
+		pos += sizeof rec;
+
+		if (rec.len != fwrite(b->data + pos, 1, rec.len, rec.fp)) {
+			ok = swFALSE;
+		}
+		pos += rec.len;
+	}
+
+	return ok;
+}
+
+
+/** Body of the writer thread: write queued blocks in order until stopped
+    and the ring is empty
+
+    @note The writer thread does not have a simulation run context and
+      must not call `LogError()`; failures are reported by
+      `SW_OUT_stop_writer()`.
+*/
+static void *run_writer(void *arg) {
+	SW_OUTWRITER *w = (SW_OUTWRITER *) arg;
+	SW_OUTWRITER_BLOCK *b;
+	Bool ok;
+
+	SW_TRC_thread_name("output writer");
+
+	pthread_mutex_lock(&w->lock);
+
+	for (;;) {
+		while (0 == w->n_queued && !w->stop) {
+			pthread_cond_wait(&w->cond_queued, &w->lock);
+		}
+
+		if (0 == w->n_queued) {
+			break; // stopped and drained
+		}
+
+		// the simulation thread does not touch queued blocks
+		b = &w->blocks[w->i_write];
+		pthread_mutex_unlock(&w->lock);
+
+		SW_TRC_START(write);
+		ok = write_block(b);
+		SW_TRC_STOP_INT(write, "write csv block", "output", "bytes", b->len);
+
+		pthread_mutex_lock(&w->lock);
+		if (!ok) {
+			w->failed = swTRUE;
+		}
+		b->len = 0;
+		w->i_write = (w->i_write + 1) % SW_OUTWRITER_NBLOCKS;
+		w->n_queued--;
+		pthread_cond_signal(&w->cond_written);
+	}
+
+	pthread_mutex_unlock(&w->lock);
+
+	return NULL;
+}
+
+
+/** Wait until the writer thread has written all queued blocks */
+static void drain_writer(void) {
+	SW_OUTWRITER *w = &SW_OutWriter;
+
+	pthread_mutex_lock(&w->lock);
+	while (w->n_queued > 0) {
+		pthread_cond_wait(&w->cond_written, &w->lock);
+	}
+	pthread_mutex_unlock(&w->lock);
+}
+
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Function Definitions                    */
+/*             (declared in SW_Output_outwriter.h)     */
+/* --------------------------------------------------- */
+
+/**
+@brief Allocate the ring of blocks and start the writer thread
+
+@note Call this routine after the `csv` files are created; the writer
+  thread only writes rows to files that are open.
+*/
+void SW_OUT_start_writer(void) {
+	SW_OUTWRITER *w = &SW_OutWriter;
+	unsigned int i;
+
+	for (i = 0; i < SW_OUTWRITER_NBLOCKS; i++) {
+		w->blocks[i].data = (char *) Mem_Malloc(SW_OUTWRITER_BLOCKSIZE,
+			"SW_OUT_start_writer()");
+		w->blocks[i].len = 0;
+	}
+
+	w->i_fill = w->i_write = w->n_queued = 0;
+	w->stop = w->failed = swFALSE;
+
+	pthread_mutex_init(&w->lock, NULL);
+	pthread_cond_init(&w->cond_queued, NULL);
+	pthread_cond_init(&w->cond_written, NULL);
+
+	if (0 != pthread_create(&w->thread, NULL, run_writer, w)) {
+		LogError(logfp, LOGWARN,
+			"Cannot start the output writer thread: output is written synchronously.");
+		SW_OUT_stop_writer();
+		return;
+	}
+
+	w->use = swTRUE;
+}
+
+
+/**
+@brief Write one row of `csv` output, i.e., `leader`, `row`, and a newline
+
+Without the writer, the row is written immediately; otherwise, the row
+is appended to the block that is being filled and written later by the
+writer thread.
+
+@param fp The `csv` file.
+@param leader The time columns of the row.
+@param row The formatted output of the row.
+@param len_row The length of `row`.
+*/
+void SW_OUT_write_row(FILE *fp, const char *leader, const char *row, size_t len_row) {
+	SW_OUTWRITER *w = &SW_OutWriter;
+	SW_OUTWRITER_BLOCK *b;
+	SW_OUTWRITER_RECORD rec;
+	size_t len_leader, len;
+
+	if (!w->use) {
+		fprintf(fp, "%s%s\n", leader, row);
+		return;
+	}
+
+	len_leader = strlen(leader);
+	len = sizeof rec + len_leader + len_row + 1;
+
+	if (len > SW_OUTWRITER_BLOCKSIZE) {
+		// row does not fit into a block: keep rows in order and write it here
+		SW_OUT_submit_rows();
+		drain_writer();
+		fprintf(fp, "%s%s\n", leader, row);
+		return;
+	}
+
+	if (w->blocks[w->i_fill].len + len > SW_OUTWRITER_BLOCKSIZE) {
+		SW_OUT_submit_rows();
+	}
+
+	b = &w->blocks[w->i_fill];
+
+	rec.fp = fp;
+	rec.len = len_leader + len_row + 1;
+	memcpy(b->data + b->len, &rec, sizeof rec);
+	memcpy(b->data + b->len + sizeof rec, leader, len_leader);
+	memcpy(b->data + b->len + sizeof rec + len_leader, row, len_row);
+	b->data[b->len + len - 1] = '\n';
+	b->len += len;
+}
+
+
+/**
+@brief Queue the block that is being filled for the writer thread
+
+Waits if all blocks are queued (back-pressure); does nothing if the writer
+is not in use or if the block is empty.
+*/
+void SW_OUT_submit_rows(void) {
+	SW_OUTWRITER *w = &SW_OutWriter;
+
+	if (!w->use || 0 == w->blocks[w->i_fill].len) {
+		return;
+	}
+
+	pthread_mutex_lock(&w->lock);
+
+	w->n_queued++;
+	w->i_fill = (w->i_fill + 1) % SW_OUTWRITER_NBLOCKS;
+	pthread_cond_signal(&w->cond_queued);
+
+	// the next block is free once the writer thread is done with it
+	if (w->n_queued == SW_OUTWRITER_NBLOCKS) {
+		SW_TRC_START(wait);
+		while (w->n_queued == SW_OUTWRITER_NBLOCKS) {
+			pthread_cond_wait(&w->cond_written, &w->lock);
+		}
+		SW_TRC_STOP(wait, "wait for output writer", "output");
+	}
+
+	pthread_mutex_unlock(&w->lock);
+}
+
+
+/**
+@brief Wait until all rows so far are written to their files; the writer
+  keeps running
+
+@note Call this routine before the `csv` files are flushed, e.g., at a
+  checkpoint (see `SW_OUT_sync_files()`).
+*/
+void SW_OUT_sync_writer(void) {
+	SW_OUTWRITER *w = &SW_OutWriter;
+
+	if (!w->use) {
+		return;
+	}
+
+	SW_OUT_submit_rows();
+	drain_writer();
+
+	if (w->failed) {
+		LogError(logfp, LOGFATAL, "Cannot write to text output file.");
+	}
+}
+
+
+/**
+@brief Write all remaining rows, stop the writer thread, and free the ring
+
+@note Call this routine before the `csv` files are closed.
+*/
+void SW_OUT_stop_writer(void) {
+	SW_OUTWRITER *w = &SW_OutWriter;
+	unsigned int i;
+	Bool failed;
+
+	if (w->use) {
+		SW_OUT_submit_rows();
+
+		pthread_mutex_lock(&w->lock);
+		w->stop = swTRUE;
+		pthread_cond_signal(&w->cond_queued);
+		pthread_mutex_unlock(&w->lock);
+
+		pthread_join(w->thread, NULL);
+	}
+
+	if (isnull(w->blocks[0].data)) {
+		return; // writer was never started
+	}
+
+	pthread_cond_destroy(&w->cond_written);
+	pthread_cond_destroy(&w->cond_queued);
+	pthread_mutex_destroy(&w->lock);
+
+	for (i = 0; i < SW_OUTWRITER_NBLOCKS; i++) {
+		Mem_Free(w->blocks[i].data);
+		w->blocks[i].data = NULL;
+	}
+
+	failed = w->failed;
+	w->use = w->stop = w->failed = swFALSE;
+
+	if (failed) {
+		LogError(logfp, LOGFATAL, "Cannot write to text output file.");
+	}
+}
@@ -0,0 +1,85 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Output_outwriter.h
+  Type: header
+  Purpose: Support for SW_Output_outwriter.c
+  Application: SOILWAT - soilwater dynamics simulator
+  Purpose: define the asynchronous writer of text output; currently, used
+    by SOILWAT2-standalone
+
+    The simulation thread appends complete rows of `csv` output to one of
+    `SW_OUTWRITER_NBLOCKS` blocks; a full block is handed to a writer
+    thread which writes its rows to their files while the simulation
+    thread fills the next block. If all blocks wait to be written, then
+    the simulation thread waits (back-pressure) so that memory is bounded
+    by `SW_OUTWRITER_NBLOCKS * SW_OUTWRITER_BLOCKSIZE` bytes per run.
+
+  History:
+  (2026-10-15) -- INITIAL CODING
+  2026-10-15 added SW_OUT_sync_writer() for checkpoints
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_OUTPUT_WRITER_H
+#define SW_OUTPUT_WRITER_H
+
+#include <stdio.h>
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#define SW_OUTWRITER_NBLOCKS 4 /**< number of blocks of the ring */
+#define SW_OUTWRITER_BLOCKSIZE 262144 /**< size of a block in bytes */
+
+/** A block of rows: a sequence of records, each a `SW_OUTWRITER_RECORD`
+    followed by `len` bytes of text */
+typedef struct {
+	char *data;
+	size_t len; /**< number of bytes used */
+} SW_OUTWRITER_BLOCK;
+
+/** Header of a record of a block */
+typedef struct {
+	FILE *fp; /**< destination file */
+	size_t len; /**< number of bytes of text that follow */
+} SW_OUTWRITER_RECORD;
+
+/** Asynchronous writer of text output of a simulation run;
+    zero-initialized means synchronous writing */
+typedef struct {
+	Bool request; /**< TRUE if asynchronous writing is requested, see `SW_OUT_set_format()` */
+	Bool use; /**< TRUE if the writer thread is running */
+	Bool stop; /**< TRUE if the writer thread should exit once the ring is empty */
+	Bool failed; /**< TRUE if the writer thread failed to write a row */
+
+	pthread_t thread;
+	pthread_mutex_t lock;
+	pthread_cond_t
+		cond_queued, /**< signals the writer thread that a block was queued */
+		cond_written; /**< signals the simulation thread that a block was written */
+
+	SW_OUTWRITER_BLOCK blocks[SW_OUTWRITER_NBLOCKS];
+	unsigned int
+		i_fill, /**< block that the simulation thread fills */
+		i_write, /**< oldest queued block, i.e., next block to write */
+		n_queued; /**< number of blocks that wait to be written */
+} SW_OUTWRITER;
+
+
+// Function declarations
+void SW_OUT_start_writer(void);
+void SW_OUT_write_row(FILE *fp, const char *leader, const char *row, size_t len_row);
+void SW_OUT_submit_rows(void);
+void SW_OUT_sync_writer(void);
+void SW_OUT_stop_writer(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,289 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Output_reduce.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Reduce the daily state of a simulation run to values that a
+ *           calling program registers for, computed while the run
+ *           progresses (see `SW_Output_reduce.h`).
+ *
+ *           Reducers are called by `SW_CTL_end_day()` (before the state
+ *           of today is carried over to tomorrow) and by
+ *           `SW_CTL_end_year()`. `SW_OUT_add_summary()` registers a
+ *           reducer of the summary statistics that calibrations commonly
+ *           use: annual actual evapotranspiration, deep drainage, and the
+ *           distribution of available soil water.
+ *
+ *           Reducers are not part of checkpoints or run images; the data
+ *           of a reducer belongs to the calling program.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ *     2026-10-15 summary statistics as a row of a table (for sweeps)
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "SW_Defines.h"
+#include "SW_Site.h"
+#include "SW_SoilWater.h"
+#include "SW_Output_reduce.h"
+#include "SW_Run.h"
+
+#define SW_OUT_SUMMARY_NFIELDS (9 + SW_OUT_SUMMARY_NBINS) /**< fields of the summary statistics */
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Name of field `k` of the summary statistics, e.g., `mean_annual_aet_cm` */
+static void summary_name(char *name, size_t size, unsigned int k,
+	RealD swa_binwidth) {
+
+	static const char *names[] = {
+		"years", "days", "mean_annual_aet_cm", "sd_annual_aet_cm",
+		"mean_annual_pet_cm", "mean_annual_deep_drainage_cm", "mean_swa_cm",
+		"min_swa_cm", "max_swa_cm"
+	};
+	unsigned int b = k - 9;
+
+	if (k < 9) {
+		snprintf(name, size, "%s", names[k]);
+	} else {
+		snprintf(name, size, "swa_%g%s", b * swa_binwidth,
+			(b + 1 < SW_OUT_SUMMARY_NBINS) ? "" : "+");
+	}
+}
+
+
+/** Value of field `k` of the summary statistics of a completed run */
+static RealD summary_value(const SW_OUT_SUMMARY *s, unsigned int k) {
+	RealD n = (s->n_years > 0) ? s->n_years : 1.,
+		nd = (s->n_days > 0) ? s->n_days : 1.;
+
+	switch (k) {
+		case 0: return s->n_years;
+		case 1: return s->n_days;
+		case 2: return s->aet / n;
+		case 3: return (s->n_years > 1) ?
+			sqrt(fmax(s->aet_sq - squared(s->aet) / n, 0.) / (n - 1.)) : 0.;
+		case 4: return s->pet / n;
+		case 5: return s->deep / n;
+		case 6: return s->swa / nd;
+		case 7: return (s->n_days > 0) ? s->swa_min : 0.;
+		case 8: return (s->n_days > 0) ? s->swa_max : 0.;
+		default: return s->swa_bins[k - 9] / nd;
+	}
+}
+
+
+/* =================================================== */
+/*             Global Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Register a reducer with the active run
+
+@param day Function that is called at the end of each day; may be `NULL`.
+@param year Function that is called at the end of each year; may be `NULL`.
+@param data A pointer that is passed on to `day` and `year`; must outlive
+  the run.
+
+@note Reducers are called in the order in which they were registered.
+*/
+void SW_OUT_add_reducer(SW_OUT_REDUCER_FUNC day, SW_OUT_REDUCER_FUNC year,
+	void *data) {
+
+	SW_OUT_REDUCER *r;
+
+	if (SW_OutReduce.n >= SW_OUT_MAX_REDUCERS) {
+		LogError(logfp, LOGFATAL,
+			"Too many output reducers (at most %d).", SW_OUT_MAX_REDUCERS);
+	}
+
+	r = &SW_OutReduce.r[SW_OutReduce.n++];
+	r->day = day;
+	r->year = year;
+	r->data = data;
+}
+
+
+/** @brief Unregister all reducers of the active run */
+void SW_OUT_clear_reducers(void) {
+	SW_OutReduce.n = 0;
+}
+
+
+/** @brief Call the day function of each reducer of the active run */
+void SW_OUT_reduce_day(void) {
+	unsigned int i;
+
+	for (i = 0; i < SW_OutReduce.n; i++) {
+		if (!isnull(SW_OutReduce.r[i].day)) {
+			SW_OutReduce.r[i].day(SW_OutReduce.r[i].data);
+		}
+	}
+}
+
+
+/** @brief Call the year function of each reducer of the active run */
+void SW_OUT_reduce_year(void) {
+	unsigned int i;
+
+	for (i = 0; i < SW_OutReduce.n; i++) {
+		if (!isnull(SW_OutReduce.r[i].year)) {
+			SW_OutReduce.r[i].year(SW_OutReduce.r[i].data);
+		}
+	}
+}
+
+
+/**
+@brief Reset summary statistics
+
+@param s Summary statistics.
+@param swa_binwidth Width of the bins of the distribution of available
+  soil water [cm].
+*/
+void SW_OUT_init_summary(SW_OUT_SUMMARY *s, RealD swa_binwidth) {
+	memset(s, 0, sizeof *s);
+	s->swa_min = HUGE_VAL;
+	s->swa_max = -HUGE_VAL;
+	s->swa_binwidth = swa_binwidth;
+}
+
+
+/**
+@brief Register summary statistics as a reducer with the active run
+
+@param s Summary statistics, see `SW_OUT_init_summary()`.
+*/
+void SW_OUT_add_summary(SW_OUT_SUMMARY *s) {
+	SW_OUT_add_reducer(SW_OUT_summary_day, SW_OUT_summary_year, s);
+}
+
+
+/**
+@brief Add today to summary statistics
+
+Available soil water is the soil water above wilting point summed across
+the soil profile, i.e., as `SWABULK` output.
+
+@param data Summary statistics, see `SW_OUT_SUMMARY`.
+*/
+void SW_OUT_summary_day(void *data) {
+	SW_OUT_SUMMARY *s = (SW_OUT_SUMMARY *) data;
+	RealD swa = 0.;
+	LyrIndex i;
+	unsigned int b;
+
+	s->n_days++;
+	s->aet += SW_Soilwat.aet;
+	s->aet_year += SW_Soilwat.aet;
+	s->pet += SW_Soilwat.pet;
+
+	if (SW_Site.deepdrain) {
+		s->deep += SW_Soilwat.swcBulk[Today][SW_Site.deep_lyr];
+	}
+
+	ForEachSoilLayer(i) {
+		swa += fmax(SW_Soilwat.swcBulk[Today][i] - SW_Site.swcBulk_wiltpt[i], 0.);
+	}
+
+	s->swa += swa;
+	s->swa_min = fmin(s->swa_min, swa);
+	s->swa_max = fmax(s->swa_max, swa);
+
+	b = (unsigned int) fmin(swa / s->swa_binwidth, SW_OUT_SUMMARY_NBINS - 1.);
+	s->swa_bins[b]++;
+}
+
+
+/**
+@brief Complete a year of summary statistics
+
+@param data Summary statistics, see `SW_OUT_SUMMARY`.
+*/
+void SW_OUT_summary_year(void *data) {
+	SW_OUT_SUMMARY *s = (SW_OUT_SUMMARY *) data;
+
+	s->n_years++;
+	s->aet_sq += squared(s->aet_year);
+	s->aet_year = 0.;
+}
+
+
+/**
+@brief Write summary statistics as `key,value` lines
+
+@param f Destination, e.g., `stdout`.
+@param s Summary statistics of a completed run.
+*/
+void SW_OUT_write_summary(FILE *f, const SW_OUT_SUMMARY *s) {
+	char name[64];
+	unsigned int k;
+
+	for (k = 0; k < SW_OUT_SUMMARY_NFIELDS; k++) {
+		summary_name(name, sizeof name, k, s->swa_binwidth);
+
+		if (k < 2) {
+			fprintf(f, "%s,%u\n", name, (unsigned int) summary_value(s, k));
+		} else {
+			fprintf(f, "%s,%.6f\n", name, summary_value(s, k));
+		}
+	}
+}
+
+
+/**
+@brief Write the names of the summary statistics as columns of a table
+
+Each name is preceded by a comma, i.e., the calling program writes its
+own first columns (e.g., the variant of a sweep) and the end of the line.
+
+@param f Destination, e.g., a csv file.
+@param swa_binwidth Width of the bins of the distribution of available
+  soil water [cm], see `SW_OUT_init_summary()`.
+*/
+void SW_OUT_write_summary_header(FILE *f, RealD swa_binwidth) {
+	char name[64];
+	unsigned int k;
+
+	for (k = 0; k < SW_OUT_SUMMARY_NFIELDS; k++) {
+		summary_name(name, sizeof name, k, swa_binwidth);
+		fprintf(f, ",%s", name);
+	}
+}
+
+
+/**
+@brief Write summary statistics as a row of a table,
+  see `SW_OUT_write_summary_header()`
+
+@param f Destination, e.g., a csv file.
+@param s Summary statistics of a completed run; `NULL` writes `NA` for
+  each value, e.g., for a failed run.
+*/
+void SW_OUT_write_summary_row(FILE *f, const SW_OUT_SUMMARY *s) {
+	unsigned int k;
+
+	for (k = 0; k < SW_OUT_SUMMARY_NFIELDS; k++) {
+		if (isnull(s)) {
+			fprintf(f, ",NA");
+		} else if (k < 2) {
+			fprintf(f, ",%u", (unsigned int) summary_value(s, k));
+		} else {
+			fprintf(f, ",%.6f", summary_value(s, k));
+		}
+	}
+}
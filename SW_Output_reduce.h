@@ -0,0 +1,102 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Output_reduce.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for the output reducers of
+ *           `SW_Output_reduce.c`.
+ *
+ *           A reducer is a pair of functions that a calling program
+ *           (e.g., a calibration that needs a few summary statistics per
+ *           run) registers with `SW_OUT_add_reducer()`; they are called
+ *           at the end of each simulated day and of each simulated year
+ *           and read the state of the active run. With the output format
+ *           `SW_OUTFORMAT_NONE`, reducers replace the output files and
+ *           arrays altogether.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ *     2026-10-15 added SW_OUT_write_summary_header() and SW_OUT_write_summary_row()
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_OUTPUT_REDUCE_H
+#define SW_OUTPUT_REDUCE_H
+
+#include <stdio.h>
+#include "generic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+#define SW_OUT_MAX_REDUCERS 8 /**< maximum number of reducers of a run */
+#define SW_OUT_SUMMARY_NBINS 20 /**< number of bins of the SWA distribution */
+
+/** Function of a reducer: reads the state of the active run and
+    accumulates into `data` */
+typedef void (*SW_OUT_REDUCER_FUNC)(void *data);
+
+/** A registered reducer */
+typedef struct {
+	SW_OUT_REDUCER_FUNC
+		day, /**< called at the end of each day; may be `NULL` */
+		year; /**< called at the end of each year; may be `NULL` */
+	void *data; /**< passed to `day` and `year` */
+} SW_OUT_REDUCER;
+
+/** Reducers of a simulation run */
+typedef struct {
+	Bool skip_output; /**< TRUE if output is not summed nor written, see `SW_OUTFORMAT_NONE` */
+	unsigned int n; /**< number of registered reducers */
+	SW_OUT_REDUCER r[SW_OUT_MAX_REDUCERS];
+} SW_OUT_REDUCERS;
+
+/** Summary statistics of a run for calibrations, see `SW_OUT_add_summary()` */
+typedef struct {
+	unsigned int n_years, n_days;
+	RealD
+		aet, /**< sum of daily actual evapotranspiration [cm] */
+		aet_sq, /**< sum of squared annual actual evapotranspiration [cm2] */
+		pet, /**< sum of daily potential evapotranspiration [cm] */
+		deep, /**< sum of daily deep drainage [cm] */
+		swa, /**< sum of daily available soil water of the profile [cm] */
+		swa_min, swa_max, /**< range of daily available soil water [cm] */
+		swa_binwidth; /**< width of the bins of `swa_bins` [cm] */
+	unsigned int
+		swa_bins[SW_OUT_SUMMARY_NBINS]; /**< number of days by available soil water;
+		the last bin includes all larger values */
+
+	RealD aet_year; /**< actual evapotranspiration of the current year [cm] */
+} SW_OUT_SUMMARY;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_OUT_add_reducer(SW_OUT_REDUCER_FUNC day, SW_OUT_REDUCER_FUNC year,
+	void *data);
+void SW_OUT_clear_reducers(void);
+void SW_OUT_reduce_day(void);
+void SW_OUT_reduce_year(void);
+
+void SW_OUT_init_summary(SW_OUT_SUMMARY *s, RealD swa_binwidth);
+void SW_OUT_add_summary(SW_OUT_SUMMARY *s);
+void SW_OUT_summary_day(void *data);
+void SW_OUT_summary_year(void *data);
+void SW_OUT_write_summary(FILE *f, const SW_OUT_SUMMARY *s);
+void SW_OUT_write_summary_header(FILE *f, RealD swa_binwidth);
+void SW_OUT_write_summary_row(FILE *f, const SW_OUT_SUMMARY *s);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
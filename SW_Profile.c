@@ -0,0 +1,89 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Profile.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Report the cycle counters of `SW_Profile.h`; only compiled
+ *           for the profiling binary (with `SW_PROFILE` defined).
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ *     2026-10-15 added SW_PROFILE_name()
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "SW_Profile.h"
+#include "SW_Run.h"
+
+
+/* =================================================== */
+/*                  Global Variables                   */
+/* --------------------------------------------------- */
+
+/** Names of the profiled phases, as reported by `SW_PROFILE_report()`;
+    nested phases are indented */
+static const char *SW_PROFILE_names[SW_PROFILE_NPHASES] = {
+	"_begin_day", "SW_Water_Flow",
+	"  solar_radiation_petfunc", "  interception", "  infiltration_runoff",
+	"  potential_ET_rates", "  evaporation", "  transpiration",
+	"  hydraulic_redistribution", "  percolation", "  soil_temperature",
+	"SW_OUT_sum_today", "SW_OUT_write_today"
+};
+
+
+/* =================================================== */
+/*             Global Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Print the per-phase breakdown of the cycle counters of the active
+  run to `logfp`
+
+For each phase: number of calls, million ticks, share of the ticks of all
+top-level phases, and ticks per call; the share of a nested phase is
+part of the share of `SW_Water_Flow`.
+*/
+void SW_PROFILE_report(void) {
+	const SW_PROFILE_COUNTERS *c = &SW_CurrentRun->Profile;
+	uint64_t total;
+	int p;
+
+	total = c->ticks[eProfBeginDay] + c->ticks[eProfWaterFlow] +
+		c->ticks[eProfOutSum] + c->ticks[eProfOutWrite];
+
+	LogError(logfp, LOGNOTE, "Profile of %lu simulated days (%.1f Mticks):",
+		c->calls[eProfBeginDay], (double) total / 1e6);
+	LogError(logfp, LOGNOTE, "  %-28s %10s %12s %7s %12s",
+		"phase", "calls", "Mticks", "share", "ticks/call");
+
+	for (p = 0; p < SW_PROFILE_NPHASES; p++) {
+		LogError(logfp, LOGNOTE, "  %-28s %10lu %12.2f %6.1f%% %12.0f",
+			SW_PROFILE_names[p], c->calls[p], (double) c->ticks[p] / 1e6,
+			total > 0 ? 100. * (double) c->ticks[p] / (double) total : 0.,
+			c->calls[p] > 0 ? (double) c->ticks[p] / (double) c->calls[p] : 0.);
+	}
+}
+
+
+/**
+@brief Name of a profiled phase, without the indentation of nested phases
+
+@param p A phase, see `SW_ProfilePhase`.
+*/
+const char *SW_PROFILE_name(int p) {
+	const char *name = SW_PROFILE_names[p];
+
+	while (' ' == *name) {
+		name++;
+	}
+
+	return name;
+}
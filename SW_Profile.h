@@ -0,0 +1,116 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Profile.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Cycle counters of the phases of a simulated day
+ *           (see `make bin_profile`).
+ *
+ *           Counters are compiled in only if `SW_PROFILE` is defined;
+ *           otherwise, `SW_PROFILE_START()`, `SW_PROFILE_STOP()`, and
+ *           `SW_PROFILE_REPORT()` expand to nothing. Ticks of the cycle
+ *           counter and number of calls are accumulated per simulation
+ *           run context (`SW_RUN.Profile`) and reported to `logfp` at the
+ *           end of the run.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ *     2026-10-15 added SW_PROFILE_name() for the metrics of batch mode
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_PROFILE_H
+#define SW_PROFILE_H
+
+#ifdef SW_PROFILE
+#include <stdint.h>
+#if !defined(__x86_64__) && !defined(__i386__) && !defined(__aarch64__)
+#include <time.h>
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+#ifdef SW_PROFILE
+
+/** Profiled phases of a simulated day; phases from `eProfRadPET` to
+    `eProfSoilTemp` are nested in `eProfWaterFlow` */
+typedef enum {
+	eProfBeginDay, /**< `_begin_day()`: weather, vegetation, soil water of the day */
+	eProfWaterFlow, /**< `SW_Water_Flow()`, includes the nested phases */
+	eProfRadPET, /**< `solar_radiation()` and `petfunc()` */
+	eProfInterception, /**< canopy and litter interception */
+	eProfInfiltration, /**< surface water, runon, saturated percolation, runoff */
+	eProfETRates, /**< potential evaporation and transpiration rates */
+	eProfEvaporation, /**< evaporation of surface water and of bare soil */
+	eProfTranspiration, /**< transpiration and evaporation under vegetation */
+	eProfHydRed, /**< hydraulic redistribution */
+	eProfPercolation, /**< unsaturated percolation */
+	eProfSoilTemp, /**< `soil_temperature()` */
+	eProfOutSum, /**< `SW_OUT_sum_today()` of all object types */
+	eProfOutWrite, /**< `SW_OUT_write_today()`: formatting and writing */
+	SW_PROFILE_NPHASES
+} SW_ProfilePhase;
+
+/** Accumulated cycle counters of a simulation run */
+typedef struct {
+	uint64_t ticks[SW_PROFILE_NPHASES]; /**< elapsed ticks of the cycle counter */
+	unsigned long calls[SW_PROFILE_NPHASES]; /**< number of profiled calls */
+} SW_PROFILE_COUNTERS;
+
+void SW_PROFILE_report(void);
+const char *SW_PROFILE_name(int p);
+
+/** Read the cycle counter: time-stamp counter on x86, virtual counter on
+    ARMv8, and nanoseconds elsewhere */
+static inline uint64_t SW_PROFILE_ticks(void) {
+	#if defined(__x86_64__) || defined(__i386__)
+	// builtin instead of `__rdtsc()` of <x86intrin.h> which clashes with the
+	// `abs()` macro of generic.h
+	return (uint64_t) __builtin_ia32_rdtsc();
+
+	#elif defined(__aarch64__)
+	uint64_t t;
+	__asm__ __volatile__ ("mrs %0, cntvct_el0" : "=r" (t));
+	return t;
+
+	#else
+	struct timespec t;
+	timespec_get(&t, TIME_UTC);
+	return (uint64_t) t.tv_sec * 1000000000u + (uint64_t) t.tv_nsec;
+	#endif
+}
+
+/** Start counting phase `p` of the active run (within a block of code) */
+#define SW_PROFILE_START(p) \
+	uint64_t sw_profile_start_##p = SW_PROFILE_ticks()
+
+/** Stop counting phase `p` (started in the same block) and add the ticks */
+#define SW_PROFILE_STOP(p) \
+	do { \
+		SW_CurrentRun->Profile.ticks[(p)] += \
+			SW_PROFILE_ticks() - sw_profile_start_##p; \
+		SW_CurrentRun->Profile.calls[(p)]++; \
+	} while (0)
+
+/** Print the per-phase breakdown of the active run to `logfp` */
+#define SW_PROFILE_REPORT() SW_PROFILE_report()
+
+#else
+
+#define SW_PROFILE_START(p)
+#define SW_PROFILE_STOP(p)
+#define SW_PROFILE_REPORT()
+
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,430 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Run.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Define the simulation run context `SW_RUN` which holds
+ *           the complete state of one SOILWAT2 simulation, i.e.,
+ *           all module structures and the module-level variables
+ *           that previously were process-wide globals.
+ *
+ *           Several independent simulation runs can co-exist in one
+ *           address space (e.g., one per thread). The run that is used
+ *           by the model code is `SW_CurrentRun`, a thread-local pointer
+ *           that is set by the `SW_CTL_*` functions of `SW_Control.c`.
+ *
+ *           The macros below map the traditional global names
+ *           (e.g., `SW_Site`, `SW_Model`) onto the currently active run so
+ *           that the module code is unchanged by the move to a context.
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ *     2026-10-15 removed the previous week, month, and year of SW_Model.c;
+ *       new periods are derived from the calendar (Times.c)
+ *     2026-10-15 added SW_PET_YEAR, radiation and PET of all days of a year
+ *     2026-10-15 added SW_VEGTYPE_LANES, vegetation types in lanes of SW_Flow_lanes.c
+ *     2026-10-15 added the input tables that are shared by the runs of a batch
+ *     2026-10-15 added the output reducers of a run (SW_Output_reduce.c)
+ *     2026-10-15 added the gridded weather of a run (SW_Weather_grid.c)
+ *     2026-10-15 added the output years of a run (SW_OUT_set_years())
+ *     2026-10-15 added output arrays that are owned by the calling program
+ *     2026-10-15 added the water balance monitor of a run (SW_WB_MONITOR)
+ *     2026-10-15 added SW_FLOW_DAY, today's water flow between the parts of
+ *       `SW_Water_Flow()` of runs that are simulated in lanes
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_RUN_H
+#define SW_RUN_H
+
+#include "generic.h"
+#include "myMemory.h"
+#include "rands.h"
+#include "Times.h"
+#include "SW_Defines.h"
+#include "SW_Times.h"
+#include "SW_Files.h"
+#include "SW_Model.h"
+#include "SW_Site.h"
+#include "SW_SoilWater.h"
+#include "SW_Weather.h"
+#include "SW_Weather_store.h"
+#include "SW_Weather_grid.h"
+#include "SW_SoilWater_store.h"
+#include "SW_Shared.h"
+#include "SW_Markov.h"
+#include "SW_Sky.h"
+#include "SW_VegProd.h"
+#include "SW_VegEstab.h"
+#include "SW_Carbon.h"
+#include "SW_Flow_lib.h"
+#include "SW_Flow_lanes.h"
+#include "SW_Output.h"
+#include "SW_Output_reduce.h"
+#include "SW_Bench.h"
+#include "SW_Profile.h"
+#ifdef SW_OUTARRAY
+#include "SW_Output_outarray.h"
+#endif
+#ifdef SW_OUTTEXT
+#include "SW_Output_outtext.h"
+#endif
+#ifdef SOILWAT
+#include "SW_Output_outbin.h"
+#include "SW_Output_digest.h"
+#include "SW_Output_outwriter.h"
+#include "SW_Checkpoint.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*           Module-level state of a simulation run    */
+/* --------------------------------------------------- */
+
+/** State of `SW_Files.c`: names of input files and path prefixes */
+typedef struct {
+	char *InFiles[SW_NFILES];
+	char
+		ProjDir[FILENAME_MAX],
+		weather_prefix[FILENAME_MAX],
+		output_prefix[FILENAME_MAX];
+
+	/** If TRUE, then the weather and output prefixes and the names of
+	    output files are, like the input files, relative to `ProjDir`
+	    (e.g., for batch runs of many sites), otherwise relative to
+	    the working directory */
+	Bool relative_to_ProjDir;
+} SW_FILES;
+
+/** Parameters of the vegetation types of the site, one type per lane of
+    the lane kernels of `SW_Flow_lanes.c`; set up for each year by
+    `SW_FLW_new_year()` */
+typedef struct {
+	int vegtype[SW_LANES]; /**< vegetation type of each lane; surplus lanes repeat the first type */
+	unsigned int
+		n_evap_lyrs, /**< number of evaporation layers up to the first layer without evaporation */
+		nlyrs, /**< number of layers with evaporation or transpiration of any type */
+		tr_regions[MAX_LAYERS][SW_LANES]; /**< transpiration region of each layer; 0 below the transpiration layers of a type */
+	double
+		evap_coeff[MAX_LAYERS][SW_LANES],
+		transp_coeff[MAX_LAYERS][SW_LANES],
+		width[MAX_LAYERS][SW_LANES],
+		lai_param[SW_LANES], /**< see `EsTpartitioning_param` */
+		Es_param_limit[SW_LANES],
+		shade_scale[SW_LANES],
+		shade_deadmax[SW_LANES],
+		co2_wue[SW_LANES]; /**< CO2 effect on water-use efficiency of the year */
+	SW_TANFUNC_LANES evap, transp, shade;
+} SW_VEGTYPE_LANES;
+
+/** Today's values of `SW_Water_Flow()` that are carried from one part of
+    the water flow to the next (see `SW_FLW_water_flow_part()`) */
+typedef struct {
+	Bool flowing; /**< `swTRUE` between the first and the last part of today */
+	RealD h2o_for_soil, /**< rain and snowmelt that reach the soil surface */
+		swc_start, /**< soil water of the profile before today's fluxes */
+		aet_surface, /**< AET before soil evaporation and transpiration */
+		scale_veg[NVEGTYPES]; /**< cover of each vegetation type above the snowpack */
+} SW_FLOW_DAY;
+
+/** State of `SW_Flow.c`: arrays of the `SW_Flow_lib.c` subroutines that
+  have no counterpart in `SW_Site` or `SW_Soilwat` (the subroutines operate
+  in place on those otherwise) and surface water pools that are carried
+  from one day to the next */
+typedef struct {
+	RealD lyrEvap[NVEGTYPES][MAX_LAYERS], /**< soil evaporation by vegetation type */
+		lyrEvap_BareGround[MAX_LAYERS], /**< soil evaporation of bare ground */
+		lyrSWCBulk_HalfWiltpts[MAX_LAYERS]; /**< soil evaporation extracts water down to half of wilting point */
+
+	RealD drainout; /**< h2o drained out of deepest layer */
+
+	// variables to help calculate runon from a (hypothetical) upslope neighboring (UpNeigh) site
+	RealD UpNeigh_lyrSWCBulk[MAX_LAYERS], UpNeigh_lyrDrain[MAX_LAYERS],
+		UpNeigh_drainout, UpNeigh_standingWater;
+
+	RealD surfaceTemp[TWO_DAYS],
+		veg_int_storage[NVEGTYPES], /**< storage of intercepted rain by the vegetation */
+		litter_int_storage, /**< storage of intercepted rain by the litter layer */
+		standingWater[TWO_DAYS]; /**< water on soil surface if layer below is saturated */
+
+	SW_FLOW_DIAG diag; /**< counters of solver and clamp events of the run */
+	SW_WB_MONITOR wbmon; /**< residuals of the daily water balance of the run */
+
+	SW_VEGTYPE_LANES veglanes; /**< vegetation types in lanes */
+	SW_FLOW_DAY day; /**< today's water flow between its parts */
+} SW_FLOW;
+
+/** State of the soil temperature functions of `SW_Flow_lib.c` */
+typedef struct {
+	ST_RGR_VALUES stValues; /**< keeps track of soil_temperature values */
+	unsigned int
+		soil_temp_init, /**< 1 if `soil_temperature` has been initialized, 0 otherwise */
+		fusion_pool_init; /**< 1 if the fusion pools of `soil_temperature` have been initialized, 0 otherwise */
+	Bool do_once_at_soiltempError;
+	double delta_time; /**< last successful time step in seconds */
+} SW_ST_STATE;
+
+/** Memoized site constants of `solar_radiation()` and `petfunc()` that
+    do not depend on day of year or daily weather */
+typedef struct {
+	Bool has_elev, has_slope; /**< TRUE if values for `elev` and `slope` are memoized */
+	double
+		elev, /**< elevation of the memoized values [m] */
+		slope, /**< slope of the memoized values [radians] */
+		P, /**< atmospheric pressure at `elev` [kPa] */
+		gamma, /**< psychrometric constant at `elev` [kPa / K] */
+		f_i, /**< isotropic view factor of diffuse irradiation on `slope` [-] */
+		sin3_halfslope; /**< `sin(slope / 2)^3` of the HDKR transposition model [-] */
+} SW_PET_SITE;
+
+/** Radiation and PET of all days of the current year, calculated at
+    the start of the year by `SW_FLW_new_year()`; arrays are indexed by
+    day of year (base1) */
+typedef struct {
+	Bool use; /**< TRUE if the values are calculated for the current year */
+	double
+		albedo, /**< surface albedo of the calculated values [-] */
+		H_oh[MAX_DAYS + 1], /**< extraterrestrial horizontal irradiation [MJ / m2] */
+		H_ot[MAX_DAYS + 1], /**< extraterrestrial tilted irradiation [MJ / m2] */
+		H_gh[MAX_DAYS + 1], /**< global horizontal irradiation [MJ / m2] */
+		H_gt[MAX_DAYS + 1], /**< global tilted irradiation [MJ / m2] */
+		pet[MAX_DAYS + 1]; /**< potential evapotranspiration [cm / day], not scaled */
+} SW_PET_YEAR;
+
+/** Memoized values of `SW_Flow_lib_PET.c` for the site of a run */
+typedef struct {
+	double
+		memoized_G_o[366][2],
+		msun_angles[366][7],
+		memoized_int_cos_theta[366][2],
+		memoized_int_sin_beta[366][2];
+	SW_PET_SITE site;
+	SW_PET_YEAR year;
+} SW_PET_STATE;
+
+/** State of `SW_Output.c`, `SW_Output_outarray.c`, `SW_Output_outtext.c`,
+  and `SW_Output_outbin.c` that describes the requested output of one
+  simulation run */
+typedef struct {
+	SW_OUTPUT Output[SW_OUTNKEYS];
+
+	char sep; /**< output delimiter */
+	TimeInt tOffset; /**< 1 or 0 means we're writing previous or current period */
+
+	/** output time periods that are required for `text` and/or `array`-based
+	    output for each output key */
+	OutPeriod timeSteps[SW_OUTNKEYS][SW_OUTNPERIODS];
+	/** number of different time steps/periods that are used/requested */
+	IntUS used_OUTNPERIODS;
+	/** TRUE if time step/period is active for any output key */
+	Bool use_OutPeriod[SW_OUTNPERIODS];
+	/** TRUE if a derived quantity is required by any output key */
+	Bool use_Derived[SW_NDERIVED];
+	/** output keys that are active for each time step/period, see `set_activeKeys()` */
+	SW_OUT_ACTIVEKEY activeKeys[SW_OUTNPERIODS][SW_OUTNKEYS];
+	/** number of active output keys for each time step/period */
+	IntUS n_activeKeys[SW_OUTNPERIODS];
+
+	/** names of output columns for each output key; number is an expensive guess */
+	char *colnames_OUT[SW_OUTNKEYS][5 * NVEGTYPES + MAX_LAYERS];
+	/** number of output columns for each output key */
+	IntUS ncol_OUT[SW_OUTNKEYS];
+
+	int useTimeStep; /**< flag to determine whether or not the line TIMESTEP exists */
+	Bool bFlush_output; /**< process partial period? */
+	TimeInt first_year, last_year; /**< calendar years of output, see `SW_OUT_set_years()`; 0 for the first/last simulation year */
+	Bool skip_year; /**< TRUE if the current year is outside of the output years */
+
+	#ifdef SW_OUTARRAY
+	/** output arrays, see `SW_Output_outarray.c` */
+	RealOut *p_OUT[SW_OUTNKEYS][SW_OUTNPERIODS];
+	#ifdef STEPWAT
+	/** running sums of squares of `p_OUT` across iterations, see `do_running_agg()` */
+	RealOut *p_OUTsd[SW_OUTNKEYS][SW_OUTNPERIODS];
+	#endif
+	size_t nrow_OUT[SW_OUTNPERIODS]; /**< number of years/months/weeks/days */
+	size_t irow_OUT[SW_OUTNPERIODS]; /**< row index of current output; incremented at end of each day */
+	#ifdef SOILWAT
+	Bool collect_OUT; /**< TRUE if `p_OUT` holds all rows of the run, see `SW_OUT_construct_outarray()` */
+	SW_OUTARRAY_CONSUMER consumer_OUT; /**< receives completed chunks of `p_OUT`, see `SW_OUT_set_outarray_consumer()` */
+	void *consumer_data_OUT; /**< passed to `consumer_OUT` */
+	SW_OUTARRAY_ALLOCATOR allocator_OUT; /**< provides `p_OUT` of the full run, see `SW_OUT_set_outarray_allocator()` */
+	void *allocator_data_OUT; /**< passed to `allocator_OUT` */
+	Bool host_OUT[SW_OUTNKEYS][SW_OUTNPERIODS]; /**< TRUE if `p_OUT` is owned by the calling program */
+	#endif
+	#endif
+
+	#ifdef SW_OUTTEXT
+	SW_FILE_STATUS OutFiles; /**< text output files and buffers */
+	#endif
+
+	#ifdef SOILWAT
+	SW_OUTBIN_FILES OutBin; /**< binary output files */
+	SW_OUTWRITER OutWriter; /**< asynchronous writer of `csv` files */
+	SW_OUT_DIGEST OutDigest; /**< digest of the output, see `SW_Output_digest.c` */
+	#endif
+
+	SW_OUT_REDUCERS OutReduce; /**< reducers of the daily state, see `SW_Output_reduce.c` */
+} SW_OUT_STATE;
+
+
+/* =================================================== */
+/*                 Simulation run context              */
+/* --------------------------------------------------- */
+
+/** The complete state of one SOILWAT2 simulation run.
+
+  A `SW_RUN` must start out zero-initialized, e.g., with static storage
+  duration or allocated with `Mem_Calloc()`. It is prepared and used by
+  `SW_CTL_setup_model()`, `SW_CTL_read_inputs_from_disk()`,
+  `SW_CTL_init_run()`, `SW_CTL_run_current_year()`/`SW_CTL_main()`, and
+  released by `SW_CTL_clear_model()`.
+
+  If `Arena.use` is set before `SW_CTL_setup_model()`, then the memory
+  that the model allocates for the run comes from the arena of the run and
+  a full reset by `SW_CTL_clear_model()` frees it at once. The `SW_RUN`
+  itself and memory that outlives the run must not be allocated while the
+  run is active.
+
+  If `Shared` is set before `SW_CTL_setup_model()`, then the run uses
+  (and adds) input tables that are shared with other runs instead of
+  holding its own copy; the shared inputs must outlive the run.
+*/
+typedef struct {
+	SW_MODEL Model;
+	SW_SITE Site;
+	SW_SOILWAT Soilwat;
+	SW_WEATHER Weather;
+	SW_MARKOV Markov;
+	SW_SKY Sky;
+	SW_VEGPROD VegProd;
+	SW_VEGESTAB VegEstab;
+	SW_CARBON Carbon;
+
+	SW_FILES Files;
+	SW_FLOW Flow;
+	SW_ST_STATE SoilTemp;
+	SW_PET_STATE PET;
+	SW_OUT_STATE Out;
+	SW_WTH_STORE WeatherStore; /**< binary weather store, see `SW_Weather_store.c` */
+	SW_WTH_GRID WeatherGrid; /**< gridded weather inputs, see `SW_Weather_grid.c` */
+	SW_SWC_STORE SoilWaterStore; /**< binary store of measured soil moisture, see `SW_SoilWater_store.c` */
+	MEM_ARENA Arena; /**< per-run allocations, see `Mem_ArenaActivate()` */
+	SW_SHARED_INPUTS *Shared; /**< input tables shared with other runs of a batch, see `SW_Shared.c`; NULL if not shared */
+	#ifdef SOILWAT
+	SW_CHECKPOINT Checkpoint; /**< checkpoints of the run, see `SW_CKP_run()` */
+	#endif
+	#ifdef SW_BENCH
+	SW_BENCH_TIMERS Bench; /**< module timers of the benchmark, see `SW_Bench.h` */
+	#endif
+	#ifdef SW_PROFILE
+	SW_PROFILE_COUNTERS Profile; /**< cycle counters of the phases of a day, see `SW_Profile.h` */
+	#endif
+
+	/* SW_Markov.c: random number generator of the weather generator */
+	pcg32_random_t markov_rng;
+
+	/* SW_Weather.c: historical daily inputs available for current year? */
+	Bool weth_found;
+
+	/* SW_Site.c: transpiration regions (units are layer numbers) and
+	   swc values (units are cm/cm if < 1, -bars if >= 1) */
+	LyrIndex TranspRgnBounds[MAX_TRANSP_REGIONS];
+	RealD SWCInitVal, SWCWetVal, SWCMinVal;
+
+	/* SW_SoilWater.c: snow temperature */
+	RealD temp_snow;
+} SW_RUN;
+
+
+/** Image of a simulation run, see `SW_CTL_save_run()` */
+typedef struct {
+	SW_RUN *sw; /**< run that the image was taken from */
+	SW_RUN *run; /**< copy of the run context */
+	MEM_ARENA_IMAGE arena; /**< copy of the memory of the run */
+} SW_RUN_SNAPSHOT;
+
+
+/** The simulation run that the model code currently operates on;
+    one per thread, set by `SW_CTL_activate_run()` */
+extern SW_THREAD_LOCAL SW_RUN *SW_CurrentRun;
+
+
+/* =================================================== */
+/*      Traditional names for the current run state    */
+/* --------------------------------------------------- */
+#define SW_Model (SW_CurrentRun->Model)
+#define SW_Site (SW_CurrentRun->Site)
+#define SW_Soilwat (SW_CurrentRun->Soilwat)
+#define SW_Weather (SW_CurrentRun->Weather)
+#define SW_Markov (SW_CurrentRun->Markov)
+#define SW_Sky (SW_CurrentRun->Sky)
+#define SW_VegProd (SW_CurrentRun->VegProd)
+#define SW_VegEstab (SW_CurrentRun->VegEstab)
+#define SW_Carbon (SW_CurrentRun->Carbon)
+
+#define InFiles (SW_CurrentRun->Files.InFiles)
+#define _ProjDir (SW_CurrentRun->Files.ProjDir)
+#define weather_prefix (SW_CurrentRun->Files.weather_prefix)
+#define output_prefix (SW_CurrentRun->Files.output_prefix)
+
+#define stValues (SW_CurrentRun->SoilTemp.stValues)
+#define soil_temp_init (SW_CurrentRun->SoilTemp.soil_temp_init)
+#define fusion_pool_init (SW_CurrentRun->SoilTemp.fusion_pool_init)
+
+#define markov_rng (SW_CurrentRun->markov_rng)
+#define weth_found (SW_CurrentRun->weth_found)
+#define _TranspRgnBounds (SW_CurrentRun->TranspRgnBounds)
+
+#define SW_Output (SW_CurrentRun->Out.Output)
+#define _Sep (SW_CurrentRun->Out.sep)
+#define tOffset (SW_CurrentRun->Out.tOffset)
+#define timeSteps (SW_CurrentRun->Out.timeSteps)
+#define used_OUTNPERIODS (SW_CurrentRun->Out.used_OUTNPERIODS)
+#define use_OutPeriod (SW_CurrentRun->Out.use_OutPeriod)
+#define use_Derived (SW_CurrentRun->Out.use_Derived)
+#define activeKeys (SW_CurrentRun->Out.activeKeys)
+#define n_activeKeys (SW_CurrentRun->Out.n_activeKeys)
+#define colnames_OUT (SW_CurrentRun->Out.colnames_OUT)
+#define ncol_OUT (SW_CurrentRun->Out.ncol_OUT)
+#define SW_OutReduce (SW_CurrentRun->Out.OutReduce)
+
+#ifdef SW_OUTARRAY
+#define p_OUT (SW_CurrentRun->Out.p_OUT)
+#ifdef STEPWAT
+#define p_OUTsd (SW_CurrentRun->Out.p_OUTsd)
+#endif
+#define nrow_OUT (SW_CurrentRun->Out.nrow_OUT)
+#define irow_OUT (SW_CurrentRun->Out.irow_OUT)
+#ifdef SOILWAT
+#define collect_OUT (SW_CurrentRun->Out.collect_OUT)
+#define consumer_OUT (SW_CurrentRun->Out.consumer_OUT)
+#define consumer_data_OUT (SW_CurrentRun->Out.consumer_data_OUT)
+#define allocator_OUT (SW_CurrentRun->Out.allocator_OUT)
+#define allocator_data_OUT (SW_CurrentRun->Out.allocator_data_OUT)
+#define host_OUT (SW_CurrentRun->Out.host_OUT)
+#endif
+#endif
+
+#ifdef SW_OUTTEXT
+#define SW_OutFiles (SW_CurrentRun->Out.OutFiles)
+#endif
+
+#ifdef SOILWAT
+#define SW_OutBin (SW_CurrentRun->Out.OutBin)
+#define SW_OutWriter (SW_CurrentRun->Out.OutWriter)
+#define SW_OutDigest (SW_CurrentRun->Out.OutDigest)
+#define SW_Checkpoint (SW_CurrentRun->Checkpoint)
+#endif
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,175 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Shared.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Share immutable input tables among the simulation runs of
+ *           a batch.
+ *
+ *           Many sites of a batch use identical input files, e.g., the
+ *           CO2 concentrations of `carbon.in` or the weather generator
+ *           parameters of a climate zone. The first run that reads such
+ *           a file parses it into a table and adds the table to the
+ *           shared inputs of the batch; later runs find the table by
+ *           the hash of the file contents (and further inputs that the
+ *           table depends on) and point to it instead of holding their
+ *           own copy.
+ *
+ *           Tables are not taken from the arena of a run because they
+ *           outlive the run; they are freed with the batch.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "SW_Shared.h"
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** 64-bit FNV-1a hash of a string */
+static unsigned long long contents_hash(const char *s, size_t *size) {
+	unsigned long long h = 0xCBF29CE484222325ULL;
+	const unsigned char *p = (const unsigned char *) s;
+
+	for (; *p != '\0'; p++) {
+		h = (h ^ *p) * 0x100000001B3ULL;
+	}
+
+	*size = (size_t) (p - (const unsigned char *) s);
+
+	return h;
+}
+
+/** Find a table from `head` to the end of the list */
+static SW_SHARED_TABLE *find_table(SW_SHARED_TABLE *head, const SW_SHARED_ID *id) {
+	SW_SHARED_TABLE *t;
+
+	for (t = head; !isnull(t); t = t->next) {
+		if (t->id.file == id->file && t->id.hash == id->hash &&
+			t->id.size == id->size && 0 == strcmp(t->id.key, id->key)) {
+			break;
+		}
+	}
+
+	return t;
+}
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Identify a table by the contents of its input file
+
+@param id The identity of the table.
+@param file The input file of the table.
+@param key Further inputs that the table depends on (`""` if none);
+  truncated to `SW_SHARED_KEYLEN - 1` characters.
+@param contents The contents of the input file (before the contents are
+  split into lines by `GetATextLine()`).
+*/
+void SW_SHR_id(SW_SHARED_ID *id, SW_FileIndex file, const char *key,
+	const char *contents) {
+
+	memset(id, 0, sizeof *id);
+	id->file = file;
+	id->hash = contents_hash(contents, &id->size);
+	strncpy(id->key, key, SW_SHARED_KEYLEN - 1);
+}
+
+
+/**
+@brief Look up a shared table
+
+@param s The shared inputs.
+@param id The identity of the table, see `SW_SHR_id()`.
+
+@return The table or `NULL` if no run has added it yet.
+*/
+const void *SW_SHR_get(SW_SHARED_INPUTS *s, const SW_SHARED_ID *id) {
+	SW_SHARED_TABLE *t = find_table(__atomic_load_n(&s->head, __ATOMIC_ACQUIRE), id);
+
+	if (isnull(t)) {
+		return NULL;
+	}
+
+	__atomic_fetch_add(&s->n_hits, 1u, __ATOMIC_RELAXED);
+	return t->data;
+}
+
+
+/**
+@brief Add a table to the shared inputs
+
+If another run added the same table in the meantime, then `data` is freed
+and the table of the other run is returned.
+
+@param s The shared inputs.
+@param id The identity of the table, see `SW_SHR_id()`.
+@param data The table, allocated with `malloc()`; owned by `s` afterwards
+  and must not be changed.
+
+@return The shared table.
+*/
+const void *SW_SHR_put(SW_SHARED_INPUTS *s, const SW_SHARED_ID *id, void *data) {
+	SW_SHARED_TABLE *t, *other, *head;
+
+	if (isnull(t = (SW_SHARED_TABLE *) malloc(sizeof *t))) {
+		free(data);
+		LogError(logfp, LOGFATAL, "SW_SHR_put(): out of memory");
+	}
+
+	t->id = *id;
+	t->data = data;
+
+	head = __atomic_load_n(&s->head, __ATOMIC_ACQUIRE);
+
+	do {
+		if (!isnull(other = find_table(head, id))) {
+			free(data);
+			free(t);
+			return other->data;
+		}
+
+		t->next = head;
+	} while (!__atomic_compare_exchange_n(&s->head, &head, t, swFALSE,
+		__ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+
+	__atomic_fetch_add(&s->n_tables, 1u, __ATOMIC_RELAXED);
+
+	return data;
+}
+
+
+/**
+@brief Free all shared tables; no run may use them afterwards
+
+@param s The shared inputs.
+*/
+void SW_SHR_deconstruct(SW_SHARED_INPUTS *s) {
+	SW_SHARED_TABLE *t, *next;
+
+	for (t = s->head; !isnull(t); t = next) {
+		next = t->next;
+		free(t->data);
+		free(t);
+	}
+
+	memset(s, 0, sizeof *s);
+}
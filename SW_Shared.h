@@ -0,0 +1,74 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Shared.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for immutable input tables
+ *           that are shared by the simulation runs of a batch,
+ *           see `SW_Shared.c`.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_SHARED_H
+#define SW_SHARED_H
+
+#include "generic.h"
+#include "SW_Files.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+#define SW_SHARED_KEYLEN 64 /**< size of the key of a shared table */
+
+/** Identity of a shared table: the contents of an input file and
+    further inputs that the table depends on */
+typedef struct {
+	SW_FileIndex file; /**< input file of the table */
+	unsigned long long hash; /**< hash of the contents of the input file */
+	size_t size; /**< size of the contents of the input file */
+	char key[SW_SHARED_KEYLEN]; /**< further inputs, e.g., the CO2 scenario */
+} SW_SHARED_ID;
+
+/** An immutable table that was parsed from an input file */
+typedef struct sw_shared_table {
+	struct sw_shared_table *next;
+	SW_SHARED_ID id;
+	void *data; /**< the table, allocated with `malloc()` */
+} SW_SHARED_TABLE;
+
+/** Tables that are shared by the simulation runs of a batch; tables are
+    added at the front of the list and never change or move afterwards,
+    so that lookups are lock-free */
+typedef struct {
+	SW_SHARED_TABLE *head;
+	unsigned int
+		n_tables, /**< number of tables */
+		n_hits; /**< number of runs that used a table instead of parsing their input file */
+} SW_SHARED_INPUTS;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_SHR_id(SW_SHARED_ID *id, SW_FileIndex file, const char *key,
+	const char *contents);
+const void *SW_SHR_get(SW_SHARED_INPUTS *s, const SW_SHARED_ID *id);
+const void *SW_SHR_put(SW_SHARED_INPUTS *s, const SW_SHARED_ID *id, void *data);
+void SW_SHR_deconstruct(SW_SHARED_INPUTS *s);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
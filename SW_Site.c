@@ -45,6 +45,12 @@
  06/05/2016 (ctd) Modified threshold for condition involving gravel in _read_layers() function - as per Caitlin's request.
  									Also, added print statements to notify the user that values may be invalid if the gravel content does not follow
 									parameters of Corey-Brooks equation.
+ 2026-10-14	soil layer properties are stored as one array per property in SW_Site;
+						added SW_SIT_get_layer() and SW_SIT_set_layer() to copy one layer
+ 2026-10-14	the soil temperature flag of siteparam.in selects the solver (stMethod)
+ 2026-10-15	SW_SIT_read() and _read_layers() read with SW_TEXTFILE and Str_Scan()
+ 2026-10-15	SW_SIT_init_run() looks up pedotransfer parameters of a soil texture in a
+						process-wide cache that is shared by the runs of a batch
  */
 /********************************************************/
 /********************************************************/
@@ -69,15 +75,13 @@
 #include "SW_SoilWater.h"
 
 #include "SW_VegProd.h"
+#include "SW_Run.h"
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
 
-extern SW_VEGPROD SW_VegProd;
-extern SW_CARBON SW_Carbon;
 
-SW_SITE SW_Site; /* declared here, externed elsewhere */
 
 extern Bool EchoInits;
 extern char const *key2veg[];
@@ -85,17 +89,55 @@ extern char const *key2veg[];
 
 /* transpiration regions  shallow, moderately shallow,  */
 /* deep and very deep. units are in layer numbers. */
-LyrIndex _TranspRgnBounds[MAX_TRANSP_REGIONS];
+/* `_TranspRgnBounds` is part of the simulation run context, see SW_Run.h */
 
 /* for these three, units are cm/cm if < 1, -bars if >= 1 */
-RealD _SWCInitVal, /* initialization value for swc */
-_SWCWetVal, /* value for a "wet" day,       */
-_SWCMinVal; /* lower bound on swc.          */
+#define _SWCInitVal (SW_CurrentRun->SWCInitVal) /* initialization value for swc */
+#define _SWCWetVal (SW_CurrentRun->SWCWetVal) /* value for a "wet" day,       */
+#define _SWCMinVal (SW_CurrentRun->SWCMinVal) /* lower bound on swc.          */
 
 /* =================================================== */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
-static char *MyFileName;
+static SW_THREAD_LOCAL char *MyFileName;
+
+/** Pedotransfer parameters of the matric component of a soil texture,
+    see `water_eqn()` */
+typedef struct {
+	RealD thetasMatric, psisMatric, bMatric, binverseMatric,
+		thetaSaturated; /**< saturated VWC of Saxton & Rawls (2006) [cm/cm] */
+} SW_PEDOTRANSFER;
+
+/** Derived soil hydraulic parameters of a soil texture, i.e., of
+    sand, clay, and gravel content */
+typedef struct {
+	SW_PEDOTRANSFER pt;
+	RealD
+		vwc_fieldcap, /**< bulk VWC at -0.333 bar [cm/cm] */
+		vwc_wiltpt, /**< bulk VWC at -15 bar [cm/cm] */
+		vwc_min30; /**< bulk VWC at -30 bar [cm/cm] */
+} SW_TEXTURE_PARAMS;
+
+/** Slot of the texture cache; `state` is `TEXTURE_FREE`, `TEXTURE_BUSY`
+    while a thread fills the slot, or `TEXTURE_READY` */
+typedef struct {
+	int state;
+	RealD key[3]; /**< sand, clay, and gravel content */
+	SW_TEXTURE_PARAMS val;
+} SW_TEXTURE_SLOT;
+
+#define TEXTURE_FREE 0
+#define TEXTURE_BUSY 1
+#define TEXTURE_READY 2
+
+#define TEXTURE_CACHE_SIZE 32768 /**< number of slots, a power of 2 */
+#define TEXTURE_CACHE_PROBES 32 /**< maximal number of slots searched */
+
+/** Process-wide cache of soil textures, shared by all runs and threads:
+    slots are filled once and never change afterwards, so that lookups
+    are lock-free; if all slots near the hash of a texture are taken,
+    the texture is not cached */
+static SW_TEXTURE_SLOT texture_cache[TEXTURE_CACHE_SIZE];
 
 /* =================================================== */
 /* =================================================== */
@@ -104,43 +146,9 @@ static char *MyFileName;
 
 static void _read_layers(void);
 
-
-
-/**
-	\brief Calculate soil moisture characteristics for each layer.
-
-  Bulk refers to the whole soil, i.e., including the rock/gravel component,
-  whereas matric refers to the < 2 mm fraction.
-
-  Saturated moisture content of the matric component (thetasMatric), saturation matric
-	potential (psisMatric), and the slope of the retention curve (bMatric) for each
-	layer are calculated using equations found in Cosby et al. (1984). \cite Cosby1984
-	The saturated moisture content of the whole soil (bulk) for each layer (swcBulk_saturated)
-	is calculated using equations found in Saxton and Rawls (2006; Equations 2, 3 & 5).
-	\cite Saxton2006
-
-	Return from the function is void. Calculated values stored in SW_Site object.
-
-	SOILWAT2 calculates internally based on soil bulk density of the whole soil,
-	i.e., including rock/gravel component. However, inputs are expected to
-	represent soil (matric) density of the < 2 mm fraction.
-
-	sand + clay + silt must equal one. Fraction silt is calculated: 1 - (sand + clay).
-
-	\param fractionGravel The fraction of gravel in a layer by volume.
-	\param sand The fraction of sand in a layer by weight.
-	\param clay The fraction of clay in a layer by weight.
-	\param n Soil layer index.
-
-	\sideeffect
-		- thetasMatric Saturated water content for the matric component (m^3/m^3).
-		- psisMatric Saturation matric potential (MPa).
-		- bMatric Slope of the linear log-log retention curve (unitless).
-		- swcBulk_saturated The saturated water content for the whole soil (bulk) (cm/layer).
-
-*/
-
-void water_eqn(RealD fractionGravel, RealD sand, RealD clay, LyrIndex n) {
+/** Calculate the pedotransfer parameters of a soil texture
+    (see `water_eqn()` for the equations) */
+static void pedotransfer(RealD sand, RealD clay, SW_PEDOTRANSFER *pt) {
 
 	/* Cosby, B. J., G. M. Hornberger, R. B. Clapp, and T. R. Ginn. 1984.
 		 A statistical exploration of the relationships of soil moisture
@@ -149,14 +157,14 @@ void water_eqn(RealD fractionGravel, RealD sand, RealD clay, LyrIndex n) {
 		 https://doi.org/10.1029/WR020i006p00682. */
 
 	/* Table 4 */
-	SW_Site.lyr[n]->thetasMatric = -14.2 * sand - 3.7 * clay + 50.5;
-	SW_Site.lyr[n]->psisMatric = powe(10.0, -1.58 * sand - 0.63 * clay + 2.17);
-	SW_Site.lyr[n]->bMatric = -0.3 * sand + 15.7 * clay + 3.10;
+	pt->thetasMatric = -14.2 * sand - 3.7 * clay + 50.5;
+	pt->psisMatric = powe(10.0, -1.58 * sand - 0.63 * clay + 2.17);
+	pt->bMatric = -0.3 * sand + 15.7 * clay + 3.10;
 
 
 	if (
-		LE(SW_Site.lyr[n]->thetasMatric, 0.0) ||
-		GT(SW_Site.lyr[n]->thetasMatric, 100.0)
+		LE(pt->thetasMatric, 0.0) ||
+		GT(pt->thetasMatric, 100.0)
 	) {
 		LogError(
 			logfp,
@@ -164,20 +172,20 @@ void water_eqn(RealD fractionGravel, RealD sand, RealD clay, LyrIndex n) {
 			"water_eqn(): invalid value of "
 			"theta(saturated, matric, [%]; Cosby et al. 1984) = %f "
 			"(must within 0-100%)\n",
-			SW_Site.lyr[n]->thetasMatric
+			pt->thetasMatric
 		);
 	}
 
-	if (ZRO(SW_Site.lyr[n]->bMatric)) {
+	if (ZRO(pt->bMatric)) {
 		LogError(
 			logfp,
 			LOGFATAL,
 			"water_eqn(): invalid value of beta = %f (must be != 0)\n",
-			SW_Site.lyr[n]->bMatric
+			pt->bMatric
 		);
 	}
 
-	SW_Site.lyr[n]->binverseMatric = 1.0 / SW_Site.lyr[n]->bMatric;
+	pt->binverseMatric = 1.0 / pt->bMatric;
 
 
 	/* Saxton, K. E. and W. J. Rawls. 2006. Soil water characteristic estimates
@@ -231,8 +239,181 @@ void water_eqn(RealD fractionGravel, RealD sand, RealD clay, LyrIndex n) {
 		);
 	}
 
-	SW_Site.lyr[n]->swcBulk_saturated =
-		SW_Site.lyr[n]->width * (1. - fractionGravel) * theta_S;
+	pt->thetaSaturated = theta_S;
+}
+
+
+/** Copy pedotransfer parameters to soil layer `n` and calculate
+    the parameters that depend on its width and gravel content */
+static void set_layer_pedotransfer(const SW_PEDOTRANSFER *pt,
+	RealD fractionGravel, LyrIndex n) {
+
+	SW_Site.thetasMatric[n] = pt->thetasMatric;
+	SW_Site.psisMatric[n] = pt->psisMatric;
+	SW_Site.bMatric[n] = pt->bMatric;
+	SW_Site.binverseMatric[n] = pt->binverseMatric;
+
+	SW_Site.swcBulk_saturated[n] =
+		SW_Site.width[n] * (1. - fractionGravel) * pt->thetaSaturated;
+
+
+	/* Constants of the soil water retention curve, see `SW_SWCbulk2SWPmatric()`:
+		 (theta / theta(saturated)) = swc * 100 / (width * (1 - gravel) * thetas) */
+	SW_Site.swrc_theta_scale[n] = 100. /
+		(SW_Site.width[n] * (1. - fractionGravel) * SW_Site.thetasMatric[n]);
+	SW_Site.swrc_psis_bar[n] = SW_Site.psisMatric[n] / BARCONV;
+
+	SW_Soilwat.swpCache.n_layers = 0;
+}
+
+
+/** Hash of a soil texture */
+static unsigned long long texture_hash(const RealD key[3]) {
+	unsigned long long h = 0, bits;
+	int i;
+
+	for (i = 0; i < 3; i++) {
+		memcpy(&bits, &key[i], sizeof bits);
+		h = (h ^ bits) * 0x9E3779B97F4A7C15ULL;
+	}
+
+	return h ^ (h >> 32);
+}
+
+
+/** Look up the derived parameters of a soil texture in the texture cache
+    @return TRUE if the texture is cached; then, `val` holds its parameters */
+static Bool texture_lookup(const RealD key[3], SW_TEXTURE_PARAMS *val) {
+	unsigned long long h = texture_hash(key);
+	SW_TEXTURE_SLOT *slot;
+	int i, state;
+
+	for (i = 0; i < TEXTURE_CACHE_PROBES; i++) {
+		slot = &texture_cache[(h + i) & (TEXTURE_CACHE_SIZE - 1)];
+		state = __atomic_load_n(&slot->state, __ATOMIC_ACQUIRE);
+
+		if (state == TEXTURE_FREE) {
+			break;
+		}
+
+		if (state == TEXTURE_READY && 0 == memcmp(slot->key, key, sizeof slot->key)) {
+			*val = slot->val;
+			return swTRUE;
+		}
+	}
+
+	return swFALSE;
+}
+
+
+/** Add the derived parameters of a soil texture to the texture cache;
+    a slot is claimed by the first thread that changes it from free to busy */
+static void texture_insert(const RealD key[3], const SW_TEXTURE_PARAMS *val) {
+	unsigned long long h = texture_hash(key);
+	SW_TEXTURE_SLOT *slot;
+	int i, state;
+
+	for (i = 0; i < TEXTURE_CACHE_PROBES; i++) {
+		slot = &texture_cache[(h + i) & (TEXTURE_CACHE_SIZE - 1)];
+		state = TEXTURE_FREE;
+
+		if (__atomic_compare_exchange_n(&slot->state, &state, TEXTURE_BUSY,
+				swFALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			memcpy(slot->key, key, sizeof slot->key);
+			slot->val = *val;
+			__atomic_store_n(&slot->state, TEXTURE_READY, __ATOMIC_RELEASE);
+			return;
+		}
+
+		if (state == TEXTURE_READY && 0 == memcmp(slot->key, key, sizeof slot->key)) {
+			return; // added by another thread
+		}
+	}
+}
+
+
+/** Set the derived soil hydraulic parameters of soil layer `s` from its
+    texture; parameters of a texture are calculated once per process and
+    shared by all runs with the same texture (e.g., of a batch) */
+static void set_layer_texture_params(LyrIndex s, SW_TEXTURE_PARAMS *tp) {
+	SW_SITE *sp = &SW_Site;
+	RealD key[3];
+
+	key[0] = sp->fractionWeightMatric_sand[s];
+	key[1] = sp->fractionWeightMatric_clay[s];
+	key[2] = sp->fractionVolBulk_gravel[s];
+
+	if (texture_lookup(key, tp)) {
+		set_layer_pedotransfer(&tp->pt, key[2], s);
+		return;
+	}
+
+	pedotransfer(key[0], key[1], &tp->pt);
+	set_layer_pedotransfer(&tp->pt, key[2], s);
+
+	tp->vwc_fieldcap = SW_SWPmatric2VWCBulk(key[2], 0.333, s);
+	tp->vwc_wiltpt = SW_SWPmatric2VWCBulk(key[2], 15, s);
+	tp->vwc_min30 = SW_SWPmatric2VWCBulk(key[2], 30., s);
+
+	texture_insert(key, tp);
+}
+
+/** Sum of transpiration coefficients across vegetation types of layer `n` */
+static RealD sum_transp_coeff(LyrIndex n) {
+	RealD sum = 0.;
+	int k;
+
+	ForEachVegType(k) {
+		sum += SW_Site.transp_coeff[k][n];
+	}
+
+	return sum;
+}
+
+
+
+/**
+	\brief Calculate soil moisture characteristics for each layer.
+
+  Bulk refers to the whole soil, i.e., including the rock/gravel component,
+  whereas matric refers to the < 2 mm fraction.
+
+  Saturated moisture content of the matric component (thetasMatric), saturation matric
+	potential (psisMatric), and the slope of the retention curve (bMatric) for each
+	layer are calculated using equations found in Cosby et al. (1984). \cite Cosby1984
+	The saturated moisture content of the whole soil (bulk) for each layer (swcBulk_saturated)
+	is calculated using equations found in Saxton and Rawls (2006; Equations 2, 3 & 5).
+	\cite Saxton2006
+
+	Return from the function is void. Calculated values stored in SW_Site object.
+
+	SOILWAT2 calculates internally based on soil bulk density of the whole soil,
+	i.e., including rock/gravel component. However, inputs are expected to
+	represent soil (matric) density of the < 2 mm fraction.
+
+	sand + clay + silt must equal one. Fraction silt is calculated: 1 - (sand + clay).
+
+	\param fractionGravel The fraction of gravel in a layer by volume.
+	\param sand The fraction of sand in a layer by weight.
+	\param clay The fraction of clay in a layer by weight.
+	\param n Soil layer index.
+
+	\sideeffect
+		- thetasMatric Saturated water content for the matric component (m^3/m^3).
+		- psisMatric Saturation matric potential (MPa).
+		- bMatric Slope of the linear log-log retention curve (unitless).
+		- swcBulk_saturated The saturated water content for the whole soil (bulk) (cm/layer).
+		- swrc_theta_scale, swrc_psis_bar Per-layer constants of
+			`SW_SWCbulk2SWPmatric_profile()`; the cached soil water potential
+			of `SW_SWCbulk2SWPmatric_cached()` is discarded.
+
+*/
+
+void water_eqn(RealD fractionGravel, RealD sand, RealD clay, LyrIndex n) {
+	SW_PEDOTRANSFER pt;
+
+	pedotransfer(sand, clay, &pt);
+	set_layer_pedotransfer(&pt, fractionGravel, n);
 }
 
 
@@ -263,7 +444,7 @@ LyrIndex nlayers_bsevap() {
 
 	ForEachSoilLayer(s)
 	{
-		if (GT(v->lyr[s]->evap_coeff, 0.0))
+		if (GT(v->evap_coeff[s], 0.0))
 		{
 			n++;
 		} else{
@@ -291,7 +472,7 @@ void nlayers_vegroots(LyrIndex n_transp_lyrs[]) {
 
 		ForEachSoilLayer(s)
 		{
-			if (GT(v->lyr[s]->transp_coeff[k], 0.0)) {
+			if (GT(v->transp_coeff[k][s], 0.0)) {
 				n_transp_lyrs[k]++;
 			} else {
 				break;
@@ -310,15 +491,13 @@ void add_deepdrain_layer(void) {
 
 		/* check if deep drain dummy layer was already added */
 		if (SW_Site.deep_lyr == 0) {
-			/* `_newlayer()` sets n_layers */
-			LyrIndex s = _newlayer();
-			SW_Site.lyr[s]->width = 1.0;
-
-			/* sp->deepdrain indicates an extra (dummy) layer for deep drainage
-			* has been added, so n_layers really should be n_layers -1
+			/* sp->deepdrain indicates an extra (dummy) layer for deep drainage;
+			* the dummy layer has no soil properties (and no storage in the
+			* soil layer arrays), it only indexes deep drainage in the
+			* soil water arrays and n_layers does not count it
 			* NOTE: deep_lyr is base0, n_layers is BASE1
 			*/
-			SW_Site.deep_lyr = --SW_Site.n_layers;
+			SW_Site.deep_lyr = SW_Site.n_layers;
 		}
 
 	} else {
@@ -330,31 +509,28 @@ void add_deepdrain_layer(void) {
 
 
 /**
-@brief First time called with no layers so SW_Site.lyr
- not initialized yet, malloc() required.  For each
- layer thereafter realloc() is called.
+@brief Adds a new soil layer with all properties set to zero
+
+@return Index of the new layer.
 */
 LyrIndex _newlayer(void) {
 
 	SW_SITE *v = &SW_Site;
-	v->n_layers++;
+	SW_LAYER_INFO lyr;
+
+	if (v->n_layers >= MAX_LAYERS) {
+		LogError(logfp, LOGFATAL,
+			"Too many soil layers: at most %d layers are supported.", MAX_LAYERS);
+	}
 
-	v->lyr = (!v->lyr) /* if not yet defined */
-		? (SW_LAYER_INFO **) Mem_Calloc(v->n_layers, sizeof(SW_LAYER_INFO *), "_newlayer()") /* malloc() it  */
-		: (SW_LAYER_INFO **) Mem_ReAlloc(v->lyr, sizeof(SW_LAYER_INFO *) * (v->n_layers)); /* else realloc() */
+	v->n_layers++;
 
-	v->lyr[v->n_layers - 1] = (SW_LAYER_INFO *) Mem_Calloc(1, sizeof(SW_LAYER_INFO), "_newlayer()");
+	memset(&lyr, 0, sizeof(SW_LAYER_INFO));
+	SW_SIT_set_layer(v->n_layers - 1, &lyr);
 
 	return v->n_layers - 1;
 }
 
-/*static void _clear_layer(LyrIndex n) {
- ---------------------------------------------------
-
- memset(SW_Site.lyr[n], 0, sizeof(SW_LAYER_INFO));
-
- }*/
-
 /* =================================================== */
 /* =================================================== */
 /*             Public Function Definitions             */
@@ -391,7 +567,7 @@ void SW_SIT_read(void) {
 	 */
 	SW_SITE *v = &SW_Site;
 	SW_CARBON *c = &SW_Carbon;
-	FILE *f;
+	SW_TEXTFILE f;
 	int lineno = 0, x,
 		rgnlow, /* lower layer of region */
 		region; /* transp region definition number */
@@ -405,142 +581,145 @@ void SW_SIT_read(void) {
 	/* note that Files.read() must be called prior to this. */
 	MyFileName = SW_F_name(eSite);
 
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
 
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 		switch (lineno) {
 		case 0:
-			_SWCMinVal = atof(inbuf);
+			_SWCMinVal = Str_ToDouble(f.line, NULL);
 			break;
 		case 1:
-			_SWCInitVal = atof(inbuf);
+			_SWCInitVal = Str_ToDouble(f.line, NULL);
 			break;
 		case 2:
-			_SWCWetVal = atof(inbuf);
+			_SWCWetVal = Str_ToDouble(f.line, NULL);
 			break;
 		case 3:
-			v->reset_yr = itob(atoi(inbuf));
+			v->reset_yr = itob(atoi(f.line));
 			break;
 		case 4:
-			v->deepdrain = itob(atoi(inbuf));
+			v->deepdrain = itob(atoi(f.line));
 			break;
 		case 5:
-			v->pet_scale = atof(inbuf);
+			v->pet_scale = Str_ToDouble(f.line, NULL);
 			break;
 		case 6:
-			v->percentRunoff = atof(inbuf);
+			v->percentRunoff = Str_ToDouble(f.line, NULL);
 			break;
 		case 7:
-			v->percentRunon = atof(inbuf);
+			v->percentRunon = Str_ToDouble(f.line, NULL);
 			break;
 		case 8:
-			v->TminAccu2 = atof(inbuf);
+			v->TminAccu2 = Str_ToDouble(f.line, NULL);
 			break;
 		case 9:
-			v->TmaxCrit = atof(inbuf);
+			v->TmaxCrit = Str_ToDouble(f.line, NULL);
 			break;
 		case 10:
-			v->lambdasnow = atof(inbuf);
+			v->lambdasnow = Str_ToDouble(f.line, NULL);
 			break;
 		case 11:
-			v->RmeltMin = atof(inbuf);
+			v->RmeltMin = Str_ToDouble(f.line, NULL);
 			break;
 		case 12:
-			v->RmeltMax = atof(inbuf);
+			v->RmeltMax = Str_ToDouble(f.line, NULL);
 			break;
 		case 13:
-			v->slow_drain_coeff = atof(inbuf);
+			v->slow_drain_coeff = Str_ToDouble(f.line, NULL);
 			break;
 		case 14:
-			v->evap.xinflec = atof(inbuf);
+			v->evap.xinflec = Str_ToDouble(f.line, NULL);
 			break;
 		case 15:
-			v->evap.slope = atof(inbuf);
+			v->evap.slope = Str_ToDouble(f.line, NULL);
 			break;
 		case 16:
-			v->evap.yinflec = atof(inbuf);
+			v->evap.yinflec = Str_ToDouble(f.line, NULL);
 			break;
 		case 17:
-			v->evap.range = atof(inbuf);
+			v->evap.range = Str_ToDouble(f.line, NULL);
 			break;
 		case 18:
-			v->transp.xinflec = atof(inbuf);
+			v->transp.xinflec = Str_ToDouble(f.line, NULL);
 			break;
 		case 19:
-			v->transp.slope = atof(inbuf);
+			v->transp.slope = Str_ToDouble(f.line, NULL);
 			break;
 		case 20:
-			v->transp.yinflec = atof(inbuf);
+			v->transp.yinflec = Str_ToDouble(f.line, NULL);
 			break;
 		case 21:
-			v->transp.range = atof(inbuf);
+			v->transp.range = Str_ToDouble(f.line, NULL);
 			break;
 		case 22:
 			// longitude is currently not used by the code, but may be used in the future
 			// it is present in the `siteparam.in` input file to completely document
 			// site location
-			v->longitude = atof(inbuf) * deg_to_rad;
+			v->longitude = Str_ToDouble(f.line, NULL) * deg_to_rad;
 			break;
 		case 23:
-			v->latitude = atof(inbuf) * deg_to_rad;
+			v->latitude = Str_ToDouble(f.line, NULL) * deg_to_rad;
 			break;
 		case 24:
-			v->altitude = atof(inbuf);
+			v->altitude = Str_ToDouble(f.line, NULL);
 			break;
 		case 25:
-			v->slope = atof(inbuf) * deg_to_rad;
+			v->slope = Str_ToDouble(f.line, NULL) * deg_to_rad;
 			break;
 		case 26:
-			tmp = atof(inbuf);
+			tmp = Str_ToDouble(f.line, NULL);
 			v->aspect = missing(tmp) ? tmp : tmp * deg_to_rad;
 			break;
 		case 27:
-			v->bmLimiter = atof(inbuf);
+			v->bmLimiter = Str_ToDouble(f.line, NULL);
 			break;
 		case 28:
-			v->t1Param1 = atof(inbuf);
+			v->t1Param1 = Str_ToDouble(f.line, NULL);
 			break;
 		case 29:
-			v->t1Param2 = atof(inbuf);
+			v->t1Param2 = Str_ToDouble(f.line, NULL);
 			break;
 		case 30:
-			v->t1Param3 = atof(inbuf);
+			v->t1Param3 = Str_ToDouble(f.line, NULL);
 			break;
 		case 31:
-			v->csParam1 = atof(inbuf);
+			v->csParam1 = Str_ToDouble(f.line, NULL);
 			break;
 		case 32:
-			v->csParam2 = atof(inbuf);
+			v->csParam2 = Str_ToDouble(f.line, NULL);
 			break;
 		case 33:
-			v->shParam = atof(inbuf);
+			v->shParam = Str_ToDouble(f.line, NULL);
 			break;
 		case 34:
-			v->Tsoil_constant = atof(inbuf);
+			v->Tsoil_constant = Str_ToDouble(f.line, NULL);
 			break;
 		case 35:
-			v->stDeltaX = atof(inbuf);
+			v->stDeltaX = Str_ToDouble(f.line, NULL);
 			break;
 		case 36:
-			v->stMaxDepth = atof(inbuf);
+			v->stMaxDepth = Str_ToDouble(f.line, NULL);
 			break;
 		case 37:
-			v->use_soil_temp = itob(atoi(inbuf));
+			// 0: off; 1: explicit solver; 2: Crank-Nicolson solver
+			x = atoi(f.line);
+			v->use_soil_temp = itob(x);
+			v->stMethod = (2 == x) ? SW_STMETHOD_CRANKNICOLSON : SW_STMETHOD_EXPLICIT;
 			break;
 		case 38:
-			c->use_bio_mult = itob(atoi(inbuf));
+			c->use_bio_mult = itob(atoi(f.line));
 			#ifdef SWDEBUG
 			if (debug) swprintf("'SW_SIT_read': use_bio_mult = %d\n", c->use_bio_mult);
 			#endif
 			break;
 		case 39:
-			c->use_wue_mult = itob(atoi(inbuf));
+			c->use_wue_mult = itob(atoi(f.line));
 			#ifdef SWDEBUG
 			if (debug) swprintf("'SW_SIT_read': use_wue_mult = %d\n", c->use_wue_mult);
 			#endif
 			break;
 		case 40:
-			strcpy(c->scenario, inbuf);
+			strcpy(c->scenario, f.line);
 			#ifdef SWDEBUG
 			if (debug) swprintf("'SW_SIT_read': scenario = %s\n", c->scenario);
 			#endif
@@ -553,9 +732,9 @@ void SW_SIT_read(void) {
 				too_many_regions = swTRUE;
 				goto Label_End_Read;
 			}
-			x = sscanf(inbuf, "%d %d", &region, &rgnlow);
+			x = Str_Scan(f.line, "%d %d", &region, &rgnlow);
 			if (x < 2 || region < 1 || rgnlow < 1) {
-				CloseFile(&f);
+				CloseTextFile(&f);
 				LogError(logfp, LOGFATAL, "%s : Bad record %d.\n", MyFileName, lineno);
 			}
 			_TranspRgnBounds[region - 1] = (LyrIndex) (rgnlow - 1);
@@ -567,7 +746,7 @@ void SW_SIT_read(void) {
 
 	Label_End_Read:
 
-	CloseFile(&f);
+	CloseTextFile(&f);
 
 	if (LT(v->percentRunoff, 0.) || GT(v->percentRunoff, 1.)) {
 		LogError(logfp, LOGFATAL, "%s : proportion of ponded surface water removed as daily"
@@ -600,7 +779,7 @@ static void _read_layers(void) {
 	/* 5-Feb-2002 (cwb) removed dmin requirement in input file */
 
 	SW_SITE *v = &SW_Site;
-	FILE *f;
+	SW_TEXTFILE f;
 	LyrIndex lyrno;
 	int x, k;
 	RealF dmin = 0.0, dmax, evco, trco_veg[NVEGTYPES], psand, pclay, matricd, imperm,
@@ -609,13 +788,24 @@ static void _read_layers(void) {
 	/* note that Files.read() must be called prior to this. */
 	MyFileName = SW_F_name(eLayers);
 
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
+
+	while (GetATextLine(&f)) {
+		if (v->n_layers >= MAX_LAYERS) {
+			CloseTextFile(&f);
+			LogError(
+				logfp,
+				LOGFATAL,
+				"%s : Too many layers specified (%d).\n"
+				"Maximum number of layers is %d\n",
+				MyFileName, v->n_layers + 1, MAX_LAYERS
+			);
+		}
 
-	while (GetALine(f, inbuf)) {
 		lyrno = _newlayer();
 
-		x = sscanf(
-			inbuf,
+		x = Str_Scan(
+			f.line,
 			"%f %f %f %f %f %f %f %f %f %f %f %f",
 			&dmax,
 			&matricd,
@@ -631,7 +821,7 @@ static void _read_layers(void) {
 		/* Check that we have 12 values per layer */
 		/* Adjust number if new variables are added */
 		if (x != 12) {
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(
 				logfp,
 				LOGFATAL,
@@ -640,38 +830,27 @@ static void _read_layers(void) {
 			);
 		}
 
-		v->lyr[lyrno]->width = dmax - dmin;
+		v->width[lyrno] = dmax - dmin;
 
 		/* checks for valid values now carried out by `SW_SIT_init_run()` */
 
 		dmin = dmax;
-		v->lyr[lyrno]->fractionVolBulk_gravel = f_gravel;
-		v->lyr[lyrno]->soilMatric_density = matricd;
-		v->lyr[lyrno]->evap_coeff = evco;
+		v->fractionVolBulk_gravel[lyrno] = f_gravel;
+		v->soilMatric_density[lyrno] = matricd;
+		v->evap_coeff[lyrno] = evco;
 
 		ForEachVegType(k)
 		{
-			v->lyr[lyrno]->transp_coeff[k] = trco_veg[k];
+			v->transp_coeff[k][lyrno] = trco_veg[k];
 		}
 
-		v->lyr[lyrno]->fractionWeightMatric_sand = psand;
-		v->lyr[lyrno]->fractionWeightMatric_clay = pclay;
-		v->lyr[lyrno]->impermeability = imperm;
-		v->lyr[lyrno]->sTemp = soiltemp;
-
-		if (lyrno >= MAX_LAYERS) {
-			CloseFile(&f);
-			LogError(
-				logfp,
-				LOGFATAL,
-				"%s : Too many layers specified (%d).\n"
-				"Maximum number of layers is %d\n",
-				MyFileName, lyrno + 1, MAX_LAYERS
-			);
-		}
+		v->fractionWeightMatric_sand[lyrno] = psand;
+		v->fractionWeightMatric_clay[lyrno] = pclay;
+		v->impermeability[lyrno] = imperm;
+		v->sTemp[lyrno] = soiltemp;
 	}
 
-	CloseFile(&f);
+	CloseTextFile(&f);
 }
 
 /**
@@ -708,8 +887,8 @@ static void _read_layers(void) {
     this from the perspective of soil, it would mean the shallowest bound is at
     `lowerBounds[0]`.
 
-  @sideeffect After deleting any previous data in the soil layer array
-    SW_Site.lyr, it creates new soil layers based on the argument inputs.
+  @sideeffect After deleting any previous soil layer data of
+    SW_Site, it creates new soil layers based on the argument inputs.
 
   @note
     - This function is a modified version of the function _read_layers() in
@@ -737,35 +916,35 @@ void set_soillayers(LyrIndex nlyrs, RealF *dmax, RealF *matricd, RealF *f_gravel
     // Create the next soil layer
     lyrno = _newlayer();
 
-    v->lyr[lyrno]->width = dmax[i] - dmin;
+    v->width[lyrno] = dmax[i] - dmin;
     dmin = dmax[i];
-    v->lyr[lyrno]->soilMatric_density = matricd[i];
-    v->lyr[lyrno]->fractionVolBulk_gravel = f_gravel[i];
-    v->lyr[lyrno]->evap_coeff = evco[i];
+    v->soilMatric_density[lyrno] = matricd[i];
+    v->fractionVolBulk_gravel[lyrno] = f_gravel[i];
+    v->evap_coeff[lyrno] = evco[i];
 
     ForEachVegType(k)
     {
       switch (k)
       {
         case SW_TREES:
-          v->lyr[lyrno]->transp_coeff[k] = trco_tree[i];
+          v->transp_coeff[k][lyrno] = trco_tree[i];
           break;
         case SW_SHRUB:
-          v->lyr[lyrno]->transp_coeff[k] = trco_shrub[i];
+          v->transp_coeff[k][lyrno] = trco_shrub[i];
           break;
         case SW_FORBS:
-          v->lyr[lyrno]->transp_coeff[k] = trco_forb[i];
+          v->transp_coeff[k][lyrno] = trco_forb[i];
           break;
         case SW_GRASS:
-          v->lyr[lyrno]->transp_coeff[k] = trco_grass[i];
+          v->transp_coeff[k][lyrno] = trco_grass[i];
           break;
       }
     }
 
-    v->lyr[lyrno]->fractionWeightMatric_sand = psand[i];
-    v->lyr[lyrno]->fractionWeightMatric_clay = pclay[i];
-    v->lyr[lyrno]->impermeability = imperm[i];
-    v->lyr[lyrno]->sTemp = soiltemp[i];
+    v->fractionWeightMatric_sand[lyrno] = psand[i];
+    v->fractionWeightMatric_clay[lyrno] = pclay[i];
+    v->impermeability[lyrno] = imperm[i];
+    v->sTemp[lyrno] = soiltemp[i];
   }
 
 
@@ -819,7 +998,7 @@ void derive_soilRegions(int nRegions, RealD *regionLowerBounds){
 
 	/* ----------------- Derive Regions ------------------- */
 	// Loop through the regions the user wants to derive
-	layer = 0; // SW_Site.lyr is base0-indexed
+	layer = 0; // soil layers are base0-indexed
 	totalDepth = 0;
 	for(i = 0; i < nRegions; ++i){
 		_TranspRgnBounds[i] = layer;
@@ -827,8 +1006,8 @@ void derive_soilRegions(int nRegions, RealD *regionLowerBounds){
 		// It becomes the bound.
 		while(totalDepth < regionLowerBounds[i] &&
 		      layer < v->n_layers &&
-		      sum_across_vegtypes(v->lyr[layer]->transp_coeff)) {
-			totalDepth += v->lyr[layer]->width;
+		      sum_transp_coeff(layer)) {
+			totalDepth += v->width[layer];
 			_TranspRgnBounds[i] = layer;
 			layer++;
 		}
@@ -864,7 +1043,6 @@ void SW_SIT_init_run(void) {
 	/* 1-Oct-03 (cwb) removed sum_evap_coeff and sum_transp_coeff  */
 
 	SW_SITE *sp = &SW_Site;
-	SW_LAYER_INFO *lyr;
 	LyrIndex s, r, curregion;
 	int k, wiltminflag = 0, initminflag = 0;
 	Bool fail = swFALSE;
@@ -872,6 +1050,7 @@ void SW_SIT_init_run(void) {
 		fval = 0,
 		evsum = 0., trsum_veg[NVEGTYPES] = {0.},
 		swcmin_help1, swcmin_help2;
+	SW_TEXTURE_PARAMS tp;
 	const char *errtype = "\0";
 
 	#ifdef SWDEBUG
@@ -892,60 +1071,58 @@ void SW_SIT_init_run(void) {
 	/* Loop over soil layers check variables and calculate parameters */
 	ForEachSoilLayer(s)
 	{
-		lyr = sp->lyr[s];
-
 		/* Check validity of soil variables:
 			previously, checked by code in `_read_layers()`,
 			erroneously skipped by `set_soillayers()`,
 			and checked by code in rSOILWAT2's `onSet_SW_LYR()`
 		*/
-		if (LE(lyr->width, 0.)) {
+		if (LE(sp->width[s], 0.)) {
 			fail = swTRUE;
-			fval = lyr->width;
+			fval = sp->width[s];
 			errtype = Str_Dup("layer width");
 
-		} else if (LT(lyr->soilMatric_density, 0.)) {
+		} else if (LT(sp->soilMatric_density[s], 0.)) {
 			fail = swTRUE;
-			fval = lyr->soilMatric_density;
+			fval = sp->soilMatric_density[s];
 			errtype = Str_Dup("soil density");
 
 		} else if (
-			LT(lyr->fractionVolBulk_gravel, 0.) ||
-			GE(lyr->fractionVolBulk_gravel, 1.)
+			LT(sp->fractionVolBulk_gravel[s], 0.) ||
+			GE(sp->fractionVolBulk_gravel[s], 1.)
 		) {
 			fail = swTRUE;
-			fval = lyr->fractionVolBulk_gravel;
+			fval = sp->fractionVolBulk_gravel[s];
 			errtype = Str_Dup("gravel content");
 
 		} else if (
-			LE(lyr->fractionWeightMatric_sand, 0.) ||
-			GE(lyr->fractionWeightMatric_sand, 1.)
+			LE(sp->fractionWeightMatric_sand[s], 0.) ||
+			GE(sp->fractionWeightMatric_sand[s], 1.)
 		) {
 			fail = swTRUE;
-			fval = lyr->fractionWeightMatric_sand;
+			fval = sp->fractionWeightMatric_sand[s];
 			errtype = Str_Dup("sand proportion");
 
 		} else if (
-			LE(lyr->fractionWeightMatric_clay, 0.) ||
-			GE(lyr->fractionWeightMatric_clay, 1.)
+			LE(sp->fractionWeightMatric_clay[s], 0.) ||
+			GE(sp->fractionWeightMatric_clay[s], 1.)
 		) {
 			fail = swTRUE;
-			fval = lyr->fractionWeightMatric_clay;
+			fval = sp->fractionWeightMatric_clay[s];
 			errtype = Str_Dup("clay proportion");
 
 		} else if (
-			GE(lyr->fractionWeightMatric_sand + lyr->fractionWeightMatric_clay, 1.)
+			GE(sp->fractionWeightMatric_sand[s] + sp->fractionWeightMatric_clay[s], 1.)
 		) {
 			fail = swTRUE;
-			fval = lyr->fractionWeightMatric_sand + lyr->fractionWeightMatric_clay;
+			fval = sp->fractionWeightMatric_sand[s] + sp->fractionWeightMatric_clay[s];
 			errtype = Str_Dup("sand+clay proportion");
 
 		} else if (
-			LT(lyr->impermeability, 0.) ||
-			GT(lyr->impermeability, 1.)
+			LT(sp->impermeability[s], 0.) ||
+			GT(sp->impermeability[s], 1.)
 		) {
 			fail = swTRUE;
-			fval = lyr->impermeability;
+			fval = sp->impermeability[s];
 			errtype = Str_Dup("impermeability");
 		}
 
@@ -959,42 +1136,28 @@ void SW_SIT_init_run(void) {
 		}
 
 		/* Update soil density for gravel */
-		lyr->soilBulk_density = calculate_soilBulkDensity(
-			lyr->soilMatric_density,
-			lyr->fractionVolBulk_gravel
+		sp->soilBulk_density[s] = calculate_soilBulkDensity(
+			sp->soilMatric_density[s],
+			sp->fractionVolBulk_gravel[s]
 		);
 
-		/* Calculate pedotransfer function paramaters */
-		water_eqn(
-			lyr->fractionVolBulk_gravel,
-			lyr->fractionWeightMatric_sand,
-			lyr->fractionWeightMatric_clay,
-			s
-		);
+		/* Calculate pedotransfer function paramaters (see `water_eqn()`) */
+		set_layer_texture_params(s, &tp);
 
 		/* Calculate SWC at field capacity and at wilting point */
-		lyr->swcBulk_fieldcap = lyr->width * SW_SWPmatric2VWCBulk(
-			lyr->fractionVolBulk_gravel,
-			0.333,
-			s
-		);
-
-		lyr->swcBulk_wiltpt = lyr->width * SW_SWPmatric2VWCBulk(
-			lyr->fractionVolBulk_gravel,
-			15,
-			s
-		);
+		sp->swcBulk_fieldcap[s] = sp->width[s] * tp.vwc_fieldcap;
+		sp->swcBulk_wiltpt[s] = sp->width[s] * tp.vwc_wiltpt;
 
 
 		/* sum ev and tr coefficients for later */
-		evsum += lyr->evap_coeff;
+		evsum += sp->evap_coeff[s];
 		ForEachVegType(k)
 		{
-			trsum_veg[k] += lyr->transp_coeff[k];
+			trsum_veg[k] += sp->transp_coeff[k][s];
 
 			/* calculate soil water content at SWPcrit for each vegetation type */
-			lyr->swcBulk_atSWPcrit[k] = SW_SWPmatric2VWCBulk(lyr->fractionVolBulk_gravel,
-				SW_VegProd.veg[k].SWPcrit, s) * lyr->width;
+			sp->swcBulk_atSWPcrit[k][s] = SW_SWPmatric2VWCBulk(sp->fractionVolBulk_gravel[s],
+				SW_VegProd.veg[k].SWPcrit, s) * sp->width[s];
 
 			/* Find which transpiration region the current soil layer
 			 * is in and check validity of result. Region bounds are
@@ -1003,7 +1166,7 @@ void SW_SIT_init_run(void) {
 			ForEachTranspRegion(r)
 			{
 				if (s < _TranspRgnBounds[r]) {
-					if (ZRO(lyr->transp_coeff[k]))
+					if (ZRO(sp->transp_coeff[k][s]))
 						break; /* end of transpiring layers */
 					curregion = r + 1;
 					break;
@@ -1011,7 +1174,7 @@ void SW_SIT_init_run(void) {
 			}
 
 			if (curregion || _TranspRgnBounds[curregion] == 0) {
-				lyr->my_transp_rgn[k] = curregion;
+				sp->my_transp_rgn[k][s] = curregion;
 				sp->n_transp_lyrs[k] = max(sp->n_transp_lyrs[k], s);
 
 			} else if (s == 0) {
@@ -1024,7 +1187,7 @@ void SW_SIT_init_run(void) {
 						"  Please fix the discrepancy and try again.\n",
 						SW_F_name(eSite), r + 1, key2veg[k], s, SW_F_name(eLayers));
 			} else {
-				lyr->my_transp_rgn[k] = 0;
+				sp->my_transp_rgn[k][s] = 0;
 			}
 		}
 
@@ -1035,58 +1198,58 @@ void SW_SIT_init_run(void) {
 
 			/* residual SWC of Rawls & Brakensiek (1985) */
 			swcmin_help1 = SW_VWCBulkRes(
-				lyr->fractionVolBulk_gravel,
-				lyr->fractionWeightMatric_sand,
-				lyr->fractionWeightMatric_clay,
-				lyr->swcBulk_saturated / ((1. - lyr->fractionVolBulk_gravel) * lyr->width)
+				sp->fractionVolBulk_gravel[s],
+				sp->fractionWeightMatric_sand[s],
+				sp->fractionWeightMatric_clay[s],
+				sp->swcBulk_saturated[s] / ((1. - sp->fractionVolBulk_gravel[s]) * sp->width[s])
 			);
 
 			/* residual SWC at -3 MPa (Fredlund DG, Xing AQ (1994)
 				EQUATIONS FOR THE SOIL-WATER CHARACTERISTIC CURVE.
 				Canadian Geotechnical Journal, 31, 521-532.)
 			*/
-			swcmin_help2 = SW_SWPmatric2VWCBulk(lyr->fractionVolBulk_gravel, 30., s);
+			swcmin_help2 = tp.vwc_min30;
 
 			// if `SW_VWCBulkRes()` returns SW_MISSING then use `swcmin_help2`
 			if (missing(swcmin_help1)){
-				lyr->swcBulk_min = swcmin_help2;
+				sp->swcBulk_min[s] = swcmin_help2;
 
 			} else{
-				lyr->swcBulk_min = fmax(0., fmin(swcmin_help1, swcmin_help2));
+				sp->swcBulk_min[s] = fmax(0., fmin(swcmin_help1, swcmin_help2));
 			}
 
 		} else if (GE(_SWCMinVal, 1.0)) {
 			/* input: fixed SWP value as minimum SWC; unit(_SWCMinVal) == -bar */
-			lyr->swcBulk_min = SW_SWPmatric2VWCBulk(
-				lyr->fractionVolBulk_gravel,
+			sp->swcBulk_min[s] = SW_SWPmatric2VWCBulk(
+				sp->fractionVolBulk_gravel[s],
 				_SWCMinVal,
 				s
 			);
 
 		} else {
 			/* input: fixed VWC value as minimum SWC; unit(_SWCMinVal) == cm/cm */
-			lyr->swcBulk_min = _SWCMinVal;
+			sp->swcBulk_min[s] = _SWCMinVal;
 		}
 
 		/* Convert VWC to SWC */
-		lyr->swcBulk_min *= lyr->width;
+		sp->swcBulk_min[s] *= sp->width[s];
 
 		#ifdef SWDEBUG
 		if (debug) {
 			swprintf(
 				"L[%d] swcmin=%f = swpmin=%f\n",
 				s,
-				lyr->swcBulk_min,
-				SW_SWCbulk2SWPmatric(lyr->fractionVolBulk_gravel, lyr->swcBulk_min, s)
+				sp->swcBulk_min[s],
+				SW_SWCbulk2SWPmatric(sp->fractionVolBulk_gravel[s], sp->swcBulk_min[s], s)
 			);
 
 			swprintf(
 				"L[%d] SWC(HalfWiltpt)=%f = swp(hw)=%f\n",
 				s,
-				lyr->swcBulk_wiltpt / 2,
+				sp->swcBulk_wiltpt[s] / 2,
 				SW_SWCbulk2SWPmatric(
-					lyr->fractionVolBulk_gravel,
-					lyr->swcBulk_wiltpt / 2,
+					sp->fractionVolBulk_gravel[s],
+					sp->swcBulk_wiltpt[s] / 2,
 					s
 				)
 			);
@@ -1095,19 +1258,19 @@ void SW_SIT_init_run(void) {
 
 
 		/* Calculate wet limit of SWC for what inputs defined as wet */
-		lyr->swcBulk_wet = GE(_SWCWetVal, 1.0) ? SW_SWPmatric2VWCBulk(lyr->fractionVolBulk_gravel, _SWCWetVal, s) * lyr->width : _SWCWetVal * lyr->width;
+		sp->swcBulk_wet[s] = GE(_SWCWetVal, 1.0) ? SW_SWPmatric2VWCBulk(sp->fractionVolBulk_gravel[s], _SWCWetVal, s) * sp->width[s] : _SWCWetVal * sp->width[s];
 		/* Calculate initial SWC based on inputs */
-		lyr->swcBulk_init = GE(_SWCInitVal, 1.0) ? SW_SWPmatric2VWCBulk(lyr->fractionVolBulk_gravel, _SWCInitVal, s) * lyr->width : _SWCInitVal * lyr->width;
+		sp->swcBulk_init[s] = GE(_SWCInitVal, 1.0) ? SW_SWPmatric2VWCBulk(sp->fractionVolBulk_gravel[s], _SWCInitVal, s) * sp->width[s] : _SWCInitVal * sp->width[s];
 
 		/* test validity of values */
-		if (LT(lyr->swcBulk_init, lyr->swcBulk_min))
+		if (LT(sp->swcBulk_init[s], sp->swcBulk_min[s]))
 			initminflag++;
-		if (LT(lyr->swcBulk_wiltpt, lyr->swcBulk_min))
+		if (LT(sp->swcBulk_wiltpt[s], sp->swcBulk_min[s]))
 			wiltminflag++;
-		if (LE(lyr->swcBulk_wet, lyr->swcBulk_min)) {
+		if (LE(sp->swcBulk_wet[s], sp->swcBulk_min[s])) {
 			LogError(logfp, LOGFATAL, "%s : Layer %d\n"
 					"  calculated swcBulk_wet (%7.4f) <= swcBulk_min (%7.4f).\n"
-					"  Recheck parameters and try again.", MyFileName, s + 1, lyr->swcBulk_wet, lyr->swcBulk_min);
+					"  Recheck parameters and try again.", MyFileName, s + 1, sp->swcBulk_wet[s], sp->swcBulk_min[s]);
 		}
 
 	} /*end ForEachSoilLayer */
@@ -1134,9 +1297,9 @@ void SW_SIT_init_run(void) {
 
 		ForEachEvapLayer(s)
 		{
-			SW_Site.lyr[s]->evap_coeff /= evsum;
+			SW_Site.evap_coeff[s] /= evsum;
 			LogError(logfp, LOGNOTE, "  Layer %2d : %.4f",
-				s + 1, SW_Site.lyr[s]->evap_coeff);
+				s + 1, SW_Site.evap_coeff[s]);
 		}
 
 		LogError(logfp, LOGQUIET, "");
@@ -1152,11 +1315,11 @@ void SW_SIT_init_run(void) {
 
 			ForEachSoilLayer(s)
 			{
-				if (GT(SW_Site.lyr[s]->transp_coeff[k], 0.))
+				if (GT(SW_Site.transp_coeff[k][s], 0.))
 				{
-					SW_Site.lyr[s]->transp_coeff[k] /= trsum_veg[k];
+					SW_Site.transp_coeff[k][s] /= trsum_veg[k];
 					LogError(logfp, LOGNOTE, "  Layer %2d : %.4f",
-						s + 1, SW_Site.lyr[s]->transp_coeff[k]);
+						s + 1, SW_Site.transp_coeff[k][s]);
 				}
 			}
 
@@ -1199,25 +1362,100 @@ void SW_SIT_init_run(void) {
 }
 
 /**
-@brief For multiple runs with the shared library, the need to remove the allocated
-			soil layers arises to avoid leaks. (rjm 2013)
+@brief For multiple runs with the shared library, the soil layers of a
+			previous run need to be removed. (rjm 2013)
+
+Soil layer properties are stored in fixed-size arrays of `SW_Site`;
+they are reset to zero, but counts are left to `SW_SIT_init_counts()`.
 */
 void SW_SIT_clear_layers(void) {
 	SW_SITE *s = &SW_Site;
-	LyrIndex i, j;
+	SW_LAYER_INFO lyr;
+	LyrIndex i;
+
+	memset(&lyr, 0, sizeof(SW_LAYER_INFO));
+
+	for (i = 0; i < s->n_layers; i++) {
+		SW_SIT_set_layer(i, &lyr);
+	}
+}
+
+
+/**
+@brief Copy the properties of soil layer `n` into a single-layer record
+
+@param n Index of the soil layer (base0).
+@param[out] lyr Properties of soil layer `n`.
+*/
+void SW_SIT_get_layer(LyrIndex n, SW_LAYER_INFO *lyr) {
+	SW_SITE *s = &SW_Site;
+	int k;
 
-	j = SW_Site.n_layers;
+	lyr->width = s->width[n];
+	lyr->soilMatric_density = s->soilMatric_density[n];
+	lyr->evap_coeff = s->evap_coeff[n];
+	lyr->fractionVolBulk_gravel = s->fractionVolBulk_gravel[n];
+	lyr->fractionWeightMatric_sand = s->fractionWeightMatric_sand[n];
+	lyr->fractionWeightMatric_clay = s->fractionWeightMatric_clay[n];
+	lyr->impermeability = s->impermeability[n];
+	lyr->sTemp = s->sTemp[n];
+	lyr->soilBulk_density = s->soilBulk_density[n];
+	lyr->swcBulk_fieldcap = s->swcBulk_fieldcap[n];
+	lyr->swcBulk_wiltpt = s->swcBulk_wiltpt[n];
+	lyr->swcBulk_min = s->swcBulk_min[n];
+	lyr->swcBulk_wet = s->swcBulk_wet[n];
+	lyr->swcBulk_init = s->swcBulk_init[n];
+	lyr->swcBulk_saturated = s->swcBulk_saturated[n];
+	lyr->thetasMatric = s->thetasMatric[n];
+	lyr->psisMatric = s->psisMatric[n];
+	lyr->bMatric = s->bMatric[n];
+	lyr->binverseMatric = s->binverseMatric[n];
 
-	if (s->deepdrain && s->deep_lyr > 0) {
-		j++;
+	ForEachVegType(k)
+	{
+		lyr->transp_coeff[k] = s->transp_coeff[k][n];
+		lyr->swcBulk_atSWPcrit[k] = s->swcBulk_atSWPcrit[k][n];
+		lyr->my_transp_rgn[k] = s->my_transp_rgn[k][n];
 	}
+}
+
 
-	for (i = 0; i < j; i++) {
-		free(s->lyr[i]);
-		s->lyr[i] = NULL;
+/**
+@brief Copy a single-layer record into the properties of soil layer `n`
+
+@param n Index of the soil layer (base0); must be less than `MAX_LAYERS`.
+@param[in] lyr Properties of soil layer `n`.
+*/
+void SW_SIT_set_layer(LyrIndex n, const SW_LAYER_INFO *lyr) {
+	SW_SITE *s = &SW_Site;
+	int k;
+
+	s->width[n] = lyr->width;
+	s->soilMatric_density[n] = lyr->soilMatric_density;
+	s->evap_coeff[n] = lyr->evap_coeff;
+	s->fractionVolBulk_gravel[n] = lyr->fractionVolBulk_gravel;
+	s->fractionWeightMatric_sand[n] = lyr->fractionWeightMatric_sand;
+	s->fractionWeightMatric_clay[n] = lyr->fractionWeightMatric_clay;
+	s->impermeability[n] = lyr->impermeability;
+	s->sTemp[n] = lyr->sTemp;
+	s->soilBulk_density[n] = lyr->soilBulk_density;
+	s->swcBulk_fieldcap[n] = lyr->swcBulk_fieldcap;
+	s->swcBulk_wiltpt[n] = lyr->swcBulk_wiltpt;
+	s->swcBulk_min[n] = lyr->swcBulk_min;
+	s->swcBulk_wet[n] = lyr->swcBulk_wet;
+	s->swcBulk_init[n] = lyr->swcBulk_init;
+	s->swcBulk_saturated[n] = lyr->swcBulk_saturated;
+	s->thetasMatric[n] = lyr->thetasMatric;
+	s->psisMatric[n] = lyr->psisMatric;
+	s->bMatric[n] = lyr->bMatric;
+	s->binverseMatric[n] = lyr->binverseMatric;
+
+	ForEachVegType(k)
+	{
+		s->transp_coeff[k][n] = lyr->transp_coeff[k];
+		s->swcBulk_atSWPcrit[k][n] = lyr->swcBulk_atSWPcrit[k];
+		s->my_transp_rgn[k][n] = lyr->my_transp_rgn[k];
 	}
-	free(s->lyr);
-	s->lyr = NULL;
 }
 
 
@@ -1283,6 +1521,8 @@ void _echo_inputs(void) {
 	LogError(logfp, LOGNOTE, "  deltaX: %5.4f\n", s->stDeltaX);
 	LogError(logfp, LOGNOTE, "  max depth: %5.4f\n", s->stMaxDepth);
 	LogError(logfp, LOGNOTE, "  Make soil temperature calculations: %s\n", (s->use_soil_temp) ? "swTRUE" : "swFALSE");
+	LogError(logfp, LOGNOTE, "  Soil temperature solver: %s\n",
+		(s->stMethod == SW_STMETHOD_CRANKNICOLSON) ? "Crank-Nicolson" : "explicit");
 	LogError(logfp, LOGNOTE, "  Number of regressions for the soil temperature function: %d\n", s->stNRGR);
 
 	LogError(logfp, LOGNOTE, "\nLayer Related Values:\n----------------------\n");
@@ -1307,14 +1547,14 @@ void _echo_inputs(void) {
 	{
 		LogError(logfp, LOGNOTE,
 				"  %3d %5.1f %9.5f %6.2f %8.5f %8.5f %6.2f %6.2f %6.2f %6.2f %6.2f %6.2f %9.2f %9.2f %9.2f %9.2f %9.2f %10d %10d %15d %15d %15.4f %9.4f %9.4f %9.4f %9.4f\n",
-				i + 1, s->lyr[i]->width, s->lyr[i]->soilBulk_density, s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_fieldcap / s->lyr[i]->width,
-				s->lyr[i]->swcBulk_wiltpt / s->lyr[i]->width, s->lyr[i]->fractionWeightMatric_sand, s->lyr[i]->fractionWeightMatric_clay,
-				s->lyr[i]->swcBulk_atSWPcrit[SW_FORBS] / s->lyr[i]->width, s->lyr[i]->swcBulk_atSWPcrit[SW_TREES] / s->lyr[i]->width,
-				s->lyr[i]->swcBulk_atSWPcrit[SW_SHRUB] / s->lyr[i]->width, s->lyr[i]->swcBulk_atSWPcrit[SW_GRASS] / s->lyr[i]->width, s->lyr[i]->evap_coeff,
-				s->lyr[i]->transp_coeff[SW_FORBS], s->lyr[i]->transp_coeff[SW_TREES], s->lyr[i]->transp_coeff[SW_SHRUB], s->lyr[i]->transp_coeff[SW_GRASS], s->lyr[i]->my_transp_rgn[SW_FORBS],
-				s->lyr[i]->my_transp_rgn[SW_TREES], s->lyr[i]->my_transp_rgn[SW_SHRUB], s->lyr[i]->my_transp_rgn[SW_GRASS], s->lyr[i]->swcBulk_wet / s->lyr[i]->width,
-				s->lyr[i]->swcBulk_min / s->lyr[i]->width, s->lyr[i]->swcBulk_init / s->lyr[i]->width, s->lyr[i]->swcBulk_saturated / s->lyr[i]->width,
-				s->lyr[i]->impermeability);
+				i + 1, s->width[i], s->soilBulk_density[i], s->fractionVolBulk_gravel[i], s->swcBulk_fieldcap[i] / s->width[i],
+				s->swcBulk_wiltpt[i] / s->width[i], s->fractionWeightMatric_sand[i], s->fractionWeightMatric_clay[i],
+				s->swcBulk_atSWPcrit[SW_FORBS][i] / s->width[i], s->swcBulk_atSWPcrit[SW_TREES][i] / s->width[i],
+				s->swcBulk_atSWPcrit[SW_SHRUB][i] / s->width[i], s->swcBulk_atSWPcrit[SW_GRASS][i] / s->width[i], s->evap_coeff[i],
+				s->transp_coeff[SW_FORBS][i], s->transp_coeff[SW_TREES][i], s->transp_coeff[SW_SHRUB][i], s->transp_coeff[SW_GRASS][i], s->my_transp_rgn[SW_FORBS][i],
+				s->my_transp_rgn[SW_TREES][i], s->my_transp_rgn[SW_SHRUB][i], s->my_transp_rgn[SW_GRASS][i], s->swcBulk_wet[i] / s->width[i],
+				s->swcBulk_min[i] / s->width[i], s->swcBulk_init[i] / s->width[i], s->swcBulk_saturated[i] / s->width[i],
+				s->impermeability[i]);
 
 	}
 	LogError(logfp, LOGNOTE, "\n  Actual per-layer values:\n");
@@ -1327,10 +1567,10 @@ void _echo_inputs(void) {
 
 	ForEachSoilLayer(i)
 	{
-		LogError(logfp, LOGNOTE, "  %3d %5.1f %9.5f %6.2f %8.5f %8.5f %6.2f %6.2f %7.4f %7.4f %7.4f %7.4f %7.4f %7.4f %8.4f %7.4f %5.4f\n", i + 1, s->lyr[i]->width,
-				s->lyr[i]->soilBulk_density, s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_fieldcap, s->lyr[i]->swcBulk_wiltpt, s->lyr[i]->fractionWeightMatric_sand,
-				s->lyr[i]->fractionWeightMatric_clay, s->lyr[i]->swcBulk_atSWPcrit[SW_FORBS], s->lyr[i]->swcBulk_atSWPcrit[SW_TREES], s->lyr[i]->swcBulk_atSWPcrit[SW_SHRUB],
-				s->lyr[i]->swcBulk_atSWPcrit[SW_GRASS], s->lyr[i]->swcBulk_wet, s->lyr[i]->swcBulk_min, s->lyr[i]->swcBulk_init, s->lyr[i]->swcBulk_saturated, s->lyr[i]->sTemp);
+		LogError(logfp, LOGNOTE, "  %3d %5.1f %9.5f %6.2f %8.5f %8.5f %6.2f %6.2f %7.4f %7.4f %7.4f %7.4f %7.4f %7.4f %8.4f %7.4f %5.4f\n", i + 1, s->width[i],
+				s->soilBulk_density[i], s->fractionVolBulk_gravel[i], s->swcBulk_fieldcap[i], s->swcBulk_wiltpt[i], s->fractionWeightMatric_sand[i],
+				s->fractionWeightMatric_clay[i], s->swcBulk_atSWPcrit[SW_FORBS][i], s->swcBulk_atSWPcrit[SW_TREES][i], s->swcBulk_atSWPcrit[SW_SHRUB][i],
+				s->swcBulk_atSWPcrit[SW_GRASS][i], s->swcBulk_wet[i], s->swcBulk_min[i], s->swcBulk_init[i], s->swcBulk_saturated[i], s->sTemp[i]);
 	}
 
 	LogError(logfp, LOGNOTE, "\n  Water Potential values:\n");
@@ -1343,15 +1583,15 @@ void _echo_inputs(void) {
 	ForEachSoilLayer(i)
 	{
 		LogError(logfp, LOGNOTE, "  %3d   %15.4f   %15.4f  %15.4f %15.4f  %15.4f  %15.4f  %15.4f   %15.4f   %15.4f\n", i + 1,
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_fieldcap, i),
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_wiltpt, i),
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_atSWPcrit[SW_FORBS], i),
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_atSWPcrit[SW_TREES], i),
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_atSWPcrit[SW_SHRUB], i),
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_atSWPcrit[SW_GRASS], i),
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_wet, i),
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_min, i),
-				SW_SWCbulk2SWPmatric(s->lyr[i]->fractionVolBulk_gravel, s->lyr[i]->swcBulk_init, i));
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_fieldcap[i], i),
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_wiltpt[i], i),
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_atSWPcrit[SW_FORBS][i], i),
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_atSWPcrit[SW_TREES][i], i),
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_atSWPcrit[SW_SHRUB][i], i),
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_atSWPcrit[SW_GRASS][i], i),
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_wet[i], i),
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_min[i], i),
+				SW_SWCbulk2SWPmatric(s->fractionVolBulk_gravel[i], s->swcBulk_init[i], i));
 
 	}
 
@@ -1372,12 +1612,7 @@ void SW_SIT_SetMemoryRefs( void) {
 	 this, and will be checked via CheckMemoryRefs() after
 	 this, most likely in the main() function.
 	 */
-	LyrIndex l;
-
-	NoteMemoryRef(SW_Site.lyr);
-	ForEachSoilLayer(l) {
-		NoteMemoryRef(SW_Site.lyr[l]);
-	}
+	// soil layers are stored in fixed-size arrays of `SW_Site`
 }
 
 #endif
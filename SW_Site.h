@@ -41,6 +41,12 @@
  						due to the renaming, also had to update the use of these variables in the other files.
 	07/09/2013	(clk)	added the variables transp_coeff[SW_FORBS], swcBulk_atSWPcrit[SW_FORBS], and my_transp_rgn[SW_FORBS] to SW_LAYER_INFO
 	07/09/2013	(clk)	added the variable n_transp_lyrs_forb to SW_SITE
+	2026-10-14 soil layer properties are stored in SW_SITE as one array per property
+						(structure of arrays) instead of one SW_LAYER_INFO struct per layer;
+						SW_LAYER_INFO remains as a copy of one layer, see SW_SIT_get_layer()
+	2026-10-14 added per-layer constants of the soil water retention curve
+						(swrc_theta_scale, swrc_psis_bar)
+	2026-10-14 added stMethod to select the solver of the soil temperature profile
 */
 /********************************************************/
 /********************************************************/
@@ -56,6 +62,8 @@ extern "C" {
 
 typedef unsigned int LyrIndex;
 
+/** Properties of one soil layer: a copy of the per-layer arrays of
+    `SW_SITE`, see `SW_SIT_get_layer()` and `SW_SIT_set_layer()` */
 typedef struct {
 	/* bulk = relating to the whole soil, i.e., matric + rock/gravel/coarse fragments */
 	/* matric = relating to the < 2 mm fraction of the soil, i.e., sand, clay, and silt */
@@ -132,15 +140,47 @@ typedef struct {
 		percentRunoff,	/* the percentage of surface water lost daily */
 		percentRunon;	/* the percentage of water that is added to surface gained daily */
 
-	unsigned int stNRGR; /* number of interpolations, for the soil_temperature function */
+	unsigned int stNRGR, /* number of interpolations, for the soil_temperature function */
+		stMethod; /* solver of the soil_temperature function: SW_STMETHOD_EXPLICIT or SW_STMETHOD_CRANKNICOLSON */
 	/* params for tanfunc rate calculations for evap and transp. */
 	/* tanfunc() creates a logistic-type graph if shift is positive,
 	 * the graph has a negative slope, if shift is 0, slope is positive.
 	 */
 	tanfunc_t evap, transp;
 
-	SW_LAYER_INFO **lyr; 	/* one struct per soil layer pointed to by   */
-							/* a dynamically allocated block of pointers */
+	/* Soil layers: one contiguous array per property, indexed by layer
+	   (see SW_LAYER_INFO for a description of each property) */
+	/* Inputs */
+	RealD width[MAX_LAYERS],
+		soilMatric_density[MAX_LAYERS],
+		evap_coeff[MAX_LAYERS],
+		transp_coeff[NVEGTYPES][MAX_LAYERS],
+		fractionVolBulk_gravel[MAX_LAYERS],
+		fractionWeightMatric_sand[MAX_LAYERS],
+		fractionWeightMatric_clay[MAX_LAYERS],
+		impermeability[MAX_LAYERS],
+		sTemp[MAX_LAYERS],
+
+	/* Derived soil characteristics */
+		soilBulk_density[MAX_LAYERS],
+		swcBulk_fieldcap[MAX_LAYERS],
+		swcBulk_wiltpt[MAX_LAYERS],
+		swcBulk_min[MAX_LAYERS],
+		swcBulk_wet[MAX_LAYERS],
+		swcBulk_init[MAX_LAYERS],
+		swcBulk_atSWPcrit[NVEGTYPES][MAX_LAYERS],
+		swcBulk_saturated[MAX_LAYERS],
+		thetasMatric[MAX_LAYERS],
+		psisMatric[MAX_LAYERS],
+		bMatric[MAX_LAYERS],
+		binverseMatric[MAX_LAYERS],
+
+	/* Soil water retention curve: per-layer constants derived by `water_eqn()`
+	   for `SW_SWCbulk2SWPmatric_profile()` */
+		swrc_theta_scale[MAX_LAYERS], /* 100 / (width * (1 - gravel) * thetasMatric) */
+		swrc_psis_bar[MAX_LAYERS]; /* psisMatric / BARCONV */
+
+	LyrIndex my_transp_rgn[NVEGTYPES][MAX_LAYERS];
 
 } SW_SITE;
 
@@ -161,6 +201,8 @@ void _echo_inputs(void);
 void SW_SIT_clear_layers(void);
 LyrIndex _newlayer(void);
 void add_deepdrain_layer(void);
+void SW_SIT_get_layer(LyrIndex n, SW_LAYER_INFO *lyr);
+void SW_SIT_set_layer(LyrIndex n, const SW_LAYER_INFO *lyr);
 
 void set_soillayers(LyrIndex nlyrs, RealF *dmax, RealF *matricd, RealF *f_gravel,
   RealF *evco, RealF *trco_grass, RealF *trco_shrub, RealF *trco_tree,
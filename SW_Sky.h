@@ -11,6 +11,7 @@
 	01/12/2010	(drs) removed pressure (used for snow sublimation)
 	08/22/2011	(drs) added monthly parameter 'snow_density' to struct SW_SKY to estimate snow depth
 	09/26/2011	(drs) added a daily variable for each monthly input in struct SW_SKY: RealD cloudcov_daily, windspeed_daily, r_humidity_daily, transmission_daily, snow_density_daily each of [MAX_DAYS]
+	10/14/2026	added 'daily_inputs' so that daily values are only recalculated if their inputs change
 */
 /********************************************************/
 /********************************************************/
@@ -25,6 +26,16 @@ extern "C" {
 #endif
 
 
+/* inputs from which SW_SKY_new_year() interpolates the daily values */
+typedef struct {
+    RealD cloudcov     [MAX_MONTHS],
+          windspeed    [MAX_MONTHS],
+          r_humidity   [MAX_MONTHS],
+          snow_density [MAX_MONTHS];
+    Bool leapyear, /* calendar of the interpolation */
+         is_set; /* swTRUE if the daily values correspond to these inputs */
+} SW_SKY_DAILY_INPUTS;
+
 typedef struct {
     RealD cloudcov     [MAX_MONTHS], /* monthly cloud cover (frac) */
           windspeed    [MAX_MONTHS], /* windspeed (m/s) */
@@ -37,6 +48,8 @@ typedef struct {
           r_humidity_daily   [MAX_DAYS+1], /* interpolated daily relative humidity (%) */
           snow_density_daily	[MAX_DAYS+1];	/* interpolated daily snow density (kg/m3) */
 
+    SW_SKY_DAILY_INPUTS daily_inputs; /* inputs of the current daily values */
+
 } SW_SKY;
 
 void SW_SKY_read(void);
@@ -29,6 +29,13 @@
  06/24/2013	(rjm)	made temp_snow a module-level static variable (instead of function-level): otherwise it will not get reset to 0 between consecutive calls as a dynamic library
  need to set temp_snow to 0 in function SW_SWC_construct()
  06/26/2013	(rjm)	closed open files at end of functions SW_SWC_read(), _read_hist() or if LogError() with LOGFATAL is called
+ 2026-10-14 soil temperature of today and yesterday is double-buffered and swapped by SW_SWC_end_day()
+ 2026-10-15 SW_SWC_read() and _read_swc_hist() read with SW_TEXTFILE and Str_Scan()
+ 2026-10-15 historical swc is stored only for days with measurements and is read from a
+   binary store `[swc prefix].bin` if present, see SW_SoilWater_store.c
+ 2026-10-15 SW_WaterBalance_Checks() keeps yesterday's surface water in SW_Soilwat (reentrant);
+   runs without SWDEBUG are checked by the water balance monitor of SW_Water_Flow()
+ 2026-10-15 added SW_SWC_water_flow_part(): the water flow of a day in parts (see SW_Flow.c)
  */
 /********************************************************/
 /********************************************************/
@@ -51,6 +58,8 @@
 #include "SW_Flow.h"
 #include "SW_SoilWater.h"
 #include "SW_VegProd.h"
+#include "SW_SoilWater_store.h"
+#include "SW_Run.h"
 #ifdef SWDEBUG
   #include "SW_Weather.h"
 #endif
@@ -63,24 +72,19 @@
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
 
-extern SW_MODEL SW_Model;
-extern SW_SITE SW_Site;
-extern SW_VEGPROD SW_VegProd;
 #ifdef RSOILWAT
 	extern Bool useFiles;
 #endif
 
-SW_SOILWAT SW_Soilwat; /* declared here, externed elsewhere */
 #ifdef SWDEBUG
-  extern SW_WEATHER SW_Weather;
 #endif
 
 
 /* =================================================== */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
-static char *MyFileName;
-static RealD temp_snow;
+static SW_THREAD_LOCAL char *MyFileName;
+#define temp_snow (SW_CurrentRun->temp_snow)
 
 
 /* =================================================== */
@@ -88,16 +92,16 @@ static RealD temp_snow;
 /*             Private Function Definitions            */
 /* --------------------------------------------------- */
 
-static void _clear_hist(void) {
-	/* --------------------------------------------------- */
-	TimeInt d;
-	LyrIndex z;
-	for (d = 0; d < MAX_DAYS; d++) {
-		for(z=0; z<MAX_LAYERS; z++)
-		{
-			SW_Soilwat.hist.swc[d][z] = SW_MISSING;
-			SW_Soilwat.hist.std_err[d][z] = SW_MISSING;
-		}
+/* load the historical swc measurements of a year from the binary store
+   or, if there is none, from the text file of the year */
+static void _new_year_swc_hist(TimeInt year) {
+	Bool found = SW_SWC_store_is_open() ?
+		SW_SWC_read_store(year) :
+		_read_swc_hist(year);
+
+	if (!found) {
+		LogError(logfp, LOGWARN, "Historical SWC of %d not found (%s).",
+			year, SW_Soilwat.hist.file_prefix);
 	}
 }
 
@@ -107,7 +111,7 @@ static void _reset_swc(void) {
 	/* reset swc */
 	ForEachSoilLayer(lyr)
 	{
-		SW_Soilwat.swcBulk[Today][lyr] = SW_Soilwat.swcBulk[Yesterday][lyr] = SW_Site.lyr[lyr]->swcBulk_init;
+		SW_Soilwat.swcBulk[Today][lyr] = SW_Soilwat.swcBulk[Yesterday][lyr] = SW_Site.swcBulk_init[lyr];
 		SW_Soilwat.drain[lyr] = 0.;
 	}
 
@@ -142,14 +146,12 @@ void SW_WaterBalance_Checks(void)
     delta_swc_total = 0., delta_swcj[MAX_LAYERS];
   RealD lhs, rhs, wbtol = 1e-9;
 
-  static RealD surfaceWater_yesterday;
-  static Bool debug = swFALSE;
+  Bool debug = swFALSE;
 
 
-  // re-init static variables on first day of each simulation
-  // to prevent carry-over
+  // re-init on first day of each simulation to prevent carry-over
   if (SW_Model.year == SW_Model.startyr && SW_Model.doy == SW_Model.firstdoy) {
-    surfaceWater_yesterday = 0.;
+    sw->surfaceWater_yesterday = 0.;
   }
 
   // Sum up variables
@@ -206,15 +208,13 @@ void SW_WaterBalance_Checks(void)
   // Get state change values
   intercepted = sw->litter_int + int_veg_total;
 
-  delta_surfaceWater = sw->surfaceWater - surfaceWater_yesterday;
-  surfaceWater_yesterday = sw->surfaceWater;
+  delta_surfaceWater = sw->surfaceWater - sw->surfaceWater_yesterday;
+  sw->surfaceWater_yesterday = sw->surfaceWater;
 
 
   //--- Water balance checks (there are # checks n = N_WBCHECKS)
-  if (!sw->is_wbError_init) {
-    for (i = 0; i < N_WBCHECKS; i++) {
-      debug = (debug || debugi[i])? swTRUE: swFALSE;
-    }
+  for (i = 0; i < N_WBCHECKS; i++) {
+    debug = (debug || debugi[i])? swTRUE: swFALSE;
   }
 
   if (debug) {
@@ -331,6 +331,61 @@ void SW_WaterBalance_Checks(void)
 }
 #endif
 
+/* set today's swc to the historical (measured) data if available;
+   returns swTRUE if these replace today's water flow */
+static Bool water_flow_hist(void) {
+	const SW_SOILWAT_HIST_DAY *obs;
+  #ifdef SWDEBUG
+  int debug = 0;
+  #endif
+
+	/* if there's no swc observation for today,
+	 * it shows up as SW_MISSING.  The input must
+	 * define historical swc for at least the top
+	 * layer to be recognized.
+	 * IMPORTANT: swc can't be adjusted on day 1 of first year of simulation.
+	 10/25/2010	(drs)	in SW_SWC_water_flow(): replaced test that "swc can't be adjusted on day 1 of year 1" to "swc can't be adjusted on start day of first year of simulation"
+	 */
+
+	if (SW_Soilwat.hist_use && !isnull(obs = SW_SWC_hist_day(SW_Model.doy)) &&
+		!missing(obs->swc[1])) {
+
+		if (!(SW_Model.doy == SW_Model.startstart && SW_Model.year == SW_Model.startyr)) {
+
+      #ifdef SWDEBUG
+      if (debug) swprintf("\n'SW_SWC_water_flow': adjust SWC from historic inputs.\n");
+      #endif
+      SW_SWC_adjust_swc(SW_Model.doy);
+
+		} else {
+			LogError(logfp, LOGWARN, "Attempt to set SWC on start day of first year of simulation disallowed.");
+		}
+
+		return swTRUE;
+	}
+
+	return swFALSE;
+}
+
+/* check the water balance (SWDEBUG) and which soil layers are wet
+   after today's water flow */
+static void water_flow_end(void) {
+	LyrIndex i;
+  #ifdef SWDEBUG
+  int debug = 0;
+
+  if (debug) swprintf("\n'SW_SWC_water_flow': check water balance.\n");
+  SW_WaterBalance_Checks();
+
+  if (debug) swprintf("\n'SW_SWC_water_flow': determine wet soil layers.\n");
+  #endif
+	if (use_Derived[eSW_DerivedWetDays]) {
+		ForEachSoilLayer(i)
+			SW_Soilwat.is_wet[i] = (Bool) (GE( SW_Soilwat.swcBulk[Today][i],
+					SW_Site.swcBulk_wet[i]));
+	}
+}
+
 
 /* =================================================== */
 /* =================================================== */
@@ -350,9 +405,17 @@ void SW_SWC_construct(void) {
 		SW_Soilwat.hist.file_prefix = NULL;
 	}
 
+	if (!isnull(SW_Soilwat.hist.days)) {
+		Mem_Free(SW_Soilwat.hist.days);
+		SW_Soilwat.hist.days = NULL;
+	}
+
 	// Clear the module structure:
 	memset(&SW_Soilwat, 0, sizeof(SW_SOILWAT));
 
+	SW_Soilwat.sTemp = SW_Soilwat.sTemp_days[Today];
+	SW_Soilwat.sTemp_yesterday = SW_Soilwat.sTemp_days[Yesterday];
+
 	// Allocate output structures:
 	ForEachOutPeriod(pd)
 	{
@@ -388,10 +451,13 @@ void SW_SWC_deconstruct(void)
 		SW_Soilwat.hist.file_prefix = NULL;
 	}
 
-	if (!isnull(SW_Soilwat.hist.file_prefix)) {
-		Mem_Free(SW_Soilwat.hist.file_prefix);
-		SW_Soilwat.hist.file_prefix = NULL;
+	if (!isnull(SW_Soilwat.hist.days)) {
+		Mem_Free(SW_Soilwat.hist.days);
+		SW_Soilwat.hist.days = NULL;
 	}
+	SW_Soilwat.hist.n_days = SW_Soilwat.hist.n_alloc = 0;
+
+	SW_SWC_close_store();
 
 	#ifdef SWDEBUG
 	IntU i;
@@ -410,51 +476,47 @@ void SW_SWC_deconstruct(void)
     water flow, and check if swc is above threshold for "wet" condition.
 */
 void SW_SWC_water_flow(void) {
-	/* =================================================== */
-
-
-	LyrIndex i;
   #ifdef SWDEBUG
   int debug = 0;
   #endif
 
-	/* if there's no swc observation for today,
-	 * it shows up as SW_MISSING.  The input must
-	 * define historical swc for at least the top
-	 * layer to be recognized.
-	 * IMPORTANT: swc can't be adjusted on day 1 of first year of simulation.
-	 10/25/2010	(drs)	in SW_SWC_water_flow(): replaced test that "swc can't be adjusted on day 1 of year 1" to "swc can't be adjusted on start day of first year of simulation"
-	 */
-
-	if (SW_Soilwat.hist_use && !missing( SW_Soilwat.hist.swc[SW_Model.doy-1][1])) {
-
-		if (!(SW_Model.doy == SW_Model.startstart && SW_Model.year == SW_Model.startyr)) {
-
-      #ifdef SWDEBUG
-      if (debug) swprintf("\n'SW_SWC_water_flow': adjust SWC from historic inputs.\n");
-      #endif
-      SW_SWC_adjust_swc(SW_Model.doy);
-
-		} else {
-			LogError(logfp, LOGWARN, "Attempt to set SWC on start day of first year of simulation disallowed.");
-		}
-
-	} else {
+	if (!water_flow_hist()) {
     #ifdef SWDEBUG
     if (debug) swprintf("\n'SW_SWC_water_flow': call 'SW_Water_Flow'.\n");
     #endif
+		SW_BENCH_START(eBenchWaterFlow);
+		SW_PROFILE_START(eProfWaterFlow);
 		SW_Water_Flow();
+		SW_PROFILE_STOP(eProfWaterFlow);
+		SW_BENCH_STOP(eBenchWaterFlow);
 	}
 
-  #ifdef SWDEBUG
-  if (debug) swprintf("\n'SW_SWC_water_flow': check water balance.\n");
-  SW_WaterBalance_Checks();
+	water_flow_end();
+}
 
-  if (debug) swprintf("\n'SW_SWC_water_flow': determine wet soil layers.\n");
-  #endif
-	ForEachSoilLayer(i)
-		SW_Soilwat.is_wet[i] = (Bool) (GE( SW_Soilwat.swcBulk[Today][i],
-				SW_Site.lyr[i]->swcBulk_wet));
+/**
+@brief One part of `SW_SWC_water_flow()`, see `SW_FLW_water_flow_part()`
+
+The water flow of a day is replaced by historical (measured) data in
+part `0` if available; then, the other parts do nothing.
+
+@param part Part of today's water flow, `0` to `SW_FLW_NPARTS - 1`.
+*/
+void SW_SWC_water_flow_part(unsigned int part) {
+
+	if ((0 == part && !water_flow_hist()) ||
+		(part > 0 && SW_CurrentRun->Flow.day.flowing)) {
+
+		SW_BENCH_START(eBenchWaterFlow);
+		SW_PROFILE_START(eProfWaterFlow);
+		SW_FLW_water_flow_part(part);
+		SW_PROFILE_STOP(eProfWaterFlow);
+		SW_BENCH_STOP(eBenchWaterFlow);
+	}
+
+	if (SW_FLW_NPARTS - 1 == part) {
+		water_flow_end();
+	}
 }
 
 /**
@@ -475,7 +537,7 @@ void calculate_repartitioned_soilwater(void){
     val = v->swcBulk[Today][i];
     ForEachVegType(j){
       if(SW_VegProd.veg[j].cov.fCover != 0)
-        v->swa_master[j][j][i] = fmax(0., val - SW_Site.lyr[i]->swcBulk_atSWPcrit[j]);
+        v->swa_master[j][j][i] = fmax(0., val - SW_Site.swcBulk_atSWPcrit[j][i]);
       else
         v->swa_master[j][j][i] = 0.;
       v->dSWA_repartitioned_sum[j][i] = 0.; // need to reset to 0 each time
@@ -634,17 +696,26 @@ void get_dSWAbulk(int i){
 }
 /**
 @brief Copies today's values so that the values for swcBulk and snowpack become yesterday's values.
+
+Soil temperature is swapped rather than copied because `soil_temperature()`
+writes all of today's values from yesterday's values. The water flow
+updates swcBulk in place starting from yesterday's values, i.e.,
+today's values must be copied.
 */
 void SW_SWC_end_day(void) {
 	/* =================================================== */
 	SW_SOILWAT *v = &SW_Soilwat;
 	LyrIndex i;
+	RealD *tmp;
 
 	ForEachSoilLayer(i)
 		v->swcBulk[Yesterday][i] = v->swcBulk[Today][i];
 
 	v->snowpack[Yesterday] = v->snowpack[Today];
 
+	tmp = v->sTemp_yesterday;
+	v->sTemp_yesterday = v->sTemp;
+	v->sTemp = tmp;
 }
 
 void SW_SWC_init_run(void) {
@@ -686,10 +757,10 @@ void SW_SWC_new_year(void) {
 	/* update historical (measured) values, if needed */
 	if (SW_Soilwat.hist_use && year >= SW_Soilwat.hist.yr.first) {
 		#ifndef RSOILWAT
-			_read_swc_hist(year);
+			_new_year_swc_hist(year);
 		#else
 			if (useFiles) {
-				_read_swc_hist(year);
+				_new_year_swc_hist(year);
 			} else {
 				onSet_SW_SWC_hist();
 			}
@@ -710,59 +781,69 @@ void SW_SWC_read(void) {
 	 */
 
 	SW_SOILWAT *v = &SW_Soilwat;
-	FILE *f;
+	SW_TEXTFILE f;
 	int lineno = 0, nitems = 4;
+	char fname[MAX_FILENAMESIZE];
 // gets the soil temperatures from where they are read in the SW_Site struct for use later
 // SW_Site.c must call it's read function before this, or it won't work
 	v->surfaceTemp = 0;
 	LyrIndex i;
 	ForEachSoilLayer(i)
-		v->sTemp[i] = SW_Site.lyr[i]->sTemp;
+		v->sTemp[i] = v->sTemp_yesterday[i] = SW_Site.sTemp[i];
 
 	MyFileName = SW_F_name(eSoilwat);
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
 
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 		switch (lineno) {
 		case 0:
-			v->hist_use = (atoi(inbuf)) ? swTRUE : swFALSE;
+			v->hist_use = (atoi(f.line)) ? swTRUE : swFALSE;
 			break;
 		case 1:
-			v->hist.file_prefix = (char *) Str_Dup(inbuf);
+			v->hist.file_prefix = (char *) Str_Dup(f.line);
 			break;
 		case 2:
-			v->hist.yr.first = yearto4digit(atoi(inbuf));
+			v->hist.yr.first = yearto4digit(atoi(f.line));
 			break;
 		case 3:
-			v->hist.method = atoi(inbuf);
+			v->hist.method = atoi(f.line);
 			break;
 		}
 		lineno++;
 	}
 	if(!v->hist_use) {
-		CloseFile(&f);
+		CloseTextFile(&f);
 		return;
 	}
 	if (lineno < nitems) {
-		CloseFile(&f);
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "%s : Insufficient parameters specified.", MyFileName);
 	}
 	if (v->hist.method < 1 || v->hist.method > 2) {
-		CloseFile(&f);
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "%s : Invalid swc adjustment method.", MyFileName);
 	}
 	v->hist.yr.last = SW_Model.endyr;
 	v->hist.yr.total = v->hist.yr.last - v->hist.yr.first + 1;
-	CloseFile(&f);
+	CloseTextFile(&f);
+
+	// use the binary store instead of text files if there is one
+	SW_SWC_store_name(fname, v->hist.file_prefix);
+	SW_SWC_open_store(fname);
 }
 
 /**
 @brief Read a file containing historical swc measurements.  Enter a year with a four
       digit year number.  This is appended to the swc prefix to make the input file name.
 
+Measurements of days and layers that are not in the file are missing
+(`SW_MISSING`); the previous values are kept if there is no file.
+
 @param year Four digit number for desired year, measured in years.
+
+@return `swTRUE`/`swFALSE` if the file of `year` was/was not found.
 */
-void _read_swc_hist(TimeInt year) {
+Bool _read_swc_hist(TimeInt year) {
 	/* =================================================== */
 	/* read a file containing historical swc measurements.
 	 * Enter with year a four digit year number.  This is
@@ -792,7 +873,8 @@ void _read_swc_hist(TimeInt year) {
 	 * cause problems in the flow model.
 	 */
 	SW_SOILWAT *v = &SW_Soilwat;
-	FILE *f;
+	SW_SOILWAT_HIST_DAY *obs;
+	SW_TEXTFILE f;
 	int x, lyr, recno = 0, doy;
 	RealF swc, st_err;
 	char fname[MAX_FILENAMESIZE];
@@ -800,39 +882,122 @@ void _read_swc_hist(TimeInt year) {
 	sprintf(fname, "%s.%4d", v->hist.file_prefix, year);
 
 	if (!FileExists(fname)) {
-		LogError(logfp, LOGWARN, "Historical SWC file %s not found.", fname);
-		return;
+		return swFALSE;
 	}
 
-	f = OpenFile(fname, "r");
+	OpenTextFile(&f, fname);
 
-	_clear_hist();
+	_clear_hist_swc();
 
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 		recno++;
-		x = sscanf(inbuf, "%d %d %f %f", &doy, &lyr, &swc, &st_err);
+		x = Str_Scan(f.line, "%d %d %f %f", &doy, &lyr, &swc, &st_err);
 		if (x < 4) {
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s : Incomplete layer data at record %d\n   Should be DOY LYR SWC STDERR.", fname, recno);
 		}
 		if (x > 4) {
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s : Too many input fields at record %d\n   Should be DOY LYR SWC STDERR.", fname, recno);
 		}
 		if (doy < 1 || doy > MAX_DAYS) {
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s : Day of year out of range at record %d", fname, recno);
 		}
 		if (lyr < 1 || lyr > MAX_LAYERS) {
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s : Layer number out of range (%d > %d), record %d\n", fname, lyr, MAX_LAYERS, recno);
 		}
 
-		v->hist.swc[doy - 1][lyr - 1] = swc;
-		v->hist.std_err[doy - 1][lyr - 1] = st_err;
+		obs = SW_SWC_hist_add_day(doy);
+		obs->swc[lyr - 1] = swc;
+		obs->std_err[lyr - 1] = st_err;
 
 	}
-	CloseFile(&f);
+	CloseTextFile(&f);
+
+	return swTRUE;
+}
+
+
+/**
+@brief Remove all historical swc measurements of the current year
+*/
+void _clear_hist_swc(void) {
+	SW_SOILWAT_HIST *h = &SW_Soilwat.hist;
+
+	memset(h->row, 0, sizeof h->row);
+	h->n_days = 0;
+}
+
+
+/**
+@brief Allocate space for historical swc measurements of (at least)
+  `n_days` days; the measurements of the current year are kept.
+
+@param n_days Number of days with measurements.
+*/
+void SW_SWC_hist_reserve(TimeInt n_days) {
+	SW_SOILWAT_HIST *h = &SW_Soilwat.hist;
+	TimeInt n_alloc = max(h->n_alloc, 32);
+
+	if (n_days <= h->n_alloc) {
+		return;
+	}
+
+	while (n_alloc < n_days) {
+		n_alloc *= 2;
+	}
+
+	h->days = (SW_SOILWAT_HIST_DAY *) (isnull(h->days) ?
+		Mem_Malloc(n_alloc * sizeof(SW_SOILWAT_HIST_DAY), "SW_SWC_hist_reserve()") :
+		Mem_ReAlloc(h->days, n_alloc * sizeof(SW_SOILWAT_HIST_DAY)));
+	h->n_alloc = n_alloc;
+}
+
+
+/**
+@brief Historical swc measurements of a day of the current year that can be set
+
+@param doy Day of year (base1).
+
+@return The measurements of `doy`; all values of a day without previous
+  measurements are missing (`SW_MISSING`).
+*/
+SW_SOILWAT_HIST_DAY *SW_SWC_hist_add_day(TimeInt doy) {
+	SW_SOILWAT_HIST *h = &SW_Soilwat.hist;
+	SW_SOILWAT_HIST_DAY *obs;
+	LyrIndex z;
+
+	if (h->row[doy - 1] > 0) {
+		return h->days + h->row[doy - 1] - 1;
+	}
+
+	SW_SWC_hist_reserve(h->n_days + 1);
+	obs = h->days + h->n_days;
+
+	for (z = 0; z < MAX_LAYERS; z++) {
+		obs->swc[z] = SW_MISSING;
+		obs->std_err[z] = SW_MISSING;
+	}
+
+	h->row[doy - 1] = ++h->n_days;
+
+	return obs;
+}
+
+
+/**
+@brief Historical swc measurements of a day of the current year
+
+@param doy Day of year (base1).
+
+@return The measurements of `doy` or `NULL` if the day has no measurements.
+*/
+const SW_SOILWAT_HIST_DAY *SW_SWC_hist_day(TimeInt doy) {
+	SW_SOILWAT_HIST *h = &SW_Soilwat.hist;
+
+	return (h->row[doy - 1] > 0) ? h->days + h->row[doy - 1] - 1 : NULL;
 }
 
 /**
@@ -846,15 +1011,19 @@ void SW_SWC_adjust_swc(TimeInt doy) {
 	 */
 
 	SW_SOILWAT *v = &SW_Soilwat;
+	const SW_SOILWAT_HIST_DAY *obs = SW_SWC_hist_day(doy);
 	RealD lower, upper;
 	LyrIndex lyr;
-	TimeInt dy = doy - 1;
+
+	if (isnull(obs)) {
+		return;
+	}
 
 	switch (SW_Soilwat.hist.method) {
 	case SW_Adjust_Avg:
 		ForEachSoilLayer(lyr)
 		{
-			v->swcBulk[Today][lyr] += v->hist.swc[dy][lyr];
+			v->swcBulk[Today][lyr] += obs->swc[lyr];
 			v->swcBulk[Today][lyr] /= 2.;
 		}
 		break;
@@ -862,8 +1031,8 @@ void SW_SWC_adjust_swc(TimeInt doy) {
 	case SW_Adjust_StdErr:
 		ForEachSoilLayer(lyr)
 		{
-			upper = v->hist.swc[dy][lyr] + v->hist.std_err[dy][lyr];
-			lower = v->hist.swc[dy][lyr] - v->hist.std_err[dy][lyr];
+			upper = obs->swc[lyr] + obs->std_err[lyr];
+			lower = obs->swc[lyr] - obs->std_err[lyr];
 			if (GT(v->swcBulk[Today][lyr], upper))
 				v->swcBulk[Today][lyr] = upper;
 			else if (LT(v->swcBulk[Today][lyr], lower))
@@ -878,7 +1047,7 @@ void SW_SWC_adjust_swc(TimeInt doy) {
 	/* this will guarantee that any method will not lower swc */
 	/* below the minimum defined for the soil layers          */
 	ForEachSoilLayer(lyr){
-		v->swcBulk[Today][lyr] = fmax(v->swcBulk[Today][lyr], SW_Site.lyr[lyr]->swcBulk_min);
+		v->swcBulk[Today][lyr] = fmax(v->swcBulk[Today][lyr], SW_Site.swcBulk_min[lyr]);
   }
 
 }
@@ -1016,7 +1185,7 @@ RealD SW_SnowDepth(RealD SWE, RealD snowdensity) {
 
   @param fractionGravel Fraction of soil containing gravel.
   @param swcBulk Soilwater content of the current layer (cm/layer)
-  @param n Layer number to index the **lyr pointer
+  @param n Soil layer index (base0) of the properties in `SW_Site`
 
   @return soil water potential
 **/
@@ -1035,7 +1204,7 @@ HISTORY:
     and the previous limit of swp to 80 seems unreasonable.
     return 0.0 if input value is MISSING
 
-   These are the values for each layer obtained via lyr[n]:
+   These are the values for each layer obtained from `SW_Site` for layer n:
 	 width  - width of current soil layer
 	 psisMatric   - "saturation" matric potential
 	 thetasMatric - saturated moisture content.
@@ -1054,7 +1223,6 @@ HISTORY:
 	 psisMatric, bMatric, binverseMatric, thetasMatric are initialized
 	 **********************************************************************/
 
-	SW_LAYER_INFO *lyr = SW_Site.lyr[n];
 	RealD theta1, theta2, swp = .0;
 
 	if (missing(swcBulk) || ZRO(swcBulk))
@@ -1064,17 +1232,17 @@ HISTORY:
 		// we have soil moisture
 
 		// calculate matric VWC [cm / cm %] from bulk VWC
-		theta1 = (swcBulk / lyr->width) * 100. / (1. - fractionGravel);
+		theta1 = (swcBulk / SW_Site.width[n]) * 100. / (1. - fractionGravel);
 
 		// calculate (VWC / VWC(saturated)) ^ b
-		theta2 = powe(theta1 / lyr->thetasMatric, lyr->bMatric);
+		theta2 = powe(theta1 / SW_Site.thetasMatric[n], SW_Site.bMatric[n]);
 
 		if (isnan(theta2) || ZRO(theta2)) {
 			LogError(logfp, LOGFATAL, "SW_SWCbulk2SWPmatric(): Year = %d, DOY=%d, Layer = %d:\n"
 					"\tinvalid value of (theta / theta(saturated)) ^ b = %f (must be != 0)\n",
 					SW_Model.year, SW_Model.doy, n, theta2);
 		} else {
-			swp = lyr->psisMatric / theta2 / BARCONV;
+			swp = SW_Site.psisMatric[n] / theta2 / BARCONV;
 		}
 
 	} else {
@@ -1085,11 +1253,103 @@ HISTORY:
 	return swp;
 }
 
+
+/** Soil water potential of layers `first` to `last - 1`,
+    see `SW_SWCbulk2SWPmatric_profile()` */
+static void swcBulk2swpMatric_layers(const RealD swcBulk[], RealD swpMatric[],
+	LyrIndex first, LyrIndex last) {
+
+	const RealD
+		*scale = SW_Site.swrc_theta_scale,
+		*psis = SW_Site.swrc_psis_bar,
+		*b = SW_Site.bMatric;
+	LyrIndex i;
+
+	for (i = first; i < last; i++) {
+		if (!missing(swcBulk[i]) && !ZRO(swcBulk[i]) && !GT(swcBulk[i], 0.)) {
+			LogError(logfp, LOGFATAL, "Invalid SWC value (%.4f) in SW_SWC_swc2potential.\n"
+				"    Year = %d, DOY=%d, Layer = %d\n",
+				swcBulk[i], SW_Model.year, SW_Model.doy, i);
+		}
+	}
+
+	// loop without function calls other than math: candidate for vectorization
+	for (i = first; i < last; i++) {
+		swpMatric[i] = (missing(swcBulk[i]) || ZRO(swcBulk[i])) ?
+			0. :
+			psis[i] / powe(swcBulk[i] * scale[i], b[i]);
+	}
+
+	for (i = first; i < last; i++) {
+		if (!isfinite(swpMatric[i])) {
+			LogError(logfp, LOGFATAL, "SW_SWCbulk2SWPmatric_profile(): Year = %d, DOY=%d, Layer = %d:\n"
+				"\tinvalid value of (theta / theta(saturated)) ^ b (must be != 0)\n",
+				SW_Model.year, SW_Model.doy, i);
+		}
+	}
+}
+
+
+/**
+  @brief Calculates the soil water potential of a soil water profile, i.e.,
+    of the first `n_layers` soil layers in one call.
+
+  Equivalent to calling `SW_SWCbulk2SWPmatric()` for each layer with the
+  layer's gravel content, but uses the per-layer constants of `SW_Site`
+  that are derived by `water_eqn()` (`swrc_theta_scale`, `swrc_psis_bar`)
+  and thus may differ from it in the last digits.
+
+  @param[in] swcBulk Soil water content of each layer (cm/layer).
+  @param[out] swpMatric Soil water potential of each layer (-bar).
+  @param n_layers Number of soil layers to convert.
+**/
+void SW_SWCbulk2SWPmatric_profile(const RealD swcBulk[], RealD swpMatric[],
+	LyrIndex n_layers) {
+
+	swcBulk2swpMatric_layers(swcBulk, swpMatric, 0, n_layers);
+}
+
+
+/**
+  @brief Soil water potential of a soil water profile with caching
+
+  The water flow converts the same soil water profile repeatedly, e.g.,
+  for the potential evaporation and transpiration rates of each vegetation
+  type. The soil water potential of the most recently converted profile is
+  kept in `SW_Soilwat.swpCache` and re-used for layers whose soil water
+  content is unchanged; the cache is discarded by `water_eqn()`.
+
+  @param[in] swcBulk Soil water content of each layer (cm/layer).
+  @param n_layers Number of soil layers to convert.
+
+  @return Soil water potential of each layer (-bar); valid until the next
+    call and of at least `n_layers` layers.
+**/
+const RealD *SW_SWCbulk2SWPmatric_cached(const RealD swcBulk[], LyrIndex n_layers) {
+	SW_SWP_CACHE *c = &SW_Soilwat.swpCache;
+	LyrIndex i = 0;
+
+	// first layer that is not cached for the soil water content of today
+	while (i < n_layers && i < c->n_layers &&
+		0 == memcmp(&c->swcBulk[i], &swcBulk[i], sizeof(RealD))) {
+		i++;
+	}
+
+	if (i < n_layers) {
+		c->n_layers = i;
+		memcpy(&c->swcBulk[i], &swcBulk[i], (n_layers - i) * sizeof(RealD));
+		swcBulk2swpMatric_layers(c->swcBulk, c->swpMatric, i, n_layers);
+		c->n_layers = n_layers;
+	}
+
+	return c->swpMatric;
+}
+
 /**
 @brief Convert soil water potential to bulk volumetric water content.
 
 @param fractionGravel Fraction of soil containing gravel, percentage.
-@param swpMatric lyr->psisMatric calculated in water equation function
+@param swpMatric Soil water potential; `SW_Site.psisMatric[n]` is calculated in water equation function
 @param n Layer of soil.
 
 @return Volumentric water content (cm H<SUB>2</SUB>O/cm SOIL).
@@ -1104,11 +1364,10 @@ RealD SW_SWPmatric2VWCBulk(RealD fractionGravel, RealD swpMatric, LyrIndex n) {
     27-Aug-03 (cwb) moved from the Site module.
 **/
 
-	SW_LAYER_INFO *lyr = SW_Site.lyr[n];
 	RealD t, p;
 	swpMatric *= BARCONV;
-	p = powe(lyr->psisMatric / swpMatric, lyr->binverseMatric); // lyr->psisMatric calculated in water equation function | todo: check to make sure these are calculated before
-  t = lyr->thetasMatric * p * 0.01 * (1 - fractionGravel);
+	p = powe(SW_Site.psisMatric[n] / swpMatric, SW_Site.binverseMatric[n]); // SW_Site.psisMatric[n] calculated in water equation function | todo: check to make sure these are calculated before
+  t = SW_Site.thetasMatric[n] * p * 0.01 * (1 - fractionGravel);
 	return (t);
 }
 
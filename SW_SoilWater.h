@@ -34,6 +34,9 @@
  modified the use of these variables throughout the rest of the code.
  07/09/2013	(clk)	Added the variables transp_forb, evap_veg[SW_FORBS], hydred[SW_FORBS], and int_veg[SW_FORBS] to SW_SOILWAT_OUTPUTS
  Added the variables transpiration_forb, hydred[SW_FORBS], evap_veg[SW_FORBS], and int_veg[SW_FORBS] to SW_SOILWAT
+ 2026-10-14 replaced sTemp[MAX_LAYERS] of SW_SOILWAT by the swapped pointers sTemp and sTemp_yesterday into sTemp_days
+ 2026-10-14 added swpCache to SW_SOILWAT, see SW_SWCbulk2SWPmatric_cached()
+ 2026-10-15 SW_SOILWAT_HIST holds only the days with measurements (SW_SOILWAT_HIST_DAY)
  */
 /********************************************************/
 /********************************************************/
@@ -54,12 +57,24 @@ typedef enum {
 	SW_Adjust_Avg = 1, SW_Adjust_StdErr
 } SW_AdjustMethods;
 
+/* historical (measured) swc values of one day; SW_MISSING if not measured */
+typedef struct {
+	RealD swc[MAX_LAYERS], std_err[MAX_LAYERS];
+} SW_SOILWAT_HIST_DAY;
+
 /* parameters for historical (measured) swc values */
 typedef struct {
 	int method; /* method: 1=average; 2=hist+/- stderr */
 	SW_TIMES yr;
 	char *file_prefix; /* prefix to historical swc filenames */
-	RealD swc[MAX_DAYS][MAX_LAYERS], std_err[MAX_DAYS][MAX_LAYERS];
+
+	/* measurements of the current year are stored only for days with values:
+	   `row[doy - 1]` is the (1-based) position of a day in `days`, 0 if the
+	   day has no measurements, see SW_SWC_hist_day() */
+	TimeInt row[MAX_DAYS],
+		n_days, /* number of days with measurements */
+		n_alloc; /* number of elements allocated for `days` */
+	SW_SOILWAT_HIST_DAY *days;
 
 } SW_SOILWAT_HIST;
 
@@ -95,6 +110,13 @@ typedef struct {
   #define N_WBCHECKS 8 // number of water balance checks
 #endif
 
+/* soil water potential of the most recently converted soil water profile,
+   see `SW_SWCbulk2SWPmatric_cached()` */
+typedef struct {
+	LyrIndex n_layers; // number of cached layers; 0 if empty
+	RealD swcBulk[MAX_LAYERS], swpMatric[MAX_LAYERS];
+} SW_SWP_CACHE;
+
 typedef struct {
 	/* current daily soil water related values */
 	Bool is_wet[MAX_LAYERS]; /* swc sufficient to count as wet today */
@@ -111,18 +133,24 @@ typedef struct {
 		aet,
 		litter_evap, evap_veg[NVEGTYPES],
 		litter_int, int_veg[NVEGTYPES], // todays intercepted rain by litter and by vegetation
-		sTemp[MAX_LAYERS],
+		sTemp_days[TWO_DAYS][MAX_LAYERS], // storage of `sTemp` and `sTemp_yesterday`
 		surfaceTemp; // soil surface temperature
 
+	/* soil temperature [C] of each layer today and yesterday: point to the
+	   rows of `sTemp_days` and are swapped (not copied) by `SW_SWC_end_day()` */
+	RealD *sTemp, *sTemp_yesterday;
+
 	RealF swa_master[NVEGTYPES][NVEGTYPES][MAX_LAYERS]; // veg_type, crit_val, layer
 	RealF dSWA_repartitioned_sum[NVEGTYPES][MAX_LAYERS];
 
 	Bool soiltempError; // soil temperature error indicator
+	SW_SWP_CACHE swpCache; // soil water potential of the most recent soil water profile
 	#ifdef SWDEBUG
 	int wbError[N_WBCHECKS]; /* water balance and water cycling error indicators (currently 8)
 	    0, no error detected; > 0, number of errors detected */
   char *wbErrorNames[N_WBCHECKS];
   Bool is_wbError_init;
+  RealD surfaceWater_yesterday; /* surface water of yesterday (was a function static of `SW_WaterBalance_Checks()`) */
   #endif
 
 	SW_SOILWAT_OUTPUTS
@@ -138,8 +166,13 @@ void SW_SWC_deconstruct(void);
 void SW_SWC_new_year(void);
 void SW_SWC_read(void);
 void SW_SWC_init_run(void);
-void _read_swc_hist(TimeInt year);
+Bool _read_swc_hist(TimeInt year);
+void _clear_hist_swc(void);
+void SW_SWC_hist_reserve(TimeInt n_days);
+SW_SOILWAT_HIST_DAY *SW_SWC_hist_add_day(TimeInt doy);
+const SW_SOILWAT_HIST_DAY *SW_SWC_hist_day(TimeInt doy);
 void SW_SWC_water_flow(void);
+void SW_SWC_water_flow_part(unsigned int part);
 void calculate_repartitioned_soilwater(void);
 void SW_SWC_adjust_swc(TimeInt doy);
 void SW_SWC_adjust_snow(RealD temp_min, RealD temp_max, RealD ppt, RealD *rain,
@@ -148,6 +181,9 @@ RealD SW_SWC_snowloss(RealD pet, RealD *snowpack);
 RealD SW_SnowDepth(RealD SWE, RealD snowdensity);
 void SW_SWC_end_day(void);
 RealD SW_SWCbulk2SWPmatric(RealD fractionGravel, RealD swcBulk, LyrIndex n);
+void SW_SWCbulk2SWPmatric_profile(const RealD swcBulk[], RealD swpMatric[],
+  LyrIndex n_layers);
+const RealD *SW_SWCbulk2SWPmatric_cached(const RealD swcBulk[], LyrIndex n_layers);
 RealD SW_SWPmatric2VWCBulk(RealD fractionGravel, RealD swpMatric, LyrIndex n);
 RealD SW_VWCBulkRes(RealD fractionGravel, RealD sand, RealD clay, RealD porosity);
 void get_dSWAbulk(int i);
@@ -0,0 +1,399 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_SoilWater_store.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Read historical (measured) soil moisture from a binary store
+ *           instead of the text files `[swc prefix].[year]`, and convert
+ *           text files into a store.
+ *
+ *           A soil moisture store holds all years of a site in one file
+ *           (see `SW_SoilWater_store.h`). The store is memory-mapped and
+ *           the measurements of a year are copied into `SW_Soilwat.hist`
+ *           without any text parsing.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "SW_Defines.h"
+#include "SW_SoilWater.h"
+#include "SW_SoilWater_store.h"
+#include "SW_Run.h"
+
+
+/* The open soil moisture store is part of the simulation run context */
+#define SStore (SW_CurrentRun->SoilWaterStore)
+
+/* size of the data block of a year */
+#define len_block(n_days, n_lyrs) \
+	((size_t) (n_days) * (sizeof(int32_t) + 2 * (size_t) (n_lyrs) * sizeof(float)))
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Check that a mapped file is a complete soil moisture store of this format
+
+  @return An error message or `NULL` if the store is valid.
+*/
+static const char *check_store(const void *map, size_t size) {
+	const SW_SWC_STORE_HEADER *h = (const SW_SWC_STORE_HEADER *) map;
+	const SW_SWC_STORE_YEAR *index;
+	const int32_t *doy;
+	uint32_t i, d;
+
+	if (size < sizeof(SW_SWC_STORE_HEADER) ||
+		0 != memcmp(h->magic, SW_SWC_STORE_MAGIC, sizeof h->magic)) {
+		return "not a soil moisture store";
+	}
+
+	if (h->version != SW_SWC_STORE_VERSION) {
+		return "unsupported version of soil moisture store";
+	}
+
+	if (h->byteorder != SW_SWC_STORE_BYTEORDER) {
+		return "soil moisture store was created with a different byte order";
+	}
+
+	if (h->max_lyrs > MAX_LAYERS) {
+		return "soil moisture store has too many soil layers";
+	}
+
+	if (size < sizeof(SW_SWC_STORE_HEADER) +
+		(size_t) h->n_years * sizeof(SW_SWC_STORE_YEAR)) {
+		return "index of soil moisture store is truncated";
+	}
+
+	index = (const SW_SWC_STORE_YEAR *) (h + 1);
+
+	for (i = 0; i < h->n_years; i++) {
+		if (index[i].n_days > MAX_DAYS || index[i].n_lyrs > h->max_lyrs) {
+			return "soil moisture store has an invalid year";
+		}
+
+		if (index[i].offset > size ||
+			size - index[i].offset < len_block(index[i].n_days, index[i].n_lyrs)) {
+			return "data of soil moisture store is truncated";
+		}
+
+		if (i > 0 && index[i].year <= index[i - 1].year) {
+			return "index of soil moisture store is not sorted by year";
+		}
+
+		doy = (const int32_t *) ((const char *) map + index[i].offset);
+
+		for (d = 0; d < index[i].n_days; d++) {
+			if (doy[d] < 1 || doy[d] > MAX_DAYS || (d > 0 && doy[d] <= doy[d - 1])) {
+				return "days of soil moisture store are invalid or not sorted";
+			}
+		}
+	}
+
+	return NULL;
+}
+
+
+/** Locate the index entry of a year in the open soil moisture store
+
+  @return The index entry or `NULL` if the store has no data for `year`.
+*/
+static const SW_SWC_STORE_YEAR *find_year(TimeInt year) {
+	const SW_SWC_STORE_YEAR *index = SStore.index;
+	long lo = 0, hi = (long) SStore.header->n_years - 1, mid;
+
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+
+		if (index[mid].year == (int32_t) year) {
+			return index + mid;
+		}
+
+		if (index[mid].year < (int32_t) year) {
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return NULL;
+}
+
+
+/** Append `n` bytes at `p` to the growing buffer `*data` of length `*len` */
+static void append(char **data, size_t *len, size_t *n_alloc,
+	const void *p, size_t n) {
+
+	if (*len + n > *n_alloc) {
+		*n_alloc = max(2 * *n_alloc, *len + n);
+		*data = (char *) (isnull(*data) ?
+			Mem_Malloc(*n_alloc, "SW_SWC_write_store()") :
+			Mem_ReAlloc(*data, *n_alloc));
+	}
+
+	memcpy(*data + *len, p, n);
+	*len += n;
+}
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Name of the soil moisture store that belongs to text files of
+  historical soil moisture
+
+@param fname Resulting file name `[file_prefix].bin`; of size `MAX_FILENAMESIZE`.
+@param file_prefix Prefix of historical swc files, see `SW_Soilwat.hist.file_prefix`.
+*/
+void SW_SWC_store_name(char *fname, const char *file_prefix) {
+	snprintf(fname, MAX_FILENAMESIZE, "%s%s", file_prefix, SW_SWC_STORE_EXT);
+}
+
+
+/**
+@brief Open (memory-map) a soil moisture store for the active simulation run
+
+A previously opened store of the run is closed first.
+
+@param fname Name of the soil moisture store file.
+
+@return `swTRUE` if the store was opened; `swFALSE` if the file does not exist.
+  An invalid store is a fatal error.
+*/
+Bool SW_SWC_open_store(const char *fname) {
+	int fd;
+	struct stat sb;
+	void *map;
+	const char *msg;
+
+	SW_SWC_close_store();
+
+	if (-1 == (fd = open(fname, O_RDONLY))) {
+		return swFALSE;
+	}
+
+	if (0 != fstat(fd, &sb) || sb.st_size <= 0) {
+		close(fd);
+		LogError(logfp, LOGFATAL, "%s : Cannot determine size of soil moisture store.", fname);
+	}
+
+	map = mmap(NULL, (size_t) sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (MAP_FAILED == map) {
+		LogError(logfp, LOGFATAL, "%s : Cannot map soil moisture store: %s",
+			fname, strerror(errno));
+	}
+
+	if (!isnull(msg = check_store(map, (size_t) sb.st_size))) {
+		munmap(map, (size_t) sb.st_size);
+		LogError(logfp, LOGFATAL, "%s : %s.", fname, msg);
+	}
+
+	SStore.map = map;
+	SStore.size = (size_t) sb.st_size;
+	SStore.header = (const SW_SWC_STORE_HEADER *) map;
+	SStore.index = (const SW_SWC_STORE_YEAR *) (SStore.header + 1);
+
+	return swTRUE;
+}
+
+
+/**
+@brief Close the soil moisture store of the active simulation run (if open)
+*/
+void SW_SWC_close_store(void) {
+	if (!isnull(SStore.map)) {
+		munmap(SStore.map, SStore.size);
+	}
+
+	SStore.map = NULL;
+	SStore.size = 0;
+	SStore.header = NULL;
+	SStore.index = NULL;
+}
+
+
+/**
+@brief Does the active simulation run use a soil moisture store?
+*/
+Bool SW_SWC_store_is_open(void) {
+	return (Bool) !isnull(SStore.map);
+}
+
+
+/**
+@brief Copy the historical soil moisture of a simulation year from the open
+  soil moisture store
+
+Values are identical to those read by `_read_swc_hist()` from the text file
+of the same year; as for text files, the previous values are kept if the
+store has no data for `year`.
+
+@param year Calendar year.
+
+@return `swTRUE`/`swFALSE` if the store has/has no data for `year`.
+*/
+Bool SW_SWC_read_store(TimeInt year) {
+	const SW_SWC_STORE_YEAR *y;
+	const int32_t *doy;
+	const float *swc, *std_err;
+	SW_SOILWAT_HIST_DAY *obs;
+	uint32_t d, z, n_lyrs;
+
+	if (isnull(y = find_year(year))) {
+		return swFALSE;
+	}
+
+	n_lyrs = y->n_lyrs;
+	doy = (const int32_t *) ((const char *) SStore.map + y->offset);
+	swc = (const float *) (doy + y->n_days);
+	std_err = swc + (size_t) y->n_days * n_lyrs;
+
+	_clear_hist_swc();
+	SW_SWC_hist_reserve(y->n_days);
+
+	for (d = 0; d < y->n_days; d++) {
+		obs = SW_SWC_hist_add_day((TimeInt) doy[d]);
+
+		for (z = 0; z < n_lyrs; z++) {
+			obs->swc[z] = swc[d * n_lyrs + z];
+			obs->std_err[z] = std_err[d * n_lyrs + z];
+		}
+	}
+
+	return swTRUE;
+}
+
+
+/**
+@brief Convert the text files of historical soil moisture of the active
+  simulation run into a soil moisture store
+
+Reads `[swc prefix].[year]` for each year from `startyr` to `endyr`
+that has a file; requires that `SW_SWC_read()` was called.
+A soil moisture store that is open by the run is closed first.
+
+@param fname Name of the soil moisture store file to create.
+@param startyr First calendar year.
+@param endyr Last calendar year.
+
+@return Number of years written to the store.
+*/
+int SW_SWC_write_store(const char *fname, TimeInt startyr, TimeInt endyr) {
+	SW_SOILWAT_HIST *h = &SW_Soilwat.hist;
+	SW_SWC_STORE_HEADER header;
+	SW_SWC_STORE_YEAR *index;
+	const SW_SOILWAT_HIST_DAY *obs;
+	char *data = NULL;
+	size_t len = 0, n_alloc = 0, base;
+	TimeInt year, doy;
+	int32_t doy32;
+	float value;
+	uint32_t n = 0, i, z, n_lyrs, max_lyrs = 0,
+		n_max = (endyr >= startyr) ? endyr - startyr + 1 : 0;
+	FILE *f;
+
+	SW_SWC_close_store();
+
+	index = (SW_SWC_STORE_YEAR *) Mem_Calloc(max(n_max, 1),
+		sizeof(SW_SWC_STORE_YEAR), "SW_SWC_write_store()");
+
+	for (year = startyr; year <= endyr; year++) {
+		if (!_read_swc_hist(year)) {
+			continue;
+		}
+
+		// deepest layer with measurements
+		n_lyrs = 0;
+		for (i = 0; i < h->n_days; i++) {
+			for (z = n_lyrs; z < MAX_LAYERS; z++) {
+				if (!missing(h->days[i].swc[z]) || !missing(h->days[i].std_err[z])) {
+					n_lyrs = z + 1;
+				}
+			}
+		}
+
+		index[n].year = (int32_t) year;
+		index[n].n_days = h->n_days;
+		index[n].n_lyrs = n_lyrs;
+		index[n].offset = len; // relative to the first data block
+		max_lyrs = max(max_lyrs, n_lyrs);
+
+		for (doy = 1; doy <= MAX_DAYS; doy++) {
+			if (!isnull(SW_SWC_hist_day(doy))) {
+				doy32 = (int32_t) doy;
+				append(&data, &len, &n_alloc, &doy32, sizeof doy32);
+			}
+		}
+
+		for (i = 0; i < 2; i++) {
+			for (doy = 1; doy <= MAX_DAYS; doy++) {
+				if (!isnull(obs = SW_SWC_hist_day(doy))) {
+					for (z = 0; z < n_lyrs; z++) {
+						value = (float) ((0 == i) ? obs->swc[z] : obs->std_err[z]);
+						append(&data, &len, &n_alloc, &value, sizeof value);
+					}
+				}
+			}
+		}
+
+		n++;
+	}
+
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, SW_SWC_STORE_MAGIC, sizeof header.magic);
+	header.version = SW_SWC_STORE_VERSION;
+	header.byteorder = SW_SWC_STORE_BYTEORDER;
+	header.n_years = n;
+	header.max_lyrs = max_lyrs;
+
+	base = sizeof header + n * sizeof(SW_SWC_STORE_YEAR);
+	for (i = 0; i < n; i++) {
+		index[i].offset += base;
+	}
+
+	f = OpenFile(fname, "wb");
+
+	if (1 != fwrite(&header, sizeof header, 1, f) ||
+		n != fwrite(index, sizeof(SW_SWC_STORE_YEAR), n, f) ||
+		(len > 0 && 1 != fwrite(data, len, 1, f))) {
+		CloseFile(&f);
+		Mem_Free(index);
+		if (!isnull(data)) {
+			Mem_Free(data);
+		}
+		LogError(logfp, LOGFATAL, "%s : Cannot write soil moisture store.", fname);
+	}
+
+	CloseFile(&f);
+	Mem_Free(index);
+	if (!isnull(data)) {
+		Mem_Free(data);
+	}
+
+	return (int) n;
+}
@@ -0,0 +1,93 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_SoilWater_store.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for the binary store of
+ *           historical (measured) soil moisture of `SW_SoilWater_store.c`.
+ *
+ *           A soil moisture store holds the measurements of all years of
+ *           a site in one binary file `[swc prefix].bin`:
+ *             - a header `SW_SWC_STORE_HEADER`,
+ *             - an index of `n_years` entries `SW_SWC_STORE_YEAR`,
+ *               sorted by year, and
+ *             - for each year, the data block of the `n_days` days with
+ *               measurements: `doy[n_days]` (int32, increasing), and the
+ *               float arrays `swc[n_days][n_lyrs]` and
+ *               `std_err[n_days][n_lyrs]` with `SW_MISSING` for layers
+ *               without values.
+ *
+ *           Days without measurements take no space, and `n_lyrs` is
+ *           the deepest layer with measurements of the year.
+ *           Values are stored in the byte order of the machine that
+ *           created the store.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_SOILWATER_STORE_H
+#define SW_SOILWATER_STORE_H
+
+#include <stdint.h>
+#include "generic.h"
+#include "SW_Times.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+#define SW_SWC_STORE_MAGIC "SW2SWCHS" /**< first 8 bytes of a soil moisture store */
+#define SW_SWC_STORE_VERSION 1 /**< version of the soil moisture store format */
+#define SW_SWC_STORE_BYTEORDER 0x01020304 /**< detects a foreign byte order */
+#define SW_SWC_STORE_EXT ".bin" /**< file extension of a soil moisture store */
+
+/** Header of a soil moisture store file */
+typedef struct {
+	char magic[8];
+	uint32_t version, byteorder,
+		n_years, /**< number of years in the store */
+		max_lyrs; /**< largest `n_lyrs` of any year */
+} SW_SWC_STORE_HEADER;
+
+/** Index entry of one year of a soil moisture store */
+typedef struct {
+	int32_t year;
+	uint32_t n_days, /**< number of days with measurements */
+		n_lyrs, /**< number of layers per day */
+		reserved;
+	uint64_t offset; /**< position of the year's data block (bytes from file start) */
+} SW_SWC_STORE_YEAR;
+
+/** An open (memory-mapped) soil moisture store */
+typedef struct {
+	void *map; /**< read-only mapping of the store file; `NULL` if not open */
+	size_t size; /**< size of the store file in bytes */
+	const SW_SWC_STORE_HEADER *header;
+	const SW_SWC_STORE_YEAR *index;
+} SW_SWC_STORE;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_SWC_store_name(char *fname, const char *file_prefix);
+Bool SW_SWC_open_store(const char *fname);
+void SW_SWC_close_store(void);
+Bool SW_SWC_store_is_open(void);
+Bool SW_SWC_read_store(TimeInt year);
+int SW_SWC_write_store(const char *fname, TimeInt startyr, TimeInt endyr);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
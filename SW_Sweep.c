@@ -0,0 +1,812 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Sweep.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Run many variants of one site with SOILWAT2-standalone,
+ *           e.g., for calibrations and sensitivity analyses.
+ *
+ *           A design lists the parameters that the variants override
+ *           in its header line and the values of one variant per line
+ *           (see `SW_SWP_read_design()`); all other inputs are those of
+ *           the base site.
+ *
+ *           The inputs of the base site are read and prepared once per
+ *           thread: each worker thread owns one simulation run context
+ *           `SW_RUN` with an image of the prepared inputs (see
+ *           `SW_CTL_save_run()`). For each variant, a worker restores the
+ *           image, applies the overrides of the variant, and derives the
+ *           inputs (`SW_CTL_init_run()`), i.e., input files are not read
+ *           again. Workers claim the next variant with an atomic counter.
+ *
+ *           If the weather generator is not used, then the daily weather
+ *           of all simulated years is read once (see `SW_WTH_preload()`)
+ *           and shared read-only by all variants (see
+ *           `SW_WTH_set_memory()`). Otherwise, each variant reads its
+ *           weather because the values that the weather generator fills
+ *           in depend on the thread (see `RandNorm()`). Input tables of
+ *           CO2 concentrations and weather generator parameters are
+ *           shared (see `SW_Shared.c`).
+ *
+ *           Variants do not write output files; instead, the summary
+ *           statistics of each variant (see `SW_OUT_add_summary()`) are
+ *           collected into one results table (see `SW_SWP_write_results()`).
+ *           A variant whose simulation fails with a fatal error is
+ *           recorded (see `SW_ERROR_HANDLER`) and does not affect the
+ *           other variants. Log messages of a variant are written at
+ *           once to the logfile of the base site.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <setjmp.h>
+#include <time.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "Times.h"
+#include "SW_Defines.h"
+#include "SW_Control.h"
+#include "SW_Output.h"
+#include "SW_Output_outbin.h"
+#include "SW_Output_reduce.h"
+#include "SW_Model.h"
+#include "SW_Site.h"
+#include "SW_VegProd.h"
+#include "SW_Carbon.h"
+#include "SW_Weather.h"
+#include "SW_Checkpoint.h"
+#include "SW_Trace.h"
+#include "SW_Run.h"
+#include "SW_Batch.h"
+#include "SW_Sweep.h"
+
+#define SW_SWP_BINWIDTH 1. /**< width of the bins of available soil water [cm], as `-o summary` */
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** A sweep while its variants are simulated */
+typedef struct {
+	SW_SWEEP *sweep;
+	unsigned int next; /**< next variant to claim by a worker */
+	Bool co2; /**< TRUE if the base site read CO2 concentrations */
+	FILE *logfile; /**< logfile of the base site */
+	SW_LOGBUFFER logbuf; /**< messages of the setup of the base site */
+	Bool logged; /**< TRUE if a variant logged messages */
+	pthread_mutex_t lock; /**< of `logfile` and `logged` */
+} SW_SWEEP_STATE;
+
+/** State of one worker thread */
+typedef struct {
+	SW_SWEEP_STATE *st;
+	unsigned int id;
+	SW_RUN *sw; /**< simulation run context of the worker */
+	SW_RUN_SNAPSHOT snap; /**< image of the prepared inputs of the base site */
+} SW_SWEEP_WORKER;
+
+
+/* =================================================== */
+/*                  Local Variables                    */
+/* --------------------------------------------------- */
+
+/** Names of the parameters of a design without vegetation type or layer */
+static const struct {
+	const char *name;
+	SW_SWEEP_KIND kind;
+} param_names[] = {
+	{"swc_min", eSwpSWCMin}, {"swc_init", eSwpSWCInit}, {"swc_wet", eSwpSWCWet},
+	{"pet_scale", eSwpPETScale},
+	{"runoff", eSwpRunoff}, {"runon", eSwpRunon},
+	{"TminAccu2", eSwpTminAccu2}, {"TmaxCrit", eSwpTmaxCrit},
+	{"lambdasnow", eSwpLambdasnow}, {"RmeltMin", eSwpRmeltMin},
+	{"RmeltMax", eSwpRmeltMax},
+	{"slow_drain_coeff", eSwpSlowDrain},
+	{"co2_bio_mult", eSwpCO2Bio}, {"co2_wue_mult", eSwpCO2WUE},
+	{"evco", eSwpEvco}, {"trco", eSwpTrco}, {"SWPcrit", eSwpSWPcrit}
+};
+
+/** Vegetation types as suffixes of parameter names, as in `soils.in` */
+static const char *veg_names[NVEGTYPES] = {"tree", "shrub", "forb", "grass"};
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Seconds elapsed since `start` */
+static double seconds_since(const struct timespec *start) {
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+
+	return (double) (now.tv_sec - start->tv_sec) +
+		1e-9 * (double) (now.tv_nsec - start->tv_nsec);
+}
+
+
+/** Next value of a line of a design; values are separated by
+    white space or commas
+
+  @return Start of the value; NULL at the end of the line.
+*/
+static char *next_value(char **s) {
+	char *v = *s + strspn(*s, " \t,");
+
+	if ('\0' == *v) {
+		return NULL;
+	}
+
+	*s = v + strcspn(v, " \t,");
+	if ('\0' != **s) {
+		*(*s)++ = '\0';
+	}
+
+	return v;
+}
+
+
+/** Parse a column of the header of a design, e.g., `trco_grass[3]`
+
+  @return FALSE if the name is not a parameter of a design.
+*/
+static Bool parse_param(const char *name, SW_SWEEP_PARAM *p) {
+	char base[SW_SWEEP_NAMELEN], *c, *end;
+	unsigned int k;
+	long layer = 0;
+
+	if (strlen(name) >= SW_SWEEP_NAMELEN) {
+		return swFALSE;
+	}
+	strcpy(p->name, name);
+	strcpy(base, name);
+	p->veg = -1;
+	p->layer = 0;
+
+	// soil layer (base1) in brackets
+	if (!isnull(c = strchr(base, '['))) {
+		layer = strtol(c + 1, &end, 10);
+		if (end == c + 1 || 0 != strcmp(end, "]") || layer < 1 ||
+			layer > MAX_LAYERS) {
+			return swFALSE;
+		}
+		*c = '\0';
+		p->layer = (LyrIndex) (layer - 1);
+	}
+
+	// vegetation type after the last underscore
+	if (!isnull(c = strrchr(base, '_'))) {
+		ForEachVegType(k) {
+			if (0 == strcmp(c + 1, veg_names[k])) {
+				p->veg = (int) k;
+				*c = '\0';
+				break;
+			}
+		}
+	}
+
+	for (k = 0; k < sizeof param_names / sizeof param_names[0]; k++) {
+		if (0 == strcmp(base, param_names[k].name)) {
+			p->kind = param_names[k].kind;
+
+			switch (p->kind) {
+				case eSwpEvco:
+					return (Bool) (layer > 0 && p->veg < 0);
+				case eSwpTrco:
+					return (Bool) (layer > 0 && p->veg >= 0);
+				case eSwpSWPcrit:
+					return (Bool) (0 == layer && p->veg >= 0);
+				default:
+					return (Bool) (0 == layer && p->veg < 0);
+			}
+		}
+	}
+
+	return swFALSE;
+}
+
+
+/** Override a parameter of the active run, before `SW_CTL_init_run()`
+
+  @param p Parameter of the design.
+  @param x Value of the variant.
+  @param co2 TRUE if the base site read CO2 concentrations.
+*/
+static void set_param(const SW_SWEEP_PARAM *p, double x, Bool co2) {
+	SW_SITE *s = &SW_Site;
+
+	switch (p->kind) {
+		case eSwpSWCMin: SW_CurrentRun->SWCMinVal = x; break;
+		case eSwpSWCInit: SW_CurrentRun->SWCInitVal = x; break;
+		case eSwpSWCWet: SW_CurrentRun->SWCWetVal = x; break;
+		case eSwpPETScale: s->pet_scale = x; break;
+		case eSwpRunoff: s->percentRunoff = x; break;
+		case eSwpRunon: s->percentRunon = x; break;
+		case eSwpTminAccu2: s->TminAccu2 = x; break;
+		case eSwpTmaxCrit: s->TmaxCrit = x; break;
+		case eSwpLambdasnow: s->lambdasnow = x; break;
+		case eSwpRmeltMin: s->RmeltMin = x; break;
+		case eSwpRmeltMax: s->RmeltMax = x; break;
+		case eSwpSlowDrain: s->slow_drain_coeff = x; break;
+
+		case eSwpCO2Bio:
+		case eSwpCO2WUE:
+			// CO2 concentrations are only read if a multiplier is turned on
+			if (0. != x && !co2) {
+				LogError(logfp, LOGFATAL, "%s : CO2 multipliers are turned off "
+					"in %s; CO2 concentrations were not read.", p->name,
+					SW_F_name(eSite));
+			}
+			if (eSwpCO2Bio == p->kind) {
+				SW_Carbon.use_bio_mult = (Bool) (0. != x);
+			} else {
+				SW_Carbon.use_wue_mult = (Bool) (0. != x);
+			}
+			break;
+
+		case eSwpEvco:
+		case eSwpTrco:
+			if (p->layer >= s->n_layers) {
+				LogError(logfp, LOGFATAL, "%s : the site has %u soil layers.",
+					p->name, s->n_layers);
+			}
+			if (eSwpEvco == p->kind) {
+				s->evap_coeff[p->layer] = x;
+			} else {
+				s->transp_coeff[p->veg][p->layer] = x;
+			}
+			break;
+
+		case eSwpSWPcrit:
+			// as read by `SW_VPD_read()`
+			SW_VegProd.veg[p->veg].SWPcrit = -10. * x;
+			SW_VegProd.critSoilWater[p->veg] = x;
+			get_critical_rank();
+			break;
+	}
+}
+
+
+/** Set up the simulation run context of a worker: read and prepare the
+    inputs of the base site and take an image of them
+
+  Called by the main thread, so that the logfile of the base site (which
+  each setup opens and truncates, see `SW_F_read()`) is kept open by the
+  main thread only.
+
+  @param w Worker.
+  @param firstfile Main input file of the base site.
+*/
+static void setup_worker(SW_SWEEP_WORKER *w, const char *firstfile) {
+	SW_SWEEP *sweep = w->st->sweep;
+	SW_ERROR_HANDLER handler;
+	SW_LOGBUFFER logbuf = {NULL, 0, 0};
+	FILE *keep = logfp;
+	char fname[MAX_FILENAMESIZE];
+
+	w->sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "setup_worker()");
+	w->sw->Arena.use = swTRUE;
+	w->sw->Shared = &sweep->shared;
+
+	// SW_F_construct() strips the path from its argument
+	strcpy(fname, firstfile);
+
+	// messages repeat those of the setup of the base site
+	handler.msg[0] = '\0';
+	LogError_handler = &handler;
+	LogError_buffer = &logbuf;
+
+	if (0 == setjmp(handler.env)) {
+		SW_CTL_setup_model(w->sw, fname);
+		SW_CTL_read_inputs_from_disk(w->sw);
+		SW_OUT_set_format(SW_OUTFORMAT_NONE);
+
+		if (!isnull(sweep->hist)) {
+			SW_WTH_set_memory(sweep->hist, sweep->first_year, sweep->n_years);
+		}
+	}
+
+	LogError_handler = NULL;
+	LogError_buffer = NULL;
+	FlushLogBuffer(&logbuf, NULL);
+
+	if (logfp != keep && logfp != stdout && logfp != stderr) {
+		CloseFile(&logfp);
+	}
+	logfp = keep;
+
+	if ('\0' != handler.msg[0]) {
+		LogError(logfp, LOGFATAL, "Sweep: setup of worker %u failed: %s",
+			w->id, handler.msg);
+	}
+
+	SW_CTL_save_run(w->sw, &w->snap);
+	SW_CTL_activate_run(NULL);
+}
+
+
+/** Simulate variant `i` with the simulation run context of a worker
+
+  @param w Worker; its run is restored from the image of the base site.
+  @param st State of the sweep.
+  @param i Index of the variant.
+*/
+static void run_variant(SW_SWEEP_WORKER *w, SW_SWEEP_STATE *st,
+	unsigned int i) {
+
+	SW_SWEEP *sweep = st->sweep;
+	SW_SWEEP_VARIANT *v = &sweep->variants[i];
+	const double *x = sweep->values + (size_t) i * sweep->n_params;
+	SW_ERROR_HANDLER handler;
+	SW_LOGBUFFER logbuf = {NULL, 0, 0};
+	struct timespec start;
+	unsigned int k;
+
+	timespec_get(&start, TIME_UTC);
+
+	LogError_handler = &handler;
+	LogError_buffer = &logbuf;
+
+	SW_TRC_START(variant);
+
+	if (0 == setjmp(handler.env)) {
+		SW_CTL_restore_run(w->sw, &w->snap);
+
+		for (k = 0; k < sweep->n_params; k++) {
+			set_param(&sweep->params[k], x[k], st->co2);
+		}
+
+		SW_OUT_init_summary(&v->summary, SW_SWP_BINWIDTH);
+		SW_OUT_add_summary(&v->summary);
+
+		SW_CTL_init_run(w->sw);
+		SW_OUT_set_ncol();
+		SW_OUT_set_colnames();
+
+		// without output files nor checkpoints, this simulates all years
+		SW_CKP_run();
+
+	} else {
+		v->failed = swTRUE;
+		strcpy(v->msg, handler.msg);
+	}
+
+	SW_TRC_STOP_INT(variant, v->failed ? "variant (failed)" : "variant",
+		"sweep", "variant", i + 1);
+
+	LogError_handler = NULL;
+	LogError_buffer = NULL;
+
+	if (logbuf.len > 0) {
+		pthread_mutex_lock(&st->lock);
+		fprintf(st->logfile, "Variant %u:\n", i + 1);
+		FlushLogBuffer(&logbuf, st->logfile);
+		st->logged = swTRUE;
+		pthread_mutex_unlock(&st->lock);
+	} else {
+		FlushLogBuffer(&logbuf, NULL);
+	}
+
+	v->seconds = seconds_since(&start);
+}
+
+
+/** Worker thread: simulate variants until all are claimed */
+static void *sweep_worker(void *arg) {
+	SW_SWEEP_WORKER *w = (SW_SWEEP_WORKER *) arg;
+	SW_SWEEP_STATE *st = w->st;
+	unsigned int i;
+	char name[32];
+
+	snprintf(name, sizeof name, "sweep %u", w->id);
+	SW_TRC_thread_name(name);
+
+	logfp = st->logfile;
+	logged = swFALSE;
+
+	// the calendar of `Times.c` is per thread; the run was set up by the
+	// main thread (see `SW_MDL_construct()`)
+	SW_CTL_activate_run(w->sw);
+	Time_init_model();
+
+	while ((i = __atomic_fetch_add(&st->next, 1u, __ATOMIC_RELAXED)) <
+		st->sweep->n_variants) {
+
+		run_variant(w, st, i);
+	}
+
+	SW_CTL_activate_run(NULL);
+
+	return NULL;
+}
+
+
+/** Read and prepare the inputs of the base site once: check the design
+    against the site and read the weather that the variants share
+
+  Messages are held in `st->logbuf` until all workers are set up, see
+  `setup_worker()`; the logfile of the base site is left in `st->logfile`.
+
+  @param st State of the sweep.
+  @param firstfile Main input file of the base site.
+*/
+static void prepare_base(SW_SWEEP_STATE *st, const char *firstfile) {
+	SW_SWEEP *sweep = st->sweep;
+	SW_RUN *sw;
+	SW_ERROR_HANDLER handler;
+	char fname[MAX_FILENAMESIZE];
+	unsigned int k;
+
+	sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "prepare_base()");
+	sw->Arena.use = swTRUE;
+	sw->Shared = &sweep->shared;
+
+	// SW_F_construct() strips the path from its argument
+	strcpy(fname, firstfile);
+
+	handler.msg[0] = '\0';
+	LogError_handler = &handler;
+	LogError_buffer = &st->logbuf;
+
+	SW_TRC_START(setup);
+
+	if (0 == setjmp(handler.env)) {
+		SW_CTL_setup_model(sw, fname);
+		SW_CTL_read_inputs_from_disk(sw);
+		SW_OUT_set_format(SW_OUTFORMAT_NONE);
+
+		st->co2 = (Bool) (SW_Carbon.use_bio_mult || SW_Carbon.use_wue_mult);
+
+		for (k = 0; k < sweep->n_params; k++) {
+			if (sweep->params[k].layer >= SW_Site.n_layers) {
+				LogError(logfp, LOGFATAL, "%s : the base site has %u soil layers.",
+					sweep->params[k].name, SW_Site.n_layers);
+			}
+		}
+
+		// the values that the weather generator fills in depend on the thread
+		if (!SW_Weather.use_weathergenerator) {
+			SW_CTL_init_run(sw);
+			SW_WTH_preload();
+
+			sweep->first_year = SW_Model.startyr;
+			sweep->n_years = SW_Model.endyr - SW_Model.startyr + 1;
+
+			// the shared weather outlives the run
+			Mem_ArenaActivate(NULL);
+			sweep->hist = (SW_WEATHER_HIST *) Mem_Malloc(
+				sweep->n_years * sizeof(SW_WEATHER_HIST), "prepare_base()");
+			SW_CTL_activate_run(sw);
+
+			memcpy(sweep->hist, SW_Weather.allHist,
+				sweep->n_years * sizeof(SW_WEATHER_HIST));
+		}
+	}
+
+	SW_TRC_STOP_STR(setup, "sweep setup", "setup", "site", firstfile);
+
+	LogError_handler = NULL;
+	LogError_buffer = NULL;
+	st->logfile = logfp;
+
+	// the buffer holds the error
+	if ('\0' != handler.msg[0]) {
+		FlushLogBuffer(&st->logbuf, logfp);
+		LogError(logfp, LOGFATAL, "Sweep: setup of the base site %s failed.",
+			firstfile);
+	}
+
+	SW_CTL_clear_model(sw, swTRUE);
+	Mem_Free(sw);
+	SW_CTL_activate_run(NULL);
+}
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Read the design of a sweep
+
+The first line lists the parameters that the variants override; each
+further line lists the values of one variant in the same order. Values
+are separated by white space or commas; comments (`#`) and empty lines
+are ignored, e.g.,
+```
+# variants of the snow parameters and of the roots of grasses
+RmeltMax  TmaxCrit  trco_grass[1]  trco_grass[2]
+0.27      1.54      0.0496         0.0495
+0.40      1.00      0.1            0.05
+```
+
+Parameters of `siteparam.in`: `swc_min`, `swc_init`, `swc_wet`,
+`pet_scale`, `runoff`, `runon` (proportions of runoff and runon),
+`TminAccu2`, `TmaxCrit`, `lambdasnow`, `RmeltMin`, `RmeltMax`,
+`slow_drain_coeff`, and the CO2 multipliers `co2_bio_mult` and
+`co2_wue_mult` (turned on if not 0). Parameters of a soil layer `n`
+(base1) of `soils.in`: `evco[n]` and `trco_<veg>[n]`, where `<veg>`
+is one of `tree`, `shrub`, `forb`, or `grass`. Parameters of `veg.in`:
+`SWPcrit_<veg>` (MPa, e.g., -3.5). Values are in the units
+of the input files; coefficients of the soil layers are normalized as
+those of `soils.in` (see `SW_SIT_init_run()`).
+
+@param sweep Sweep; its parameters, values, and variants are set up.
+  Free with `SW_SWP_deconstruct()`.
+@param design Name of the design file.
+*/
+void SW_SWP_read_design(SW_SWEEP *sweep, const char *design) {
+	SW_TEXTFILE f;
+	char *s, *v, *end, name[SW_SWEEP_NAMELEN];
+	unsigned int k, n_alloc = 0;
+	double x;
+
+	memset(sweep, 0, sizeof *sweep);
+
+	OpenTextFile(&f, design);
+
+	// header: one column per parameter
+	if (GetATextLine(&f)) {
+		s = f.line;
+		while (!isnull(v = next_value(&s))) {
+			if (sweep->n_params == n_alloc) {
+				n_alloc = (0 == n_alloc) ? 16 : 2 * n_alloc;
+				sweep->params = (SW_SWEEP_PARAM *) (isnull(sweep->params) ?
+					Mem_Malloc(n_alloc * sizeof(SW_SWEEP_PARAM), "SW_SWP_read_design()") :
+					Mem_ReAlloc(sweep->params, n_alloc * sizeof(SW_SWEEP_PARAM)));
+			}
+
+			if (!parse_param(v, &sweep->params[sweep->n_params])) {
+				snprintf(name, sizeof name, "%s", v); // `v` is part of `f`
+				CloseTextFile(&f);
+				LogError(logfp, LOGFATAL, "Design %s: unknown parameter %s",
+					design, name);
+			}
+			sweep->n_params++;
+		}
+	}
+
+	if (0 == sweep->n_params) {
+		CloseTextFile(&f);
+		LogError(logfp, LOGFATAL, "Design %s does not list any parameters", design);
+	}
+
+	// one variant per line
+	n_alloc = 0;
+	while (GetATextLine(&f)) {
+		if (sweep->n_variants == n_alloc) {
+			n_alloc = (0 == n_alloc) ? 64 : 2 * n_alloc;
+			sweep->values = (double *) (isnull(sweep->values) ?
+				Mem_Malloc((size_t) n_alloc * sweep->n_params * sizeof(double),
+					"SW_SWP_read_design()") :
+				Mem_ReAlloc(sweep->values,
+					(size_t) n_alloc * sweep->n_params * sizeof(double)));
+		}
+
+		s = f.line;
+		for (k = 0; k < sweep->n_params; k++) {
+			v = next_value(&s);
+			x = isnull(v) ? 0. : Str_ToDouble(v, &end);
+
+			if (isnull(v) || end == v || '\0' != *end) {
+				CloseTextFile(&f);
+				LogError(logfp, LOGFATAL, "Design %s: variant %u: %s value of %s",
+					design, sweep->n_variants + 1, isnull(v) ? "missing" : "invalid",
+					sweep->params[k].name);
+			}
+
+			sweep->values[(size_t) sweep->n_variants * sweep->n_params + k] = x;
+		}
+
+		if (!isnull(next_value(&s))) {
+			CloseTextFile(&f);
+			LogError(logfp, LOGFATAL, "Design %s: variant %u has more than %u values",
+				design, sweep->n_variants + 1, sweep->n_params);
+		}
+
+		sweep->n_variants++;
+	}
+
+	CloseTextFile(&f);
+
+	if (0 == sweep->n_variants) {
+		LogError(logfp, LOGFATAL, "Design %s does not list any variants", design);
+	}
+
+	sweep->variants = (SW_SWEEP_VARIANT *) Mem_Calloc(sweep->n_variants,
+		sizeof(SW_SWEEP_VARIANT), "SW_SWP_read_design()");
+}
+
+
+/**
+@brief Simulate all variants of a sweep with a pool of worker threads
+
+The inputs of the base site are read and prepared once for the sweep
+and once per worker thread (see `SW_Sweep.c`); each variant then starts
+from an image of the prepared inputs.
+
+@param sweep Sweep of `SW_SWP_read_design()`; updated with the status,
+  summary statistics, and run time of each variant.
+@param firstfile Main input file of the base site (`files.in`).
+@param n_threads Number of worker threads; `0` uses
+  `SW_BAT_default_nthreads()`. At most one thread per variant is used.
+*/
+void SW_SWP_run(SW_SWEEP *sweep, const char *firstfile, unsigned int n_threads) {
+	SW_SWEEP_STATE st;
+	SW_SWEEP_WORKER *workers;
+	pthread_t *threads;
+	struct timespec start;
+	unsigned int i;
+
+	if (0 == n_threads) {
+		n_threads = SW_BAT_default_nthreads();
+	}
+	n_threads = min(n_threads, sweep->n_variants);
+	n_threads = max(n_threads, 1);
+
+	timespec_get(&start, TIME_UTC);
+
+	memset(&st, 0, sizeof st);
+	st.sweep = sweep;
+	pthread_mutex_init(&st.lock, NULL);
+
+	for (i = 0; i < sweep->n_variants; i++) {
+		sweep->variants[i].failed = swFALSE;
+		sweep->variants[i].msg[0] = '\0';
+	}
+
+	prepare_base(&st, firstfile);
+
+	workers = (SW_SWEEP_WORKER *) Mem_Calloc(n_threads, sizeof(SW_SWEEP_WORKER), "SW_SWP_run()");
+	threads = (pthread_t *) Mem_Calloc(n_threads, sizeof(pthread_t), "SW_SWP_run()");
+
+	for (i = 0; i < n_threads; i++) {
+		workers[i].st = &st;
+		workers[i].id = i;
+		setup_worker(&workers[i], firstfile);
+	}
+
+	// the logfile is not truncated anymore by the setup of a run
+	FlushLogBuffer(&st.logbuf, st.logfile);
+
+	for (i = 0; i < n_threads; i++) {
+		if (0 != pthread_create(&threads[i], NULL, sweep_worker, &workers[i])) {
+			LogError(logfp, LOGFATAL, "Cannot start worker thread %u of sweep", i);
+		}
+	}
+
+	for (i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	if (st.logged) {
+		logged = swTRUE;
+	}
+
+	sweep->n_failed = 0;
+	for (i = 0; i < sweep->n_variants; i++) {
+		if (sweep->variants[i].failed) {
+			sweep->n_failed++;
+		}
+	}
+
+	for (i = 0; i < n_threads; i++) {
+		SW_CTL_activate_run(workers[i].sw);
+		SW_CTL_free_snapshot(&workers[i].snap);
+		SW_CTL_clear_model(workers[i].sw, swTRUE);
+		Mem_Free(workers[i].sw);
+	}
+	SW_CTL_activate_run(NULL);
+
+	Mem_Free(workers);
+	Mem_Free(threads);
+	pthread_mutex_destroy(&st.lock);
+
+	sweep->n_threads = n_threads;
+	sweep->seconds = seconds_since(&start);
+}
+
+
+/**
+@brief Write the results table of a sweep
+
+One row per variant: the number of the variant (base1, i.e., the line of
+the design without header, comments, and empty lines), its parameter
+values, its status (`ok` or `failed`), and its summary statistics (see
+`SW_OUT_write_summary_header()`; `NA` if the variant failed).
+
+@param sweep Sweep after `SW_SWP_run()`.
+@param fname Name of the csv file.
+*/
+void SW_SWP_write_results(const SW_SWEEP *sweep, const char *fname) {
+	FILE *f = OpenFile(fname, "w");
+	const SW_SWEEP_VARIANT *v;
+	unsigned int i, k;
+
+	fprintf(f, "variant");
+	for (k = 0; k < sweep->n_params; k++) {
+		fprintf(f, ",%s", sweep->params[k].name);
+	}
+	fprintf(f, ",status");
+	SW_OUT_write_summary_header(f, SW_SWP_BINWIDTH);
+	fprintf(f, "\n");
+
+	for (i = 0; i < sweep->n_variants; i++) {
+		v = &sweep->variants[i];
+
+		fprintf(f, "%u", i + 1);
+		for (k = 0; k < sweep->n_params; k++) {
+			fprintf(f, ",%.10g", sweep->values[(size_t) i * sweep->n_params + k]);
+		}
+		fprintf(f, ",%s", v->failed ? "failed" : "ok");
+		SW_OUT_write_summary_row(f, v->failed ? NULL : &v->summary);
+		fprintf(f, "\n");
+	}
+
+	CloseFile(&f);
+}
+
+
+/**
+@brief Print the number of simulated and failed variants of a sweep
+
+@param sweep Sweep after `SW_SWP_run()`.
+*/
+void SW_SWP_print_summary(const SW_SWEEP *sweep) {
+	unsigned int i;
+
+	swprintf(
+		"Sweep: %u variants simulated by %u thread%s in %.2f s, %u succeeded, %u failed\n",
+		sweep->n_variants, sweep->n_threads, (sweep->n_threads > 1) ? "s" : "",
+		sweep->seconds,
+		sweep->n_variants - sweep->n_failed, sweep->n_failed
+	);
+
+	if (!isnull(sweep->hist)) {
+		swprintf("Sweep: variants share the weather of %u years\n", sweep->n_years);
+	}
+
+	for (i = 0; i < sweep->n_variants; i++) {
+		if (sweep->variants[i].failed) {
+			swprintf("  FAILED variant %u: %s\n", i + 1, sweep->variants[i].msg);
+		}
+	}
+}
+
+
+/**
+@brief Free the memory of a sweep
+
+@param sweep Sweep of `SW_SWP_read_design()`.
+*/
+void SW_SWP_deconstruct(SW_SWEEP *sweep) {
+	if (!isnull(sweep->params)) {
+		Mem_Free(sweep->params);
+	}
+	if (!isnull(sweep->values)) {
+		Mem_Free(sweep->values);
+	}
+	if (!isnull(sweep->variants)) {
+		Mem_Free(sweep->variants);
+	}
+	if (!isnull(sweep->hist)) {
+		Mem_Free(sweep->hist);
+	}
+
+	SW_SHR_deconstruct(&sweep->shared);
+	memset(sweep, 0, sizeof *sweep);
+}
@@ -0,0 +1,102 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Sweep.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Run many variants of one site with SOILWAT2-standalone,
+ *           e.g., for calibrations and sensitivity analyses: a design
+ *           matrix lists the parameter values of each variant, the
+ *           inputs of the base site are prepared once, a pool of worker
+ *           threads simulates the variants, and the summary statistics
+ *           of each variant are collected into one results table.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_SWEEP_H
+#define SW_SWEEP_H
+
+#include <stdio.h>
+#include "generic.h"
+#include "filefuncs.h"
+#include "SW_Defines.h"
+#include "SW_Weather.h"
+#include "SW_Output_reduce.h"
+#include "SW_Shared.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+#define SW_SWEEP_NAMELEN 32 /**< size of the name of a parameter of a design */
+#define SW_SWEEP_FILENAME "sw2_sweep.csv" /**< results table of a sweep of SOILWAT2-standalone */
+
+/** Parameters that a design can override, see `SW_SWP_read_design()` */
+typedef enum {
+	eSwpSWCMin, eSwpSWCInit, eSwpSWCWet, /**< `siteparam.in`: soil water content */
+	eSwpPETScale, eSwpRunoff, eSwpRunon,
+	eSwpTminAccu2, eSwpTmaxCrit, eSwpLambdasnow, eSwpRmeltMin, eSwpRmeltMax, /**< snow */
+	eSwpSlowDrain,
+	eSwpCO2Bio, eSwpCO2WUE, /**< CO2 multipliers turned on (1) or off (0) */
+	eSwpEvco, eSwpTrco, /**< `soils.in`: coefficients of a soil layer */
+	eSwpSWPcrit /**< `veg.in`: critical soil water potential [MPa], as in `veg.in` */
+} SW_SWEEP_KIND;
+
+/** A column of a design */
+typedef struct {
+	char name[SW_SWEEP_NAMELEN]; /**< as in the header of the design */
+	SW_SWEEP_KIND kind;
+	int veg; /**< vegetation type of `eSwpTrco` and `eSwpSWPcrit`, e.g., `SW_GRASS` */
+	LyrIndex layer; /**< soil layer (base0) of `eSwpEvco` and `eSwpTrco` */
+} SW_SWEEP_PARAM;
+
+/** One variant of a sweep */
+typedef struct {
+	Bool failed; /**< TRUE if the simulation of the variant failed */
+	char msg[ERRSTRLEN]; /**< error message if the variant failed */
+	SW_OUT_SUMMARY summary; /**< summary statistics of the simulation */
+	double seconds; /**< run time of the variant */
+} SW_SWEEP_VARIANT;
+
+/** A sweep: variants of a base site */
+typedef struct {
+	SW_SWEEP_PARAM *params; /**< columns of the design */
+	unsigned int n_params;
+	double *values; /**< value of parameter `k` of variant `i` is `values[i * n_params + k]` */
+	SW_SWEEP_VARIANT *variants;
+	unsigned int n_variants, /**< number of variants of the sweep */
+		n_failed; /**< number of failed variants, updated by `SW_SWP_run()` */
+
+	unsigned int n_threads; /**< worker threads of the last `SW_SWP_run()` */
+	double seconds; /**< run time of the last `SW_SWP_run()` */
+
+	SW_WEATHER_HIST *hist; /**< daily weather of the simulated years that the variants
+		share, see `SW_WTH_set_memory()`; NULL if each variant reads its weather */
+	TimeInt first_year, n_years; /**< years of `hist` */
+	SW_SHARED_INPUTS shared; /**< input tables that are shared by the variants, see `SW_Shared.c` */
+} SW_SWEEP;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_SWP_read_design(SW_SWEEP *sweep, const char *design);
+void SW_SWP_run(SW_SWEEP *sweep, const char *firstfile, unsigned int n_threads);
+void SW_SWP_write_results(const SW_SWEEP *sweep, const char *fname);
+void SW_SWP_print_summary(const SW_SWEEP *sweep);
+void SW_SWP_deconstruct(SW_SWEEP *sweep);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
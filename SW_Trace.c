@@ -0,0 +1,246 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Trace.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Write the spans of `SW_Trace.h` to a trace file in the
+ *           Chrome trace event format (JSON array format).
+ *
+ *           The trace is shared by all threads of the process: each
+ *           event is formatted by its thread and appended to the file
+ *           under a lock. Each thread is identified by a small thread id
+ *           ("tid") that is assigned when it records its first event.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "SW_Trace.h"
+
+#define SW_TRC_EVENTSIZE 1024 /**< maximum length of an event */
+
+
+/* =================================================== */
+/*                  Global Variables                   */
+/* --------------------------------------------------- */
+
+/** TRUE if the trace file is open, see `SW_TRC_open()` */
+Bool SW_TRC_on = swFALSE;
+
+
+/* =================================================== */
+/*                Module-Level Variables               */
+/* --------------------------------------------------- */
+
+static FILE *trace_fp = NULL;
+static pthread_mutex_t trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct timespec trace_t0; /**< time when the trace was opened */
+static int trace_ntids = 0; /**< number of assigned thread ids */
+
+static SW_THREAD_LOCAL int trace_tid = 0; /**< thread id; 0 if not yet assigned */
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Copy `s` into `buf` as a JSON string (without quotes)
+
+    @return Number of characters written (excluding the terminating null).
+*/
+static int json_str(char *buf, size_t n, const char *s) {
+	size_t i = 0;
+
+	for (; *s != '\0' && i + 2 < n; s++) {
+		if ('"' == *s || '\\' == *s) {
+			buf[i++] = '\\';
+			buf[i++] = *s;
+		} else if ((unsigned char) *s >= 0x20) {
+			buf[i++] = *s;
+		}
+	}
+	buf[i] = '\0';
+
+	return (int) i;
+}
+
+/** Append a formatted event to the trace file
+
+    @note Call with `trace_lock` held.
+*/
+static void write_event(const char *event) {
+	if (!isnull(trace_fp)) {
+		fputs(",\n", trace_fp);
+		fputs(event, trace_fp);
+	}
+}
+
+/** Assign the thread id of the calling thread (if not yet assigned)
+
+    @note Call with `trace_lock` held.
+*/
+static void assign_tid(void) {
+	if (0 == trace_tid) {
+		trace_tid = ++trace_ntids;
+	}
+}
+
+/** Record a complete event of the calling thread; `args` is the content
+    of the "args" object or empty */
+static void span(double start, const char *name, const char *cat, const char *args) {
+	char event[SW_TRC_EVENTSIZE], jname[128];
+	double end = SW_TRC_now();
+
+	json_str(jname, sizeof jname, name);
+
+	pthread_mutex_lock(&trace_lock);
+	assign_tid();
+	snprintf(event, sizeof event,
+		"{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+		"\"pid\":1,\"tid\":%d,\"args\":{%s}}",
+		jname, cat, start, end - start, trace_tid, args);
+	write_event(event);
+	pthread_mutex_unlock(&trace_lock);
+}
+
+
+/* =================================================== */
+/*             Global Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Open the trace file and start recording spans of all threads
+
+@param fname Name of the trace file, e.g., `trace.json`.
+*/
+void SW_TRC_open(const char *fname) {
+	trace_fp = OpenFile(fname, "w");
+	timespec_get(&trace_t0, TIME_UTC);
+
+	// the first element names the process; all further events are preceded by a comma
+	fputs("[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+		"\"args\":{\"name\":\"SOILWAT2\"}}", trace_fp);
+
+	SW_TRC_on = swTRUE;
+	SW_TRC_thread_name("main");
+}
+
+
+/**
+@brief Stop recording and close the trace file
+
+@note Call this routine after all other threads are done; it is safe to
+  call it more than once, e.g., from an `atexit()` handler.
+*/
+void SW_TRC_close(void) {
+	if (isnull(trace_fp)) {
+		return;
+	}
+
+	SW_TRC_on = swFALSE;
+
+	pthread_mutex_lock(&trace_lock);
+	fputs("\n]\n", trace_fp);
+	CloseFile(&trace_fp);
+	pthread_mutex_unlock(&trace_lock);
+}
+
+
+/**
+@brief Name the calling thread in the trace, e.g., "worker 2"
+
+@param name Name of the thread.
+*/
+void SW_TRC_thread_name(const char *name) {
+	char event[SW_TRC_EVENTSIZE], jname[128];
+
+	if (!SW_TRC_on) {
+		return;
+	}
+
+	json_str(jname, sizeof jname, name);
+
+	pthread_mutex_lock(&trace_lock);
+	assign_tid();
+	snprintf(event, sizeof event,
+		"{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,"
+		"\"args\":{\"name\":\"%s\"}}",
+		trace_tid, jname);
+	write_event(event);
+	pthread_mutex_unlock(&trace_lock);
+}
+
+
+/**
+@brief Time since the trace was opened
+
+@return Microseconds.
+*/
+double SW_TRC_now(void) {
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+
+	return 1e6 * (double) (now.tv_sec - trace_t0.tv_sec) +
+		1e-3 * (double) (now.tv_nsec - trace_t0.tv_nsec);
+}
+
+
+/**
+@brief Record a span of the calling thread that started at `start`
+
+@param start Begin of the span, see `SW_TRC_now()`.
+@param name Name of the span.
+@param cat Category of the span (a JSON string without special characters),
+  e.g., "input" or "output".
+@param key Name of an argument of the span; NULL if none.
+@param value Value of the argument.
+*/
+void SW_TRC_span(double start, const char *name, const char *cat,
+	const char *key, const char *value) {
+
+	char args[SW_TRC_EVENTSIZE / 2];
+	int n;
+
+	args[0] = '\0';
+
+	if (!isnull(key)) {
+		n = snprintf(args, sizeof args, "\"%s\":\"", key);
+		n += json_str(args + n, sizeof args - n - 1, value);
+		strcpy(args + n, "\"");
+	}
+
+	span(start, name, cat, args);
+}
+
+
+/**
+@brief Record a span of the calling thread with an integer argument
+
+@param start Begin of the span, see `SW_TRC_now()`.
+@param name Name of the span.
+@param cat Category of the span.
+@param key Name of the argument.
+@param value Value of the argument, e.g., the simulated year.
+*/
+void SW_TRC_span_int(double start, const char *name, const char *cat,
+	const char *key, long value) {
+
+	char args[128];
+
+	snprintf(args, sizeof args, "\"%s\":%ld", key, value);
+
+	span(start, name, cat, args);
+}
@@ -0,0 +1,83 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Trace.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Optional trace of timed spans of a process (e.g., site setup,
+ *           simulated years, input reads, and output flushes of the sites
+ *           of a batch) in the Chrome trace event format, which can be
+ *           loaded into Perfetto (https://ui.perfetto.dev) or
+ *           chrome://tracing (see option -t of SOILWAT2).
+ *
+ *           A span is recorded as a complete event ("ph":"X") with begin
+ *           time and duration on the thread that ran it; a span that is
+ *           left by a fatal error (e.g., a failed site of a batch) is not
+ *           recorded and does not leave an unmatched begin event.
+ *
+ *           Spans are timed only if the trace is open (`SW_TRC_on`);
+ *           otherwise, `SW_TRC_START()` and `SW_TRC_STOP*()` cost a test
+ *           of a flag.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_TRACE_H
+#define SW_TRACE_H
+
+#include "generic.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*             Global Variable Declarations            */
+/* --------------------------------------------------- */
+extern Bool SW_TRC_on;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_TRC_open(const char *fname);
+void SW_TRC_close(void);
+void SW_TRC_thread_name(const char *name);
+double SW_TRC_now(void);
+void SW_TRC_span(double start, const char *name, const char *cat,
+	const char *key, const char *value);
+void SW_TRC_span_int(double start, const char *name, const char *cat,
+	const char *key, long value);
+
+
+/** Start timing span `v` (within a block of code) */
+#define SW_TRC_START(v) \
+	double sw_trc_##v = SW_TRC_on ? SW_TRC_now() : 0.
+
+/** Stop timing span `v` (started in the same block) and record it */
+#define SW_TRC_STOP(v, name, cat) \
+	do { \
+		if (SW_TRC_on) SW_TRC_span(sw_trc_##v, (name), (cat), NULL, NULL); \
+	} while (0)
+
+/** Stop timing span `v` and record it with argument `key` (text) */
+#define SW_TRC_STOP_STR(v, name, cat, key, value) \
+	do { \
+		if (SW_TRC_on) SW_TRC_span(sw_trc_##v, (name), (cat), (key), (value)); \
+	} while (0)
+
+/** Stop timing span `v` and record it with argument `key` (integer) */
+#define SW_TRC_STOP_INT(v, name, cat, key, value) \
+	do { \
+		if (SW_TRC_on) SW_TRC_span_int(sw_trc_##v, (name), (cat), (key), (long) (value)); \
+	} while (0)
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -24,6 +24,11 @@
  06/26/2013	(rjm)	closed open files in function SW_VES_read() or if LogError() with LOGFATAL is called in _read_spp()
  08/21/2013	(clk)	changed the line v = SW_VegEstab.parms[ _new_species() ]; -> v = SW_VegEstab.parms[ count ], where count = _new_species();
  for some reason, without this change, a segmenation fault was occuring
+ 10/15/2026	SW_VES_read() and _read_spp() read with SW_TEXTFILE; the name of a species file
+ 				remains valid while the species file is read
+ 10/15/2026	species are initialized by SW_VES_init_run() (after the soil layers);
+ 				SW_VES_checkestab() checks all species of a day as a batch over the
+ 				arrays of SW_VEGESTAB_SPP and drops species that are done for the year
  */
 /********************************************************/
 /********************************************************/
@@ -46,22 +51,18 @@
 #include "SW_SoilWater.h"
 #include "SW_Weather.h"
 #include "SW_VegEstab.h"
+#include "SW_Run.h"
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_MODEL SW_Model;
-extern SW_SITE SW_Site;
-extern SW_WEATHER SW_Weather;
-extern SW_SOILWAT SW_Soilwat;
 extern Bool EchoInits;
 
-SW_VEGESTAB SW_VegEstab; /* declared here, externed elsewhere */
 
 /* =================================================== */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
-static char *MyFileName;
+static SW_THREAD_LOCAL char *MyFileName;
 
 /* =================================================== */
 /* =================================================== */
@@ -69,8 +70,10 @@ static char *MyFileName;
 /* --------------------------------------------------- */
 static void _sanity_check(unsigned int sppnum);
 static void _read_spp(const char *infile);
-static void _checkit(TimeInt doy, unsigned int sppnum);
-static void _zero_state(unsigned int sppnum);
+static void _checkit(TimeInt doy);
+static void _zero_state(void);
+static void _alloc_spp(void);
+static void _free_spp(void);
 
 /* =================================================== */
 /* =================================================== */
@@ -115,6 +118,8 @@ void SW_VES_deconstruct(void)
 	// De-allocate parameters
 	if (SW_VegEstab.count > 0)
 	{
+		_free_spp();
+
 		for (i = 0; i < SW_VegEstab.count; i++)
 		{
 			Mem_Free(SW_VegEstab.parms[i]);
@@ -131,12 +136,15 @@ void SW_VES_deconstruct(void)
 		// De-allocate days and parameters
 		if (SW_VegEstab.count > 0)
 		{
-			if (!isnull(SW_VegEstab.p_oagg[pd]->days)) {
-				Mem_Free(SW_VegEstab.p_oagg[eSW_Year]->days);
+			if (!isnull(SW_VegEstab.p_oagg[pd]) &&
+				!isnull(SW_VegEstab.p_oagg[pd]->days)) {
+				Mem_Free(SW_VegEstab.p_oagg[pd]->days);
+				SW_VegEstab.p_oagg[pd]->days = NULL;
 			}
 
 			if (!isnull(SW_VegEstab.p_accu[pd]->days)) {
-				Mem_Free(SW_VegEstab.p_accu[eSW_Year]->days);
+				Mem_Free(SW_VegEstab.p_accu[pd]->days);
+				SW_VegEstab.p_accu[pd]->days = NULL;
 			}
 		}
 
@@ -168,32 +176,29 @@ void SW_VES_new_year(void) {
 */
 void SW_VES_read(void) {
 	/* =================================================== */
-	FILE *f;
+	SW_TEXTFILE f;
 
 	MyFileName = SW_F_name(eVegEstab);
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
 	SW_VegEstab.use = swTRUE;
 
 	/* if data file empty or useflag=0, assume no
 	 * establishment checks and just continue the model run. */
-	if (!GetALine(f, inbuf) || *inbuf == '0') {
+	if (!GetATextLine(&f) || *f.line == '0') {
 		SW_VegEstab.use = swFALSE;
 		if (EchoInits)
 			LogError(logfp, LOGNOTE, "Establishment not used.\n");
-		CloseFile(&f);
+		CloseTextFile(&f);
 		return;
 	}
 
-	while (GetALine(f, inbuf)) {
-		_read_spp(inbuf);
+	while (GetATextLine(&f)) {
+		_read_spp(f.line);
 	}
 
-	CloseFile(&f);
+	CloseTextFile(&f);
 
 	SW_VegEstab_construct();
-
-	if (EchoInits)
-		_echo_VegEstab();
 }
 
 /**
@@ -201,26 +206,73 @@ void SW_VES_read(void) {
 */
 void SW_VegEstab_construct(void)
 {
+	if (SW_VegEstab.count > 0) {
+		SW_VegEstab.p_accu[eSW_Year]->days = (TimeInt *) Mem_Calloc(
+			SW_VegEstab.count, sizeof(TimeInt), "SW_VegEstab_construct()");
+	}
+}
+
+/**
+@brief Initialize the species for a simulation run: convert their soil
+			water requirements for the soil layers of the site and set up the
+			arrays of SW_VEGESTAB_SPP.
+
+@note Call this routine after SW_SIT_init_run().
+*/
+void SW_VES_init_run(void) {
+	SW_VEGESTAB_SPP *s = &SW_VegEstab.spp;
+	SW_VEGESTAB_INFO *v;
 	IntU i;
 
-	for (i = 0; i < SW_VegEstab.count; i++)
+	if (0 == SW_VegEstab.count)
+		return;
+
+	if (isnull(s->active))
+		_alloc_spp();
+
+	s->max_estab_lyrs = 0;
+
+	for (i = 0; i < SW_VegEstab.count; i++) {
 		_spp_init(i);
 
-	if (SW_VegEstab.count > 0) {
-		SW_VegEstab.p_accu[eSW_Year]->days = (TimeInt *) Mem_Calloc(
-			SW_VegEstab.count, sizeof(TimeInt), "SW_VegEstab_construct()");
+		v = SW_VegEstab.parms[i];
+		s->min_pregerm_days[i] = v->min_pregerm_days;
+		s->max_pregerm_days[i] = v->max_pregerm_days;
+		s->min_wetdays_for_germ[i] = v->min_wetdays_for_germ;
+		s->max_drydays_postgerm[i] = v->max_drydays_postgerm;
+		s->min_wetdays_for_estab[i] = v->min_wetdays_for_estab;
+		s->min_days_germ2estab[i] = v->min_days_germ2estab;
+		s->max_days_germ2estab[i] = v->max_days_germ2estab;
+		s->estab_lyrs[i] = v->estab_lyrs;
+		s->min_swc_germ[i] = v->min_swc_germ;
+		s->min_swc_estab[i] = v->min_swc_estab;
+		s->min_temp_germ[i] = v->min_temp_germ;
+		s->max_temp_germ[i] = v->max_temp_germ;
+		s->min_temp_estab[i] = v->min_temp_estab;
+		s->max_temp_estab[i] = v->max_temp_estab;
+
+		s->max_estab_lyrs = max(s->max_estab_lyrs, v->estab_lyrs);
 	}
+
+	_zero_state();
+
+	if (EchoInits)
+		_echo_VegEstab();
 }
 
 /**
-@brief Check that each count coincides with a day of the year.
+@brief Check germination and establishment of all species for today.
 */
 void SW_VES_checkestab(void) {
 	/* =================================================== */
-	IntUS i;
 
-	for (i = 0; i < SW_VegEstab.count; i++)
-		_checkit(SW_Model.doy, i);
+	if (SW_Model.doy == SW_Model.firstdoy) {
+		_zero_state();
+	}
+
+	if (SW_VegEstab.spp.n_active > 0) {
+		_checkit(SW_Model.doy);
+	}
 }
 
 /* =================================================== */
@@ -228,171 +280,239 @@ void SW_VES_checkestab(void) {
 /*            Private Function Definitions             */
 /* --------------------------------------------------- */
 
-static void _checkit(TimeInt doy, unsigned int sppnum) {
+static void _checkit(TimeInt doy) {
+	/* Each species follows the same steps as a single plant (see the
+	 * description in the header of this file); the steps are evaluated
+	 * as conditions for all species that are still checked this year
+	 * instead of branching per species. */
 
-	SW_VEGESTAB_INFO *v = SW_VegEstab.parms[sppnum];
+	SW_VEGESTAB_SPP *s = &SW_VegEstab.spp;
+	SW_VEGESTAB_INFO **parms = SW_VegEstab.parms;
 	SW_WEATHER_2DAYS *wn = &SW_Weather.now;
 	SW_SOILWAT *sw = &SW_Soilwat;
 
-	IntU i;
+	IntU a, n = 0;
+	unsigned int i, k;
+	int on, germ, late, watch, dry, failed, grown, estab;
 	RealF avgtemp = wn->temp_avg[Today], /* avg of today's min/max temp */
-	avgswc; /* avg_swc today */
+	avgswc, /* avg_swc today */
+	sumswc[MAX_LAYERS + 1]; /* swc summed over the top layers, shared by all species */
 
-	if (doy == SW_Model.firstdoy) {
-		_zero_state(sppnum);
-	}
+	sumswc[0] = 0.;
+	for (i = 0; i < s->max_estab_lyrs; i++)
+		sumswc[i + 1] = sumswc[i] + sw->swcBulk[Today][i];
 
-	if (v->no_estab || v->estab_doy > 0)
-		goto LBL_Normal_Exit;
+	for (a = 0; a < s->n_active; a++) {
+		k = s->active[a];
 
-	/* keep up with germinating wetness regardless of current state */
-	if (GT(sw->swcBulk[Today][0], v->min_swc_germ))
-		v->wetdays_for_germ++;
-	else
-		v->wetdays_for_germ = 0;
+		/* keep up with germinating wetness regardless of current state */
+		s->wetdays_for_germ[k] = GT(sw->swcBulk[Today][0], s->min_swc_germ[k]) ?
+			s->wetdays_for_germ[k] + 1 : 0;
 
-	if (doy < v->min_pregerm_days)
-		goto LBL_Normal_Exit;
+		on = doy >= s->min_pregerm_days[k];
 
-	/* ---- check for germination, establishment */
-	if (!v->germd && v->wetdays_for_germ >= v->min_wetdays_for_germ) {
+		/* ---- check for germination (temp doesn't affect wetdays) */
+		germ = on && !s->germd[k] &&
+			s->wetdays_for_germ[k] >= s->min_wetdays_for_germ[k];
+		late = germ && doy > s->max_pregerm_days[k];
 
-		if (doy < v->min_pregerm_days)
-			goto LBL_Normal_Exit;
-		if (doy > v->max_pregerm_days) {
-			v->no_estab = swTRUE;
-			goto LBL_Normal_Exit;
-		}
-		/* temp doesn't affect wetdays */
-		if (LT(avgtemp, v->min_temp_germ) || GT(avgtemp, v->max_temp_germ))
-			goto LBL_Normal_Exit;
+		if (germ && !late && !LT(avgtemp, s->min_temp_germ[k]) &&
+			!GT(avgtemp, s->max_temp_germ[k]))
+			s->germd[k] = swTRUE;
 
-		v->germd = swTRUE;
-		goto LBL_Normal_Exit;
+		/* ---- otherwise, continue monitoring sprout's progress:
+		 * any dry period (> max_drydays) or temp out of range
+		 * after germination means restart */
+		watch = on && !germ;
 
-	} else { /* continue monitoring sprout's progress */
+		avgswc = sumswc[s->estab_lyrs[k]] / (RealF) s->estab_lyrs[k];
+		dry = LT(avgswc, s->min_swc_estab[k]);
 
-		/* any dry period (> max_drydays) or temp out of range
-		 * after germination means restart */
-		for (i = avgswc = 0; i < v->estab_lyrs;)
-			avgswc += sw->swcBulk[Today][i++];
-		avgswc /= (RealF) v->estab_lyrs;
-		if (LT(avgswc, v->min_swc_estab)) {
-			v->drydays_postgerm++;
-			v->wetdays_for_estab = 0;
-		} else {
-			v->drydays_postgerm = 0;
-			v->wetdays_for_estab++;
-		}
+		s->drydays_postgerm[k] = !watch ? s->drydays_postgerm[k] :
+			dry ? s->drydays_postgerm[k] + 1 : 0;
+		s->wetdays_for_estab[k] = !watch ? s->wetdays_for_estab[k] :
+			dry ? 0 : s->wetdays_for_estab[k] + 1;
 
-		if (v->drydays_postgerm > v->max_drydays_postgerm || LT(avgtemp, v->min_temp_estab) || GT(avgtemp, v->max_temp_estab)) {
-			/* too bad: discontinuity in environment, plant dies, start over */
-			goto LBL_EstabFailed_Exit;
-		}
+		failed = watch && (s->drydays_postgerm[k] > s->max_drydays_postgerm[k] ||
+			LT(avgtemp, s->min_temp_estab[k]) || GT(avgtemp, s->max_temp_estab[k]));
+
+		s->germ_days[k] += (watch && !failed) ? 1 : 0;
+
+		grown = watch && !failed &&
+			s->wetdays_for_estab[k] >= s->min_wetdays_for_estab[k] &&
+			s->germ_days[k] >= s->min_days_germ2estab[k];
 
-		v->germ_days++;
+		/* too bad: discontinuity in environment, plant dies, start over */
+		failed = failed || (grown && s->germ_days[k] > s->max_days_germ2estab[k]);
+		estab = grown && !failed;
 
-		if (v->wetdays_for_estab < v->min_wetdays_for_estab || v->germ_days < v->min_days_germ2estab) {
-			goto LBL_Normal_Exit;
-			/* no need to zero anything */
+		if (failed) {
+			/* allows us to try again if not too late */
+			s->wetdays_for_estab[k] = 0;
+			s->germ_days[k] = 0;
+			s->germd[k] = swFALSE;
 		}
 
-		if (v->germ_days > v->max_days_germ2estab)
-			goto LBL_EstabFailed_Exit;
+		if (estab)
+			parms[k]->estab_doy = doy;
 
-		v->estab_doy = SW_Model.doy;
-		goto LBL_Normal_Exit;
+		/* no more than one establishment per species per year;
+		 * if too late for germination, can't attempt estab for remainder of year */
+		s->active[n] = k;
+		n += (late || estab) ? 0 : 1;
 	}
 
-	LBL_EstabFailed_Exit:
-	/* allows us to try again if not too late */
-	v->wetdays_for_estab = 0;
-	v->germ_days = 0;
-	v->germd = swFALSE;
-
-	LBL_Normal_Exit: return;
+	s->n_active = n;
 }
 
-static void _zero_state(unsigned int sppnum) {
+static void _zero_state(void) {
 	/* =================================================== */
 	/* zero any values that need it for the new growing season */
 
-	SW_VEGESTAB_INFO *v = SW_VegEstab.parms[sppnum];
+	SW_VEGESTAB_SPP *s = &SW_VegEstab.spp;
+	IntU i;
+
+	for (i = 0; i < SW_VegEstab.count; i++) {
+		SW_VegEstab.parms[i]->estab_doy = 0;
+		s->germd[i] = swFALSE;
+		s->germ_days[i] = s->drydays_postgerm[i] = 0;
+		s->wetdays_for_germ[i] = s->wetdays_for_estab[i] = 0;
+		s->active[i] = i;
+	}
+
+	s->n_active = SW_VegEstab.count;
+}
+
+/* Allocate the arrays of SW_VEGESTAB_SPP for all species */
+static void _alloc_spp(void) {
+	const char *me = "SW_VES_init_run()";
+	SW_VEGESTAB_SPP *s = &SW_VegEstab.spp;
+	IntU n = SW_VegEstab.count;
+
+	s->germ_days = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->drydays_postgerm = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->wetdays_for_germ = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->wetdays_for_estab = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->germd = (Bool *) Mem_Calloc(n, sizeof(Bool), me);
+	s->active = (unsigned int *) Mem_Calloc(n, sizeof(unsigned int), me);
+
+	s->min_pregerm_days = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->max_pregerm_days = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->min_wetdays_for_germ = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->max_drydays_postgerm = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->min_wetdays_for_estab = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->min_days_germ2estab = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->max_days_germ2estab = (TimeInt *) Mem_Calloc(n, sizeof(TimeInt), me);
+	s->estab_lyrs = (unsigned int *) Mem_Calloc(n, sizeof(unsigned int), me);
+	s->min_swc_germ = (RealF *) Mem_Calloc(n, sizeof(RealF), me);
+	s->min_swc_estab = (RealF *) Mem_Calloc(n, sizeof(RealF), me);
+	s->min_temp_germ = (RealF *) Mem_Calloc(n, sizeof(RealF), me);
+	s->max_temp_germ = (RealF *) Mem_Calloc(n, sizeof(RealF), me);
+	s->min_temp_estab = (RealF *) Mem_Calloc(n, sizeof(RealF), me);
+	s->max_temp_estab = (RealF *) Mem_Calloc(n, sizeof(RealF), me);
+}
+
+/* De-allocate the arrays of SW_VEGESTAB_SPP */
+static void _free_spp(void) {
+	SW_VEGESTAB_SPP *s = &SW_VegEstab.spp;
+
+	if (isnull(s->active))
+		return;
 
-	v->no_estab = v->germd = swFALSE;
-	v->estab_doy = v->germ_days = v->drydays_postgerm = 0;
-	v->wetdays_for_germ = v->wetdays_for_estab = 0;
+	Mem_Free(s->germ_days);
+	Mem_Free(s->drydays_postgerm);
+	Mem_Free(s->wetdays_for_germ);
+	Mem_Free(s->wetdays_for_estab);
+	Mem_Free(s->germd);
+	Mem_Free(s->active);
+
+	Mem_Free(s->min_pregerm_days);
+	Mem_Free(s->max_pregerm_days);
+	Mem_Free(s->min_wetdays_for_germ);
+	Mem_Free(s->max_drydays_postgerm);
+	Mem_Free(s->min_wetdays_for_estab);
+	Mem_Free(s->min_days_germ2estab);
+	Mem_Free(s->max_days_germ2estab);
+	Mem_Free(s->estab_lyrs);
+	Mem_Free(s->min_swc_germ);
+	Mem_Free(s->min_swc_estab);
+	Mem_Free(s->min_temp_germ);
+	Mem_Free(s->max_temp_germ);
+	Mem_Free(s->min_temp_estab);
+	Mem_Free(s->max_temp_estab);
+
+	memset(s, 0, sizeof *s);
 }
 
 static void _read_spp(const char *infile) {
 	/* =================================================== */
 	SW_VEGESTAB_INFO *v;
 	const int nitems = 15;
-	FILE *f;
+	SW_TEXTFILE f;
 	int lineno = 0;
 	char name[80]; /* only allow 4 char sppnames */
 
-	f = OpenFile(infile, "r");
+	OpenTextFile(&f, infile);
 
 	unsigned int count;
 
 	count = _new_species();
 	v = SW_VegEstab.parms[count];
 
-	strcpy(v->sppFileName, inbuf); //have to copy before the pointer infile gets reset below by getAline
+	strcpy(v->sppFileName, infile);
 
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 		switch (lineno) {
 		case 0:
-			strcpy(name, inbuf);
+			strcpy(name, f.line);
 			break;
 		case 1:
-			v->estab_lyrs = atoi(inbuf);
+			v->estab_lyrs = atoi(f.line);
 			break;
 		case 2:
-			v->bars[SW_GERM_BARS] = fabs(atof(inbuf));
+			v->bars[SW_GERM_BARS] = fabs(Str_ToDouble(f.line, NULL));
 			break;
 		case 3:
-			v->bars[SW_ESTAB_BARS] = fabs(atof(inbuf));
+			v->bars[SW_ESTAB_BARS] = fabs(Str_ToDouble(f.line, NULL));
 			break;
 		case 4:
-			v->min_pregerm_days = atoi(inbuf);
+			v->min_pregerm_days = atoi(f.line);
 			break;
 		case 5:
-			v->max_pregerm_days = atoi(inbuf);
+			v->max_pregerm_days = atoi(f.line);
 			break;
 		case 6:
-			v->min_wetdays_for_germ = atoi(inbuf);
+			v->min_wetdays_for_germ = atoi(f.line);
 			break;
 		case 7:
-			v->max_drydays_postgerm = atoi(inbuf);
+			v->max_drydays_postgerm = atoi(f.line);
 			break;
 		case 8:
-			v->min_wetdays_for_estab = atoi(inbuf);
+			v->min_wetdays_for_estab = atoi(f.line);
 			break;
 		case 9:
-			v->min_days_germ2estab = atoi(inbuf);
+			v->min_days_germ2estab = atoi(f.line);
 			break;
 		case 10:
-			v->max_days_germ2estab = atoi(inbuf);
+			v->max_days_germ2estab = atoi(f.line);
 			break;
 		case 11:
-			v->min_temp_germ = atof(inbuf);
+			v->min_temp_germ = Str_ToDouble(f.line, NULL);
 			break;
 		case 12:
-			v->max_temp_germ = atof(inbuf);
+			v->max_temp_germ = Str_ToDouble(f.line, NULL);
 			break;
 		case 13:
-			v->min_temp_estab = atof(inbuf);
+			v->min_temp_estab = Str_ToDouble(f.line, NULL);
 			break;
 		case 14:
-			v->max_temp_estab = atof(inbuf);
+			v->max_temp_estab = Str_ToDouble(f.line, NULL);
 			break;
 		}
 		/* check for valid name first */
 		if (0 == lineno) {
 			if (strlen(name) > MAX_SPECIESNAMELEN) {
-				CloseFile(&f);
+				CloseTextFile(&f);
 				LogError(logfp, LOGFATAL, "%s: Species name <%s> too long (> %d chars).\n Try again.\n", infile, name, MAX_SPECIESNAMELEN);
 			} else {
 				strcpy(v->sppname, name);
@@ -403,11 +523,11 @@ static void _read_spp(const char *infile) {
 	}
 
 	if (lineno < nitems) {
-		CloseFile(&f);
+		CloseTextFile(&f);
 		LogError(logfp, LOGFATAL, "%s : Too few input parameters.\n", infile);
 	}
 
-	CloseFile(&f);
+	CloseTextFile(&f);
 }
 
 /**
@@ -419,20 +539,19 @@ static void _read_spp(const char *infile) {
 void _spp_init(unsigned int sppnum) {
 
 	SW_VEGESTAB_INFO *v = SW_VegEstab.parms[sppnum];
-	SW_LAYER_INFO **lyr = SW_Site.lyr;
 	IntU i;
 
 	/* The thetas and psis etc should be initialized by now */
 	/* because init_layers() must be called prior to this routine */
 	/* (see watereqn() ) */
-	v->min_swc_germ = SW_SWPmatric2VWCBulk(lyr[0]->fractionVolBulk_gravel, v->bars[SW_GERM_BARS], 0) * lyr[0]->width;
+	v->min_swc_germ = SW_SWPmatric2VWCBulk(SW_Site.fractionVolBulk_gravel[0], v->bars[SW_GERM_BARS], 0) * SW_Site.width[0];
 
 	/* due to possible differences in layer textures and widths, we need
 	 * to average the estab swc across the given layers to peoperly
 	 * compare the actual swc average in the checkit() routine */
 	v->min_swc_estab = 0.;
 	for (i = 0; i < v->estab_lyrs; i++)
-		v->min_swc_estab += SW_SWPmatric2VWCBulk(lyr[i]->fractionVolBulk_gravel, v->bars[SW_ESTAB_BARS], i) * lyr[i]->width;
+		v->min_swc_estab += SW_SWPmatric2VWCBulk(SW_Site.fractionVolBulk_gravel[i], v->bars[SW_ESTAB_BARS], i) * SW_Site.width[i];
 	v->min_swc_estab /= v->estab_lyrs;
 
 	_sanity_check(sppnum);
@@ -441,7 +560,6 @@ void _spp_init(unsigned int sppnum) {
 
 static void _sanity_check(unsigned int sppnum) {
 	/* =================================================== */
-	SW_LAYER_INFO **lyr = SW_Site.lyr;
 	SW_VEGESTAB_INFO *v = SW_VegEstab.parms[sppnum];
 	LyrIndex min_transp_lyrs;
 	int k;
@@ -452,24 +570,24 @@ static void _sanity_check(unsigned int sppnum) {
 	}
 
 	if (v->estab_lyrs > min_transp_lyrs) {
-		LogError(logfp, LOGFATAL, "%s : Layers requested (estab_lyrs) > (# transpiration layers=%d).", MyFileName, min_transp_lyrs);
+		LogError(logfp, LOGFATAL, "%s : Layers requested (estab_lyrs) > (# transpiration layers=%d).", v->sppFileName, min_transp_lyrs);
 	}
 
 	if (v->min_pregerm_days > v->max_pregerm_days) {
-		LogError(logfp, LOGFATAL, "%s : First day of germination > last day of germination.", MyFileName);
+		LogError(logfp, LOGFATAL, "%s : First day of germination > last day of germination.", v->sppFileName);
 	}
 
 	if (v->min_wetdays_for_estab > v->max_days_germ2estab) {
-		LogError(logfp, LOGFATAL, "%s : Minimum wetdays after germination (%d) > maximum days allowed for establishment (%d).", MyFileName, v->min_wetdays_for_estab,
+		LogError(logfp, LOGFATAL, "%s : Minimum wetdays after germination (%d) > maximum days allowed for establishment (%d).", v->sppFileName, v->min_wetdays_for_estab,
 				v->max_days_germ2estab);
 	}
 
-	if (v->min_swc_germ < lyr[0]->swcBulk_wiltpt) {
-		LogError(logfp, LOGFATAL, "%s : Minimum swc for germination (%.4f) < wiltpoint (%.4f)", MyFileName, v->min_swc_germ, lyr[0]->swcBulk_wiltpt);
+	if (v->min_swc_germ < SW_Site.swcBulk_wiltpt[0]) {
+		LogError(logfp, LOGFATAL, "%s : Minimum swc for germination (%.4f) < wiltpoint (%.4f)", v->sppFileName, v->min_swc_germ, SW_Site.swcBulk_wiltpt[0]);
 	}
 
-	if (v->min_swc_estab < lyr[0]->swcBulk_wiltpt) {
-		LogError(logfp, LOGFATAL, "%s : Minimum swc for establishment (%.4f) < wiltpoint (%.4f)", MyFileName, v->min_swc_estab, lyr[0]->swcBulk_wiltpt);
+	if (v->min_swc_estab < SW_Site.swcBulk_wiltpt[0]) {
+		LogError(logfp, LOGFATAL, "%s : Minimum swc for establishment (%.4f) < wiltpoint (%.4f)", v->sppFileName, v->min_swc_estab, SW_Site.swcBulk_wiltpt[0]);
 	}
 
 }
@@ -501,7 +619,6 @@ unsigned int _new_species(void) {
 void _echo_VegEstab(void) {
 	/* --------------------------------------------------- */
 	SW_VEGESTAB_INFO **v = SW_VegEstab.parms;
-	SW_LAYER_INFO **lyr = SW_Site.lyr;
 	IntU i;
 	char outstr[2048];
 
@@ -522,7 +639,7 @@ void _echo_VegEstab(void) {
 				"\tFirst possible day  : %d\n"
 				"\tLast  possible day  : %d\n"
 				"\tMinimum consecutive wet days (after first possible day): %d\n",
-				v[i]->sppname, v[i]->bars[SW_GERM_BARS], v[i]->min_swc_germ / lyr[0]->width,
+				v[i]->sppname, v[i]->bars[SW_GERM_BARS], v[i]->min_swc_germ / SW_Site.width[0],
 				v[i]->min_swc_germ, v[i]->min_temp_germ, v[i]->max_temp_germ,
 				v[i]->min_pregerm_days, v[i]->max_pregerm_days, v[i]->min_wetdays_for_germ);
 
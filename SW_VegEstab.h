@@ -6,8 +6,9 @@
 	Purpose: Supports Veg_Estab.c routines.
 	History:
 	(8/28/01) -- INITIAL CODING - cwb
-
-	currently not used.
+	10/15/2026	added SW_VEGESTAB_SPP: the state and parameters of the daily
+				establishment check of all species are stored as arrays;
+				the state variables moved from SW_VEGESTAB_INFO to SW_VEGESTAB_SPP
 */
 /********************************************************/
 /********************************************************/
@@ -33,14 +34,9 @@ typedef struct {
 
 	/* see COMMENT-1 below for more information on these vars */
 
-	/* THESE VARIABLES CAN CHANGE VALUE IN THE MODEL */
-	TimeInt estab_doy, /* day of establishment for this plant */
-			germ_days, /* elapsed days since germination with no estab */
-			drydays_postgerm, /* did sprout get too dry for estab? */
-			wetdays_for_germ, /* keep track of consecutive wet days */
-			wetdays_for_estab;
-	Bool germd, /* has this plant germinated yet?  */
-		no_estab; /* if swTRUE, can't attempt estab for remainder of year */
+	/* THIS VARIABLE CAN CHANGE VALUE IN THE MODEL */
+	/* (the other state variables are in SW_VEGESTAB_SPP) */
+	TimeInt estab_doy; /* day of establishment for this plant */
 
 	/* THESE VARIABLES DO NOT CHANGE DURING THE NORMAL MODEL RUN */
 	char sppFileName[MAX_FILENAMESIZE]; /* Store the file Name and Path, Mostly for Rsoilwat */
@@ -79,10 +75,37 @@ typedef struct {
 					/* each day in the array corresponds to the ordered species list */
 } SW_VEGESTAB_OUTPUTS;
 
+/* State and parameters of the daily establishment check of all species
+ * as arrays with one element per species (struct of arrays), set up by
+ * SW_VES_init_run(). Species that have established or that can no longer
+ * establish in the current year are compacted out of `active`. */
+typedef struct {
+	/* THESE VARIABLES CAN CHANGE VALUE IN THE MODEL (zeroed each year) */
+	TimeInt *germ_days, /* elapsed days since germination with no estab */
+			*drydays_postgerm, /* did sprout get too dry for estab? */
+			*wetdays_for_germ, /* keep track of consecutive wet days */
+			*wetdays_for_estab;
+	Bool *germd; /* has this plant germinated yet?  */
+
+	unsigned int *active; /* species that are still checked this year */
+	IntU n_active; /* number of elements of `active` */
+
+	/* THESE VARIABLES DO NOT CHANGE DURING THE NORMAL MODEL RUN */
+	/* (copies of the parameters of SW_VEGESTAB_INFO) */
+	TimeInt *min_pregerm_days, *max_pregerm_days, *min_wetdays_for_germ,
+			*max_drydays_postgerm, *min_wetdays_for_estab,
+			*min_days_germ2estab, *max_days_germ2estab;
+	unsigned int *estab_lyrs,
+			max_estab_lyrs; /* largest estab_lyrs of all species */
+	RealF *min_swc_germ, *min_swc_estab, *min_temp_germ, *max_temp_germ,
+			*min_temp_estab, *max_temp_estab;
+} SW_VEGESTAB_SPP;
+
 typedef struct {
   Bool use;      /* if swTRUE use establishment parms and chkestab() */
   IntU count;  /* number of species to check */
   SW_VEGESTAB_INFO **parms;  /* dynamic array of parms for each species */
+  SW_VEGESTAB_SPP spp;  /* state and parameters of all species as arrays */
   SW_VEGESTAB_OUTPUTS  /* only yearly element will be used */
 		*p_accu[SW_OUTNPERIODS], // output accumulator: summed values for each time period
 		*p_oagg[SW_OUTNPERIODS]; // output aggregator: mean or sum for each time periods
@@ -93,6 +116,7 @@ void SW_VES_read(void);
 void SW_VES_construct(void);
 void SW_VES_deconstruct(void);
 void SW_VES_init(void);
+void SW_VES_init_run(void);
 void SW_VegEstab_construct(void);
 void SW_VES_checkestab(void);
 void SW_VES_new_year(void);
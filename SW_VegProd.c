@@ -33,6 +33,10 @@ added the variable RealF help_bareGround as a place holder for the sscanf call.
 changed _echo_inits() to now display the bare ground components in logfile.log
 06/27/2013	(drs)	closed open files if LogError() with LOGFATAL is called in SW_VPD_read()
 07/09/2013	(clk)	added initialization of all the values of the new vegtype variable forb and forb.cov.fCover
+10/14/2026	SW_VPD_new_year() recalculates daily values of a vegetation type only if its inputs changed
+10/15/2026	SW_VPD_read() reads with SW_TEXTFILE and Str_Scan()
+10/15/2026	CO2 multipliers are held only for the current simulation year
+10/15/2026	added SW_VPD_update_day() for daily vegetation of a coupled model
 */
 /********************************************************/
 /********************************************************/
@@ -53,21 +57,20 @@ changed _echo_inits() to now display the bare ground components in logfile.log
 #include "SW_Times.h"
 #include "SW_VegProd.h"
 #include "SW_Model.h"
+#include "SW_Run.h"
 
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
 extern Bool EchoInits;
-extern SW_MODEL SW_Model;
 
 
 
-SW_VEGPROD SW_VegProd; /* declared here, externed elsewhere */
 
 /* =================================================== */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
-static char *MyFileName;
+static SW_THREAD_LOCAL char *MyFileName;
 
 // key2veg must be in the same order as the indices to vegetation types defined in SW_Defines.h
 char const *key2veg[] = {"Trees", "Shrubs", "Forbs", "Grasses"};
@@ -89,25 +92,25 @@ char const *key2veg[] = {"Trees", "Shrubs", "Forbs", "Grasses"};
 void SW_VPD_read(void) {
 	/* =================================================== */
 	SW_VEGPROD *v = &SW_VegProd;
-	FILE *f;
+	SW_TEXTFILE f;
 	TimeInt mon = Jan;
 	int x, k, lineno = 0;
 	const int line_help = 27; // last case line number before monthly biomass densities
 	RealF help_veg[NVEGTYPES], help_bareGround, litt, biom, pctl, laic;
 
 	MyFileName = SW_F_name(eVegProd);
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
 
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 		if (lineno++ < line_help) {
 			switch (lineno) {
 			/* fractions of vegetation types */
 			case 1:
-				x = sscanf(inbuf, "%f %f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS], &help_bareGround);
 				if (x < NVEGTYPES + 1) {
 					sprintf(errstr, "ERROR: invalid record in vegetation type components in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -118,11 +121,11 @@ void SW_VPD_read(void) {
 
 			/* albedo */
 			case 2:
-				x = sscanf(inbuf, "%f %f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS], &help_bareGround);
 				if (x < NVEGTYPES + 1) {
 					sprintf(errstr, "ERROR: invalid record in albedo values in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -133,11 +136,11 @@ void SW_VPD_read(void) {
 
 			/* canopy height */
 			case 3:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in canopy xinflec in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -145,11 +148,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 4:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in canopy yinflec in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -157,11 +160,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 5:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in canopy range in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -169,11 +172,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 6:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in canopy slope in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -181,11 +184,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 7:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in canopy height constant option in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -195,11 +198,11 @@ void SW_VPD_read(void) {
 
 			/* vegetation interception parameters */
 			case 8:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in interception parameter kSmax(veg) in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -207,11 +210,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 9:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in interception parameter kdead(veg) in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -221,11 +224,11 @@ void SW_VPD_read(void) {
 
 			/* litter interception parameters */
 			case 10:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in litter interception parameter kSmax(litter) in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -235,11 +238,11 @@ void SW_VPD_read(void) {
 
 			/* parameter for partitioning of bare-soil evaporation and transpiration */
 			case 11:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in parameter for partitioning of bare-soil evaporation and transpiration in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -249,11 +252,11 @@ void SW_VPD_read(void) {
 
 			/* Parameter for scaling and limiting bare soil evaporation rate */
 			case 12:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in parameter for Parameter for scaling and limiting bare soil evaporation rate in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -263,11 +266,11 @@ void SW_VPD_read(void) {
 
 			/* shade effects */
 			case 13:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in shade scale in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -275,11 +278,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 14:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in shade max dead biomass in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -287,11 +290,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 15:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in shade xinflec in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -299,11 +302,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 16:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in shade yinflec in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -311,11 +314,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 17:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in shade range in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -323,11 +326,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 18:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in shade slope in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -337,11 +340,11 @@ void SW_VPD_read(void) {
 
 			/* Hydraulic redistribution */
 			case 19:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in hydraulic redistribution: flag in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -349,11 +352,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 20:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in hydraulic redistribution: maxCondroot in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -361,11 +364,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 21:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in hydraulic redistribution: swpMatric50 in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -373,11 +376,11 @@ void SW_VPD_read(void) {
 				}
 				break;
 			case 22:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in hydraulic redistribution: shapeCond in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -387,11 +390,11 @@ void SW_VPD_read(void) {
 
 			/* Critical soil water potential */
 			case 23:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: invalid record in critical soil water potentials: flag in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -404,11 +407,11 @@ void SW_VPD_read(void) {
 			/* CO2 Biomass Power Equation */
 			// Coefficient 1
 			case 24:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: Not enough arguments for CO2 Biomass Coefficient 1 in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -417,11 +420,11 @@ void SW_VPD_read(void) {
 				break;
 			// Coefficient 2
 			case 25:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: Not enough arguments for CO2 Biomass Coefficient 2 in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -432,11 +435,11 @@ void SW_VPD_read(void) {
 			/* CO2 WUE Power Equation */
 			// Coefficient 1
 			case 26:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: Not enough arguments for CO2 WUE Coefficient 1 in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -445,11 +448,11 @@ void SW_VPD_read(void) {
 				break;
 			// Coefficient 2
 			case 27:
-				x = sscanf(inbuf, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
+				x = Str_Scan(f.line, "%f %f %f %f", &help_veg[SW_GRASS], &help_veg[SW_SHRUB],
 					&help_veg[SW_TREES], &help_veg[SW_FORBS]);
 				if (x < NVEGTYPES) {
 					sprintf(errstr, "ERROR: Not enough arguments for CO2 WUE Coefficient 2 in %s\n", MyFileName);
-					CloseFile(&f);
+					CloseTextFile(&f);
 					LogError(logfp, LOGFATAL, errstr);
 				}
 				ForEachVegType(k) {
@@ -465,10 +468,10 @@ void SW_VPD_read(void) {
 			if (lineno == line_help + 1 || lineno == line_help + 1 + 12 || lineno == line_help + 1 + 12 * 2 || lineno == line_help + 1 + 12 * 3)
 				mon = Jan;
 
-			x = sscanf(inbuf, "%f %f %f %f", &litt, &biom, &pctl, &laic);
+			x = Str_Scan(f.line, "%f %f %f %f", &litt, &biom, &pctl, &laic);
 			if (x < NVEGTYPES) {
 				sprintf(errstr, "ERROR: invalid record %d in %s\n", mon + 1, MyFileName);
-				CloseFile(&f);
+				CloseTextFile(&f);
 				LogError(logfp, LOGFATAL, errstr);
 			}
 			if (lineno > line_help + 12 * 3 && lineno <= line_help + 12 * 4) {
@@ -508,7 +511,7 @@ void SW_VPD_read(void) {
 
   SW_VPD_fix_cover();
 
-	CloseFile(&f);
+	CloseTextFile(&f);
 
 	if (EchoInits)
 		_echo_VegProd();
@@ -579,17 +582,13 @@ void SW_VPD_construct(void) {
 
 
 void SW_VPD_init_run(void) {
-  TimeInt year;
   int k;
 
   /* Set co2-multipliers to default */
-  for (year = 0; year < MAX_NYEAR; year++)
+  ForEachVegType(k)
   {
-    ForEachVegType(k)
-    {
-      SW_VegProd.veg[k].co2_multipliers[BIO_INDEX][year] = 1.;
-      SW_VegProd.veg[k].co2_multipliers[WUE_INDEX][year] = 1.;
-    }
+    SW_VegProd.veg[k].co2_multipliers[BIO_INDEX] = 1.;
+    SW_VegProd.veg[k].co2_multipliers[WUE_INDEX] = 1.;
   }
 }
 
@@ -636,6 +635,98 @@ void apply_biomassCO2effect(double new_biomass[], double biomass[], double multi
 
 
 
+/**
+  @brief Check whether the daily values of a vegetation type are up to date
+
+  @param[in,out] v A vegetation type; its `daily_inputs` are updated to the
+    current inputs.
+  @param[in] leapyear Calendar of the current year.
+
+  @return swTRUE if the inputs did not change since the daily values were
+    last calculated.
+*/
+static Bool veg_daily_is_current(VegType *v, Bool leapyear) {
+	VegDailyInputs x;
+
+	// clear padding so that the inputs can be compared byte-wise
+	memset(&x, 0, sizeof(VegDailyInputs));
+
+	x.fCover = v->cov.fCover;
+	x.bio_multiplier = v->co2_multipliers[BIO_INDEX];
+	x.canopy_height_constant = v->canopy_height_constant;
+	x.veg_kdead = v->veg_kdead;
+	memcpy(x.litter, v->litter, sizeof x.litter);
+	memcpy(x.biomass, v->biomass, sizeof x.biomass);
+	memcpy(x.pct_live, v->pct_live, sizeof x.pct_live);
+	memcpy(x.lai_conv, v->lai_conv, sizeof x.lai_conv);
+	x.cnpy = v->cnpy;
+	x.leapyear = leapyear;
+	x.is_set = swTRUE;
+
+	if (0 == memcmp(&x, &v->daily_inputs, sizeof(VegDailyInputs))) {
+		return swTRUE;
+	}
+
+	memcpy(&v->daily_inputs, &x, sizeof(VegDailyInputs));
+	return swFALSE;
+}
+
+
+/**
+  @brief Calculate the daily values of a vegetation type that are derived
+    from biomass, percent live biomass, litter, and LAI conversion of a day
+
+  @param[in,out] v A vegetation type.
+  @param[in] k The vegetation type, e.g., `SW_TREES`.
+  @param[in] doy Day of year (base1).
+*/
+static void veg_derived_day(VegType *v, int k, TimeInt doy) {
+	if (GT(v->cov.fCover, 0.))
+	{
+    /* vegetation height = 'veg_height_daily' is used for 'snowdepth_scale'; historically, also for 'vegcov' */
+		if (GT(v->canopy_height_constant, 0.))
+		{
+			v->veg_height_daily[doy] = v->canopy_height_constant;
+
+		} else {
+			v->veg_height_daily[doy] = tanfunc(v->biomass_daily[doy],
+				v->cnpy.xinflec,
+				v->cnpy.yinflec,
+				v->cnpy.range,
+				v->cnpy.slope);
+		}
+
+    /* live biomass = 'biolive_daily' is used for canopy-interception, transpiration, bare-soil evaporation, and hydraulic redistribution */
+    v->biolive_daily[doy] = v->biomass_daily[doy] * v->pct_live_daily[doy];
+
+    /* dead biomass = 'biodead_daily' is used for canopy-interception and transpiration */
+    v->biodead_daily[doy] = v->biomass_daily[doy] - v->biolive_daily[doy];
+
+    /* live leaf area index = 'lai_live_daily' is used for E-T partitioning */
+    v->lai_live_daily[doy] = v->biolive_daily[doy] / v->lai_conv_daily[doy];
+
+    /* compound leaf area index = 'bLAI_total_daily' is used for canopy-interception */
+    v->bLAI_total_daily[doy] = v->lai_live_daily[doy] +
+      v->veg_kdead * v->biodead_daily[doy] / v->lai_conv_daily[doy];
+
+    /* total above-ground biomass = 'total_agb_daily' is used for bare-soil evaporation */
+		if (k == SW_TREES)
+		{
+			v->total_agb_daily[doy] = v->litter_daily[doy] + v->biolive_daily[doy];
+		} else {
+			v->total_agb_daily[doy] = v->litter_daily[doy] + v->biomass_daily[doy];
+		}
+
+	} else {
+		v->lai_live_daily[doy] = 0.;
+		v->bLAI_total_daily[doy] = 0.;
+		v->biolive_daily[doy] = 0.;
+		v->biodead_daily[doy] = 0.;
+		v->total_agb_daily[doy] = 0.;
+	}
+}
+
+
 /**
 @brief Update vegetation parameters for new year
 */
@@ -660,19 +751,35 @@ void SW_VPD_new_year(void) {
 
 	SW_VEGPROD *v = &SW_VegProd; /* convenience */
 	TimeInt doy; /* base1 */
-	int k;
+	int k, n_update = 0;
+	Bool is_current[NVEGTYPES], leapyear = isleapyear(SW_Model.year);
+
+	// Daily values change only if the monthly inputs, the CO2 multiplier of
+	// the year, or the calendar change (e.g., not at all without CO2 effects)
+	ForEachVegType(k)
+	{
+		is_current[k] = veg_daily_is_current(&v->veg[k], leapyear);
+		n_update += is_current[k] ? 0 : 1;
+	}
 
+	if (0 == n_update) {
+		return;
+	}
 
 	// Grab the real year so we can access CO2 data
 	ForEachVegType(k)
 	{
+		if (is_current[k]) {
+			continue;
+		}
+
 		if (GT(v->veg[k].cov.fCover, 0.))
 		{
 			if (k == SW_TREES)
 			{
 				// CO2 effects on biomass restricted to percent live biomass
 				apply_biomassCO2effect(v->veg[k].CO2_pct_live, v->veg[k].pct_live,
-					v->veg[k].co2_multipliers[BIO_INDEX][SW_Model.simyear]);
+					v->veg[k].co2_multipliers[BIO_INDEX]);
 
 				interpolate_monthlyValues(v->veg[k].CO2_pct_live, v->veg[k].pct_live_daily);
 				interpolate_monthlyValues(v->veg[k].biomass, v->veg[k].biomass_daily);
@@ -680,7 +787,7 @@ void SW_VPD_new_year(void) {
 			} else {
 				// CO2 effects on biomass applied to total biomass
 				apply_biomassCO2effect(v->veg[k].CO2_biomass, v->veg[k].biomass,
-					v->veg[k].co2_multipliers[BIO_INDEX][SW_Model.simyear]);
+					v->veg[k].co2_multipliers[BIO_INDEX]);
 
 				interpolate_monthlyValues(v->veg[k].CO2_biomass, v->veg[k].biomass_daily);
 				interpolate_monthlyValues(v->veg[k].pct_live, v->veg[k].pct_live_daily);
@@ -695,50 +802,32 @@ void SW_VPD_new_year(void) {
 	for (doy = 1; doy <= MAX_DAYS; doy++)
 	{
 		ForEachVegType(k) {
-			if (GT(v->veg[k].cov.fCover, 0.))
-			{
-        /* vegetation height = 'veg_height_daily' is used for 'snowdepth_scale'; historically, also for 'vegcov' */
-				if (GT(v->veg[k].canopy_height_constant, 0.))
-				{
-					v->veg[k].veg_height_daily[doy] = v->veg[k].canopy_height_constant;
-
-				} else {
-					v->veg[k].veg_height_daily[doy] = tanfunc(v->veg[k].biomass_daily[doy],
-						v->veg[k].cnpy.xinflec,
-						v->veg[k].cnpy.yinflec,
-						v->veg[k].cnpy.range,
-						v->veg[k].cnpy.slope);
-				}
-
-        /* live biomass = 'biolive_daily' is used for canopy-interception, transpiration, bare-soil evaporation, and hydraulic redistribution */
-        v->veg[k].biolive_daily[doy] = v->veg[k].biomass_daily[doy] * v->veg[k].pct_live_daily[doy];
+			if (!is_current[k]) {
+				veg_derived_day(&v->veg[k], k, doy);
+			}
+		}
+	}
+}
 
-        /* dead biomass = 'biodead_daily' is used for canopy-interception and transpiration */
-        v->veg[k].biodead_daily[doy] = v->veg[k].biomass_daily[doy] - v->veg[k].biolive_daily[doy];
 
-        /* live leaf area index = 'lai_live_daily' is used for E-T partitioning */
-        v->veg[k].lai_live_daily[doy] = v->veg[k].biolive_daily[doy] / v->veg[k].lai_conv_daily[doy];
+/**
+@brief Update the daily values of vegetation that are derived from biomass,
+  percent live biomass, litter, and LAI conversion of a day
 
-        /* compound leaf area index = 'bLAI_total_daily' is used for canopy-interception */
-        v->veg[k].bLAI_total_daily[doy] = v->veg[k].lai_live_daily[doy] +
-          v->veg[k].veg_kdead * v->veg[k].biodead_daily[doy] / v->veg[k].lai_conv_daily[doy];
+A coupled vegetation model may overwrite these inputs of the current day
+(e.g., `biomass_daily[doy]`) after `SW_CTL_begin_day()`; the daily values
+of the year are calculated again from the monthly inputs by the next
+`SW_VPD_new_year()`.
 
-        /* total above-ground biomass = 'total_agb_daily' is used for bare-soil evaporation */
-				if (k == SW_TREES)
-				{
-					v->veg[k].total_agb_daily[doy] = v->veg[k].litter_daily[doy] + v->veg[k].biolive_daily[doy];
-				} else {
-					v->veg[k].total_agb_daily[doy] = v->veg[k].litter_daily[doy] + v->veg[k].biomass_daily[doy];
-				}
+@param doy Day of year (base1).
+*/
+void SW_VPD_update_day(TimeInt doy) {
+	SW_VEGPROD *v = &SW_VegProd;
+	int k;
 
-			} else {
-				v->veg[k].lai_live_daily[doy] = 0.;
-				v->veg[k].bLAI_total_daily[doy] = 0.;
-				v->veg[k].biolive_daily[doy] = 0.;
-				v->veg[k].biodead_daily[doy] = 0.;
-				v->veg[k].total_agb_daily[doy] = 0.;
-			}
-		}
+	ForEachVegType(k) {
+		veg_derived_day(&v->veg[k], k, doy);
+		v->veg[k].daily_inputs.is_set = swFALSE;
 	}
 }
 
@@ -27,6 +27,9 @@
  01/31/2013	(clk)	added varilabe RealD bare_cov.albedo instead of creating a bare_cov VegType, because only need albedo and not the other data members
  04/09/2013	(clk) changed the variable name swp50 to swpMatric50. Therefore also updated the use of swp50 to swpMatric50 in SW_VegProd.c and SW_Flow.c.
  07/09/2013	(clk)	add the variables forb and forb.cov.fCover to SW_VEGPROD
+ 10/14/2026	added struct VegDailyInputs so that daily values are only recalculated if their inputs change
+ 10/15/2026	co2_multipliers of VegType hold only the values of the current simulation year
+ 10/15/2026	added SW_VPD_update_day()
  */
 /********************************************************/
 /********************************************************/
@@ -58,6 +61,30 @@ typedef struct {
 } CoverType;
 
 
+/** Inputs from which `SW_VPD_new_year()` calculates the daily values of a
+  vegetation type; the daily values are recalculated only if these change */
+typedef struct {
+  RealD
+    fCover,
+    /** CO2 multiplier of biomass of the current year */
+    bio_multiplier,
+    canopy_height_constant,
+    veg_kdead,
+    litter[MAX_MONTHS],
+    biomass[MAX_MONTHS],
+    pct_live[MAX_MONTHS],
+    lai_conv[MAX_MONTHS];
+
+  tanfunc_t cnpy;
+
+  Bool
+    /** Calendar of the current year (interpolation from monthly values) */
+    leapyear,
+    /** swTRUE if the daily values correspond to these inputs */
+    is_set;
+} VegDailyInputs;
+
+
 /** Data type that describes a vegetation type: currently, one of
   \ref NVEGTYPES available types:
   \ref SW_TREES, \ref SW_SHRUB, \ref SW_FORBS, and \ref SW_GRASS */
@@ -130,6 +157,9 @@ typedef struct {
     /** Daily sum of aboveground biomass & litter [g / m2] */
     total_agb_daily[MAX_DAYS + 1];
 
+  /** Inputs of the current daily values */
+  VegDailyInputs daily_inputs;
+
   Bool
     /** Flag for hydraulic redistribution/lift:
       1, simulate; 0, don't simulate;
@@ -193,11 +223,11 @@ typedef struct {
     co2_wue_coeff2;
 
   RealD
-    /** Calculated multipliers for CO2-effects:
-      - column \ref BIO_INDEX holds biomass multipliers
-      - column \ref WUE_INDEX holds water-use-efficiency multipliers
-      - rows represent years */
-    co2_multipliers[2][MAX_NYEAR];
+    /** Calculated multipliers for CO2-effects of the current simulation
+      year (see SW_CBN_new_year()):
+      - \ref BIO_INDEX holds the biomass multiplier
+      - \ref WUE_INDEX holds the water-use-efficiency multiplier */
+    co2_multipliers[2];
 
 } VegType;
 
@@ -220,12 +250,6 @@ typedef struct {
       user input from file `Input/veg.in` */
   CoverType bare_cov;
 
-  Bool
-    /** Flag that determines whether vegetation-type specific soil water
-      availability should be calculated;
-      user input from file `Input/outsetup.in` */
-    use_SWA;
-
   RealD
     // storing values in same order as defined in STEPWAT2/rgroup.in (0=tree, 1=shrub, 2=grass, 3=forb)
     critSoilWater[NVEGTYPES];
@@ -246,6 +270,7 @@ typedef struct {
 
 void SW_VPD_read(void);
 void SW_VPD_new_year(void);
+void SW_VPD_update_day(TimeInt doy);
 void SW_VPD_fix_cover(void);
 void SW_VPD_construct(void);
 void SW_VPD_init_run(void);
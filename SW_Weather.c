@@ -34,6 +34,16 @@
  need to set these variables to 0 resp TRUE in function SW_WTH_construct()
  06/27/2013	(drs)	closed open files if LogError() with LOGFATAL is called in SW_WTH_read(), _read_hist()
  08/26/2013 (rjm) removed extern SW_OUTPUT never used.
+ 2026-10-14 historical weather is read from a binary weather store
+   `[weather-file prefix].bin` if present, see SW_Weather_store.c
+ 2026-10-14 added SW_WTH_preload() to prepare the weather of all years up front
+ 2026-10-15 reads of weather input files are traced (option -t, see SW_Trace.h)
+ 2026-10-15 SW_WTH_read() and _read_weather_hist() read with SW_TEXTFILE and Str_Scan()
+ 2026-10-15 added SW_WTH_temp_avg_year() for the radiation and PET of a year
+ 2026-10-15 historical weather is read from gridded netCDF files if requested by
+   an optional last line of `weathsetup.in`, see SW_Weather_grid.c
+ 2026-10-15 missing values of a year are filled in by a prepass at the start of
+   the year (_fill_year()); SW_WTH_new_day() reads the filled days
  */
 /********************************************************/
 /********************************************************/
@@ -52,6 +62,10 @@
 #include "SW_Markov.h"
 
 #include "SW_Weather.h"
+#include "SW_Weather_store.h"
+#include "SW_Weather_grid.h"
+#include "SW_Trace.h"
+#include "SW_Run.h"
 #ifdef RSOILWAT
   #include "../rSW_Weather.h"
 #endif
@@ -59,20 +73,18 @@
 /* =================================================== */
 /*                  Global Variables                   */
 /* --------------------------------------------------- */
-extern SW_MODEL SW_Model;
 
-SW_WEATHER SW_Weather; /* declared here, externed elsewhere */
 
-/** `swTRUE`/`swFALSE` if historical daily meteorological inputs
-    are available/not available for the current simulation year
+/* `weth_found` is `swTRUE`/`swFALSE` if historical daily meteorological
+    inputs are available/not available for the current simulation year;
+    it is part of the simulation run context, see SW_Run.h
 */
-Bool weth_found;
 
 
 /* =================================================== */
 /*                Module-Level Variables               */
 /* --------------------------------------------------- */
-static char *MyFileName;
+static SW_THREAD_LOCAL char *MyFileName;
 
 
 /* =================================================== */
@@ -81,6 +93,8 @@ static char *MyFileName;
 /* --------------------------------------------------- */
 
 static void _update_yesterday(void);
+static Bool _read_hist_year(TimeInt year);
+static const SW_WEATHER_HIST *_hist_of_year(void);
 
 /**
 @brief Clears weather history.
@@ -95,7 +109,18 @@ void _clear_hist_weather(void) {
 }
 
 
-static void _todays_weth(RealD *tmax, RealD *tmin, RealD *ppt) {
+/** Daily weather values of a day before scaling
+
+  @param wh Daily weather inputs of the year.
+  @param found swTRUE if weather inputs for the year are available.
+  @param doy Day of year (base0).
+  @param wn Weather of yesterday (scaled).
+  @param tmax Resulting maximum temperature.
+  @param tmin Resulting minimum temperature.
+  @param ppt Resulting precipitation.
+*/
+static void _todays_weth(const SW_WEATHER_HIST *wh, Bool found, TimeInt doy,
+	const SW_WEATHER_2DAYS *wn, RealD *tmax, RealD *tmin, RealD *ppt) {
 	/* --------------------------------------------------- */
 	/* If use_weathergenerator = swFALSE and no weather file found, we won't
 	 * get this far because the new_year() will fail, so if
@@ -106,48 +131,90 @@ static void _todays_weth(RealD *tmax, RealD *tmin, RealD *ppt) {
 	 * always be most desirable, especially for ppt, so its
 	 * default is 0.
 	 */
-	SW_WEATHER *w = &SW_Weather;
-	TimeInt doy = SW_Model.doy - 1;
 	Bool no_missing = swTRUE;
 
-	if (!weth_found) {
+	if (!found) {
 		// no weather input file for current year ==> use weather generator
-		*ppt = w->now.ppt[Yesterday]; /* reqd for markov */
+		*ppt = wn->ppt[Yesterday]; /* reqd for markov */
 		SW_MKV_today(doy, tmax, tmin, ppt);
 
 	} else {
 		// weather input file for current year available
 
-		no_missing = (Bool) (!missing(w->hist.temp_max[doy]) &&
-									!missing(w->hist.temp_min[doy]) &&
-									!missing(w->hist.ppt[doy]));
+		no_missing = (Bool) (!missing(wh->temp_max[doy]) &&
+									!missing(wh->temp_min[doy]) &&
+									!missing(wh->ppt[doy]));
 
 		if (no_missing) {
 			// all values available
-			*tmax = w->hist.temp_max[doy];
-			*tmin = w->hist.temp_min[doy];
-			*ppt = w->hist.ppt[doy];
+			*tmax = wh->temp_max[doy];
+			*tmin = wh->temp_min[doy];
+			*ppt = wh->ppt[doy];
 
 		} else {
 			// some of today's values are missing
 
 			if (SW_Weather.use_weathergenerator) {
 				// if weather generator is turned on then use it for all values
-				*ppt = w->now.ppt[Yesterday]; /* reqd for markov */
+				*ppt = wn->ppt[Yesterday]; /* reqd for markov */
 				SW_MKV_today(doy, tmax, tmin, ppt);
 
 			} else {
 				// impute missing values with 0 for precipitation and
 				// with LOCF for temperature (i.e., last-observation-carried-forward)
-				*tmax = (!missing(w->hist.temp_max[doy])) ? w->hist.temp_max[doy] : w->now.temp_max[Yesterday];
-				*tmin = (!missing(w->hist.temp_min[doy])) ? w->hist.temp_min[doy] : w->now.temp_min[Yesterday];
-				*ppt = (!missing(w->hist.ppt[doy])) ? w->hist.ppt[doy] : 0.;
+				*tmax = (!missing(wh->temp_max[doy])) ? wh->temp_max[doy] : wn->temp_max[Yesterday];
+				*tmin = (!missing(wh->temp_min[doy])) ? wh->temp_min[doy] : wn->temp_min[Yesterday];
+				*ppt = (!missing(wh->ppt[doy])) ? wh->ppt[doy] : 0.;
 			}
 		}
 	}
 
 }
 
+
+/** Daily weather values of all simulated days of a year before scaling
+
+  Missing values are filled in day by day with `_todays_weth()`, i.e., by
+  the weather generator (if turned on) in the same order of random draws
+  as if the days were filled in during the simulation.
+
+  @param wh Daily weather inputs of the year.
+  @param found swTRUE if weather inputs for the year are available.
+  @param firstdoy First simulated day of the year (base1).
+  @param lastdoy Last simulated day of the year (base1).
+  @param wn Weather of the day before `firstdoy` (scaled);
+    updated to the weather of `lastdoy`.
+  @param out Resulting daily weather values of the year; days that are
+    not simulated are set to the missing value.
+*/
+static void _fill_year(const SW_WEATHER_HIST *wh, Bool found,
+	TimeInt firstdoy, TimeInt lastdoy, SW_WEATHER_2DAYS *wn,
+	SW_WEATHER_HIST *out) {
+	SW_WEATHER *w = &SW_Weather;
+	TimeInt doy, month;
+	RealD tmax, tmin, ppt;
+
+	for (doy = 0; doy < MAX_DAYS; doy++) {
+		out->ppt[doy] = out->temp_max[doy] = out->temp_min[doy] =
+			out->temp_avg[doy] = SW_MISSING;
+	}
+
+	for (doy = firstdoy; doy <= lastdoy; doy++) {
+		_todays_weth(wh, found, doy - 1, wn, &tmax, &tmin, &ppt);
+
+		out->temp_max[doy - 1] = tmax;
+		out->temp_min[doy - 1] = tmin;
+		out->temp_avg[doy - 1] = (tmax + tmin) / 2.;
+		out->ppt[doy - 1] = ppt;
+
+		// today's scaled weather is tomorrow's "yesterday", see `SW_WTH_new_day()`
+		month = doy2month(doy);
+		wn->temp_max[Yesterday] = tmax + w->scale_temp_max[month];
+		wn->temp_min[Yesterday] = tmin + w->scale_temp_min[month];
+		wn->ppt[Yesterday] = ppt * w->scale_precip[month];
+	}
+}
+
 /* =================================================== */
 /* =================================================== */
 /*             Public Function Definitions             */
@@ -199,6 +266,13 @@ void SW_WTH_deconstruct(void)
 	if (SW_Weather.use_weathergenerator) {
 		SW_MKV_deconstruct();
 	}
+
+	SW_WTH_close_store();
+
+	if (!isnull(SW_Weather.allHist)) {
+		Mem_Free(SW_Weather.allHist);
+		SW_Weather.allHist = SW_Weather.hist_year = NULL;
+	}
 }
 
 /**
@@ -240,35 +314,119 @@ void SW_WTH_init_run(void) {
     2. Set the "first year to begin historical weather" to a year after
        the last simulated year
 
+  Missing values of the year are filled in before the first day of the
+  year (see `_fill_year()`) so that `SW_WTH_new_day()` reads the values of
+  a day. If the weather of all years is preloaded (see `SW_WTH_preload()`),
+  then the weather of the current year is located in `SW_Weather.allHist`;
+  otherwise, in `SW_Weather.filled`. `SW_Weather.hist_year` points to it.
+
   @sideeffect
-    - if historical daily meteorological inputs are successfully located,
-      then \ref weth_found is set to `swTRUE`
-    - otherwise, \ref weth_found is `swFALSE`
+    - \ref weth_found is set to `swTRUE` because all days of the year
+      have values
 */
 void SW_WTH_new_year(void) {
+	SW_WEATHER_2DAYS wn = SW_Weather.now; // weather of "yesterday" as seen by the first day
+	Bool found;
 
-	if (
-		SW_Weather.use_weathergenerator_only ||
-		SW_Model.year < SW_Weather.yr.first
-	) {
-		weth_found = swFALSE;
 
-	} else {
-		#ifdef RSOILWAT
-		weth_found = onSet_WTH_DATA_YEAR(SW_Model.year);
-		#else
-		weth_found = _read_weather_hist(SW_Model.year);
-		#endif
+	if (SW_Weather.preload_all_years) {
+		if (isnull(SW_Weather.allHist)) {
+			SW_WTH_preload();
+			Time_new_year(SW_Model.year); // reset calendar to the current year
+		}
+
+		SW_Weather.hist_year =
+			SW_Weather.allHist + (SW_Model.year - SW_Model.startyr);
+		weth_found = swTRUE; // all days of `allHist` have values
+		return;
 	}
 
-	if (!weth_found && !SW_Weather.use_weathergenerator) {
-		LogError(
-		  logfp,
-		  LOGFATAL,
-		  "Markov Simulator turned off and weather file not found for year %d",
-		  SW_Model.year
-		);
+	found = _read_hist_year(SW_Model.year);
+	_fill_year(_hist_of_year(), found, SW_Model.firstdoy, SW_Model.lastdoy,
+		&wn, &SW_Weather.filled);
+
+	SW_Weather.hist_year = &SW_Weather.filled;
+	weth_found = swTRUE; // all days of `filled` have values
+}
+
+
+/** @brief Prepare the daily weather of all simulation years before the first year
+
+  Weather inputs of all years from `startyr` to `endyr` are read
+  into the contiguous buffer `SW_Weather.allHist`, and missing days and years
+  are filled in (by the weather generator, if turned on), in the same
+  sequence as if the years were read one at a time during the simulation.
+  Afterwards, the simulation does not read weather inputs anymore;
+  `SW_WTH_new_year()` moves `SW_Weather.hist_year` to the year.
+
+  Requires that the Markov weather generator (if used) and
+  `SW_WTH_init_run()` are set up. The calendar of `Times.c` is changed
+  and needs to be reset (e.g., by `Time_new_year()`) before use.
+*/
+void SW_WTH_preload(void) {
+	SW_WEATHER *w = &SW_Weather;
+	SW_MODEL *m = &SW_Model;
+	SW_WEATHER_2DAYS wn = w->now; // weather of "yesterday" as seen by the first day
+	TimeInt year, firstdoy, lastdoy;
+	Bool found;
+
+	if (!isnull(w->allHist)) {
+		Mem_Free(w->allHist);
+	}
+
+	w->allHist = (SW_WEATHER_HIST *) Mem_Calloc(m->endyr - m->startyr + 1,
+		sizeof(SW_WEATHER_HIST), "SW_WTH_preload()");
+
+	for (year = m->startyr; year <= m->endyr; year++) {
+		found = _read_hist_year(year);
+		Time_new_year(year);
+
+		// same days as simulated, see `SW_MDL_new_year()`
+		firstdoy = (year == m->startyr) ? m->startstart : 1;
+		lastdoy = (year == m->endyr) ? m->endend : Time_get_lastdoy_y(year);
+
+		_fill_year(_hist_of_year(), found, firstdoy, lastdoy, &wn,
+			w->allHist + (year - m->startyr));
+	}
+}
+
+/**
+@brief Daily mean air temperature of all simulated days of the current year
+
+  The temperature of each day is known before the day is simulated
+  because missing values of the year are filled in by `SW_WTH_new_year()`.
+  Values are identical to those of `SW_WTH_new_day()`.
+
+  @param[out] temp_avg Daily mean air temperature [C], indexed by
+    day of year (base1).
+  @return `swTRUE` if `temp_avg` holds the days from `SW_Model.firstdoy`
+    to `SW_Model.lastdoy`; `swFALSE` otherwise.
+*/
+Bool SW_WTH_temp_avg_year(double temp_avg[]) {
+	SW_WEATHER *w = &SW_Weather;
+	const SW_WEATHER_HIST *wh;
+	TimeInt doy, month;
+	RealD tmax, tmin;
+
+	if (!weth_found) {
+		return swFALSE;
 	}
+
+	wh = w->hist_year;
+
+	for (doy = SW_Model.firstdoy; doy <= SW_Model.lastdoy; doy++) {
+		if (missing(wh->temp_max[doy - 1]) || missing(wh->temp_min[doy - 1]) ||
+			missing(wh->ppt[doy - 1])) {
+			return swFALSE;
+		}
+
+		month = doy2month(doy);
+		tmax = wh->temp_max[doy - 1] + w->scale_temp_max[month];
+		tmin = wh->temp_min[doy - 1] + w->scale_temp_min[month];
+		temp_avg[doy] = (tmax + tmin) / 2.;
+	}
+
+	return swTRUE;
 }
 
 /**
@@ -280,7 +438,7 @@ void SW_WTH_end_day(void) {
 }
 
 /**
-@brief Guarantees that today's weather will not be invalid via -_todays_weth().
+@brief Sets up today's weather from the weather of the year, see SW_WTH_new_year().
 */
 void SW_WTH_new_day(void) {
 	/* =================================================== */
@@ -309,8 +467,10 @@ void SW_WTH_new_day(void) {
 	 */
 #endif
 
-	/* get the plain unscaled values */
-	_todays_weth(&tmpmax, &tmpmin, &ppt);
+	/* get the plain unscaled values, filled in by `SW_WTH_new_year()` */
+	tmpmax = w->hist_year->temp_max[SW_Model.doy - 1];
+	tmpmin = w->hist_year->temp_min[SW_Model.doy - 1];
+	ppt = w->hist_year->ppt[SW_Model.doy - 1];
 
 	/* scale the weather according to monthly factors */
 	wn->temp_max[Today] = tmpmax + w->scale_temp_max[month];
@@ -338,28 +498,34 @@ void SW_WTH_read(void) {
 	/* =================================================== */
 	SW_WEATHER *w = &SW_Weather;
 	const int nitems = 17;
-	FILE *f;
+	SW_TEXTFILE f;
 	int lineno = 0, month, x;
 	RealF sppt, stmax, stmin;
 	RealF sky, wind, rH;
+	#ifndef RSOILWAT
+	char fname[MAX_FILENAMESIZE];
+	const char *msg;
+
+	SW_WTH_grid_setup(NULL);
+	#endif
 
 	MyFileName = SW_F_name(eWeather);
-	f = OpenFile(MyFileName, "r");
+	OpenTextFile(&f, MyFileName);
 
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 		switch (lineno) {
 		case 0:
-			w->use_snow = itob(atoi(inbuf));
+			w->use_snow = itob(atoi(f.line));
 			break;
 		case 1:
-			w->pct_snowdrift = atoi(inbuf);
+			w->pct_snowdrift = atoi(f.line);
 			break;
 		case 2:
-			w->pct_snowRunoff = atoi(inbuf);
+			w->pct_snowRunoff = atoi(f.line);
 			break;
 
 		case 3:
-			x = atoi(inbuf);
+			x = atoi(f.line);
 			if (x > 1) {
 				w->use_weathergenerator_only = w->use_weathergenerator = swTRUE;
 			} else {
@@ -369,22 +535,30 @@ void SW_WTH_read(void) {
 			break;
 
 		case 4:
-			x = atoi(inbuf);
+			x = atoi(f.line);
 			w->yr.first = (x < 0) ? SW_Model.startyr : yearto4digit(x);
 			break;
 
 		default:
-			if (lineno == 5 + MAX_MONTHS)
+			if (lineno == 5 + MAX_MONTHS) {
+				#ifndef RSOILWAT
+				// optional: gridded weather instead of weather input files
+				if (!isnull(msg = SW_WTH_grid_setup(f.line))) {
+					CloseTextFile(&f);
+					LogError(logfp, LOGFATAL, "%s : %s.", MyFileName, msg);
+				}
+				#endif
 				break;
+			}
 
-			x = sscanf(
-				inbuf,
+			x = Str_Scan(
+				f.line,
 				"%d %f %f %f %f %f %f",
 				&month, &sppt, &stmax, &stmin, &sky, &wind, &rH
 			);
 
 			if (x != 7) {
-				CloseFile(&f);
+				CloseTextFile(&f);
 				LogError(logfp, LOGFATAL, "%s : Bad record %d.", MyFileName, lineno);
 			}
 
@@ -401,12 +575,54 @@ void SW_WTH_read(void) {
 	}
 
 	SW_WeatherPrefix(w->name_prefix);
-	CloseFile(&f);
+	CloseTextFile(&f);
+
+	#ifndef RSOILWAT
+	// use the binary weather store instead of text files if there is one
+	if (!SW_WTH_grid_is_used()) {
+		SW_WTH_store_name(fname, w->name_prefix);
+		SW_WTH_open_store(fname);
+	}
+	#endif
 
 	if (lineno < nitems) {
 		LogError(logfp, LOGFATAL, "%s : Too few input lines.", MyFileName);
 	}
 
+	SW_WTH_init_years();
+}
+
+
+/**
+@brief Pass the daily weather of a sequence of years in memory instead of
+  reading weather input files
+
+  Days with missing values (\ref SW_MISSING) and years outside the range
+  are handled as if they were missing from weather input files.
+
+  @param hist Daily weather of `n_years` consecutive years; the array is not
+    copied and must remain valid until the simulation run is completed.
+  @param first_year Calendar year of `hist[0]`.
+  @param n_years Number of years of `hist`.
+*/
+void SW_WTH_set_memory(const SW_WEATHER_HIST *hist, TimeInt first_year,
+	TimeInt n_years) {
+
+	SW_Weather.memHist = hist;
+	SW_Weather.n_memHist = isnull(hist) ? 0 : n_years;
+	SW_Weather.memHist_year = NULL;
+	SW_Weather.yr.first = first_year;
+}
+
+
+/**
+@brief Check the years of the weather inputs against the simulation period
+
+  Requires that `SW_Weather.yr.first` and `SW_Model` are set up.
+*/
+void SW_WTH_init_years(void) {
+	SW_WEATHER *w = &SW_Weather;
+
 	w->yr.last = SW_Model.endyr;
 	w->yr.total = w->yr.last - w->yr.first + 1;
 
@@ -419,7 +635,7 @@ void SW_WTH_read(void) {
         "Please synchronize the years or "
         "activate the weather generator "
         "(and set up input files `mkv_prob.in` and `mkv_covar.in`).",
-      MyFileName, SW_Model.startyr, w->yr.first
+      SW_F_name(eWeather), SW_Model.startyr, w->yr.first
     );
 	}
 	/* else we assume weather files match model run years */
@@ -456,7 +672,7 @@ Bool _read_weather_hist(TimeInt year) {
 	 */
 
 	SW_WEATHER_HIST *wh = &SW_Weather.hist;
-	FILE *f;
+	SW_TEXTFILE f;
 	int x, lineno = 0, doy;
 	// TimeInt mon, j, k = 0;
 	RealF tmpmax, tmpmin, ppt;
@@ -468,22 +684,24 @@ Bool _read_weather_hist(TimeInt year) {
 
 	_clear_hist_weather(); // clear values before returning
 
-	if (NULL == (f = fopen(fname, "r")))
+	SW_TRC_START(read);
+
+	if (!ReadTextFile(&f, fname))
 		return swFALSE;
 
-	while (GetALine(f, inbuf)) {
+	while (GetATextLine(&f)) {
 		lineno++;
-		x = sscanf(inbuf, "%d %f %f %f", &doy, &tmpmax, &tmpmin, &ppt);
+		x = Str_Scan(f.line, "%d %f %f %f", &doy, &tmpmax, &tmpmin, &ppt);
 		if (x < 4) {
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s : Incomplete record %d (doy=%d).", fname, lineno, doy);
 		}
 		if (x > 4) {
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s : Too many values in record %d (doy=%d).", fname, lineno, doy);
 		}
 		if (doy < 1 || doy > MAX_DAYS) {
-			CloseFile(&f);
+			CloseTextFile(&f);
 			LogError(logfp, LOGFATAL, "%s : Day of year out of range, line %d.", fname, lineno);
 		}
 
@@ -526,10 +744,70 @@ Bool _read_weather_hist(TimeInt year) {
 	}
   */
 
-	fclose(f);
+	CloseTextFile(&f);
+
+	SW_TRC_STOP_INT(read, "read weather", "input", "year", year);
 	return swTRUE;
 }
 
+/** Read the daily weather inputs of a year into `SW_Weather.hist`
+
+  Daily weather passed in memory is not copied; instead,
+  `SW_Weather.memHist_year` points to the year (see `_hist_of_year()`).
+
+  @return swTRUE if weather inputs are available for `year`; it is an error
+    if they are not available and the weather generator is turned off.
+*/
+static Bool _read_hist_year(TimeInt year) {
+	Bool found;
+
+	SW_Weather.memHist_year = NULL;
+
+	if (
+		SW_Weather.use_weathergenerator_only ||
+		year < SW_Weather.yr.first
+	) {
+		found = swFALSE;
+
+	} else if (!isnull(SW_Weather.memHist)) {
+		// daily weather passed in memory, see `SW_WTH_set_memory()`
+		found = (Bool) (year - SW_Weather.yr.first < SW_Weather.n_memHist);
+		if (found) {
+			SW_Weather.memHist_year = SW_Weather.memHist + (year - SW_Weather.yr.first);
+		}
+
+	} else {
+		#ifdef RSOILWAT
+		found = onSet_WTH_DATA_YEAR(year);
+		#else
+		if (SW_WTH_grid_is_used()) {
+			found = SW_WTH_read_grid(year);
+		} else {
+			found = SW_WTH_store_is_open() ?
+				SW_WTH_read_store(year) :
+				_read_weather_hist(year);
+		}
+		#endif
+	}
+
+	if (!found && !SW_Weather.use_weathergenerator) {
+		LogError(
+		  logfp,
+		  LOGFATAL,
+		  "Markov Simulator turned off and weather file not found for year %d",
+		  year
+		);
+	}
+
+	return found;
+}
+
+/** Daily weather inputs of the year of the last call to `_read_hist_year()` */
+static const SW_WEATHER_HIST *_hist_of_year(void) {
+	return isnull(SW_Weather.memHist_year) ?
+		&SW_Weather.hist : SW_Weather.memHist_year;
+}
+
 static void _update_yesterday(void) {
 	/* --------------------------------------------------- */
 	/* save today's temp values as yesterday */
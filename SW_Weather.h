@@ -16,6 +16,10 @@
  06/01/2012  (DLM) added temp_year_avg variable to SW_WEATHER_HIST struct & temp_month_avg[MAX_MONTHS] variable
  11/30/2012	(clk) added variable 'surfaceRunoff' to SW_WEATHER and SW_WEATHER_OUTPUTS
  changed 'runoff' to 'snowRunoff' to better distinguish between surface runoff and snowmelt runoff
+ 2026-10-14 added whole-run weather preload: 'preload_all_years', 'allHist', and 'hist_year'
+ 2026-10-14 added daily weather passed in memory: 'memHist' and 'n_memHist'
+ 2026-10-14 added 'memHist_year' so that weather passed in memory is used without copies
+ 2026-10-15 added 'filled', the weather of the current year with missing values filled in
 
  */
 /********************************************************/
@@ -87,9 +91,23 @@ typedef struct {
 	SW_WEATHER_HIST hist;
 	SW_WEATHER_2DAYS now;
 
+	/* Whole-run weather preload, see `SW_WTH_preload()` */
+	Bool preload_all_years; // swTRUE: prepare weather of all years before the first year
+	SW_WEATHER_HIST
+		*allHist, // daily weather for years `startyr` to `endyr` (NULL if not preloaded)
+		*hist_year; // weather of the current year: element of `allHist` or `filled`
+	SW_WEATHER_HIST filled; // weather of the current year with missing values filled in (if not preloaded)
+
+	/* Daily weather passed in memory, see `SW_WTH_set_memory()` */
+	const SW_WEATHER_HIST *memHist; // daily weather of years `yr.first` to `yr.first + n_memHist - 1` (not owned)
+	TimeInt n_memHist; // number of years of `memHist`
+	const SW_WEATHER_HIST *memHist_year; // element of `memHist` for the current year (NULL if the year was read into `hist`)
 } SW_WEATHER;
 
 void SW_WTH_read(void);
+void SW_WTH_set_memory(const SW_WEATHER_HIST *hist, TimeInt first_year,
+	TimeInt n_years);
+void SW_WTH_init_years(void);
 Bool _read_weather_hist(TimeInt year);
 void _clear_hist_weather(void);
 void SW_WTH_init_run(void);
@@ -97,6 +115,8 @@ void SW_WTH_construct(void);
 void SW_WTH_deconstruct(void);
 void SW_WTH_new_day(void);
 void SW_WTH_new_year(void);
+void SW_WTH_preload(void);
+Bool SW_WTH_temp_avg_year(double temp_avg[]);
 void SW_WTH_sum_today(void);
 void SW_WTH_end_day(void);
 
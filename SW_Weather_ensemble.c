@@ -0,0 +1,276 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Weather_ensemble.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Generate the weather of ensembles of sites and replicates
+ *           once, in parallel, into a shared read-only cache.
+ *
+ *           Simulation runs use the weather of a replicate as daily
+ *           weather passed in memory (see `SW_WTH_set_memory()`) without
+ *           copies; thus, many runs (and threads) can share the cache and
+ *           the Markov weather generator is not called during the runs.
+ *
+ *           For example,
+ *             SW_WTH_ens_init(&ens, startyr, n_years);
+ *             SW_WTH_ens_add(&ens, site, seed, n_replicates, &SW_Markov);
+ *             SW_WTH_ens_generate(&ens, 0);
+ *             for each replicate r (e.g., in parallel):
+ *               SW_WTH_set_memory(SW_WTH_ens_get(&ens, site, seed, r),
+ *                 startyr, n_years);
+ *               simulate the run
+ *             SW_WTH_ens_deconstruct(&ens);
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "rands.h"
+#include "Times.h"
+#include "SW_Defines.h"
+#include "SW_Markov.h"
+#include "SW_Weather.h"
+#include "SW_Weather_ensemble.h"
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** Replicates waiting to be generated: each worker thread takes the
+    next replicate (across all sites) until none are left */
+typedef struct {
+	SW_WTH_ENSEMBLE *ens;
+	unsigned long next, n_jobs; /**< replicates of all sites in order */
+} SW_WTH_ENS_JOBS;
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Generate the weather of all years of one replicate of a site */
+static void generate_replicate(SW_WTH_ENSEMBLE *ens, SW_WTH_ENS_SITE *s,
+	uint32_t replicate) {
+
+	pcg32_random_t rng;
+	SW_WEATHER_HIST *wh = s->hist + (size_t) replicate * ens->n_years;
+	TimeInt year, doy0, n;
+	RealD rain = 0.;
+
+	SW_MKV_seed_stream(&rng, s->seed, s->site, replicate);
+
+	for (year = ens->startyr; year < ens->startyr + ens->n_years; year++, wh++) {
+		n = SW_MKV_generate_year(s->markov, &rng, year, &rain,
+			wh->temp_max, wh->temp_min, wh->ppt);
+
+		for (doy0 = 0; doy0 < n; doy0++) {
+			wh->temp_avg[doy0] = (wh->temp_max[doy0] + wh->temp_min[doy0]) / 2.;
+		}
+
+		for (doy0 = n; doy0 < MAX_DAYS; doy0++) {
+			wh->temp_max[doy0] = wh->temp_min[doy0] = wh->temp_avg[doy0] =
+				wh->ppt[doy0] = SW_MISSING;
+		}
+	}
+}
+
+
+/** Thread function of a worker: generate replicates until none are left */
+static void *generate_worker(void *arg) {
+	SW_WTH_ENS_JOBS *jobs = (SW_WTH_ENS_JOBS *) arg;
+	SW_WTH_ENSEMBLE *ens = jobs->ens;
+	unsigned long job, first;
+	unsigned int k;
+
+	while ((job = __atomic_fetch_add(&jobs->next, 1u, __ATOMIC_RELAXED)) < jobs->n_jobs) {
+		// locate site and replicate of the job
+		for (k = 0, first = 0; job >= first + ens->sites[k].n_replicates; k++) {
+			first += ens->sites[k].n_replicates;
+		}
+
+		generate_replicate(ens, &ens->sites[k], (uint32_t) (job - first));
+	}
+
+	return NULL;
+}
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Set up an empty weather ensemble
+
+@param ens The weather ensemble.
+@param startyr The first calendar year of each replicate.
+@param n_years The number of years of each replicate.
+*/
+void SW_WTH_ens_init(SW_WTH_ENSEMBLE *ens, TimeInt startyr, TimeInt n_years) {
+	memset(ens, 0, sizeof(SW_WTH_ENSEMBLE));
+	ens->startyr = startyr;
+	ens->n_years = n_years;
+}
+
+
+/**
+@brief Add replicates `0` to `n_replicates - 1` of a site to a weather ensemble
+
+The weather is generated by `SW_WTH_ens_generate()`.
+
+@param ens The weather ensemble.
+@param site Index of the site (< 2^31); together with `seed` unique in `ens`.
+@param seed Seed of the replicates.
+@param n_replicates Number of replicates.
+@param markov Weather generator parameters of the site, e.g., `&SW_Markov`
+  (after `SW_MKV_setup()`); must remain valid until the weather is generated.
+*/
+void SW_WTH_ens_add(SW_WTH_ENSEMBLE *ens, uint32_t site, uint64_t seed,
+	uint32_t n_replicates, SW_MARKOV *markov) {
+
+	SW_WTH_ENS_SITE *s;
+	unsigned int k;
+
+	for (k = 0; k < ens->n_sites; k++) {
+		if (ens->sites[k].site == site && ens->sites[k].seed == seed) {
+			LogError(logfp, LOGFATAL,
+				"Weather ensemble has already replicates of site %u with seed %lu",
+				site, (unsigned long) seed);
+		}
+	}
+
+	if (ens->n_sites == ens->n_alloc) {
+		ens->n_alloc = (0 == ens->n_alloc) ? 8 : 2 * ens->n_alloc;
+		ens->sites = (SW_WTH_ENS_SITE *) (isnull(ens->sites) ?
+			Mem_Malloc(ens->n_alloc * sizeof(SW_WTH_ENS_SITE), "SW_WTH_ens_add()") :
+			Mem_ReAlloc(ens->sites, ens->n_alloc * sizeof(SW_WTH_ENS_SITE)));
+	}
+
+	s = &ens->sites[ens->n_sites++];
+	s->site = site;
+	s->seed = seed;
+	s->n_replicates = n_replicates;
+	s->markov = markov;
+	s->hist = (SW_WEATHER_HIST *) Mem_Malloc(
+		(size_t) n_replicates * ens->n_years * sizeof(SW_WEATHER_HIST),
+		"SW_WTH_ens_add()"
+	);
+}
+
+
+/**
+@brief Generate the weather of all replicates of a weather ensemble
+  with a pool of worker threads
+
+The weather of a replicate does not depend on the number of threads.
+Afterwards, the ensemble is read-only and can be shared by simulation runs
+of any thread.
+
+@param ens The weather ensemble.
+@param n_threads Number of worker threads; `0` uses the number of online
+  processors. At most one thread per replicate is used.
+*/
+void SW_WTH_ens_generate(SW_WTH_ENSEMBLE *ens, unsigned int n_threads) {
+	SW_WTH_ENS_JOBS jobs;
+	pthread_t *threads;
+	unsigned int i, k;
+	long n = 1;
+
+	jobs.ens = ens;
+	jobs.next = jobs.n_jobs = 0;
+	for (k = 0; k < ens->n_sites; k++) {
+		jobs.n_jobs += ens->sites[k].n_replicates;
+	}
+
+	if (0 == n_threads) {
+		#ifdef _SC_NPROCESSORS_ONLN
+		n = sysconf(_SC_NPROCESSORS_ONLN);
+		#endif
+		n_threads = (n > 0) ? (unsigned int) n : 1;
+	}
+	n_threads = (unsigned int) min((unsigned long) n_threads, jobs.n_jobs);
+
+	if (n_threads <= 1) {
+		generate_worker(&jobs);
+		return;
+	}
+
+	threads = (pthread_t *) Mem_Calloc(n_threads, sizeof(pthread_t), "SW_WTH_ens_generate()");
+
+	for (i = 0; i < n_threads; i++) {
+		if (0 != pthread_create(&threads[i], NULL, generate_worker, &jobs)) {
+			LogError(logfp, LOGFATAL, "Cannot start worker thread %u of weather ensemble", i);
+		}
+	}
+
+	for (i = 0; i < n_threads; i++) {
+		pthread_join(threads[i], NULL);
+	}
+
+	Mem_Free(threads);
+}
+
+
+/**
+@brief Locate the weather of a replicate in a weather ensemble
+
+@param ens The weather ensemble after `SW_WTH_ens_generate()`.
+@param site Index of the site.
+@param seed Seed of the replicates.
+@param replicate Index of the replicate.
+
+@return Daily weather of `ens->n_years` consecutive years starting with
+  `ens->startyr`, e.g., to be passed to `SW_WTH_set_memory()`; `NULL` if
+  the ensemble does not contain the replicate.
+*/
+const SW_WEATHER_HIST *SW_WTH_ens_get(const SW_WTH_ENSEMBLE *ens,
+	uint32_t site, uint64_t seed, uint32_t replicate) {
+
+	unsigned int k;
+
+	for (k = 0; k < ens->n_sites; k++) {
+		if (ens->sites[k].site == site && ens->sites[k].seed == seed) {
+			return (replicate < ens->sites[k].n_replicates) ?
+				ens->sites[k].hist + (size_t) replicate * ens->n_years : NULL;
+		}
+	}
+
+	return NULL;
+}
+
+
+/**
+@brief Free the memory of a weather ensemble
+
+@param ens The weather ensemble; empty upon return.
+*/
+void SW_WTH_ens_deconstruct(SW_WTH_ENSEMBLE *ens) {
+	unsigned int k;
+
+	for (k = 0; k < ens->n_sites; k++) {
+		Mem_Free(ens->sites[k].hist);
+	}
+
+	if (!isnull(ens->sites)) {
+		Mem_Free(ens->sites);
+	}
+
+	SW_WTH_ens_init(ens, ens->startyr, ens->n_years);
+}
@@ -0,0 +1,71 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Weather_ensemble.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for the cache of
+ *           pre-generated weather ensembles of `SW_Weather_ensemble.c`.
+ *
+ *           An ensemble holds the daily weather of `n_years` consecutive
+ *           years for each replicate of each of its sites. A replicate is
+ *           identified by its key (site, seed, replicate) and its
+ *           weather depends only on the key and on the weather generator
+ *           parameters of the site (see `SW_MKV_seed_stream()`).
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_WEATHER_ENSEMBLE_H
+#define SW_WEATHER_ENSEMBLE_H
+
+#include <stdint.h>
+#include "generic.h"
+#include "SW_Times.h"
+#include "SW_Weather.h"
+#include "SW_Markov.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+/** Replicates of the weather of one site and seed */
+typedef struct {
+	uint32_t site, n_replicates;
+	uint64_t seed;
+	SW_MARKOV *markov; /**< weather generator parameters of the site (not owned) */
+	SW_WEATHER_HIST *hist; /**< `n_years` years of each replicate, replicate by replicate */
+} SW_WTH_ENS_SITE;
+
+/** A cache of weather ensembles; zero-initialized means empty */
+typedef struct {
+	TimeInt startyr, n_years; /**< years of each replicate */
+	unsigned int n_sites, n_alloc;
+	SW_WTH_ENS_SITE *sites;
+} SW_WTH_ENSEMBLE;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_WTH_ens_init(SW_WTH_ENSEMBLE *ens, TimeInt startyr, TimeInt n_years);
+void SW_WTH_ens_add(SW_WTH_ENSEMBLE *ens, uint32_t site, uint64_t seed,
+	uint32_t n_replicates, SW_MARKOV *markov);
+void SW_WTH_ens_generate(SW_WTH_ENSEMBLE *ens, unsigned int n_threads);
+const SW_WEATHER_HIST *SW_WTH_ens_get(const SW_WTH_ENSEMBLE *ens,
+	uint32_t site, uint64_t seed, uint32_t replicate);
+void SW_WTH_ens_deconstruct(SW_WTH_ENSEMBLE *ens);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,924 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Weather_grid.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Read daily historical weather of a site from gridded netCDF
+ *           files (e.g., Daymet or gridMET) instead of the text files
+ *           `[weather-file prefix].[year]` (see `SW_Weather_grid.h`).
+ *
+ *           The grid cell of a site is the cell nearest to the site's
+ *           latitude and longitude; it is located at the first read
+ *           (the site parameters are read after `weathsetup.in`).
+ *           Coordinates are either 1-dimensional (`lat(y)`, `lon(x)`)
+ *           or 2-dimensional (`lat(y, x)`, `lon(y, x)`); variables have
+ *           the dimensions `(time, y, x)`; `time` is in days or hours
+ *           since a date of a `standard`, `gregorian`,
+ *           `proleptic_gregorian`, `noleap`, or `365_day` calendar.
+ *           Days of a `noleap` calendar are days of year 1-365, i.e., as
+ *           Daymet, the last day of a leap year is missing.
+ *           Packed values are unpacked and temperature (K, degC) and
+ *           precipitation (mm, kg m-2, kg m-2 s-1, cm) are converted to
+ *           degC and cm. Days without values are missing, i.e., they
+ *           are handled as days missing from a weather input file.
+ *
+ *           Files stay open and decoded tiles stay in the cache until
+ *           `SW_WTH_grid_close()`; both are shared by all runs of the
+ *           process and are not taken from the arena of a run.
+ *           The netCDF library is not thread-safe: all netCDF calls,
+ *           the cache, and the copying of values from a tile are
+ *           serialized by one lock. Errors are reported only after the
+ *           lock is released because `LogError()` may not return.
+ *
+ *           Without `SW_NETCDF`, only the tile cache is available and
+ *           requesting gridded weather is an error.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef SW_NETCDF
+#include <errno.h>
+#include <pthread.h>
+#include <netcdf.h>
+#endif
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "Times.h"
+#include "SW_Defines.h"
+#include "SW_Site.h"
+#include "SW_Weather.h"
+#include "SW_Weather_grid.h"
+#include "SW_Run.h"
+
+
+/* The gridded weather of a run is part of the simulation run context */
+#define WGrid (SW_CurrentRun->WeatherGrid)
+
+/** Default names of tmax, tmin, and ppt (Daymet) */
+static const char *default_var[SW_WTH_GRID_NVARS] = {"tmax", "tmin", "prcp"};
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+static size_t tile_bytes(const SW_WTH_TILE *t) {
+	return t->count[0] * t->count[1] * t->count[2] * sizeof(float);
+}
+
+static Bool same_key(const SW_WTH_TILE_KEY *a, const SW_WTH_TILE_KEY *b) {
+	return (Bool) (a->src == b->src && a->start[0] == b->start[0] &&
+		a->start[1] == b->start[1] && a->start[2] == b->start[2]);
+}
+
+static void unlink_tile(SW_WTH_TILE_CACHE *c, SW_WTH_TILE *t) {
+	if (isnull(t->prev)) {
+		c->head = t->next;
+	} else {
+		t->prev->next = t->next;
+	}
+
+	if (isnull(t->next)) {
+		c->tail = t->prev;
+	} else {
+		t->next->prev = t->prev;
+	}
+
+	t->prev = t->next = NULL;
+}
+
+static void push_front(SW_WTH_TILE_CACHE *c, SW_WTH_TILE *t) {
+	t->prev = NULL;
+	t->next = c->head;
+
+	if (isnull(c->head)) {
+		c->tail = t;
+	} else {
+		c->head->prev = t;
+	}
+
+	c->head = t;
+}
+
+static void free_tile(SW_WTH_TILE_CACHE *c, SW_WTH_TILE *t) {
+	unlink_tile(c, t);
+	c->n_tiles--;
+	c->n_bytes -= tile_bytes(t);
+	free(t->values);
+	free(t);
+}
+
+#ifdef SW_NETCDF
+
+/** A variable of an open netCDF file */
+typedef struct {
+	char name[SW_WTH_GRID_NAMELEN];
+	int varid;
+	size_t chunk[3]; /**< extent of a tile: a chunk of the variable */
+	double scale, offset, /**< unpacking: scale * raw + offset */
+		fill, missing_value, /**< raw values of days without values */
+		mult, add; /**< conversion to SOILWAT2 units: mult * value + add */
+	const struct GRID_FILE *file;
+} GRID_VAR;
+
+/** An open netCDF file */
+typedef struct GRID_FILE {
+	char path[MAX_FILENAMESIZE];
+	int ncid; /**< -1 if the file does not exist */
+	int dim_time, dim_y, dim_x;
+	size_t n_time, ny, nx;
+	long *day; /**< day number of each time step, see `day_number()` */
+	Bool noleap;
+
+	int n_vars;
+	GRID_VAR var[SW_WTH_GRID_NVARS];
+
+	Bool coord2d; /**< swTRUE if `lat` and `lon` are of dimension `(y, x)` */
+	double *lat, *lon; /**< coordinates; read when a site is located */
+
+	struct GRID_FILE *next;
+} GRID_FILE;
+
+/** Open files and the tile cache of the process */
+static struct {
+	pthread_mutex_t lock;
+	GRID_FILE *files;
+	SW_WTH_TILE_CACHE cache;
+} Grids = {
+	PTHREAD_MUTEX_INITIALIZER, NULL,
+	{NULL, NULL, 0, 0, SW_WTH_GRID_CACHESIZE, 0, 0}
+};
+
+/** Units of variables: kind 0 is temperature, kind 1 is precipitation */
+static const struct {
+	int kind;
+	const char *units;
+	double mult, add;
+} known_units[] = {
+	{0, "degC", 1., 0.}, {0, "C", 1., 0.}, {0, "deg C", 1., 0.},
+	{0, "degree_C", 1., 0.}, {0, "degrees_C", 1., 0.}, {0, "degrees C", 1., 0.},
+	{0, "celsius", 1., 0.}, {0, "Celsius", 1., 0.},
+	{0, "K", 1., -273.15}, {0, "degK", 1., -273.15},
+	{0, "kelvin", 1., -273.15}, {0, "Kelvin", 1., -273.15},
+	{1, "mm", 0.1, 0.}, {1, "mm/day", 0.1, 0.}, {1, "mm day-1", 0.1, 0.},
+	{1, "mm d-1", 0.1, 0.}, {1, "kg m-2", 0.1, 0.}, {1, "kg/m2", 0.1, 0.},
+	{1, "kg m-2 d-1", 0.1, 0.}, {1, "kg m-2 s-1", 8640., 0.},
+	{1, "cm", 1., 0.}, {1, "cm/day", 1., 0.}
+};
+
+
+/** Day number of a date: days since 1970-01-01 (`standard` calendar)
+    or since 0000-01-01 (`noleap` calendar) */
+static long day_number(Bool noleap, long y, int m, int d) {
+	static const int cum_days[MAX_MONTHS] =
+		{0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+	long era, yoe, doy;
+
+	if (noleap) {
+		return 365 * y + cum_days[m - 1] + d - 1;
+	}
+
+	// proleptic Gregorian calendar
+	y -= (m <= 2);
+	era = (y >= 0 ? y : y - 399) / 400;
+	yoe = y - era * 400;
+	doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+
+	return era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+}
+
+/** Index of the first time step on or after day number `x` */
+static size_t lower_bound(const long *day, size_t n, long x) {
+	size_t lo = 0, hi = n, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (day[mid] < x) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static Bool get_att_text(int ncid, int varid, const char *name,
+	char *s, size_t size) {
+
+	size_t len;
+
+	if (NC_NOERR != nc_inq_attlen(ncid, varid, name, &len) || len >= size ||
+		NC_NOERR != nc_get_att_text(ncid, varid, name, s)) {
+		return swFALSE;
+	}
+
+	s[len] = '\0';
+	return swTRUE;
+}
+
+static double get_att_double(int ncid, int varid, const char *name, double dflt) {
+	double x;
+
+	return (NC_NOERR == nc_get_att_double(ncid, varid, name, &x)) ? x : dflt;
+}
+
+/** Read the time axis of a file */
+static Bool read_time(GRID_FILE *f, char *msg) {
+	char units[128], unit[16], calendar[64];
+	int varid, ndims, m, d;
+	long y, base;
+	double per_day, *t;
+	size_t i;
+
+	if (NC_NOERR != nc_inq_varid(f->ncid, "time", &varid) ||
+		NC_NOERR != nc_inq_varndims(f->ncid, varid, &ndims) || 1 != ndims ||
+		NC_NOERR != nc_inq_vardimid(f->ncid, varid, &f->dim_time) ||
+		NC_NOERR != nc_inq_dimlen(f->ncid, f->dim_time, &f->n_time)) {
+		snprintf(msg, MAX_ERROR, "%s : No coordinate variable 'time'.", f->path);
+		return swFALSE;
+	}
+
+	if (!get_att_text(f->ncid, varid, "units", units, sizeof units) ||
+		4 != sscanf(units, "%15s since %ld-%d-%d", unit, &y, &m, &d) ||
+		m < 1 || m > MAX_MONTHS) {
+		snprintf(msg, MAX_ERROR, "%s : Units of 'time' are not '<days|hours> since <date>'.", f->path);
+		return swFALSE;
+	}
+
+	if (0 == strcmp(unit, "days")) {
+		per_day = 1.;
+	} else if (0 == strcmp(unit, "hours")) {
+		per_day = 24.;
+	} else {
+		snprintf(msg, MAX_ERROR, "%s : Units of 'time' are not days or hours.", f->path);
+		return swFALSE;
+	}
+
+	if (!get_att_text(f->ncid, varid, "calendar", calendar, sizeof calendar) ||
+		0 == strcmp(calendar, "standard") || 0 == strcmp(calendar, "gregorian") ||
+		0 == strcmp(calendar, "proleptic_gregorian")) {
+		f->noleap = swFALSE;
+	} else if (0 == strcmp(calendar, "noleap") || 0 == strcmp(calendar, "365_day")) {
+		f->noleap = swTRUE;
+	} else {
+		snprintf(msg, MAX_ERROR, "%s : Unsupported calendar '%s'.", f->path, calendar);
+		return swFALSE;
+	}
+
+	base = day_number(f->noleap, y, m, d);
+	t = (double *) malloc(max(f->n_time, 1) * sizeof(double));
+	f->day = (long *) malloc(max(f->n_time, 1) * sizeof(long));
+
+	if (isnull(t) || isnull(f->day) ||
+		NC_NOERR != nc_get_var_double(f->ncid, varid, t)) {
+		free(t);
+		snprintf(msg, MAX_ERROR, "%s : Cannot read 'time'.", f->path);
+		return swFALSE;
+	}
+
+	for (i = 0; i < f->n_time; i++) {
+		// time steps may be centered on a day (e.g., noon)
+		f->day[i] = base + (long) floor(t[i] / per_day + 1e-6);
+
+		if (i > 0 && f->day[i] <= f->day[i - 1]) {
+			free(t);
+			snprintf(msg, MAX_ERROR, "%s : Time steps are not increasing days.", f->path);
+			return swFALSE;
+		}
+	}
+
+	free(t);
+	return swTRUE;
+}
+
+static void free_file(GRID_FILE *f) {
+	int k;
+
+	for (k = 0; k < f->n_vars; k++) {
+		SW_WTH_tile_evict(&Grids.cache, &f->var[k]);
+	}
+
+	if (f->ncid >= 0) {
+		nc_close(f->ncid);
+	}
+
+	free(f->day);
+	free(f->lat);
+	free(f->lon);
+	free(f);
+}
+
+/** Find or open a file; a missing file that is not `required` is
+    remembered as not existing (`ncid` is -1) */
+static GRID_FILE *open_file(const char *fname, Bool required, char *msg) {
+	GRID_FILE *f;
+	int status;
+
+	for (f = Grids.files; !isnull(f); f = f->next) {
+		if (0 == strcmp(f->path, fname)) {
+			return f;
+		}
+	}
+
+	if (isnull(f = (GRID_FILE *) calloc(1, sizeof *f))) {
+		snprintf(msg, MAX_ERROR, "%s : Out of memory.", fname);
+		return NULL;
+	}
+
+	strcpy(f->path, fname);
+	status = nc_open(fname, NC_NOWRITE, &f->ncid);
+
+	if (NC_NOERR != status) {
+		f->ncid = -1;
+
+		if (required || ENOENT != status) {
+			snprintf(msg, MAX_ERROR, "%s : %s", fname, nc_strerror(status));
+			free_file(f);
+			return NULL;
+		}
+
+	} else if (!read_time(f, msg)) {
+		free_file(f);
+		return NULL;
+	}
+
+	f->next = Grids.files;
+	Grids.files = f;
+
+	return f;
+}
+
+/** Find a variable of a file and prepare its tiles and conversion
+
+  @param kind 0 for temperature, 1 for precipitation.
+*/
+static GRID_VAR *find_var(GRID_FILE *f, const char *name, int kind, char *msg) {
+	GRID_VAR *v;
+	int i, ndims, dims[NC_MAX_VAR_DIMS], storage;
+	size_t ny, nx, chunk[3], n_units = sizeof known_units / sizeof known_units[0];
+	char units[SW_WTH_GRID_NAMELEN];
+
+	for (i = 0; i < f->n_vars; i++) {
+		if (0 == strcmp(f->var[i].name, name)) {
+			return &f->var[i];
+		}
+	}
+
+	if (SW_WTH_GRID_NVARS == f->n_vars) {
+		snprintf(msg, MAX_ERROR, "%s : Too many variables requested.", f->path);
+		return NULL;
+	}
+
+	v = &f->var[f->n_vars];
+
+	if (NC_NOERR != nc_inq_varid(f->ncid, name, &v->varid) ||
+		NC_NOERR != nc_inq_varndims(f->ncid, v->varid, &ndims) || 3 != ndims ||
+		NC_NOERR != nc_inq_vardimid(f->ncid, v->varid, dims) ||
+		dims[0] != f->dim_time ||
+		NC_NOERR != nc_inq_dimlen(f->ncid, dims[1], &ny) ||
+		NC_NOERR != nc_inq_dimlen(f->ncid, dims[2], &nx)) {
+		snprintf(msg, MAX_ERROR, "%s : No variable '%s' of dimensions (time, y, x).",
+			f->path, name);
+		return NULL;
+	}
+
+	if (0 == f->n_vars) {
+		f->dim_y = dims[1];
+		f->dim_x = dims[2];
+		f->ny = ny;
+		f->nx = nx;
+	} else if (dims[1] != f->dim_y || dims[2] != f->dim_x) {
+		snprintf(msg, MAX_ERROR, "%s : Variables are not on the same grid.", f->path);
+		return NULL;
+	}
+
+	// a tile is a chunk; contiguous variables are read in tiles of a year
+	if (NC_NOERR == nc_inq_var_chunking(f->ncid, v->varid, &storage, chunk) &&
+		NC_CHUNKED == storage) {
+		memcpy(v->chunk, chunk, sizeof chunk);
+	} else {
+		v->chunk[0] = min(f->n_time, (size_t) MAX_DAYS);
+		v->chunk[1] = min(ny, (size_t) 16);
+		v->chunk[2] = min(nx, (size_t) 16);
+	}
+
+	v->scale = get_att_double(f->ncid, v->varid, "scale_factor", 1.);
+	v->offset = get_att_double(f->ncid, v->varid, "add_offset", 0.);
+	v->fill = get_att_double(f->ncid, v->varid, "_FillValue", NC_FILL_FLOAT);
+	v->missing_value = get_att_double(f->ncid, v->varid, "missing_value", v->fill);
+
+	if (!get_att_text(f->ncid, v->varid, "units", units, sizeof units)) {
+		snprintf(msg, MAX_ERROR, "%s : Variable '%s' has no units.", f->path, name);
+		return NULL;
+	}
+
+	for (i = 0; i < (int) n_units; i++) {
+		if (known_units[i].kind == kind && 0 == strcmp(known_units[i].units, units)) {
+			break;
+		}
+	}
+
+	if (i == (int) n_units) {
+		snprintf(msg, MAX_ERROR, "%s : Unsupported units '%s' of variable '%s'.",
+			f->path, units, name);
+		return NULL;
+	}
+
+	v->mult = known_units[i].mult;
+	v->add = known_units[i].add;
+	v->file = f;
+	strcpy(v->name, name);
+	f->n_vars++;
+
+	return v;
+}
+
+/** Read the coordinates of the grid of a file */
+static Bool read_coords(GRID_FILE *f, char *msg) {
+	int ilat, ilon, nd_lat, nd_lon, d_lat[2], d_lon[2];
+	size_t n;
+
+	if ((NC_NOERR != nc_inq_varid(f->ncid, "lat", &ilat) &&
+			NC_NOERR != nc_inq_varid(f->ncid, "latitude", &ilat)) ||
+		(NC_NOERR != nc_inq_varid(f->ncid, "lon", &ilon) &&
+			NC_NOERR != nc_inq_varid(f->ncid, "longitude", &ilon)) ||
+		NC_NOERR != nc_inq_varndims(f->ncid, ilat, &nd_lat) ||
+		NC_NOERR != nc_inq_varndims(f->ncid, ilon, &nd_lon) ||
+		nd_lat != nd_lon || nd_lat < 1 || nd_lat > 2 ||
+		NC_NOERR != nc_inq_vardimid(f->ncid, ilat, d_lat) ||
+		NC_NOERR != nc_inq_vardimid(f->ncid, ilon, d_lon)) {
+		snprintf(msg, MAX_ERROR, "%s : No coordinate variables 'lat' and 'lon'.", f->path);
+		return swFALSE;
+	}
+
+	f->coord2d = (Bool) (2 == nd_lat);
+
+	if (f->coord2d ?
+		(d_lat[0] != f->dim_y || d_lat[1] != f->dim_x ||
+			d_lon[0] != f->dim_y || d_lon[1] != f->dim_x) :
+		(d_lat[0] != f->dim_y || d_lon[0] != f->dim_x)) {
+		snprintf(msg, MAX_ERROR, "%s : Coordinates 'lat' and 'lon' do not match the grid.",
+			f->path);
+		return swFALSE;
+	}
+
+	n = f->coord2d ? f->ny * f->nx : max(f->ny, f->nx);
+	f->lat = (double *) malloc(max(n, 1) * sizeof(double));
+	f->lon = (double *) malloc(max(n, 1) * sizeof(double));
+
+	if (isnull(f->lat) || isnull(f->lon) ||
+		NC_NOERR != nc_get_var_double(f->ncid, ilat, f->lat) ||
+		NC_NOERR != nc_get_var_double(f->ncid, ilon, f->lon)) {
+		free(f->lat);
+		free(f->lon);
+		f->lat = f->lon = NULL;
+		snprintf(msg, MAX_ERROR, "%s : Cannot read 'lat' and 'lon'.", f->path);
+		return swFALSE;
+	}
+
+	return swTRUE;
+}
+
+/** Index of the value nearest to `x`; `dist` is the distance to it
+    and `step` the distance to its neighbor */
+static size_t nearest(const double *a, size_t n, double x, double *dist,
+	double *step) {
+
+	size_t i, k = 0;
+
+	for (i = 1; i < n; i++) {
+		if (fabs(a[i] - x) < fabs(a[k] - x)) {
+			k = i;
+		}
+	}
+
+	*dist = fabs(a[k] - x);
+	*step = (n > 1) ? fabs(a[(k + 1 < n) ? k + 1 : k - 1] - a[k]) : HUGE_VAL;
+
+	return k;
+}
+
+/** Locate the grid cell of the site of the active run */
+static Bool locate(GRID_FILE *f, char *msg) {
+	double slat = SW_Site.latitude * rad_to_deg,
+		slon = SW_Site.longitude * rad_to_deg,
+		lon_max = -HUGE_VAL, coslat = cos(SW_Site.latitude), d, dy, dx, sy, sx;
+	size_t i, n, best = 0;
+
+	if (isnull(f->lat) && !read_coords(f, msg)) {
+		return swFALSE;
+	}
+
+	n = f->coord2d ? f->ny * f->nx : f->nx;
+	for (i = 0; i < n; i++) {
+		lon_max = fmax(lon_max, f->lon[i]);
+	}
+
+	// longitudes of the grid may be 0-360
+	if (lon_max > 180. && slon < 0.) {
+		slon += 360.;
+	}
+
+	if (f->coord2d) {
+		for (i = 0, dy = HUGE_VAL; i < n; i++) {
+			d = squared(f->lat[i] - slat) + squared((f->lon[i] - slon) * coslat);
+			if (d < dy) {
+				dy = d;
+				best = i;
+			}
+		}
+
+		WGrid.iy = best / f->nx;
+		WGrid.ix = best % f->nx;
+
+	} else {
+		WGrid.iy = nearest(f->lat, f->ny, slat, &dy, &sy);
+		WGrid.ix = nearest(f->lon, f->nx, slon, &dx, &sx);
+
+		if (dy > sy || dx > sx) {
+			snprintf(msg, MAX_ERROR,
+				"%s : Site (%.4f, %.4f) is outside of the grid.", f->path, slat, slon);
+			return swFALSE;
+		}
+	}
+
+	WGrid.ny = f->ny;
+	WGrid.nx = f->nx;
+	WGrid.located = swTRUE;
+
+	return swTRUE;
+}
+
+/** Name of the file of a variable and year, see `SW_WTH_GRID.pattern` */
+static void grid_filename(char *fname, const char *var, TimeInt year) {
+	const char *p = WGrid.pattern;
+	size_t n = 0;
+
+	while (*p != '\0' && n + 1 < MAX_FILENAMESIZE) {
+		if (0 == strncmp(p, "{var}", 5)) {
+			n += snprintf(fname + n, MAX_FILENAMESIZE - n, "%s", var);
+			p += 5;
+		} else if (0 == strncmp(p, "{year}", 6)) {
+			n += snprintf(fname + n, MAX_FILENAMESIZE - n, "%u", year);
+			p += 6;
+		} else {
+			fname[n++] = *p++;
+		}
+
+		n = min(n, (size_t) MAX_FILENAMESIZE - 1);
+	}
+
+	fname[n] = '\0';
+}
+
+/** Read the values of a tile of a variable */
+static int load_tile(const SW_WTH_TILE_KEY *key, const size_t count[3],
+	float *values, void *data) {
+
+	const GRID_VAR *v = (const GRID_VAR *) key->src;
+	size_t i, n = count[0] * count[1] * count[2];
+	double x;
+	int status;
+
+	(void) data;
+
+	status = nc_get_vara_float(v->file->ncid, v->varid, key->start, count, values);
+	if (NC_NOERR != status) {
+		return status;
+	}
+
+	for (i = 0; i < n; i++) {
+		x = values[i];
+
+		if (!isfinite(x) || x == v->fill || x == v->missing_value) {
+			values[i] = (float) SW_MISSING;
+		} else {
+			values[i] = (float) ((x * v->scale + v->offset) * v->mult + v->add);
+		}
+	}
+
+	return NC_NOERR;
+}
+
+/** Copy the values of a variable of a year at the site's grid cell;
+    must be called with the lock held
+
+  @param k Index of the variable: 0, tmax; 1, tmin; 2, ppt.
+  @param dest Values by day of year (base0).
+
+  @return swTRUE if the variable has values for days of `year`.
+*/
+static Bool read_var(int k, TimeInt year, RealD *dest, char *msg) {
+	char fname[MAX_FILENAMESIZE];
+	GRID_FILE *f;
+	GRID_VAR *v;
+	const SW_WTH_TILE *tile;
+	SW_WTH_TILE_KEY key;
+	size_t count[3], t, i0, i1, off;
+	long d0;
+	int status;
+
+	grid_filename(fname, WGrid.var[k], year);
+
+	if (isnull(f = open_file(fname, (Bool) isnull(strstr(WGrid.pattern, "{year}")), msg)) ||
+		f->ncid < 0 ||
+		isnull(v = find_var(f, WGrid.var[k], (k < 2) ? 0 : 1, msg))) {
+		return swFALSE;
+	}
+
+	if (!WGrid.located) {
+		if (!locate(f, msg)) {
+			return swFALSE;
+		}
+	} else if (f->ny != WGrid.ny || f->nx != WGrid.nx) {
+		snprintf(msg, MAX_ERROR, "%s : Grid differs from the grid of other files.", fname);
+		return swFALSE;
+	}
+
+	d0 = day_number(f->noleap, year, 1, 1);
+	i0 = lower_bound(f->day, f->n_time, d0);
+	i1 = lower_bound(f->day, f->n_time,
+		d0 + (long) (f->noleap ? 365 : Time_get_lastdoy_y(year)));
+
+	key.src = v;
+	key.start[1] = WGrid.iy - WGrid.iy % v->chunk[1];
+	key.start[2] = WGrid.ix - WGrid.ix % v->chunk[2];
+	count[1] = min(v->chunk[1], f->ny - key.start[1]);
+	count[2] = min(v->chunk[2], f->nx - key.start[2]);
+	off = (WGrid.iy - key.start[1]) * count[2] + (WGrid.ix - key.start[2]);
+
+	for (t = i0; t < i1; ) {
+		key.start[0] = t - t % v->chunk[0];
+		count[0] = min(v->chunk[0], f->n_time - key.start[0]);
+
+		tile = SW_WTH_tile_get(&Grids.cache, &key, count, load_tile, NULL, &status);
+		if (isnull(tile)) {
+			snprintf(msg, MAX_ERROR, "%s : Cannot read variable '%s': %s", fname,
+				v->name, (0 != status) ? nc_strerror(status) : "out of memory");
+			return swFALSE;
+		}
+
+		for (; t < i1 && t < key.start[0] + count[0]; t++) {
+			dest[f->day[t] - d0] =
+				tile->values[(t - key.start[0]) * count[1] * count[2] + off];
+		}
+	}
+
+	return (Bool) (i1 > i0);
+}
+
+#endif
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Find a tile in a cache or load it
+
+A found tile becomes the most recently used tile; a loaded tile is added
+and the least recently used tiles are dropped until the cache is within
+`max_bytes` again. The cache is not locked: the returned tile is valid
+until the next call with the same cache.
+
+@param c Tile cache; starts out zero-initialized except for `max_bytes`.
+@param key Identifies the tile.
+@param count Extent of the tile in each dimension.
+@param load Loads the values of a tile that is not in the cache.
+@param data Passed on to `load`.
+@param status Error code of `load`; 0 if the tile could not be allocated.
+
+@return The tile or `NULL` if it could not be loaded.
+*/
+const SW_WTH_TILE *SW_WTH_tile_get(SW_WTH_TILE_CACHE *c,
+	const SW_WTH_TILE_KEY *key, const size_t count[3],
+	SW_WTH_TILE_LOADER load, void *data, int *status) {
+
+	SW_WTH_TILE *t;
+	float *values;
+
+	*status = 0;
+
+	for (t = c->head; !isnull(t); t = t->next) {
+		if (same_key(&t->key, key)) {
+			c->n_hits++;
+
+			if (t != c->head) {
+				unlink_tile(c, t);
+				push_front(c, t);
+			}
+
+			return t;
+		}
+	}
+
+	c->n_misses++;
+
+	t = (SW_WTH_TILE *) malloc(sizeof *t);
+	values = (float *) malloc(max(count[0] * count[1] * count[2], 1) * sizeof(float));
+
+	if (isnull(t) || isnull(values) ||
+		0 != (*status = load(key, count, values, data))) {
+		free(t);
+		free(values);
+		return NULL;
+	}
+
+	t->key = *key;
+	memcpy(t->count, count, sizeof t->count);
+	t->values = values;
+
+	push_front(c, t);
+	c->n_tiles++;
+	c->n_bytes += tile_bytes(t);
+
+	while (c->n_bytes > c->max_bytes && c->tail != t) {
+		free_tile(c, c->tail);
+	}
+
+	return t;
+}
+
+
+/**
+@brief Drop the tiles of a source from a cache
+
+@param c Tile cache.
+@param src Source of tiles, see `SW_WTH_TILE_KEY`.
+*/
+void SW_WTH_tile_evict(SW_WTH_TILE_CACHE *c, const void *src) {
+	SW_WTH_TILE *t = c->head, *next;
+
+	while (!isnull(t)) {
+		next = t->next;
+		if (t->key.src == src) {
+			free_tile(c, t);
+		}
+		t = next;
+	}
+}
+
+
+/**
+@brief Drop all tiles of a cache
+
+@param c Tile cache; `max_bytes` is kept.
+*/
+void SW_WTH_tile_clear(SW_WTH_TILE_CACHE *c) {
+	while (!isnull(c->head)) {
+		free_tile(c, c->head);
+	}
+
+	c->n_hits = c->n_misses = 0;
+}
+
+
+/**
+@brief Set up gridded weather for the active run
+
+@param spec The optional last line of `weathsetup.in`:
+  `<netCDF file> [<tmax> <tmin> <ppt>]`; `NULL` if gridded weather is not used.
+
+@return An error message or `NULL` if the specification is valid.
+*/
+const char *SW_WTH_grid_setup(const char *spec) {
+	int k, n;
+
+	memset(&WGrid, 0, sizeof WGrid);
+
+	if (isnull(spec)) {
+		return NULL;
+	}
+
+	// field widths: MAX_FILENAMESIZE - 1 and SW_WTH_GRID_NAMELEN - 1
+	n = sscanf(spec, "%511s %63s %63s %63s",
+		WGrid.pattern, WGrid.var[0], WGrid.var[1], WGrid.var[2]);
+
+	if (1 == n) {
+		for (k = 0; k < SW_WTH_GRID_NVARS; k++) {
+			strcpy(WGrid.var[k], default_var[k]);
+		}
+
+	} else if (1 + SW_WTH_GRID_NVARS != n) {
+		WGrid.pattern[0] = '\0';
+		return "Gridded weather needs a file name and, optionally, "
+			"the variable names of tmax, tmin, and ppt";
+	}
+
+	#ifndef SW_NETCDF
+	WGrid.pattern[0] = '\0';
+	return "Gridded weather requires SOILWAT2 compiled with netCDF "
+		"(add -DSW_NETCDF to CPPFLAGS and -lnetcdf to LDLIBS)";
+	#else
+	return NULL;
+	#endif
+}
+
+
+/**
+@brief Does the active simulation run use gridded weather?
+*/
+Bool SW_WTH_grid_is_used(void) {
+	return (Bool) ('\0' != WGrid.pattern[0]);
+}
+
+
+/**
+@brief Copy the historical weather of a simulation year at the site's grid
+  cell into `SW_Weather.hist`
+
+@param year Calendar year.
+
+@return `swTRUE`/`swFALSE` if the grid has/has no values for days of `year`.
+  Errors of files and variables are fatal.
+*/
+Bool SW_WTH_read_grid(TimeInt year) {
+	SW_WEATHER_HIST *wh = &SW_Weather.hist;
+	Bool found = swFALSE;
+	#ifdef SW_NETCDF
+	RealD *dest[SW_WTH_GRID_NVARS] = {wh->temp_max, wh->temp_min, wh->ppt};
+	char msg[MAX_ERROR] = "";
+	TimeInt d;
+	int k;
+	#endif
+
+	_clear_hist_weather();
+
+	#ifdef SW_NETCDF
+	pthread_mutex_lock(&Grids.lock);
+	for (k = 0; k < SW_WTH_GRID_NVARS && '\0' == *msg; k++) {
+		found = read_var(k, year, dest[k], msg) || found;
+	}
+	pthread_mutex_unlock(&Grids.lock);
+
+	if ('\0' != *msg) {
+		LogError(logfp, LOGFATAL, "%s", msg);
+	}
+
+	for (d = 0; d < MAX_DAYS; d++) {
+		if (!missing(wh->temp_max[d]) && !missing(wh->temp_min[d])) {
+			wh->temp_avg[d] = (wh->temp_max[d] + wh->temp_min[d]) / 2.0;
+		}
+	}
+	#else
+	(void) wh;
+	(void) year;
+	#endif
+
+	return found;
+}
+
+
+/**
+@brief Set the size of the tile cache of the process
+
+@param max_bytes Size of the values of all tiles [bytes]; the default is
+  `SW_WTH_GRID_CACHESIZE`.
+*/
+void SW_WTH_grid_cache_size(size_t max_bytes) {
+	#ifdef SW_NETCDF
+	pthread_mutex_lock(&Grids.lock);
+	Grids.cache.max_bytes = max_bytes;
+	pthread_mutex_unlock(&Grids.lock);
+	#else
+	(void) max_bytes;
+	#endif
+}
+
+
+/**
+@brief Close all files of gridded weather and drop all tiles
+
+Call when no run uses gridded weather anymore, e.g., at the end of a batch.
+*/
+void SW_WTH_grid_close(void) {
+	#ifdef SW_NETCDF
+	GRID_FILE *f;
+
+	pthread_mutex_lock(&Grids.lock);
+
+	while (!isnull(f = Grids.files)) {
+		Grids.files = f->next;
+		free_file(f);
+	}
+
+	SW_WTH_tile_clear(&Grids.cache);
+
+	pthread_mutex_unlock(&Grids.lock);
+	#endif
+}
@@ -0,0 +1,112 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Weather_grid.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for the gridded weather
+ *           inputs of `SW_Weather_grid.c`.
+ *
+ *           Gridded weather is requested by an optional last line of
+ *           `weathsetup.in`:
+ *             `<netCDF file> [<tmax> <tmin> <ppt>]`
+ *           where the file name may contain `{var}` (replaced by the name
+ *           of a variable) and `{year}` (replaced by the calendar year),
+ *           e.g., `Input/daymet/daymet_v4_daily_na_{var}_{year}.nc`;
+ *           variable names default to `tmax tmin prcp` (Daymet).
+ *
+ *           Values are read in tiles, i.e., hyperslabs of
+ *           `time x y x x` values that match the chunks of a variable.
+ *           Decoded tiles are kept in a least-recently-used cache that
+ *           all runs of the process share so that neighboring sites of
+ *           a batch reuse them.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_WEATHER_GRID_H
+#define SW_WEATHER_GRID_H
+
+#include <stddef.h>
+#include "generic.h"
+#include "SW_Defines.h"
+#include "SW_Times.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+#define SW_WTH_GRID_NVARS 3 /**< variables of gridded weather: tmax, tmin, ppt */
+#define SW_WTH_GRID_NAMELEN 64 /**< maximum length of a variable name */
+#define SW_WTH_GRID_CACHESIZE (256 * 1024 * 1024) /**< default size of the tile cache [bytes] */
+
+/** Gridded weather of a simulation run, see `SW_WTH_grid_setup()` */
+typedef struct {
+	char pattern[MAX_FILENAMESIZE]; /**< name of the netCDF file(s); empty if gridded weather is not used */
+	char var[SW_WTH_GRID_NVARS][SW_WTH_GRID_NAMELEN]; /**< names of tmax, tmin, and ppt */
+
+	Bool located; /**< swTRUE if the grid cell of the site is known */
+	size_t ny, nx, /**< size of the grid */
+		iy, ix; /**< grid cell of the site */
+} SW_WTH_GRID;
+
+
+/** Identifies a tile: its source (e.g., a variable of an open file) and
+    the index of its first value in each dimension `time, y, x` */
+typedef struct {
+	const void *src;
+	size_t start[3];
+} SW_WTH_TILE_KEY;
+
+/** A decoded tile of `count[0] * count[1] * count[2]` values (row-major) */
+typedef struct SW_WTH_TILE {
+	SW_WTH_TILE_KEY key;
+	size_t count[3];
+	float *values;
+	struct SW_WTH_TILE *prev, *next; /**< more/less recently used tile */
+} SW_WTH_TILE;
+
+/** Load (and decode) the values of a tile
+
+  @return 0 on success; otherwise an error code of the source.
+*/
+typedef int (*SW_WTH_TILE_LOADER)(const SW_WTH_TILE_KEY *key,
+	const size_t count[3], float *values, void *data);
+
+/** Least-recently-used cache of tiles, bounded by the size of their values */
+typedef struct {
+	SW_WTH_TILE *head, *tail; /**< most/least recently used tile */
+	size_t n_tiles, n_bytes,
+		max_bytes; /**< the most recently used tile is kept even if larger */
+	unsigned long n_hits, n_misses;
+} SW_WTH_TILE_CACHE;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+const SW_WTH_TILE *SW_WTH_tile_get(SW_WTH_TILE_CACHE *c,
+	const SW_WTH_TILE_KEY *key, const size_t count[3],
+	SW_WTH_TILE_LOADER load, void *data, int *status);
+void SW_WTH_tile_evict(SW_WTH_TILE_CACHE *c, const void *src);
+void SW_WTH_tile_clear(SW_WTH_TILE_CACHE *c);
+
+const char *SW_WTH_grid_setup(const char *spec);
+Bool SW_WTH_grid_is_used(void);
+Bool SW_WTH_read_grid(TimeInt year);
+void SW_WTH_grid_cache_size(size_t max_bytes);
+void SW_WTH_grid_close(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
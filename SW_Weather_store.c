@@ -0,0 +1,324 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Weather_store.c
+ *  Type: module
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Read daily historical weather from a binary weather store
+ *           instead of the text files `[weather-file prefix].[year]`,
+ *           and convert text files into a weather store.
+ *
+ *           A weather store holds all years of a site in one file
+ *           (see `SW_Weather_store.h`). The store is memory-mapped and
+ *           the values of a year are copied into `SW_Weather.hist`
+ *           without any text parsing.
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include "generic.h"
+#include "filefuncs.h"
+#include "myMemory.h"
+#include "SW_Defines.h"
+#include "SW_Weather.h"
+#include "SW_Weather_store.h"
+#include "SW_Run.h"
+
+
+/* The open weather store is part of the simulation run context */
+#define WStore (SW_CurrentRun->WeatherStore)
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Check that a mapped file is a complete weather store of this format
+
+  @return An error message or `NULL` if the store is valid.
+*/
+static const char *check_store(const void *map, size_t size) {
+	const SW_WTH_STORE_HEADER *h = (const SW_WTH_STORE_HEADER *) map;
+	const SW_WTH_STORE_YEAR *index;
+	size_t len_block;
+	uint32_t i;
+
+	if (size < sizeof(SW_WTH_STORE_HEADER) ||
+		0 != memcmp(h->magic, SW_WTH_STORE_MAGIC, sizeof h->magic)) {
+		return "not a weather store";
+	}
+
+	if (h->version != SW_WTH_STORE_VERSION) {
+		return "unsupported version of weather store";
+	}
+
+	if (h->byteorder != SW_WTH_STORE_BYTEORDER) {
+		return "weather store was created with a different byte order";
+	}
+
+	if (h->n_days != MAX_DAYS) {
+		return "weather store has an unexpected number of days per year";
+	}
+
+	if (size < sizeof(SW_WTH_STORE_HEADER) +
+		(size_t) h->n_years * sizeof(SW_WTH_STORE_YEAR)) {
+		return "index of weather store is truncated";
+	}
+
+	index = (const SW_WTH_STORE_YEAR *) (h + 1);
+	len_block = 3 * (size_t) h->n_days * sizeof(float);
+
+	for (i = 0; i < h->n_years; i++) {
+		if (index[i].offset > size || size - index[i].offset < len_block) {
+			return "data of weather store is truncated";
+		}
+
+		if (i > 0 && index[i].year <= index[i - 1].year) {
+			return "index of weather store is not sorted by year";
+		}
+	}
+
+	return NULL;
+}
+
+
+/** Locate the data block of a year in the open weather store
+
+  @return Pointer to `temp_max[n_days]` (followed by `temp_min` and `ppt`)
+    or `NULL` if the store has no data for `year`.
+*/
+static const float *find_year(TimeInt year) {
+	const SW_WTH_STORE_YEAR *index = WStore.index;
+	long lo = 0, hi = (long) WStore.header->n_years - 1, mid;
+
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+
+		if (index[mid].year == (int32_t) year) {
+			return (const float *) ((const char *) WStore.map + index[mid].offset);
+		}
+
+		if (index[mid].year < (int32_t) year) {
+			lo = mid + 1;
+		} else {
+			hi = mid - 1;
+		}
+	}
+
+	return NULL;
+}
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Public Function Definitions             */
+/* --------------------------------------------------- */
+
+/**
+@brief Name of the weather store that belongs to text weather files
+
+@param fname Resulting file name `[name_prefix].bin`; of size `MAX_FILENAMESIZE`.
+@param name_prefix Weather-file prefix, see `SW_Weather.name_prefix`.
+*/
+void SW_WTH_store_name(char *fname, const char *name_prefix) {
+	snprintf(fname, MAX_FILENAMESIZE, "%s%s", name_prefix, SW_WTH_STORE_EXT);
+}
+
+
+/**
+@brief Open (memory-map) a weather store for the active simulation run
+
+A previously opened store of the run is closed first.
+
+@param fname Name of the weather store file.
+
+@return `swTRUE` if the store was opened; `swFALSE` if the file does not exist.
+  An invalid store is a fatal error.
+*/
+Bool SW_WTH_open_store(const char *fname) {
+	int fd;
+	struct stat sb;
+	void *map;
+	const char *msg;
+
+	SW_WTH_close_store();
+
+	if (-1 == (fd = open(fname, O_RDONLY))) {
+		return swFALSE;
+	}
+
+	if (0 != fstat(fd, &sb) || sb.st_size <= 0) {
+		close(fd);
+		LogError(logfp, LOGFATAL, "%s : Cannot determine size of weather store.", fname);
+	}
+
+	map = mmap(NULL, (size_t) sb.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (MAP_FAILED == map) {
+		LogError(logfp, LOGFATAL, "%s : Cannot map weather store: %s",
+			fname, strerror(errno));
+	}
+
+	if (!isnull(msg = check_store(map, (size_t) sb.st_size))) {
+		munmap(map, (size_t) sb.st_size);
+		LogError(logfp, LOGFATAL, "%s : %s.", fname, msg);
+	}
+
+	WStore.map = map;
+	WStore.size = (size_t) sb.st_size;
+	WStore.header = (const SW_WTH_STORE_HEADER *) map;
+	WStore.index = (const SW_WTH_STORE_YEAR *) (WStore.header + 1);
+
+	return swTRUE;
+}
+
+
+/**
+@brief Close the weather store of the active simulation run (if open)
+*/
+void SW_WTH_close_store(void) {
+	if (!isnull(WStore.map)) {
+		munmap(WStore.map, WStore.size);
+	}
+
+	WStore.map = NULL;
+	WStore.size = 0;
+	WStore.header = NULL;
+	WStore.index = NULL;
+}
+
+
+/**
+@brief Does the active simulation run use a weather store?
+*/
+Bool SW_WTH_store_is_open(void) {
+	return (Bool) !isnull(WStore.map);
+}
+
+
+/**
+@brief Copy the historical weather of a simulation year from the open weather store
+
+Values are identical to those read by `_read_weather_hist()` from the
+text file of the same year.
+
+@param year Calendar year.
+
+@return `swTRUE`/`swFALSE` if the store has/has no data for `year`.
+*/
+Bool SW_WTH_read_store(TimeInt year) {
+	SW_WEATHER_HIST *wh = &SW_Weather.hist;
+	const float *tmax, *tmin, *ppt;
+	TimeInt d;
+
+	if (isnull(tmax = find_year(year))) {
+		_clear_hist_weather();
+		return swFALSE;
+	}
+
+	tmin = tmax + MAX_DAYS;
+	ppt = tmin + MAX_DAYS;
+
+	for (d = 0; d < MAX_DAYS; d++) {
+		wh->temp_max[d] = tmax[d];
+		wh->temp_min[d] = tmin[d];
+		wh->temp_avg[d] = (tmax[d] + tmin[d]) / 2.0;
+		wh->ppt[d] = ppt[d];
+	}
+
+	return swTRUE;
+}
+
+
+/**
+@brief Convert the text weather files of the active simulation run into a
+  weather store
+
+Reads `[weather-file prefix].[year]` for each year from `startyr` to `endyr`
+that has a weather file; requires that `SW_WTH_read()` was called.
+A weather store that is open by the run is closed first.
+
+@param fname Name of the weather store file to create.
+@param startyr First calendar year.
+@param endyr Last calendar year.
+
+@return Number of years written to the store.
+*/
+int SW_WTH_write_store(const char *fname, TimeInt startyr, TimeInt endyr) {
+	SW_WEATHER_HIST *wh = &SW_Weather.hist;
+	SW_WTH_STORE_HEADER header;
+	SW_WTH_STORE_YEAR *index;
+	float *data, *block;
+	TimeInt year, d;
+	uint32_t n = 0, n_max = (endyr >= startyr) ? endyr - startyr + 1 : 0;
+	size_t len_block = 3 * MAX_DAYS;
+	FILE *f;
+
+	SW_WTH_close_store();
+
+	index = (SW_WTH_STORE_YEAR *) Mem_Calloc(max(n_max, 1),
+		sizeof(SW_WTH_STORE_YEAR), "SW_WTH_write_store()");
+	data = (float *) Mem_Calloc(max(n_max, 1) * len_block,
+		sizeof(float), "SW_WTH_write_store()");
+
+	for (year = startyr; year <= endyr; year++) {
+		if (_read_weather_hist(year)) {
+			block = data + n * len_block;
+
+			for (d = 0; d < MAX_DAYS; d++) {
+				block[d] = (float) wh->temp_max[d];
+				block[d + MAX_DAYS] = (float) wh->temp_min[d];
+				block[d + 2 * MAX_DAYS] = (float) wh->ppt[d];
+			}
+
+			index[n].year = (int32_t) year;
+			n++;
+		}
+	}
+
+	memset(&header, 0, sizeof header);
+	memcpy(header.magic, SW_WTH_STORE_MAGIC, sizeof header.magic);
+	header.version = SW_WTH_STORE_VERSION;
+	header.byteorder = SW_WTH_STORE_BYTEORDER;
+	header.n_years = n;
+	header.n_days = MAX_DAYS;
+
+	for (d = 0; d < n; d++) {
+		index[d].offset = sizeof header + n * sizeof(SW_WTH_STORE_YEAR) +
+			d * len_block * sizeof(float);
+	}
+
+	f = OpenFile(fname, "wb");
+
+	if (1 != fwrite(&header, sizeof header, 1, f) ||
+		n != fwrite(index, sizeof(SW_WTH_STORE_YEAR), n, f) ||
+		n * len_block != fwrite(data, sizeof(float), n * len_block, f)) {
+		CloseFile(&f);
+		Mem_Free(index);
+		Mem_Free(data);
+		LogError(logfp, LOGFATAL, "%s : Cannot write weather store.", fname);
+	}
+
+	CloseFile(&f);
+	Mem_Free(index);
+	Mem_Free(data);
+
+	return (int) n;
+}
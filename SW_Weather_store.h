@@ -0,0 +1,87 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: SW_Weather_store.h
+ *  Type: header
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Support definitions/declarations for the binary weather store
+ *           of `SW_Weather_store.c`.
+ *
+ *           A weather store holds the daily historical weather of all
+ *           years of a site in one binary file `[weather-file prefix].bin`:
+ *             - a header `SW_WTH_STORE_HEADER`,
+ *             - an index of `n_years` entries `SW_WTH_STORE_YEAR`,
+ *               sorted by year, and
+ *             - for each year, the data block of columnar float arrays
+ *               `temp_max[n_days]`, `temp_min[n_days]`, `ppt[n_days]`
+ *               with `SW_MISSING` for days without values.
+ *
+ *           Values are stored in the byte order of the machine that
+ *           created the store.
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+#ifndef SW_WEATHER_STORE_H
+#define SW_WEATHER_STORE_H
+
+#include <stdint.h>
+#include "generic.h"
+#include "SW_Times.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/* =================================================== */
+/*                Global Types / Defines               */
+/* --------------------------------------------------- */
+
+#define SW_WTH_STORE_MAGIC "SW2WEATH" /**< first 8 bytes of a weather store */
+#define SW_WTH_STORE_VERSION 1 /**< version of the weather store format */
+#define SW_WTH_STORE_BYTEORDER 0x01020304 /**< detects a foreign byte order */
+#define SW_WTH_STORE_EXT ".bin" /**< file extension of a weather store */
+
+/** Header of a weather store file */
+typedef struct {
+	char magic[8];
+	uint32_t version, byteorder,
+		n_years, /**< number of years in the store */
+		n_days; /**< number of days per year block (`MAX_DAYS`) */
+} SW_WTH_STORE_HEADER;
+
+/** Index entry of one year of a weather store */
+typedef struct {
+	int32_t year;
+	uint32_t reserved;
+	uint64_t offset; /**< position of the year's data block (bytes from file start) */
+} SW_WTH_STORE_YEAR;
+
+/** An open (memory-mapped) weather store */
+typedef struct {
+	void *map; /**< read-only mapping of the store file; `NULL` if not open */
+	size_t size; /**< size of the store file in bytes */
+	const SW_WTH_STORE_HEADER *header;
+	const SW_WTH_STORE_YEAR *index;
+} SW_WTH_STORE;
+
+
+/* =================================================== */
+/*             Global Function Declarations            */
+/* --------------------------------------------------- */
+void SW_WTH_store_name(char *fname, const char *name_prefix);
+Bool SW_WTH_open_store(const char *fname);
+void SW_WTH_close_store(void);
+Bool SW_WTH_store_is_open(void);
+Bool SW_WTH_read_store(TimeInt year);
+int SW_WTH_write_store(const char *fname, TimeInt startyr, TimeInt endyr);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
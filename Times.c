@@ -16,6 +16,9 @@
  and added the facility for model time.
  03/12/2010	(drs) "365:366" -> Time_get_lastdoy_y(TimeInt year) {return isleapyear(year) ? 366 : 365; }
  09/26/2011	(drs)	added function interpolate_monthlyValues(): interpolating a record with monthly values and outputs a record with daily values
+ 2026-10-15	Time_new_year() selects a calendar table of the year (leap/noleap) so that
+ doy2month() and doy2mday() are single lookups (doy2week() uses a constant table);
+ added the first and last day of each month and week
  */
 /********************************************************/
 /********************************************************/
@@ -41,9 +44,86 @@ static TimeInt
     a call to Time_new_year() */
   monthdays[12] = { 31, NoDay, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
 
-static TimeInt
-  days_in_month[MAX_MONTHS], /* number of days per month for "current" year */
-  cum_monthdays[MAX_MONTHS]; /* monthly cumulative number of days for "current" year */
+#define W7(w) w, w, w, w, w, w, w
+
+/* week (base0) by day of year (base1); the same for every year;
+  doy 0 does not exist, its value is that of the previous arithmetic */
+static const TimeInt doy_week[MAX_DAYS + 1] = {
+  (0u - 1u) / WKDAYS,
+  W7(0), W7(1), W7(2), W7(3), W7(4), W7(5), W7(6), W7(7), W7(8), W7(9),
+  W7(10), W7(11), W7(12), W7(13), W7(14), W7(15), W7(16), W7(17), W7(18), W7(19),
+  W7(20), W7(21), W7(22), W7(23), W7(24), W7(25), W7(26), W7(27), W7(28), W7(29),
+  W7(30), W7(31), W7(32), W7(33), W7(34), W7(35), W7(36), W7(37), W7(38), W7(39),
+  W7(40), W7(41), W7(42), W7(43), W7(44), W7(45), W7(46), W7(47), W7(48), W7(49),
+  W7(50), W7(51), 52, 52
+};
+
+#undef W7
+
+/** Calendar of a year: month and day of month of each day of the year
+    (base1) and the first and last day of the year of each month and week */
+typedef struct {
+	TimeInt
+	  month[MAX_DAYS + 1], /* month (base0) by day of year */
+	  mday[MAX_DAYS + 1], /* day of month (base1) by day of year */
+	  month_firstdoy[MAX_MONTHS], month_lastdoy[MAX_MONTHS],
+	  week_firstdoy[MAX_WEEKS], week_lastdoy[MAX_WEEKS];
+} TimeCalendar;
+
+/* all zero: catches use cases without a prior call to Time_new_year() */
+static TimeCalendar no_calendar;
+
+/* one "current" year per thread */
+static SW_THREAD_LOCAL TimeInt
+  days_in_month[MAX_MONTHS]; /* number of days per month for "current" year */
+
+/* calendars of a noleap [0] and a leap year [1], built on first use */
+static SW_THREAD_LOCAL TimeCalendar calendars[2];
+static SW_THREAD_LOCAL Bool has_calendar[2];
+
+/* calendar of the "current" year */
+static SW_THREAD_LOCAL const TimeCalendar *calendar = &no_calendar;
+
+
+/* =================================================== */
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+/** Build the calendar of a year with `ndays_Feb` days in February */
+static void build_calendar(TimeCalendar *cal, TimeInt ndays_Feb) {
+	TimeInt mdays[MAX_MONTHS], doy, m, w, first;
+
+	memcpy(mdays, monthdays, sizeof mdays);
+	mdays[Feb] = ndays_Feb;
+
+	/* doy 0 does not exist; values are those of the previous arithmetic */
+	cal->month[0] = Jan;
+	cal->mday[0] = 0;
+
+	doy = 1;
+	for (m = Jan; m < NoMonth; m++) {
+		cal->month_firstdoy[m] = doy;
+		cal->month_lastdoy[m] = doy + mdays[m] - 1;
+
+		for (first = doy; doy <= cal->month_lastdoy[m]; doy++) {
+			cal->month[doy] = m;
+			cal->mday[doy] = doy - first + 1;
+		}
+	}
+
+	/* day 366 of a noleap year continues December */
+	for (; doy <= MAX_DAYS; doy++) {
+		cal->month[doy] = Dec;
+		cal->mday[doy] = doy - cal->month_firstdoy[Dec] + 1;
+	}
+
+	/* the last week is shorter; the 53rd week has 1 (or 2) days */
+	for (w = 0; w < MAX_WEEKS; w++) {
+		cal->week_firstdoy[w] = w * WKDAYS + 1;
+		cal->week_lastdoy[w] = min((w + 1) * WKDAYS, cal->month_lastdoy[Dec]);
+	}
+}
 
 
 /* =================================================== */
@@ -58,29 +138,32 @@ void Time_init_model(void) {
   // called by `SW_MDL_construct()`
 
 	memcpy(days_in_month, monthdays, sizeof(TimeInt) * MAX_MONTHS);
+	calendar = &no_calendar;
 }
 
 /**
   @brief Prepares information for a new year -- considering leap/noleap years.
 
   This function must be called prior to using Time_days_in_month(),
-  doy2month(), doy2mday(), or interpolate_monthlyValues().
+  doy2month(), doy2mday(), the first and last days of months and weeks,
+  or interpolate_monthlyValues().
 
   @param year A (Gregorian) calendar year; not abbreviated.
 */
 void Time_new_year(TimeInt year) {
   // called by `SW_MDL_new_year()`
 
-	/* set the year's month-days arrays depending on leap/noleap year */
-	TimeInt m;
+	/* set the year's month-days array and calendar depending on leap/noleap year */
+	int leap = isleapyear(year) ? 1 : 0;
 
-	days_in_month[Feb] = isleapyear(year) ? 29 : 28;
+	days_in_month[Feb] = leap ? 29 : 28;
 
-	cum_monthdays[Jan] = days_in_month[Jan];
-	for (m = Feb; m < NoMonth; m++)
-	{
-		cum_monthdays[m] = days_in_month[m] + cum_monthdays[m - 1];
+	if (!has_calendar[leap]) {
+		build_calendar(&calendars[leap], days_in_month[Feb]);
+		has_calendar[leap] = swTRUE;
 	}
+
+	calendar = &calendars[leap];
 }
 
 
@@ -109,38 +192,77 @@ TimeInt Time_get_lastdoy_y(TimeInt year) {
 
 
 /**
-  @brief Determine month of the year
+  @brief Determine first day of a month, see Time_new_year()
+
+  @param month Number of month (base0) [Jan-Dec = 0-11]
+  @return Day of the year (base1) [1-336].
+*/
+TimeInt Time_first_doy_month(TimeInt month) {
+	return calendar->month_firstdoy[month];
+}
+
+/**
+  @brief Determine last day of a month, see Time_new_year()
+
+  @param month Number of month (base0) [Jan-Dec = 0-11]
+  @return Day of the year (base1) [31-366].
+*/
+TimeInt Time_last_doy_month(TimeInt month) {
+	return calendar->month_lastdoy[month];
+}
+
+/**
+  @brief Determine first day of a 7-day period ("week"), see Time_new_year()
+
+  @param week Week number (base0) [0-52].
+  @return Day of the year (base1) [1-365].
+*/
+TimeInt Time_first_doy_week(TimeInt week) {
+	return calendar->week_firstdoy[week];
+}
+
+/**
+  @brief Determine last day of a 7-day period ("week"), see Time_new_year()
+
+  The last week of a year is incomplete and ends on the last day of the year.
+
+  @param week Week number (base0) [0-52].
+  @return Day of the year (base1) [7-366].
+*/
+TimeInt Time_last_doy_week(TimeInt week) {
+	return calendar->week_lastdoy[week];
+}
+
+
+/**
+  @brief Determine month of the year, see Time_new_year()
 
   @param doy Day of the year (base1) [1-366].
   @return Month (base0) [Jan-Dec = 0-11].
 
 */
 TimeInt doy2month(const TimeInt doy) {
-	TimeInt mon;
-
-	for (mon = Jan; mon < Dec && doy > cum_monthdays[mon]; mon++)
-		;
-	return mon;
+	return calendar->month[doy];
 }
 
 /**
-  @brief Determine day of the month
+  @brief Determine day of the month, see Time_new_year()
 
   @param doy Day of the year (base1) [1-366].
   @return Day of the month [1-31].
 */
 TimeInt doy2mday(const TimeInt doy) {
-  return (doy <= days_in_month[Jan]) ? doy : doy - cum_monthdays[doy2month(doy) - 1];
+	return calendar->mday[doy];
 }
 
 /**
   @brief Determine 7-day period ("week") of the year
 
   @param doy Day of the year (base1) [1-366].
-  @return Week number (base0) [0-51].
+  @return Week number (base0) [0-52].
 */
 TimeInt doy2week(TimeInt doy) {
-	return ((TimeInt) (((doy) - 1) / WKDAYS));
+	return doy_week[doy];
 }
 
 /**
@@ -33,6 +33,7 @@
  *    19-Sep-03 (cwb) Imported a bunch of new routines
  *       and added the facility for model time.
  *	  09/26/2011	(drs)	added function interpolate_monthlyValues()
+ *    2026-10-15 added the first and last day of the year of each month and week
  */
 /********************************************************/
 /********************************************************/
@@ -88,6 +89,10 @@ void Time_new_year(TimeInt year);
 
 TimeInt Time_days_in_month(TimeInt month);
 TimeInt Time_get_lastdoy_y(TimeInt year);
+TimeInt Time_first_doy_month(TimeInt month);
+TimeInt Time_last_doy_month(TimeInt month);
+TimeInt Time_first_doy_week(TimeInt week);
+TimeInt Time_last_doy_week(TimeInt week);
 
 TimeInt doy2month(const TimeInt doy);
 TimeInt doy2mday(const TimeInt doy);
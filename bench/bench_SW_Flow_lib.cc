@@ -0,0 +1,476 @@
+#include "benchmark/benchmark.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Files.h"
+#include "../SW_Site.h"
+#include "../SW_VegProd.h"
+#include "../SW_SoilWater.h"
+#include "../SW_Control.h"
+#include "../SW_Flow_lib.h"
+#include "../SW_Flow_lanes.h"
+#include "../SW_Run.h"
+
+
+/* Microbenchmarks of the per-layer kernels of `SW_Flow_lib.c` and of the
+   soil water retention curve of `SW_SoilWater.c` (see `make bench_micro`).
+
+   Kernels are exercised with the same soil layers as the unit tests
+   (see `create_test_soillayers()`) and are parameterized by the number of
+   soil layers. Kernels that modify soil water are reset to the initial
+   state at each iteration (included in the timing).
+*/
+
+
+// Global variables which are defined in SW_Main_lib.c (part of the library)
+extern char _firstfile[];
+extern Bool QuietMode, EchoInits;
+
+// Helpers shared with the unit tests, see `test/sw_testhelpers.cc`
+void Reset_SOILWAT2_after_UnitTest(void);
+void create_test_soillayers(unsigned int nlayers);
+
+
+namespace {
+  // Per-layer inputs derived from the soil layers of the active run
+  typedef struct {
+    unsigned int n;
+    double swc[MAX_LAYERS], swcfc[MAX_LAYERS], swcsat[MAX_LAYERS],
+      swcmin[MAX_LAYERS], swcwp[MAX_LAYERS], width[MAX_LAYERS],
+      imperm[MAX_LAYERS], coeff[MAX_LAYERS];
+  } BenchLayers;
+
+  // Setup `n` soil layers and collect their inputs
+  static void setup_layers(BenchLayers *b, unsigned int n) {
+    unsigned int i;
+
+    create_test_soillayers(n);
+    b->n = n;
+
+    ForEachSoilLayer(i) {
+      b->swcfc[i] = SW_Site.swcBulk_fieldcap[i];
+      b->swcsat[i] = SW_Site.swcBulk_saturated[i];
+      b->swcmin[i] = SW_Site.swcBulk_min[i];
+      b->swcwp[i] = SW_Site.swcBulk_wiltpt[i];
+      b->width[i] = SW_Site.width[i];
+      b->imperm[i] = SW_Site.impermeability[i];
+      b->coeff[i] = SW_Site.transp_coeff[SW_SHRUB][i];
+      b->swc[i] = (b->swcfc[i] + b->swcwp[i]) / 2.;
+      stValues.lyrFrozen[i] = swFALSE;
+    }
+  }
+
+  static void finish(benchmark::State& state, unsigned int n) {
+    state.SetItemsProcessed((int64_t) state.iterations() * n);
+    state.counters["layers"] = n;
+  }
+
+
+  static void BM_infiltrate_water_high(benchmark::State& state) {
+    BenchLayers b;
+    double swc[MAX_LAYERS], drain[MAX_LAYERS], drainout, standingWater;
+
+    setup_layers(&b, (unsigned int) state.range(0));
+
+    for (auto _ : state) {
+      memcpy(swc, b.swc, sizeof swc);
+      standingWater = 0.;
+      infiltrate_water_high(swc, drain, &drainout, 2., (int) b.n, b.swcfc,
+        b.swcsat, b.imperm, &standingWater);
+      benchmark::DoNotOptimize(drainout);
+    }
+
+    finish(state, b.n);
+  }
+  BENCHMARK(BM_infiltrate_water_high)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_infiltrate_water_low(benchmark::State& state) {
+    BenchLayers b;
+    double swc[MAX_LAYERS], drain[MAX_LAYERS], drainout, standingWater;
+
+    setup_layers(&b, (unsigned int) state.range(0));
+
+    for (auto _ : state) {
+      memcpy(swc, b.swcfc, sizeof swc);
+      memset(drain, 0, sizeof drain);
+      drainout = standingWater = 0.;
+      infiltrate_water_low(swc, drain, &drainout, b.n, SW_Site.slow_drain_coeff,
+        SLOW_DRAIN_DEPTH, b.swcfc, b.width, b.swcmin, b.swcsat, b.imperm,
+        &standingWater);
+      benchmark::DoNotOptimize(drainout);
+    }
+
+    finish(state, b.n);
+  }
+  BENCHMARK(BM_infiltrate_water_low)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_transp_weighted_avg(benchmark::State& state) {
+    BenchLayers b;
+    unsigned int i, tr_regions[MAX_LAYERS];
+    double swp_avg;
+
+    setup_layers(&b, (unsigned int) state.range(0));
+    ForEachSoilLayer(i) {
+      tr_regions[i] = SW_Site.my_transp_rgn[SW_SHRUB][i];
+    }
+
+    for (auto _ : state) {
+      transp_weighted_avg(&swp_avg, SW_Site.n_transp_rgn,
+        SW_Site.n_transp_lyrs[SW_SHRUB], tr_regions, b.coeff, b.swc);
+      benchmark::DoNotOptimize(swp_avg);
+    }
+
+    finish(state, b.n);
+  }
+  BENCHMARK(BM_transp_weighted_avg)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_remove_from_soil(benchmark::State& state) {
+    BenchLayers b;
+    double swc[MAX_LAYERS], qty[MAX_LAYERS], aet;
+
+    setup_layers(&b, (unsigned int) state.range(0));
+
+    for (auto _ : state) {
+      memcpy(swc, b.swc, sizeof swc);
+      aet = 0.;
+      remove_from_soil(swc, qty, &aet, b.n, b.coeff, 0.5, b.swcmin);
+      benchmark::DoNotOptimize(aet);
+    }
+
+    finish(state, b.n);
+  }
+  BENCHMARK(BM_remove_from_soil)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_hydraulic_redistribution(benchmark::State& state) {
+    BenchLayers b;
+    double swc[MAX_LAYERS], hydred[MAX_LAYERS];
+
+    setup_layers(&b, (unsigned int) state.range(0));
+
+    for (auto _ : state) {
+      memcpy(swc, b.swc, sizeof swc);
+      hydraulic_redistribution(swc, b.swcwp, b.coeff, hydred, b.n,
+        SW_VegProd.veg[SW_SHRUB].maxCondroot,
+        SW_VegProd.veg[SW_SHRUB].swpMatric50,
+        SW_VegProd.veg[SW_SHRUB].shapeCond, 1.);
+      benchmark::DoNotOptimize(hydred[b.n - 1]);
+    }
+
+    finish(state, b.n);
+  }
+  BENCHMARK(BM_hydraulic_redistribution)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_SWCbulk2SWPmatric(benchmark::State& state) {
+    BenchLayers b;
+    unsigned int i;
+    double swp;
+
+    setup_layers(&b, (unsigned int) state.range(0));
+
+    for (auto _ : state) {
+      for (i = 0; i < b.n; i++) {
+        swp = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[i],
+          b.swc[i], i);
+        benchmark::DoNotOptimize(swp);
+      }
+    }
+
+    finish(state, b.n);
+  }
+  BENCHMARK(BM_SWCbulk2SWPmatric)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_SWCbulk2SWPmatric_profile(benchmark::State& state) {
+    BenchLayers b;
+    double swp[MAX_LAYERS];
+
+    setup_layers(&b, (unsigned int) state.range(0));
+
+    for (auto _ : state) {
+      SW_SWCbulk2SWPmatric_profile(b.swc, swp, b.n);
+      benchmark::DoNotOptimize(swp[b.n - 1]);
+    }
+
+    finish(state, b.n);
+  }
+  BENCHMARK(BM_SWCbulk2SWPmatric_profile)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_SWPmatric2VWCBulk(benchmark::State& state) {
+    BenchLayers b;
+    unsigned int i;
+    double vwc;
+
+    setup_layers(&b, (unsigned int) state.range(0));
+
+    for (auto _ : state) {
+      for (i = 0; i < b.n; i++) {
+        vwc = SW_SWPmatric2VWCBulk(SW_Site.fractionVolBulk_gravel[i],
+          15., i);
+        benchmark::DoNotOptimize(vwc);
+      }
+    }
+
+    finish(state, b.n);
+  }
+  BENCHMARK(BM_SWPmatric2VWCBulk)->Arg(1)->Arg(10)->Arg(25);
+
+
+  // Inputs of the soil temperature profile with `nRgr` interior nodes
+  // that are `deltaX` cm apart
+  typedef struct {
+    int nRgr;
+    double deltaX;
+    double oldsTempR[MAX_ST_RGR + 1], wpR[MAX_ST_RGR + 1],
+      fcR[MAX_ST_RGR + 1], vwcR[MAX_ST_RGR + 1], bDensityR[MAX_ST_RGR + 1];
+  } BenchTempProfile;
+
+  static void setup_temp_profile(BenchTempProfile *b, int nRgr, double deltaX) {
+    int i;
+
+    b->nRgr = nRgr;
+    b->deltaX = deltaX;
+    for (i = 0; i <= nRgr + 1; i++) {
+      b->oldsTempR[i] = 4.15 + 5. * exp(-i / 5.);
+      b->fcR[i] = 2.1;
+      b->wpR[i] = 1.5;
+      b->vwcR[i] = 1.6;
+      b->bDensityR[i] = 1.5;
+    }
+  }
+
+
+  // Arguments are the number of nodes and the node distance (cm); the
+  // explicit solver is stable with one daily time step at 15 cm but
+  // requires sub-daily time steps at 5 cm
+  static void BM_soil_temperature_today(benchmark::State& state) {
+    BenchTempProfile b;
+    double sTempR[MAX_ST_RGR + 1], dTime;
+    Bool stError;
+
+    setup_temp_profile(&b, (int) state.range(0), (double) state.range(1));
+
+    for (auto _ : state) {
+      dTime = SEC_PER_DAY;
+      soil_temperature_today(&dTime, b.deltaX, 20., 4.15, b.nRgr,
+        sTempR, b.oldsTempR, b.vwcR, b.wpR, b.fcR, b.bDensityR,
+        0.0007, 0.0003, 0.18, &stError);
+      benchmark::DoNotOptimize(sTempR[1]);
+    }
+
+    state.SetItemsProcessed((int64_t) state.iterations() * b.nRgr);
+    state.counters["nodes"] = b.nRgr;
+    state.counters["steps"] = SEC_PER_DAY / dTime;
+  }
+  BENCHMARK(BM_soil_temperature_today)
+    ->Args({10, 15})->Args({65, 15})->Args({98, 5});
+
+
+  static void BM_soil_temperature_today_CN(benchmark::State& state) {
+    BenchTempProfile b;
+    double sTempR[MAX_ST_RGR + 1];
+    Bool stError;
+
+    setup_temp_profile(&b, (int) state.range(0), (double) state.range(1));
+
+    for (auto _ : state) {
+      soil_temperature_today_CN(b.deltaX, 20., 4.15, b.nRgr,
+        sTempR, b.oldsTempR, b.vwcR, b.wpR, b.fcR, b.bDensityR,
+        0.0007, 0.0003, 0.18, &stError);
+      benchmark::DoNotOptimize(sTempR[1]);
+    }
+
+    state.SetItemsProcessed((int64_t) state.iterations() * b.nRgr);
+    state.counters["nodes"] = b.nRgr;
+  }
+  BENCHMARK(BM_soil_temperature_today_CN)
+    ->Args({10, 15})->Args({65, 15})->Args({98, 5});
+
+
+
+  // Lane kernels (see `SW_Flow_lanes.c`) of `SW_LANES` sites versus
+  // `SW_LANES` calls of the scalar kernel; items are sites times layers
+  typedef struct {
+    double swc[MAX_LAYERS][SW_LANES], swcfc[MAX_LAYERS][SW_LANES],
+      swcsat[MAX_LAYERS][SW_LANES], swcmin[MAX_LAYERS][SW_LANES],
+      width[MAX_LAYERS][SW_LANES], imperm[MAX_LAYERS][SW_LANES];
+    Bool frozen[MAX_LAYERS][SW_LANES];
+  } BenchLanes;
+
+  static void setup_lanes(BenchLanes *bl, const BenchLayers *b) {
+    unsigned int i, l;
+
+    for (i = 0; i < b->n; i++) {
+      ForEachLane(l) {
+        bl->swc[i][l] = b->swc[i] * (1. + 0.1 * l);
+        bl->swcfc[i][l] = b->swcfc[i];
+        bl->swcsat[i][l] = b->swcsat[i];
+        bl->swcmin[i][l] = b->swcmin[i];
+        bl->width[i][l] = b->width[i];
+        bl->imperm[i][l] = b->imperm[i];
+        bl->frozen[i][l] = swFALSE;
+      }
+    }
+  }
+
+
+  static void BM_infiltrate_water_scalar_x_lanes(benchmark::State& state) {
+    BenchLayers b;
+    unsigned int i, l;
+    double swc[SW_LANES][MAX_LAYERS], drain[MAX_LAYERS], drainout,
+      standingWater;
+
+    setup_layers(&b, (unsigned int) state.range(0));
+
+    for (auto _ : state) {
+      ForEachLane(l) {
+        for (i = 0; i < b.n; i++) {
+          swc[l][i] = b.swc[i] * (1. + 0.1 * l);
+        }
+        standingWater = 0.;
+        drainout = 0.;
+        infiltrate_water_high(swc[l], drain, &drainout, 2., (int) b.n, b.swcfc,
+          b.swcsat, b.imperm, &standingWater);
+        infiltrate_water_low(swc[l], drain, &drainout, b.n,
+          SW_Site.slow_drain_coeff, SLOW_DRAIN_DEPTH, b.swcfc, b.width,
+          b.swcmin, b.swcsat, b.imperm, &standingWater);
+        benchmark::DoNotOptimize(drainout);
+      }
+    }
+
+    state.SetItemsProcessed((int64_t) state.iterations() * b.n * SW_LANES);
+    state.counters["layers"] = b.n;
+  }
+  BENCHMARK(BM_infiltrate_water_scalar_x_lanes)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_infiltrate_water_lanes(benchmark::State& state) {
+    BenchLayers b;
+    BenchLanes bl;
+    unsigned int l;
+    double swc[MAX_LAYERS][SW_LANES], drain[MAX_LAYERS][SW_LANES],
+      drainout[SW_LANES], standingWater[SW_LANES], pptleft[SW_LANES],
+      sdrainpar[SW_LANES];
+
+    setup_layers(&b, (unsigned int) state.range(0));
+    setup_lanes(&bl, &b);
+    ForEachLane(l) {
+      pptleft[l] = 2.;
+      sdrainpar[l] = SW_Site.slow_drain_coeff;
+    }
+
+    for (auto _ : state) {
+      memcpy(swc, bl.swc, b.n * sizeof swc[0]);
+      ForEachLane(l) {
+        standingWater[l] = 0.;
+      }
+      infiltrate_water_high_lanes(swc, drain, drainout, pptleft, b.n, bl.swcfc,
+        bl.swcsat, bl.imperm, bl.frozen, standingWater);
+      infiltrate_water_low_lanes(swc, drain, drainout, b.n, sdrainpar,
+        SLOW_DRAIN_DEPTH, bl.swcfc, bl.width, bl.swcmin, bl.swcsat, bl.imperm,
+        bl.frozen, standingWater, NULL, NULL);
+      benchmark::DoNotOptimize(drainout[0]);
+    }
+
+    state.SetItemsProcessed((int64_t) state.iterations() * b.n * SW_LANES);
+    state.counters["layers"] = b.n;
+  }
+  BENCHMARK(BM_infiltrate_water_lanes)->Arg(1)->Arg(10)->Arg(25);
+
+
+  static void BM_pot_transp_scalar_x_lanes(benchmark::State& state) {
+    unsigned int l;
+    double rate;
+    SW_VEGPROD *v = &SW_VegProd;
+
+    for (auto _ : state) {
+      ForEachLane(l) {
+        pot_transp(&rate, 1. + l, 100. + l, 300., 0.5, 0.3 + 0.1 * l,
+          SW_Site.transp.xinflec, SW_Site.transp.slope, SW_Site.transp.yinflec,
+          SW_Site.transp.range, v->veg[SW_SHRUB].shade_scale,
+          v->veg[SW_SHRUB].shade_deadmax,
+          v->veg[SW_SHRUB].tr_shade_effects.xinflec,
+          v->veg[SW_SHRUB].tr_shade_effects.slope,
+          v->veg[SW_SHRUB].tr_shade_effects.yinflec,
+          v->veg[SW_SHRUB].tr_shade_effects.range, 1.);
+        benchmark::DoNotOptimize(rate);
+      }
+    }
+
+    state.SetItemsProcessed((int64_t) state.iterations() * SW_LANES);
+  }
+  BENCHMARK(BM_pot_transp_scalar_x_lanes);
+
+
+  static void BM_pot_transp_lanes(benchmark::State& state) {
+    unsigned int l;
+    SW_TANFUNC_LANES transp, shade;
+    SW_VEGPROD *v = &SW_VegProd;
+    double rate[SW_LANES], swpavg[SW_LANES], biolive[SW_LANES],
+      biodead[SW_LANES], fbst[SW_LANES], petday[SW_LANES],
+      shade_scale[SW_LANES], shade_deadmax[SW_LANES], co2[SW_LANES];
+
+    ForEachLane(l) {
+      SW_LANES_set_tanfunc(&transp, l, &SW_Site.transp);
+      SW_LANES_set_tanfunc(&shade, l, &v->veg[SW_SHRUB].tr_shade_effects);
+      swpavg[l] = 1. + l;
+      biolive[l] = 100. + l;
+      biodead[l] = 300.;
+      fbst[l] = 0.5;
+      petday[l] = 0.3 + 0.1 * l;
+      shade_scale[l] = v->veg[SW_SHRUB].shade_scale;
+      shade_deadmax[l] = v->veg[SW_SHRUB].shade_deadmax;
+      co2[l] = 1.;
+    }
+
+    for (auto _ : state) {
+      pot_transp_lanes(rate, swpavg, biolive, biodead, fbst, petday, &transp,
+        shade_scale, shade_deadmax, &shade, co2);
+      benchmark::DoNotOptimize(rate[0]);
+    }
+
+    state.SetItemsProcessed((int64_t) state.iterations() * SW_LANES);
+  }
+  BENCHMARK(BM_pot_transp_lanes);
+
+} // namespace
+
+
+int main(int argc, char **argv) {
+  logged = swFALSE;
+  logfp = stdout;
+
+  // Emulate 'init_args()' as the unit tests do (see `test/sw_maintest.cc`)
+  if (!ChDir("./testing")) {
+    swprintf("Invalid project directory (./testing)");
+  }
+  strcpy(_firstfile, "files.in");
+  QuietMode = swTRUE;
+  EchoInits = swFALSE;
+
+  Reset_SOILWAT2_after_UnitTest();
+
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+
+  SW_CTL_clear_model(SW_CurrentRun, swTRUE);
+
+  return 0;
+}
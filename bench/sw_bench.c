@@ -0,0 +1,451 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: sw_bench.c
+ *  Type: main module of the benchmark binary `sw_bench` (see `make bench`)
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Measure the speed of SOILWAT2 simulations.
+ *
+ *           The benchmark simulates the reference site of `testing/` and
+ *           synthetic sites derived from it with 1, 10, and 25 soil layers
+ *           and 1, 10, 100, and 500 simulation years. It reports for each
+ *           site the time per simulated day spent in the simulation loop
+ *           and in the timed modules of `SW_Bench.h`, as a table and
+ *           (option -o) as a JSON file.
+ *
+ *           Synthetic soil layers are evenly spaced over the soil profile
+ *           of the reference site: soil properties are width-weighted
+ *           averages and evaporation and transpiration coefficients are
+ *           distributed by overlap with the reference layers.
+ *           Synthetic years re-use the daily weather of the reference years
+ *           (a leap year re-uses a leap year) and the CO2 concentration
+ *           of the last reference year.
+ *
+ *           With option -z, the sites are simulated without output
+ *           (`SW_OUTFORMAT_NONE`), i.e., the throughput of the simulation
+ *           itself is measured.
+ *
+ *  Usage: sw_bench [-d startdir] [-f files.in] [-o results.json] [-n min_days] [-z]
+ *
+ *  History:
+ *     (2026-10-14) -- INITIAL CODING
+ *     (2026-10-15) -- added option -z to simulate without output
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "../generic.h"
+#include "../filefuncs.h"
+#include "../myMemory.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Control.h"
+#include "../SW_Model.h"
+#include "../SW_Site.h"
+#include "../SW_Weather.h"
+#include "../SW_Output.h"
+#include "../SW_Output_outbin.h"
+#include "../SW_Bench.h"
+#include "../SW_Run.h"
+
+#ifndef SW_BENCH
+#error "sw_bench requires a libSOILWAT2 compiled with SW_BENCH (see `make bench`)"
+#endif
+
+#ifndef SW2_VERSION
+#define SW2_VERSION "unknown"
+#endif
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** A benchmarked site */
+typedef struct {
+	LyrIndex n_layers; /**< number of soil layers; 0, use the reference site */
+	TimeInt n_years; /**< number of simulation years; 0, use the reference site */
+} BENCH_SITE;
+
+/** Result of a benchmarked site */
+typedef struct {
+	LyrIndex n_layers;
+	TimeInt n_years;
+	unsigned int reps; /**< number of repeated simulations */
+	unsigned long days; /**< number of simulated days across repetitions */
+	double ns_total; /**< elapsed time of the simulation loops [ns] */
+	double ns[SW_BENCH_NTIMERS]; /**< elapsed time of the timed modules [ns] */
+} BENCH_RESULT;
+
+/** Inputs of the reference site that synthetic sites are derived from */
+typedef struct {
+	TimeInt first_year, n_years;
+	SW_WEATHER_HIST *hist; /**< daily weather of each reference year */
+	LyrIndex n_layers;
+	SW_LAYER_INFO lyr[MAX_LAYERS];
+	RealD rgn_depth[MAX_TRANSP_REGIONS]; /**< lower depth of each transpiration region */
+	unsigned int n_rgn;
+} BENCH_REFERENCE;
+
+
+/* =================================================== */
+/*                  Local Variables                    */
+/* --------------------------------------------------- */
+
+static const BENCH_SITE bench_sites[] = {
+	{0, 0},
+	{1, 1}, {1, 10}, {1, 100}, {1, 500},
+	{10, 1}, {10, 10}, {10, 100}, {10, 500},
+	{25, 1}, {25, 10}, {25, 100}, {25, 500}
+};
+
+static char firstfile[MAX_FILENAMESIZE];
+static Bool no_output = swFALSE; /* option -z */
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+static void print_usage(void) {
+	swprintf(
+		"Usage: sw_bench [-d startdir] [-f files.in] [-o results.json] [-n min_days] [-z]\n"
+		"  -d : operate (chdir) in startdir (default=.)\n"
+		"  -f : name of the main input file (default=files.in)\n"
+		"  -o : write results as JSON to file (default=none)\n"
+		"  -n : repeat the simulation of a site until at least min_days\n"
+		"       are simulated (default=3650)\n"
+		"  -z : simulate without output (default=csv output files)\n"
+	);
+}
+
+
+/** Elapsed time since `start` [ns] */
+static double elapsed_ns(const struct timespec *start) {
+	struct timespec now;
+
+	timespec_get(&now, TIME_UTC);
+
+	return 1e9 * (double) (now.tv_sec - start->tv_sec) +
+		(double) (now.tv_nsec - start->tv_nsec);
+}
+
+
+/** Close the logfile that `SW_F_read()` opened for the finished run */
+static void close_logfile(void) {
+	if (logfp != stdout && logfp != stderr) {
+		CloseFile(&logfp);
+	}
+	logfp = stderr;
+}
+
+
+/** Read the inputs of the reference site that synthetic sites re-use */
+static void read_reference(BENCH_REFERENCE *ref) {
+	SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "read_reference()");
+	char fname[MAX_FILENAMESIZE];
+	TimeInt i;
+	LyrIndex r;
+	RealD depth = 0.;
+
+	strcpy(fname, firstfile);
+	SW_CTL_setup_model(sw, fname);
+	SW_CTL_read_inputs_from_disk(sw);
+
+	ref->first_year = SW_Model.startyr;
+	ref->n_years = SW_Model.endyr - SW_Model.startyr + 1;
+	ref->hist = (SW_WEATHER_HIST *) Mem_Calloc(ref->n_years, sizeof(SW_WEATHER_HIST),
+		"read_reference()");
+
+	for (i = 0; i < ref->n_years; i++) {
+		_read_weather_hist(ref->first_year + i);
+		memcpy(&ref->hist[i], &SW_Weather.hist, sizeof(SW_WEATHER_HIST));
+	}
+
+	ref->n_layers = SW_Site.n_layers;
+	ref->n_rgn = 0;
+
+	ForEachSoilLayer(r) {
+		SW_SIT_get_layer(r, &ref->lyr[r]);
+		depth += SW_Site.width[r];
+
+		if (ref->n_rgn < SW_Site.n_transp_rgn && r == _TranspRgnBounds[ref->n_rgn]) {
+			ref->rgn_depth[ref->n_rgn++] = depth;
+		}
+	}
+
+	SW_CTL_clear_model(sw, swTRUE);
+	Mem_Free(sw);
+	SW_CTL_activate_run(NULL);
+	close_logfile();
+}
+
+
+/** Replace the soil layers of the active run by `n` evenly spaced layers */
+static void set_synthetic_soil(const BENCH_REFERENCE *ref, LyrIndex n) {
+	RealF dmax[MAX_LAYERS], matricd[MAX_LAYERS], f_gravel[MAX_LAYERS],
+		evco[MAX_LAYERS], trco[NVEGTYPES][MAX_LAYERS], psand[MAX_LAYERS],
+		pclay[MAX_LAYERS], imperm[MAX_LAYERS], soiltemp[MAX_LAYERS];
+	RealD rgn_depth[MAX_TRANSP_REGIONS], total = 0., top, bottom, ttop, tbottom,
+		overlap, w;
+	const SW_LAYER_INFO *t;
+	LyrIndex i, j;
+	unsigned int k;
+
+	for (j = 0; j < ref->n_layers; j++) {
+		total += ref->lyr[j].width;
+	}
+
+	for (i = 0; i < n; i++) {
+		top = total * i / n;
+		bottom = total * (i + 1) / n;
+		w = bottom - top;
+
+		dmax[i] = (RealF) bottom;
+		matricd[i] = f_gravel[i] = evco[i] = psand[i] = pclay[i] = 0.;
+		imperm[i] = soiltemp[i] = 0.;
+		ForEachVegType(k) {
+			trco[k][i] = 0.;
+		}
+
+		for (j = 0, ttop = 0.; j < ref->n_layers; j++, ttop = tbottom) {
+			t = &ref->lyr[j];
+			tbottom = ttop + t->width;
+			overlap = fmin(bottom, tbottom) - fmax(top, ttop);
+
+			if (overlap <= 0.) {
+				continue;
+			}
+
+			// soil properties: width-weighted average
+			matricd[i] += (RealF) (t->soilMatric_density * overlap / w);
+			f_gravel[i] += (RealF) (t->fractionVolBulk_gravel * overlap / w);
+			psand[i] += (RealF) (t->fractionWeightMatric_sand * overlap / w);
+			pclay[i] += (RealF) (t->fractionWeightMatric_clay * overlap / w);
+			imperm[i] += (RealF) (t->impermeability * overlap / w);
+			soiltemp[i] += (RealF) (t->sTemp * overlap / w);
+
+			// coefficients: distributed by overlap (sums are unchanged)
+			evco[i] += (RealF) (t->evap_coeff * overlap / t->width);
+			ForEachVegType(k) {
+				trco[k][i] += (RealF) (t->transp_coeff[k] * overlap / t->width);
+			}
+		}
+	}
+
+	memcpy(rgn_depth, ref->rgn_depth, sizeof rgn_depth);
+
+	set_soillayers(n, dmax, matricd, f_gravel, evco,
+		trco[SW_GRASS], trco[SW_SHRUB], trco[SW_TREES], trco[SW_FORBS],
+		psand, pclay, imperm, soiltemp, (int) ref->n_rgn, rgn_depth);
+}
+
+
+/** Replace the simulation years of the active run by `n` years
+
+  @return Daily weather of the years (to be freed by the caller).
+*/
+static SW_WEATHER_HIST *set_synthetic_years(const BENCH_REFERENCE *ref, TimeInt n) {
+	SW_WEATHER_HIST *hist;
+	TimeInt i, j, year, src, endyr = ref->first_year + n - 1;
+	RealD ppm = SW_Carbon.ppm[ref->first_year + ref->n_years - 1];
+
+	hist = (SW_WEATHER_HIST *) Mem_Calloc(n, sizeof(SW_WEATHER_HIST),
+		"set_synthetic_years()");
+
+	for (i = 0; i < n; i++) {
+		year = ref->first_year + i;
+
+		// cycle through the reference years; a leap year re-uses a leap year
+		src = i % ref->n_years;
+		for (j = 0; j < ref->n_years; j++) {
+			if (isleapyear(year) == isleapyear(ref->first_year + src)) {
+				break;
+			}
+			src = (src + 1) % ref->n_years;
+		}
+
+		memcpy(&hist[i], &ref->hist[src], sizeof(SW_WEATHER_HIST));
+	}
+
+	SW_MDL_set_time(ref->first_year, endyr, 1, 0, SW_Model.isnorth);
+	SW_WTH_set_memory(hist, ref->first_year, n);
+	SW_WTH_init_years();
+
+	for (year = ref->first_year + ref->n_years; year <= endyr; year++) {
+		SW_Carbon.ppm[year] = ppm;
+	}
+
+	return hist;
+}
+
+
+/** Simulate a site once and add elapsed times to `res` */
+static void simulate_site(const BENCH_REFERENCE *ref, const BENCH_SITE *site,
+	BENCH_RESULT *res) {
+
+	SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "simulate_site()");
+	SW_WEATHER_HIST *hist = NULL;
+	char fname[MAX_FILENAMESIZE];
+	struct timespec start;
+	unsigned int k;
+
+	strcpy(fname, firstfile);
+	SW_CTL_setup_model(sw, fname);
+	SW_CTL_read_inputs_from_disk(sw);
+
+	if (no_output) {
+		SW_OUT_set_format(SW_OUTFORMAT_NONE);
+	}
+
+	if (site->n_layers > 0) {
+		set_synthetic_soil(ref, site->n_layers);
+	}
+	if (site->n_years > 0) {
+		hist = set_synthetic_years(ref, site->n_years);
+	}
+
+	SW_CTL_init_run(sw);
+
+	SW_OUT_set_ncol();
+	SW_OUT_set_colnames();
+	SW_OUT_create_files();
+
+	res->n_layers = SW_Site.n_layers;
+	res->n_years = SW_Model.endyr - SW_Model.startyr + 1;
+
+	timespec_get(&start, TIME_UTC);
+	SW_CTL_main(sw);
+	res->ns_total += elapsed_ns(&start);
+
+	SW_OUT_close_files();
+
+	for (k = 0; k < SW_BENCH_NTIMERS; k++) {
+		res->ns[k] += sw->Bench.ns[k];
+	}
+	res->days += sw->Bench.calls[eBenchWaterFlow];
+	res->reps++;
+
+	SW_CTL_clear_model(sw, swTRUE);
+	Mem_Free(sw);
+	SW_CTL_activate_run(NULL);
+	close_logfile();
+
+	if (!isnull(hist)) {
+		Mem_Free(hist);
+	}
+}
+
+
+static void print_result(const BENCH_RESULT *res) {
+	unsigned int k;
+
+	swprintf("%6u %6u %4u %10.0f", res->n_layers, res->n_years, res->reps,
+		res->ns_total / res->days);
+	for (k = 0; k < SW_BENCH_NTIMERS; k++) {
+		swprintf(" %10.0f", res->ns[k] / res->days);
+	}
+	swprintf("\n");
+}
+
+
+static void write_json(FILE *f, const BENCH_RESULT *res, unsigned int n) {
+	unsigned int i, k;
+
+	fprintf(f, "{\n  \"version\": \"%s\",\n  \"unit\": \"ns/day\",\n"
+		"  \"output\": \"%s\",\n  \"sites\": [\n",
+		SW2_VERSION, no_output ? "none" : "csv");
+
+	for (i = 0; i < n; i++) {
+		fprintf(f,
+			"    {\"site\": \"%s\", \"n_layers\": %u, \"n_years\": %u, "
+			"\"reps\": %u, \"days\": %lu, \"total\": %.1f",
+			(0 == i) ? "reference" : "synthetic",
+			res[i].n_layers, res[i].n_years, res[i].reps, res[i].days,
+			res[i].ns_total / res[i].days);
+
+		for (k = 0; k < SW_BENCH_NTIMERS; k++) {
+			fprintf(f, ", \"%s\": %.1f", SW_BENCH_names[k], res[i].ns[k] / res[i].days);
+		}
+
+		fprintf(f, "}%s\n", (i + 1 < n) ? "," : "");
+	}
+
+	fprintf(f, "  ]\n}\n");
+}
+
+
+/************  Main() ************************/
+
+int main(int argc, char **argv) {
+	BENCH_REFERENCE ref;
+	BENCH_RESULT res[sizeof bench_sites / sizeof bench_sites[0]];
+	char const *startdir = NULL;
+	FILE *fjson = NULL;
+	unsigned long min_days = 3650;
+	unsigned int i, k, n = sizeof bench_sites / sizeof bench_sites[0];
+	int a;
+
+	logged = swFALSE;
+	logfp = stderr;
+	strcpy(firstfile, DFLT_FIRSTFILE);
+
+	for (a = 1; a < argc; a++) {
+		if (a + 1 < argc && 0 == strcmp(argv[a], "-d")) {
+			startdir = argv[++a];
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-f")) {
+			strcpy(firstfile, argv[++a]);
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-o")) {
+			// relative to the working directory before `-d` is applied
+			fjson = OpenFile(argv[++a], "w");
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-n")) {
+			min_days = strtoul(argv[++a], NULL, 10);
+		} else if (0 == strcmp(argv[a], "-z")) {
+			no_output = swTRUE;
+		} else {
+			print_usage();
+			sw_error(-1, "\nInvalid option %s\n", argv[a]);
+		}
+	}
+
+	if (!isnull(startdir) && !ChDir(startdir)) {
+		LogError(logfp, LOGFATAL, "Invalid project directory (%s)", startdir);
+	}
+
+	read_reference(&ref);
+
+	swprintf("SOILWAT2 benchmark (version %s): ns per simulated day%s\n",
+		SW2_VERSION, no_output ? " (without output)" : "");
+	swprintf("%6s %6s %4s %10s", "layers", "years", "reps", "total");
+	for (k = 0; k < SW_BENCH_NTIMERS; k++) {
+		swprintf(" %10.10s", SW_BENCH_names[k]);
+	}
+	swprintf("\n");
+
+	for (i = 0; i < n; i++) {
+		memset(&res[i], 0, sizeof res[i]);
+
+		do {
+			simulate_site(&ref, &bench_sites[i], &res[i]);
+		} while (res[i].days < min_days);
+
+		print_result(&res[i]);
+	}
+
+	if (!isnull(fjson)) {
+		write_json(fjson, res, n);
+		CloseFile(&fjson);
+	}
+
+	Mem_Free(ref.hist);
+
+	return 0;
+}
@@ -0,0 +1,839 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: sw_bench_batch.c
+ *  Type: main module of the benchmark binary `sw_bench_batch`
+ *        (see `make bench_batch`)
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Measure the scaling of the batch driver (see `SW_Batch.c`)
+ *           with reproducible workloads of synthetic sites.
+ *
+ *           The benchmark generates synthetic sites from a template
+ *           site (the inputs of `testing/`) in a work directory. Each
+ *           site varies its number of soil layers (1, 6, 12, 25), its
+ *           simulation years (10, 30, 60), soil temperature (off, on),
+ *           the weather generator (off, on), and its output (the time
+ *           steps of the template or yearly only). The sites take their
+ *           parameters in turn from a mix of `n_mix` combinations, which
+ *           are always the same for the same `n_mix`.
+ *
+ *           Synthetic soil layers are evenly spaced over the soil profile
+ *           of the template: soil properties are width-weighted averages,
+ *           evaporation and transpiration coefficients are distributed by
+ *           overlap with the template layers, and transpiration regions
+ *           keep their depths. Synthetic years re-use the daily weather of
+ *           the template years (a leap year re-uses a leap year) from a
+ *           weather directory that all sites share; the other inputs of
+ *           the template that are not varied are also shared. Manifests
+ *           of the sites are written to the work directory, e.g., to run
+ *           a workload with `SOILWAT2 -b`.
+ *
+ *           The batch driver then simulates the sites at 1, 2, 4, ...
+ *           up to `n_threads` worker threads:
+ *             - strong scaling: the same `n_strong` sites at each number
+ *               of threads,
+ *             - weak scaling: `n_mix` sites per thread.
+ *           For each run, the benchmark reports the makespan, speedup
+ *           and parallel efficiency against the run with one thread,
+ *           percentiles of the latency of the sites (setup and simulation
+ *           of a site), the memory of the simulation run context of the
+ *           sites (`SW_RUN` and its arena), and the peak resident memory
+ *           of the process; as a table and (option -o) as a JSON file.
+ *           The sites of the mix are simulated once before the runs
+ *           (warm-up of the file cache).
+ *
+ *  Usage: sw_bench_batch [-d template] [-w workdir] [-j n_threads]
+ *           [-m n_mix] [-s n_strong] [-i n_readers] [-o results.json] [-g]
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING
+ */
+/********************************************************/
+/********************************************************/
+
+/* =================================================== */
+/*                INCLUDES / DEFINES                   */
+/* --------------------------------------------------- */
+#define _POSIX_C_SOURCE 200809L /* for getrusage() with -std=c11 */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+#include "../generic.h"
+#include "../filefuncs.h"
+#include "../myMemory.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Batch.h"
+
+#ifndef SW2_VERSION
+#define SW2_VERSION "unknown"
+#endif
+
+#define BENCH_LINE 1024 /**< longest line of a template input file */
+#define BENCH_NFILES 32 /**< entries of `files.in` */
+#define BENCH_NCOLS 12 /**< columns of the table of `soils.in` */
+
+/** Entries of `files.in` (see `SW_F_read()`) that each site has its own
+    copy of or that are re-directed; other entries before `fOutputDir` are
+    shared, entries from `fOutputDir` on are kept (except `fOutSetup`) */
+enum {
+	fYears = 0, fLog = 1, fSite = 2, fSoils = 3, fWeatherSetup = 4,
+	fWeather = 5, fOutputDir = 13, fOutSetup = 14
+};
+
+
+/* =================================================== */
+/*                    Local Types                      */
+/* --------------------------------------------------- */
+
+/** Parameters of a synthetic site */
+typedef struct {
+	unsigned int n_layers; /**< number of soil layers */
+	unsigned int n_years; /**< number of simulation years */
+	Bool soil_temp; /**< TRUE if soil temperature is simulated */
+	Bool weather_generator; /**< TRUE if all weather is generated */
+	Bool yearly_output; /**< TRUE if output is yearly only; otherwise, the time steps of the template */
+} BENCH_SITE;
+
+/** Inputs of the template site that synthetic sites are derived from */
+typedef struct {
+	char dir[MAX_FILENAMESIZE]; /**< directory of the template, with a trailing `/` */
+	char files[BENCH_NFILES][MAX_FILENAMESIZE]; /**< entries of `files.in` */
+	unsigned int n_files;
+	TimeInt first_year, n_years; /**< of `years.in` */
+	unsigned int n_layers;
+	double lyr[MAX_LAYERS][BENCH_NCOLS]; /**< table of `soils.in` */
+	unsigned int n_rgn;
+	double rgn_depth[MAX_TRANSP_REGIONS]; /**< lower depth of each transpiration region */
+} BENCH_TEMPLATE;
+
+/** A line of a template input file that a site changes */
+typedef struct {
+	const char *match; /**< the first (non-comment) line that contains `match` */
+	char value[64]; /**< replaces the first field (or, if `whole`, all) of the line */
+	Bool whole;
+} BENCH_EDIT;
+
+/** Writes the rows of a table of a synthetic input file */
+typedef void (*BENCH_TABLE)(FILE *f, const BENCH_TEMPLATE *t, const BENCH_SITE *site);
+
+/** Result of one run of the batch driver */
+typedef struct {
+	unsigned int n_threads, n_sites, n_failed;
+	double makespan; /**< observed run time of the batch [s] */
+	double p50, p90, p99, max; /**< latency of the sites [s] */
+	double mean_bytes; /**< mean memory of the simulation run contexts [bytes] */
+	size_t max_bytes; /**< largest simulation run context [bytes] */
+	long max_rss; /**< peak resident memory of the process so far [kB] */
+} BENCH_RUN;
+
+
+/* =================================================== */
+/*                  Local Variables                    */
+/* --------------------------------------------------- */
+
+static const unsigned int
+	bench_layers[] = {1, 6, 12, 25},
+	bench_years[] = {10, 30, 60};
+
+/* number of combinations of the site parameters and a step through them
+   that is relatively prime to it, so that a small mix varies all parameters */
+#define BENCH_NCOMBOS (4 * 3 * 2 * 2 * 2)
+#define BENCH_STEP 29
+
+static const char *workdir = "bench_sites";
+static unsigned int n_readers = 0; /* option -i */
+
+
+/* =================================================== */
+/*             Private Function Definitions            */
+/* --------------------------------------------------- */
+
+static void print_usage(void) {
+	swprintf(
+		"Usage: sw_bench_batch [-d template] [-w workdir] [-j n_threads]\n"
+		"         [-m n_mix] [-s n_strong] [-i n_readers] [-o results.json] [-g]\n"
+		"  -d : directory of the template site with files.in (default=testing)\n"
+		"  -w : directory of the synthetic sites, relative to the working\n"
+		"       directory (default=bench_sites)\n"
+		"  -j : largest number of worker threads (default=number of CPUs)\n"
+		"  -m : number of distinct sites, i.e., sites per thread of weak\n"
+		"       scaling (default=8)\n"
+		"  -s : number of sites of strong scaling (default=4 * n_mix)\n"
+		"  -i : number of reader threads of the batch driver (default=0)\n"
+		"  -o : write results as JSON to file (default=none)\n"
+		"  -g : only generate the sites and their manifests\n"
+	);
+}
+
+
+/** Parameters of synthetic site `k` */
+static void site_params(unsigned int k, unsigned int n_mix, BENCH_SITE *site) {
+	unsigned int i = ((k % n_mix) * BENCH_STEP) % BENCH_NCOMBOS;
+
+	site->n_layers = bench_layers[i % 4];
+	site->n_years = bench_years[(i / 4) % 3];
+	site->soil_temp = (Bool) ((i / 12) % 2);
+	site->weather_generator = (Bool) ((i / 24) % 2);
+	site->yearly_output = (Bool) ((i / 48) % 2);
+}
+
+
+/** Directory of synthetic site `k` (with a trailing `/`) */
+static void site_dir(char *dir, unsigned int k) {
+	snprintf(dir, MAX_FILENAMESIZE, "%s/site_%03u/", workdir, k);
+}
+
+
+/** TRUE if `line` has no value, i.e., is empty or a comment */
+static Bool is_comment(const char *line) {
+	line += strspn(line, " \t\r\n");
+	return (Bool) ('\0' == *line || '#' == *line);
+}
+
+
+/** Copy a file */
+static void copy_file(const char *src, const char *dst) {
+	FILE *in = OpenFile(src, "rb"), *out = OpenFile(dst, "wb");
+	char buf[BUFSIZ];
+	size_t n;
+
+	while ((n = fread(buf, 1, sizeof buf, in)) > 0) {
+		if (n != fwrite(buf, 1, n, out)) {
+			LogError(logfp, LOGFATAL, "Cannot write %s", dst);
+		}
+	}
+
+	CloseFile(&in);
+	CloseFile(&out);
+}
+
+
+/** Write `line` with its first field replaced by `value` */
+static void write_field(FILE *f, const char *line, const char *value) {
+	const char *rest = line + strspn(line, " \t");
+
+	rest += strcspn(rest, " \t\r\n");
+	fprintf(f, "%s%s", value, rest);
+}
+
+
+/** Template file of entry `k` of `files.in` */
+static void template_file(char *name, const BENCH_TEMPLATE *t, unsigned int k) {
+	snprintf(name, MAX_PATHSIZE, "%s%s", t->dir, t->files[k]);
+}
+
+
+/** Read the inputs of the template site that synthetic sites are derived from */
+static void read_template(BENCH_TEMPLATE *t, const char *dir) {
+	FILE *f;
+	char name[MAX_PATHSIZE], line[BENCH_LINE];
+	unsigned int n = 0, i, layer;
+	Bool regions = swFALSE;
+	double *x;
+
+	memset(t, 0, sizeof *t);
+	snprintf(t->dir, sizeof t->dir, "%s%s", dir,
+		(dir[strlen(dir) - 1] == '/') ? "" : "/");
+
+	// entries of files.in
+	snprintf(name, sizeof name, "%s%s", t->dir, DFLT_FIRSTFILE);
+	f = OpenFile(name, "r");
+	while (t->n_files < BENCH_NFILES && !isnull(fgets(line, sizeof line, f))) {
+		if (!is_comment(line)) {
+			sscanf(line, "%511s", t->files[t->n_files++]);
+		}
+	}
+	CloseFile(&f);
+
+	if (t->n_files <= fOutSetup) {
+		LogError(logfp, LOGFATAL, "%s: too few entries", name);
+	}
+
+	// first and last year of years.in
+	template_file(name, t, fYears);
+	f = OpenFile(name, "r");
+	while (n < 2 && !isnull(fgets(line, sizeof line, f))) {
+		if (!is_comment(line)) {
+			i = (unsigned int) atoi(line);
+			if (0 == n++) {
+				t->first_year = i;
+			} else {
+				t->n_years = i - t->first_year + 1;
+			}
+		}
+	}
+	CloseFile(&f);
+
+	// table of soils.in
+	template_file(name, t, fSoils);
+	f = OpenFile(name, "r");
+	while (t->n_layers < MAX_LAYERS && !isnull(fgets(line, sizeof line, f))) {
+		x = t->lyr[t->n_layers];
+		if (!is_comment(line) && BENCH_NCOLS == sscanf(line,
+			"%lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf %lf",
+			&x[0], &x[1], &x[2], &x[3], &x[4], &x[5], &x[6], &x[7], &x[8],
+			&x[9], &x[10], &x[11])) {
+			t->n_layers++;
+		}
+	}
+	CloseFile(&f);
+
+	// depths of the transpiration regions of siteparam.in (the last table)
+	template_file(name, t, fSite);
+	f = OpenFile(name, "r");
+	while (!isnull(fgets(line, sizeof line, f))) {
+		if (!regions) {
+			regions = (Bool) !isnull(strstr(line, "Transpiration regions"));
+		} else if (!is_comment(line) && t->n_rgn < MAX_TRANSP_REGIONS &&
+			2 == sscanf(line, "%u %u", &i, &layer) && layer > 0) {
+			t->rgn_depth[t->n_rgn++] = t->lyr[min(layer, t->n_layers) - 1][0];
+		}
+	}
+	CloseFile(&f);
+
+	if (0 == t->n_years || 0 == t->n_layers || 0 == t->n_rgn) {
+		LogError(logfp, LOGFATAL, "Template %s: cannot read years, soil layers,"
+			" or transpiration regions", t->dir);
+	}
+}
+
+
+/** Write the table of `soils.in` of a site: `n_layers` evenly spaced layers */
+static void write_soils(FILE *f, const BENCH_TEMPLATE *t, const BENCH_SITE *site) {
+	double y[BENCH_NCOLS], total = t->lyr[t->n_layers - 1][0], top, bottom,
+		ttop, tbottom, overlap;
+	unsigned int n = site->n_layers, i, j, c;
+
+	for (i = 0; i < n; i++) {
+		top = total * i / n;
+		bottom = total * (i + 1) / n;
+
+		memset(y, 0, sizeof y);
+		y[0] = bottom;
+
+		for (j = 0, ttop = 0.; j < t->n_layers; j++, ttop = tbottom) {
+			tbottom = t->lyr[j][0];
+			overlap = fmin(bottom, tbottom) - fmax(top, ttop);
+
+			if (overlap <= 0.) {
+				continue;
+			}
+
+			for (c = 1; c < BENCH_NCOLS; c++) {
+				if (c >= 3 && c <= 7) {
+					// coefficients: distributed by overlap (sums are unchanged)
+					y[c] += t->lyr[j][c] * overlap / (tbottom - ttop);
+				} else {
+					// soil properties: width-weighted average
+					y[c] += t->lyr[j][c] * overlap / (bottom - top);
+				}
+			}
+		}
+
+		for (c = 0; c < BENCH_NCOLS; c++) {
+			fprintf(f, "%s%.6f", (0 == c) ? "" : "\t", y[c]);
+		}
+		fprintf(f, "\n");
+	}
+}
+
+
+/** Write the transpiration regions of `siteparam.in` of a site: the
+    deepest synthetic layer of each region of the template */
+static void write_regions(FILE *f, const BENCH_TEMPLATE *t, const BENCH_SITE *site) {
+	double total = t->lyr[t->n_layers - 1][0];
+	unsigned int r, k = 0, layer, last = 0;
+
+	for (r = 0; r < t->n_rgn; r++) {
+		layer = (unsigned int) (site->n_layers * t->rgn_depth[r] / total + 1e-6);
+		layer = min(max(layer, 1), site->n_layers);
+
+		if (layer > last) {
+			fprintf(f, "\t%u\t%u\n", ++k, layer);
+			last = layer;
+		}
+	}
+}
+
+
+/** Write the copy of a template input file of a site
+
+  @param t Template site.
+  @param site Parameters of the site.
+  @param dir Directory of the site.
+  @param k Entry of the input file in `files.in`.
+  @param edits Lines that are changed.
+  @param n_edits Number of `edits`.
+  @param marker Rows of a table follow the line that contains `marker`
+    (NULL: the first non-comment line); they are replaced by those of `table`.
+  @param table Writes the rows of the table; NULL if none.
+*/
+static void write_input(const BENCH_TEMPLATE *t, const BENCH_SITE *site,
+	const char *dir, unsigned int k, const BENCH_EDIT *edits,
+	unsigned int n_edits, const char *marker, BENCH_TABLE table) {
+
+	FILE *in, *out;
+	char src[MAX_PATHSIZE], dst[MAX_PATHSIZE], line[BENCH_LINE];
+	Bool done[4] = {swFALSE, swFALSE, swFALSE, swFALSE},
+		in_table = swFALSE, written = swFALSE, copy;
+	unsigned int e;
+
+	template_file(src, t, k);
+	snprintf(dst, sizeof dst, "%sInput/%s", dir, BaseName(t->files[k]));
+
+	in = OpenFile(src, "r");
+	out = OpenFile(dst, "w");
+
+	while (!isnull(fgets(line, sizeof line, in))) {
+		copy = swTRUE;
+
+		if (!isnull(table) && !in_table && !isnull(marker) &&
+			!isnull(strstr(line, marker))) {
+			in_table = swTRUE;
+
+		} else if (!is_comment(line)) {
+			if (!isnull(table) && isnull(marker)) {
+				in_table = swTRUE;
+			}
+
+			if (in_table) {
+				// rows of the table are replaced
+				if (!written) {
+					table(out, t, site);
+					written = swTRUE;
+				}
+				copy = swFALSE;
+
+			} else {
+				for (e = 0; e < n_edits && copy; e++) {
+					if (!done[e] && !isnull(strstr(line, edits[e].match))) {
+						if (edits[e].whole) {
+							fprintf(out, "%s\n", edits[e].value);
+						} else {
+							write_field(out, line, edits[e].value);
+						}
+						done[e] = swTRUE;
+						copy = swFALSE;
+					}
+				}
+			}
+		}
+
+		if (copy) {
+			fputs(line, out);
+		}
+	}
+
+	if (!isnull(table) && !written) {
+		table(out, t, site);
+	}
+
+	CloseFile(&in);
+	CloseFile(&out);
+
+	for (e = 0; e < n_edits; e++) {
+		if (!done[e]) {
+			LogError(logfp, LOGFATAL, "%s: no line with '%s'", src, edits[e].match);
+		}
+	}
+}
+
+
+/** Generate the directory of a synthetic site */
+static void write_site(const BENCH_TEMPLATE *t, const BENCH_SITE *site,
+	unsigned int isite) {
+
+	FILE *in, *out;
+	char dir[MAX_FILENAMESIZE], name[MAX_PATHSIZE], value[MAX_PATHSIZE],
+		line[BENCH_LINE];
+	BENCH_EDIT edit[2];
+	unsigned int k = 0;
+
+	site_dir(dir, isite);
+	snprintf(name, sizeof name, "%sInput", dir);
+	if (!DirExists(name) && !MkDir(name)) {
+		LogError(logfp, LOGFATAL, "Cannot create directory %s", name);
+	}
+
+	// files.in: the site's own inputs, shared inputs, and shared weather
+	snprintf(name, sizeof name, "%s%s", t->dir, DFLT_FIRSTFILE);
+	in = OpenFile(name, "r");
+	snprintf(name, sizeof name, "%s%s", dir, DFLT_FIRSTFILE);
+	out = OpenFile(name, "w");
+
+	while (!isnull(fgets(line, sizeof line, in))) {
+		if (is_comment(line)) {
+			fputs(line, out);
+			continue;
+		}
+
+		switch (k) {
+			case fYears: case fSite: case fSoils: case fWeatherSetup: case fOutSetup:
+				snprintf(value, sizeof value, "Input/%s", BaseName(t->files[k]));
+				break;
+			case fWeather:
+				snprintf(value, sizeof value, "../weather/%s", BaseName(t->files[k]));
+				break;
+			default:
+				if (k == fLog || k >= fOutputDir) {
+					strcpy(value, t->files[k]);
+				} else {
+					snprintf(value, sizeof value, "../Input/%s", BaseName(t->files[k]));
+				}
+		}
+
+		write_field(out, line, value);
+		k++;
+	}
+
+	CloseFile(&in);
+	CloseFile(&out);
+
+	// years.in: the first year of the template
+	edit[0].match = "Last (Gregorian) calendar year";
+	snprintf(edit[0].value, sizeof edit[0].value, "%u",
+		t->first_year + site->n_years - 1);
+	edit[0].whole = swFALSE;
+	write_input(t, site, dir, fYears, edit, 1, NULL, NULL);
+
+	write_input(t, site, dir, fSoils, NULL, 0, NULL, write_soils);
+
+	edit[0].match = "to calculate soil_temperature";
+	strcpy(edit[0].value, site->soil_temp ? "1" : "0");
+	edit[0].whole = swFALSE;
+	write_input(t, site, dir, fSite, edit, 1, "Transpiration regions", write_regions);
+
+	edit[0].match = "use historical data only";
+	strcpy(edit[0].value, site->weather_generator ? "2" : "0");
+	edit[0].whole = swFALSE;
+	write_input(t, site, dir, fWeatherSetup, edit, 1, NULL, NULL);
+
+	edit[0].match = "TIMESTEP";
+	strcpy(edit[0].value, "TIMESTEP yr");
+	edit[0].whole = swTRUE;
+	write_input(t, site, dir, fOutSetup, edit, site->yearly_output ? 1 : 0,
+		NULL, NULL);
+}
+
+
+/** Generate the shared inputs, the shared weather of `n_years` years, and
+    `n_sites` synthetic sites */
+static void write_sites(const BENCH_TEMPLATE *t, unsigned int n_sites,
+	unsigned int n_mix) {
+
+	BENCH_SITE site;
+	char src[MAX_PATHSIZE], dst[MAX_PATHSIZE];
+	TimeInt year, i, j, n_years = 0;
+	unsigned int k;
+
+	for (k = 0; k < n_mix; k++) {
+		site_params(k, n_mix, &site);
+		n_years = max(n_years, site.n_years);
+	}
+
+	snprintf(dst, sizeof dst, "%s/Input", workdir);
+	if (!DirExists(dst) && !MkDir(dst)) {
+		LogError(logfp, LOGFATAL, "Cannot create directory %s", dst);
+	}
+	for (k = fWeather + 1; k < fOutputDir; k++) {
+		template_file(src, t, k);
+		snprintf(dst, sizeof dst, "%s/Input/%s", workdir, BaseName(t->files[k]));
+		copy_file(src, dst);
+	}
+
+	// weather: cycle through the template years; a leap year re-uses a leap year
+	snprintf(dst, sizeof dst, "%s/weather", workdir);
+	if (!DirExists(dst) && !MkDir(dst)) {
+		LogError(logfp, LOGFATAL, "Cannot create directory %s", dst);
+	}
+	for (i = 0; i < n_years; i++) {
+		year = t->first_year + i;
+
+		k = i % t->n_years;
+		for (j = 0; j < t->n_years; j++) {
+			if (isleapyear(year) == isleapyear(t->first_year + k)) {
+				break;
+			}
+			k = (k + 1) % t->n_years;
+		}
+
+		snprintf(src, sizeof src, "%s%s.%u", t->dir, t->files[fWeather],
+			t->first_year + k);
+		snprintf(dst, sizeof dst, "%s/weather/%s.%u", workdir,
+			BaseName(t->files[fWeather]), year);
+		copy_file(src, dst);
+	}
+
+	for (k = 0; k < n_sites; k++) {
+		site_params(k, n_mix, &site);
+		write_site(t, &site, k);
+	}
+}
+
+
+/** Write a manifest of the first `n_sites` sites
+
+  @return Name of the manifest (in static memory).
+*/
+static const char *write_manifest(unsigned int n_sites) {
+	static char name[MAX_FILENAMESIZE];
+	char dir[MAX_FILENAMESIZE];
+	FILE *f;
+	unsigned int k;
+
+	snprintf(name, sizeof name, "%s/sites_%u.txt", workdir, n_sites);
+	f = OpenFile(name, "w");
+
+	fprintf(f, "# %u synthetic sites of sw_bench_batch\n", n_sites);
+	for (k = 0; k < n_sites; k++) {
+		site_dir(dir, k);
+		fprintf(f, "%s\n", dir);
+	}
+
+	CloseFile(&f);
+
+	return name;
+}
+
+
+static int compare_doubles(const void *a, const void *b) {
+	double x = *(const double *) a, y = *(const double *) b;
+
+	return (x > y) - (x < y);
+}
+
+
+/** Nearest-rank percentile `p` of `n` sorted values */
+static double percentile(const double *x, unsigned int n, double p) {
+	unsigned int r = (unsigned int) (p * n + 0.999999);
+
+	return x[max(r, 1) - 1];
+}
+
+
+/** Simulate the first `n_sites` sites with `n_threads` worker threads */
+static void run_batch(unsigned int n_sites, unsigned int n_threads, BENCH_RUN *res) {
+	SW_BATCH batch;
+	struct rusage usage;
+	double *latency, bytes = 0.;
+	unsigned int k;
+
+	SW_BAT_read_manifest(&batch, write_manifest(n_sites));
+	batch.n_readers = n_readers;
+
+	SW_BAT_run(&batch, n_threads);
+
+	memset(res, 0, sizeof *res);
+	res->n_threads = n_threads;
+	res->n_sites = batch.n_sites;
+	res->n_failed = batch.n_failed;
+	res->makespan = batch.cost.makespan;
+
+	latency = (double *) Mem_Calloc(batch.n_sites, sizeof(double), "run_batch()");
+	for (k = 0; k < batch.n_sites; k++) {
+		latency[k] = batch.sites[k].seconds;
+		bytes += (double) batch.sites[k].context_bytes;
+		res->max_bytes = max(res->max_bytes, batch.sites[k].context_bytes);
+
+		if (batch.sites[k].failed) {
+			LogError(logfp, LOGWARN, "Site %s failed: %s",
+				batch.sites[k].firstfile, batch.sites[k].msg);
+		}
+	}
+	qsort(latency, batch.n_sites, sizeof(double), compare_doubles);
+
+	res->p50 = percentile(latency, batch.n_sites, 0.50);
+	res->p90 = percentile(latency, batch.n_sites, 0.90);
+	res->p99 = percentile(latency, batch.n_sites, 0.99);
+	res->max = latency[batch.n_sites - 1];
+	res->mean_bytes = bytes / batch.n_sites;
+
+	if (0 == getrusage(RUSAGE_SELF, &usage)) {
+		res->max_rss = usage.ru_maxrss;
+	}
+
+	Mem_Free(latency);
+	SW_BAT_deconstruct(&batch);
+}
+
+
+/** Speedup and parallel efficiency of a run against the run with one thread
+
+  @param weak TRUE if the work grows with the threads (weak scaling).
+*/
+static void scaling(const BENCH_RUN *res, const BENCH_RUN *one, Bool weak,
+	double *speedup, double *efficiency) {
+
+	*speedup = one->makespan / res->makespan;
+	if (weak) {
+		*speedup *= (double) res->n_sites / one->n_sites;
+	}
+	*efficiency = *speedup / res->n_threads;
+}
+
+
+static void print_run(const char *mode, const BENCH_RUN *res, const BENCH_RUN *one) {
+	double speedup, efficiency;
+
+	scaling(res, one, (Bool) (0 == strcmp(mode, "weak")), &speedup, &efficiency);
+
+	swprintf("%6s %7u %5u %9.3f %7.2f %5.2f %8.3f %8.3f %8.3f %8.3f %9.0f %9ld\n",
+		mode, res->n_threads, res->n_sites, res->makespan, speedup, efficiency,
+		res->p50, res->p90, res->p99, res->max, res->mean_bytes / 1024., res->max_rss);
+}
+
+
+static void write_runs(FILE *f, const char *mode, const BENCH_RUN *res,
+	unsigned int n) {
+
+	double speedup, efficiency;
+	unsigned int i;
+
+	fprintf(f, "  \"%s\": [\n", mode);
+
+	for (i = 0; i < n; i++) {
+		scaling(&res[i], &res[0], (Bool) (0 == strcmp(mode, "weak")), &speedup,
+			&efficiency);
+
+		fprintf(f,
+			"    {\"threads\": %u, \"sites\": %u, \"failed\": %u, "
+			"\"makespan\": %.4f, \"speedup\": %.3f, \"efficiency\": %.3f, "
+			"\"latency\": {\"p50\": %.4f, \"p90\": %.4f, \"p99\": %.4f, \"max\": %.4f}, "
+			"\"context_bytes\": {\"mean\": %.0f, \"max\": %lu}, "
+			"\"max_rss_kb\": %ld}%s\n",
+			res[i].n_threads, res[i].n_sites, res[i].n_failed, res[i].makespan,
+			speedup, efficiency, res[i].p50, res[i].p90, res[i].p99, res[i].max,
+			res[i].mean_bytes, (unsigned long) res[i].max_bytes, res[i].max_rss,
+			(i + 1 < n) ? "," : "");
+	}
+
+	fprintf(f, "  ]");
+}
+
+
+static void write_json(FILE *f, const BENCH_TEMPLATE *t, unsigned int n_mix,
+	const BENCH_RUN *strong, const BENCH_RUN *weak, unsigned int n_runs) {
+
+	BENCH_SITE site;
+	unsigned int k;
+
+	fprintf(f, "{\n  \"version\": \"%s\",\n  \"template\": \"%s\",\n"
+		"  \"unit\": {\"makespan\": \"s\", \"latency\": \"s\"},\n"
+		"  \"readers\": %u,\n  \"mix\": [\n",
+		SW2_VERSION, t->dir, n_readers);
+
+	for (k = 0; k < n_mix; k++) {
+		site_params(k, n_mix, &site);
+		fprintf(f,
+			"    {\"n_layers\": %u, \"n_years\": %u, \"soil_temp\": %s, "
+			"\"weather_generator\": %s, \"output\": \"%s\"}%s\n",
+			site.n_layers, site.n_years, site.soil_temp ? "true" : "false",
+			site.weather_generator ? "true" : "false",
+			site.yearly_output ? "yearly" : "template", (k + 1 < n_mix) ? "," : "");
+	}
+
+	fprintf(f, "  ],\n");
+	write_runs(f, "strong", strong, n_runs);
+	fprintf(f, ",\n");
+	write_runs(f, "weak", weak, n_runs);
+	fprintf(f, "\n}\n");
+}
+
+
+/************  Main() ************************/
+
+int main(int argc, char **argv) {
+	BENCH_TEMPLATE t;
+	BENCH_RUN *strong, *weak, warmup;
+	const char *templ = "testing";
+	FILE *fjson = NULL;
+	unsigned int
+		n_threads = SW_BAT_default_nthreads(), n_mix = 8, n_strong = 0,
+		threads[32], n_runs = 0, p, i;
+	Bool generate_only = swFALSE;
+	int a;
+
+	logged = swFALSE;
+	logfp = stderr;
+
+	for (a = 1; a < argc; a++) {
+		if (a + 1 < argc && 0 == strcmp(argv[a], "-d")) {
+			templ = argv[++a];
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-w")) {
+			workdir = argv[++a];
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-j")) {
+			n_threads = (unsigned int) strtoul(argv[++a], NULL, 10);
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-m")) {
+			n_mix = (unsigned int) strtoul(argv[++a], NULL, 10);
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-s")) {
+			n_strong = (unsigned int) strtoul(argv[++a], NULL, 10);
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-i")) {
+			n_readers = (unsigned int) strtoul(argv[++a], NULL, 10);
+		} else if (a + 1 < argc && 0 == strcmp(argv[a], "-o")) {
+			fjson = OpenFile(argv[++a], "w");
+		} else if (0 == strcmp(argv[a], "-g")) {
+			generate_only = swTRUE;
+		} else {
+			print_usage();
+			sw_error(-1, "\nInvalid option %s\n", argv[a]);
+		}
+	}
+
+	if (0 == n_threads || 0 == n_mix) {
+		print_usage();
+		sw_error(-1, "\nNumber of threads and of sites must be positive\n");
+	}
+	if (0 == n_strong) {
+		n_strong = 4 * n_mix;
+	}
+
+	// 1, 2, 4, ... and the largest number of threads
+	for (p = 1; p < n_threads && n_runs < 31; p *= 2) {
+		threads[n_runs++] = p;
+	}
+	threads[n_runs++] = n_threads;
+
+	read_template(&t, templ);
+	write_sites(&t, max(n_strong, n_mix * n_threads), n_mix);
+
+	swprintf("sw_bench_batch (version %s): %u synthetic sites of a mix of %u in %s\n",
+		SW2_VERSION, max(n_strong, n_mix * n_threads), n_mix, workdir);
+
+	if (generate_only) {
+		write_manifest(n_strong);
+		write_manifest(n_mix * n_threads);
+		return 0;
+	}
+
+	strong = (BENCH_RUN *) Mem_Calloc(n_runs, sizeof(BENCH_RUN), "main()");
+	weak = (BENCH_RUN *) Mem_Calloc(n_runs, sizeof(BENCH_RUN), "main()");
+
+	run_batch(n_mix, 1, &warmup);
+
+	swprintf("%6s %7s %5s %9s %7s %5s %8s %8s %8s %8s %9s %9s\n",
+		"mode", "threads", "sites", "makespan", "speedup", "eff",
+		"p50", "p90", "p99", "max", "ctx[kB]", "rss[kB]");
+
+	for (i = 0; i < n_runs; i++) {
+		run_batch(n_strong, threads[i], &strong[i]);
+		print_run("strong", &strong[i], &strong[0]);
+	}
+
+	for (i = 0; i < n_runs; i++) {
+		run_batch(n_mix * threads[i], threads[i], &weak[i]);
+		print_run("weak", &weak[i], &weak[0]);
+	}
+
+	if (!isnull(fjson)) {
+		write_json(fjson, &t, n_mix, strong, weak, n_runs);
+		CloseFile(&fjson);
+	}
+
+	Mem_Free(strong);
+	Mem_Free(weak);
+
+	return 0;
+}
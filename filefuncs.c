@@ -1,3 +1,7 @@
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L /* for fileno(), fsync(), and ftruncate() with -std=c11 */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdarg.h>
@@ -12,6 +16,10 @@
 #else
 #include <unistd.h>
 #endif
+#ifdef _WIN32
+#include <io.h>
+#define fsync(fd) _commit(fd)
+#endif
 
 #include "filefuncs.h"
 #include "generic.h"
@@ -25,10 +33,79 @@
 /* Note that errstr[] is externed in generic.h via filefuncs.h */
 /* 01/05/2011	(drs) removed unused variable *p from MkDir()
  06/21/2013	(DLM)	memory leak in function getfiles(): variables dname and fname need to be free'd
+ 2026-10-15 added SyncFile() and ResumeFile() for checkpoints of simulation runs
+ 2026-10-15 added SW_TEXTFILE: input files are read as a whole and split into lines
+   in place (replaces GetALine() with the global buffer inbuf)
+ 2026-10-15 sw_error() jumps to the error handler of the thread (if set) instead
+   of exiting; added SW_LOGBUFFER, log messages of a thread held in memory
  */
 
 char **getfiles(const char *fspec, int *nfound);
 
+/** Fatal errors of the calling thread exit the process unless a handler is set,
+    see `SW_ERROR_HANDLER` */
+SW_THREAD_LOCAL SW_ERROR_HANDLER *LogError_handler = NULL;
+
+/** Log messages of the calling thread are written to their file unless
+    a buffer is set, see `SW_LOGBUFFER` */
+SW_THREAD_LOCAL SW_LOGBUFFER *LogError_buffer = NULL;
+
+
+/** Append a formatted message to a log buffer
+
+  If the buffer cannot grow, then the message is written to `stderr`.
+*/
+static void append_log(SW_LOGBUFFER *buf, const char *fmt, va_list ap) {
+	va_list ap_len;
+	size_t size;
+	char *p;
+	int n;
+
+	va_copy(ap_len, ap);
+	n = vsnprintf(NULL, 0, fmt, ap_len);
+	va_end(ap_len);
+
+	if (n < 0) {
+		return;
+	}
+
+	if (buf->len + (size_t) n + 1 > buf->size) {
+		size = max(2 * buf->size, buf->len + (size_t) n + 1);
+		size = max(size, (size_t) 1024);
+
+		// not Mem_ReAlloc(): it logs (and may not return) if out of memory
+		p = (char *) realloc(buf->text, size);
+		if (isnull(p)) {
+			vfprintf(stderr, fmt, ap);
+			return;
+		}
+		buf->text = p;
+		buf->size = size;
+	}
+
+	vsnprintf(buf->text + buf->len, buf->size - buf->len, fmt, ap);
+	buf->len += (size_t) n;
+}
+
+
+/**
+  @brief Write the messages of a log buffer to a file and empty the buffer
+
+  @param buf Log buffer, see `SW_LOGBUFFER`.
+  @param fp File to write to; NULL discards the messages.
+*/
+void FlushLogBuffer(SW_LOGBUFFER *buf, FILE *fp) {
+	if (!isnull(fp) && buf->len > 0) {
+		// one write so that messages do not interleave with other threads
+		fwrite(buf->text, 1, buf->len, fp);
+		fflush(fp);
+	}
+
+	free(buf->text);
+	buf->text = NULL;
+	buf->len = buf->size = 0;
+}
+
 
 /**
  * @brief Prints an error message and throws an error or warning. Works both for rSOILWAT2
@@ -36,7 +113,8 @@ char **getfiles(const char *fspec, int *nfound);
  *
  * @param code The error/warning code. If `code` is not 0, then it is passed to `exit`
  *  (SOILWAT2) / `error` (rSOILWAT2). If `code` is 0, then it is passed to
- *  `warning` (rSOILWAT2), respectively.
+ *  `warning` (rSOILWAT2), respectively. SOILWAT2 does not exit if the calling
+ *  thread set an error handler, see `SW_ERROR_HANDLER`.
  * @param format The character string with formatting (as for `printf`).
  * @param ... Variables to be printed.
  */
@@ -45,10 +123,29 @@ void sw_error(int code, const char *format, ...)
   va_list ap;
   va_start(ap, format);
 
+#ifndef RSOILWAT
+  if (code != 0 && !isnull(LogError_handler)) {
+    va_list ap_log;
+
+    if (!isnull(LogError_buffer)) {
+      va_copy(ap_log, ap);
+      append_log(LogError_buffer, format, ap_log);
+      va_end(ap_log);
+    }
+    vsnprintf(LogError_handler->msg, ERRSTRLEN, format, ap);
+    va_end(ap);
+    longjmp(LogError_handler->env, 1);
+  }
+#endif
+
 #ifdef RSOILWAT
   REvprintf(format, ap);
 #else
-  vfprintf(stderr, format, ap);
+  if (!isnull(LogError_buffer)) {
+    append_log(LogError_buffer, format, ap);
+  } else {
+    vfprintf(stderr, format, ap);
+  }
 #endif
   va_end(ap);
 
@@ -61,6 +158,10 @@ void sw_error(int code, const char *format, ...)
     #ifdef RSOILWAT
       error("exit %d\n", code);
     #else
+      if (!isnull(LogError_buffer)) {
+        // don't lose buffered messages
+        FlushLogBuffer(LogError_buffer, stderr);
+      }
       exit(code);
     #endif
   }
@@ -77,9 +178,10 @@ void LogError(FILE *fp, const int mode, const char *fmt, ...) {
 	 */
 
 	char outfmt[ERRSTRLEN] = {0}; /* to prepend err type str */
-	va_list args;
+	va_list args, args_msg;
 
 	va_start(args, fmt);
+	va_copy(args_msg, args);
 
 	if (LOGQUIET & mode)
 		strcpy(outfmt, "");
@@ -100,17 +202,30 @@ void LogError(FILE *fp, const int mode, const char *fmt, ...) {
 
 	#else
 		int check_eof;
-		check_eof = (EOF == vfprintf(fp, outfmt, args));
 
-		if (check_eof)
-			sw_error(0, "SYSTEM: Cannot write to FILE *fp in LogError()\n");
-		fflush(fp);
+		if (!isnull(LogError_buffer)) {
+			append_log(LogError_buffer, outfmt, args);
+
+		} else {
+			check_eof = (EOF == vfprintf(fp, outfmt, args));
+
+			if (check_eof)
+				sw_error(0, "SYSTEM: Cannot write to FILE *fp in LogError()\n");
+			fflush(fp);
+		}
 	#endif
 
 
 	logged = swTRUE;
 	va_end(args);
 
+	if ((LOGEXIT & mode) && !isnull(LogError_handler)) {
+		vsnprintf(LogError_handler->msg, ERRSTRLEN, fmt, args_msg);
+		va_end(args_msg);
+		longjmp(LogError_handler->env, 1);
+	}
+	va_end(args_msg);
+
 	if (LOGEXIT & mode) {
 		sw_error(-1, "@ generic.c LogError");
 	}
@@ -138,13 +253,126 @@ Bool GetALine(FILE *f, char buf[]) {
 	return (not_eof);
 }
 
+
+/**
+@brief Read a text file into memory as a whole
+
+The contents are read in binary mode; `GetATextLine()` removes carriage
+returns of DOS line endings together with trailing whitespace.
+
+@note The memory is not taken from the arena of a simulation run
+  (`Mem_Malloc()`) because it is released as soon as the file is read.
+
+@param tf The text file; release it with `CloseTextFile()`.
+@param name Name of the file.
+
+@return swFALSE if the file cannot be opened or read (and `tf` is empty).
+*/
+Bool ReadTextFile(SW_TEXTFILE *tf, const char *name) {
+	FILE *fp;
+	size_t size = 0, cap = 65536, n;
+	char *p;
+
+	tf->data = tf->next = tf->line = NULL;
+
+	if (isnull(fp = fopen(name, "rb"))) {
+		return swFALSE;
+	}
+
+	if (isnull(tf->data = (char *) malloc(cap))) {
+		fclose(fp);
+		return swFALSE;
+	}
+
+	while ((n = fread(tf->data + size, 1, cap - size - 1, fp)) > 0) {
+		size += n;
+
+		if (size == cap - 1) {
+			cap *= 2;
+			if (isnull(p = (char *) realloc(tf->data, cap))) {
+				break;
+			}
+			tf->data = p;
+		}
+	}
+
+	if (ferror(fp) || size == cap - 1) {
+		fclose(fp);
+		CloseTextFile(tf);
+		return swFALSE;
+	}
+
+	fclose(fp);
+
+	tf->data[size] = '\0';
+	tf->next = tf->data;
+
+	return swTRUE;
+}
+
+/**
+@brief Read a text file into memory as a whole; fails like `OpenFile()`
+  if the file cannot be read, see `ReadTextFile()`
+
+@param tf The text file; release it with `CloseTextFile()`.
+@param name Name of the file.
+*/
+void OpenTextFile(SW_TEXTFILE *tf, const char *name) {
+	if (!ReadTextFile(tf, name)) {
+		LogError(logfp, LOGERROR | LOGEXIT, "Cannot open file %s: %s", name, strerror(errno));
+	}
+}
+
+/**
+@brief Advance to the next line of possibly commented input of a text file
+
+Works like `GetALine()`: blank lines and comment lines are skipped,
+comments within the line and trailing whitespace are removed. The line is
+terminated in place and is available as `tf->line` until the file is closed.
+
+@param tf The text file, see `OpenTextFile()`.
+
+@return swFALSE if there are no more lines.
+*/
+Bool GetATextLine(SW_TEXTFILE *tf) {
+	char *p;
+
+	while (!isnull(tf->next) && *tf->next != '\0') {
+		tf->line = tf->next;
+
+		if (!isnull(p = strchr(tf->line, '\n'))) {
+			*p = '\0';
+			tf->next = p + 1;
+		} else {
+			tf->next = tf->line + strlen(tf->line);
+		}
+
+		UnComment(tf->line);
+		if (*tf->line != '\0') {
+			return swTRUE;
+		}
+	}
+
+	return swFALSE;
+}
+
+/**
+@brief Release the contents of a text file; `tf` may be closed repeatedly
+
+@param tf The text file, see `OpenTextFile()`.
+*/
+void CloseTextFile(SW_TEXTFILE *tf) {
+	free(tf->data);
+	tf->data = tf->next = tf->line = NULL;
+}
+
 /**************************************************************/
 char *DirName(const char *p) {
 	/* copy path (if any) to a static buffer.
 	 * Be sure to copy the return value to a more stable buffer
 	 * before moving on.
 	 */
-	static char s[FILENAME_MAX];
+	static SW_THREAD_LOCAL char s[FILENAME_MAX];
 	char *c;
 	int l;
 	char sep1 = '/', sep2 = '\\';
@@ -203,6 +431,31 @@ void CloseFile(FILE **f) {
 	*f = NULL;
 }
 
+/**************************************************************/
+Bool SyncFile(FILE *f) {
+	/* write the buffered data of a stream and let the operating
+	 * system commit it to disk, e.g., before a checkpoint refers to it.
+	 * returns FALSE if anything failed.
+	 */
+	return (0 == fflush(f) && 0 == fsync(fileno(f))) ? swTRUE : swFALSE;
+}
+
+/**************************************************************/
+FILE * ResumeFile(const char *name, const char *mode, long size) {
+	/* open an existing file for writing at its end after cutting it
+	 * to its first `size` bytes, e.g., to discard what was written
+	 * after a checkpoint. `mode` is "r+" or "r+b".
+	 */
+	FILE *fp;
+
+	fp = OpenFile(name, mode);
+	if (0 != ftruncate(fileno(fp), (off_t) size) || 0 != fseek(fp, 0, SEEK_END)) {
+		fclose(fp);
+		LogError(logfp, LOGERROR | LOGEXIT, "Cannot resume file %s: %s", name, strerror(errno));
+	}
+	return (fp);
+}
+
 /**************************************************************/
 Bool FileExists(const char *name) {
 	/* return swFALSE if name is not a regular file
@@ -408,8 +661,8 @@ char **getfiles(const char *fspec, int *nfound) {
 	}
 
 	closedir(dir);
-	free(dname);
-	free(fname);
+	Mem_Free(dname);
+	Mem_Free(fname);
 
 	return flist;
 }
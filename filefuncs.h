@@ -9,6 +9,7 @@
 #ifndef FILEFUNCS_H
 #define FILEFUNCS_H
 
+#include <setjmp.h>
 #include "generic.h"
 
 #ifdef __cplusplus
@@ -19,12 +20,59 @@ extern "C" {
 #define ERRSTRLEN 3000
 
 
+/** Handler for fatal errors of the calling thread.
+
+  If a thread sets `LogError_handler`, then `LogError()` with `LOGEXIT`
+  and `sw_error()` with a non-zero code store the error message in `msg`
+  and jump to `env` (via `longjmp()`) instead of terminating the process, e.g., so that a failing simulation
+  run of a batch does not bring down all other runs.
+*/
+typedef struct {
+	jmp_buf env; /**< return point, set by `setjmp()` */
+	char msg[ERRSTRLEN]; /**< message of the fatal error */
+} SW_ERROR_HANDLER;
+
+
+/** Log messages of the calling thread that are held in memory.
+
+  If a thread sets `LogError_buffer`, then `LogError()` appends its
+  messages to `text` instead of writing them to a file, e.g., so that the
+  messages of a simulation run of a batch are written at once by
+  `FlushLogBuffer()` and do not interleave with those of other runs.
+*/
+typedef struct {
+	char *text; /**< messages, nul-terminated; NULL if none */
+	size_t len; /**< length of `text` */
+	size_t size; /**< allocated size of `text` */
+} SW_LOGBUFFER;
+
+
+/** A text input file that is read into memory as a whole.
+
+  `GetATextLine()` splits the contents into lines in place, i.e., without
+  copying them into a line buffer; values are then read from `line`,
+  e.g., with `Str_Scan()`. Each reader has its own `SW_TEXTFILE` so that
+  reading is reentrant.
+*/
+typedef struct {
+	char *data; /**< contents of the file, nul-terminated */
+	char *next; /**< start of the next unread line of `data` */
+	char *line; /**< current line, see `GetATextLine()` */
+} SW_TEXTFILE;
+
+
 /***************************************************
  * Function definitions
  ***************************************************/
 FILE * OpenFile(const char *, const char *);
 void CloseFile(FILE **);
+Bool SyncFile(FILE *f);
+FILE * ResumeFile(const char *name, const char *mode, long size);
 Bool GetALine(FILE *f, char buf[]);
+Bool ReadTextFile(SW_TEXTFILE *tf, const char *name);
+void OpenTextFile(SW_TEXTFILE *tf, const char *name);
+Bool GetATextLine(SW_TEXTFILE *tf);
+void CloseTextFile(SW_TEXTFILE *tf);
 char *DirName(const char *p);
 const char *BaseName(const char *p);
 Bool FileExists(const char *f);
@@ -34,8 +82,10 @@ Bool MkDir(const char *d);
 Bool RemoveFiles(const char *fspec);
 void sw_error(int errorcode, const char *format, ...);
 void LogError(FILE *fp, const int mode, const char *fmt, ...);
+void FlushLogBuffer(SW_LOGBUFFER *buf, FILE *fp);
 
-extern char inbuf[]; /* declare in main, use anywhere */
+extern SW_THREAD_LOCAL SW_ERROR_HANDLER *LogError_handler; /* NULL: fatal errors exit */
+extern SW_THREAD_LOCAL SW_LOGBUFFER *LogError_buffer; /* NULL: messages are written to their file */
 
 
 #ifdef __cplusplus
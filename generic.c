@@ -1,9 +1,18 @@
+#if !defined(_WIN32) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* for strtod_l() and strtof_l() of glibc with -std=c11 */
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <stdarg.h>
 #include <math.h>
+#include <locale.h>
+#include <pthread.h>
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h>
+#endif
 
 /* int logged is to be declared in the main module of your program. */
 /* global variable indicates logfile used: externed via generic.h */
@@ -17,6 +26,10 @@
  05/25/2012  (DLM) added interpolation() function
  05/29/2012  (DLM) added lobf(), lobfM(), & lobfB() function
  05/31/2012  (DLM) added st_getBounds() function for use in the soil_temperature function in SW_Flow_lib.c
+ 2026-10-14  added Str_FormatFixed() to format output values without printf
+ 2026-10-15  added merge_running_stats() to combine running aggregations
+ 2026-10-15  added Str_ToDouble(), Str_ToFloat(), and Str_Scan() to read input
+             values fast and independently of the locale
  */
 
 #include "generic.h"
@@ -410,3 +423,456 @@ double final_running_sd(unsigned int n, double ssqr)
 {
 	return (n > 1) ? sqrt(ssqr / (n - 1)) : 0.;
 }
+
+/** @brief Merge two running aggregations of disjoint sets of values
+
+		Combines the running average \f$m_a\f$ and sum of squares \f$S_a\f$ of
+		\f$n_a\f$ values with those of \f$n_b\f$ other values (e.g., as
+		calculated by get_running_mean() and get_running_sqr() in separate
+		threads) into the aggregation of all \f$n = n_a + n_b\f$ values, i.e.,
+			\f$m = m_a + d * n_b / n\f$ and
+			\f$S = S_a + S_b + d^2 * n_a * n_b / n\f$
+		where \f$d = m_b - m_a\f$.
+
+		@param n_a Number of values of the first aggregation
+		@param mean_a Average of the first aggregation; updated to \f$m\f$
+		@param ssqr_a Sum of squares of the first aggregation; updated to \f$S\f$
+		@param n_b Number of values of the second aggregation
+		@param mean_b Average of the second aggregation
+		@param ssqr_b Sum of squares of the second aggregation
+
+		@see Chan, T. F., G. H. Golub, and R. J. LeVeque. 1979. Updating
+			formulae and a pairwise algorithm for computing sample variances.
+			<https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance#Parallel_algorithm>
+*/
+void merge_running_stats(unsigned int n_a, double *mean_a, double *ssqr_a,
+	unsigned int n_b, double mean_b, double ssqr_b)
+{
+	double n, d;
+
+	if (n_b == 0) {
+		return;
+	}
+
+	if (n_a == 0) {
+		*mean_a = mean_b;
+		*ssqr_a = ssqr_b;
+		return;
+	}
+
+	n = (double) n_a + n_b;
+	d = mean_b - *mean_a;
+
+	*mean_a += d * n_b / n;
+	*ssqr_a += ssqr_b + d * d * n_a * n_b / n;
+}
+
+
+/** Powers of ten for `Str_FormatFixed()` */
+static const double pow10_fixed[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+/** @brief Format a double in fixed-point notation
+
+		Writes the same characters as `sprintf(s, "%.*f", digits, x)`
+		(including the rounding of ties to even of the exact binary value)
+		but without the overhead of parsing a format string. Values that
+		are not finite, that do not fit into 52 bits, or that are requested with
+		more than nine decimal digits are passed on to `sprintf()`.
+
+		@param s Destination; must be large enough to hold the formatted value.
+		@param x Value to format.
+		@param digits Number of decimal digits.
+
+		@return Pointer to the terminating nul character of `s` so that
+			further text can be appended without rescanning `s`.
+*/
+char *Str_FormatFixed(char *s, double x, int digits)
+{
+	char tmp[24], *q;
+	double a, ip, f, p, r, t, e, scale;
+	unsigned long long n;
+
+	a = fabs(x);
+
+	// `!(a < ...)` is also true for NaN
+	if (digits < 0 || digits > 9 || !(a < 4503599627370496.)) {
+		return s + sprintf(s, "%.*f", digits, x);
+	}
+
+	scale = pow10_fixed[digits];
+	ip = floor(a);
+	f = a - ip; // exact
+
+	// round the scaled fraction to the nearest integer; if the rounded
+	// product lies exactly halfway between two integers, then the sign of the
+	// rounding error of the product decides (and a true tie goes to even)
+	p = f * scale;
+	r = nearbyint(p);
+	t = p - r; // exact
+
+	if (t == 0.5 || t == -0.5) {
+		e = fma(f, scale, -p);
+
+		if (e > 0.) {
+			r = ceil(p);
+		} else if (e < 0.) {
+			r = floor(p);
+		} else if (digits == 0) {
+			r = (fmod(ip, 2.) == 0.) ? 0. : 1.;
+		}
+	}
+
+	if (r >= scale) {
+		r -= scale;
+		ip += 1.;
+	}
+
+	if (signbit(x)) {
+		*s++ = '-';
+	}
+
+	// integer part
+	n = (unsigned long long) ip;
+	q = tmp + sizeof tmp;
+	do {
+		*--q = (char) ('0' + n % 10);
+		n /= 10;
+	} while (n > 0);
+
+	while (q < tmp + sizeof tmp) {
+		*s++ = *q++;
+	}
+
+	// decimal digits (zero-padded)
+	if (digits > 0) {
+		*s++ = '.';
+
+		n = (unsigned long long) r;
+		q = s + digits;
+		while (q > s) {
+			*--q = (char) ('0' + n % 10);
+			n /= 10;
+		}
+		s += digits;
+	}
+
+	*s = '\0';
+
+	return s;
+}
+
+
+/** Powers of ten that are exact in double precision, see `Str_ToDouble()` */
+static const double pow10_exact[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/** Powers of ten that are exact in single precision, see `Str_ToFloat()` */
+static const float pow10f_exact[] = {
+	1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+#ifdef _WIN32
+typedef _locale_t sw_locale_t;
+#define new_c_locale() _create_locale(LC_NUMERIC, "C")
+#define strtod_l _strtod_l
+#define strtof_l _strtof_l
+#else
+typedef locale_t sw_locale_t;
+#define new_c_locale() newlocale(LC_NUMERIC_MASK, "C", (locale_t) 0)
+#endif
+
+static sw_locale_t c_locale; /**< "C" locale of `strtod_l()` and `strtof_l()` */
+static pthread_once_t c_locale_once = PTHREAD_ONCE_INIT;
+
+static void init_c_locale(void) {
+	c_locale = new_c_locale();
+}
+
+/** The "C" locale for the fallback of `Str_ToDouble()` and `Str_ToFloat()`
+    to the C library: created once per process, never freed */
+static sw_locale_t get_c_locale(void) {
+	pthread_once(&c_locale_once, init_c_locale);
+
+	if (!c_locale) {
+		LogError(stderr, LOGFATAL, "Cannot create the \"C\" locale to read numbers.");
+	}
+
+	return c_locale;
+}
+
+/** Split a decimal number `[+-]digits[.digits][(e|E)[+-]digits]` into its
+    sign, its significant digits `*mant`, and its decimal exponent `*exp10`
+
+    @return Pointer to the first character after the number; `s` if `s` does
+      not start with a number or if the significant digits do not fit into
+      `*mant` (the caller then falls back to the C library).
+*/
+static const char *split_decimal(const char *s, Bool *neg,
+	unsigned long long *mant, int *exp10) {
+
+	const char *p = s, *q;
+	unsigned long long m = 0;
+	int e = 0, x = 0, nd = 0, esign = 1;
+	Bool any = swFALSE;
+
+	*neg = (Bool) (*p == '-');
+	if (*p == '-' || *p == '+') {
+		p++;
+	}
+
+	for (; isdigit((unsigned char) *p); p++) {
+		any = swTRUE;
+		if (m > 0 || *p != '0') {
+			if (++nd > 19) {
+				return s;
+			}
+			m = 10 * m + (unsigned long long) (*p - '0');
+		}
+	}
+
+	if (*p == '.') {
+		for (p++; isdigit((unsigned char) *p); p++) {
+			any = swTRUE;
+			if (m > 0 || *p != '0') {
+				if (++nd > 19) {
+					return s;
+				}
+				m = 10 * m + (unsigned long long) (*p - '0');
+			}
+			e--;
+		}
+	}
+
+	if (!any) {
+		return s;
+	}
+
+	if (*p == 'e' || *p == 'E') {
+		q = p + 1;
+		if (*q == '-' || *q == '+') {
+			esign = (*q == '-') ? -1 : 1;
+			q++;
+		}
+
+		if (isdigit((unsigned char) *q)) {
+			for (; isdigit((unsigned char) *q); q++) {
+				if (x < 10000) {
+					x = 10 * x + (*q - '0');
+				}
+			}
+			e += esign * x;
+			p = q;
+		}
+	}
+
+	*mant = m;
+	*exp10 = e;
+
+	return p;
+}
+
+/** @brief Convert the initial part of a string to a double
+
+		Returns the same value as `strtod()` in the "C" locale, i.e., the
+		decimal separator is always a point. Numbers with at most 15
+		significant digits and a small exponent, i.e., all numbers of the
+		input files of SOILWAT2, are converted exactly without the C library
+		(Clinger's fast path: the significand and the power of ten are both
+		exact doubles so that the result is correctly rounded by a single
+		multiplication or division); all others are passed on to `strtod_l()`
+		with the "C" locale, i.e., the locale set by the calling program, e.g.,
+		R, does not matter.
+
+		@param s String to convert; leading whitespace is skipped.
+		@param end If not NULL, set to the first character after the number
+			(or to `s` if no conversion was performed).
+
+		@return The converted value; 0 if no conversion was performed.
+*/
+double Str_ToDouble(const char *s, char **end)
+{
+	const char *p = s, *q;
+	unsigned long long m = 0;
+	int e = 0;
+	Bool neg;
+	double x;
+
+	while (isspace((unsigned char) *p)) {
+		p++;
+	}
+
+	q = split_decimal(p, &neg, &m, &e);
+
+	if (q == p || isalnum((unsigned char) *q) || *q == '.' ||
+		m > 9007199254740992ULL || e < -22 || e > 22) {
+		// not a plain decimal number or not exact
+		return strtod_l(s, end, get_c_locale());
+	}
+
+	x = (e < 0) ? (double) m / pow10_exact[-e] : (double) m * pow10_exact[e];
+
+	if (!isnull(end)) {
+		*end = (char *) q;
+	}
+
+	return neg ? -x : x;
+}
+
+/** @brief Convert the initial part of a string to a float
+
+		Returns the same value as `strtof()` in the "C" locale, i.e., the same
+		value as `sscanf()` with `%f`, see `Str_ToDouble()`; the fast path
+		applies to numbers with at most 7 significant digits.
+
+		@param s String to convert; leading whitespace is skipped.
+		@param end If not NULL, set to the first character after the number
+			(or to `s` if no conversion was performed).
+
+		@return The converted value; 0 if no conversion was performed.
+*/
+float Str_ToFloat(const char *s, char **end)
+{
+	const char *p = s, *q;
+	unsigned long long m = 0;
+	int e = 0;
+	Bool neg;
+	float x;
+
+	while (isspace((unsigned char) *p)) {
+		p++;
+	}
+
+	q = split_decimal(p, &neg, &m, &e);
+
+	if (q == p || isalnum((unsigned char) *q) || *q == '.' ||
+		m > 16777216ULL || e < -10 || e > 10) {
+		return strtof_l(s, end, get_c_locale());
+	}
+
+	x = (e < 0) ? (float) m / pow10f_exact[-e] : (float) m * pow10f_exact[e];
+
+	if (!isnull(end)) {
+		*end = (char *) q;
+	}
+
+	return neg ? -x : x;
+}
+
+/** @brief Read formatted values from a string
+
+		A fast and locale-independent subset of `sscanf()`: the conversions
+		`%d`, `%f`, `%lf`, and `%s` (with an optional maximum field width)
+		are supported; whitespace in `fmt` matches any amount of whitespace;
+		other characters must match. Numbers are converted with `strtol()`,
+		`Str_ToFloat()`, and `Str_ToDouble()`, respectively.
+
+		@param s String to read, e.g., a line of an input file.
+		@param fmt Format as for `sscanf()`.
+		@param ... Pointers to the values to be assigned.
+
+		@return The number of assigned values, or `EOF` if the end of `s`
+			was reached before the first conversion (as `sscanf()`).
+*/
+int Str_Scan(const char *s, const char *fmt, ...)
+{
+	va_list ap;
+	const char *f = fmt;
+	char *end, *dst;
+	int n = 0, width;
+	Bool is_long, ok = swTRUE;
+	long li;
+	float xf;
+	double xd;
+
+	va_start(ap, fmt);
+
+	while (ok && *f != '\0') {
+		if (isspace((unsigned char) *f)) {
+			while (isspace((unsigned char) *s)) {
+				s++;
+			}
+			f++;
+			continue;
+		}
+
+		if (*f != '%') {
+			ok = (Bool) (*s == *f);
+			s++;
+			f++;
+			continue;
+		}
+
+		// conversion specification
+		f++;
+		for (width = 0; isdigit((unsigned char) *f); f++) {
+			width = 10 * width + (*f - '0');
+		}
+		is_long = (Bool) (*f == 'l');
+		if (is_long) {
+			f++;
+		}
+
+		while (isspace((unsigned char) *s)) {
+			s++;
+		}
+		if (*s == '\0') {
+			if (n == 0) {
+				n = EOF;
+			}
+			break;
+		}
+
+		// values are only assigned if the conversion succeeds
+		switch (*f) {
+			case 'd':
+				li = strtol(s, &end, 10);
+				ok = (Bool) (end != s);
+				if (ok) {
+					*va_arg(ap, int *) = (int) li;
+				}
+				break;
+
+			case 'f':
+				if (is_long) {
+					xd = Str_ToDouble(s, &end);
+					ok = (Bool) (end != s);
+					if (ok) {
+						*va_arg(ap, double *) = xd;
+					}
+				} else {
+					xf = Str_ToFloat(s, &end);
+					ok = (Bool) (end != s);
+					if (ok) {
+						*va_arg(ap, float *) = xf;
+					}
+				}
+				break;
+
+			case 's':
+				dst = va_arg(ap, char *);
+				for (end = (char *) s; *end != '\0' && !isspace((unsigned char) *end) &&
+					(width == 0 || end - s < width); end++) {
+					*dst++ = *end;
+				}
+				*dst = '\0';
+				break;
+
+			default:
+				ok = swFALSE; // unsupported conversion
+		}
+
+		if (ok) {
+			s = end;
+			f++;
+			n++;
+		}
+	}
+
+	va_end(ap);
+
+	return n;
+}
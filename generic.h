@@ -16,6 +16,8 @@
  03/08/2013	(clk) added abs(x) definition, this returns the absolute value of x. If x < 0, returns -x, else returns x.
  06/19/2013	(DLM) replaced isless2(), ismore(), iszero(), isequal() macros with new MUCH faster ones... these new macros make the program run about 4x faster as a whole.
  06/26/2013 (dlm)	powe(): an alternate definition of pow(x, y) for x>0... this is faster (ca. 20%) then the one in math.h, but comes with a cost as the precision is slightly lower.  The measured precision drop I was getting was at max a relative error of about 100 billion percent (12 places after the decimal point) per calculation though so I don't think it's a big deal... (though it's hard to even accurately tell)
+ 2026-10-15	added sw_fast_exp(), sw_fast_log(), sw_fast_pow(), sw_fast_atan() and
+	the build-time switch SW_FAST_MATH
  */
 
 
@@ -44,6 +46,7 @@
 #include <float.h>
 #include <math.h>
 #include <assert.h>
+#include <string.h> // declares `strdup()` (if available) before the fallback below
 
 #ifdef RSOILWAT
   #include <R_ext/Print.h>
@@ -58,6 +61,20 @@ extern "C" {
  * Basic definitions
  ***************************************************/
 
+/* ------ Thread-local storage. ------ */
+/* Storage class for variables that need one instance per thread, e.g.,
+ * scratch buffers and the currently active simulation run (see SW_Run.h).
+ */
+#if defined(__cplusplus)
+  #define SW_THREAD_LOCAL thread_local
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+  #define SW_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+  #define SW_THREAD_LOCAL __thread
+#else
+  #define SW_THREAD_LOCAL
+#endif
+
 /* ------ Convenience macros. ------ */
 /* integer to boolean */
 #define itob(i) ((i)?swTRUE:swFALSE)
@@ -140,20 +157,22 @@ typedef unsigned char byte;
 #define LOGFATAL 0x0c  /* LOGEXIT | LOGERROR */
 #define MAX_ERROR 4096
 
-extern FILE *logfp; /* REQUIRED */
+extern SW_THREAD_LOCAL FILE *logfp; /* REQUIRED */
 /* This is the pointer to the log file.  It is declared in the
  * main module and externed here to make it available to any
  * file that needs it so all modules write to the same logfile.
+ * One pointer per thread so that concurrent simulation runs
+ * can each write to their own logfile.
  * See also the comments on 'logged' below.
  */
 
-extern char errstr[]; /* REQUIRED */
+extern SW_THREAD_LOCAL char errstr[]; /* REQUIRED */
 /* declared in the main module, this is an ever-ready
  * buffer to put error text into for printing or
- * writing to the log file.
+ * writing to the log file. One buffer per thread.
  */
 
-extern int logged; /* REQUIRED */
+extern SW_THREAD_LOCAL int logged; /* REQUIRED */
 /* use as a boolean: see gen_funcs.c.
  * Global variable indicates logfile written to via LogError.
  * In the main module, create a subroutine (eg, log_notify)
@@ -208,10 +227,125 @@ extern int logged; /* REQUIRED */
 #define GE(x,y) ((x) > (y) || EQ(x,y))
 
 // 06/26/2013 (dlm)	powe(): an alternate definition of pow(x, y) for x>0... this is faster (ca. 20%) then the one in math.h, but comes with a cost as the precision is slightly lower.  The measured precision drop I was getting was at max a relative error of about 100 billion percent (12 places after the decimal point) per calculation though so I don't think it's a big deal... (though it's hard to even accurately tell)
-#define powe(x, y) (exp((y) * log(x))) //x^y == exponential(y * ln(x)) or e^(y * ln(x)).  NOTE: this will only work when x > 0 I believe
 #define squared(x) ((x) * (x)) // added for convenience
 
 
+/* Fast approximations of exp(), log(), pow(), and atan(): polynomials
+   without table lookups that compilers can inline and vectorize.
+   Maximal relative errors (see test_generic.cc) are
+     - sw_fast_exp(x): < 1e-8 for -708 <= x <= 709
+       (x is clamped to this range)
+     - sw_fast_log(x): < 1e-8 for normal x > 0
+     - sw_fast_pow(x, y): < 1e-8 * (1 + |y * log(x)|) for x > 0
+     - sw_fast_atan(x): < 1e-8
+   NaN arguments result in NaN.
+
+   They replace `exp()`, `pow()`, and `atan()` of the PET equations, of
+   `tanfunc()`, and of `powe()` if SOILWAT2 is compiled with
+   `-DSW_FAST_MATH`; otherwise, `sw_exp()`, `sw_pow()`, and `sw_atan()`
+   are the functions of math.h. */
+static inline double sw_fast_exp(double x) {
+  const double
+    ln2_hi = 6.93147180369123816490e-01,
+    ln2_lo = 1.90821492927058770002e-10,
+    round = 6755399441055744.; // 1.5 * 2^52: adding it rounds to an integer (not with -ffast-math)
+  double n, r, r2, r4, p, scale;
+  unsigned long long u;
+
+  x = (x < -708.) ? -708. : (x > 709.) ? 709. : x;
+  n = (x * 1.44269504088896338700 + round) - round;
+  r = (x - n * ln2_hi) - n * ln2_lo; // |r| <= ln(2) / 2
+
+  // Taylor polynomial of degree 7 (Estrin's scheme)
+  r2 = r * r;
+  r4 = r2 * r2;
+  p = (1. + r) + r2 * (1. / 2. + r * (1. / 6.)) +
+    r4 * ((1. / 24. + r * (1. / 120.)) + r2 * (1. / 720. + r * (1. / 5040.)));
+
+  n = (n == n) ? n : 0.; // NaN: p is NaN
+  u = (unsigned long long) ((long long) n + 1023) << 52; // 2^n
+  memcpy(&scale, &u, sizeof scale);
+
+  return p * scale;
+}
+
+static inline double sw_fast_log(double x) {
+  const double
+    ln2_hi = 6.93147180369123816490e-01,
+    ln2_lo = 1.90821492927058770002e-10;
+  double m, e, s, s2, s4, p;
+  unsigned long long u;
+
+  // x = m * 2^e with sqrt(1/2) < m <= sqrt(2)
+  memcpy(&u, &x, sizeof u);
+  e = (double) ((long long) (u >> 52) - 1023);
+  u = (u & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL;
+  memcpy(&m, &u, sizeof m);
+
+  if (m > 1.41421356237309504880) {
+    m *= 0.5;
+    e += 1.;
+  }
+
+  // log(m) = 2 * atanh(s) with |s| <= 0.172
+  s = (m - 1.) / (m + 1.);
+  s2 = s * s;
+  s4 = s2 * s2;
+  p = 2. * s * ((1. + s2 * (1. / 3.)) +
+    s4 * ((1. / 5. + s2 * (1. / 7.)) + s4 * (1. / 9.)));
+
+  p = e * ln2_hi + (p + e * ln2_lo);
+
+  // log(0) = -Inf, log(Inf) = Inf, and log(x) = NaN for x < 0 or NaN
+  return (x > 0. && x <= DBL_MAX) ? p : (x == 0.) ? -HUGE_VAL : (x > 0.) ? x : NAN;
+}
+
+static inline double sw_fast_pow(double x, double y) {
+  return sw_fast_exp(y * sw_fast_log(x));
+}
+
+static inline double sw_fast_atan(double x) {
+  const double pi_2 = 1.57079632679489661923, pi_4 = 0.78539816339744830962;
+  double a = fabs(x), t, t2, t4, t8, p, offset;
+
+  // atan(a) = offset + atan(t) with |t| <= tan(pi / 8)
+  if (a > 2.41421356237309504880) { // a > tan(3 pi / 8)
+    t = -1. / a;
+    offset = pi_2;
+  } else if (a > 0.41421356237309504880) { // a > tan(pi / 8)
+    t = (a - 1.) / (a + 1.);
+    offset = pi_4;
+  } else {
+    t = a;
+    offset = 0.;
+  }
+
+  // Taylor polynomial of degree 17 (Estrin's scheme)
+  t2 = t * t;
+  t4 = t2 * t2;
+  t8 = t4 * t4;
+  p = t * (
+    ((1. - t2 * (1. / 3.)) + t4 * (1. / 5. - t2 * (1. / 7.))) +
+    t8 * (((1. / 9. - t2 * (1. / 11.)) + t4 * (1. / 13. - t2 * (1. / 15.))) +
+    t8 * (1. / 17.))
+  );
+
+  return copysign(offset + p, x);
+}
+
+#ifdef SW_FAST_MATH
+  #define sw_exp(x) sw_fast_exp(x)
+  #define sw_pow(x, y) sw_fast_pow((x), (y))
+  #define sw_atan(x) sw_fast_atan(x)
+  #define powe(x, y) sw_fast_pow((x), (y))
+#else
+  #define sw_exp(x) exp(x)
+  #define sw_pow(x, y) pow((x), (y))
+  #define sw_atan(x) atan(x)
+  #define powe(x, y) (exp((y) * log(x))) //x^y == exponential(y * ln(x)) or e^(y * ln(x)).  NOTE: this will only work when x > 0 I believe
+#endif
+
+
 /***************************************************
  * Function definitions
  ***************************************************/
@@ -232,6 +366,13 @@ void lobf(double *m, double* b, double xs[], double ys[], unsigned int size);
 double get_running_mean(unsigned int n, double mean_prev, double val_to_add);
 double get_running_sqr(double mean_prev, double mean_current, double val_to_add);
 double final_running_sd(unsigned int n, double ssqr);
+void merge_running_stats(unsigned int n_a, double *mean_a, double *ssqr_a,
+	unsigned int n_b, double mean_b, double ssqr_b);
+
+char *Str_FormatFixed(char *s, double x, int digits);
+double Str_ToDouble(const char *s, char **end);
+float Str_ToFloat(const char *s, char **end);
+int Str_Scan(const char *s, const char *fmt, ...);
 
 
 #ifdef DEBUG
@@ -5,7 +5,7 @@
 #ifndef MEMBLOCK_H
 #define MEMBLOCK_H
 
-#include <stdlib.h>
+#include <stddef.h>
 #include <assert.h>
 
 #ifdef __cplusplus
@@ -20,9 +20,10 @@ typedef signed char flag;
  * blockinfo is a structure that contains the memory log information
  * for one allocated memory block.  Every allocated memory block has
  * a corresponding blockinfo structure in the memory log.
+ * The memory log is a search tree ordered by block start (see myMemory.c).
  */
 typedef struct BLOCKINFO {
-	struct BLOCKINFO *pbiNext;
+	struct BLOCKINFO *pbiLeft, *pbiRight; /* blocks before/after this one */
 	byte *pb; /* start of block    */
 	size_t size; /* length of block   */
 	flag fReferenced; /* Ever referenced?  */
@@ -18,6 +18,28 @@ extern "C" {
 #endif
 
 
+/* An arena holds the allocations of one simulation run (see SW_Run.h):
+ * while an arena is active on a thread, Mem_Malloc() and Mem_Calloc()
+ * take memory from its blocks, Mem_Free() of arena memory does not
+ * return memory to the system, and Mem_ArenaRelease() frees all of it
+ * at once. A zero-initialized arena is empty and not in use. */
+typedef struct mem_arena_block MEM_ARENA_BLOCK;
+
+typedef struct {
+	Bool use; /* TRUE if the owner of the arena opted in, see SW_CTL_activate_run() */
+	MEM_ARENA_BLOCK *head; /* block that is being filled; linked to older blocks */
+} MEM_ARENA;
+
+/* A copy of the contents of an arena, see Mem_ArenaSave() */
+typedef struct mem_arena_copy MEM_ARENA_COPY;
+
+typedef struct {
+	MEM_ARENA_BLOCK *head; /* head of the arena when the image was taken */
+	size_t n_blocks;
+	MEM_ARENA_COPY *copies; /* one per block of the arena */
+} MEM_ARENA_IMAGE;
+
+
 char *Str_Dup(const char *s); /* return pointer to malloc'ed dup of s */
 void *Mem_Malloc(size_t size, const char *funcname);
 void *Mem_Calloc(size_t nobjs, size_t size, const char *funcname);
@@ -25,6 +47,13 @@ void *Mem_ReAlloc(void *block, size_t sizeNew);
 void Mem_Free(void *block);
 void Mem_Set(void *block, byte c, size_t n);
 void Mem_Copy(void *dest, const void *src, size_t n);
+void Mem_ArenaActivate(MEM_ARENA *arena); /* NULL: allocate from the system */
+void Mem_ArenaRelease(MEM_ARENA *arena);
+void Mem_ArenaBlocks(const MEM_ARENA *arena,
+	void (*f)(const void *block, size_t size, void *data), void *data);
+void Mem_ArenaSave(const MEM_ARENA *arena, MEM_ARENA_IMAGE *image);
+void Mem_ArenaRestore(MEM_ARENA *arena, const MEM_ARENA_IMAGE *image);
+void Mem_ArenaFreeImage(MEM_ARENA_IMAGE *image);
 
 
 #ifdef __cplusplus
@@ -26,11 +26,15 @@
  * - CWBennett 7/17/01 */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <assert.h>
 #include "filefuncs.h"
 #include "generic.h"
 #include "myMemory.h"
+#ifdef DEBUG_MEM
+#include <pthread.h>
+#endif
 
 /*  not sure how to handle this block migrated from gen_funcs.c */
 #ifdef DEBUG_MEM_X
@@ -48,6 +52,95 @@ void mem_DelNode( void *handle);
 
 /* Note that errstr[] is externed via generic.h */
 
+/* ------ Arena of a simulation run (see MEM_ARENA in myMemory.h) ------ */
+/* Each allocation is preceded by MEM_ARENA_ALIGN bytes that hold its size
+ * (for Mem_ReAlloc()). Blocks double in size from MEM_ARENA_MINBLOCK up
+ * to MEM_ARENA_MAXBLOCK bytes; a larger request gets a block of its own.
+ * The arena is not used if DEBUG_MEM is defined so that the memory log
+ * sees every allocation.
+ */
+#define MEM_ARENA_ALIGN 16 /* suffices for all types of the model */
+#define MEM_ARENA_MINBLOCK 262144
+#define MEM_ARENA_MAXBLOCK 8388608
+#define arena_roundup(n) (((n) + MEM_ARENA_ALIGN - 1) & ~((size_t) MEM_ARENA_ALIGN - 1))
+
+struct mem_arena_block {
+	MEM_ARENA_BLOCK *next; /* previously filled block */
+	size_t size, /* bytes of data */
+		used, /* bytes of data in use */
+		last; /* offset of the most recent allocation */
+};
+
+#define arena_data(b) ((byte *)(b) + arena_roundup(sizeof(MEM_ARENA_BLOCK)))
+
+struct mem_arena_copy {
+	MEM_ARENA_BLOCK *b; /* copied block */
+	size_t len; /* bytes of block header and data in use */
+	byte *bytes; /* copy of these bytes */
+};
+
+/* arena that is active on this thread; NULL: allocate from the system */
+static SW_THREAD_LOCAL MEM_ARENA *Mem_Arena = NULL;
+
+/* return the block of arena that holds p, NULL if p is not arena memory */
+static MEM_ARENA_BLOCK *arena_block(const MEM_ARENA *arena, const void *p) {
+	MEM_ARENA_BLOCK *b;
+	uintptr_t a = (uintptr_t) p, start;
+
+	for (b = arena->head; !isnull(b); b = b->next) {
+		start = (uintptr_t) arena_data(b);
+		if (a >= start && a < start + b->size)
+			break;
+	}
+
+	return b;
+}
+
+static void *arena_alloc(MEM_ARENA *arena, size_t size, const char *funcname) {
+	MEM_ARENA_BLOCK *b = arena->head;
+	size_t need = MEM_ARENA_ALIGN + arena_roundup(size), n;
+	byte *p;
+
+	if (isnull(b) || b->size - b->used < need) {
+		n = isnull(b) ? MEM_ARENA_MINBLOCK : min(2 * b->size, MEM_ARENA_MAXBLOCK);
+		n = max(n, need);
+
+		b = (MEM_ARENA_BLOCK *) malloc(arena_roundup(sizeof(MEM_ARENA_BLOCK)) + n);
+		if (b == NULL )
+			LogError(logfp, LOGFATAL, "Out of memory in %s()", funcname);
+
+		b->next = arena->head;
+		b->size = n;
+		b->used = b->last = 0;
+		arena->head = b;
+	}
+
+	p = arena_data(b) + b->used;
+	*(size_t *) p = size;
+	b->last = b->used;
+	b->used += need;
+
+	return p + MEM_ARENA_ALIGN;
+}
+
+static void *arena_realloc(MEM_ARENA *arena, MEM_ARENA_BLOCK *b, byte *p, size_t sizeNew) {
+	byte *pNew;
+	size_t sizeOld = *(size_t *) (p - MEM_ARENA_ALIGN);
+
+	/* the most recent allocation can grow or shrink in place */
+	if (b == arena->head && p - MEM_ARENA_ALIGN == arena_data(b) + b->last
+			&& b->size - b->last >= MEM_ARENA_ALIGN + arena_roundup(sizeNew)) {
+		*(size_t *) (p - MEM_ARENA_ALIGN) = sizeNew;
+		b->used = b->last + MEM_ARENA_ALIGN + arena_roundup(sizeNew);
+		return p;
+	}
+
+	pNew = (byte *) arena_alloc(arena, sizeNew, "Mem_ReAlloc()");
+	memcpy(pNew, p, min(sizeOld, sizeNew));
+
+	return pNew;
+}
+
 /*****************************************************/
 char *Str_Dup(const char *s) {
 	/*-------------------------------------------
@@ -92,6 +185,9 @@ void *Mem_Malloc(size_t size, const char *funcname) {
 	FILE *f;
 #endif
 
+	if (!isnull(Mem_Arena))
+		return arena_alloc(Mem_Arena, size, funcname);
+
 #ifdef DEBUG_MEM
 	{
 		if (size == 0)
@@ -153,12 +249,10 @@ void *Mem_Calloc(size_t nobjs, size_t size, const char *funcname) {
 
 	p = Mem_Malloc(size * nobjs, funcname);
 
-#ifndef DEBUG_MEM
-	/* if using mcguire's code, no need to memset after
-	 * malloc() as it is done there.
+	/* mcguire's code fills new blocks with garbage, so this
+	 * memset is needed with and without DEBUG_MEM.
 	 */
 	Mem_Set(p, 0, size * nobjs);
-#endif
 
 	return p;
 
@@ -180,6 +274,7 @@ void *Mem_ReAlloc(void *block, size_t sizeNew) {
 	 -------------------------------------------*/
 	byte *p = (byte *) block, /* a copy so as not to damage original ? */
 	*pNew;
+	MEM_ARENA_BLOCK *b;
 #ifdef DEBUG_MEM
 	size_t sizeOld;
 #endif
@@ -191,6 +286,9 @@ void *Mem_ReAlloc(void *block, size_t sizeNew) {
 		sw_error(-1, "assert failed in ReAlloc");
 #endif
 
+	if (!isnull(Mem_Arena) && !isnull(b = arena_block(Mem_Arena, p)))
+		return arena_realloc(Mem_Arena, b, p, sizeNew);
+
 #ifdef DEBUG_MEM
 	{
 		sizeOld = sizeofBlock(p);
@@ -243,6 +341,17 @@ void Mem_Free(void *block) {
 	 7/23/01  - added Macguire's code.
 	 -------------------------------------------*/
 
+	MEM_ARENA_BLOCK *b;
+
+	if (!isnull(Mem_Arena) && !isnull(b = arena_block(Mem_Arena, block))) {
+		/* arena memory is released by Mem_ArenaRelease(); only the most
+		 * recent allocation can be reused right away */
+		if (b == Mem_Arena->head
+				&& (byte *) block - MEM_ARENA_ALIGN == arena_data(b) + b->last)
+			b->used = b->last;
+		return;
+	}
+
 #ifdef DEBUG_MEM_X
 	{
 		if (mem_SizeOf(block) > SizeOfMalloc)
@@ -253,6 +362,7 @@ void Mem_Free(void *block) {
 #endif
 
 #ifdef DEBUG_MEM
+	if (block != NULL) /* free(NULL) is valid */
 	{
 		assert(fValidPointer(block, sizeofBlock(block)));
 		memset( block, bGarbage, sizeofBlock(block));
@@ -308,6 +418,158 @@ void Mem_Copy(void *dest, const void *src, size_t n) {
 
 }
 
+/*****************************************************/
+void Mem_ArenaActivate(MEM_ARENA *arena) {
+	/*-------------------------------------------
+	 Allocate from arena on the calling thread until
+	 another arena is activated; NULL or an arena
+	 that is not in use restore allocations from the
+	 system.
+
+	 Memory must be freed while the arena that it
+	 came from is active.
+	 -------------------------------------------*/
+
+#ifndef DEBUG_MEM
+	Mem_Arena = (isnull(arena) || !arena->use) ? NULL : arena;
+#else
+	Mem_Arena = NULL;
+	(void) arena;
+#endif
+
+}
+
+/*****************************************************/
+void Mem_ArenaRelease(MEM_ARENA *arena) {
+	/*-------------------------------------------
+	 Free all memory of arena at once; pointers
+	 into the arena are invalid afterwards. The
+	 arena is empty and can be used again.
+	 -------------------------------------------*/
+
+	MEM_ARENA_BLOCK *b, *next;
+
+	for (b = arena->head; !isnull(b); b = next) {
+		next = b->next;
+		free(b);
+	}
+
+	arena->head = NULL;
+
+}
+
+/*****************************************************/
+void Mem_ArenaBlocks(const MEM_ARENA *arena,
+	void (*f)(const void *block, size_t size, void *data), void *data) {
+	/*-------------------------------------------
+	 Call f with the start and size in bytes (header
+	 and data) of each block of arena, e.g., to move
+	 the memory of a run to another NUMA node.
+	 -------------------------------------------*/
+
+	const MEM_ARENA_BLOCK *b;
+
+	for (b = arena->head; !isnull(b); b = b->next) {
+		f(b, arena_roundup(sizeof(MEM_ARENA_BLOCK)) + b->size, data);
+	}
+
+}
+
+/*****************************************************/
+void Mem_ArenaSave(const MEM_ARENA *arena, MEM_ARENA_IMAGE *image) {
+	/*-------------------------------------------
+	 Copy the memory in use of arena into image;
+	 the image is allocated from the system and
+	 released by Mem_ArenaFreeImage().
+
+	 The copies keep their addresses: an image can
+	 only be restored into the arena that it was
+	 taken from and only before that arena is
+	 released.
+	 -------------------------------------------*/
+
+	MEM_ARENA_BLOCK *b;
+	MEM_ARENA_COPY *c;
+	size_t n = 0;
+
+	for (b = arena->head; !isnull(b); b = b->next)
+		n++;
+
+	image->head = arena->head;
+	image->n_blocks = n;
+	image->copies = NULL;
+
+	if (n == 0)
+		return;
+
+	image->copies = (MEM_ARENA_COPY *) calloc(n, sizeof(MEM_ARENA_COPY));
+	if (image->copies == NULL )
+		LogError(logfp, LOGFATAL, "Out of memory in Mem_ArenaSave()");
+
+	for (b = arena->head, c = image->copies; !isnull(b); b = b->next, c++) {
+		c->b = b;
+		c->len = arena_roundup(sizeof(MEM_ARENA_BLOCK)) + b->used;
+		c->bytes = (byte *) malloc(c->len);
+		if (c->bytes == NULL ) {
+			Mem_ArenaFreeImage(image);
+			LogError(logfp, LOGFATAL, "Out of memory in Mem_ArenaSave()");
+		}
+		memcpy(c->bytes, b, c->len);
+	}
+
+}
+
+/*****************************************************/
+void Mem_ArenaRestore(MEM_ARENA *arena, const MEM_ARENA_IMAGE *image) {
+	/*-------------------------------------------
+	 Return arena to the state of image: blocks
+	 that were added after the image was taken are
+	 freed and the other blocks get their copied
+	 contents back.
+	 -------------------------------------------*/
+
+	MEM_ARENA_BLOCK *b, *next;
+	size_t i;
+
+	for (b = arena->head; b != image->head && !isnull(b); b = b->next)
+		;
+
+	if (b != image->head)
+		LogError(logfp, LOGFATAL, "Mem_ArenaRestore(): "
+				"image was not taken from this arena");
+
+	for (b = arena->head; b != image->head; b = next) {
+		next = b->next;
+		free(b);
+	}
+
+	for (i = 0; i < image->n_blocks; i++)
+		memcpy(image->copies[i].b, image->copies[i].bytes, image->copies[i].len);
+
+	arena->head = image->head;
+
+}
+
+/*****************************************************/
+void Mem_ArenaFreeImage(MEM_ARENA_IMAGE *image) {
+	/*-------------------------------------------
+	 Free the copies of image.
+	 -------------------------------------------*/
+
+	size_t i;
+
+	if (!isnull(image->copies)) {
+		for (i = 0; i < image->n_blocks; i++)
+			free(image->copies[i].bytes);
+		free(image->copies);
+	}
+
+	image->head = NULL;
+	image->n_blocks = 0;
+	image->copies = NULL;
+
+}
+
 /* ===============  end of block from gen_funcs.c ----------------- */
 /* ================ see also the end of this file ------------------ */
 
@@ -338,6 +600,13 @@ void Mem_Copy(void *dest, const void *src, size_t n) {
  was chosen because it is simple and easy to understand.
  ----------------------------------------------------------------*/
 
+/* The linked list was indeed too slow for runs over real inputs: every
+ * lookup scanned all blocks. The memory log is now a treap, i.e., a
+ * binary search tree ordered by block start whose shape is balanced
+ * (in expectation) by a priority that is a hash of the block start;
+ * lookups, insertions, and deletions take O(log n) steps.
+ */
+
 /* See memblock.h */
 
 /* -------------------------------------------------------------- *
@@ -345,10 +614,142 @@ void Mem_Copy(void *dest, const void *src, size_t n) {
  * -------------------------------------------------------------- */
 
 /* --  --  --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
- * pbiHead points to a singly linked list of debugging information
+ * pbiRoot points to the root of the tree of debugging information
  * for the memory manager.
  */
-static blockinfo *pbiHead = NULL;
+static blockinfo *pbiRoot = NULL;
+
+/* The memory log is shared by all threads (e.g., of batch mode);
+ * mutexLog serializes lookups and modifications of the tree. Pointers
+ * to a blockinfo stay valid until its block is freed.
+ */
+static pthread_mutex_t mutexLog = PTHREAD_MUTEX_INITIALIZER;
+
+/* --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
+ * uPriority returns the treap priority of a block: a hash
+ * of its start that mixes all bits (successive blocks from
+ * malloc() would otherwise degrade the tree into a list).
+ */
+static uint64_t uPriority(const blockinfo *pbi) {
+
+	uint64_t x = (uint64_t) (uintptr_t) pbi->pb;
+
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+
+	return x;
+}
+
+/* --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
+ * pbiInsert adds pbiNew to the (sub)tree pbi and returns
+ * the new root of the (sub)tree.
+ */
+static blockinfo *pbiInsert(blockinfo *pbi, blockinfo *pbiNew) {
+
+	blockinfo *pbiChild;
+
+	if (pbi == NULL)
+		return pbiNew;
+
+	if (fPtrLess(pbiNew->pb, pbi->pb)) {
+		pbiChild = pbi->pbiLeft = pbiInsert(pbi->pbiLeft, pbiNew);
+		if (uPriority(pbiChild) > uPriority(pbi)) { /* rotate right */
+			pbi->pbiLeft = pbiChild->pbiRight;
+			pbiChild->pbiRight = pbi;
+			pbi = pbiChild;
+		}
+	} else {
+		pbiChild = pbi->pbiRight = pbiInsert(pbi->pbiRight, pbiNew);
+		if (uPriority(pbiChild) > uPriority(pbi)) { /* rotate left */
+			pbi->pbiRight = pbiChild->pbiLeft;
+			pbiChild->pbiLeft = pbi;
+			pbi = pbiChild;
+		}
+	}
+
+	return pbi;
+}
+
+/* --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
+ * pbiJoin merges two treaps where all blocks of pbiLeft
+ * come before all blocks of pbiRight.
+ */
+static blockinfo *pbiJoin(blockinfo *pbiLeft, blockinfo *pbiRight) {
+
+	if (pbiLeft == NULL)
+		return pbiRight;
+	if (pbiRight == NULL)
+		return pbiLeft;
+
+	if (uPriority(pbiLeft) > uPriority(pbiRight)) {
+		pbiLeft->pbiRight = pbiJoin(pbiLeft->pbiRight, pbiRight);
+		return pbiLeft;
+	}
+
+	pbiRight->pbiLeft = pbiJoin(pbiLeft, pbiRight->pbiLeft);
+	return pbiRight;
+}
+
+/* --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
+ * pbiRemove unlinks the blockinfo of the block that starts
+ * at pb from the (sub)tree pbi and returns the new root of
+ * the (sub)tree; *ppbiFound is the unlinked blockinfo or
+ * NULL if there is no such block.
+ */
+static blockinfo *pbiRemove(blockinfo *pbi, byte *pb, blockinfo **ppbiFound) {
+
+	if (pbi == NULL)
+		return NULL;
+
+	if (fPtrEqual(pb, pbi->pb)) {
+		*ppbiFound = pbi;
+		return pbiJoin(pbi->pbiLeft, pbi->pbiRight);
+	}
+
+	if (fPtrLess(pb, pbi->pb))
+		pbi->pbiLeft = pbiRemove(pbi->pbiLeft, pb, ppbiFound);
+	else
+		pbi->pbiRight = pbiRemove(pbi->pbiRight, pb, ppbiFound);
+
+	return pbi;
+}
+
+/* --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
+ * The memory log is only modified with these two functions.
+ */
+static void LinkBlockInfo(blockinfo *pbi) {
+
+	pbi->pbiLeft = pbi->pbiRight = NULL;
+	pthread_mutex_lock(&mutexLog);
+	pbiRoot = pbiInsert(pbiRoot, pbi);
+	pthread_mutex_unlock(&mutexLog);
+}
+
+static blockinfo *pbiUnlinkBlockInfo(byte *pb) {
+
+	blockinfo *pbi = NULL;
+
+	pthread_mutex_lock(&mutexLog);
+	pbiRoot = pbiRemove(pbiRoot, pb, &pbi);
+	pthread_mutex_unlock(&mutexLog);
+	return pbi;
+}
+
+/* --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
+ * ForEachBlockInfo calls f for every blockinfo of the
+ * (sub)tree pbi; f must not modify the memory log.
+ */
+static void ForEachBlockInfo(blockinfo *pbi, void (*f)(blockinfo *)) {
+
+	while (pbi != NULL) {
+		ForEachBlockInfo(pbi->pbiLeft, f);
+		f(pbi);
+		pbi = pbi->pbiRight;
+	}
+}
 
 /* --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
  * pbiGetBlockInfo searches the memory log to find the block
@@ -367,16 +768,26 @@ static blockinfo *pbiHead = NULL;
 
 static blockinfo *pbiGetBlockInfo(byte *pb) {
 
-	blockinfo *pbi;
+	blockinfo *pbi, *pbiFloor = NULL;
 
-	for (pbi = pbiHead; pbi != NULL; pbi = pbi->pbiNext) {
-		byte *pbStart = pbi->pb; /* for readability */
-		byte *pbEnd = pbi->pb + pbi->size - 1;
+	pthread_mutex_lock(&mutexLog);
 
-		if (fPtrGrtrEq(pb, pbStart) && fPtrLessEq(pb, pbEnd))
-		break;
+	/* find the block with the largest start that is not after pb */
+	for (pbi = pbiRoot; pbi != NULL;) {
+		if (fPtrLess(pb, pbi->pb)) {
+			pbi = pbi->pbiLeft;
+		} else {
+			pbiFloor = pbi;
+			pbi = pbi->pbiRight;
+		}
 	}
 
+	pbi = pbiFloor;
+	if (pbi != NULL && fPtrGrtr(pb, pbi->pb + pbi->size - 1))
+		pbi = NULL; /* pb is after the end of that block */
+
+	pthread_mutex_unlock(&mutexLog);
+
 	/* Couldn't find pointer?  Is it (a) garbage? (b) pointing
 	 * to a block that was freed? or (c) pointing to a block
 	 * that moved when it was resized by fResizeMemory?
@@ -414,8 +825,7 @@ flag fCreateBlockInfo(byte *pbNew, size_t sizeNew) {
 	if (pbi != NULL) {
 		pbi->pb = pbNew;
 		pbi->size = sizeNew;
-		pbi->pbiNext = pbiHead;
-		pbiHead = pbi;
+		LinkBlockInfo(pbi);
 	}
 
 	return (flag)(pbi != NULL);
@@ -432,21 +842,9 @@ flag fCreateBlockInfo(byte *pbNew, size_t sizeNew) {
 
 void FreeBlockInfo( byte *pbToFree) {
 
-	blockinfo *pbi, *pbiPrev;
-
-	pbiPrev = NULL;
-
-	for (pbi = pbiHead; pbi != NULL; pbi = pbi->pbiNext) {
-		if (fPtrEqual(pbi->pb, pbToFree)) {
-			if (pbiPrev == NULL)
-			pbiHead = pbi->pbiNext;
-			else
-			pbiPrev->pbiNext = pbi->pbiNext;
+	blockinfo *pbi;
 
-			break;
-		}
-		pbiPrev = pbi;
-	}
+	pbi = pbiUnlinkBlockInfo(pbToFree);
 #ifndef RSOILWAT
 	/* If pbi is NULL, then pbiToFree is invalid */
 	assert(pbi != NULL);
@@ -474,12 +872,15 @@ void UpdateBlockInfo(byte *pbOld, byte *pbNew, size_t sizeNew) {
 #ifndef RSOILWAT
 	assert(pbNew != NULL && sizeNew > 0);
 #endif
-	pbi = pbiGetBlockInfo(pbOld);
+	pbi = pbiUnlinkBlockInfo(pbOld);
 #ifndef RSOILWAT
-	assert(pbOld == pbi->pb);
+	/* If pbi is NULL, then pbOld is not the start of a block */
+	assert(pbi != NULL);
 #endif
+	/* the tree is ordered by block start */
 	pbi->pb = pbNew;
 	pbi->size = sizeNew;
+	LinkBlockInfo(pbi);
 }
 
 /* --  --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
@@ -513,14 +914,16 @@ size_t sizeofBlock(byte *pb) {
  * Mark all blocks in the memory log as being unreferenced.
  */
 
+static void ClearMemoryRef(blockinfo *pbi) {
+
+	pbi->fReferenced = swFALSE;
+}
+
 void ClearMemoryRefs(void) {
 
-	blockinfo *pbi;
-	int i = 0;
-	for ( pbi = pbiHead; pbi != NULL; pbi = pbi->pbiNext) {
-		pbi->fReferenced = swFALSE;
-		i++;
-	}
+	pthread_mutex_lock(&mutexLog);
+	ForEachBlockInfo(pbiRoot, ClearMemoryRef);
+	pthread_mutex_unlock(&mutexLog);
 
 }
 
@@ -547,32 +950,33 @@ void NoteMemoryRef(void *pv) {
  * marked with a call to NoteMemoryRef.  If this function finds
  * an unmarked block, it asserts.
  */
-void CheckMemoryRefs(void) {
+static void CheckMemoryRef(blockinfo *pbi) {
 
-	blockinfo *pbi;
-	int i=0;
-
-	for (pbi = pbiHead; pbi != NULL; pbi = pbi->pbiNext) {
-		/* a simple check for block integrity.  If this
-		 * assert fires, it meanse that something is wrong
-		 * with the debug code that manages blockinfo or,
-		 * possibly, that a wild memory store has trashed the
-		 * data structure.  Either way, it's a bug.
-		 */
+	/* a simple check for block integrity.  If this
+	 * assert fires, it meanse that something is wrong
+	 * with the debug code that manages blockinfo or,
+	 * possibly, that a wild memory store has trashed the
+	 * data structure.  Either way, it's a bug.
+	 */
 #ifndef RSOILWAT
-		assert(pbi->pb != NULL && pbi->size > 0);
+	assert(pbi->pb != NULL && pbi->size > 0);
 #endif
-		/* swprintf("i=%d, size=%d, p=%p\n", ++i, pbi->size, pbi->pb); */
 
-		/* A check for lost or leaky memory.  if this assert
-		 * fires, it means that the app has either lost track
-		 * of this block or that not all global pointers have
-		 * been accounted for with NoteMemoryRef.
-		 */
+	/* A check for lost or leaky memory.  if this assert
+	 * fires, it means that the app has either lost track
+	 * of this block or that not all global pointers have
+	 * been accounted for with NoteMemoryRef.
+	 */
 #ifndef RSOILWAT
-		assert(pbi->fReferenced);
+	assert(pbi->fReferenced);
 #endif
-	}
+}
+
+void CheckMemoryRefs(void) {
+
+	pthread_mutex_lock(&mutexLog);
+	ForEachBlockInfo(pbiRoot, CheckMemoryRef);
+	pthread_mutex_unlock(&mutexLog);
 }
 
 /* --  --  --  --  --  --  --  --  --  --  --  --  --  --  -- *
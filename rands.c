@@ -13,7 +13,9 @@
 
 
 #ifndef RSOILWAT
-  uint64_t stream = 1u; //stream id. this is given out to a pcg_rng then incremented.
+  // stream id: this is given out to a pcg_rng then (atomically) incremented;
+  // generators can be seeded from several threads, e.g., see `SW_Batch.c`
+  uint64_t stream = 1u;
 
 #else
   // R-API requires that we use it's own random number implementation
@@ -27,11 +29,45 @@
 
 
 
+#ifndef RSOILWAT
+/** Mix the bits of `x` (the finalizer of splitmix64) so that nearby
+    values result in unrelated seeds */
+static uint64_t mix_bits(uint64_t x) {
+  x += 0x9e3779b97f4a7c15u;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9u;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebu;
+  return x ^ (x >> 31);
+}
+
+/** A seed from the system clock (with nanoseconds, if available) that
+    differs among streams even if they were seeded at the same time */
+static uint64_t clock_seed(uint64_t stream_id) {
+  uint64_t t;
+
+  #if defined(CLOCK_REALTIME)
+    struct timespec ts;
+
+    if (0 == clock_gettime(CLOCK_REALTIME, &ts)) {
+      t = (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+    } else {
+      t = (uint64_t) time(NULL);
+    }
+  #else
+    t = (uint64_t) time(NULL);
+  #endif
+
+  return mix_bits(t ^ mix_bits(stream_id));
+}
+#endif
+
+
 /*****************************************************/
 /**
   \brief Sets the random number seed.
 
-  \param seed The initial state of the system; if 0 then use system time.
+  \param seed The initial state of the system; if 0 then use system time
+    (mixed with the stream id so that generators seeded at the same
+    time differ).
   \param[in,out] pcg_rng The random number generator to set.
 
   \note If using this function with STEPWAT2, then call RandSeed() only once
@@ -43,20 +79,19 @@
 void RandSeed(signed long seed, pcg32_random_t* pcg_rng) {
 //we don't need to set a random seed if RSOILWAT is used
 #ifndef RSOILWAT
+  //Increment the stream so no two generators have the same sequence.
+  uint64_t s = __atomic_fetch_add(&stream, 1u, __ATOMIC_RELAXED);
 
   if (seed == 0) {
     //seed with a random value. Uses the system time to generate
     //a pseudo-random seed.
-    pcg32_srandom_r(pcg_rng, time(NULL), stream);
+    pcg32_srandom_r(pcg_rng, clock_seed(s), s);
   }
   else {
     //Seed with a specific value.
-    pcg32_srandom_r(pcg_rng, (int) seed, stream);
+    pcg32_srandom_r(pcg_rng, (int) seed, s);
   }
 
-  //Increment the stream so no two generators have the same sequence.
-  stream++;
-
 #else
   // silence compile warnings [-Wunused-parameter]
   if (pcg_rng == NULL && seed > 0) {}
@@ -66,6 +101,34 @@ void RandSeed(signed long seed, pcg32_random_t* pcg_rng) {
 
 
 
+/*****************************************************/
+/**
+  \brief Sets the random number seed and the stream of a generator.
+
+  Unlike RandSeed(), the sequence of a generator depends only on `seed` and
+  `stream_id` (and not on how many generators were seeded before) which
+  makes, e.g., ensembles of many sites and replicates reproducible
+  independently of the order (or threads) in which they are simulated.
+
+  \param seed The initial state of the system.
+  \param stream_id The stream, i.e., `initseq` of `pcg32_srandom_r()`;
+    generators with different `stream_id` (in the lower 63 bits) produce
+    different sequences even if they use the same `seed`.
+  \param[in,out] pcg_rng The random number generator to set.
+*/
+void RandSeedStream(uint64_t seed, uint64_t stream_id, pcg32_random_t* pcg_rng) {
+#ifndef RSOILWAT
+  pcg32_srandom_r(pcg_rng, seed, stream_id);
+
+#else
+  // silence compile warnings [-Wunused-parameter]
+  if (pcg_rng == NULL && seed > 0 && stream_id > 0) {}
+
+#endif
+}
+
+
+
 /*****************************************************/
 /**
   \brief A pseudo-random number from the uniform distribution.
@@ -300,9 +363,9 @@ double RandNorm(double mean, double stddev, pcg32_random_t* pcg_rng) {
 	double res;
 
 	#ifndef RSOILWAT
-		static short set = 0;
+		static SW_THREAD_LOCAL short set = 0;
 
-		static double v1, v2, r, fac, gset, gasdev;
+		static SW_THREAD_LOCAL double v1, v2, r, fac, gset, gasdev;
 
 		if (!set) {
 			do {
@@ -333,6 +396,60 @@ double RandNorm(double mean, double stddev, pcg32_random_t* pcg_rng) {
 	return res;
 }
 
+/**
+  \brief Fill an array with pseudo-random numbers from a normal distribution.
+
+  Uniform variates are drawn first and then transformed in pairs by the
+  Box-Muller method in a separate loop without branches (which compilers
+  can vectorize). The result depends only on the state of `pcg_rng`;
+  unlike RandNorm(), no variate is carried over between calls.
+
+  \param n Number of values to generate.
+  \param mean The mean of the distribution.
+  \param stddev Standard deviation of the distribution.
+  \param[out] res Upon return this array holds `n` random values.
+  \param[in,out] *pcg_rng The random number generator to use.
+*/
+void RandNormList(long n, double mean, double stddev, double res[],
+  pcg32_random_t* pcg_rng) {
+
+  long i;
+
+  #ifndef RSOILWAT
+    const double twopi = 6.283185307179586476925286766559;
+    long n2 = n - n % 2;
+    double r, t, u1, u2;
+
+    // pairs of uniform variates: u1 in (0, 1] and u2 in [0, 1)
+    for (i = 0; i < n2; i++) {
+      res[i] = RandUni(pcg_rng);
+    }
+
+    for (i = 0; i < n2; i += 2) {
+      r = sqrt(-2. * log(1. - res[i]));
+      t = twopi * res[i + 1];
+      res[i] = mean + stddev * r * cos(t);
+      res[i + 1] = mean + stddev * r * sin(t);
+    }
+
+    if (n2 < n) {
+      u1 = RandUni(pcg_rng);
+      u2 = RandUni(pcg_rng);
+      res[n2] = mean + stddev * sqrt(-2. * log(1. - u1)) * cos(twopi * u2);
+    }
+
+  #else
+    if (pcg_rng == NULL) {} // silence compile warnings [-Wunused-parameter]
+
+    GetRNGstate();
+    for (i = 0; i < n; i++) {
+      res[i] = rnorm(mean, stddev);
+    }
+    PutRNGstate();
+
+  #endif
+}
+
 /**
   \brief Generate a beta random variate.
 
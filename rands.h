@@ -7,6 +7,8 @@
  */
 /* Chris Bennett @ LTER-CSU 6/15/2000            */
 /*    - 5/19/2001 - split from gen_funcs.c       */
+/*    - 2026-10-14 - added RandSeedStream() and  */
+/*      RandNormList()                           */
 
 #ifndef RANDS_H
 
@@ -29,10 +31,13 @@ typedef long RandListType;
  ***************************************************/
 
 void RandSeed(signed long seed, pcg32_random_t* pcg_rng);
+void RandSeedStream(uint64_t seed, uint64_t stream_id, pcg32_random_t* pcg_rng);
 double RandUni(pcg32_random_t* pcg_rng);
 int RandUniIntRange(const long first, const long last, pcg32_random_t* pcg_rng);
 float RandUniFloatRange(const float min, const float max, pcg32_random_t* pcg_rng);
 double RandNorm(double mean, double stddev, pcg32_random_t* pcg_rng);
+void RandNormList(long n, double mean, double stddev, double res[],
+  pcg32_random_t* pcg_rng);
 void RandUniList(long, long, long, RandListType[], pcg32_random_t* pcg_rng);
 float RandBeta(float aa, float bb, pcg32_random_t* pcg_rng);
 
@@ -0,0 +1,314 @@
+/********************************************************/
+/********************************************************/
+/*  Source file: sw_hdf5_readback.c
+ *  Type: test program
+ *  Application: SOILWAT - soilwater dynamics simulator
+ *  Purpose: Read back the HDF5 output of a site (option `-o h5`) and
+ *           compare it with the csv output files of the same run, see
+ *           `make test_hdf5`.
+ *
+ *           Usage: sw_test_hdf5 <h5 file> <site> <csv file> [<csv file> ...]
+ *
+ *           Each data column `[KEY]_[column]` of a csv file is compared
+ *           with the dataset `/[period]/[KEY]` (see `SW_Output_outhdf.h`);
+ *           values must agree within the digits of the csv files. Exits
+ *           with 0 if all values agree and if at least one value was
+ *           compared.
+ *
+ *  History:
+ *     (2026-10-15) -- INITIAL CODING - ag
+ */
+/********************************************************/
+/********************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <math.h>
+#include <hdf5.h>
+
+#define NAMELEN 64
+#define MAXLINE (1 << 16)
+#define MAXCOLS 1024
+
+/** The values of a site in a dataset `site x time x layer x variable` */
+typedef struct {
+	char name[NAMELEN];
+	hsize_t n_time, n_layers, n_vars;
+	char (*vars)[NAMELEN];
+	double *x;
+} DSET;
+
+static unsigned long n_checked = 0, n_failed = 0;
+
+/** Index of a site in the dataset `/site`; -1 if not found */
+static long find_site(hid_t file, const char *site) {
+	hid_t dset = H5Dopen2(file, "/site", H5P_DEFAULT), type, space;
+	hsize_t n = 0;
+	size_t len;
+	char *s;
+	long i = -1, k;
+
+	if (dset < 0) {
+		return -1;
+	}
+
+	type = H5Dget_type(dset);
+	space = H5Dget_space(dset);
+	len = H5Tget_size(type);
+	H5Sget_simple_extent_dims(space, &n, NULL);
+
+	s = (char *) calloc(n * len, 1);
+	if (s != NULL && H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, s) >= 0) {
+		for (k = 0; k < (long) n && i < 0; k++) {
+			if (0 == strncmp(s + k * len, site, len)) {
+				i = k;
+			}
+		}
+	}
+
+	free(s);
+	H5Sclose(space);
+	H5Tclose(type);
+	H5Dclose(dset);
+
+	return i;
+}
+
+/** Read the values of site `isite` of dataset `/period/key` */
+static int read_dset(hid_t file, const char *period, const char *key,
+	hsize_t isite, DSET *d) {
+
+	char path[2 * NAMELEN + 2];
+	hid_t dset, attr, type, fspace, mspace, aspace;
+	hsize_t dims[4], start[4] = {0, 0, 0, 0}, count[4];
+	herr_t status;
+
+	snprintf(path, sizeof path, "/%s/%s", period, key);
+	if (H5Lexists(file, period, H5P_DEFAULT) <= 0 ||
+		H5Lexists(file, path, H5P_DEFAULT) <= 0 ||
+		(dset = H5Dopen2(file, path, H5P_DEFAULT)) < 0) {
+		return -1;
+	}
+
+	fspace = H5Dget_space(dset);
+	H5Sget_simple_extent_dims(fspace, dims, NULL);
+	strcpy(d->name, key);
+	d->n_time = dims[1];
+	d->n_layers = dims[2];
+	d->n_vars = dims[3];
+	d->vars = calloc(d->n_vars, NAMELEN);
+	d->x = (double *) malloc(dims[1] * dims[2] * dims[3] * sizeof(double));
+
+	// variable names
+	attr = H5Aopen(dset, "variables", H5P_DEFAULT);
+	type = H5Tcopy(H5T_C_S1);
+	H5Tset_size(type, NAMELEN);
+	status = (attr < 0) ? -1 : H5Aread(attr, type, d->vars);
+	if (attr >= 0) {
+		aspace = H5Aget_space(attr);
+		status = (H5Sget_simple_extent_npoints(aspace) == (hssize_t) d->n_vars) ?
+			status : -1;
+		H5Sclose(aspace);
+		H5Aclose(attr);
+	}
+	H5Tclose(type);
+
+	// values of the site
+	start[0] = isite;
+	count[0] = 1;
+	count[1] = dims[1];
+	count[2] = dims[2];
+	count[3] = dims[3];
+	mspace = H5Screate_simple(4, count, NULL);
+	if (status >= 0) {
+		H5Sselect_hyperslab(fspace, H5S_SELECT_SET, start, NULL, count, NULL);
+		status = H5Dread(dset, H5T_NATIVE_DOUBLE, mspace, fspace, H5P_DEFAULT, d->x);
+	}
+
+	H5Sclose(mspace);
+	H5Sclose(fspace);
+	H5Dclose(dset);
+
+	return (status < 0) ? -1 : 0;
+}
+
+/** Split a csv column (without its key) into variable and layer (base0),
+  see `split_colname()` of `SW_Output_outhdf.c` */
+static void split_column(const char *name, const char *key, char *var,
+	hsize_t *layer) {
+
+	const char *s = strstr(name, "Lyr_"), *d;
+	size_t n = strlen(name);
+
+	*layer = 0;
+	if (s != NULL) {
+		for (d = s + 4; isdigit((unsigned char) *d); d++);
+		if ('\0' == *d && d > s + 4) {
+			*layer = strtoul(s + 4, NULL, 10) - 1;
+			n = (size_t) (s - name);
+			if (n > 0 && '_' == name[n - 1]) {
+				n--;
+			}
+		}
+	}
+	if (0 == n) {
+		name = key;
+		n = strlen(key);
+	}
+
+	n = (n < NAMELEN) ? n : NAMELEN - 1;
+	memcpy(var, name, n);
+	var[n] = '\0';
+}
+
+/** Split a csv line in place; returns the number of fields */
+static int split_line(char *line, char **fields) {
+	int n = 0;
+	char *p = line;
+
+	line[strcspn(line, "\r\n")] = '\0';
+	while (n < MAXCOLS) {
+		fields[n++] = p;
+		if (NULL == (p = strchr(p, ','))) {
+			break;
+		}
+		*p++ = '\0';
+	}
+
+	return n;
+}
+
+/** Compare a csv output file with the datasets of its output period */
+static int check_csv(hid_t file, hsize_t isite, const char *fname) {
+	static char line[MAXLINE], header[MAXLINE];
+	char *cols[MAXCOLS], *fields[MAXCOLS], key[NAMELEN], var[NAMELEN];
+	const char *period;
+	DSET dsets[64];
+	int n_dsets = 0, ncol, nt, c, k, v, idset[MAXCOLS], ivar[MAXCOLS];
+	hsize_t layer[MAXCOLS], row = 0;
+	double x, y;
+	FILE *f = fopen(fname, "r");
+
+	if (f == NULL || NULL == fgets(header, sizeof header, f)) {
+		fprintf(stderr, "%s: cannot read\n", fname);
+		return -1;
+	}
+
+	ncol = split_line(header, cols);
+	nt = (ncol > 1 && (0 == strcmp(cols[1], "Day") || 0 == strcmp(cols[1], "Week") ||
+		0 == strcmp(cols[1], "Month"))) ? 2 : 1;
+	period = (2 == nt) ? cols[1] : "Year";
+
+	// dataset and variable of each column
+	for (c = nt; c < ncol; c++) {
+		const char *u = strchr(cols[c], '_');
+		size_t n = (u == NULL) ? strlen(cols[c]) : (size_t) (u - cols[c]);
+
+		snprintf(key, sizeof key, "%.*s", (int) n, cols[c]);
+		for (k = 0; k < n_dsets && 0 != strcmp(dsets[k].name, key); k++);
+
+		if (k == n_dsets) {
+			if (n_dsets == 64 || 0 != read_dset(file, period, key, isite, &dsets[k])) {
+				fprintf(stderr, "%s: no dataset /%s/%s\n", fname, period, key);
+				fclose(f);
+				return -1;
+			}
+			n_dsets++;
+		}
+
+		split_column((u == NULL) ? "" : u + 1, key, var, &layer[c]);
+		for (v = 0; v < (int) dsets[k].n_vars && 0 != strcmp(dsets[k].vars[v], var); v++);
+
+		if (v == (int) dsets[k].n_vars || layer[c] >= dsets[k].n_layers) {
+			fprintf(stderr, "%s: column %s is not in /%s/%s\n", fname, cols[c],
+				period, key);
+			fclose(f);
+			return -1;
+		}
+
+		idset[c] = k;
+		ivar[c] = v;
+	}
+
+	// values of each row
+	while (NULL != fgets(line, sizeof line, f)) {
+		if (split_line(line, fields) != ncol) {
+			continue;
+		}
+
+		for (c = nt; c < ncol; c++) {
+			DSET *d = &dsets[idset[c]];
+
+			if (row >= d->n_time) {
+				fprintf(stderr, "%s: more rows than /%s/%s\n", fname, period, d->name);
+				n_failed++;
+				break;
+			}
+
+			x = strtod(fields[c], NULL);
+			y = d->x[(row * d->n_layers + layer[c]) * d->n_vars + ivar[c]];
+			n_checked++;
+
+			if (!(fabs(x - y) <= 1e-6 * (1. + fabs(x)))) {
+				if (n_failed++ < 10) {
+					fprintf(stderr, "%s: row %lu, %s: csv %s, h5 %.9g\n", fname,
+						(unsigned long) row + 1, cols[c], fields[c], y);
+				}
+			}
+		}
+
+		row++;
+	}
+
+	for (k = 0; k < n_dsets; k++) {
+		if (row != dsets[k].n_time) {
+			fprintf(stderr, "%s: %lu rows, /%s/%s has %lu time steps\n", fname,
+				(unsigned long) row, period, dsets[k].name,
+				(unsigned long) dsets[k].n_time);
+			n_failed++;
+		}
+		free(dsets[k].vars);
+		free(dsets[k].x);
+	}
+
+	fclose(f);
+	return 0;
+}
+
+int main(int argc, char **argv) {
+	hid_t file;
+	long isite;
+	int i, status = 0;
+
+	if (argc < 4) {
+		fprintf(stderr, "Usage: %s <h5 file> <site> <csv file> [<csv file> ...]\n",
+			argv[0]);
+		return 2;
+	}
+
+	if ((file = H5Fopen(argv[1], H5F_ACC_RDONLY, H5P_DEFAULT)) < 0) {
+		fprintf(stderr, "%s: cannot open\n", argv[1]);
+		return 1;
+	}
+
+	if ((isite = find_site(file, argv[2])) < 0) {
+		fprintf(stderr, "%s: no site '%s' in /site\n", argv[1], argv[2]);
+		status = 1;
+	}
+
+	for (i = 3; i < argc && 0 == status; i++) {
+		status = (0 == check_csv(file, (hsize_t) isite, argv[i])) ? 0 : 1;
+	}
+
+	H5Fclose(file);
+
+	if (0 == status && (n_failed > 0 || 0 == n_checked)) {
+		status = 1;
+	}
+
+	printf("%s: %lu values compared, %lu differ\n", argv[1], n_checked, n_failed);
+
+	return status;
+}
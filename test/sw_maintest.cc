@@ -34,6 +34,7 @@
 #include "../SW_Sky.h"
 
 #include "../SW_Control.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
@@ -49,10 +50,9 @@ const char * masterfile_test = "files.in"; // relative to 'dir_test'
 
 // Global variables which are defined in SW_Main_lib.c:
 // We need to redefine them here because they are not included in the library
-char inbuf[MAX_FILENAMESIZE];
-char errstr[MAX_ERROR];
-FILE *logfp;
-int logged;
+SW_THREAD_LOCAL char errstr[MAX_ERROR];
+SW_THREAD_LOCAL FILE *logfp;
+SW_THREAD_LOCAL int logged;
 Bool QuietMode, EchoInits;
 char _firstfile[MAX_FILENAMESIZE];
 
@@ -83,7 +83,7 @@ int main(int argc, char **argv) {
   res = RUN_ALL_TESTS();
 
   //--- Take down SOILWAT2 variables
-  SW_CTL_clear_model(swTRUE); // de-allocate all memory
+  SW_CTL_clear_model(SW_CurrentRun, swTRUE); // de-allocate all memory
 
   //--- Return output of 'RUN_ALL_TESTS()', see https://github.com/google/googletest/blob/master/googletest/docs/FAQ.md#my-compiler-complains-about-ignoring-return-value-when-i-call-run_all_tests-why
   return res;
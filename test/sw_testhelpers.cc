@@ -33,22 +33,21 @@
 #include "../SW_Markov.h"
 #include "../SW_Sky.h"
 #include "../SW_Control.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
 extern char _firstfile[];
-extern SW_SITE SW_Site;
 
-extern SW_MODEL SW_Model;
 
 /** Initialize SOILWAT2 variables and read values from example input file
  */
 void Reset_SOILWAT2_after_UnitTest(void) {
-  SW_CTL_clear_model(swFALSE);
+  SW_CTL_clear_model(SW_CurrentRun, swFALSE);
 
-  SW_CTL_setup_model(_firstfile);
-  SW_CTL_read_inputs_from_disk();
-  SW_CTL_init_run();
+  SW_CTL_setup_model(SW_CurrentRun, _firstfile);
+  SW_CTL_read_inputs_from_disk(SW_CurrentRun);
+  SW_CTL_init_run(SW_CurrentRun);
 
 
   // Next two function calls will require SW_Output.c
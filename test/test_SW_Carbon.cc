@@ -34,13 +34,11 @@
 #include "../SW_Weather.h"
 #include "../SW_Markov.h"
 #include "../SW_Sky.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
 
-extern SW_CARBON SW_Carbon;
-extern SW_MODEL SW_Model;
-extern SW_VEGPROD SW_VegProd;
 
 
 
@@ -53,6 +51,7 @@ namespace {
   TEST(CarbonTest, Constructor) {
     int x;
 
+    SW_CBN_deconstruct();
     SW_CBN_construct();
 
     // Test type (and existence)
@@ -70,6 +69,7 @@ namespace {
     double sum_CO2;
 
     // Test if CO2-effects are turned off -> no CO2 concentration data are read from file
+    SW_CBN_deconstruct();
     SW_CBN_construct();
     c->use_wue_mult = 0;
     c->use_bio_mult = 0;
@@ -83,6 +83,7 @@ namespace {
     EXPECT_DOUBLE_EQ(sum_CO2, 0.);
 
     // Test if CO2-effects are turned on -> CO2 concentration data are read from file
+    SW_CBN_deconstruct();
     SW_CBN_construct();
     strcpy(c->scenario, "RCP85");
     c->use_wue_mult = 1;
@@ -105,6 +106,7 @@ namespace {
     TimeInt year;
     int k;
 
+    SW_CBN_deconstruct();
     SW_CBN_construct();
     strcpy(c->scenario, "RCP85");
     c->use_wue_mult = 1;
@@ -115,9 +117,14 @@ namespace {
     SW_CBN_init_run();
 
     for (year = SW_Model.startyr + SW_Model.addtl_yr; year <= simendyr; year++) {
+      SW_Model.simyear = year;
+      SW_CBN_new_year();
+
       ForEachVegType(k) {
-        EXPECT_GT(v->veg[k].co2_multipliers[BIO_INDEX][year], 0.);
-        EXPECT_GT(v->veg[k].co2_multipliers[WUE_INDEX][year], 0.);
+        EXPECT_GT(v->veg[k].co2_multipliers[BIO_INDEX], 0.);
+        EXPECT_GT(v->veg[k].co2_multipliers[WUE_INDEX], 0.);
+        EXPECT_DOUBLE_EQ(v->veg[k].co2_multipliers[BIO_INDEX],
+          v->veg[k].co2_bio_coeff1 * pow(c->ppm[year], v->veg[k].co2_bio_coeff2));
       }
     }
 
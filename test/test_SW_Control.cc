@@ -0,0 +1,678 @@
+#include "gtest/gtest.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Files.h"
+#include "../SW_Site.h"
+#include "../SW_Model.h"
+#include "../SW_SoilWater.h"
+#include "../SW_Weather.h"
+#include "../SW_VegProd.h"
+#include "../SW_Sky.h"
+#include "../SW_Carbon.h"
+#include "../SW_Control.h"
+#include "../SW_Flow.h"
+#include "../SW_Flow_lanes.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+extern char _firstfile[];
+
+
+namespace {
+  // Summary of a completed simulation run
+  typedef struct {
+    TimeInt year;
+    RealD swcBulk[MAX_LAYERS];
+    RealD snowpack;
+    RealD aet;
+  } RunSummary;
+
+  // Collect summary of the currently active simulation run
+  static void summarize_current_run(RunSummary *res) {
+    LyrIndex i;
+
+    res->year = SW_Model.year;
+    ForEachSoilLayer(i) {
+      res->swcBulk[i] = SW_Soilwat.swcBulk[Today][i];
+    }
+    res->snowpack = SW_Soilwat.snowpack[Today];
+    res->aet = SW_Soilwat.aet;
+  }
+
+  // Simulate a complete, independent run from the example inputs
+  static void simulate_new_run(RunSummary *res, Bool preload_weather) {
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "simulate_new_run");
+
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_Weather.preload_all_years = preload_weather;
+    SW_CTL_init_run(sw);
+    SW_CTL_main(sw);
+
+    summarize_current_run(res);
+
+    SW_CTL_clear_model(sw, swTRUE);
+    Mem_Free(sw);
+    SW_CTL_activate_run(NULL);
+  }
+
+
+  // Independent runs in one address space produce the same results
+  TEST(SWControlTest, IndependentRuns) {
+    RunSummary ref, res1, res2, ref_default;
+    LyrIndex i, n_layers = SW_Site.n_layers;
+
+    summarize_current_run(&ref_default);
+
+    // Reference: a run on the main thread
+    simulate_new_run(&ref, swFALSE);
+
+    // Two runs on their own threads
+    std::thread t1(simulate_new_run, &res1, swFALSE);
+    std::thread t2(simulate_new_run, &res2, swFALSE);
+    t1.join();
+    t2.join();
+
+    EXPECT_EQ(ref.year, res1.year);
+    EXPECT_EQ(ref.year, res2.year);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res1.snowpack);
+    EXPECT_DOUBLE_EQ(ref.aet, res2.aet);
+
+    for (i = 0; i < n_layers; i++) {
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res1.swcBulk[i]);
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res2.swcBulk[i]);
+    }
+
+    // The default run of this thread was not affected by the other runs
+    EXPECT_EQ(ref_default.year, SW_Model.year);
+    EXPECT_DOUBLE_EQ(ref_default.aet, SW_Soilwat.aet);
+  }
+
+
+  // Preloading the weather of all years does not change the simulation
+  TEST(SWControlTest, PreloadWeather) {
+    RunSummary ref, res;
+    LyrIndex i, n_layers = SW_Site.n_layers;
+
+    simulate_new_run(&ref, swFALSE);
+    simulate_new_run(&res, swTRUE);
+
+    EXPECT_EQ(ref.year, res.year);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res.snowpack);
+    EXPECT_DOUBLE_EQ(ref.aet, res.aet);
+
+    for (i = 0; i < n_layers; i++) {
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res.swcBulk[i]);
+    }
+  }
+
+
+  // A run with an arena produces the same results and a full reset frees
+  // all of its allocations at once
+  TEST(SWControlTest, RunArena) {
+    RunSummary ref, res;
+    LyrIndex i, n_layers = SW_Site.n_layers;
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "RunArena");
+
+    simulate_new_run(&ref, swFALSE);
+
+    sw->Arena.use = swTRUE;
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_CTL_init_run(sw);
+    SW_CTL_main(sw);
+    summarize_current_run(&res);
+    #ifndef DEBUG_MEM
+    EXPECT_TRUE(NULL != sw->Arena.head); // no arena under DEBUG_MEM
+    #endif
+
+    SW_CTL_clear_model(sw, swTRUE);
+    EXPECT_TRUE(NULL == sw->Arena.head);
+
+    SW_CTL_activate_run(NULL);
+    Mem_Free(sw);
+
+    EXPECT_EQ(ref.year, res.year);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res.snowpack);
+    EXPECT_DOUBLE_EQ(ref.aet, res.aet);
+
+    for (i = 0; i < n_layers; i++) {
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res.swcBulk[i]);
+    }
+  }
+
+
+  // A run that is restored from an image of its prepared state produces
+  // the same results as a run that reads and initializes its inputs
+  TEST(SWControlTest, SaveRestoreRun) {
+    RunSummary ref, res1, res2;
+    LyrIndex i, n_layers = SW_Site.n_layers;
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "SaveRestoreRun");
+    SW_RUN_SNAPSHOT snap;
+
+    #ifdef DEBUG_MEM
+    Mem_Free(sw);
+    return; // no arena under DEBUG_MEM
+    #endif
+
+    simulate_new_run(&ref, swFALSE);
+
+    sw->Arena.use = swTRUE;
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_CTL_init_run(sw);
+    SW_CTL_save_run(sw, &snap);
+
+    SW_CTL_main(sw);
+    summarize_current_run(&res1);
+
+    // the second simulation starts from the prepared state, too
+    SW_CTL_restore_run(sw, &snap);
+    SW_CTL_main(sw);
+    summarize_current_run(&res2);
+
+    SW_CTL_free_snapshot(&snap);
+    SW_CTL_clear_model(sw, swTRUE);
+    SW_CTL_activate_run(NULL);
+    Mem_Free(sw);
+
+    EXPECT_EQ(ref.year, res1.year);
+    EXPECT_EQ(ref.year, res2.year);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res1.snowpack);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res2.snowpack);
+    EXPECT_DOUBLE_EQ(ref.aet, res2.aet);
+
+    for (i = 0; i < n_layers; i++) {
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res1.swcBulk[i]);
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res2.swcBulk[i]);
+    }
+  }
+
+
+  // Scenarios that continue from a checkpoint at the end of a year produce
+  // the same results as a run without checkpoint
+  TEST(SWControlTest, ForkFromCheckpoint) {
+    RunSummary ref, res1, res2;
+    LyrIndex i, n_layers = SW_Site.n_layers;
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "ForkFromCheckpoint");
+    SW_RUN_SNAPSHOT snap;
+    TimeInt spinup_end;
+
+    #ifdef DEBUG_MEM
+    Mem_Free(sw);
+    return; // no arena under DEBUG_MEM
+    #endif
+
+    simulate_new_run(&ref, swFALSE);
+
+    sw->Arena.use = swTRUE;
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_CTL_init_run(sw);
+
+    // spin-up: first half of the simulation period
+    spinup_end = (SW_Model.startyr + SW_Model.endyr) / 2;
+    SW_CTL_run_years(sw, SW_Model.startyr, spinup_end);
+    SW_CTL_save_run(sw, &snap);
+
+    SW_CTL_run_years(sw, spinup_end + 1, SW_Model.endyr);
+    summarize_current_run(&res1);
+
+    SW_CTL_restore_run(sw, &snap);
+    EXPECT_EQ(spinup_end + 1, SW_Model.year);
+    SW_CTL_run_years(sw, spinup_end + 1, SW_Model.endyr);
+    summarize_current_run(&res2);
+
+    SW_CTL_free_snapshot(&snap);
+    SW_CTL_clear_model(sw, swTRUE);
+    SW_CTL_activate_run(NULL);
+    Mem_Free(sw);
+
+    EXPECT_EQ(ref.year, res1.year);
+    EXPECT_EQ(ref.year, res2.year);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res1.snowpack);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res2.snowpack);
+    EXPECT_DOUBLE_EQ(ref.aet, res1.aet);
+    EXPECT_DOUBLE_EQ(ref.aet, res2.aet);
+
+    for (i = 0; i < n_layers; i++) {
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res1.swcBulk[i]);
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res2.swcBulk[i]);
+    }
+  }
+
+
+  // A run is only modified while it is active
+  TEST(SWControlTest, ActivateRun) {
+    SW_RUN *sw_default = SW_CurrentRun;
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "ActivateRun");
+
+    SW_CTL_activate_run(sw);
+    EXPECT_EQ(sw, SW_CurrentRun);
+    SW_Model.startyr = 1234;
+    EXPECT_EQ(1234u, sw->Model.startyr);
+
+    SW_CTL_activate_run(sw_default);
+    EXPECT_EQ(sw_default, SW_CurrentRun);
+    EXPECT_NE(1234u, SW_Model.startyr);
+
+    Mem_Free(sw);
+  }
+
+
+  // Setup a new run from a main input file; return FALSE on a fatal error
+  static Bool setup_with_handler(SW_RUN *sw, char *firstfile,
+    SW_ERROR_HANDLER *handler) {
+    Bool ok = swFALSE;
+
+    LogError_handler = handler;
+    if (0 == setjmp(handler->env)) {
+      SW_CTL_setup_model(sw, firstfile);
+      SW_CTL_read_inputs_from_disk(sw);
+      ok = swTRUE;
+    }
+    LogError_handler = NULL;
+
+    return ok;
+  }
+
+  // A fatal error of a run with an error handler does not terminate
+  TEST(SWControlTest, FatalErrorHandler) {
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "FatalErrorHandler");
+    SW_ERROR_HANDLER handler;
+    char firstfile[] = "does_not_exist/files.in";
+
+    EXPECT_FALSE(setup_with_handler(sw, firstfile, &handler));
+    EXPECT_TRUE(NULL != strstr(handler.msg, "Cannot open file"));
+    EXPECT_TRUE(NULL == LogError_handler);
+
+    SW_CTL_clear_model(sw, swTRUE);
+    Mem_Free(sw);
+    SW_CTL_activate_run(NULL);
+  }
+
+
+  // Fatal errors of a run with an error handler do not terminate, and
+  // its messages are held in a log buffer
+  TEST(SWControlTest, FatalErrorLogBuffer) {
+    SW_ERROR_HANDLER handler;
+    SW_LOGBUFFER logbuf = {NULL, 0, 0};
+    volatile int n_caught = 0;
+
+    LogError_handler = &handler;
+    LogError_buffer = &logbuf;
+
+    // invalid soil water content
+    if (0 == setjmp(handler.env)) {
+      SW_SWCbulk2SWPmatric(0., -1., 0);
+    } else {
+      n_caught++;
+      EXPECT_TRUE(NULL != strstr(handler.msg, "Invalid SWC value"));
+    }
+
+    // errors that are not reported by LogError()
+    if (0 == setjmp(handler.env)) {
+      sw_error(-1, "Error %d of sw_error()\n", 2);
+    } else {
+      n_caught++;
+      EXPECT_STREQ("Error 2 of sw_error()\n", handler.msg);
+    }
+
+    LogError_handler = NULL;
+    LogError_buffer = NULL;
+
+    EXPECT_EQ(2, n_caught);
+    ASSERT_TRUE(NULL != logbuf.text);
+    EXPECT_EQ(strlen(logbuf.text), logbuf.len);
+    EXPECT_TRUE(NULL != strstr(logbuf.text, "ERROR: Invalid SWC value"));
+    EXPECT_TRUE(NULL != strstr(logbuf.text, "Error 2 of sw_error()"));
+
+    FlushLogBuffer(&logbuf, NULL);
+    EXPECT_TRUE(NULL == logbuf.text);
+    EXPECT_EQ(0u, logbuf.len);
+  }
+
+
+  // Pass the inputs of run `src` (read from disk, not initialized) in memory
+  // to the active run; `hist` holds the daily weather of all simulated years
+  static void pass_inputs_in_memory(SW_RUN *src, const SW_WEATHER_HIST *hist) {
+    RealF dmax[MAX_LAYERS], matricd[MAX_LAYERS], f_gravel[MAX_LAYERS],
+      evco[MAX_LAYERS], trco[NVEGTYPES][MAX_LAYERS], psand[MAX_LAYERS],
+      pclay[MAX_LAYERS], imperm[MAX_LAYERS], soiltemp[MAX_LAYERS], depth = 0.;
+    RealD rgn_bounds[MAX_TRANSP_REGIONS];
+    RealD *p_accu[SW_OUTNPERIODS], *p_oagg[SW_OUTNPERIODS], *ppm;
+    const SW_SITE *site = &src->Site;
+    LyrIndex i, n_layers = src->Site.n_layers;
+    unsigned int k, r = 0;
+
+    SW_MDL_set_time(src->Model.startyr, src->Model.endyr,
+      src->Model.startstart, src->Model.endend, src->Model.isnorth);
+
+    // Site parameters without soil layers
+    memcpy(&SW_Site, &src->Site, sizeof(SW_SITE));
+    SW_Site.n_layers = 0;
+    SW_Site.deep_lyr = 0;
+    SW_CurrentRun->SWCMinVal = src->SWCMinVal;
+    SW_CurrentRun->SWCInitVal = src->SWCInitVal;
+    SW_CurrentRun->SWCWetVal = src->SWCWetVal;
+    ppm = SW_Carbon.ppm;
+    memcpy(&SW_Carbon, &src->Carbon, sizeof(SW_CARBON));
+    SW_Carbon.ppm = ppm;
+    memcpy(SW_Carbon.ppm, src->Carbon.ppm, MAX_NYEAR * sizeof(double));
+
+    // Vegetation and sky
+    memcpy(p_accu, SW_VegProd.p_accu, sizeof p_accu);
+    memcpy(p_oagg, SW_VegProd.p_oagg, sizeof p_oagg);
+    memcpy(&SW_VegProd, &src->VegProd, sizeof(SW_VEGPROD));
+    memcpy(SW_VegProd.p_accu, p_accu, sizeof p_accu);
+    memcpy(SW_VegProd.p_oagg, p_oagg, sizeof p_oagg);
+    memcpy(&SW_Sky, &src->Sky, sizeof(SW_SKY));
+
+    // Weather
+    SW_Weather.use_snow = src->Weather.use_snow;
+    SW_Weather.pct_snowdrift = src->Weather.pct_snowdrift;
+    SW_Weather.pct_snowRunoff = src->Weather.pct_snowRunoff;
+    SW_Weather.use_weathergenerator = src->Weather.use_weathergenerator;
+    SW_Weather.use_weathergenerator_only = src->Weather.use_weathergenerator_only;
+    memcpy(SW_Weather.scale_precip, src->Weather.scale_precip, sizeof SW_Weather.scale_precip);
+    memcpy(SW_Weather.scale_temp_max, src->Weather.scale_temp_max, sizeof SW_Weather.scale_temp_max);
+    memcpy(SW_Weather.scale_temp_min, src->Weather.scale_temp_min, sizeof SW_Weather.scale_temp_min);
+    memcpy(SW_Weather.scale_skyCover, src->Weather.scale_skyCover, sizeof SW_Weather.scale_skyCover);
+    memcpy(SW_Weather.scale_wind, src->Weather.scale_wind, sizeof SW_Weather.scale_wind);
+    memcpy(SW_Weather.scale_rH, src->Weather.scale_rH, sizeof SW_Weather.scale_rH);
+    SW_WTH_set_memory(hist, src->Model.startyr,
+      src->Model.endyr - src->Model.startyr + 1);
+
+    // Soil layers and transpiration regions
+    for (i = 0; i < n_layers; i++) {
+      depth += (RealF) site->width[i];
+      dmax[i] = depth;
+      matricd[i] = (RealF) site->soilMatric_density[i];
+      f_gravel[i] = (RealF) site->fractionVolBulk_gravel[i];
+      evco[i] = (RealF) site->evap_coeff[i];
+      ForEachVegType(k) {
+        trco[k][i] = (RealF) site->transp_coeff[k][i];
+      }
+      psand[i] = (RealF) site->fractionWeightMatric_sand[i];
+      pclay[i] = (RealF) site->fractionWeightMatric_clay[i];
+      imperm[i] = (RealF) site->impermeability[i];
+      soiltemp[i] = (RealF) site->sTemp[i];
+
+      if (r < src->Site.n_transp_rgn && i == src->TranspRgnBounds[r]) {
+        rgn_bounds[r++] = dmax[i];
+      }
+    }
+
+    set_soillayers(n_layers, dmax, matricd, f_gravel, evco,
+      trco[SW_GRASS], trco[SW_SHRUB], trco[SW_TREES], trco[SW_FORBS],
+      psand, pclay, imperm, soiltemp, (int) r, rgn_bounds);
+
+    SW_CTL_read_inputs_from_memory(SW_CurrentRun);
+  }
+
+  // Inputs passed in memory produce the same results as inputs from disk
+  TEST(SWControlTest, InputsFromMemory) {
+    RunSummary ref, res;
+    SW_RUN *src = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "InputsFromMemory");
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "InputsFromMemory");
+    SW_WEATHER_HIST *hist;
+    char firstfile[MAX_FILENAMESIZE];
+    TimeInt year, n_years;
+    LyrIndex i;
+
+    // Reference: inputs from disk
+    simulate_new_run(&ref, swFALSE);
+
+    // Inputs and daily weather as they would be provided by a caller
+    strcpy(firstfile, _firstfile);
+    SW_CTL_setup_model(src, firstfile);
+    SW_CTL_read_inputs_from_disk(src);
+
+    n_years = SW_Model.endyr - SW_Model.startyr + 1;
+    hist = (SW_WEATHER_HIST *) Mem_Calloc(n_years, sizeof(SW_WEATHER_HIST),
+      "InputsFromMemory");
+    for (year = 0; year < n_years; year++) {
+      _read_weather_hist(SW_Model.startyr + year);
+      memcpy(&hist[year], &SW_Weather.hist, sizeof(SW_WEATHER_HIST));
+    }
+
+    // Run without any input files
+    SW_CTL_setup_model(sw, NULL);
+    pass_inputs_in_memory(src, hist);
+    SW_CTL_init_run(sw);
+    SW_CTL_main(sw);
+
+    summarize_current_run(&res);
+
+    EXPECT_EQ(ref.year, res.year);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res.snowpack);
+    EXPECT_DOUBLE_EQ(ref.aet, res.aet);
+
+    ForEachSoilLayer(i) {
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res.swcBulk[i]);
+    }
+
+    SW_CTL_clear_model(sw, swTRUE);
+    Mem_Free(sw);
+    SW_CTL_activate_run(src);
+    SW_CTL_clear_model(src, swTRUE);
+    Mem_Free(src);
+    Mem_Free(hist);
+    SW_CTL_activate_run(NULL);
+  }
+
+  // A run that is advanced one day at a time produces the same results
+  TEST(SWControlTest, DayStepAPI) {
+    RunSummary ref, res;
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "DayStepAPI");
+    SW_DAY_STATE day;
+    TimeInt year;
+    LyrIndex i;
+    int k;
+    Bool has_transp = swFALSE;
+
+    // Reference: a run that simulates whole years
+    simulate_new_run(&ref, swFALSE);
+
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_CTL_init_run(sw);
+
+    for (year = SW_Model.startyr; year <= SW_Model.endyr; year++) {
+      SW_CTL_begin_year(sw, year);
+
+      while (SW_CTL_begin_day(sw, &day)) {
+        EXPECT_EQ(year, day.year);
+        EXPECT_EQ(SW_Site.n_layers, day.n_layers);
+        SW_CTL_water_flow(sw, &day);
+
+        // Views show the soil state of the day without copies
+        EXPECT_EQ(SW_Soilwat.swcBulk[Today], day.swcBulk);
+        ForEachVegType(k) {
+          for (i = 0; i < day.n_layers; i++) {
+            has_transp = (Bool) (has_transp || day.transpiration[k][i] > 0.);
+          }
+        }
+
+        SW_CTL_end_day(sw);
+      }
+
+      SW_CTL_end_year(sw);
+    }
+
+    SW_Model.year = year;
+    summarize_current_run(&res);
+    EXPECT_TRUE(has_transp);
+
+    EXPECT_EQ(ref.year, res.year);
+    EXPECT_DOUBLE_EQ(ref.snowpack, res.snowpack);
+    EXPECT_DOUBLE_EQ(ref.aet, res.aet);
+
+    ForEachSoilLayer(i) {
+      EXPECT_DOUBLE_EQ(ref.swcBulk[i], res.swcBulk[i]);
+    }
+
+    SW_CTL_clear_model(sw, swTRUE);
+    Mem_Free(sw);
+    SW_CTL_activate_run(NULL);
+  }
+
+
+  // Vegetation that a coupled model writes for a day is used for that day
+  TEST(SWControlTest, DayStepVegetation) {
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "DayStepVegetation");
+    SW_DAY_STATE day;
+    LyrIndex i;
+    int k;
+
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_CTL_init_run(sw);
+
+    SW_CTL_begin_year(sw, SW_Model.startyr);
+
+    // Skip to mid-summer when plants transpire
+    while (SW_CTL_begin_day(sw, &day) && day.doy < 180) {
+      SW_CTL_water_flow(sw, &day);
+      SW_CTL_end_day(sw);
+    }
+
+    // The coupled model removes all vegetation of today
+    ForEachVegType(k) {
+      EXPECT_GT(SW_VegProd.veg[k].biolive_daily[day.doy], 0.);
+      *day.biomass[k] = 0.;
+    }
+    day.veg_changed = swTRUE;
+    SW_CTL_water_flow(sw, &day);
+
+    ForEachVegType(k) {
+      EXPECT_DOUBLE_EQ(0., SW_VegProd.veg[k].biolive_daily[day.doy]);
+      for (i = 0; i < day.n_layers; i++) {
+        EXPECT_DOUBLE_EQ(0., day.transpiration[k][i]);
+      }
+    }
+
+    SW_CTL_end_day(sw);
+
+    SW_CTL_clear_model(sw, swTRUE);
+    Mem_Free(sw);
+    SW_CTL_activate_run(NULL);
+  }
+
+
+  // Set up run `k` of a group with its own parameters of the water flow
+  static void setup_lane_run(SW_RUN *sw, unsigned int k) {
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_CTL_init_run(sw);
+
+    SW_Site.slow_drain_coeff *= 1. + 2. * k;
+    SW_Site.percentRunoff = 0.2 * k;
+    SW_Site.percentRunon = (k % 2 == 0) ? 0. : 0.5;
+  }
+
+  // Runs that are advanced in lock-step, with their percolation in lanes,
+  // produce the same results as runs that are simulated alone
+  TEST(SWControlTest, WaterFlowLanes) {
+    // more runs than lanes: one full and one partial block of lanes
+    const unsigned int n = SW_LANES + 2;
+    SW_RUN *sw[SW_LANES + 2];
+    RunSummary ref[SW_LANES + 2], res;
+    SW_FLOW_DIAG diag[SW_LANES + 2];
+    unsigned long wb_days[SW_LANES + 2];
+    TimeInt year, startyr, endyr;
+    LyrIndex i;
+    unsigned int k, part;
+    Bool today;
+
+    // References: each run simulated alone
+    for (k = 0; k < n; k++) {
+      sw[k] = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "WaterFlowLanes");
+      setup_lane_run(sw[k], k);
+      SW_CTL_main(sw[k]);
+
+      summarize_current_run(&ref[k]);
+      diag[k] = sw[k]->Flow.diag;
+      wb_days[k] = sw[k]->Flow.wbmon.days;
+
+      SW_CTL_clear_model(sw[k], swTRUE);
+      memset(sw[k], 0, sizeof(SW_RUN));
+      setup_lane_run(sw[k], k);
+    }
+
+    startyr = sw[0]->Model.startyr;
+    endyr = sw[0]->Model.endyr;
+
+    for (year = startyr; year <= endyr; year++) {
+      for (k = 0; k < n; k++) {
+        SW_CTL_begin_year(sw[k], year);
+      }
+
+      for (;;) {
+        today = swFALSE;
+        for (k = 0; k < n; k++) {
+          today = SW_CTL_begin_day(sw[k], NULL);
+        }
+        if (!today) {
+          break;
+        }
+
+        for (part = 0; part < SW_FLW_NPARTS; part++) {
+          for (k = 0; k < n; k++) {
+            SW_CTL_water_flow_part(sw[k], NULL, part);
+          }
+          if (part < SW_FLW_NPARTS - 1) {
+            SW_FLW_percolate_lanes(sw, n, part);
+          }
+        }
+
+        for (k = 0; k < n; k++) {
+          SW_CTL_end_day(sw[k]);
+        }
+      }
+
+      for (k = 0; k < n; k++) {
+        SW_CTL_end_year(sw[k]);
+      }
+    }
+
+    for (k = 0; k < n; k++) {
+      SW_CTL_activate_run(sw[k]);
+      SW_Model.year = year;
+      summarize_current_run(&res);
+
+      EXPECT_EQ(ref[k].year, res.year);
+      EXPECT_EQ(ref[k].snowpack, res.snowpack) << "run " << k;
+      EXPECT_EQ(ref[k].aet, res.aet) << "run " << k;
+      ForEachSoilLayer(i) {
+        EXPECT_EQ(ref[k].swcBulk[i], res.swcBulk[i]) <<
+          "run " << k << ", layer " << i;
+      }
+
+      // percolation that was limited by available water is counted per run
+      EXPECT_EQ(diag[k].clamp_perc, sw[k]->Flow.diag.clamp_perc) << "run " << k;
+      EXPECT_EQ(diag[k].push_sat, sw[k]->Flow.diag.push_sat) << "run " << k;
+      EXPECT_EQ(wb_days[k], sw[k]->Flow.wbmon.days) << "run " << k;
+
+      SW_CTL_clear_model(sw[k], swTRUE);
+      Mem_Free(sw[k]);
+    }
+
+    // the runs differ
+    EXPECT_NE(ref[0].swcBulk[0], ref[1].swcBulk[0]);
+
+    SW_CTL_activate_run(NULL);
+  }
+
+} // namespace
@@ -37,13 +37,10 @@
 #include "../pcg/pcg_basic.h"
 
 #include "../SW_Flow_lib.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
-extern SW_SITE SW_Site;
-extern SW_MODEL SW_Model;
-extern SW_VEGPROD SW_VegProd;
-extern ST_RGR_VALUES stValues;
 //extern SW_SOILWAT_OUTPUTS SW_Soilwat_outputs;
 
 pcg32_random_t flow_rng;
@@ -333,6 +330,52 @@ namespace
   }
 
 
+  // Test that infiltrate_water_high conserves water for numbers of soil
+  // layers with fixed-size loops (6, 8, 12) and with generic loops
+  TEST(SWFlowTest, InfiltrateWaterHighFixedLayers)
+  {
+    double swc[MAX_LAYERS], drain[MAX_LAYERS], swcfc[MAX_LAYERS],
+      swcsat[MAX_LAYERS], impermeability[MAX_LAYERS];
+    double pptleft = 3., standingWater, drainout, water_in, water_out;
+    unsigned int i, n;
+
+    pcg32_random_t infiltrate_rng;
+    RandSeed(0, &infiltrate_rng);
+
+    for (n = 1; n <= 13; n++)
+    {
+      standingWater = 0.5;
+      drainout = 0.;
+      water_in = pptleft + standingWater;
+
+      for (i = 0; i < n; i++)
+      {
+        swc[i] = RandNorm(1., 0.5, &infiltrate_rng);
+        swcfc[i] = RandNorm(1., 0.5, &infiltrate_rng);
+        swcsat[i] = swcfc[i] + .1;
+        impermeability[i] = 0.2;
+        water_in += swc[i];
+      }
+
+      infiltrate_water_high(swc, drain, &drainout, pptleft, n, swcfc,
+        swcsat, impermeability, &standingWater);
+
+      water_out = drainout + standingWater;
+      for (i = 0; i < n; i++)
+      {
+        EXPECT_LE(swc[i], swcsat[i] + tol9) << "nlyrs = " << n;
+        water_out += swc[i];
+      }
+
+      EXPECT_NEAR(water_in, water_out, tol9) << "nlyrs = " << n;
+      EXPECT_DOUBLE_EQ(drainout, drain[n - 1]) << "nlyrs = " << n;
+    }
+
+    // Reset to previous global states
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
   //Test transp_weighted_avg function.
   TEST(SWFlowTest, transp_weighted_avg)
   {
@@ -372,10 +415,10 @@ namespace
     {
       // copy soil layer values into arrays so that they can be passed as
       // arguments to `transp_weighted_avg`
-      tr_coeff2[i] = s->lyr[i]->transp_coeff[SW_SHRUB];
+      tr_coeff2[i] = s->transp_coeff[SW_SHRUB][i];
 
       // example: swc as mean of wilting point and field capacity
-      swc2[i] = (s->lyr[i]->swcBulk_fieldcap + s->lyr[i]->swcBulk_wiltpt) / 2.;
+      swc2[i] = (s->swcBulk_fieldcap[i] + s->swcBulk_wiltpt[i]) / 2.;
     }
 
 
@@ -460,11 +503,11 @@ namespace
       {
         // copy soil layer values into arrays so that they can be passed as
         // arguments to `pot_soil_evap`
-        width[i] = s->lyr[i]->width;
-        lyrEvapCo[i] = s->lyr[i]->evap_coeff;
+        width[i] = s->width[i];
+        lyrEvapCo[i] = s->evap_coeff[i];
 
         // example: swc as mean of wilting point and field capacity
-        swc[i] = (s->lyr[i]->swcBulk_fieldcap + s->lyr[i]->swcBulk_wiltpt) / 2.;
+        swc[i] = (s->swcBulk_fieldcap[i] + s->swcBulk_wiltpt[i]) / 2.;
       }
 
       // Begin TEST if (totagb >= Es_param_limit)
@@ -559,10 +602,10 @@ namespace
       {
         // copy soil layer values into arrays so that they can be passed as
         // arguments to `pot_soil_evap`
-        width[i] = s->lyr[i]->width;
-        ecoeff[i] = s->lyr[i]->evap_coeff;
+        width[i] = s->width[i];
+        ecoeff[i] = s->evap_coeff[i];
         // example: swc as mean of wilting point and field capacity
-        swc[i] = (s->lyr[i]->swcBulk_fieldcap + s->lyr[i]->swcBulk_wiltpt) / 2.;
+        swc[i] = (s->swcBulk_fieldcap[i] + s->swcBulk_wiltpt[i]) / 2.;
       }
 
       //Begin TEST for bserate when nelyrs = 1
@@ -760,7 +803,7 @@ namespace
       ForEachSoilLayer(i)
       {
         // Setup: initial swc to some example value, here SWC at 20% VWC
-        swc_init[i] = 0.2 * s->lyr[i]->width;
+        swc_init[i] = 0.2 * s->width[i];
         // Setup: water extraction coefficient, some example value, here 0.5
         coeff[i] = 0.5;
       }
@@ -886,6 +929,31 @@ namespace
           "remove_from_soil: sum(qty)=" << qty_sum <<
           " !<= rate=" << rate <<
           " for " << nlyrs << " soil layers";
+
+
+      //------ 4) TEST: if rate exceeds available water, then removal is
+      // limited to swc - swcmin and each limited layer is counted
+      unsigned long n_clamp = SW_CurrentRun->Flow.diag.clamp_remove;
+      double swcmin_high[MAX_LAYERS];
+      aet = aet_init;
+      ForEachSoilLayer(i)
+      {
+        qty[i] = 0.;
+        swc[i] = swc_init[i];
+        swcmin_high[i] = swc_init[i] - 1e-4;
+      }
+
+      // Call function to test
+      remove_from_soil(swc, qty, &aet, nlyrs, coeff, rate, swcmin_high);
+
+      for (i = 0; i < nlyrs; i++)
+      {
+        EXPECT_NEAR(swc[i], swcmin_high[i], tol9) <<
+          "remove_from_soil(limited): swc != swcmin in layer "
+          << 1 + i << " out of " << nlyrs << " soil layers";
+      }
+      EXPECT_EQ(SW_CurrentRun->Flow.diag.clamp_remove, n_clamp + nlyrs) <<
+          "remove_from_soil(limited): clamp count for " << nlyrs << " soil layers";
     }
 
     // Reset to previous global states.
@@ -925,7 +993,7 @@ namespace
       // Initialize soil arrays to be independent of soil texture...
       ForEachSoilLayer(i)
       {
-        width[i] = s->lyr[i]->width;
+        width[i] = s->width[i];
         swcfc[i] = 0.25 * width[i];
         swcmin[i] = 0.05 * width[i];
         swcsat[i] = 0.35 * width[i];
@@ -1153,9 +1221,9 @@ namespace
       ForEachSoilLayer(i)
       {
         // example data based on soil:
-        swc[i] = (s->lyr[i]->swcBulk_fieldcap + s->lyr[i]->swcBulk_wiltpt) / 2.;
-        swcwp[i] = s->lyr[i]->swcBulk_wiltpt;
-        lyrRootCo[i] =  s->lyr[i]->transp_coeff[SW_SHRUB]; // shrubs as example
+        swc[i] = (s->swcBulk_fieldcap[i] + s->swcBulk_wiltpt[i]) / 2.;
+        swcwp[i] = s->swcBulk_wiltpt[i];
+        lyrRootCo[i] =  s->transp_coeff[SW_SHRUB][i]; // shrubs as example
         st->lyrFrozen[i] = swFALSE;
       }
 
@@ -1193,4 +1261,55 @@ namespace
       Reset_SOILWAT2_after_UnitTest();
     }
   }
+
+
+  //TEST for hydraulic_redistribution with layers without roots and frozen layers
+  TEST(SWFlowTest, hydraulic_redistribution_rootless_frozen)
+  {
+    unsigned int nlyrs = MAX_LAYERS, i;
+    double maxCondroot = -0.2328, swp50 = 1.2e12, shapeCond = 1, scale = 0.3;
+    double swc[MAX_LAYERS], swc0[MAX_LAYERS], swcwp[MAX_LAYERS],
+      lyrRootCo[MAX_LAYERS], hydred[MAX_LAYERS] = {0.};
+    double sum = 0.;
+
+    create_test_soillayers(nlyrs);
+    ForEachSoilLayer(i)
+    {
+      // alternate wet and dry layers
+      swc0[i] = swc[i] = (i % 2 == 0) ?
+        s->swcBulk_fieldcap[i] : 0.8 * s->swcBulk_wiltpt[i];
+      swcwp[i] = s->swcBulk_wiltpt[i];
+      lyrRootCo[i] = (i >= 5 && i < 10) ? 0. : s->transp_coeff[SW_SHRUB][i];
+      st->lyrFrozen[i] = itob(i == 3);
+    }
+
+    hydraulic_redistribution(swc, swcwp, lyrRootCo, hydred, nlyrs,
+      maxCondroot, swp50, shapeCond, scale);
+
+    ForEachSoilLayer(i)
+    {
+      if (i == 0 || i == 3 || (i >= 5 && i < 10))
+      {
+        // Expection: no hydred in top layer, in frozen layers, and in
+        // layers without roots
+        EXPECT_DOUBLE_EQ(hydred[i], 0.);
+        EXPECT_DOUBLE_EQ(swc[i], swc0[i]);
+      }
+
+      EXPECT_DOUBLE_EQ(swc[i], swc0[i] + hydred[i]);
+      sum += hydred[i];
+    }
+
+    // Expection: water is redistributed, not created or lost
+    EXPECT_NE(hydred[1], 0.);
+    EXPECT_NEAR(sum, 0., tol9);
+
+    ForEachSoilLayer(i)
+    {
+      st->lyrFrozen[i] = swFALSE;
+    }
+
+    // Reset to previous global states.
+    Reset_SOILWAT2_after_UnitTest();
+  }
 }
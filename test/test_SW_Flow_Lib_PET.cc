@@ -39,10 +39,10 @@
 #include "../pcg/pcg_basic.h"
 
 #include "../SW_Flow_lib_PET.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
-extern char output_prefix[FILENAME_MAX];
 
 
 namespace
@@ -774,6 +774,102 @@ namespace
 
 
 
+  // Test that memoized site constants follow changes in elevation and slope
+  TEST(SW2_SolarRadiation_Test, memoized_site_constants)
+  {
+    unsigned int k, doy = 105;
+    double
+      H_gt[3], H_ot, H_oh, H_gh, pet[3],
+      elev[3] = {226., 3000., 226.},
+      slope[3] = {60 * deg_to_rad, 10 * deg_to_rad, 60 * deg_to_rad};
+
+    for (k = 0; k < 3; k++) {
+      H_gt[k] = solar_radiation(
+        doy, 43. * deg_to_rad, elev[k], slope[k], 0.,
+        0.2, 50., 66.3, 7.4,
+        &H_oh, &H_ot, &H_gh
+      );
+
+      pet[k] = petfunc(H_gt[k], 7.4, elev[k], 0.2, 66.3, 1., 50.);
+
+      // Re-init radiation memoization (hour angles depend on slope)
+      SW_PET_init_run();
+    }
+
+    // Recalculated after a change in elevation or slope
+    EXPECT_NE(H_gt[0], H_gt[1]);
+    EXPECT_NE(pet[0], pet[1]);
+
+    // Same site constants produce the same values
+    EXPECT_DOUBLE_EQ(H_gt[0], H_gt[2]);
+    EXPECT_DOUBLE_EQ(pet[0], pet[2]);
+
+    // Alternating elevations recalculate the memoized constants
+    H_gt[1] = solar_radiation(
+      doy, 43. * deg_to_rad, elev[0], slope[0], 0.,
+      0.2, 50., 66.3, 7.4,
+      &H_oh, &H_ot, &H_gh
+    );
+    pet[1] = petfunc(H_gt[1], 7.4, elev[1], 0.2, 66.3, 1., 50.);
+    pet[2] = petfunc(H_gt[1], 7.4, elev[0], 0.2, 66.3, 1., 50.);
+
+    EXPECT_DOUBLE_EQ(H_gt[1], H_gt[0]);
+    EXPECT_NE(pet[1], pet[0]);
+    EXPECT_DOUBLE_EQ(pet[2], pet[0]);
+
+    SW_PET_init_run(); // Re-init radiation memoization
+  }
+
+
+
+  // Test that radiation and PET of a year equal daily calculations
+  TEST(SW2_PET_Test, pet_days)
+  {
+    unsigned int doy;
+    double
+      lat = 43. * deg_to_rad, elev = 1500.,
+      slope = 20. * deg_to_rad, aspect = 30. * deg_to_rad, albedo = 0.2,
+      temp[MAX_DAYS + 1], RH[MAX_DAYS + 1], windsp[MAX_DAYS + 1],
+      cloudcov[MAX_DAYS + 1],
+      H_oh[MAX_DAYS + 1], H_ot[MAX_DAYS + 1], H_gh[MAX_DAYS + 1],
+      H_gt[MAX_DAYS + 1], pet[MAX_DAYS + 1],
+      d_H_oh, d_H_ot, d_H_gh, d_H_gt, d_pet;
+
+    for (doy = 1; doy <= MAX_DAYS; doy++) {
+      temp[doy] = -10. + 30. * sin(doy * swPI / MAX_DAYS);
+      RH[doy] = 30. + 0.1 * doy;
+      windsp[doy] = 1. + (doy % 7);
+      cloudcov[doy] = (doy * 13) % 100;
+    }
+
+    pet_days(
+      1, MAX_DAYS, lat, elev, slope, aspect, albedo,
+      temp, RH, windsp, cloudcov,
+      H_oh, H_ot, H_gh, H_gt, pet
+    );
+
+    for (doy = 1; doy <= MAX_DAYS; doy++) {
+      d_H_gt = solar_radiation(
+        doy, lat, elev, slope, aspect, albedo,
+        cloudcov[doy], RH[doy], temp[doy],
+        &d_H_oh, &d_H_ot, &d_H_gh
+      );
+      d_pet = petfunc(
+        d_H_gt, temp[doy], elev, albedo, RH[doy], windsp[doy], cloudcov[doy]
+      );
+
+      EXPECT_EQ(H_oh[doy], d_H_oh);
+      EXPECT_EQ(H_ot[doy], d_H_ot);
+      EXPECT_EQ(H_gh[doy], d_H_gh);
+      EXPECT_EQ(H_gt[doy], d_H_gt);
+      EXPECT_EQ(pet[doy], d_pet);
+    }
+
+    SW_PET_init_run(); // Re-init radiation memoization
+  }
+
+
+
   // Test saturation vapor pressure functions
   TEST(SW2_PET_Test, svp)
   {
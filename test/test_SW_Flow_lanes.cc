@@ -0,0 +1,382 @@
+#include "gtest/gtest.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Files.h"
+#include "../SW_Site.h"
+#include "../SW_VegProd.h"
+#include "../SW_SoilWater.h"
+#include "../SW_Flow_lib.h"
+#include "../SW_Flow_lanes.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+
+namespace
+{
+  const unsigned int nlyrs = 8;
+
+  // Lane-shaped soil layers: lane `l` is a copy of the test soil layers
+  // with a lane-specific soil moisture and frozen state
+  typedef struct {
+    double swc[MAX_LAYERS][SW_LANES], swcfc[MAX_LAYERS][SW_LANES],
+      swcsat[MAX_LAYERS][SW_LANES], swcmin[MAX_LAYERS][SW_LANES],
+      width[MAX_LAYERS][SW_LANES], imperm[MAX_LAYERS][SW_LANES],
+      coeff[MAX_LAYERS][SW_LANES], swp[MAX_LAYERS][SW_LANES];
+    Bool frozen[MAX_LAYERS][SW_LANES];
+  } LaneLayers;
+
+  // Copy lane `l` of a lane-shaped layer array
+  void get_lane(double x[][SW_LANES], unsigned int l, double *res) {
+    unsigned int i;
+
+    for (i = 0; i < nlyrs; i++) {
+      res[i] = x[i][l];
+    }
+  }
+
+  // Set the frozen state of the active run to that of lane `l`
+  void set_frozen(LaneLayers *b, unsigned int l) {
+    unsigned int i;
+
+    for (i = 0; i < nlyrs; i++) {
+      stValues.lyrFrozen[i] = b->frozen[i][l];
+    }
+  }
+
+  void setup_lanes(LaneLayers *b) {
+    unsigned int i, l;
+    double swc[MAX_LAYERS], swp[MAX_LAYERS];
+
+    create_test_soillayers(nlyrs);
+
+    ForEachLane(l) {
+      for (i = 0; i < nlyrs; i++) {
+        b->swcfc[i][l] = SW_Site.swcBulk_fieldcap[i];
+        b->swcsat[i][l] = SW_Site.swcBulk_saturated[i];
+        b->swcmin[i][l] = SW_Site.swcBulk_min[i];
+        b->width[i][l] = SW_Site.width[i];
+        b->imperm[i][l] = (l == 1 && i == 2) ? 0.8 : SW_Site.impermeability[i];
+        b->coeff[i][l] = (l == 2 && i > 3) ? 0. : SW_Site.transp_coeff[SW_SHRUB][i];
+
+        // lanes range from dry to above saturation
+        swc[i] = b->swc[i][l] = SW_Site.swcBulk_min[i] +
+          (0.3 + 0.4 * l) * (SW_Site.swcBulk_saturated[i] - SW_Site.swcBulk_min[i]);
+
+        b->frozen[i][l] = itob(l == 3 && i < 2);
+      }
+
+      SW_SWCbulk2SWPmatric_profile(swc, swp, nlyrs);
+      for (i = 0; i < nlyrs; i++) {
+        b->swp[i][l] = swp[i];
+      }
+    }
+  }
+
+  void set_tanfunc_lanes(SW_TANFUNC_LANES *tf, tanfunc_t *x) {
+    unsigned int l;
+
+    ForEachLane(l) {
+      SW_LANES_set_tanfunc(tf, l, x);
+      tf->xinflec[l] += l;
+    }
+  }
+
+
+  // Each lane of an interception kernel equals the scalar kernel
+  TEST(SWFlowLanesTest, InterceptedWater)
+  {
+    unsigned int l;
+    double
+      ppt[SW_LANES], intc[SW_LANES], store[SW_LANES], m[SW_LANES],
+      kSmax[SW_LANES], lai[SW_LANES], blitter[SW_LANES], scale[SW_LANES],
+      ppt2[SW_LANES], intc2[SW_LANES], store2[SW_LANES];
+
+    // lanes with no vegetation, no rain, rain, and partly full storage
+    ForEachLane(l) {
+      ppt[l] = (l == 1) ? 0. : 0.3 * (l + 1);
+      store[l] = (l == 3) ? 0.05 : 0.;
+      m[l] = 1. + l;
+      kSmax[l] = SW_VegProd.veg[SW_GRASS].veg_kSmax;
+      lai[l] = (l == 0) ? 0. : 1.5 * l;
+      blitter[l] = (l == 2) ? 0. : 100. * (l + 1);
+      scale[l] = 1. - 0.1 * l;
+    }
+
+    // canopy interception
+    ForEachLane(l) {
+      ppt2[l] = ppt[l]; store2[l] = store[l];
+      veg_intercepted_water(&ppt2[l], &intc2[l], &store2[l], m[l], kSmax[l],
+        lai[l], scale[l]);
+    }
+
+    veg_intercepted_water_lanes(ppt, intc, store, m, kSmax, lai, scale);
+
+    ForEachLane(l) {
+      EXPECT_DOUBLE_EQ(ppt2[l], ppt[l]);
+      EXPECT_DOUBLE_EQ(intc2[l], intc[l]);
+      EXPECT_DOUBLE_EQ(store2[l], store[l]);
+    }
+
+    // litter interception (adds to previous interception)
+    ForEachLane(l) {
+      kSmax[l] = SW_VegProd.veg[SW_GRASS].lit_kSmax;
+      litter_intercepted_water(&ppt2[l], &intc2[l], &store2[l], m[l], kSmax[l],
+        blitter[l], scale[l]);
+    }
+
+    litter_intercepted_water_lanes(ppt, intc, store, m, kSmax, blitter, scale);
+
+    ForEachLane(l) {
+      EXPECT_DOUBLE_EQ(ppt2[l], ppt[l]);
+      EXPECT_DOUBLE_EQ(intc2[l], intc[l]);
+      EXPECT_DOUBLE_EQ(store2[l], store[l]);
+    }
+  }
+
+
+  // Each lane of the infiltration kernels equals the scalar kernel
+  TEST(SWFlowLanesTest, InfiltrateWater)
+  {
+    LaneLayers b;
+    unsigned int i, l;
+    double
+      swc[MAX_LAYERS], drain[MAX_LAYERS], swcfc[MAX_LAYERS],
+      swcsat[MAX_LAYERS], swcmin[MAX_LAYERS], width[MAX_LAYERS],
+      imperm[MAX_LAYERS],
+      drain_lanes[MAX_LAYERS][SW_LANES], drainout[SW_LANES],
+      pptleft[SW_LANES], standingWater[SW_LANES], sdrainpar[SW_LANES],
+      drainout2, standingWater2;
+    unsigned long clamp_perc[SW_LANES] = {0}, push_sat[SW_LANES] = {0},
+      clamp_perc2, push_sat2;
+
+    setup_lanes(&b);
+
+    ForEachLane(l) {
+      pptleft[l] = (l == 0) ? 0. : 1.5 * l;
+      standingWater[l] = (l == 2) ? 0.3 : 0.;
+      sdrainpar[l] = SW_Site.slow_drain_coeff * (1. + l);
+    }
+
+    // lane kernels: all lanes at once
+    LaneLayers c = b;
+    double sw[SW_LANES];
+
+    memcpy(sw, standingWater, sizeof sw);
+    infiltrate_water_high_lanes(c.swc, drain_lanes, drainout, pptleft, nlyrs,
+      c.swcfc, c.swcsat, c.imperm, c.frozen, sw);
+    infiltrate_water_low_lanes(c.swc, drain_lanes, drainout, nlyrs, sdrainpar,
+      SLOW_DRAIN_DEPTH, c.swcfc, c.width, c.swcmin, c.swcsat, c.imperm,
+      c.frozen, sw, clamp_perc, push_sat);
+
+    // scalar kernels: lane by lane
+    ForEachLane(l) {
+      get_lane(b.swc, l, swc);
+      get_lane(b.swcfc, l, swcfc);
+      get_lane(b.swcsat, l, swcsat);
+      get_lane(b.swcmin, l, swcmin);
+      get_lane(b.width, l, width);
+      get_lane(b.imperm, l, imperm);
+      set_frozen(&b, l);
+
+      standingWater2 = standingWater[l];
+      clamp_perc2 = SW_CurrentRun->Flow.diag.clamp_perc;
+      push_sat2 = SW_CurrentRun->Flow.diag.push_sat;
+      infiltrate_water_high(swc, drain, &drainout2, pptleft[l], nlyrs, swcfc,
+        swcsat, imperm, &standingWater2);
+      infiltrate_water_low(swc, drain, &drainout2, nlyrs, sdrainpar[l],
+        SLOW_DRAIN_DEPTH, swcfc, width, swcmin, swcsat, imperm,
+        &standingWater2);
+
+      EXPECT_DOUBLE_EQ(drainout2, drainout[l]);
+      EXPECT_DOUBLE_EQ(standingWater2, sw[l]);
+      EXPECT_EQ(SW_CurrentRun->Flow.diag.clamp_perc - clamp_perc2, clamp_perc[l]);
+      EXPECT_EQ(SW_CurrentRun->Flow.diag.push_sat - push_sat2, push_sat[l]);
+      for (i = 0; i < nlyrs; i++) {
+        EXPECT_DOUBLE_EQ(swc[i], c.swc[i][l]) << "lane " << l << " layer " << i;
+        EXPECT_DOUBLE_EQ(drain[i], drain_lanes[i][l]) << "lane " << l << " layer " << i;
+      }
+    }
+  }
+
+
+  // Each lane of the rate kernels equals the scalar kernel
+  TEST(SWFlowLanesTest, PotentialRates)
+  {
+    LaneLayers b;
+    SW_VEGPROD *v = &SW_VegProd;
+    SW_TANFUNC_LANES evap, transp, shade;
+    unsigned int l, k = SW_SHRUB;
+    double
+      ecoeff[MAX_LAYERS][SW_LANES], swc[MAX_LAYERS], width[MAX_LAYERS],
+      ec[MAX_LAYERS],
+      rate[SW_LANES], swpavg[SW_LANES], petday[SW_LANES], totagb[SW_LANES],
+      fbse[SW_LANES], esLimit[SW_LANES], biolive[SW_LANES],
+      biodead[SW_LANES], fbst[SW_LANES], shade_scale[SW_LANES],
+      shade_deadmax[SW_LANES], co2[SW_LANES],
+      res;
+
+    setup_lanes(&b);
+    set_tanfunc_lanes(&evap, &SW_Site.evap);
+    set_tanfunc_lanes(&transp, &SW_Site.transp);
+    set_tanfunc_lanes(&shade, &v->veg[k].tr_shade_effects);
+
+    // lanes cover each of the cases of petday, totagb, biolive, and biodead
+    ForEachLane(l) {
+      unsigned int i;
+
+      for (i = 0; i < nlyrs; i++) {
+        ecoeff[i][l] = (i < 2 + l) ? SW_Site.evap_coeff[i] : 0.;
+      }
+      ecoeff[0][l] = (l == 3) ? 0. : ecoeff[0][l];
+
+      petday[l] = 0.1 + 0.2 * l;
+      swpavg[l] = 0.5 + 10. * l;
+      totagb[l] = (l == 1) ? 2. * v->veg[k].Es_param_limit : 50. * l;
+      fbse[l] = 0.8 - 0.1 * l;
+      esLimit[l] = v->veg[k].Es_param_limit;
+      biolive[l] = (l == 0) ? 0. : 100. * l;
+      biodead[l] = (l == 2) ? 0. : 400. * l;
+      fbst[l] = 0.2 + 0.1 * l;
+      shade_scale[l] = v->veg[k].shade_scale;
+      shade_deadmax[l] = v->veg[k].shade_deadmax;
+      co2[l] = 1. + 0.05 * l;
+    }
+
+    // watrate
+    watrate_lanes(rate, swpavg, petday, &transp);
+    ForEachLane(l) {
+      res = watrate(swpavg[l], petday[l], transp.xinflec[l], transp.slope[l],
+        transp.yinflec[l], transp.range[l]);
+      EXPECT_DOUBLE_EQ(res, rate[l]);
+    }
+
+    // pot_soil_evap (uses soil water potential of the active run)
+    pot_soil_evap_lanes(rate, nlyrs, ecoeff, totagb, fbse, petday, &evap,
+      b.width, b.swp, esLimit);
+    ForEachLane(l) {
+      get_lane(b.swc, l, swc);
+      get_lane(b.width, l, width);
+      get_lane(ecoeff, l, ec);
+
+      pot_soil_evap(&res, nlyrs, ec, totagb[l], fbse[l], petday[l],
+        evap.xinflec[l], evap.slope[l], evap.yinflec[l], evap.range[l],
+        width, swc, esLimit[l]);
+      EXPECT_DOUBLE_EQ(res, rate[l]);
+    }
+
+    // pot_transp
+    pot_transp_lanes(rate, swpavg, biolive, biodead, fbst, petday, &transp,
+      shade_scale, shade_deadmax, &shade, co2);
+    ForEachLane(l) {
+      pot_transp(&res, swpavg[l], biolive[l], biodead[l], fbst[l], petday[l],
+        transp.xinflec[l], transp.slope[l], transp.yinflec[l], transp.range[l],
+        shade_scale[l], shade_deadmax[l],
+        shade.xinflec[l], shade.slope[l], shade.yinflec[l], shade.range[l],
+        co2[l]);
+      EXPECT_DOUBLE_EQ(res, rate[l]);
+    }
+
+    // EsT_partitioning
+    EsT_partitioning_lanes(fbse, fbst, biolive, co2);
+    ForEachLane(l) {
+      double fbse1, fbst1;
+
+      EsT_partitioning(&fbse1, &fbst1, biolive[l], co2[l]);
+      EXPECT_DOUBLE_EQ(fbse1, fbse[l]);
+      EXPECT_DOUBLE_EQ(fbst1, fbst[l]);
+    }
+  }
+
+
+  // Each lane of the weighted average of soil water potential equals the
+  // scalar kernel; lanes have different numbers of transpiration layers
+  TEST(SWFlowLanesTest, TranspWeightedAvg)
+  {
+    LaneLayers b;
+    unsigned int i, l, n_tr_lyrs, regions[MAX_LAYERS][SW_LANES],
+      rgn[MAX_LAYERS];
+    double swc[MAX_LAYERS], coeff[MAX_LAYERS], swpavg[SW_LANES], res;
+
+    setup_lanes(&b);
+
+    ForEachLane(l) {
+      n_tr_lyrs = nlyrs - l;
+
+      for (i = 0; i < nlyrs; i++) {
+        regions[i][l] = (i < n_tr_lyrs) ? SW_Site.my_transp_rgn[SW_SHRUB][i] : 0;
+      }
+    }
+
+    transp_weighted_avg_lanes(swpavg, SW_Site.n_transp_rgn, nlyrs, regions,
+      b.coeff, b.swp);
+
+    ForEachLane(l) {
+      n_tr_lyrs = nlyrs - l;
+      get_lane(b.swc, l, swc);
+      get_lane(b.coeff, l, coeff);
+
+      for (i = 0; i < nlyrs; i++) {
+        rgn[i] = SW_Site.my_transp_rgn[SW_SHRUB][i];
+      }
+
+      transp_weighted_avg(&res, SW_Site.n_transp_rgn, n_tr_lyrs, rgn, coeff,
+        swc);
+      EXPECT_DOUBLE_EQ(res, swpavg[l]);
+    }
+  }
+
+
+  // Each lane of the water removal kernel equals the scalar kernel
+  TEST(SWFlowLanesTest, RemoveFromSoil)
+  {
+    LaneLayers b;
+    unsigned int i, l;
+    double
+      swc[MAX_LAYERS], qty[MAX_LAYERS], coeff[MAX_LAYERS], swcmin[MAX_LAYERS],
+      qty_lanes[MAX_LAYERS][SW_LANES], aet[SW_LANES], rate[SW_LANES], aet2;
+
+    setup_lanes(&b);
+
+    // lane 0 has no removal coefficients: `qty` remains unchanged
+    ForEachLane(l) {
+      for (i = 0; i < nlyrs; i++) {
+        qty_lanes[i][l] = -1.;
+        b.coeff[i][l] = (l == 0) ? 0. : b.coeff[i][l];
+      }
+      aet[l] = 0.1 * l;
+      rate[l] = 0.2 + 0.3 * l;
+    }
+
+    remove_from_soil_lanes(b.swc, qty_lanes, aet, nlyrs, b.coeff, rate,
+      b.swcmin, b.swp, b.frozen);
+
+    setup_lanes(&b);
+    ForEachLane(l) {
+      get_lane(b.swc, l, swc);
+      get_lane(b.swcmin, l, swcmin);
+      get_lane(b.coeff, l, coeff);
+      set_frozen(&b, l);
+      for (i = 0; i < nlyrs; i++) {
+        qty[i] = -1.;
+        coeff[i] = (l == 0) ? 0. : coeff[i];
+      }
+      aet2 = 0.1 * l;
+
+      remove_from_soil(swc, qty, &aet2, nlyrs, coeff, rate[l], swcmin);
+
+      EXPECT_DOUBLE_EQ(aet2, aet[l]);
+      for (i = 0; i < nlyrs; i++) {
+        EXPECT_DOUBLE_EQ(qty[i], qty_lanes[i][l]) << "lane " << l << " layer " << i;
+      }
+    }
+  }
+}
@@ -37,14 +37,12 @@
 #include "../pcg/pcg_basic.h"
 
 #include "../SW_Flow_lib.h"
+#include "../SW_Run.h"
 #include "../SW_Flow_lib.c"
 
 
 #include "sw_testhelpers.h"
 
-extern SW_MODEL SW_Model;
-extern SW_VEGPROD SW_VegProd;
-extern ST_RGR_VALUES stValues;
 pcg32_random_t flowTemp_rng;
 
 namespace {
@@ -96,6 +94,7 @@ namespace {
     double deltaX = 15.0, theMaxDepth = 990.0, sTconst = 4.15;
     unsigned int nlyrs, nRgr = 65;
     Bool ptr_stError = swFALSE;
+    double x[MAX_LAYERS], y[MAX_ST_RGR];
     pcg32_random_t STInit_rng;
     RandSeed(0,&STInit_rng);
 
@@ -112,12 +111,14 @@ namespace {
       fc, wp, deltaX, theMaxDepth, nRgr, &ptr_stError);
 
     //Structure Tests
-    EXPECT_EQ(sizeof(stValues.tlyrs_by_slyrs),
-      sizeof(double) * MAX_ST_RGR * (MAX_LAYERS + 1));
+    for (i = 0; i < nlyrs; i++) {
+      x[i] = i + 1.;
+    }
+    st_sparse_matvec(&stValues.wSoil_to_Temp, x, y);
 
     for(unsigned int i = ceil(stValues.depths[nlyrs - 1]/deltaX); i < nRgr + 1; i++){
-        EXPECT_EQ(stValues.tlyrs_by_slyrs[i][nlyrs], -deltaX);
-        //Values should be equal to -deltaX when i > the depth of the soil profile/deltaX and j is == nlyrs
+        EXPECT_DOUBLE_EQ(y[i], x[nlyrs - 1]);
+        //Soil temperature layers deeper than the soil profile take the value of the deepest soil layer
     }
 
     // Other init test
@@ -147,12 +148,14 @@ namespace {
       fc2, wp2, deltaX, theMaxDepth, nRgr, &ptr_stError);
 
     //Structure Tests
-    EXPECT_EQ(sizeof(stValues.tlyrs_by_slyrs),
-      sizeof(double) * MAX_ST_RGR * (MAX_LAYERS + 1));
+    for (i = 0; i < nlyrs; i++) {
+      x[i] = i + 1.;
+    }
+    st_sparse_matvec(&stValues.wSoil_to_Temp, x, y);
 
     for(unsigned int i = ceil(stValues.depths[nlyrs - 1]/deltaX); i < nRgr + 1; i++){
-        EXPECT_EQ(stValues.tlyrs_by_slyrs[i][nlyrs], -deltaX);
-        //Values should be equal to -deltaX when i > the depth of the soil profile/deltaX and j is == nlyrs
+        EXPECT_DOUBLE_EQ(y[i], x[nlyrs - 1]);
+        //Soil temperature layers deeper than the soil profile take the value of the deepest soil layer
     }
 
     // Other init test
@@ -303,6 +306,100 @@ namespace {
     delete[] bDensity2; delete[] fc2; delete[] wp2;
   }
 
+  // Test the interpolation weights that 'soil_temperature_setup' calculates
+  // once per run
+  TEST(SWFlowTempTest, SoilLayerInterpolationWeights) {
+
+    double deltaX = 15.0, theMaxDepth = 990.0, sTconst = 4.15;
+    unsigned int nlyrs = MAX_LAYERS, nRgr = 65, i, k;
+    Bool ptr_stError = swFALSE;
+    double width[MAX_LAYERS], oldsTemp[MAX_LAYERS], bDensity[MAX_LAYERS],
+      fc[MAX_LAYERS], wp[MAX_LAYERS], x[MAX_ST_RGR + 1], y[MAX_ST_RGR + 1],
+      sum, expected[MAX_ST_RGR + 1];
+    const ST_SPARSE_MATRIX
+      *wS2T = &stValues.wSoil_to_Temp,
+      *wS2Tt = &stValues.wSoil_to_Temp_temperature,
+      *wT2St = &stValues.wTemp_to_Soil_temperature;
+
+    // soil layers of varying width that do not align with deltaX
+    for (i = 0; i < nlyrs; i++) {
+      width[i] = (i % 3 == 0) ? 5. : 12.;
+      oldsTemp[i] = 1. + i;
+      bDensity[i] = 1.2 + 0.01 * i;
+      fc[i] = 0.3 * width[i];
+      wp[i] = 0.1 * width[i];
+    }
+
+    soil_temperature_setup(bDensity, width, oldsTemp, sTconst, nlyrs,
+      fc, wp, deltaX, theMaxDepth, nRgr, &ptr_stError);
+    EXPECT_FALSE(ptr_stError);
+
+    // Dimensions
+    EXPECT_EQ(wS2T->n_rows, nRgr + 1);
+    EXPECT_EQ(wS2T->n_cols, nlyrs);
+    EXPECT_EQ(wS2Tt->n_rows, nRgr);
+    EXPECT_EQ(wS2Tt->n_cols, nlyrs + 1);
+    EXPECT_EQ(wT2St->n_rows, nlyrs);
+    EXPECT_EQ(wT2St->n_cols, nRgr + 2);
+
+    // Weights of each row sum to one (averages and linear interpolations);
+    // linear interpolations use at most two weights
+    for (i = 0; i < wS2T->n_rows; i++) {
+      sum = 0.;
+      for (k = wS2T->row_start[i]; k < wS2T->row_start[i + 1]; k++) {
+        sum += wS2T->val[k];
+      }
+      EXPECT_NEAR(sum, 1., tol9);
+    }
+
+    for (i = 0; i < wS2Tt->n_rows; i++) {
+      EXPECT_LE(wS2Tt->row_start[i + 1] - wS2Tt->row_start[i], 2u);
+      sum = 0.;
+      for (k = wS2Tt->row_start[i]; k < wS2Tt->row_start[i + 1]; k++) {
+        sum += wS2Tt->val[k];
+      }
+      EXPECT_NEAR(sum, 1., tol9);
+    }
+
+    for (i = 0; i < wT2St->n_rows; i++) {
+      sum = 0.;
+      for (k = wT2St->row_start[i]; k < wT2St->row_start[i + 1]; k++) {
+        sum += wT2St->val[k];
+      }
+      EXPECT_NEAR(sum, 1., tol9);
+    }
+
+    // A linear temperature profile is reproduced at the soil layer depths
+    for (i = 0; i <= nRgr + 1; i++) {
+      x[i] = 2. + 0.1 * i * deltaX;
+    }
+    st_sparse_matvec(wT2St, x, y);
+
+    for (i = 0; i < nlyrs; i++) {
+      EXPECT_NEAR(y[i], 2. + 0.1 * stValues.depths[i], tol6);
+    }
+
+    // Weights reproduce the (precomputed) interpolation of the initial
+    // soil temperature
+    for (i = 0; i < nlyrs; i++) {
+      x[i] = oldsTemp[i];
+    }
+    x[nlyrs] = sTconst;
+    st_sparse_matvec(wS2Tt, x, y);
+
+    lyrSoil_to_lyrTemp_temperature(nlyrs, stValues.depths, oldsTemp, sTconst,
+      nRgr, stValues.depthsR, theMaxDepth, expected);
+
+    for (i = 0; i < nRgr; i++) {
+      EXPECT_DOUBLE_EQ(y[i], expected[i + 1]);
+      EXPECT_DOUBLE_EQ(y[i], stValues.oldsTempR[i + 1]);
+    }
+
+    // Reset to previous global state
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
   // Test set layer to frozen or unfrozen 'set_frozen_unfrozen'
   TEST(SWFlowTempTest, SetFrozenUnfrozen){
 
@@ -387,9 +484,20 @@ namespace {
       bDensityR[i] = 1.5;
     }
 
+    SW_FLOW_DIAG diag = SW_CurrentRun->Flow.diag;
+
     soil_temperature_today(&delta_time, deltaX, T1, sTconst, nRgr, sTempR, oldsTempR,
       vwcR, wpR, fcR, bDensityR, csParam1, csParam2, shParam, &ptr_stError);
 
+    // Check that the day and its realized sub-steps are counted:
+    // each halving of the time step doubles the number of sub-steps
+    unsigned long n_halvings =
+      SW_CurrentRun->Flow.diag.st_halvings - diag.st_halvings;
+    EXPECT_EQ(SW_CurrentRun->Flow.diag.st_days, diag.st_days + 1);
+    EXPECT_EQ(delta_time, 86400. / (1 << n_halvings));
+    EXPECT_EQ(SW_CurrentRun->Flow.diag.st_nsteps[n_halvings],
+      diag.st_nsteps[n_halvings] + 1);
+
     // Check that values that are set, are set right.
     EXPECT_EQ(sTempR[0], T1);
     EXPECT_EQ(sTempR[nRgr + 1], sTconst);
@@ -427,6 +535,89 @@ namespace {
     Reset_SOILWAT2_after_UnitTest();
   }
 
+  // Test implicit soil temperature today function 'soil_temperature_today_CN'
+  TEST(SWFlowTempTest, SoilTemperatureTodayCNFunction) {
+
+    double delta_time = 86400., deltaX = 15.0, T1 = 20.0, sTconst = 4.16,
+      csParam1 = 0.00070, csParam2 = 0.000030, shParam = 0.18;
+    int nRgr = 65, i;
+    Bool ptr_stError = swFALSE;
+    double sTempR[MAX_ST_RGR + 1], sTempR_expl[MAX_ST_RGR + 1],
+      oldsTempR[MAX_ST_RGR + 1], wpR[MAX_ST_RGR + 1], fcR[MAX_ST_RGR + 1],
+      vwcR[MAX_ST_RGR + 1], bDensityR[MAX_ST_RGR + 1];
+
+    for (i = 0; i <= nRgr + 1; i++) {
+      fcR[i] = 2.1;
+      wpR[i] = 1.5;
+      vwcR[i] = 1.6;
+      bDensityR[i] = 1.5;
+      // linear profile between the boundary conditions
+      oldsTempR[i] = T1 + (sTconst - T1) * i / (nRgr + 1.);
+    }
+
+    // A linear profile with unchanged boundaries is the steady state
+    soil_temperature_today_CN(deltaX, T1, sTconst, nRgr, sTempR, oldsTempR,
+      vwcR, wpR, fcR, bDensityR, csParam1, csParam2, shParam, &ptr_stError);
+
+    EXPECT_EQ(ptr_stError, 0);
+    EXPECT_EQ(sTempR[0], T1);
+    EXPECT_EQ(sTempR[nRgr + 1], sTconst);
+    for (i = 1; i <= nRgr; i++) {
+      EXPECT_NEAR(sTempR[i], oldsTempR[i], tol9);
+    }
+
+    // Agrees with the explicit solver where that is stable; the schemes
+    // differ most next to the surface where today's boundary value enters
+    // the explicit scheme fully (and the Crank-Nicolson scheme by half)
+    for (i = 0; i <= nRgr + 1; i++) {
+      oldsTempR[i] = sTconst + 5. * exp(-i / 5.);
+    }
+
+    soil_temperature_today(&delta_time, deltaX, T1, sTconst, nRgr, sTempR_expl,
+      oldsTempR, vwcR, wpR, fcR, bDensityR, csParam1, csParam2, shParam,
+      &ptr_stError);
+    EXPECT_EQ(ptr_stError, 0);
+    EXPECT_DOUBLE_EQ(delta_time, 86400.);
+
+    soil_temperature_today_CN(deltaX, T1, sTconst, nRgr, sTempR, oldsTempR,
+      vwcR, wpR, fcR, bDensityR, csParam1, csParam2, shParam, &ptr_stError);
+    EXPECT_EQ(ptr_stError, 0);
+
+    for (i = 1; i <= nRgr; i++) {
+      EXPECT_NEAR(sTempR[i], sTempR_expl[i], 1.);
+    }
+
+    // Stable with one daily time step where the explicit solver requires
+    // sub-daily time steps (here, parts > 0.5 for deltaX = 5 cm)
+    deltaX = 5.;
+    soil_temperature_today(&delta_time, deltaX, T1, sTconst, nRgr, sTempR_expl,
+      oldsTempR, vwcR, wpR, fcR, bDensityR, csParam1, csParam2, shParam,
+      &ptr_stError);
+    EXPECT_LT(delta_time, 86400.);
+
+    soil_temperature_today_CN(deltaX, T1, sTconst, nRgr, sTempR, oldsTempR,
+      vwcR, wpR, fcR, bDensityR, csParam1, csParam2, shParam, &ptr_stError);
+    EXPECT_EQ(ptr_stError, 0);
+
+    for (i = 1; i <= nRgr; i++) {
+      EXPECT_LE(sTempR[i], T1 + tol9);
+      EXPECT_GE(sTempR[i], sTconst - tol9);
+    }
+
+    // Error if soil temperature goes beyond +/- 100 C
+    for (i = 0; i <= nRgr + 1; i++) {
+      oldsTempR[i] = 150.;
+    }
+
+    soil_temperature_today_CN(deltaX, T1, sTconst, nRgr, sTempR, oldsTempR,
+      vwcR, wpR, fcR, bDensityR, csParam1, csParam2, shParam, &ptr_stError);
+    EXPECT_EQ(ptr_stError, 1);
+
+    // Reset to previous global state
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
   // Test main soil temperature function 'soil_temperature'
   // AND lyrTemp_to_lyrSoil_temperature as this function
   // is only called in the soil_temperature function
@@ -461,7 +652,7 @@ namespace {
     soil_temperature(airTemp, pet, aet, biomass, swc, swc_sat, bDensity, width,
       oldsTemp, sTemp, surfaceTemp, nlyrs, bmLimiter, t1Param1, t1Param2,
       t1Param3, csParam1, csParam2, shParam, snowdepth, sTconst, deltaX, theMaxDepth,
-      nRgr, snow, &ptr_stError);
+      nRgr, snow, SW_STMETHOD_EXPLICIT, &ptr_stError);
 
 
     // Expect that surface temp equals surface_temperature_under_snow() because snow > 0
@@ -475,7 +666,7 @@ namespace {
     soil_temperature(airTemp, pet, aet, biomass, swc, swc_sat, bDensity, width,
       oldsTemp, sTemp, surfaceTemp, nlyrs, bmLimiter, t1Param1, t1Param2,
       t1Param3, csParam1, csParam2, shParam, snowdepth, sTconst, deltaX, theMaxDepth,
-      nRgr, snow, &ptr_stError);
+      nRgr, snow, SW_STMETHOD_EXPLICIT, &ptr_stError);
 
     EXPECT_EQ(surfaceTemp[Today], airTemp + (t1Param1 * pet * (1. - (aet / pet)) * (1. - (biomass / bmLimiter))));
     EXPECT_NE(surfaceTemp[Today], airTemp + ((t1Param2 * (biomass - bmLimiter)) / t1Param3));
@@ -487,7 +678,7 @@ namespace {
     soil_temperature(airTemp, pet, aet, biomass, swc, swc_sat, bDensity, width,
       oldsTemp, sTemp, surfaceTemp, nlyrs, bmLimiter, t1Param1, t1Param2,
       t1Param3, csParam1, csParam2, shParam, snowdepth, sTconst, deltaX, theMaxDepth,
-      nRgr, snow, &ptr_stError);
+      nRgr, snow, SW_STMETHOD_EXPLICIT, &ptr_stError);
 
     EXPECT_EQ(surfaceTemp[Today], airTemp + ((t1Param2 * (biomass - bmLimiter)) / t1Param3));
     EXPECT_NE(surfaceTemp[Today], airTemp + (t1Param1 * pet * (1. - (aet / pet)) * (1. - (biomass / bmLimiter))));
@@ -538,7 +729,7 @@ namespace {
     soil_temperature(airTemp, pet, aet, biomass, swc, swc_sat, bDensity, width,
       oldsTemp2, sTemp2, surfaceTemp, nlyrs, bmLimiter, t1Param1, t1Param2,
       t1Param3, csParam1, csParam2, shParam, snowdepth, sTconst, deltaX, theMaxDepth,
-      nRgr, snow, &ptr_stError);
+      nRgr, snow, SW_STMETHOD_EXPLICIT, &ptr_stError);
 
     // Check that error has occurred as indicated by ptr_stError
     EXPECT_EQ(ptr_stError, swTRUE);
@@ -610,7 +801,7 @@ namespace {
     soil_temperature(airTemp, pet, aet, biomass, swc2, swc_sat2, bDensity2, width2,
       oldsTemp3, sTemp3, surfaceTemp, nlyrs2, bmLimiter, t1Param1, t1Param2,
       t1Param3, csParam1, csParam2, shParam, snowdepth, sTconst, deltaX, theMaxDepth,
-      nRgr, snow, &ptr_stError);
+      nRgr, snow, SW_STMETHOD_EXPLICIT, &ptr_stError);
 
     EXPECT_EQ(surfaceTemp[Today], surface_temperature_under_snow(airTemp, snow));
     EXPECT_NE(surfaceTemp[Today], airTemp + ((t1Param2 * (biomass - bmLimiter)) / t1Param3));
@@ -623,7 +814,7 @@ namespace {
     soil_temperature(airTemp, pet, aet, biomass, swc2, swc_sat2, bDensity2, width2,
       oldsTemp3, sTemp3, surfaceTemp, nlyrs2, bmLimiter, t1Param1, t1Param2,
       t1Param3, csParam1, csParam2, shParam, snowdepth, sTconst, deltaX, theMaxDepth,
-      nRgr, snow, &ptr_stError);
+      nRgr, snow, SW_STMETHOD_EXPLICIT, &ptr_stError);
 
     EXPECT_EQ(surfaceTemp[Today], airTemp + (t1Param1 * pet * (1. - (aet / pet)) * (1. - (biomass / bmLimiter))));
     EXPECT_NE(surfaceTemp[Today], airTemp + ((t1Param2 * (biomass - bmLimiter)) / t1Param3));
@@ -635,7 +826,7 @@ namespace {
     soil_temperature(airTemp, pet, aet, biomass, swc2, swc_sat2, bDensity2, width2,
       oldsTemp3, sTemp3, surfaceTemp, nlyrs2, bmLimiter, t1Param1, t1Param2,
       t1Param3, csParam1, csParam2, shParam, snowdepth, sTconst, deltaX, theMaxDepth,
-      nRgr, snow, &ptr_stError);
+      nRgr, snow, SW_STMETHOD_EXPLICIT, &ptr_stError);
 
     EXPECT_EQ(surfaceTemp[Today], airTemp + ((t1Param2 * (biomass - bmLimiter)) / t1Param3));
     EXPECT_NE(surfaceTemp[Today], airTemp + (t1Param1 * pet * (1. - (aet / pet)) * (1. - (biomass / bmLimiter))));
@@ -685,7 +876,7 @@ namespace {
     EXPECT_DEATH_IF_SUPPORTED(soil_temperature(airTemp, pet, aet, biomass, swc, swc_sat, bDensity, width,
       oldsTemp, sTemp, surfaceTemp, nlyrs, bmLimiter, t1Param1, t1Param2,
       t1Param3, csParam1, csParam2, shParam, snowdepth, sTconst, deltaX, theMaxDepth,
-      nRgr, snow, &ptr_stError), "@ generic.c LogError");
+      nRgr, snow, SW_STMETHOD_EXPLICIT, &ptr_stError), "@ generic.c LogError");
 
     //Reset to global state
     Reset_SOILWAT2_after_UnitTest();
@@ -0,0 +1,219 @@
+#include "gtest/gtest.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Files.h"
+#include "../SW_Site.h"
+#include "../SW_VegProd.h"
+#include "../SW_SoilWater.h"
+#include "../SW_Flow_lib.h"
+#include "../SW_Flow_offload.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+
+namespace
+{
+  // Five sites with 8 soil layers (one full and one partial block),
+  // followed by two sites with 6 soil layers (another partial block)
+  const unsigned int n_sites = 7, n_days = 60, n_period = 30;
+  const unsigned int site_nlyrs[n_sites] = {8, 8, 8, 8, 8, 6, 6};
+  const double tol = 1e-10;
+
+  void set_soillayers(unsigned int nlyrs) {
+    unsigned int i;
+
+    create_test_soillayers(nlyrs);
+    for (i = 0; i < nlyrs; i++) {
+      stValues.lyrFrozen[i] = swFALSE;
+    }
+  }
+
+  void setup_site(SW_OFL_SITE *s, unsigned int isite) {
+    unsigned int i;
+
+    set_soillayers(site_nlyrs[isite]);
+    SW_OFL_site_from_run(s, SW_SHRUB);
+
+    // sites range from dry to wet, from sparse to full vegetation cover
+    for (i = 0; i < s->n_layers; i++) {
+      s->swc[i] = s->swcmin[i] +
+        (0.2 + 0.1 * isite) * (s->swcsat[i] - s->swcmin[i]);
+    }
+    s->fCover = 0.2 + 0.8 * isite / (n_sites - 1.);
+    s->standingWater = (isite == 2) ? 0.3 : 0.;
+    s->s_veg = s->s_lit = 0.;
+  }
+
+  void get_forcing(SW_OFL_DAY *d, unsigned int isite, unsigned int doy) {
+    d->rain = (doy % (2 + isite % 3) == 0) ? 0.3 + 0.4 * isite : 0.;
+    d->pet = 0.15 + 0.03 * isite + 0.004 * doy;
+    d->rain_events = 1. + isite % 2;
+    d->lai_live = 0.4 + 0.2 * isite;
+    d->bLAI_total = d->lai_live + 0.3;
+    d->total_agb = 150. + 60. * isite;
+    d->biolive = 80. + 20. * isite;
+    d->biodead = 40. + 5. * doy;
+    d->litter = 60. + 10. * isite;
+  }
+
+  // Scalar reference: the kernels of SW_Flow_lib.c in the order of
+  // SW_Water_Flow() for a site with one vegetation type and without snow
+  void step_site(SW_OFL_SITE *s, const SW_OFL_DAY *d, SW_OFL_OUT *o) {
+    unsigned int i,
+      n_evap = SW_Site.n_evap_lyrs, n_transp = SW_Site.n_transp_lyrs[SW_SHRUB];
+    double
+      h2o = d->rain, int_veg, int_lit = 0., drainout = 0., aet = 0.,
+      drain[MAX_LAYERS], qty[MAX_LAYERS], fbse, fbst, swpavg,
+      evap_rate, transp_rate, evap_veg, evap_lit, evap_sw, peti, x;
+    tanfunc_t *ev = &s->evap, *tr = &s->transp, *sh = &s->shade;
+
+    veg_intercepted_water(&h2o, &int_veg, &s->s_veg, d->rain_events,
+      s->veg_kSmax, d->bLAI_total, s->fCover);
+    litter_intercepted_water(&h2o, &int_lit, &s->s_lit, d->rain_events,
+      s->lit_kSmax, d->litter, s->fCover);
+
+    infiltrate_water_high(s->swc, drain, &drainout, h2o, s->n_layers,
+      s->swcfc, s->swcsat, s->impermeability, &s->standingWater);
+
+    EsT_partitioning(&fbse, &fbst, d->lai_live, s->lai_param);
+    pot_soil_evap(&evap_rate, n_evap, s->evap_coeff, d->total_agb, fbse,
+      d->pet, ev->xinflec, ev->slope, ev->yinflec, ev->range, s->width,
+      s->swc, s->Es_param_limit);
+    transp_weighted_avg(&swpavg, s->n_transp_rgn, n_transp, s->transp_rgn,
+      s->transp_coeff, s->swc);
+    pot_transp(&transp_rate, swpavg, d->biolive, d->biodead, fbst, d->pet,
+      tr->xinflec, tr->slope, tr->yinflec, tr->range,
+      s->shade_scale, s->shade_deadmax,
+      sh->xinflec, sh->slope, sh->yinflec, sh->range, s->co2_wue);
+
+    evap_rate *= s->fCover;
+    transp_rate *= s->fCover;
+
+    evap_veg = fmax(0., fmin(d->pet * s->fCover, s->s_veg));
+    peti = d->pet - evap_veg / s->fCover;
+    evap_lit = fmax(0., fmin(peti, s->s_lit));
+    peti -= evap_lit;
+    evap_sw = fmax(0., fmin(peti, s->standingWater));
+
+    x = evap_lit + evap_sw;
+    x += evap_veg + evap_rate + transp_rate;
+    if (GT(x, d->pet)) {
+      x = d->pet / x;
+      evap_veg *= x;
+      evap_rate *= x;
+      transp_rate *= x;
+      evap_lit *= x;
+      evap_sw *= x;
+    }
+
+    evap_fromSurface(&s->s_veg, &evap_veg, &aet);
+    evap_fromSurface(&s->s_lit, &evap_lit, &aet);
+    evap_fromSurface(&s->standingWater, &evap_sw, &aet);
+    o->interception += int_veg + int_lit;
+    o->evap_surface += evap_veg + evap_lit + evap_sw;
+
+    remove_from_soil(s->swc, qty, &aet, n_evap, s->evap_coeff, evap_rate,
+      s->swc_halfwiltpt);
+    for (i = 0; i < n_evap; i++) {
+      o->evap_soil += qty[i];
+    }
+
+    remove_from_soil(s->swc, qty, &aet, n_transp, s->transp_coeff,
+      transp_rate, s->swc_crit);
+    for (i = 0; i < n_transp; i++) {
+      o->transp += qty[i];
+    }
+
+    infiltrate_water_low(s->swc, drain, &drainout, s->n_layers,
+      s->slow_drain_coeff, SLOW_DRAIN_DEPTH, s->swcfc, s->width, s->swcmin,
+      s->swcsat, s->impermeability, &s->standingWater);
+
+    o->aet += aet;
+    o->drainout += drainout;
+    for (i = 0; i < s->n_layers; i++) {
+      o->swc[i] += s->swc[i];
+    }
+  }
+
+
+  // Each site of the engine equals the scalar kernels with its inputs
+  TEST(SWFlowOffloadTest, EqualsScalarKernels)
+  {
+    SW_OFL_ENGINE e;
+    SW_OFL_SITE sites[n_sites], ref;
+    SW_OFL_DAY d;
+    SW_OFL_OUT out[n_days / n_period][n_sites], res, *o;
+    double swc[MAX_LAYERS];
+    unsigned int isite, doy, p, i;
+
+    for (isite = 0; isite < n_sites; isite++) {
+      setup_site(&sites[isite], isite);
+    }
+
+    SW_OFL_construct(&e, sites, n_sites);
+    EXPECT_EQ(3u, e.n_blocks);
+    EXPECT_EQ(1u, e.block[4]);
+    EXPECT_EQ(1u, e.lane[6]);
+
+    for (doy = 0; doy < n_days; doy++) {
+      for (isite = 0; isite < n_sites; isite++) {
+        get_forcing(&d, isite, doy);
+        SW_OFL_set_forcing(&e, isite, doy, &d);
+      }
+    }
+    SW_OFL_new_year(&e);
+
+    for (doy = 0; doy < n_days; doy++) {
+      SW_OFL_step_day(&e, doy);
+      if ((doy + 1) % n_period == 0) {
+        SW_OFL_end_period(&e, out[doy / n_period]);
+      }
+    }
+
+    for (isite = 0; isite < n_sites; isite++) {
+      set_soillayers(site_nlyrs[isite]);
+      ref = sites[isite];
+
+      for (p = 0; p < n_days / n_period; p++) {
+        memset(&res, 0, sizeof res);
+        for (doy = p * n_period; doy < (p + 1) * n_period; doy++) {
+          get_forcing(&d, isite, doy);
+          step_site(&ref, &d, &res);
+        }
+
+        o = &out[p][isite];
+        EXPECT_EQ(n_period, o->n_days);
+        EXPECT_NEAR(res.interception, o->interception, tol) << "site " << isite;
+        EXPECT_NEAR(res.evap_surface, o->evap_surface, tol) << "site " << isite;
+        EXPECT_NEAR(res.evap_soil, o->evap_soil, tol) << "site " << isite;
+        EXPECT_NEAR(res.transp, o->transp, tol) << "site " << isite;
+        EXPECT_NEAR(res.aet, o->aet, tol) << "site " << isite;
+        EXPECT_NEAR(res.drainout, o->drainout, tol) << "site " << isite;
+        for (i = 0; i < ref.n_layers; i++) {
+          EXPECT_NEAR(res.swc[i] / n_period, o->swc[i], tol)
+            << "site " << isite << " layer " << i;
+        }
+
+        // without snow, AET consists of evaporation and transpiration
+        EXPECT_NEAR(o->aet, o->evap_surface + o->evap_soil + o->transp, tol);
+      }
+
+      SW_OFL_get_swc(&e, isite, swc);
+      for (i = 0; i < ref.n_layers; i++) {
+        EXPECT_NEAR(ref.swc[i], swc[i], tol) << "site " << isite << " layer " << i;
+      }
+    }
+
+    SW_OFL_deconstruct(&e);
+    EXPECT_TRUE(isnull(e.blocks));
+  }
+}
@@ -32,12 +32,11 @@
 #include "../SW_Weather.h"
 #include "../SW_Markov.h"
 #include "../SW_Sky.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
 
-extern SW_MODEL SW_Model;
-extern SW_MARKOV SW_Markov;
 
 extern void (*test_mvnorm)(RealD *, RealD *, RealD, RealD, RealD, RealD, RealD);
 extern void (*test_temp_correct_wetdry)(RealD *, RealD *, RealD, RealD, RealD, RealD, RealD);
@@ -149,4 +148,77 @@ namespace {
     EXPECT_LE(tmin, tmax);
   }
 
+
+  // Test generating whole years of weather from per-site/replicate streams
+  TEST(WGTest, GenerateYears) {
+    SW_MARKOV mp;
+    pcg32_random_t rng0, rng1, rng2;
+    unsigned int i, week, n_years = 20, n_alloc = 20 * MAX_DAYS;
+    size_t d, n0, n1, n2, n_wet = 0, n_diff = 0;
+    RealD p[8][MAX_DAYS], m_tmax = 0., m_ppt = 0.,
+      *tmax0, *tmin0, *ppt0, *tmax1, *tmin1, *ppt1, *tmax2, *tmin2, *ppt2;
+
+    // Parameters: 30% wet days with 1 +/- 0.5 cm; tmax = 10 +/- 2 C
+    for (d = 0; d < MAX_DAYS; d++) {
+      p[0][d] = p[1][d] = 0.3;
+      p[2][d] = 1.;
+      p[3][d] = 0.5;
+      for (i = 4; i < 8; i++) {
+        p[i][d] = 0.;
+      }
+    }
+    mp.wetprob = p[0]; mp.dryprob = p[1]; mp.avg_ppt = p[2]; mp.std_ppt = p[3];
+    mp.cfxw = p[4]; mp.cfxd = p[5]; mp.cfnw = p[6]; mp.cfnd = p[7];
+    for (week = 0; week < MAX_WEEKS; week++) {
+      mp.u_cov[week][0] = 10.;
+      mp.u_cov[week][1] = 0.;
+      mp.v_cov[week][0][0] = 4.;
+      mp.v_cov[week][1][1] = 3.;
+      mp.v_cov[week][0][1] = mp.v_cov[week][1][0] = 1.;
+    }
+
+    tmax0 = (RealD *) malloc(9 * n_alloc * sizeof(RealD));
+    tmin0 = tmax0 + n_alloc; ppt0 = tmin0 + n_alloc;
+    tmax1 = ppt0 + n_alloc; tmin1 = tmax1 + n_alloc; ppt1 = tmin1 + n_alloc;
+    tmax2 = ppt1 + n_alloc; tmin2 = tmax2 + n_alloc; ppt2 = tmin2 + n_alloc;
+
+    SW_MKV_seed_stream(&rng0, 42, 7, 0);
+    SW_MKV_seed_stream(&rng1, 42, 7, 0); // same site and replicate as rng0
+    SW_MKV_seed_stream(&rng2, 42, 7, 1); // other replicate of the same site
+
+    n0 = SW_MKV_generate_years(&mp, &rng0, 1980, n_years, tmax0, tmin0, ppt0);
+    n1 = SW_MKV_generate_years(&mp, &rng1, 1980, n_years, tmax1, tmin1, ppt1);
+    n2 = SW_MKV_generate_years(&mp, &rng2, 1980, n_years, tmax2, tmin2, ppt2);
+
+    // 20 years with 5 leap years
+    EXPECT_EQ(n0, (size_t) 7305);
+    EXPECT_EQ(n1, n0);
+    EXPECT_EQ(n2, n0);
+
+    for (d = 0; d < n0; d++) {
+      // Same stream: identical weather
+      EXPECT_DOUBLE_EQ(tmax0[d], tmax1[d]);
+      EXPECT_DOUBLE_EQ(tmin0[d], tmin1[d]);
+      EXPECT_DOUBLE_EQ(ppt0[d], ppt1[d]);
+      n_diff += (tmax0[d] == tmax2[d]) ? 0 : 1;
+
+      EXPECT_LE(tmin0[d], tmax0[d]);
+      EXPECT_GE(ppt0[d], 0.);
+
+      n_wet += (ppt0[d] > 0.) ? 1 : 0;
+      m_tmax += tmax0[d];
+      m_ppt += ppt0[d];
+    }
+
+    // Other replicate: different weather
+    EXPECT_GT(n_diff, n0 - 10);
+
+    // Sample statistics (standard errors are about 0.005, 0.02, and 0.01)
+    EXPECT_NEAR((double) n_wet / n0, 0.3, 0.03);
+    EXPECT_NEAR(m_tmax / n0, 10., 0.1);
+    EXPECT_NEAR(m_ppt / n_wet, 1., 0.05);
+
+    free(tmax0);
+  }
+
 } // namespace
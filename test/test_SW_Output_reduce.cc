@@ -0,0 +1,199 @@
+#include "gtest/gtest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Model.h"
+#include "../SW_Site.h"
+#include "../SW_SoilWater.h"
+#include "../SW_Control.h"
+#include "../SW_Output_reduce.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+extern char _firstfile[];
+
+
+namespace {
+  // A reducer that counts the calls of its functions
+  typedef struct {
+    unsigned int n_days, n_years;
+  } CallCounts;
+
+  void count_day(void *data) {
+    ((CallCounts *) data)->n_days++;
+  }
+
+  void count_year(void *data) {
+    ((CallCounts *) data)->n_years++;
+  }
+
+
+  // Reducers see each simulated day and year; summary statistics match
+  // the daily state of a run that is advanced one day at a time
+  TEST(OutputReduceTest, Summary) {
+    SW_RUN *sw = (SW_RUN *) Mem_Calloc(1, sizeof(SW_RUN), "OutputReduceTest");
+    SW_OUT_SUMMARY summary;
+    CallCounts counts = {0, 0};
+    SW_DAY_STATE day;
+    TimeInt year, n_years;
+    unsigned int n_days = 0, b, n_bins = 0;
+    RealD aet = 0., deep = 0., swa, swa_sum = 0.;
+    LyrIndex i;
+
+    // Run with reducers
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_CTL_init_run(sw);
+
+    SW_OUT_init_summary(&summary, 0.5);
+    SW_OUT_add_summary(&summary);
+    SW_OUT_add_reducer(count_day, count_year, &counts);
+    SW_CTL_main(sw);
+
+    n_years = SW_Model.endyr - SW_Model.startyr + 1;
+    SW_CTL_clear_model(sw, swTRUE);
+    memset(sw, 0, sizeof(SW_RUN));
+
+    // Reference: daily state of a run without reducers
+    SW_CTL_setup_model(sw, _firstfile);
+    SW_CTL_read_inputs_from_disk(sw);
+    SW_CTL_init_run(sw);
+
+    for (year = SW_Model.startyr; year <= SW_Model.endyr; year++) {
+      SW_CTL_begin_year(sw, year);
+
+      while (SW_CTL_begin_day(sw, &day)) {
+        SW_CTL_water_flow(sw, &day);
+
+        n_days++;
+        aet += SW_Soilwat.aet;
+        if (SW_Site.deepdrain) {
+          deep += SW_Soilwat.swcBulk[Today][SW_Site.deep_lyr];
+        }
+
+        swa = 0.;
+        for (i = 0; i < day.n_layers; i++) {
+          swa += fmax(day.swcBulk[i] - SW_Site.swcBulk_wiltpt[i], 0.);
+        }
+        swa_sum += swa;
+
+        SW_CTL_end_day(sw);
+      }
+
+      SW_CTL_end_year(sw);
+    }
+
+    EXPECT_EQ(n_days, counts.n_days);
+    EXPECT_EQ(n_years, counts.n_years);
+    EXPECT_EQ(n_days, summary.n_days);
+    EXPECT_EQ(n_years, summary.n_years);
+
+    EXPECT_NEAR(aet, summary.aet, 1e-9);
+    EXPECT_NEAR(deep, summary.deep, 1e-9);
+    EXPECT_NEAR(swa_sum, summary.swa, 1e-9);
+    EXPECT_LE(summary.swa_min, summary.swa_max);
+
+    for (b = 0; b < SW_OUT_SUMMARY_NBINS; b++) {
+      n_bins += summary.swa_bins[b];
+    }
+    EXPECT_EQ(n_days, n_bins);
+
+    SW_CTL_clear_model(sw, swTRUE);
+    Mem_Free(sw);
+    SW_CTL_activate_run(NULL);
+  }
+
+
+  // A row of summary statistics holds the values of the key-value lines
+  TEST(OutputReduceTest, SummaryRow) {
+    SW_OUT_SUMMARY summary;
+    FILE *f1 = tmpfile(), *f2 = tmpfile();
+    char line[256], header[4096], row[4096], *name, *value, *s1, *s2;
+    unsigned int n = 0;
+
+    SW_OUT_init_summary(&summary, 0.5);
+    summary.n_years = 2;
+    summary.n_days = 730;
+    summary.aet = 80.;
+    summary.aet_sq = 3250.;
+    summary.pet = 200.;
+    summary.deep = 10.;
+    summary.swa = 730. * 3.;
+    summary.swa_min = 0.;
+    summary.swa_max = 9.;
+    summary.swa_bins[6] = 730;
+
+    SW_OUT_write_summary(f1, &summary);
+    SW_OUT_write_summary_header(f2, 0.5);
+    fprintf(f2, "\n");
+    SW_OUT_write_summary_row(f2, &summary);
+    fprintf(f2, "\n");
+
+    rewind(f1);
+    rewind(f2);
+    ASSERT_TRUE(NULL != fgets(header, sizeof header, f2));
+    ASSERT_TRUE(NULL != fgets(row, sizeof row, f2));
+    header[strcspn(header, "\n")] = '\0';
+    row[strcspn(row, "\n")] = '\0';
+
+    // each column is preceded by a comma
+    ASSERT_EQ(',', header[0]);
+    ASSERT_EQ(',', row[0]);
+    name = strtok_r(header + 1, ",", &s1);
+    value = strtok_r(row + 1, ",", &s2);
+
+    while (NULL != fgets(line, sizeof line, f1)) {
+      line[strcspn(line, "\n")] = '\0';
+      ASSERT_TRUE(NULL != name);
+      ASSERT_TRUE(NULL != value);
+      EXPECT_EQ(std::string(line), std::string(name) + "," + value);
+
+      name = strtok_r(NULL, ",", &s1);
+      value = strtok_r(NULL, ",", &s2);
+      n++;
+    }
+    EXPECT_EQ(NULL, name);
+    EXPECT_EQ(9u + SW_OUT_SUMMARY_NBINS, n);
+
+    // a failed run has no values
+    rewind(f2);
+    SW_OUT_write_summary_row(f2, NULL);
+    fprintf(f2, "\n");
+    rewind(f2);
+    ASSERT_TRUE(NULL != fgets(row, sizeof row, f2));
+    EXPECT_EQ(0, strncmp(row, ",NA,NA,", 7));
+
+    fclose(f1);
+    fclose(f2);
+  }
+
+
+  // A run has a limited number of reducers
+  TEST(OutputReduceTest, TooManyReducers) {
+    CallCounts counts = {0, 0};
+    int k;
+
+    SW_OUT_clear_reducers();
+    for (k = 0; k < SW_OUT_MAX_REDUCERS; k++) {
+      SW_OUT_add_reducer(count_day, NULL, &counts);
+    }
+
+    EXPECT_DEATH_IF_SUPPORTED(
+      SW_OUT_add_reducer(count_day, NULL, &counts),
+      "@ generic.c LogError"
+    );
+
+    // Reset to previous global state
+    SW_OUT_clear_reducers();
+  }
+
+} // namespace
@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Files.h"
+#include "../SW_Model.h"
+#include "../SW_Carbon.h"
+#include "../SW_Markov.h"
+#include "../SW_Shared.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+
+namespace {
+
+  // Tables are identified by file, contents, and key; a table is added once
+  TEST(SharedTest, Tables) {
+    SW_SHARED_INPUTS shared;
+    SW_SHARED_ID id1, id2, id3;
+    int *t1 = (int *) malloc(sizeof(int)), *t2 = (int *) malloc(sizeof(int));
+
+    memset(&shared, 0, sizeof shared);
+    *t1 = 1;
+    *t2 = 2;
+
+    SW_SHR_id(&id1, eCarbon, "RCP85", "0 RCP85\n2000 370.\n");
+    SW_SHR_id(&id2, eCarbon, "RCP45", "0 RCP85\n2000 370.\n");
+    SW_SHR_id(&id3, eMarkovProb, "RCP85", "0 RCP85\n2000 370.\n");
+    EXPECT_EQ(id1.hash, id2.hash);
+
+    EXPECT_TRUE(isnull(SW_SHR_get(&shared, &id1)));
+    EXPECT_EQ(t1, SW_SHR_put(&shared, &id1, t1));
+    EXPECT_EQ(t1, SW_SHR_get(&shared, &id1));
+    EXPECT_TRUE(isnull(SW_SHR_get(&shared, &id2)));
+    EXPECT_TRUE(isnull(SW_SHR_get(&shared, &id3)));
+
+    // another run added the same table in the meantime: `t2` is freed
+    EXPECT_EQ(t1, SW_SHR_put(&shared, &id1, t2));
+    EXPECT_EQ(1u, shared.n_tables);
+    EXPECT_EQ(1u, shared.n_hits);
+
+    SW_SHR_deconstruct(&shared);
+    EXPECT_TRUE(isnull(shared.head));
+  }
+
+
+  // Runs that share CO2 concentrations use the values of their own reading
+  TEST(SharedTest, CarbonScenario) {
+    SW_SHARED_INPUTS shared;
+    double ppm[MAX_NYEAR];
+    const double *ppm_shared;
+    TimeInt year;
+    SW_CARBON *c = &SW_Carbon;
+
+    memset(&shared, 0, sizeof shared);
+
+    // Reference: a run that reads its own CO2 concentrations
+    SW_CBN_deconstruct();
+    SW_CBN_construct();
+    strcpy(c->scenario, "RCP85");
+    c->use_bio_mult = c->use_wue_mult = 1;
+    SW_CBN_read();
+    EXPECT_FALSE(c->shares_ppm);
+    memcpy(ppm, c->ppm, sizeof ppm);
+    SW_CBN_deconstruct();
+
+    // The first run adds the scenario, the second run uses it
+    SW_CurrentRun->Shared = &shared;
+
+    SW_CBN_construct();
+    EXPECT_TRUE(isnull(c->ppm));
+    strcpy(c->scenario, "RCP85");
+    c->use_bio_mult = c->use_wue_mult = 1;
+    SW_CBN_read();
+    EXPECT_TRUE(c->shares_ppm);
+    ppm_shared = c->ppm;
+    SW_CBN_deconstruct();
+
+    SW_CBN_construct();
+    strcpy(c->scenario, "RCP85");
+    c->use_bio_mult = c->use_wue_mult = 1;
+    SW_CBN_read();
+    EXPECT_EQ(ppm_shared, c->ppm);
+    EXPECT_EQ(1u, shared.n_tables);
+    EXPECT_EQ(1u, shared.n_hits);
+
+    for (year = SW_Model.startyr + SW_Model.addtl_yr;
+      year <= SW_Model.endyr + SW_Model.addtl_yr; year++) {
+      EXPECT_DOUBLE_EQ(ppm[year], c->ppm[year]);
+    }
+
+    // Another scenario of the same file is a different table
+    SW_CBN_deconstruct();
+    SW_CBN_construct();
+    strcpy(c->scenario, "RCP45");
+    c->use_bio_mult = c->use_wue_mult = 1;
+    SW_CBN_read();
+    EXPECT_NE(ppm_shared, c->ppm);
+    EXPECT_EQ(2u, shared.n_tables);
+    SW_CBN_deconstruct();
+
+    // Reset to previous global state
+    SW_CurrentRun->Shared = NULL;
+    SW_SHR_deconstruct(&shared);
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
+  // Runs that share weather generator parameters use the values of their own reading
+  TEST(SharedTest, MarkovParameters) {
+    SW_SHARED_INPUTS shared;
+    SW_MARKOV ref, *m = &SW_Markov;
+    RealD wetprob[MAX_DAYS], cfnd[MAX_DAYS];
+    int i;
+
+    memset(&shared, 0, sizeof shared);
+
+    // Reference: a run that reads its own parameters
+    SW_MKV_construct();
+    ASSERT_TRUE(SW_MKV_read_prob());
+    ASSERT_TRUE(SW_MKV_read_cov());
+    EXPECT_FALSE(m->shares_prob);
+    EXPECT_FALSE(m->shares_cov);
+    memcpy(&ref, m, sizeof ref);
+    memcpy(wetprob, m->wetprob, sizeof wetprob);
+    memcpy(cfnd, m->cfnd, sizeof cfnd);
+    SW_MKV_deconstruct();
+
+    // Two runs share the parameters
+    SW_CurrentRun->Shared = &shared;
+
+    for (i = 0; i < 2; i++) {
+      SW_MKV_construct();
+      EXPECT_TRUE(isnull(m->wetprob));
+      ASSERT_TRUE(SW_MKV_read_prob());
+      ASSERT_TRUE(SW_MKV_read_cov());
+      EXPECT_TRUE(m->shares_prob);
+      EXPECT_TRUE(m->shares_cov);
+
+      EXPECT_EQ(0, memcmp(wetprob, m->wetprob, sizeof wetprob));
+      EXPECT_EQ(0, memcmp(cfnd, m->cfnd, sizeof cfnd));
+      EXPECT_EQ(0, memcmp(ref.u_cov, m->u_cov, sizeof ref.u_cov));
+      EXPECT_EQ(0, memcmp(ref.v_cov, m->v_cov, sizeof ref.v_cov));
+
+      SW_MKV_deconstruct();
+      EXPECT_TRUE(isnull(m->wetprob));
+    }
+
+    EXPECT_EQ(2u, shared.n_tables);
+    EXPECT_EQ(2u, shared.n_hits);
+
+    // Reset to previous global state
+    SW_CurrentRun->Shared = NULL;
+    SW_SHR_deconstruct(&shared);
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+} // namespace
@@ -34,15 +34,11 @@
 #include "../SW_Weather.h"
 #include "../SW_Markov.h"
 #include "../SW_Sky.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
 
-extern SW_CARBON SW_Carbon;
-extern SW_MODEL SW_Model;
-extern SW_VEGPROD SW_VegProd;
-extern SW_SITE SW_Site;
-extern LyrIndex _TranspRgnBounds[];
 
 
 namespace {
@@ -56,31 +52,35 @@ namespace {
     water_eqn(fractionGravel, sand, clay, n);
 
     // Test swcBulk_saturated
-    EXPECT_GT(SW_Site.lyr[n]->swcBulk_saturated, 0.); // The swcBulk_saturated should be greater than 0
-    EXPECT_LT(SW_Site.lyr[n]->swcBulk_saturated, SW_Site.lyr[n]->width); // The swcBulk_saturated can't be greater than the width of the layer
+    EXPECT_GT(SW_Site.swcBulk_saturated[n], 0.); // The swcBulk_saturated should be greater than 0
+    EXPECT_LT(SW_Site.swcBulk_saturated[n], SW_Site.width[n]); // The swcBulk_saturated can't be greater than the width of the layer
 
     // Test thetasMatric
-    EXPECT_GT(SW_Site.lyr[n]->thetasMatric, 36.3); /* Value should always be greater
+    EXPECT_GT(SW_Site.thetasMatric[n], 36.3); /* Value should always be greater
     than 36.3 based upon complete consideration of potential range of sand and clay values */
-    EXPECT_LT(SW_Site.lyr[n]->thetasMatric, 46.8); /* Value should always be less
+    EXPECT_LT(SW_Site.thetasMatric[n], 46.8); /* Value should always be less
     than 46.8 based upon complete consideration of potential range of sand and clay values */
-    EXPECT_DOUBLE_EQ(SW_Site.lyr[n]->thetasMatric,  44.593); /* If sand is .33 and
+    EXPECT_DOUBLE_EQ(SW_Site.thetasMatric[n],  44.593); /* If sand is .33 and
     clay is .33, thetasMatric should be 44.593 */
 
     // Test psisMatric
-    EXPECT_GT(SW_Site.lyr[n]->psisMatric, 3.890451); /* Value should always be greater
+    EXPECT_GT(SW_Site.psisMatric[n], 3.890451); /* Value should always be greater
     than 3.890451 based upon complete consideration of potential range of sand and clay values */
-    EXPECT_LT(SW_Site.lyr[n]->psisMatric,  34.67369); /* Value should always be less
+    EXPECT_LT(SW_Site.psisMatric[n],  34.67369); /* Value should always be less
     than 34.67369 based upon complete consideration of potential range of sand and clay values */
-    EXPECT_DOUBLE_EQ(SW_Site.lyr[n]->psisMatric, 27.586715750763947); /* If sand is
+    #ifdef SW_FAST_MATH
+    EXPECT_NEAR(SW_Site.psisMatric[n], 27.586715750763947, 1e-8 * 27.6);
+    #else
+    EXPECT_DOUBLE_EQ(SW_Site.psisMatric[n], 27.586715750763947); /* If sand is
     .33 and clay is .33, psisMatric should be 27.5867 */
+    #endif
 
     // Test bMatric
-    EXPECT_GT(SW_Site.lyr[n]->bMatric, 2.8); /* Value should always be greater than
+    EXPECT_GT(SW_Site.bMatric[n], 2.8); /* Value should always be greater than
     2.8 based upon complete consideration of potential range of sand and clay values */
-    EXPECT_LT(SW_Site.lyr[n]->bMatric, 18.8); /* Value should always be less
+    EXPECT_LT(SW_Site.bMatric[n], 18.8); /* Value should always be less
     than 18.8 based upon complete consideration of potential range of sand and clay values */
-    EXPECT_DOUBLE_EQ(SW_Site.lyr[n]->bMatric, 8.182); /* If sand is .33 and clay is .33,
+    EXPECT_DOUBLE_EQ(SW_Site.bMatric[n], 8.182); /* If sand is .33 and clay is .33,
     thetasMatric should be 8.182 */
 
     // Reset to previous global states
@@ -131,7 +131,7 @@ namespace {
       // Quickly calculate soil depth for current region as output information
       soildepth = 0.;
       for (id = 0; id <= _TranspRgnBounds[i]; ++id) {
-        soildepth += SW_Site.lyr[id]->width;
+        soildepth += SW_Site.width[id];
       }
 
       EXPECT_EQ(prev_TranspRgnBounds[i], _TranspRgnBounds[i]) <<
@@ -153,7 +153,7 @@ namespace {
 
     // Check that setting one region for one soil layer works
     nRegions = 1;
-    RealD regionLowerBounds3[] = {SW_Site.lyr[0]->width};
+    RealD regionLowerBounds3[] = {SW_Site.width[0]};
     derive_soilRegions(nRegions, regionLowerBounds3);
 
     for (i = 0; i < nRegions; ++i) {
@@ -168,7 +168,7 @@ namespace {
     // Example: one region each for the topmost soil layers
     soildepth = 0.;
     for (i = 0; i < nRegions; ++i) {
-      soildepth += SW_Site.lyr[i]->width;
+      soildepth += SW_Site.width[i];
       regionLowerBounds4[i] = soildepth;
     }
     derive_soilRegions(nRegions, regionLowerBounds4);
@@ -184,4 +184,54 @@ namespace {
     Reset_SOILWAT2_after_UnitTest();
   }
 
+
+  // Test that pedotransfer parameters from the texture cache are identical
+  // to those calculated by 'water_eqn'
+  TEST(SWSiteTest, TextureCache) {
+    LyrIndex s;
+    int k;
+    RealD thetas, psis, b, swc_sat, fieldcap, wiltpt;
+
+    // a new texture for every second layer: the first run of
+    // 'SW_SIT_init_run' calculates and caches it, the second one looks it up
+    ForEachSoilLayer(s) {
+      if (s % 2 == 0) {
+        SW_Site.fractionWeightMatric_sand[s] = 0.4123;
+        SW_Site.fractionWeightMatric_clay[s] = 0.2171;
+      }
+    }
+
+    for (k = 0; k < 2; k++) {
+      SW_SIT_init_run();
+
+      ForEachSoilLayer(s) {
+        thetas = SW_Site.thetasMatric[s];
+        psis = SW_Site.psisMatric[s];
+        b = SW_Site.bMatric[s];
+        swc_sat = SW_Site.swcBulk_saturated[s];
+        fieldcap = SW_Site.swcBulk_fieldcap[s];
+        wiltpt = SW_Site.swcBulk_wiltpt[s];
+
+        water_eqn(
+          SW_Site.fractionVolBulk_gravel[s],
+          SW_Site.fractionWeightMatric_sand[s],
+          SW_Site.fractionWeightMatric_clay[s],
+          s
+        );
+
+        EXPECT_EQ(SW_Site.thetasMatric[s], thetas) << "layer " << s + 1;
+        EXPECT_EQ(SW_Site.psisMatric[s], psis) << "layer " << s + 1;
+        EXPECT_EQ(SW_Site.bMatric[s], b) << "layer " << s + 1;
+        EXPECT_EQ(SW_Site.swcBulk_saturated[s], swc_sat) << "layer " << s + 1;
+        EXPECT_EQ(SW_Site.width[s] * SW_SWPmatric2VWCBulk(
+          SW_Site.fractionVolBulk_gravel[s], 0.333, s), fieldcap) << "layer " << s + 1;
+        EXPECT_EQ(SW_Site.width[s] * SW_SWPmatric2VWCBulk(
+          SW_Site.fractionVolBulk_gravel[s], 15, s), wiltpt) << "layer " << s + 1;
+      }
+    }
+
+    // Reset to previous global states
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
 } // namespace
@@ -15,11 +15,9 @@
 #include "../SW_VegProd.h"
 #include "../SW_Site.h"
 #include "../SW_Flow_lib.h"
+#include "../SW_Run.h"
 #include "sw_testhelpers.h"
 
-extern SW_MODEL SW_Model;
-extern SW_SITE SW_Site;
-extern SW_VEGPROD SW_VegProd;
 
 namespace{
   // Test the 'SW_SoilWater' function 'SW_VWCBulkRes'
@@ -116,7 +114,7 @@ namespace{
 
   // Test the 'SW_SoilWater' function 'SW_SWCbulk2SWPmatric'
   TEST(SWSoilWaterTest, SWSWCbulk2SWPmatric){
-    // Note: function `SW_SWCbulk2SWPmatric` accesses `SW_Site.lyr[n]`
+    // Note: function `SW_SWCbulk2SWPmatric` accesses the properties of layer `n` in `SW_Site`
 
     RealD tol = 1e-2; // pedotransfer functions are not very exact
     RealD fractionGravel = 0.2;
@@ -134,32 +132,32 @@ namespace{
     EXPECT_EQ(res, 0.0);
 
     // if swc > field capacity, then we expect res < 0.33 bar
-    res = SW_SWCbulk2SWPmatric(SW_Site.lyr[n]->fractionVolBulk_gravel,
-      SW_Site.lyr[n]->swcBulk_fieldcap + 0.1, n);
+    res = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[n],
+      SW_Site.swcBulk_fieldcap[n] + 0.1, n);
     EXPECT_LT(res, 0.33 + tol);
 
     // if swc = field capacity, then we expect res == 0.33 bar
-    res = SW_SWCbulk2SWPmatric(SW_Site.lyr[n]->fractionVolBulk_gravel,
-      SW_Site.lyr[n]->swcBulk_fieldcap, n);
+    res = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[n],
+      SW_Site.swcBulk_fieldcap[n], n);
     EXPECT_NEAR(res, 0.33, tol);
 
     // if field capacity > swc > wilting point, then
     // we expect 15 bar > res > 0.33 bar
-    swcBulk = (SW_Site.lyr[n]->swcBulk_fieldcap +
-      SW_Site.lyr[n]->swcBulk_wiltpt) / 2;
-    res = SW_SWCbulk2SWPmatric(SW_Site.lyr[n]->fractionVolBulk_gravel,
+    swcBulk = (SW_Site.swcBulk_fieldcap[n] +
+      SW_Site.swcBulk_wiltpt[n]) / 2;
+    res = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[n],
       swcBulk, n);
     EXPECT_GT(res, 0.33 - tol);
     EXPECT_LT(res, 15 + tol);
 
     // if swc = wilting point, then we expect res == 15 bar
-    res = SW_SWCbulk2SWPmatric(SW_Site.lyr[n]->fractionVolBulk_gravel,
-      SW_Site.lyr[n]->swcBulk_wiltpt, n);
+    res = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[n],
+      SW_Site.swcBulk_wiltpt[n], n);
     EXPECT_NEAR(res, 15., tol);
 
     // if swc < wilting point, then we expect res > 15 bar
-    swcBulk = (SW_Site.lyr[n]->swcBulk_wiltpt) / 2;
-    res = SW_SWCbulk2SWPmatric(SW_Site.lyr[n]->fractionVolBulk_gravel,
+    swcBulk = (SW_Site.swcBulk_wiltpt[n]) / 2;
+    res = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[n],
       swcBulk, n);
     EXPECT_GT(res, 15. - tol);
 
@@ -173,26 +171,26 @@ namespace{
     // `SWSWCbulk2SWPmatricDeathTest`: we cannot test it here because the
     // Address Sanitizer would complain with `UndefinedBehaviorSanitizer`
     // see [issue #231](https://github.com/DrylandEcology/SOILWAT2/issues/231)
-    // res = SW_SWCbulk2SWPmatric(1., SW_Site.lyr[n]->swcBulk_fieldcap, n);
+    // res = SW_SWCbulk2SWPmatric(1., SW_Site.swcBulk_fieldcap[n], n);
     // EXPECT_DOUBLE_EQ(res, 0.); // SWP "ought to be" infinity [bar]
 
     // if theta(sat, matric; Cosby et al. 1984) == 0: would be division by zero
     // this situation does normally not occur because it is
     // checked during input by function `water_eqn`
-    help = SW_Site.lyr[n]->thetasMatric;
-    SW_Site.lyr[n]->thetasMatric = 0.;
-    res = SW_SWCbulk2SWPmatric(SW_Site.lyr[n]->fractionVolBulk_gravel, 0., n);
+    help = SW_Site.thetasMatric[n];
+    SW_Site.thetasMatric[n] = 0.;
+    res = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[n], 0., n);
     EXPECT_DOUBLE_EQ(res, 0.); // SWP "ought to be" infinity [bar]
-    SW_Site.lyr[n]->thetasMatric = help;
+    SW_Site.thetasMatric[n] = help;
 
     // if lyr->width == 0: would be division by zero
     // this situation does normally not occur because it is
     // checked during input by function `_read_layers`
-    help = SW_Site.lyr[n]->bMatric;
-    SW_Site.lyr[n]->width = 0.;
-     res = SW_SWCbulk2SWPmatric(SW_Site.lyr[n]->fractionVolBulk_gravel, 0., n);
+    help = SW_Site.bMatric[n];
+    SW_Site.width[n] = 0.;
+     res = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[n], 0., n);
     EXPECT_DOUBLE_EQ(res, 0.); // swc < width
-    SW_Site.lyr[n]->width = help;
+    SW_Site.width[n] = help;
 
 
     // No need to reset to previous global states because we didn't change any
@@ -208,7 +206,7 @@ namespace{
 
     // if swc < 0: water content can physically not be negative
     EXPECT_DEATH_IF_SUPPORTED(SW_SWCbulk2SWPmatric(
-      SW_Site.lyr[n]->fractionVolBulk_gravel, -1., n),
+      SW_Site.fractionVolBulk_gravel[n], -1., n),
       "@ generic.c LogError");
 
     // if theta1 == 0 (i.e., gravel == 1) && lyr->bMatric == 0:
@@ -216,12 +214,12 @@ namespace{
     // note: this case is in normally prevented due to checks of inputs by
     // function `water_eqn` for `bMatric` and function `_read_layers` for
     // `gravelFraction`
-    help = SW_Site.lyr[n]->bMatric;
-    SW_Site.lyr[n]->bMatric = 0.;
+    help = SW_Site.bMatric[n];
+    SW_Site.bMatric[n] = 0.;
     EXPECT_DEATH_IF_SUPPORTED(SW_SWCbulk2SWPmatric(
-      1., SW_Site.lyr[n]->swcBulk_fieldcap, n),
+      1., SW_Site.swcBulk_fieldcap[n], n),
       "@ generic.c LogError");
-    SW_Site.lyr[n]->bMatric = help;
+    SW_Site.bMatric[n] = help;
 
     // Reset to previous global states
     Reset_SOILWAT2_after_UnitTest();
@@ -235,9 +233,9 @@ namespace{
     RealD tExpect, t, actualExpectDiff;
     int i;
     LyrIndex n = 0;
-    SW_Site.lyr[n]->thetasMatric = thetaMatric;
-    SW_Site.lyr[n]->psisMatric = psisMatric;
-    SW_Site.lyr[n]->bMatric = binverseMatric;
+    SW_Site.thetasMatric[n] = thetaMatric;
+    SW_Site.psisMatric[n] = psisMatric;
+    SW_Site.bMatric[n] = binverseMatric;
 
     // set gravel fractions on the interval [.0, .8], step .05
     for (i = 0; i <= 16; i++){
@@ -261,4 +259,69 @@ namespace{
     // Reset to previous global states
     Reset_SOILWAT2_after_UnitTest();
   }
+
+
+  // Test the batch and cached variants of 'SW_SWCbulk2SWPmatric'
+  TEST(SWSoilWaterTest, SWSWCbulk2SWPmatricProfile){
+    LyrIndex i, n = MAX_LAYERS;
+    RealD swc[MAX_LAYERS], swp[MAX_LAYERS], expected;
+    const RealD *swp_cached;
+
+    create_test_soillayers(n);
+
+    ForEachSoilLayer(i) {
+      swc[i] = (SW_Site.swcBulk_fieldcap[i] + SW_Site.swcBulk_wiltpt[i]) / 2.;
+    }
+    swc[1] = 0.; // zero soil water content: swp is 0
+    swc[2] = SW_MISSING; // missing soil water content: swp is 0
+
+    SW_SWCbulk2SWPmatric_profile(swc, swp, n);
+    swp_cached = SW_SWCbulk2SWPmatric_cached(swc, n);
+
+    ForEachSoilLayer(i) {
+      expected = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[i], swc[i], i);
+      EXPECT_NEAR(swp[i], expected, tol9 * fmax(1., fabs(expected)));
+      EXPECT_DOUBLE_EQ(swp_cached[i], swp[i]);
+    }
+
+    // Change one layer: cached values must be updated
+    swc[n - 1] *= 2.;
+    swp_cached = SW_SWCbulk2SWPmatric_cached(swc, n);
+    expected = SW_SWCbulk2SWPmatric(SW_Site.fractionVolBulk_gravel[n - 1],
+      swc[n - 1], n - 1);
+    EXPECT_NEAR(swp_cached[n - 1], expected, tol9 * fmax(1., fabs(expected)));
+    EXPECT_DOUBLE_EQ(swp_cached[0], swp[0]);
+
+    // Reset to previous global states
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
+  // Test that 'SW_SWC_end_day' makes today's values become yesterday's values
+  TEST(SWSoilWaterTest, SWSWCEndDay){
+    LyrIndex i;
+    RealD *sTemp_today = SW_Soilwat.sTemp;
+
+    ForEachSoilLayer(i) {
+      SW_Soilwat.swcBulk[Today][i] = 1. + i;
+      SW_Soilwat.sTemp[i] = 10. + i;
+    }
+    SW_Soilwat.snowpack[Today] = 3.;
+
+    SW_SWC_end_day();
+
+    // soil temperature buffers are swapped
+    EXPECT_EQ(SW_Soilwat.sTemp_yesterday, sTemp_today);
+    EXPECT_NE(SW_Soilwat.sTemp, sTemp_today);
+
+    ForEachSoilLayer(i) {
+      EXPECT_DOUBLE_EQ(SW_Soilwat.swcBulk[Yesterday][i], 1. + i);
+      EXPECT_DOUBLE_EQ(SW_Soilwat.swcBulk[Today][i], 1. + i);
+      EXPECT_DOUBLE_EQ(SW_Soilwat.sTemp_yesterday[i], 10. + i);
+    }
+    EXPECT_DOUBLE_EQ(SW_Soilwat.snowpack[Yesterday], 3.);
+
+    // Reset to previous global states
+    Reset_SOILWAT2_after_UnitTest();
+  }
 }
@@ -0,0 +1,143 @@
+#include "gtest/gtest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_SoilWater.h"
+#include "../SW_SoilWater_store.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+
+namespace {
+  const char *prefix = "Output/test_swcdata";
+  const char *fname_store = "Output/test_swcdata.bin";
+
+  // Write a text file of historical swc of `year`
+  void write_swc_hist(TimeInt year, const char *records) {
+    char fname[FILENAME_MAX];
+    FILE *f;
+
+    snprintf(fname, sizeof fname, "%s.%d", prefix, year);
+    f = fopen(fname, "w");
+    fputs("# doy layer swc stderr\n", f);
+    fputs(records, f);
+    fclose(f);
+  }
+
+  void remove_swc_hist(TimeInt year) {
+    char fname[FILENAME_MAX];
+
+    snprintf(fname, sizeof fname, "%s.%d", prefix, year);
+    remove(fname);
+  }
+
+
+  // Only days with measurements are stored
+  TEST(SoilWaterStoreTest, SparseDays) {
+    const SW_SOILWAT_HIST_DAY *obs;
+
+    _clear_hist_swc();
+    EXPECT_TRUE(isnull(SW_SWC_hist_day(1)));
+
+    SW_SWC_hist_add_day(200)->swc[2] = 1.5;
+    SW_SWC_hist_add_day(10)->swc[0] = 0.5;
+    SW_SWC_hist_add_day(200)->std_err[2] = 0.1;
+    EXPECT_EQ(2u, SW_Soilwat.hist.n_days);
+
+    obs = SW_SWC_hist_day(200);
+    ASSERT_FALSE(isnull(obs));
+    EXPECT_DOUBLE_EQ(1.5, obs->swc[2]);
+    EXPECT_DOUBLE_EQ(0.1, obs->std_err[2]);
+    EXPECT_DOUBLE_EQ(SW_MISSING, obs->swc[0]);
+    EXPECT_TRUE(isnull(SW_SWC_hist_day(11)));
+
+    _clear_hist_swc();
+    EXPECT_EQ(0u, SW_Soilwat.hist.n_days);
+    EXPECT_TRUE(isnull(SW_SWC_hist_day(200)));
+
+    // Reset to previous global state
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
+  // Measurements from a binary store are identical to those from text files
+  TEST(SoilWaterStoreTest, ReadYear) {
+    SW_SOILWAT_HIST_DAY text[MAX_DAYS];
+    const SW_SOILWAT_HIST_DAY *obs;
+    Bool has_text[MAX_DAYS];
+    char *file_prefix = SW_Soilwat.hist.file_prefix;
+    TimeInt doy, year = 1981;
+    LyrIndex z;
+
+    SW_Soilwat.hist.file_prefix = (char *) prefix;
+    write_swc_hist(1981,
+      "90 2 1.11500 .1\n185 1 2.0330 .23\n90 1 1.11658 .1\n300 4 3.1432 .25\n");
+    write_swc_hist(1983, "1 1 0.5 0.05\n");
+
+    EXPECT_EQ(2, SW_SWC_write_store(fname_store, 1980, 1983));
+    EXPECT_FALSE(SW_SWC_store_is_open());
+
+    // Reference: text file
+    EXPECT_TRUE(_read_swc_hist(year));
+    EXPECT_EQ(3u, SW_Soilwat.hist.n_days);
+    for (doy = 1; doy <= MAX_DAYS; doy++) {
+      obs = SW_SWC_hist_day(doy);
+      has_text[doy - 1] = (Bool) !isnull(obs);
+      if (has_text[doy - 1]) {
+        memcpy(&text[doy - 1], obs, sizeof(SW_SOILWAT_HIST_DAY));
+      }
+    }
+
+    // Binary store
+    _clear_hist_swc();
+    EXPECT_TRUE(SW_SWC_open_store(fname_store));
+    EXPECT_TRUE(SW_SWC_store_is_open());
+    EXPECT_TRUE(SW_SWC_read_store(year));
+    EXPECT_EQ(3u, SW_Soilwat.hist.n_days);
+
+    for (doy = 1; doy <= MAX_DAYS; doy++) {
+      obs = SW_SWC_hist_day(doy);
+      ASSERT_EQ(has_text[doy - 1], !isnull(obs)) << "doy = " << doy;
+
+      if (!isnull(obs)) {
+        for (z = 0; z < MAX_LAYERS; z++) {
+          EXPECT_DOUBLE_EQ(text[doy - 1].swc[z], obs->swc[z]);
+          EXPECT_DOUBLE_EQ(text[doy - 1].std_err[z], obs->std_err[z]);
+        }
+      }
+    }
+
+    // Years that are not in the store keep the previous measurements
+    EXPECT_FALSE(SW_SWC_read_store(1982));
+    EXPECT_FALSE(isnull(SW_SWC_hist_day(185)));
+    EXPECT_TRUE(SW_SWC_read_store(1983));
+    EXPECT_EQ(1u, SW_Soilwat.hist.n_days);
+    EXPECT_TRUE(isnull(SW_SWC_hist_day(185)));
+
+    SW_SWC_close_store();
+    EXPECT_FALSE(SW_SWC_store_is_open());
+    remove(fname_store);
+    remove_swc_hist(1981);
+    remove_swc_hist(1983);
+
+    // Reset to previous global state
+    SW_Soilwat.hist.file_prefix = file_prefix;
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
+  // A missing store is not opened
+  TEST(SoilWaterStoreTest, MissingStore) {
+    EXPECT_FALSE(SW_SWC_open_store("Output/does_not_exist.bin"));
+    EXPECT_FALSE(SW_SWC_store_is_open());
+  }
+
+} // namespace
@@ -0,0 +1,311 @@
+#include "gtest/gtest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Model.h"
+#include "../SW_Site.h"
+#include "../SW_SoilWater.h"
+#include "../SW_Weather.h"
+#include "../SW_VegEstab.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+
+namespace {
+  // Parameters of a test species
+  typedef struct {
+    TimeInt min_pregerm_days, max_pregerm_days, min_wetdays_for_germ,
+      max_drydays_postgerm, min_wetdays_for_estab, min_days_germ2estab,
+      max_days_germ2estab;
+    unsigned int estab_lyrs;
+  } SppParms;
+
+  // State of one species of the scalar reference `RefCheckit()`
+  typedef struct {
+    Bool no_estab, germd;
+    TimeInt estab_doy, germ_days, drydays_postgerm, wetdays_for_germ,
+      wetdays_for_estab;
+  } RefState;
+
+  // Add a species with germination at -5 bars and establishment at -1 bar
+  // and with a temperature range of 0-30 C to the active run
+  void add_species(const SppParms *p) {
+    // `_new_species()` re-allocates `parms`: index it after the call
+    unsigned int count = _new_species();
+    SW_VEGESTAB_INFO *v = SW_VegEstab.parms[count];
+
+    sprintf(v->sppFileName, "test_spp%u", SW_VegEstab.count);
+    strcpy(v->sppname, "test");
+    v->estab_lyrs = p->estab_lyrs;
+    v->bars[SW_GERM_BARS] = 5.;
+    v->bars[SW_ESTAB_BARS] = 1.;
+    v->min_pregerm_days = p->min_pregerm_days;
+    v->max_pregerm_days = p->max_pregerm_days;
+    v->min_wetdays_for_germ = p->min_wetdays_for_germ;
+    v->max_drydays_postgerm = p->max_drydays_postgerm;
+    v->min_wetdays_for_estab = p->min_wetdays_for_estab;
+    v->min_days_germ2estab = p->min_days_germ2estab;
+    v->max_days_germ2estab = p->max_days_germ2estab;
+    v->min_temp_germ = v->min_temp_estab = 0.;
+    v->max_temp_germ = v->max_temp_estab = 30.;
+  }
+
+  // Set today's weather and soil moisture of the top two layers and check
+  // the establishment of all species
+  void check_day(TimeInt doy, RealF temp, RealD swc0, RealD swc1) {
+    SW_Model.doy = doy;
+    SW_Weather.now.temp_avg[Today] = temp;
+    SW_Soilwat.swcBulk[Today][0] = swc0;
+    SW_Soilwat.swcBulk[Today][1] = swc1;
+
+    SW_VES_checkestab();
+  }
+
+  // Establishment check of one species as it was implemented before the
+  // species were checked as a batch over arrays (one species at a time)
+  void RefCheckit(RefState *r, const SW_VEGESTAB_INFO *v, TimeInt doy,
+    RealF avgtemp, RealD swc0, RealD swc1) {
+
+    RealF avgswc;
+
+    if (doy == SW_Model.firstdoy) {
+      memset(r, 0, sizeof *r);
+    }
+
+    if (r->no_estab || r->estab_doy > 0) {
+      return;
+    }
+
+    if (GT(swc0, v->min_swc_germ)) {
+      r->wetdays_for_germ++;
+    } else {
+      r->wetdays_for_germ = 0;
+    }
+
+    if (doy < v->min_pregerm_days) {
+      return;
+    }
+
+    if (!r->germd && r->wetdays_for_germ >= v->min_wetdays_for_germ) {
+      if (doy > v->max_pregerm_days) {
+        r->no_estab = swTRUE;
+      } else if (!LT(avgtemp, v->min_temp_germ) && !GT(avgtemp, v->max_temp_germ)) {
+        r->germd = swTRUE;
+      }
+      return;
+    }
+
+    avgswc = 0.;
+    avgswc += swc0;
+    if (v->estab_lyrs > 1) {
+      avgswc += swc1;
+    }
+    avgswc /= (RealF) v->estab_lyrs;
+    if (LT(avgswc, v->min_swc_estab)) {
+      r->drydays_postgerm++;
+      r->wetdays_for_estab = 0;
+    } else {
+      r->drydays_postgerm = 0;
+      r->wetdays_for_estab++;
+    }
+
+    if (r->drydays_postgerm > v->max_drydays_postgerm ||
+      LT(avgtemp, v->min_temp_estab) || GT(avgtemp, v->max_temp_estab)) {
+      r->wetdays_for_estab = r->germ_days = 0;
+      r->germd = swFALSE;
+      return;
+    }
+
+    r->germ_days++;
+
+    if (r->wetdays_for_estab < v->min_wetdays_for_estab ||
+      r->germ_days < v->min_days_germ2estab) {
+      return;
+    }
+
+    if (r->germ_days > v->max_days_germ2estab) {
+      r->wetdays_for_estab = r->germ_days = 0;
+      r->germd = swFALSE;
+      return;
+    }
+
+    r->estab_doy = doy;
+  }
+
+
+  // Species germinate, fail after a dry period, establish, and drop out of
+  // the list of checked species; the state is reset at the start of a year
+  TEST(VegEstabTest, GerminationEstablishment) {
+    // 0: establishes after a dry period; 1: fails after the dry period, then
+    // germinates again and establishes;
+    // 2: first possible day of germination is late in the year;
+    // 3: too late for germination (wet days are reached after its last day;
+    // days before germination count towards establishment as in the scalar
+    // check, hence the long minimum time from germination to establishment)
+    SppParms p[] = {
+      {10, 100, 3, 5, 4, 5, 30, 2},
+      {10, 100, 3, 2, 4, 5, 30, 2},
+      {50, 100, 3, 5, 4, 5, 30, 2},
+      {1, 5, 10, 5, 4, 20, 30, 1}
+    };
+    TimeInt expected_doy[] = {18, 20, 55, 0};
+    unsigned int i, k;
+    TimeInt doy, year;
+    RealD G, E, wet, dry0;
+
+    for (k = 0; k < length(p); k++) {
+      add_species(&p[k]);
+    }
+    SW_VES_init_run();
+    ASSERT_EQ(SW_VegEstab.spp.n_active, length(p));
+
+    // soil moisture that is wet for germination and establishment, and
+    // soil moisture that is wet for germination but dry for establishment
+    G = SW_VegEstab.spp.min_swc_germ[0];
+    E = SW_VegEstab.spp.min_swc_estab[0];
+    ASSERT_LT(G, 2. * E);
+    wet = 2. * fmax(G, E);
+    dry0 = (G + 2. * E) / 2.;
+
+    SW_Model.firstdoy = 1;
+
+    for (year = 0; year < 2; year++) {
+      for (doy = 1; doy <= 60; doy++) {
+        if (doy >= 12 && doy <= 14) {
+          check_day(doy, 15., dry0, 0.);
+        } else {
+          check_day(doy, 15., wet, wet);
+        }
+
+        if (doy == 1) {
+          // the first day of a year resets all species
+          EXPECT_EQ(SW_VegEstab.spp.n_active, length(p));
+        }
+        if (doy == 13) {
+          // species 3 was too late for germination (day 10)
+          EXPECT_EQ(SW_VegEstab.spp.n_active, 3u);
+          EXPECT_EQ(SW_VegEstab.spp.active[2], 2u);
+          EXPECT_EQ(SW_VegEstab.spp.drydays_postgerm[0], 2u);
+        }
+        if (doy == 15) {
+          // species 1 failed on day 14 and germinated again
+          EXPECT_TRUE(SW_VegEstab.spp.germd[1]);
+          EXPECT_EQ(SW_VegEstab.spp.germ_days[1], 0u);
+          EXPECT_EQ(SW_VegEstab.parms[0]->estab_doy, 0u);
+        }
+        if (doy == 18) {
+          // species 0 is established and no longer checked
+          EXPECT_EQ(SW_VegEstab.parms[0]->estab_doy, 18u);
+          EXPECT_EQ(SW_VegEstab.spp.n_active, 2u);
+          EXPECT_EQ(SW_VegEstab.spp.active[0], 1u);
+          EXPECT_EQ(SW_VegEstab.spp.active[1], 2u);
+        }
+      }
+
+      for (k = 0; k < length(p); k++) {
+        EXPECT_EQ(SW_VegEstab.parms[k]->estab_doy, expected_doy[k]) <<
+          "year " << year << ", species " << k;
+      }
+      EXPECT_EQ(SW_VegEstab.spp.n_active, 0u);
+    }
+
+    // species do not establish if it's too cold
+    for (doy = 1; doy <= 60; doy++) {
+      check_day(doy, -5., wet, wet);
+    }
+    for (i = 0; i < length(p); i++) {
+      EXPECT_EQ(SW_VegEstab.parms[i]->estab_doy, 0u);
+    }
+
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
+  // Days of establishment match the scalar check of one species at a time
+  // across two years of variable weather and soil moisture
+  TEST(VegEstabTest, MatchesScalarCheck) {
+    SppParms p[] = {
+      {10, 200, 3, 5, 4, 5, 30, 2},
+      {30, 250, 2, 2, 3, 4, 10, 1},
+      {60, 120, 5, 8, 6, 10, 40, 2},
+      {1, 300, 1, 1, 2, 2, 3, 1},
+      {100, 365, 4, 3, 5, 6, 20, 2}
+    };
+    RefState r[length(p)];
+    unsigned int k, seed = 12345, n_estab = 0, n_fail = 0;
+    Bool germd;
+    TimeInt doy, year;
+    RealD G, E, swc0, swc1;
+    RealF temp;
+
+    for (k = 0; k < length(p); k++) {
+      add_species(&p[k]);
+    }
+    SW_VES_init_run();
+
+    G = SW_VegEstab.spp.min_swc_germ[0];
+    E = SW_VegEstab.spp.min_swc_estab[0];
+    memset(r, 0, sizeof r);
+    SW_Model.firstdoy = 1;
+
+    for (year = 0; year < 2; year++) {
+      for (doy = 1; doy <= 365; doy++) {
+        // a wet or dry spell of a few days, seasonal temperature
+        seed = seed * 1103515245u + 12345u;
+        swc0 = ((seed >> 16) % 4 == 0) ? 0.5 * G : 2.5 * fmax(G, E);
+        swc1 = ((seed >> 20) % 3 == 0) ? 0. : 2. * E;
+        temp = (RealF) (15. - 20. * cos(2. * M_PI * doy / 365.) +
+          (RealD) ((seed >> 8) % 10));
+
+        check_day(doy, temp, swc0, swc1);
+
+        for (k = 0; k < length(p); k++) {
+          germd = r[k].germd;
+          RefCheckit(&r[k], SW_VegEstab.parms[k], doy, temp, swc0, swc1);
+          n_fail += (germd && !r[k].germd && doy != SW_Model.firstdoy) ? 1 : 0;
+          ASSERT_EQ(SW_VegEstab.parms[k]->estab_doy, r[k].estab_doy) <<
+            "year " << year << ", day " << doy << ", species " << k;
+        }
+      }
+
+      for (k = 0; k < length(p); k++) {
+        n_estab += (r[k].estab_doy > 0) ? 1 : 0;
+      }
+    }
+
+    // the inputs exercise establishment and failure after germination
+    EXPECT_GT(n_estab, 0u);
+    EXPECT_GT(n_fail, 0u);
+
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
+  // Species are checked against the transpiration layers of the site
+  TEST(VegEstabDeathTest, EstabLayers) {
+    SppParms p = {10, 100, 3, 5, 4, 5, 30, 1};
+    LyrIndex n_transp = SW_Site.n_transp_lyrs[SW_TREES];
+    int k;
+
+    ForEachVegType(k) {
+      n_transp = min(n_transp, SW_Site.n_transp_lyrs[k]);
+    }
+
+    p.estab_lyrs = n_transp + 1;
+    add_species(&p);
+
+    EXPECT_DEATH_IF_SUPPORTED(SW_VES_init_run(), "@ generic.c LogError");
+
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+} // namespace
@@ -32,12 +32,11 @@
 #include "../SW_Weather.h"
 #include "../SW_Markov.h"
 #include "../SW_Sky.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
 
-extern SW_MODEL SW_Model;
-extern SW_VEGPROD SW_VegProd;
 
 
 static void assert_decreasing_SWPcrit(void);
@@ -70,15 +69,13 @@ namespace {
 
   // Test the SW_VEGPROD constructor 'SW_VPD_construct'
   TEST(VegTest, Constructor) {
+    SW_VPD_deconstruct();
     SW_VPD_construct();
     SW_VPD_init_run();
 
     ForEachVegType(k) {
-      EXPECT_DOUBLE_EQ(1., v->veg[k].co2_multipliers[BIO_INDEX][0]);
-      EXPECT_DOUBLE_EQ(1., v->veg[k].co2_multipliers[BIO_INDEX][MAX_NYEAR - 1]);
-
-      EXPECT_DOUBLE_EQ(1., v->veg[k].co2_multipliers[WUE_INDEX][0]);
-      EXPECT_DOUBLE_EQ(1., v->veg[k].co2_multipliers[WUE_INDEX][MAX_NYEAR - 1]);
+      EXPECT_DOUBLE_EQ(1., v->veg[k].co2_multipliers[BIO_INDEX]);
+      EXPECT_DOUBLE_EQ(1., v->veg[k].co2_multipliers[WUE_INDEX]);
     }
 
     // Reset to previous global state
@@ -97,7 +94,7 @@ namespace {
     }
 
     // One example
-    x = v->veg[SW_GRASS].co2_multipliers[BIO_INDEX][SW_Model.startyr + SW_Model.addtl_yr];
+    x = v->veg[SW_GRASS].co2_multipliers[BIO_INDEX];
     apply_biomassCO2effect(biom2, biom1, x);
 
     for (i = 0; i < 12; i++) {
@@ -109,6 +106,46 @@ namespace {
   }
 
 
+  // Daily values are only recalculated if their inputs change
+  TEST(VegTest, DailyValuesOnlyIfInputsChange) {
+    double biomass_daily[MAX_DAYS + 1];
+
+    SW_Model.year = SW_Model.startyr;
+    SW_MDL_new_year();
+    ForEachVegType(k) {
+      v->veg[k].cov.fCover = 0.25;
+    }
+    SW_VPD_new_year();
+    memcpy(biomass_daily, v->veg[SW_GRASS].biomass_daily, sizeof biomass_daily);
+
+    // Same inputs in the next year of the same calendar: values are not touched
+    v->veg[SW_GRASS].biolive_daily[100] = -1.;
+    SW_Model.year = SW_Model.startyr + 1;
+    SW_MDL_new_year();
+    if (isleapyear(SW_Model.year) == isleapyear(SW_Model.startyr)) {
+      SW_VPD_new_year();
+      EXPECT_DOUBLE_EQ(v->veg[SW_GRASS].biolive_daily[100], -1.);
+    }
+
+    // Monthly input changes: values are recalculated
+    v->veg[SW_GRASS].biomass[Jul] *= 2.;
+    SW_VPD_new_year();
+    EXPECT_GT(v->veg[SW_GRASS].biolive_daily[100], 0.);
+    EXPECT_GT(v->veg[SW_GRASS].biomass_daily[196], biomass_daily[196]);
+
+    // CO2 multiplier changes: values are recalculated
+    v->veg[SW_GRASS].biomass[Jul] /= 2.;
+    SW_VPD_new_year();
+    memcpy(biomass_daily, v->veg[SW_GRASS].biomass_daily, sizeof biomass_daily);
+    v->veg[SW_GRASS].co2_multipliers[BIO_INDEX] *= 2.;
+    SW_VPD_new_year();
+    EXPECT_DOUBLE_EQ(v->veg[SW_GRASS].biomass_daily[196], 2. * biomass_daily[196]);
+
+    // Reset to previous global state
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
   // Test summing values across vegetation types
   TEST(VegTest, Summing) {
     double x0[NVEGTYPES] = {0.};
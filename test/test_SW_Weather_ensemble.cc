@@ -0,0 +1,165 @@
+#include "gtest/gtest.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../rands.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Weather.h"
+#include "../SW_Markov.h"
+#include "../SW_Weather_ensemble.h"
+
+#include "sw_testhelpers.h"
+
+
+namespace {
+  // Weather generator parameters: 30% wet days with 1 +/- 0.5 cm;
+  // tmax = 10 +/- 2 C and tmin = 0 +/- 1.7 C
+  void set_markov(SW_MARKOV *mp, RealD p[8][MAX_DAYS]) {
+    unsigned int i, week;
+    size_t d;
+
+    for (d = 0; d < MAX_DAYS; d++) {
+      p[0][d] = p[1][d] = 0.3;
+      p[2][d] = 1.;
+      p[3][d] = 0.5;
+      for (i = 4; i < 8; i++) {
+        p[i][d] = 0.;
+      }
+    }
+    mp->wetprob = p[0]; mp->dryprob = p[1]; mp->avg_ppt = p[2]; mp->std_ppt = p[3];
+    mp->cfxw = p[4]; mp->cfxd = p[5]; mp->cfnw = p[6]; mp->cfnd = p[7];
+    for (week = 0; week < MAX_WEEKS; week++) {
+      mp->u_cov[week][0] = 10.;
+      mp->u_cov[week][1] = 0.;
+      mp->v_cov[week][0][0] = 4.;
+      mp->v_cov[week][1][1] = 3.;
+      mp->v_cov[week][0][1] = mp->v_cov[week][1][0] = 1.;
+    }
+  }
+
+
+  // Replicates generated in parallel equal replicates generated sequentially
+  TEST(WeatherEnsembleTest, GenerateInParallel) {
+    SW_MARKOV mp;
+    SW_WTH_ENSEMBLE ens;
+    const SW_WEATHER_HIST *wh;
+    pcg32_random_t rng;
+    RealD p[8][MAX_DAYS], rain, tmax[MAX_DAYS], tmin[MAX_DAYS], ppt[MAX_DAYS];
+    TimeInt year, n, doy0, n_years = 5;
+    uint32_t site, r, n_reps = 3;
+
+    set_markov(&mp, p);
+
+    SW_WTH_ens_init(&ens, 1999, n_years);
+    for (site = 0; site < 4; site++) {
+      SW_WTH_ens_add(&ens, site, 42, n_reps, &mp);
+    }
+    SW_WTH_ens_add(&ens, 0, 7, n_reps, &mp); // same site with other seed
+    SW_WTH_ens_generate(&ens, 2);
+
+    for (site = 0; site < 4; site++) {
+      for (r = 0; r < n_reps; r++) {
+        wh = SW_WTH_ens_get(&ens, site, 42, r);
+        ASSERT_TRUE(wh != NULL);
+
+        SW_MKV_seed_stream(&rng, 42, site, r);
+        rain = 0.;
+
+        for (year = 1999; year < 1999 + n_years; year++, wh++) {
+          n = SW_MKV_generate_year(&mp, &rng, year, &rain, tmax, tmin, ppt);
+          EXPECT_EQ(n, Time_get_lastdoy_y(year));
+
+          for (doy0 = 0; doy0 < n; doy0++) {
+            EXPECT_DOUBLE_EQ(wh->temp_max[doy0], tmax[doy0]);
+            EXPECT_DOUBLE_EQ(wh->temp_min[doy0], tmin[doy0]);
+            EXPECT_DOUBLE_EQ(wh->ppt[doy0], ppt[doy0]);
+            EXPECT_DOUBLE_EQ(wh->temp_avg[doy0], (tmax[doy0] + tmin[doy0]) / 2.);
+          }
+
+          // Day 366 of a non-leap year is missing
+          if (n < MAX_DAYS) {
+            EXPECT_DOUBLE_EQ(wh->ppt[MAX_DAYS - 1], SW_MISSING);
+          }
+        }
+      }
+    }
+
+    // Seeds differ: weather differs
+    EXPECT_NE(
+      SW_WTH_ens_get(&ens, 0, 7, 0)->temp_max[0],
+      SW_WTH_ens_get(&ens, 0, 42, 0)->temp_max[0]
+    );
+
+    // Replicates that are not in the ensemble
+    EXPECT_TRUE(SW_WTH_ens_get(&ens, 4, 42, 0) == NULL);
+    EXPECT_TRUE(SW_WTH_ens_get(&ens, 0, 43, 0) == NULL);
+    EXPECT_TRUE(SW_WTH_ens_get(&ens, 0, 42, n_reps) == NULL);
+
+    SW_WTH_ens_deconstruct(&ens);
+    EXPECT_EQ(ens.n_sites, 0u);
+    EXPECT_TRUE(ens.sites == NULL);
+  }
+
+
+  // The number of threads does not change the replicates
+  TEST(WeatherEnsembleTest, IndependentOfThreads) {
+    SW_MARKOV mp;
+    SW_WTH_ENSEMBLE ens1, ens8;
+    const SW_WEATHER_HIST *wh1, *wh8;
+    RealD p[8][MAX_DAYS];
+    uint32_t site, r;
+    TimeInt i;
+
+    set_markov(&mp, p);
+
+    SW_WTH_ens_init(&ens1, 2000, 3);
+    SW_WTH_ens_init(&ens8, 2000, 3);
+    for (site = 0; site < 3; site++) {
+      SW_WTH_ens_add(&ens1, site, 1, 5, &mp);
+      SW_WTH_ens_add(&ens8, site, 1, 5, &mp);
+    }
+    SW_WTH_ens_generate(&ens1, 1);
+    SW_WTH_ens_generate(&ens8, 8);
+
+    for (site = 0; site < 3; site++) {
+      for (r = 0; r < 5; r++) {
+        wh1 = SW_WTH_ens_get(&ens1, site, 1, r);
+        wh8 = SW_WTH_ens_get(&ens8, site, 1, r);
+
+        for (i = 0; i < 3; i++) {
+          EXPECT_EQ(0, memcmp(&wh1[i], &wh8[i], sizeof(SW_WEATHER_HIST)));
+        }
+      }
+    }
+
+    SW_WTH_ens_deconstruct(&ens1);
+    SW_WTH_ens_deconstruct(&ens8);
+  }
+
+
+  // Adding the same site and seed twice is an error
+  TEST(WeatherEnsembleDeathTest, DuplicateSite) {
+    SW_MARKOV mp;
+    SW_WTH_ENSEMBLE ens;
+    RealD p[8][MAX_DAYS];
+
+    set_markov(&mp, p);
+    SW_WTH_ens_init(&ens, 2000, 1);
+    SW_WTH_ens_add(&ens, 3, 1, 2, &mp);
+
+    EXPECT_DEATH_IF_SUPPORTED(
+      SW_WTH_ens_add(&ens, 3, 1, 2, &mp),
+      "@ generic.c LogError"
+    );
+
+    SW_WTH_ens_deconstruct(&ens);
+  }
+
+} // namespace
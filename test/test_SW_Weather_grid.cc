@@ -0,0 +1,196 @@
+#include "gtest/gtest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Weather.h"
+#include "../SW_Weather_grid.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+
+namespace {
+  int n_loads;
+
+  // Values of a tile encode the tile's first time step and the value index
+  int load_test_tile(const SW_WTH_TILE_KEY *key, const size_t count[3],
+    float *values, void *data) {
+
+    size_t i, n = count[0] * count[1] * count[2];
+
+    n_loads++;
+    for (i = 0; i < n; i++) {
+      values[i] = (float) (1000 * key->start[0] + i);
+    }
+
+    return (data == NULL) ? 0 : *(int *) data;
+  }
+
+  void set_key(SW_WTH_TILE_KEY *key, const void *src, size_t t0) {
+    key->src = src;
+    key->start[0] = t0;
+    key->start[1] = key->start[2] = 0;
+  }
+
+
+  // The cache keeps the most recently used tiles within its size
+  TEST(WeatherGridTest, TileCache) {
+    SW_WTH_TILE_CACHE c;
+    SW_WTH_TILE_KEY key;
+    const SW_WTH_TILE *t;
+    const size_t count[3] = {10, 2, 2};
+    int src1 = 1, src2 = 2, status;
+    size_t t0;
+
+    memset(&c, 0, sizeof c);
+    c.max_bytes = 3 * 40 * sizeof(float);
+    n_loads = 0;
+
+    // Tiles at time steps 0, 10, and 20 fill the cache
+    for (t0 = 0; t0 <= 20; t0 += 10) {
+      set_key(&key, &src1, t0);
+      t = SW_WTH_tile_get(&c, &key, count, load_test_tile, NULL, &status);
+      ASSERT_FALSE(isnull(t));
+      EXPECT_FLOAT_EQ(1000. * t0 + 39., t->values[39]);
+    }
+    EXPECT_EQ(3u, c.n_tiles);
+    EXPECT_EQ(3, n_loads);
+
+    // A hit does not load and makes the tile the most recently used
+    set_key(&key, &src1, 0);
+    t = SW_WTH_tile_get(&c, &key, count, load_test_tile, NULL, &status);
+    EXPECT_EQ(3, n_loads);
+    EXPECT_EQ(1u, c.n_hits);
+    EXPECT_EQ(t, c.head);
+
+    // The same position of another source is another tile; it drops
+    // the least recently used tile (time step 10)
+    set_key(&key, &src2, 0);
+    SW_WTH_tile_get(&c, &key, count, load_test_tile, NULL, &status);
+    EXPECT_EQ(4, n_loads);
+    EXPECT_EQ(3u, c.n_tiles);
+    EXPECT_EQ(20u, c.tail->key.start[0]);
+
+    set_key(&key, &src1, 10);
+    SW_WTH_tile_get(&c, &key, count, load_test_tile, NULL, &status);
+    EXPECT_EQ(5, n_loads);
+    EXPECT_EQ(5u, c.n_misses);
+
+    // Tiles of a source are dropped together
+    SW_WTH_tile_evict(&c, &src1);
+    EXPECT_EQ(1u, c.n_tiles);
+    EXPECT_EQ(&src2, c.head->key.src);
+    EXPECT_EQ(c.head, c.tail);
+
+    SW_WTH_tile_clear(&c);
+    EXPECT_EQ(0u, c.n_tiles);
+    EXPECT_EQ(0u, c.n_bytes);
+    EXPECT_TRUE(isnull(c.head));
+  }
+
+
+  // A tile that cannot be loaded is not added; a tile larger than the
+  // cache is kept until the next tile
+  TEST(WeatherGridTest, TileCacheLimits) {
+    SW_WTH_TILE_CACHE c;
+    SW_WTH_TILE_KEY key;
+    const size_t count[3] = {10, 2, 2};
+    int src = 0, error = -1, status;
+
+    memset(&c, 0, sizeof c);
+    c.max_bytes = 10;
+
+    set_key(&key, &src, 0);
+    EXPECT_TRUE(isnull(
+      SW_WTH_tile_get(&c, &key, count, load_test_tile, &error, &status)));
+    EXPECT_EQ(-1, status);
+    EXPECT_EQ(0u, c.n_tiles);
+
+    EXPECT_FALSE(isnull(
+      SW_WTH_tile_get(&c, &key, count, load_test_tile, NULL, &status)));
+    EXPECT_EQ(1u, c.n_tiles);
+
+    set_key(&key, &src, 10);
+    SW_WTH_tile_get(&c, &key, count, load_test_tile, NULL, &status);
+    EXPECT_EQ(1u, c.n_tiles);
+    EXPECT_EQ(10u, c.head->key.start[0]);
+
+    SW_WTH_tile_clear(&c);
+  }
+
+
+  // Gridded weather is requested by a file name and optional variable names
+  TEST(WeatherGridTest, Setup) {
+    EXPECT_TRUE(isnull(SW_WTH_grid_setup(NULL)));
+    EXPECT_FALSE(SW_WTH_grid_is_used());
+
+    EXPECT_FALSE(isnull(SW_WTH_grid_setup("daymet_{year}.nc tmax tmin")));
+    EXPECT_FALSE(SW_WTH_grid_is_used());
+
+    #ifdef SW_NETCDF
+    EXPECT_TRUE(isnull(SW_WTH_grid_setup("daymet_{var}_{year}.nc")));
+    EXPECT_TRUE(SW_WTH_grid_is_used());
+    EXPECT_STREQ("prcp", SW_CurrentRun->WeatherGrid.var[2]);
+    #else
+    // without netCDF, gridded weather is an error
+    EXPECT_FALSE(isnull(SW_WTH_grid_setup("daymet_{var}_{year}.nc")));
+    EXPECT_FALSE(SW_WTH_grid_is_used());
+    #endif
+
+    // Reset to previous global state
+    SW_WTH_grid_setup(NULL);
+  }
+
+
+  #ifdef SW_NETCDF
+  // The site's grid cell of a netCDF file has the weather of the input files;
+  // the file is written by `tools/make_weather_grid_nc.py`
+  TEST(WeatherGridTest, ReadNetCDF) {
+    SW_WEATHER_HIST *wh = &SW_Weather.hist;
+    RealD tmax[MAX_DAYS], tmin[MAX_DAYS], ppt[MAX_DAYS];
+    TimeInt year = 1980, doy;
+
+    ASSERT_TRUE(_read_weather_hist(year));
+    memcpy(tmax, wh->temp_max, sizeof tmax);
+    memcpy(tmin, wh->temp_min, sizeof tmin);
+    memcpy(ppt, wh->ppt, sizeof ppt);
+
+    ASSERT_TRUE(isnull(SW_WTH_grid_setup(
+      "Input/data_weather_grid/weather_{year}.nc tmax tmin prcp")));
+    EXPECT_TRUE(SW_WTH_read_grid(year));
+
+    // nearest cell of the site (39.59 N, 105.58 W) on a 0-360 grid
+    EXPECT_TRUE(SW_CurrentRun->WeatherGrid.located);
+    EXPECT_EQ(0u, SW_CurrentRun->WeatherGrid.iy);
+    EXPECT_EQ(1u, SW_CurrentRun->WeatherGrid.ix);
+
+    for (doy = 0; doy < Time_get_lastdoy_y(year); doy++) {
+      if (doy == 99) {
+        EXPECT_TRUE(missing(wh->temp_max[doy])); // _FillValue
+      } else {
+        EXPECT_NEAR(tmax[doy], wh->temp_max[doy], tol3) << doy;
+        EXPECT_NEAR((tmax[doy] + tmin[doy]) / 2., wh->temp_avg[doy], tol3) << doy;
+      }
+      // tmin in K and prcp in packed mm are converted
+      EXPECT_NEAR(tmin[doy], wh->temp_min[doy], tol3) << doy;
+      EXPECT_NEAR(ppt[doy], wh->ppt[doy], tol3) << doy;
+    }
+
+    // a missing file of a year has no values
+    EXPECT_FALSE(SW_WTH_read_grid(year + 1));
+
+    // Reset to previous global state
+    SW_WTH_grid_setup(NULL);
+    SW_WTH_grid_close();
+    Reset_SOILWAT2_after_UnitTest();
+  }
+  #endif
+
+} // namespace
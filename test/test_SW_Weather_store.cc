@@ -0,0 +1,66 @@
+#include "gtest/gtest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../generic.h"
+#include "../myMemory.h"
+#include "../filefuncs.h"
+#include "../Times.h"
+#include "../SW_Defines.h"
+#include "../SW_Times.h"
+#include "../SW_Weather.h"
+#include "../SW_Weather_store.h"
+#include "../SW_Run.h"
+
+#include "sw_testhelpers.h"
+
+
+namespace {
+  const char *fname_store = "Output/test_weath.bin";
+
+
+  // Weather from a binary store is identical to weather from text files
+  TEST(WeatherStoreTest, ReadYear) {
+    SW_WEATHER_HIST hist_text;
+    TimeInt d, year = 1981;
+
+    EXPECT_EQ(3, SW_WTH_write_store(fname_store, 1980, 1982));
+    EXPECT_FALSE(SW_WTH_store_is_open());
+
+    // Reference: text file
+    EXPECT_TRUE(_read_weather_hist(year));
+    memcpy(&hist_text, &SW_Weather.hist, sizeof(SW_WEATHER_HIST));
+
+    // Binary store
+    EXPECT_TRUE(SW_WTH_open_store(fname_store));
+    EXPECT_TRUE(SW_WTH_store_is_open());
+    EXPECT_TRUE(SW_WTH_read_store(year));
+
+    for (d = 0; d < MAX_DAYS; d++) {
+      EXPECT_DOUBLE_EQ(hist_text.temp_max[d], SW_Weather.hist.temp_max[d]);
+      EXPECT_DOUBLE_EQ(hist_text.temp_min[d], SW_Weather.hist.temp_min[d]);
+      EXPECT_DOUBLE_EQ(hist_text.ppt[d], SW_Weather.hist.ppt[d]);
+    }
+
+    // Years that are not in the store are missing
+    EXPECT_FALSE(SW_WTH_read_store(1979));
+    EXPECT_FALSE(SW_WTH_read_store(1983));
+    EXPECT_DOUBLE_EQ(SW_MISSING, SW_Weather.hist.ppt[0]);
+
+    SW_WTH_close_store();
+    EXPECT_FALSE(SW_WTH_store_is_open());
+    remove(fname_store);
+
+    // Reset to previous global state
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
+  // A missing store is not opened
+  TEST(WeatherStoreTest, MissingStore) {
+    EXPECT_FALSE(SW_WTH_open_store("Output/does_not_exist.bin"));
+    EXPECT_FALSE(SW_WTH_store_is_open());
+  }
+
+} // namespace
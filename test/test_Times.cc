@@ -16,6 +16,7 @@
 #include "../SW_VegProd.h"
 #include "../SW_Site.h"
 #include "../SW_Flow_lib.h"
+#include "../SW_Run.h"
 #include "../Times.h"
 #include "sw_testhelpers.h"
 
@@ -52,6 +53,48 @@ namespace{
       EXPECT_EQ(doy2week(7), 0); // last day of first 7-day period
       EXPECT_EQ(doy2week(8), 1); // first day of second 7-day period
       EXPECT_EQ(doy2week(365 + lpadd), 52);
+
+      EXPECT_EQ(Time_first_doy_month(Jan), 1);
+      EXPECT_EQ(Time_last_doy_month(Feb), 59 + lpadd);
+      EXPECT_EQ(Time_first_doy_month(Mar), 60 + lpadd);
+      EXPECT_EQ(Time_last_doy_month(Dec), 365 + lpadd);
+
+      EXPECT_EQ(Time_first_doy_week(0), 1);
+      EXPECT_EQ(Time_last_doy_week(0), 7);
+      EXPECT_EQ(Time_first_doy_week(52), 365);
+      EXPECT_EQ(Time_last_doy_week(52), 365 + lpadd); // incomplete last week
+    }
+  }
+
+
+  // Test that the calendar lookups agree with day-by-day counting
+  TEST(TimesTest, calendar_tables) {
+    unsigned int k, doy, month, mday, ndays,
+      years[] = {1980, 1981};
+
+    for (k = 0; k < length(years); k++) {
+      Time_new_year(years[k]);
+      ndays = Time_get_lastdoy_y(years[k]);
+
+      month = Jan;
+      mday = 0;
+
+      for (doy = 1; doy <= ndays; doy++) {
+        if (mday == Time_days_in_month(month)) {
+          month++;
+          mday = 0;
+        }
+        mday++;
+
+        EXPECT_EQ(doy2month(doy), month) << "year = " << years[k] << " doy = " << doy;
+        EXPECT_EQ(doy2mday(doy), mday) << "year = " << years[k] << " doy = " << doy;
+        EXPECT_EQ(doy2week(doy), (doy - 1) / WKDAYS) << "doy = " << doy;
+
+        EXPECT_EQ(doy == Time_first_doy_month(month), mday == 1);
+        EXPECT_EQ(doy == Time_last_doy_month(month),
+          mday == Time_days_in_month(month));
+        EXPECT_EQ(doy == Time_first_doy_week(doy2week(doy)), (doy - 1) % WKDAYS == 0);
+      }
     }
   }
 
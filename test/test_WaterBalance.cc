@@ -31,16 +31,14 @@
 #include "../SW_SoilWater.h"
 #include "../SW_Weather.h"
 #include "../SW_Markov.h"
+#include "../SW_Weather_ensemble.h"
 #include "../SW_Sky.h"
 #include "../SW_Control.h"
+#include "../SW_Run.h"
 
 #include "sw_testhelpers.h"
 
 
-extern SW_MODEL SW_Model;
-extern SW_SOILWAT SW_Soilwat;
-extern SW_SITE SW_Site;
-extern SW_WEATHER SW_Weather;
 
 
 namespace {
@@ -54,7 +52,7 @@ namespace {
     int i;
 
     // Run the simulation
-    SW_CTL_main();
+    SW_CTL_main(SW_CurrentRun);
 
     // Collect and output from daily checks
     for (i = 0; i < N_WBCHECKS; i++) {
@@ -74,7 +72,7 @@ namespace {
     SW_Site.use_soil_temp = swTRUE;
 
     // Run the simulation
-    SW_CTL_main();
+    SW_CTL_main(SW_CurrentRun);
 
     // Collect and output from daily checks
     for (i = 0; i < N_WBCHECKS; i++) {
@@ -87,16 +85,40 @@ namespace {
   }
 
 
+  TEST(WaterBalance, WithSoilTemperatureCrankNicolson) {
+    int i;
+
+    // Turn on soil temperature simulations with the implicit solver
+    SW_Site.use_soil_temp = swTRUE;
+    SW_Site.stMethod = SW_STMETHOD_CRANKNICOLSON;
+
+    // Run the simulation
+    SW_CTL_main(SW_CurrentRun);
+
+    // Collect and output from daily checks
+    for (i = 0; i < N_WBCHECKS; i++) {
+      EXPECT_EQ(0, SW_Soilwat.wbError[i]) << "Water balance error in test " <<
+        i << ": " << (char*)SW_Soilwat.wbErrorNames[i];
+    }
+
+    // Soil temperature was not turned off
+    EXPECT_FALSE(SW_Soilwat.soiltempError);
+
+    // Reset to previous global state
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
   TEST(WaterBalance, WithPondedWaterRunonRunoff) {
     int i;
 
     // Turn on impermeability of first soil layer, runon, and runoff
-    SW_Site.lyr[0]->impermeability = 0.95;
+    SW_Site.impermeability[0] = 0.95;
     SW_Site.percentRunoff = 0.5;
     SW_Site.percentRunon = 1.25;
 
     // Run the simulation
-    SW_CTL_main();
+    SW_CTL_main(SW_CurrentRun);
 
     // Collect and output from daily checks
     for (i = 0; i < N_WBCHECKS; i++) {
@@ -122,7 +144,7 @@ namespace {
     SW_MKV_setup();
 
     // Run the simulation
-    SW_CTL_main();
+    SW_CTL_main(SW_CurrentRun);
 
     // Collect and output from daily checks
     for (i = 0; i < N_WBCHECKS; i++) {
@@ -147,7 +169,34 @@ namespace {
     strcpy(SW_Weather.name_prefix, "Input/data_weather_missing/weath");
 
     // Run the simulation
-    SW_CTL_main();
+    SW_CTL_main(SW_CurrentRun);
+
+    // Collect and output from daily checks
+    for (i = 0; i < N_WBCHECKS; i++) {
+      EXPECT_EQ(0, SW_Soilwat.wbError[i]) << "Water balance error: " << SW_Soilwat.wbErrorNames[i];
+    }
+
+    // Reset to previous global state
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
+  TEST(WaterBalance, WithWeatherEnsemble) {
+    int i;
+    SW_WTH_ENSEMBLE ens;
+    TimeInt n_years = SW_Model.endyr - SW_Model.startyr + 1;
+
+    // Read Markov weather generator input files (they are not normally read)
+    SW_MKV_setup();
+
+    // Pre-generate two replicates and simulate with the second one
+    SW_WTH_ens_init(&ens, SW_Model.startyr, n_years);
+    SW_WTH_ens_add(&ens, 0, 42, 2, &SW_Markov);
+    SW_WTH_ens_generate(&ens, 2);
+    SW_WTH_set_memory(SW_WTH_ens_get(&ens, 0, 42, 1), SW_Model.startyr, n_years);
+
+    // Run the simulation
+    SW_CTL_main(SW_CurrentRun);
 
     // Collect and output from daily checks
     for (i = 0; i < N_WBCHECKS; i++) {
@@ -155,6 +204,8 @@ namespace {
     }
 
     // Reset to previous global state
+    SW_WTH_set_memory(NULL, 0, 0);
+    SW_WTH_ens_deconstruct(&ens);
     Reset_SOILWAT2_after_UnitTest();
   }
 
@@ -166,14 +217,14 @@ namespace {
     // Set high gravel volume in all soil layers
     ForEachSoilLayer(s)
     {
-      SW_Site.lyr[s]->fractionVolBulk_gravel = 0.99;
+      SW_Site.fractionVolBulk_gravel[s] = 0.99;
     }
 
     // Re-calculate soils
     SW_SIT_init_run();
 
     // Run the simulation
-    SW_CTL_main();
+    SW_CTL_main(SW_CurrentRun);
 
     // Collect and output from daily checks
     for (i = 0; i < N_WBCHECKS; i++) {
@@ -187,4 +238,37 @@ namespace {
   }
 
 
+  // The water balance monitor (which every build runs) checks each simulated
+  // day and finds no violations where the detailed checks find none
+  TEST(WaterBalance, Monitor) {
+    unsigned int i;
+    unsigned long n_days = 0;
+    TimeInt year;
+    const SW_WB_MONITOR *m = &SW_CurrentRun->Flow.wbmon;
+
+    // Ponded water, runon, runoff, and frozen soils exercise all terms
+    SW_Site.impermeability[0] = 0.95;
+    SW_Site.percentRunoff = 0.5;
+    SW_Site.percentRunon = 1.25;
+    SW_Site.use_soil_temp = swTRUE;
+
+    // Run the simulation
+    SW_CTL_main(SW_CurrentRun);
+
+    for (year = SW_Model.startyr; year <= SW_Model.endyr; year++) {
+      n_days += Time_get_lastdoy_y(year);
+    }
+    EXPECT_EQ(n_days, m->days);
+
+    for (i = 0; i < SW_WB_NCHECKS; i++) {
+      EXPECT_EQ(0ul, m->failures[i]) << "Water balance invariant " << i;
+      EXPECT_LE(m->max_residual[i], SW_WB_TOL) << "Water balance invariant " << i;
+      EXPECT_EQ(0, SW_Soilwat.wbError[i]) << SW_Soilwat.wbErrorNames[i];
+    }
+
+    // Reset to previous global state
+    Reset_SOILWAT2_after_UnitTest();
+  }
+
+
 } // namespace
@@ -4,6 +4,7 @@
 #include <dirent.h>
 #include <errno.h>
 #include <float.h>
+#include <locale.h>
 #include <math.h>
 #include <memory.h>
 #include <stdarg.h>
@@ -59,4 +60,221 @@ namespace {
     }
   }
 
+  TEST(RunningAggregatorsTest, MergeRunningStats) {
+    unsigned int n_a;
+    double m_a, ss_a, m_b, ss_b, m_prev;
+
+    // Split the values at each position and aggregate both parts separately
+    for (n_a = 0; n_a <= N; n_a++)
+    {
+      m_a = ss_a = m_b = ss_b = 0.;
+
+      for (k = 0; k < N; k++)
+      {
+        if (k < n_a) {
+          m_prev = m_a;
+          m_a = get_running_mean(k + 1, m_prev, x[k]);
+          ss_a += get_running_sqr(m_prev, m_a, x[k]);
+        } else {
+          m_prev = m_b;
+          m_b = get_running_mean(k - n_a + 1, m_prev, x[k]);
+          ss_b += get_running_sqr(m_prev, m_b, x[k]);
+        }
+      }
+
+      merge_running_stats(n_a, &m_a, &ss_a, N - n_a, m_b, ss_b);
+
+      EXPECT_NEAR(m_a, m[N - 1], tol);
+      EXPECT_NEAR(final_running_sd(N, ss_a), sd[N - 1], tol);
+    }
+  }
+
+
+  // Str_FormatFixed() is identical to `sprintf("%.*f")`
+  TEST(StrFormatFixedTest, IdenticalToPrintf) {
+    char str1[400], str2[400], *end;
+    int i, d;
+    double v,
+      values[] = {
+        0., -0., 1., -1., 0.5, 1.5, 2.5, -2.5, 0.0078125, 1e-7, -1e-9,
+        0.1234565, 0.1234575, 1.0000005, 999999.9999995, 123456789.123456789,
+        4503599627370495.5, 4503599627370496., 1e300, -1e300, SW_MISSING
+      };
+
+    for (d = 0; d <= 10; d++) {
+      for (i = 0; i < (int) (sizeof values / sizeof values[0]); i++) {
+        sprintf(str1, "%.*f", d, values[i]);
+        end = Str_FormatFixed(str2, values[i], d);
+        EXPECT_STREQ(str1, str2);
+        EXPECT_EQ(str2 + strlen(str2), end);
+      }
+
+      // random values of different magnitudes
+      srand(d + 1);
+      for (i = 0; i < 20000; i++) {
+        v = ((double) rand() / RAND_MAX - 0.5) * pow(10., (i % 16) - 6);
+        sprintf(str1, "%.*f", d, v);
+        Str_FormatFixed(str2, v, d);
+        EXPECT_STREQ(str1, str2);
+      }
+    }
+
+    // not finite values
+    sprintf(str1, "%.6f", NAN);
+    Str_FormatFixed(str2, NAN, 6);
+    EXPECT_STREQ(str1, str2);
+    sprintf(str1, "%.6f", -INFINITY);
+    Str_FormatFixed(str2, -INFINITY, 6);
+    EXPECT_STREQ(str1, str2);
+  }
+
+
+  TEST(StrToDoubleTest, IdenticalToStrtod) {
+    const char *strs[] = {
+        "0", "-0", "1", "0.1", ".5", "-2.", "1e3", "1.5E-7", "  -12.75",
+        "123456789012345678", "9007199254740993", "1e23", "2.2250738585072014e-308",
+        "4.9e-324", "1.7976931348623157e308", "0.30000000000000004",
+        "12abc", "3.14.15", "inf", "nan", "-", "", "x1"
+      };
+    char str[64], *end1, *end2;
+    double v;
+    int i;
+
+    for (i = 0; i < (int) (sizeof strs / sizeof strs[0]); i++) {
+      v = Str_ToDouble(strs[i], &end2);
+      if (isnan(strtod(strs[i], &end1))) {
+        EXPECT_TRUE(isnan(v)) << strs[i];
+      } else {
+        EXPECT_EQ(strtod(strs[i], NULL), v) << strs[i];
+        EXPECT_EQ(strtof(strs[i], NULL), Str_ToFloat(strs[i], NULL)) << strs[i];
+      }
+      EXPECT_EQ(end1, end2) << strs[i];
+    }
+
+    // random values of different magnitudes
+    srand(1);
+    for (i = 0; i < 20000; i++) {
+      sprintf(str, "%.*g", 1 + i % 17,
+        ((double) rand() / RAND_MAX - 0.5) * pow(10., (i % 40) - 20));
+      EXPECT_EQ(strtod(str, NULL), Str_ToDouble(str, NULL)) << str;
+      EXPECT_EQ(strtof(str, NULL), Str_ToFloat(str, NULL)) << str;
+    }
+  }
+
+
+  TEST(StrToDoubleTest, IndependentOfLocale) {
+    // fast path and fallback to the C library (too many significant digits)
+    const char *strs[] = {"2.5", "-1.5e-3", "0.1234567890123456789", "1e-30"};
+    const double xs[] = {2.5, -1.5e-3, 0.1234567890123456789, 1e-30};
+    const char *locs[] = {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "German"};
+    const char *loc = NULL;
+    char *prev = strdup(setlocale(LC_NUMERIC, NULL)), *end;
+    int i;
+
+    for (i = 0; isnull(loc) && i < (int) (sizeof locs / sizeof locs[0]); i++) {
+      loc = setlocale(LC_NUMERIC, locs[i]);
+    }
+
+    if (isnull(loc) || strtod("2.5", NULL) == 2.5) {
+      setlocale(LC_NUMERIC, prev);
+      free(prev);
+      GTEST_SKIP() << "no locale with a decimal comma";
+    }
+
+    for (i = 0; i < (int) (sizeof strs / sizeof strs[0]); i++) {
+      EXPECT_EQ(xs[i], Str_ToDouble(strs[i], &end)) << strs[i];
+      EXPECT_EQ('\0', *end) << strs[i];
+      EXPECT_EQ((float) xs[i], Str_ToFloat(strs[i], &end)) << strs[i];
+      EXPECT_EQ('\0', *end) << strs[i];
+    }
+
+    setlocale(LC_NUMERIC, prev);
+    free(prev);
+  }
+
+
+  TEST(StrScanTest, IdenticalToSscanf) {
+    const char *strs[] = {
+        "1 2.5 3.25 name", "  -7\t0.1   1e-3 x", "4 5", "12 abc", "", "   ",
+        "3 4.5 6 a_very_long_name_that_is_truncated"
+      };
+    int i, n1, n2, d1, d2;
+    float f1, f2;
+    double g1, g2;
+    char s1[8], s2[8];
+
+    for (i = 0; i < (int) (sizeof strs / sizeof strs[0]); i++) {
+      d1 = d2 = -1;
+      f1 = f2 = -1.f;
+      g1 = g2 = -1.;
+      strcpy(s1, "-");
+      strcpy(s2, "-");
+
+      n1 = sscanf(strs[i], "%d %f %lf %7s", &d1, &f1, &g1, s1);
+      n2 = Str_Scan(strs[i], "%d %f %lf %7s", &d2, &f2, &g2, s2);
+
+      EXPECT_EQ(n1, n2) << strs[i];
+      EXPECT_EQ(d1, d2) << strs[i];
+      EXPECT_EQ(f1, f2) << strs[i];
+      EXPECT_EQ(g1, g2) << strs[i];
+      EXPECT_STREQ(s1, s2) << strs[i];
+    }
+  }
+
+
+  TEST(FastMathTest, RelativeError) {
+    double x, y, u, v, rel, max_exp = 0., max_log = 0., max_pow = 0., max_atan = 0.;
+    int i;
+
+    srand(7);
+    for (i = 0; i < 200000; i++) {
+      u = (double) rand() / RAND_MAX;
+      v = (double) rand() / RAND_MAX;
+
+      x = -708. + u * 1417.;
+      rel = fabs(sw_fast_exp(x) - exp(x)) / exp(x);
+      max_exp = fmax(max_exp, rel);
+
+      x = exp((u - 0.5) * 1400.);
+      if (x != 1.) {
+        rel = fabs(sw_fast_log(x) - log(x)) / fabs(log(x));
+        max_log = fmax(max_log, rel);
+      }
+
+      x = 1e-3 + u * 1e3;
+      y = (v - 0.5) * 20.;
+      rel = fabs(sw_fast_pow(x, y) - pow(x, y)) / pow(x, y);
+      max_pow = fmax(max_pow, rel / (1. + fabs(y * log(x))));
+
+      x = tan((u - 0.5) * 3.14159);
+      if (x != 0.) {
+        rel = fabs(sw_fast_atan(x) - atan(x)) / fabs(atan(x));
+        max_atan = fmax(max_atan, rel);
+      }
+    }
+
+    // documented maximal relative errors, see generic.h
+    EXPECT_LT(max_exp, 1e-8);
+    EXPECT_LT(max_log, 1e-8);
+    EXPECT_LT(max_pow, 1e-8);
+    EXPECT_LT(max_atan, 1e-8);
+
+    // arguments at the boundaries of range reductions
+    EXPECT_EQ(sw_fast_exp(0.), 1.);
+    EXPECT_EQ(sw_fast_log(1.), 0.);
+    EXPECT_EQ(sw_fast_atan(0.), 0.);
+    EXPECT_NEAR(sw_fast_atan(1.), atan(1.), 1e-8);
+    EXPECT_NEAR(sw_fast_atan(-1e300), -atan(1e300), 1e-8);
+    EXPECT_NEAR(sw_fast_log(sqrt(2.)), log(sqrt(2.)), 1e-8);
+
+    // special values
+    EXPECT_TRUE(isnan(sw_fast_exp(NAN)));
+    EXPECT_TRUE(isnan(sw_fast_log(-1.)));
+    EXPECT_TRUE(isnan(sw_fast_pow(INFINITY, 0.)));
+    EXPECT_TRUE(isnan(sw_fast_atan(NAN)));
+    EXPECT_EQ(sw_fast_log(0.), -INFINITY);
+    EXPECT_EQ(sw_fast_log(INFINITY), INFINITY);
+    EXPECT_NEAR(sw_fast_atan(INFINITY), 2. * atan(1.), 1e-8);
+  }
+
 } // namespace
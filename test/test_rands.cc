@@ -202,6 +202,66 @@ namespace {
 
 
   // This tests the beta random number generator
+  // This tests filling an array with normal random numbers
+  TEST(RNG_norm, ListMeanSD) {
+    pcg32_random_t rng0, rng1, rng2;
+    long i, n = 20001; // odd number: last value is not part of a pair
+    double mean = 5., sd = 2., m0 = 0., v0 = 0., nd = 0.;
+    double *x0, *x1, *x2;
+
+    x0 = (double *) malloc(n * sizeof(double));
+    x1 = (double *) malloc(n * sizeof(double));
+    x2 = (double *) malloc(n * sizeof(double));
+
+    RandSeedStream(7, 3, &rng0);
+    RandSeedStream(7, 3, &rng1); // same seed & same stream as rng0
+    RandSeedStream(7, 4, &rng2); // same seed, but different stream than rng0
+
+    RandNormList(n, mean, sd, x0, &rng0);
+    RandNormList(n, mean, sd, x1, &rng1);
+    RandNormList(n, mean, sd, x2, &rng2);
+
+    for (i = 0; i < n; i++) {
+      EXPECT_LT(fabs(x0[i] - mean), 100. * sd);
+
+      // Same seed & stream produce the same sequence, but not another stream
+      EXPECT_DOUBLE_EQ(x0[i], x1[i]);
+      nd += (x0[i] == x2[i]) ? 0. : 1.;
+
+      m0 += x0[i];
+    }
+    m0 /= n;
+
+    for (i = 0; i < n; i++) {
+      v0 += (x0[i] - m0) * (x0[i] - m0);
+    }
+    v0 /= n - 1;
+
+    EXPECT_GT(nd, n - 10.);
+
+    // Check sample moments (standard errors are about 0.014 and 0.02)
+    EXPECT_NEAR(m0, mean, 0.1);
+    EXPECT_NEAR(sqrt(v0), sd, 0.1);
+
+    free(x0);
+    free(x1);
+    free(x2);
+  }
+
+
+  // This tests seeding many generators (e.g., from several threads)
+  TEST(RNG_unif, SeedFromClock) {
+    pcg32_random_t rng0, rng1;
+
+    // Generators seeded at the same time with system time produce
+    // different sequences
+    RandSeed(0, &rng0);
+    RandSeed(0, &rng1);
+
+    EXPECT_NE(pcg32_random_r(&rng0), pcg32_random_r(&rng1));
+  }
+
+
   TEST(RNG_beta, ZeroToOneOutput) {
     pcg32_random_t ZeroToOne_rng;
     RandSeed(0, &ZeroToOne_rng);
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+
+# Writes the netCDF file of gridded weather that the unit tests of
+# `SW_Weather_grid.c` read (see `WeatherGridTest.ReadNetCDF`):
+#   testing/Input/data_weather_grid/weather_1980.nc
+#
+# The file is in the netCDF classic format (CDF-1) and is written without
+# netCDF libraries. Its grid of 2 x 3 cells has the weather of
+# `testing/Input/data_weather/weath.1980` at the cell of the example site
+# (39.5 N, 254.5 E); values of other cells are shifted by 100 per cell.
+# tmax is in degC (float, missing on day 100), tmin in K (float), and
+# prcp in mm (short, packed with `scale_factor` 0.1).
+#
+# Usage (from the SOILWAT2 directory): ./tools/make_weather_grid_nc.py
+
+import os
+import struct
+
+NC_DIMENSION, NC_VARIABLE, NC_ATTRIBUTE = 10, 11, 12
+NC_CHAR, NC_SHORT, NC_FLOAT, NC_DOUBLE = 2, 3, 5, 6
+TYPE = {NC_CHAR: ('c', 1), NC_SHORT: ('h', 2), NC_FLOAT: ('f', 4),
+        NC_DOUBLE: ('d', 8)}
+FILL_FLOAT = 9.9692099683868690e+36
+FILL_SHORT = -32767
+
+YEAR = 1980
+LAT = [39.5, 40.0]
+LON = [254.0, 254.5, 255.0]
+SITE = (0, 1)  # cell (lat, lon) of the example site
+
+
+def pad(b):
+    return b + b'\0' * (-len(b) % 4)
+
+
+def name(s):
+    return struct.pack('>i', len(s)) + pad(s.encode())
+
+
+def values(nc_type, x):
+    if nc_type == NC_CHAR:
+        return pad(x.encode())
+    return pad(struct.pack('>%d%s' % (len(x), TYPE[nc_type][0]), *x))
+
+
+def att_list(atts):
+    if not atts:
+        return struct.pack('>ii', 0, 0)
+    b = struct.pack('>ii', NC_ATTRIBUTE, len(atts))
+    for key, nc_type, x in atts:
+        b += name(key) + struct.pack('>ii', nc_type, len(x)) + values(nc_type, x)
+    return b
+
+
+def read_weather(fname):
+    w = {}
+    with open(fname) as f:
+        for line in f:
+            x = line.split('#')[0].split()
+            if len(x) == 4:
+                w[int(x[0])] = [float(v) for v in x[1:]]
+    return w
+
+
+def main():
+    src = os.path.join('testing', 'Input', 'data_weather', 'weath.%d' % YEAR)
+    dst = os.path.join('testing', 'Input', 'data_weather_grid',
+                       'weather_%d.nc' % YEAR)
+    w = read_weather(src)
+    ndays = len(w)
+    ncells = len(LAT) * len(LON)
+
+    tmax, tmin, prcp = [], [], []
+    for doy in range(1, ndays + 1):
+        for i in range(len(LAT)):
+            for j in range(len(LON)):
+                k = i * len(LON) + j
+                off = 0 if (i, j) == SITE else 100 * (k + 1)
+                tx, tn, pp = w[doy]
+                tmax.append(FILL_FLOAT if doy == 100 else tx + off)
+                tmin.append(tn + 273.15 + off)
+                prcp.append(int(round(pp * 100)) + off)
+
+    dims = [('time', ndays), ('lat', len(LAT)), ('lon', len(LON))]
+    grid = [0, 1, 2]
+    variables = [
+        ('time', [0], NC_DOUBLE, [
+            ('units', NC_CHAR, 'days since %d-01-01 00:00:00' % YEAR),
+            ('calendar', NC_CHAR, 'standard')],
+            [d + 0.5 for d in range(ndays)]),
+        ('lat', [1], NC_DOUBLE, [('units', NC_CHAR, 'degrees_north')], LAT),
+        ('lon', [2], NC_DOUBLE, [('units', NC_CHAR, 'degrees_east')], LON),
+        ('tmax', grid, NC_FLOAT, [
+            ('units', NC_CHAR, 'degC'),
+            ('_FillValue', NC_FLOAT, [FILL_FLOAT])], tmax),
+        ('tmin', grid, NC_FLOAT, [('units', NC_CHAR, 'K')], tmin),
+        ('prcp', grid, NC_SHORT, [
+            ('units', NC_CHAR, 'mm'),
+            ('scale_factor', NC_DOUBLE, [0.1]),
+            ('_FillValue', NC_SHORT, [FILL_SHORT])], prcp)
+    ]
+
+    data = [values(t, x) for _, _, t, _, x in variables]
+    assert len(tmax) == ndays * ncells
+
+    # header: begin of each variable is only known after the header size
+    def header(begins):
+        b = b'CDF\x01' + struct.pack('>i', 0)
+        b += struct.pack('>ii', NC_DIMENSION, len(dims))
+        for d, n in dims:
+            b += name(d) + struct.pack('>i', n)
+        b += att_list([('title', NC_CHAR, 'SOILWAT2 unit test: gridded weather')])
+        b += struct.pack('>ii', NC_VARIABLE, len(variables))
+        for (v, dimids, t, atts, _), x, begin in zip(variables, data, begins):
+            b += name(v) + struct.pack('>i', len(dimids))
+            b += struct.pack('>%di' % len(dimids), *dimids)
+            b += att_list(atts) + struct.pack('>iii', t, len(x), begin)
+        return b
+
+    begins = [0] * len(variables)
+    begin = len(header(begins))
+    for k, x in enumerate(data):
+        begins[k] = begin
+        begin += len(x)
+
+    os.makedirs(os.path.dirname(dst), exist_ok=True)
+    with open(dst, 'wb') as f:
+        f.write(header(begins) + b''.join(data))
+
+
+if __name__ == '__main__':
+    main()